@@ -0,0 +1,125 @@
+//! Latency of the action path on the Rust side, from the websocket frame
+//! a NeuroAction arrives in to the native executor's completion, as
+//! p50 / p99 / p999 per stage:
+//!
+//!     cargo bench --bench action_path
+//!
+//! The executor stages run `WAIT 0`, which goes through the queue, the
+//! script cache and the completion hop without injecting anything.
+//! NEURO_BENCH_INJECT=1 runs a typing and clicking script instead, into
+//! whatever has focus. The native stages on their own (compile, paths,
+//! queue execution into a no-op sink, frames, telemetry) are the
+//! neuro_native_bench target in native/c_cpp.
+
+#![allow(dead_code)]
+
+#[path = "../src/integration.rs"]
+mod integration;
+#[path = "../src/native.rs"]
+mod native;
+
+use std::hint::black_box;
+use std::time::{Duration, Instant};
+
+use integration::NeuroAction;
+use native::{Executor, Input};
+
+const WARMUP: usize = 1_000;
+const SAMPLES: usize = 20_000;
+
+// Dispatcher's group and flags (src/dispatch.rs).
+const GROUP_SCRIPT: u32 = 1;
+
+const INJECTING_SCRIPT: &str = "TYPE hello from neuro\nPRESS enter\nMOVE 640 360 0\nCLICK 640 360\n";
+
+/// `run` returns the time of the part it measures, so per-sample setup
+/// (cloning a frame) stays out of the numbers.
+fn measure(name: &str, mut run: impl FnMut() -> Duration) {
+    for _ in 0..WARMUP {
+        run();
+    }
+    let mut samples: Vec<Duration> = (0..SAMPLES).map(|_| run()).collect();
+    samples.sort_unstable();
+    let at = |q: f64| samples[((q * samples.len() as f64) as usize).min(samples.len() - 1)];
+    println!(
+        "{name:<24} p50 {:>10.2?}  p99 {:>10.2?}  p999 {:>10.2?}",
+        at(0.50),
+        at(0.99),
+        at(0.999)
+    );
+}
+
+/// A run_script action frame, in the shape the borrowing parser takes.
+fn frame(script: &str) -> String {
+    serde_json::json!({
+        "Action": { "action": "run_script", "data": { "script": script } }
+    })
+    .to_string()
+}
+
+fn parse(frame: &str) -> NeuroAction {
+    NeuroAction::parse(frame.to_owned()).expect("bench frame no longer parses as an action")
+}
+
+fn main() {
+    let inject = std::env::var_os("NEURO_BENCH_INJECT").is_some_and(|v| v == "1");
+    if inject {
+        if let Err(e) = Input::open() {
+            eprintln!("NEURO_BENCH_INJECT=1 but {e}");
+            std::process::exit(1);
+        }
+    }
+    let script = if inject { INJECTING_SCRIPT } else { "WAIT 0" };
+
+    // Single line: borrowed from the frame. Multi-line: escaped in the
+    // JSON, so into_script decodes a copy.
+    let borrowed = frame("WAIT 0");
+    let escaped = frame(INJECTING_SCRIPT);
+    let submitted = frame(script);
+
+    measure("parse frame", || {
+        let frame = borrowed.clone();
+        let start = Instant::now();
+        black_box(NeuroAction::parse(frame));
+        start.elapsed()
+    });
+
+    measure("script (borrowed)", || {
+        let action = parse(&borrowed);
+        let start = Instant::now();
+        black_box(action.into_script());
+        start.elapsed()
+    });
+
+    measure("script (escaped)", || {
+        let action = parse(&escaped);
+        let start = Instant::now();
+        black_box(action.into_script());
+        start.elapsed()
+    });
+
+    let executor = Executor::open(8, 0.0).expect("executor");
+
+    measure("executor round trip", || {
+        let script = parse(&submitted).into_script().unwrap();
+        let start = Instant::now();
+        executor.submit_owned(script, GROUP_SCRIPT, native::SUBMIT_SUPERSEDE).expect("submit");
+        let done = executor.next(-1).expect("next").expect("completion");
+        let elapsed = start.elapsed();
+        done.result.expect("script failed");
+        elapsed
+    });
+
+    measure("frame to completion", || {
+        let frame = submitted.clone();
+        let start = Instant::now();
+        let script = NeuroAction::parse(frame).and_then(NeuroAction::into_script).unwrap();
+        executor.submit_owned(script, GROUP_SCRIPT, native::SUBMIT_SUPERSEDE).expect("submit");
+        let done = executor.next(-1).expect("next").expect("completion");
+        let elapsed = start.elapsed();
+        done.result.expect("script failed");
+        elapsed
+    });
+
+    executor.close();
+}
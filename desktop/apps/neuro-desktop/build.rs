@@ -0,0 +1,63 @@
+// Links the neuro_native shared library (desktop/native/c_cpp).
+//
+// The shared build is used on purpose: the embedded Python controller
+// loads the same library, so both sides share one instance (telemetry
+// channels, script cache, injector).
+//
+// NEURO_NATIVE_DIR points at a prebuilt library; otherwise the tree's own
+// build directory (`make native`) is used, or CMake is run into OUT_DIR.
+
+use std::env;
+use std::path::{Path, PathBuf};
+use std::process::Command;
+
+fn main() {
+    let manifest = PathBuf::from(env::var("CARGO_MANIFEST_DIR").unwrap());
+    let source = manifest.join("../../native/c_cpp");
+
+    println!("cargo:rerun-if-env-changed=NEURO_NATIVE_DIR");
+    println!("cargo:rerun-if-changed={}", source.join("include").display());
+    println!("cargo:rerun-if-changed={}", source.join("src").display());
+    println!("cargo:rerun-if-changed={}", source.join("CMakeLists.txt").display());
+
+    let lib_dir = match env::var("NEURO_NATIVE_DIR") {
+        Ok(dir) => PathBuf::from(dir),
+        Err(_) => find_built(&source.join("build")).unwrap_or_else(|| build(&source)),
+    };
+
+    println!("cargo:rustc-link-search=native={}", lib_dir.display());
+    println!("cargo:rustc-link-lib=dylib=neuro_native_shared");
+
+    // Bundles ship the library next to the executable (scripts/bundle).
+    if env::var("CARGO_CFG_TARGET_OS").as_deref() == Ok("linux") {
+        println!("cargo:rustc-link-arg=-Wl,-rpath,$ORIGIN");
+        println!("cargo:rustc-link-arg=-Wl,-rpath,{}", lib_dir.display());
+    }
+}
+
+fn find_built(build: &Path) -> Option<PathBuf> {
+    [build.join("Release"), build.to_path_buf()]
+        .into_iter()
+        .find(|dir| {
+            dir.join("neuro_native_shared.lib").is_file()
+                || dir.join("libneuro_native_shared.so").is_file()
+                || dir.join("libneuro_native_shared.dylib").is_file()
+        })
+}
+
+fn build(source: &Path) -> PathBuf {
+    let out = PathBuf::from(env::var("OUT_DIR").unwrap()).join("neuro_native");
+
+    let run = |cmd: &mut Command| {
+        let status = cmd.status().expect("failed to run cmake (needed to build neuro_native)");
+        assert!(status.success(), "neuro_native build failed");
+    };
+
+    run(Command::new("cmake").arg("-S").arg(source).arg("-B").arg(&out));
+    run(Command::new("cmake")
+        .arg("--build")
+        .arg(&out)
+        .args(["--config", "Release", "--target", "neuro_native_shared"]));
+
+    find_built(&out).expect("neuro_native_shared missing after build")
+}
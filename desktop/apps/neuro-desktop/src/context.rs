@@ -0,0 +1,255 @@
+//! Context updates for Neuro, built from the native desktop state.
+//!
+//! The builder remembers what it last sent and only describes what has
+//! changed since: windows opened / closed / renamed, the active window,
+//! the lines of its accessibility tree that changed, processes started /
+//! exited and the pointer position. The first message is the full
+//! picture. Everything that happens between two
+//! messages is coalesced into the next one (a window that opens and
+//! closes in between is never mentioned), and messages are at least
+//! `min_interval` apart. A tick with nothing new costs a version compare
+//! and a process refresh, and sends nothing.
+
+use std::collections::{BTreeMap, HashMap};
+use std::fmt::Write;
+use std::time::{Duration, Instant};
+
+use crate::native::{self, ProcessList, ProcessTracker};
+
+/// Bytes of accessibility tree text per message.
+const UI_TEXT_BUDGET: usize = 4096;
+
+pub struct ContextBuilder {
+    min_interval: Duration,
+    last_sent: Option<Instant>,
+
+    // Window state as last sent; `windows_enabled` is false without the
+    // native window cache.
+    windows_enabled: bool,
+    window_version: u64,
+    windows: HashMap<u64, String>,
+    active: Option<String>,
+
+    // Accessibility tree text as last sent, line by line; `ui_enabled`
+    // is false without a native accessibility backend.
+    ui_enabled: bool,
+    ui_version: u64,
+    ui_lines: Vec<String>,
+
+    // Refreshed only when a message may go out, and whatever it reports
+    // goes into that message: its deltas span exactly the time since the
+    // last one.
+    processes: Option<ProcessTracker>,
+
+    mouse: Option<(i32, i32)>,
+}
+
+impl ContextBuilder {
+    pub fn new(min_interval: Duration) -> Self {
+        Self {
+            min_interval,
+            last_sent: None,
+            windows_enabled: native::start_window_cache().is_ok(),
+            window_version: 0,
+            windows: HashMap::new(),
+            active: None,
+            ui_enabled: native::start_ui_tree().is_ok(),
+            ui_version: 0,
+            ui_lines: Vec::new(),
+            processes: ProcessTracker::open().ok(),
+            mouse: None,
+        }
+    }
+
+    /// The next context message, or None when it is too early or nothing
+    /// changed since the last one.
+    pub fn tick(&mut self) -> Option<String> {
+        let now = Instant::now();
+        if self.last_sent.is_some_and(|sent| now.duration_since(sent) < self.min_interval) {
+            return None;
+        }
+
+        let first = self.last_sent.is_none();
+        let mut text = String::new();
+        self.windows_delta(first, &mut text);
+        self.ui_delta(first, &mut text);
+        self.processes_delta(first, &mut text);
+        self.mouse_delta(&mut text);
+
+        if text.is_empty() {
+            return None;
+        }
+        self.last_sent = Some(now);
+        text.pop(); // trailing newline
+        Some(text)
+    }
+
+    fn windows_delta(&mut self, first: bool, text: &mut String) {
+        if !self.windows_enabled {
+            return;
+        }
+        let version = native::window_cache_version();
+        if !first && version == self.window_version {
+            return;
+        }
+        let Ok((windows, active)) = native::windows() else { return };
+        self.window_version = version;
+
+        let mut current = HashMap::with_capacity(windows.len());
+        let mut opened = Vec::new();
+        let mut renamed = Vec::new();
+        for window in &windows {
+            if window.title.is_empty() {
+                continue;
+            }
+            match self.windows.get(&window.id) {
+                None => opened.push(window.title.as_str()),
+                Some(old) if *old != window.title => renamed.push((old.as_str(), window.title.as_str())),
+                Some(_) => {}
+            }
+            current.insert(window.id, window.title.clone());
+        }
+        let mut closed: Vec<&str> = self
+            .windows
+            .iter()
+            .filter(|(id, _)| !current.contains_key(id))
+            .map(|(_, title)| title.as_str())
+            .collect();
+        closed.sort_unstable();
+
+        let active = active.map(|index| windows[index].title.clone());
+        if active != self.active {
+            let _ = writeln!(text, "Active window: {}", active.as_deref().unwrap_or("none"));
+        }
+
+        if first {
+            line(text, "Open windows", &opened);
+        } else {
+            line(text, "Windows opened", &opened);
+            line(text, "Windows closed", &closed);
+            if !renamed.is_empty() {
+                text.push_str("Windows renamed: ");
+                for (i, (old, new)) in renamed.iter().enumerate() {
+                    if i > 0 {
+                        text.push_str("; ");
+                    }
+                    let _ = write!(text, "{old} -> {new}");
+                }
+                text.push('\n');
+            }
+        }
+
+        self.windows = current;
+        self.active = active;
+    }
+
+    /// The whole tree for a new window (its line comes first), otherwise
+    /// the lines that went away and the ones that appeared, unless that
+    /// is no shorter than the whole tree.
+    fn ui_delta(&mut self, first: bool, text: &mut String) {
+        if !self.ui_enabled {
+            return;
+        }
+        let version = native::ui_tree_version();
+        if !first && version == self.ui_version {
+            return;
+        }
+        let Ok(current) = native::ui_text(UI_TEXT_BUDGET) else { return };
+        self.ui_version = version;
+
+        let lines: Vec<String> = current.lines().map(str::to_owned).collect();
+        if lines == self.ui_lines {
+            return;
+        }
+
+        let same_window = !first && !lines.is_empty() && lines.first() == self.ui_lines.first();
+        let mut diff = String::new();
+        if same_window {
+            // Multiset difference, in tree order on both sides: a line
+            // that only moved (a sibling came or went) is not repeated.
+            let mut unmatched: HashMap<&str, usize> = HashMap::new();
+            for old in &self.ui_lines {
+                *unmatched.entry(old.as_str()).or_default() += 1;
+            }
+            let mut added = Vec::new();
+            for new in &lines {
+                match unmatched.get_mut(new.as_str()) {
+                    Some(count) if *count > 0 => *count -= 1,
+                    _ => added.push(new.as_str()),
+                }
+            }
+            for old in &self.ui_lines {
+                if let Some(count) = unmatched.get_mut(old.as_str()).filter(|count| **count > 0) {
+                    *count -= 1;
+                    let _ = writeln!(diff, "- {old}");
+                }
+            }
+            for new in added {
+                let _ = writeln!(diff, "+ {new}");
+            }
+        }
+
+        if same_window && diff.is_empty() {
+            // Same lines, only reordered: nothing worth a message.
+        } else if same_window && diff.len() < current.len() {
+            text.push_str("Window UI changed:\n");
+            text.push_str(&diff);
+        } else if !lines.is_empty() {
+            text.push_str("Window UI:\n");
+            for entry in &lines {
+                text.push_str(entry);
+                text.push('\n');
+            }
+        }
+        self.ui_lines = lines;
+    }
+
+    fn processes_delta(&mut self, first: bool, text: &mut String) {
+        let Some(tracker) = self.processes.as_mut() else { return };
+        let Ok((added, removed)) = tracker.refresh() else { return };
+
+        if first {
+            line(text, "Running processes", &grouped(tracker, &added));
+        } else {
+            line(text, "Processes started", &grouped(tracker, &added));
+            line(text, "Processes exited", &grouped(tracker, &removed));
+        }
+    }
+
+    fn mouse_delta(&mut self, text: &mut String) {
+        let position = native::mouse_position();
+        if position.is_some() && position != self.mouse {
+            let (x, y) = position.unwrap();
+            let _ = writeln!(text, "Mouse: ({x}, {y})");
+            self.mouse = position;
+        }
+    }
+}
+
+/// "name" or "name (count)", sorted by name.
+fn grouped(tracker: &ProcessTracker, list: &ProcessList) -> Vec<String> {
+    let mut counts: BTreeMap<&str, usize> = BTreeMap::new();
+    for &(_, name) in list {
+        *counts.entry(tracker.name(name)).or_default() += 1;
+    }
+    counts
+        .into_iter()
+        .filter(|(name, _)| !name.is_empty())
+        .map(|(name, count)| if count > 1 { format!("{name} ({count})") } else { name.to_owned() })
+        .collect()
+}
+
+fn line<S: AsRef<str>>(text: &mut String, label: &str, items: &[S]) {
+    if items.is_empty() {
+        return;
+    }
+    text.push_str(label);
+    text.push_str(": ");
+    for (i, item) in items.iter().enumerate() {
+        if i > 0 {
+            text.push_str("; ");
+        }
+        text.push_str(item.as_ref());
+    }
+    text.push('\n');
+}
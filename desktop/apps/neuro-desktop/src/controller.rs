@@ -1,19 +1,64 @@
-use anyhow::Result;
+use std::sync::{Arc, Condvar, Mutex, OnceLock};
+use std::time::{Duration, Instant};
+
+use anyhow::{anyhow, Result};
 use pyo3::prelude::*;
 use pyo3::types::{PyTuple};
 
 use rust_core::paths::get_python_packages_path;
 
-pub struct Controller {
+use crate::native::{self, Metric};
+
+/// Python::with_gil, timed: the wait for the GIL and the time it is held
+/// go into the native metrics, so stalls behind the interpreter show up
+/// without a profiler.
+fn with_gil<F, R>(f: F) -> R
+where
+    F: for<'py> FnOnce(Python<'py>) -> R,
+{
+    let requested = native::clock_ns();
+    Python::with_gil(|py| {
+        let acquired = native::span_since(Metric::GilWait, requested);
+        let result = f(py);
+        native::span_since(Metric::GilHold, acquired);
+        result
+    })
+}
+
+/// One low-level driver call, for Controller::batch.
+#[derive(Clone, Copy, Debug)]
+pub enum Op<'a> {
+    Move { x: i32, y: i32 },
+    Click { x: i32, y: i32 },
+    Type(&'a str),
+    /// Runs what the Python queues hold, whichever path the other ops
+    /// took (natively nothing is left in them once the drivers are up).
+    Execute,
+}
+
+// Python MouseController.queue_move's default.
+const MOVE_SECONDS: f64 = 0.1;
+
+/// The Python drivers (controller.lib.initialize_driver()), as the bound
+/// methods the controller calls: resolved once at load, so a call is
+/// just the call, no attribute lookup by name.
+struct Drivers {
     monitor: Py<PyAny>,
-    mouse: Py<PyAny>,
-    keyboard: Py<PyAny>,
-    parser: Py<PyAny>,
+
+    queue_move: Py<PyAny>,
+    queue_click: Py<PyAny>,
+    type_text: Py<PyAny>,
+    stream: Py<PyAny>,
+    // InstructionTimeline.execute, shared by both queues: executes them
+    // merged, in script order, on one executor.
+    execute: Py<PyAny>,
+    action_history: Py<PyAny>,
+    shutdown: Py<PyAny>,
 }
 
-impl Controller {
-    pub fn initialize_drivers() -> Result<Self> {
-        Python::with_gil(|py| -> PyResult<Self> {
+impl Drivers {
+    fn load() -> PyResult<Self> {
+        with_gil(|py| -> PyResult<Self> {
             // -------------------------------------------------
             // Configure Python path
             // -------------------------------------------------
@@ -34,79 +79,207 @@ impl Controller {
             let result = lib.getattr("initialize_driver")?.call0()?;
             let tuple = result.downcast::<PyTuple>()?;
 
+            let monitor = tuple.get_item(0)?;
+            let mouse = tuple.get_item(1)?;
+            let keyboard = tuple.get_item(2)?;
+            let parser = tuple.get_item(3)?;
+            let timeline = tuple.get_item(4)?;
+
             Ok(Self {
-                monitor: tuple.get_item(0)?.into(),
-                mouse: tuple.get_item(1)?.into(),
-                keyboard: tuple.get_item(2)?.into(),
-                parser: tuple.get_item(3)?.into(),
+                queue_move: mouse.getattr("queue_move")?.into(),
+                queue_click: mouse.getattr("queue_click")?.into(),
+                type_text: keyboard.getattr("type")?.into(),
+                stream: parser.getattr("stream")?.into(),
+                execute: timeline.getattr("execute")?.into(),
+                action_history: monitor.getattr("get_action_history")?.into(),
+                shutdown: monitor.getattr("shutdown")?.into(),
+                monitor: monitor.into(),
             })
         })
-        .map_err(Into::into)
+    }
+
+    fn call(&self, py: Python<'_>, op: Op<'_>) -> PyResult<()> {
+        match op {
+            Op::Move { x, y } => self.queue_move.call1(py, (x, y))?,
+            Op::Click { x, y } => self.queue_click.call1(py, (x, y))?,
+            Op::Type(text) => self.type_text.call1(py, (text,))?,
+            Op::Execute => self.execute.call0(py)?,
+        };
+        Ok(())
+    }
+
+    /// Every op under one GIL acquisition.
+    fn run(&self, ops: &[Op<'_>]) -> Result<()> {
+        with_gil(|py| ops.iter().try_for_each(|&op| self.call(py, op))).map_err(Into::into)
+    }
+
+    /// Imports what the drivers defer (pyautogui, PIL, mss, ...), so the
+    /// first fallback call doesn't pay for it either.
+    fn preload() {
+        let _ = with_gil(|py| -> PyResult<()> {
+            py.import_bound("controller.lib")?.getattr("preload_modules")?.call0()?;
+            Ok(())
+        });
+    }
+}
+
+/// Readiness of the Python side, set once by the startup thread.
+#[derive(Default)]
+struct Startup {
+    drivers: OnceLock<Result<Drivers, String>>,
+    lock: Mutex<()>,
+    ready: Condvar,
+}
+
+impl Startup {
+    fn finish(&self, drivers: Result<Drivers, String>) {
+        let _guard = self.lock.lock().unwrap();
+        let _ = self.drivers.set(drivers);
+        self.ready.notify_all();
+    }
+
+    /// None on timeout.
+    fn wait(&self, timeout: Option<Duration>) -> Option<&Result<Drivers, String>> {
+        let deadline = timeout.map(|t| Instant::now() + t);
+        let mut guard = self.lock.lock().unwrap();
+        loop {
+            if let Some(drivers) = self.drivers.get() {
+                return Some(drivers);
+            }
+            guard = match deadline {
+                None => self.ready.wait(guard).unwrap(),
+                Some(deadline) => {
+                    let left = deadline.checked_duration_since(Instant::now())?;
+                    self.ready.wait_timeout(guard, left).unwrap().0
+                }
+            };
+        }
+    }
+}
+
+pub struct Controller {
+    // Native injector; None when neuro_native has no backend here, in
+    // which case everything goes through the Python drivers.
+    input: Option<native::Input>,
+
+    // The Python drivers start on their own thread: importing them (and
+    // the interpreter's first imports) takes seconds in the bundled
+    // build, while the native engine is usable at once.
+    startup: Arc<Startup>,
+}
+
+impl Controller {
+    /// Returns as soon as the native engine is open. The Python drivers
+    /// load in the background: run_script() goes native without them,
+    /// the calls that need Python wait for them (see is_ready /
+    /// wait_ready).
+    pub fn initialize_drivers() -> Result<Self> {
+        let input = native::Input::open().ok();
+        let startup = Arc::new(Startup::default());
+
+        let loading = Arc::clone(&startup);
+        std::thread::Builder::new()
+            .name("python-drivers".into())
+            .spawn(move || {
+                let drivers = Drivers::load().map_err(|e| e.to_string());
+                let loaded = drivers.is_ok();
+                loading.finish(drivers);
+                if loaded {
+                    Drivers::preload();
+                }
+            })?;
+
+        Ok(Self { input, startup })
+    }
+
+    /// Whether the Python drivers have finished loading (successfully).
+    pub fn is_ready(&self) -> bool {
+        matches!(self.startup.drivers.get(), Some(Ok(_)))
+    }
+
+    /// Waits up to `timeout` for the Python drivers: Ok(false) if they
+    /// are still loading, Err if they failed to.
+    pub fn wait_ready(&self, timeout: Duration) -> Result<bool> {
+        match self.startup.wait(Some(timeout)) {
+            None => Ok(false),
+            Some(Ok(_)) => Ok(true),
+            Some(Err(e)) => Err(anyhow!("python drivers failed to start: {e}")),
+        }
+    }
+
+    fn drivers(&self) -> Result<&Drivers> {
+        match self.startup.wait(None) {
+            Some(Ok(drivers)) => Ok(drivers),
+            Some(Err(e)) => Err(anyhow!("python drivers failed to start: {e}")),
+            None => unreachable!("waits without a timeout"),
+        }
     }
 
     // =====================================================
     // Script execution (preferred API)
     // =====================================================
 
+    /// Native injector, for callers that want to act without the GIL.
+    pub fn native(&self) -> Option<native::Input> {
+        self.input
+    }
+
     pub fn run_script(&self, script: &str) -> Result<()> {
-        Python::with_gil(|py| {
-            self.parser
-                .bind(py)
-                .getattr("parse")?
-                .call1((script,))?;
-
-            self.keyboard.bind(py).getattr("execute")?.call0()?;
-            self.mouse.bind(py).getattr("execute")?.call0()?;
-            Ok::<(), PyErr>(())
-        })
-        .map_err(Into::into)
+        // Compiled + injected natively (in script order); the Python
+        // parser is only the fallback.
+        if let Some(input) = self.input {
+            return input.execute_script(script).map_err(Into::into);
+        }
+
+        // Pipelined in the parser too: each line runs once it has parsed.
+        let drivers = self.drivers()?;
+        with_gil(|py| drivers.stream.call1(py, (script,)).map(drop)).map_err(Into::into)
+    }
+
+    /// Runs `ops` in order: injected natively when there is an injector,
+    /// otherwise queued on the Python drivers under one GIL acquisition.
+    /// Execute runs what the Python queues hold either way; natively it
+    /// skips the drivers while they are still loading, since nothing can
+    /// have been queued on them yet.
+    pub fn batch(&self, ops: &[Op<'_>]) -> Result<()> {
+        let Some(input) = self.input else {
+            return self.drivers()?.run(ops);
+        };
+        for &op in ops {
+            match op {
+                Op::Move { x, y } => input.move_to(x, y, MOVE_SECONDS)?,
+                Op::Click { x, y } => input.click(x, y, native::Button::Left)?,
+                Op::Type(text) => input.type_text(text, 0.0)?,
+                Op::Execute if self.is_ready() => self.drivers()?.run(&[Op::Execute])?,
+                Op::Execute => {}
+            }
+        }
+        Ok(())
     }
 
     // Used to execute manual low-level calls (required when calling low-level APIs)
     pub fn execute_instructions(&self) -> Result<()> {
-        Python::with_gil(|py| {
-            self.keyboard.bind(py).getattr("execute")?.call0()?;
-            self.mouse.bind(py).getattr("execute")?.call0()?;
-            Ok::<(), PyErr>(())
-        })
-        .map_err(Into::into)
+        self.batch(&[Op::Execute])
     }
 
     // =====================================================
     // Low-level direct calls (optional)
     // =====================================================
 
+    // Injected at once when there is a native injector, otherwise queued
+    // on the Python drivers until execute_instructions(); batch() sends
+    // several in one go.
+
     pub fn mouse_move(&self, x: i32, y: i32) -> Result<()> {
-        Python::with_gil(|py| {
-            self.mouse
-                .bind(py)
-                .getattr("queue_move")?
-                .call1((x, y))?;
-            Ok::<(), PyErr>(())
-        })
-        .map_err(Into::into)
+        self.batch(&[Op::Move { x, y }])
     }
 
     pub fn mouse_click(&self, x: i32, y: i32) -> Result<()> {
-        Python::with_gil(|py| {
-            self.mouse
-                .bind(py)
-                .getattr("queue_click")?
-                .call1((x, y))?;
-            Ok::<(), PyErr>(())
-        })
-        .map_err(Into::into)
+        self.batch(&[Op::Click { x, y }])
     }
 
     pub fn type_text(&self, text: &str) -> Result<()> {
-        Python::with_gil(|py| {
-            self.keyboard
-                .bind(py)
-                .getattr("type")?
-                .call1((text,))?;
-            Ok::<(), PyErr>(())
-        })
-        .map_err(Into::into)
+        self.batch(&[Op::Type(text)])
     }
 
     // =====================================================
@@ -114,29 +287,22 @@ impl Controller {
     // =====================================================
 
     pub fn action_history(&self) -> Result<String> {
-        Python::with_gil(|py| {
-            let history = self
-                .monitor
-                .bind(py)
-                .getattr("get_action_history")?
-                .call0()?;
-
-            Ok::<_, PyErr>(history.str()?.to_string())
+        let drivers = self.drivers()?;
+        with_gil(|py| {
+            let history = drivers.action_history.call0(py)?;
+            Ok::<_, PyErr>(history.bind(py).str()?.to_string())
         })
         .map_err(Into::into)
     }
 
-    // Expose DesktopMonitor class
-    pub fn get_monitor(&self) -> &Monitor {
-        &self.monitor
+    // Expose DesktopMonitor class (waits for the Python drivers)
+    pub fn get_monitor(&self) -> Result<&Py<PyAny>> {
+        Ok(&self.drivers()?.monitor)
     }
 
     pub fn shutdown(&self) -> Result<()> {
-        Python::with_gil(|py| {
-            self.monitor.bind(py).getattr("shutdown")?.call0()?;
-            Ok::<(), PyErr>(())
-        })
-        .map_err(Into::into)
+        let drivers = self.drivers()?;
+        with_gil(|py| drivers.shutdown.call0(py).map(drop)).map_err(Into::into)
     }
 }
 
@@ -153,6 +319,14 @@ impl Controller {
 // ENTER
 // "#)?;
 //
+// // Low-level calls, one round trip (native, or one GIL acquisition)
+// controller.batch(&[
+//     Op::Move { x: 400, y: 300 },
+//     Op::Click { x: 400, y: 300 },
+//     Op::Type("hello"),
+//     Op::Execute,
+// ])?;
+//
 // // Inspect what happened
 // println!("{}", controller.action_history()?);
 //
@@ -0,0 +1,86 @@
+//! Action dispatch onto the native executor thread.
+//!
+//! submit() only queues: scripts run on the C++ executor, one at a time,
+//! and their ActionResult goes back to Neuro from a separate thread as
+//! each one finishes, so the action loop (and the websocket behind it)
+//! never waits on injection. The queue is bounded: a full queue rejects
+//! the action on the spot. A newer script supersedes the ones still
+//! queued and interrupts the one running (Neuro has moved on), scripts
+//! that sat queued too long are dropped as stale, and all of them are
+//! reported as cancelled.
+
+use std::borrow::Cow;
+use std::collections::HashMap;
+use std::sync::{Arc, Mutex};
+use std::thread;
+
+use tokio::sync::mpsc;
+
+use crate::integration::{NeuroAction, NeuroInput};
+use crate::native::{self, Executor, NativeError};
+
+const QUEUE_CAPACITY: u32 = 8;
+const STALE_SECONDS: f64 = 10.0;
+
+/// Executor group of `run_script` actions.
+const GROUP_SCRIPT: u32 = 1;
+
+pub struct Dispatcher {
+    executor: Arc<Executor>,
+    // ticket -> action name, for the ActionResult
+    actions: Arc<Mutex<HashMap<u64, Arc<str>>>>,
+}
+
+impl Dispatcher {
+    pub fn start(results: mpsc::Sender<NeuroInput>) -> Result<Self, NativeError> {
+        native::Input::open()?;
+        let executor = Arc::new(Executor::open(QUEUE_CAPACITY, STALE_SECONDS)?);
+        let actions = Arc::new(Mutex::new(HashMap::new()));
+
+        let (completions, names) = (executor.clone(), actions.clone());
+        thread::Builder::new()
+            .name("neuro-results".into())
+            .spawn(move || {
+                // Ends once the executor is closed and drained, or nobody
+                // listens for results any more.
+                while let Ok(next) = completions.next(-1) {
+                    let Some(done) = next else { continue };
+                    let Some(action) = names.lock().unwrap().remove(&done.ticket) else { continue };
+                    let result = match done.result {
+                        Ok(()) => Cow::Borrowed("success"),
+                        Err(e) if e.is_cancelled() => Cow::Borrowed("cancelled: superseded, interrupted or stale"),
+                        Err(e) => Cow::Owned(format!("error: {e}")),
+                    };
+                    if results.blocking_send(NeuroInput::ActionResult { action, result }).is_err() {
+                        break;
+                    }
+                }
+            })
+            .expect("failed to spawn result thread");
+
+        Ok(Self { executor, actions })
+    }
+
+    /// Queues the action's script, reported as `name` once it has run.
+    /// Never waits: Err means rejected (no script, queue full) and
+    /// nothing ran. The script goes to the executor without a copy.
+    pub fn submit(&self, name: Arc<str>, action: NeuroAction) -> Result<(), Cow<'static, str>> {
+        let script = action.into_script().ok_or(Cow::Borrowed("error: missing \"script\""))?;
+
+        // Held across the submit, so the result thread can't see the
+        // ticket complete before it is on the map.
+        let mut actions = self.actions.lock().unwrap();
+        let ticket = self
+            .executor
+            .submit_owned(script, GROUP_SCRIPT, native::SUBMIT_SUPERSEDE | native::SUBMIT_INTERRUPT)
+            .map_err(|e| Cow::Owned(format!("error: {e}")))?;
+        actions.insert(ticket, name);
+        Ok(())
+    }
+}
+
+impl Drop for Dispatcher {
+    fn drop(&mut self) {
+        self.executor.close();
+    }
+}
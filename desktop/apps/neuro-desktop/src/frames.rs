@@ -0,0 +1,86 @@
+//! Encoded screen frames for the integration layer.
+//!
+//! A capture thread grabs the primary output every `interval` and feeds
+//! changed frames to the native encoder pool. "Changed" is perceptual and
+//! measured against the last frame sent: a frame whose tile hashes are
+//! all within the screen cache's threshold of that one's is never
+//! encoded, yet a slow drift (typing, a progress bar) still goes out once
+//! it adds up. A second thread forwards the
+//! packets (JPEG / WebP bytes, read in place from native buffers) in
+//! capture order as they finish. Nothing is copied on the way and Python
+//! is never involved. When the consumer falls behind, frames are dropped
+//! instead of queued: only recent ones are worth sending.
+
+use std::sync::Arc;
+use std::thread;
+use std::time::{Duration, Instant};
+
+use tokio::sync::mpsc;
+
+use crate::native::{Capture, EncodeOptions, Encoder, NativeError, Packet, ScreenCache};
+
+/// Packets waiting for the consumer before new ones are dropped.
+const CHANNEL_DEPTH: usize = 2;
+
+/// Runs until the receiver is dropped or capture fails.
+pub fn start(interval: Duration, options: EncodeOptions) -> Result<mpsc::Receiver<Packet>, NativeError> {
+    let capture = Arc::new(Capture::open(0)?);
+    let encoder = Encoder::open(capture.clone(), &options)?;
+    let screen = ScreenCache::open()?;
+    let (tx, rx) = mpsc::channel(CHANNEL_DEPTH);
+
+    let (packets, sink) = (encoder.clone(), tx.clone());
+    thread::Builder::new()
+        .name("neuro-frames-out".into())
+        .spawn(move || {
+            // Ends once the encoder is closed and drained; frames that
+            // failed to encode come back as None and are skipped.
+            while let Ok(next) = packets.next(-1) {
+                let Some(packet) = next else { continue };
+                if let Err(mpsc::error::TrySendError::Closed(_)) = sink.try_send(packet) {
+                    break;
+                }
+            }
+        })
+        .expect("failed to spawn frame thread");
+
+    thread::Builder::new()
+        .name("neuro-frames".into())
+        .spawn(move || {
+            let timeout_ms = interval.as_millis().min(u32::MAX as u128) as u32;
+            let mut last_sent = None;
+            while !tx.is_closed() {
+                let started = Instant::now();
+
+                match capture.grab(timeout_ms) {
+                    Ok(frame) if !frame.unchanged() => {
+                        // Unknown (nothing sent yet, or it left the history) counts as changed.
+                        let changed = match (screen.observe(&frame), last_sent) {
+                            (Ok(_), Some(sent)) => screen.changed_since(sent).map_or(true, |tiles| tiles > 0),
+                            _ => true,
+                        };
+                        if changed {
+                            let sequence = frame.sequence();
+                            // Busy: every buffer is in flight; this frame is skipped.
+                            if encoder.submit(frame).is_ok() {
+                                last_sent = Some(sequence);
+                            }
+                        }
+                    }
+                    Ok(_) => {}
+                    Err(e) => {
+                        eprintln!("frame capture stopped: {e}");
+                        break;
+                    }
+                }
+
+                if let Some(rest) = interval.checked_sub(started.elapsed()) {
+                    thread::sleep(rest);
+                }
+            }
+            encoder.close();
+        })
+        .expect("failed to spawn frame thread");
+
+    Ok(rx)
+}
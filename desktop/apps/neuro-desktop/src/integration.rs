@@ -1,29 +1,186 @@
+use std::borrow::Cow;
+use std::ops::Range;
+use std::sync::Arc;
+
 use futures_util::{SinkExt, StreamExt};
+use serde::{Deserialize, Serialize};
+use serde_json::value::RawValue;
 use tokio::sync::mpsc;
 use tokio_tungstenite::{connect_async, tungstenite::Message};
 use url::Url;
 
+use crate::native::{self, Metric, Packet};
+
 use neuro_sama::game::{
     GameMessage,
     RegisterActions,
     ActionResult,
 };
 
+// Context updates and results can arrive in bursts (a batch of results
+// after a long script); actions only as fast as Neuro decides.
+const TO_NEURO_DEPTH: usize = 256;
+const FROM_NEURO_DEPTH: usize = 64;
+
+/// The actions registered with Neuro: (name, description).
+pub const ACTIONS: [(&str, &str); 4] = [
+    ("move", "Move somewhere"),
+    ("attack", "Attack a target"),
+    ("wait", "Do nothing"),
+    ("run_script", "Run a desktop action script ({\"script\": \"...\"})"),
+];
+
 /// Message YOU send TO Neuro
 #[derive(Debug)]
 pub enum NeuroInput {
     Context(String),
     ActionResult {
-        action: String,
-        result: String,
+        action: Arc<str>,
+        result: Cow<'static, str>,
     },
+    /// An encoded screen frame (JPEG / WebP bytes), sent as one binary
+    /// websocket message.
+    Frame(Packet),
 }
 
 /// Message Neuro sends TO YOU
+///
+/// Owns the websocket frame it arrived in: the action name and the raw
+/// JSON payload are slices of it, and the payload is only parsed when
+/// someone asks for a field.
 #[derive(Debug)]
 pub struct NeuroAction {
-    pub action: String,
-    pub data: serde_json::Value,
+    frame: String,
+    action: Range<usize>,
+    data: Range<usize>,
+}
+
+impl NeuroAction {
+    pub fn action(&self) -> &str {
+        &self.frame[self.action.clone()]
+    }
+
+    /// The payload as raw JSON text.
+    pub fn data(&self) -> &str {
+        &self.frame[self.data.clone()]
+    }
+
+    /// The payload's "script" string; borrowed from the frame unless it
+    /// had escapes (newlines, quotes) that needed decoding.
+    pub fn script(&self) -> Option<Cow<'_, str>> {
+        #[derive(Deserialize)]
+        struct Args<'a> {
+            #[serde(borrow)]
+            script: Cow<'a, str>,
+        }
+        serde_json::from_str::<Args>(self.data()).ok().map(|args| args.script)
+    }
+
+    /// Consumes the action for its "script": the frame itself when the
+    /// script could be borrowed from it, else the decoded copy.
+    pub fn into_script(self) -> Option<Script> {
+        let range = match self.script()? {
+            Cow::Borrowed(script) => Self::range_of(&self.frame, script),
+            Cow::Owned(script) => {
+                let range = 0..script.len();
+                return Some(Script { buffer: script, range });
+            }
+        };
+        Some(Script { buffer: self.frame, range })
+    }
+
+    // Byte range of `part` inside `frame`; `part` must borrow from it.
+    fn range_of(frame: &str, part: &str) -> Range<usize> {
+        let start = part.as_ptr() as usize - frame.as_ptr() as usize;
+        start..start + part.len()
+    }
+
+    pub(crate) fn parse(frame: String) -> Option<Self> {
+        // Borrowing twin of GameMessage::Action: nothing is copied out of
+        // the frame.
+        #[derive(Deserialize)]
+        enum Incoming<'a> {
+            Action {
+                #[serde(borrow)]
+                action: &'a str,
+                #[serde(borrow)]
+                data: &'a RawValue,
+            },
+        }
+
+        if let Ok(Incoming::Action { action, data }) = serde_json::from_str::<Incoming>(&frame) {
+            let action = Self::range_of(&frame, action);
+            let data = Self::range_of(&frame, data.get());
+            return Some(Self { frame, action, data });
+        }
+
+        // Other messages, or an escaped action name: the owned path.
+        match serde_json::from_str::<GameMessage>(&frame).ok()? {
+            GameMessage::Action { action, data } => {
+                let data = data.to_string();
+                Some(Self {
+                    action: 0..action.len(),
+                    data: action.len()..action.len() + data.len(),
+                    frame: action + &data,
+                })
+            }
+            _ => None,
+        }
+    }
+}
+
+/// A script taken out of a NeuroAction, without copying it when possible.
+#[derive(Debug)]
+pub struct Script {
+    buffer: String,
+    range: Range<usize>,
+}
+
+impl AsRef<str> for Script {
+    fn as_ref(&self) -> &str {
+        &self.buffer[self.range.clone()]
+    }
+}
+
+// Borrowing twins of the outbound GameMessage variants, serialized with
+// the same shape (checked against GameMessage in debug builds) without
+// building owned copies of the game name or the text.
+#[derive(Serialize)]
+enum Outgoing<'a> {
+    Context {
+        game: &'a str,
+        context: &'a str,
+    },
+    ActionResult(ActionResultRef<'a>),
+}
+
+#[derive(Serialize)]
+struct ActionResultRef<'a> {
+    game: &'a str,
+    action: &'a str,
+    result: &'a str,
+}
+
+fn check_wire_format(game: &str) {
+    let twin = |ours: &Outgoing, theirs: &GameMessage| {
+        assert_eq!(
+            serde_json::to_value(ours).unwrap(),
+            serde_json::to_value(theirs).unwrap(),
+            "Outgoing no longer serializes like GameMessage"
+        );
+    };
+    twin(
+        &Outgoing::Context { game, context: "c" },
+        &GameMessage::Context { game: game.into(), context: "c".into() },
+    );
+    twin(
+        &Outgoing::ActionResult(ActionResultRef { game, action: "a", result: "r" }),
+        &GameMessage::ActionResult(ActionResult {
+            game: game.into(),
+            action: "a".into(),
+            result: "r".into(),
+        }),
+    );
 }
 
 /// Starts the Neuro integration in the background
@@ -38,12 +195,16 @@ pub async fn start_integration(
     mpsc::Sender<NeuroInput>,
     mpsc::Receiver<NeuroAction>,
 ) {
-    let (to_neuro_tx, mut to_neuro_rx) = mpsc::channel::<NeuroInput>(32);
-    let (from_neuro_tx, from_neuro_rx) = mpsc::channel::<NeuroAction>(32);
+    let (to_neuro_tx, mut to_neuro_rx) = mpsc::channel::<NeuroInput>(TO_NEURO_DEPTH);
+    let (from_neuro_tx, from_neuro_rx) = mpsc::channel::<NeuroAction>(FROM_NEURO_DEPTH);
 
-    let game_name = game_name.to_string();
+    let game_name: Arc<str> = game_name.into();
     let ws_url = ws_url.to_string();
 
+    if cfg!(debug_assertions) {
+        check_wire_format(&game_name);
+    }
+
     tokio::spawn(async move {
         let url = Url::parse(&ws_url).expect("Invalid Neuro WS URL");
         let (ws, _) = connect_async(url).await.expect("Neuro connect failed");
@@ -52,12 +213,8 @@ pub async fn start_integration(
 
         // Register actions once
         let register = RegisterActions {
-            game: game_name.clone(),
-            actions: vec![
-                ("move".into(), "Move somewhere".into()),
-                ("attack".into(), "Attack a target".into()),
-                ("wait".into(), "Do nothing".into()),
-            ],
+            game: game_name.to_string(),
+            actions: ACTIONS.iter().map(|&(name, about)| (name.into(), about.into())).collect(),
         };
 
         write
@@ -67,44 +224,64 @@ pub async fn start_integration(
             .await
             .unwrap();
 
+        // Outbound frames are serialized into this buffer. The socket
+        // takes each frame as an owned String, so it is handed over and
+        // replaced by one of the same capacity: one allocation per frame,
+        // and none of the regrowing to_string() does.
+        let mut buffer: Vec<u8> = Vec::with_capacity(4096);
+
         loop {
             tokio::select! {
                 // Incoming messages FROM Neuro
                 msg = read.next() => {
                     let Some(Ok(Message::Text(text))) = msg else { continue };
 
-                    if let Ok(parsed) = serde_json::from_str::<GameMessage>(&text) {
-                        if let GameMessage::Action { action, data } = parsed {
-                            let _ = from_neuro_tx.send(NeuroAction {
-                                action,
-                                data,
-                            }).await;
-                        }
+                    let received = native::clock_ns();
+                    if let Some(action) = NeuroAction::parse(text) {
+                        let _ = from_neuro_tx.send(action).await;
                     }
+                    native::span_since(Metric::WsRecv, received);
                 }
 
                 // Messages FROM your game
                 Some(input) = to_neuro_rx.recv() => {
-                    let msg = match input {
-                        NeuroInput::Context(text) => {
-                            GameMessage::Context {
-                                game: game_name.clone(),
-                                context: text,
-                            }
+                    let started = native::clock_ns();
+                    let msg = match &input {
+                        NeuroInput::Frame(packet) => {
+                            // The socket wants an owned buffer: the one copy
+                            // out of the encoder's.
+                            write
+                                .send(Message::Binary(packet.to_vec()))
+                                .await
+                                .unwrap();
+                            native::span_since(Metric::WsSend, started);
+                            continue;
                         }
+                        NeuroInput::Context(text) => Outgoing::Context {
+                            game: &game_name,
+                            context: text,
+                        },
                         NeuroInput::ActionResult { action, result } => {
-                            GameMessage::ActionResult(ActionResult {
-                                game: game_name.clone(),
+                            Outgoing::ActionResult(ActionResultRef {
+                                game: &game_name,
                                 action,
                                 result,
                             })
                         }
                     };
 
+                    buffer.clear();
+                    serde_json::to_writer(&mut buffer, &msg).unwrap();
+                    let capacity = buffer.capacity();
+                    let frame = std::mem::replace(&mut buffer, Vec::with_capacity(capacity));
+                    // serde_json only writes valid UTF-8.
+                    let frame = unsafe { String::from_utf8_unchecked(frame) };
+
                     write
-                        .send(Message::Text(serde_json::to_string(&msg).unwrap()))
+                        .send(Message::Text(frame))
                         .await
                         .unwrap();
+                    native::span_since(Metric::WsSend, started);
                 }
             }
         }
@@ -1,9 +1,99 @@
 mod controller;
 use controller::Controller;
 
+mod context;
+mod dispatch;
+mod frames;
 mod integration;
+mod native;
 
-use integration::{start_integration, NeuroInput};
+use std::borrow::Cow;
+use std::sync::Arc;
+use std::time::Duration;
+
+use tokio::sync::mpsc;
+
+use context::ContextBuilder;
+use dispatch::Dispatcher;
+use integration::{start_integration, NeuroInput, ACTIONS};
+use native::{Codec, EncodeOptions};
+
+// How often the desktop state is checked, and the least time between two
+// context messages (changes in between are coalesced into the next one).
+const CONTEXT_TICK: Duration = Duration::from_millis(250);
+const CONTEXT_MIN_INTERVAL: Duration = Duration::from_secs(2);
+
+// How often the trace file is rewritten while NEURO_TRACE is set.
+const TRACE_FLUSH: Duration = Duration::from_secs(10);
+
+// Frames sent with NEURO_FRAMES are scaled down to fit this.
+const FRAME_MAX_WIDTH: i32 = 1280;
+const FRAME_MAX_HEIGHT: i32 = 720;
+
+/// NEURO_HISTORY=<path>: keeps the action and mouse history in a
+/// memory-mapped log at <path> (rotated to <path>.1, .2, ...), so it
+/// survives restarts and crashes; read it back with native::HistoryFile.
+fn start_history() {
+    let Some(path) = std::env::var_os("NEURO_HISTORY") else { return };
+    if let Err(e) = native::start_history(std::path::Path::new(&path), 0, 0) {
+        eprintln!("NEURO_HISTORY: {e}");
+    }
+}
+
+/// NEURO_TRACE=<path>: records a trace of the hot path (GIL waits,
+/// websocket frames, scripts, injection, capture) and keeps the newest
+/// part of it in <path> as Chrome trace JSON, for chrome://tracing or
+/// Perfetto.
+fn start_trace() {
+    let Some(path) = std::env::var_os("NEURO_TRACE") else { return };
+    if let Err(e) = native::start_trace(0) {
+        eprintln!("NEURO_TRACE: {e}");
+        return;
+    }
+    let path = std::path::PathBuf::from(path);
+    std::thread::spawn(move || loop {
+        std::thread::sleep(TRACE_FLUSH);
+        if let Err(e) = native::write_trace(&path) {
+            eprintln!("NEURO_TRACE: {}: {e}", path.display());
+        }
+    });
+}
+
+/// NEURO_FRAMES=<ms>: captures the primary output every <ms> and sends
+/// the frames that changed to Neuro, JPEG-encoded, as binary websocket
+/// messages (see frames::start).
+fn start_frames(neuro_tx: mpsc::Sender<NeuroInput>) {
+    let Ok(value) = std::env::var("NEURO_FRAMES") else { return };
+    let interval = match value.parse::<u64>() {
+        Ok(ms) if ms > 0 => Duration::from_millis(ms),
+        _ => {
+            eprintln!("NEURO_FRAMES: expected an interval in ms, got {value:?}");
+            return;
+        }
+    };
+    let options = EncodeOptions {
+        codec: Codec::Jpeg,
+        quality: 0,
+        max_width: FRAME_MAX_WIDTH,
+        max_height: FRAME_MAX_HEIGHT,
+        threads: 0,
+        buffers: 0,
+    };
+    let mut packets = match frames::start(interval, options) {
+        Ok(packets) => packets,
+        Err(e) => {
+            eprintln!("NEURO_FRAMES: {e}");
+            return;
+        }
+    };
+    tokio::spawn(async move {
+        while let Some(packet) = packets.recv().await {
+            if neuro_tx.send(NeuroInput::Frame(packet)).await.is_err() {
+                break;
+            }
+        }
+    });
+}
 
 #[tokio::main]
 async fn main() {
@@ -19,12 +109,18 @@ async fn main() {
 
     // Ok(())
 
+    eprintln!("neuro_native: {} backend", native::backend_name());
+    start_trace();
+    start_history();
+
     let (neuro_tx, mut neuro_rx) = start_integration(
         "Neuro's Desktop",
         "ws://localhost:8080/neuro",
     )
     .await;
 
+    start_frames(neuro_tx.clone());
+
     // // Send initial context
     // neuro_tx
     //     .send(NeuroInput::Context(
@@ -33,22 +129,57 @@ async fn main() {
     //     .await
     //     .unwrap();
 
-    // Game loop
-    loop {
-        if let Some(action) = neuro_rx.recv().await {
-            println!("Neuro chose: {}", action.action);
-
-            // YOU handle what this does
-            // ...
-
-            // Report result
-            neuro_tx
-                .send(NeuroInput::ActionResult {
-                    action: action.action,
-                    result: "success".into(),
-                })
-                .await
-                .unwrap();
+    // Context: only what changed since the previous message.
+    let context_tx = neuro_tx.clone();
+    tokio::spawn(async move {
+        let mut builder = ContextBuilder::new(CONTEXT_MIN_INTERVAL);
+        let mut ticks = tokio::time::interval(CONTEXT_TICK);
+        ticks.set_missed_tick_behavior(tokio::time::MissedTickBehavior::Skip);
+        loop {
+            ticks.tick().await;
+            if let Some(text) = builder.tick() {
+                if context_tx.send(NeuroInput::Context(text)).await.is_err() {
+                    break;
+                }
+            }
         }
+    });
+
+    // Scripts run on the native executor thread, straight from Rust (no
+    // Python, no GIL); their results come back through neuro_tx on their
+    // own, so this loop only ever queues.
+    let dispatcher = Dispatcher::start(neuro_tx.clone()).ok();
+
+    // Registered action names, interned: their results carry an Arc<str>,
+    // not a copy. Anything else the server sends is allocated per action
+    // and dropped with its result, so unknown names can't pile up.
+    let names: Vec<Arc<str>> = ACTIONS.iter().map(|&(name, _)| name.into()).collect();
+
+    // Game loop
+    while let Some(action) = neuro_rx.recv().await {
+        println!("Neuro chose: {}", action.action());
+
+        let name = match names.iter().find(|&name| &**name == action.action()) {
+            Some(name) => name.clone(),
+            None => action.action().into(),
+        };
+
+        let result: Cow<'static, str> = match (&*name, &dispatcher) {
+            ("run_script", Some(dispatcher)) => match dispatcher.submit(name.clone(), action) {
+                Ok(()) => continue, // reported when it finishes
+                Err(result) => result,
+            },
+            ("run_script", None) => Cow::Borrowed("error: input injection unavailable"),
+            _ => Cow::Borrowed("success"),
+        };
+
+        // Report result
+        neuro_tx
+            .send(NeuroInput::ActionResult {
+                action: name,
+                result,
+            })
+            .await
+            .unwrap();
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,1321 @@
+//! Bindings to neuro_native (desktop/native/c_cpp/include/neuro_native.h).
+//!
+//! Only what the app drives directly: script execution (inline or on the
+//! native executor thread), input injection, the desktop state the context is built from (window cache,
+//! process tracker, pointer position) and encoded screen frames. None of
+//! it touches the Python interpreter, so the action loop never waits on
+//! the GIL.
+
+use std::ffi::{CStr, c_char, c_void};
+use std::fmt;
+use std::sync::Arc;
+
+type NnStatus = i32;
+
+const NN_OK: NnStatus = 0;
+const NN_ERR_INVALID_ARGUMENT: NnStatus = -2;
+const NN_ERR_BUSY: NnStatus = -3;
+const NN_ERR_TIMEOUT: NnStatus = -4;
+const NN_ERR_SYNTAX: NnStatus = -6;
+const NN_ERR_CANCELLED: NnStatus = -7;
+
+pub const SUBMIT_SUPERSEDE: u32 = 1 << 0;
+pub const SUBMIT_INTERRUPT: u32 = 1 << 1;
+
+const NN_KEY_TAP: u32 = 0;
+const NN_KEY_DOWN: u32 = 1;
+const NN_KEY_UP: u32 = 2;
+
+#[repr(C)]
+struct ScriptError {
+    line: u32,
+    message: [c_char; 124],
+}
+
+#[repr(C)]
+struct ExecutorOptions {
+    capacity: u32,
+    stale_seconds: f64,
+}
+
+#[repr(C)]
+struct Completion {
+    ticket: u64,
+    group: u32,
+    status: NnStatus,
+    error: ScriptError,
+}
+
+#[repr(C)]
+struct WindowInfo {
+    id: u64,
+    pid: u32,
+    title_len: u32,
+    title: *const c_char,
+}
+
+#[repr(C)]
+#[derive(Clone, Copy)]
+struct ProcessDelta {
+    pid: u32,
+    name_id: u32,
+}
+
+#[repr(C)]
+struct CaptureOptions {
+    output: i32,
+    ring_slots: u32,
+}
+
+#[repr(C)]
+struct RawFrame {
+    data: *const u8,
+    width: i32,
+    height: i32,
+    stride: i32,
+    format: u32,
+    slot: u32,
+    flags: u32,
+    sequence: u64,
+    timestamp_ns: u64,
+}
+
+const NN_FRAME_UNCHANGED: u32 = 1 << 0;
+
+#[repr(C)]
+struct Rect {
+    x: i32,
+    y: i32,
+    width: i32,
+    height: i32,
+}
+
+#[repr(C)]
+struct EncoderOptions {
+    codec: u32,
+    quality: i32,
+    max_width: i32,
+    max_height: i32,
+    filter: u32,
+    threads: u32,
+    buffers: u32,
+}
+
+#[repr(C)]
+struct RawPacket {
+    id: u32,
+    status: NnStatus,
+    codec: u32,
+    width: i32,
+    height: i32,
+    source_width: i32,
+    source_height: i32,
+    sequence: u64,
+    timestamp_ns: u64,
+    data: *const u8,
+    size: usize,
+    rects: *const Rect,
+    rect_count: u32,
+}
+
+/// nn_record: one 64-byte telemetry record. In the history log,
+/// timestamp_ns is Unix-epoch ns and `reserved` the channel it came from.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default)]
+pub struct Record {
+    pub sequence: u64,
+    pub timestamp_ns: u64,
+    pub source: u16,
+    pub kind: u16,
+    pub flags: u32,
+    pub x: i32,
+    pub y: i32,
+    pub arg: i64,
+    pub value: f64,
+    pub aux: u64,
+    pub reserved: u64,
+}
+
+#[repr(C)]
+struct HistoryOptions {
+    segment_records: u32,
+    keep_segments: u32,
+    rotate_seconds: u32,
+    reserved: u32,
+}
+
+#[repr(C)]
+struct ScreenCacheOptions {
+    capacity: u32,
+    tile_size: u32,
+    history: u32,
+    threshold: u32,
+}
+
+#[repr(C)]
+#[derive(Clone, Copy, Default)]
+pub struct ScreenObservation {
+    pub state: u64,
+    pub sequence: u64,
+    pub first_sequence: u64,
+    pub value: u64,
+    pub frame_hash: u64,
+    pub changed_tiles: u32,
+    pub tile_count: u32,
+    pub known: u32,
+}
+
+unsafe extern "C" {
+    fn nn_status_string(status: NnStatus) -> *const c_char;
+    fn nn_backend() -> u32;
+    fn nn_backend_name(backend: u32) -> *const c_char;
+
+    fn nn_clock_ns() -> u64;
+    fn nn_metrics_span(metric: u32, start_ns: u64, end_ns: u64) -> NnStatus;
+    fn nn_trace_start(capacity: u32) -> NnStatus;
+    fn nn_trace_write(path: *const c_char) -> NnStatus;
+
+    fn nn_history_start(path: *const c_char, options: *const HistoryOptions) -> NnStatus;
+    fn nn_history_open(path: *const c_char, out: *mut *mut c_void) -> NnStatus;
+    fn nn_history_close(file: *mut c_void);
+    fn nn_history_records(file: *const c_void, records: *mut *const Record) -> usize;
+    fn nn_history_range(file: *const c_void, from_ns: u64, to_ns: u64, first: *mut *const Record) -> usize;
+    fn nn_history_name_of(file: *const c_void, id: u16) -> *const c_char;
+
+    fn nn_input_open() -> NnStatus;
+    fn nn_input_key(key: *const c_char, action: u32) -> NnStatus;
+    fn nn_input_type(text: *const c_char, len: usize, interval_seconds: f64) -> NnStatus;
+    fn nn_input_move(x: i32, y: i32, seconds: f64) -> NnStatus;
+    fn nn_input_click(x: i32, y: i32, button: u32) -> NnStatus;
+    fn nn_input_screen_size(width: *mut i32, height: *mut i32) -> NnStatus;
+
+    fn nn_script_stream(text: *const c_char, len: usize, error: *mut ScriptError) -> NnStatus;
+
+    fn nn_executor_create(options: *const ExecutorOptions, out: *mut *mut c_void) -> NnStatus;
+    fn nn_executor_free(executor: *mut c_void);
+    fn nn_executor_submit(executor: *mut c_void, text: *const c_char, len: usize, group: u32, flags: u32,
+                          ticket: *mut u64) -> NnStatus;
+    fn nn_executor_submit_view(executor: *mut c_void, text: *const c_char, len: usize,
+                               release: unsafe extern "C" fn(*mut c_void), user: *mut c_void, group: u32,
+                               flags: u32, ticket: *mut u64) -> NnStatus;
+    fn nn_executor_cancel(executor: *mut c_void, ticket: u64) -> NnStatus;
+    fn nn_executor_next(executor: *mut c_void, out: *mut Completion, timeout_ms: i32) -> NnStatus;
+    fn nn_executor_close(executor: *mut c_void);
+
+    fn nn_mouse_hook_position(x: *mut i32, y: *mut i32, timestamp_ns: *mut u64) -> NnStatus;
+
+    fn nn_window_cache_start() -> NnStatus;
+    fn nn_window_cache_version() -> u64;
+    fn nn_window_snapshot_get(out: *mut *mut c_void) -> NnStatus;
+    fn nn_window_snapshot_free(snapshot: *mut c_void);
+    fn nn_window_snapshot_count(snapshot: *const c_void) -> usize;
+    fn nn_window_snapshot_window(snapshot: *const c_void, index: usize, out: *mut WindowInfo) -> NnStatus;
+    fn nn_window_snapshot_active(snapshot: *const c_void) -> i64;
+
+    fn nn_ui_tree_start() -> NnStatus;
+    fn nn_ui_tree_version() -> u64;
+    fn nn_ui_snapshot_get(out: *mut *mut c_void) -> NnStatus;
+    fn nn_ui_snapshot_free(snapshot: *mut c_void);
+    fn nn_ui_snapshot_text(snapshot: *const c_void, out: *mut c_char, capacity: usize, len: *mut usize) -> NnStatus;
+
+    fn nn_process_tracker_create(out: *mut *mut c_void) -> NnStatus;
+    fn nn_process_tracker_free(tracker: *mut c_void);
+    fn nn_process_tracker_refresh(tracker: *mut c_void) -> NnStatus;
+    fn nn_process_tracker_added(tracker: *const c_void, count: *mut usize) -> *const ProcessDelta;
+    fn nn_process_tracker_removed(tracker: *const c_void, count: *mut usize) -> *const ProcessDelta;
+    fn nn_process_name_count(tracker: *const c_void) -> usize;
+    fn nn_process_name(tracker: *const c_void, id: u32, len: *mut u32) -> *const c_char;
+
+    fn nn_capture_open(options: *const CaptureOptions, out: *mut *mut c_void) -> NnStatus;
+    fn nn_capture_close(session: *mut c_void);
+    fn nn_capture_grab(session: *mut c_void, timeout_ms: u32, out: *mut RawFrame) -> NnStatus;
+    fn nn_capture_release(session: *mut c_void, slot: u32) -> NnStatus;
+
+    fn nn_encoder_create(options: *const EncoderOptions, out: *mut *mut c_void) -> NnStatus;
+    fn nn_encoder_free(encoder: *mut c_void);
+    fn nn_encoder_submit(encoder: *mut c_void, capture: *mut c_void, frame: *const RawFrame, rects: *const Rect,
+                         rect_count: u32) -> NnStatus;
+    fn nn_encoder_next(encoder: *mut c_void, out: *mut RawPacket, timeout_ms: i32) -> NnStatus;
+    fn nn_encoder_release(encoder: *mut c_void, id: u32) -> NnStatus;
+    fn nn_encoder_close(encoder: *mut c_void);
+
+    fn nn_screen_cache_create(options: *const ScreenCacheOptions, out: *mut *mut c_void) -> NnStatus;
+    fn nn_screen_cache_free(cache: *mut c_void);
+    fn nn_screen_cache_observe(cache: *mut c_void, frame: *const RawFrame, out: *mut ScreenObservation) -> NnStatus;
+    fn nn_screen_cache_changed_since(cache: *const c_void, sequence: u64, changed_tiles: *mut u32) -> NnStatus;
+}
+
+// =====================================================
+// Errors
+// =====================================================
+
+#[derive(Debug)]
+pub enum NativeError {
+    Status(i32),
+    Syntax { line: u32, message: String },
+}
+
+impl fmt::Display for NativeError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            NativeError::Status(status) => {
+                let reason = unsafe { CStr::from_ptr(nn_status_string(*status)) };
+                write!(f, "neuro_native: {}", reason.to_string_lossy())
+            }
+            NativeError::Syntax { line, message } => write!(f, "Line {line}: {message}"),
+        }
+    }
+}
+
+impl std::error::Error for NativeError {}
+
+impl NativeError {
+    /// Superseded, stale or cancelled on the executor before it finished.
+    pub fn is_cancelled(&self) -> bool {
+        matches!(self, NativeError::Status(NN_ERR_CANCELLED))
+    }
+}
+
+fn check(status: NnStatus) -> Result<(), NativeError> {
+    if status == NN_OK { Ok(()) } else { Err(NativeError::Status(status)) }
+}
+
+fn script_result(status: NnStatus, error: &ScriptError) -> Result<(), NativeError> {
+    if status == NN_ERR_SYNTAX {
+        let message = unsafe { CStr::from_ptr(error.message.as_ptr()) };
+        return Err(NativeError::Syntax {
+            line: error.line,
+            message: message.to_string_lossy().into_owned(),
+        });
+    }
+    check(status)
+}
+
+// =====================================================
+// Input
+// =====================================================
+
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum Button {
+    Left = 1,
+    Middle = 2,
+    Right = 3,
+}
+
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum KeyAction {
+    Tap,
+    Down,
+    Up,
+}
+
+/// Handle to the native injector. Proof that the backend opened; the
+/// library serializes calls, so it can be copied to any thread.
+#[derive(Clone, Copy, Debug)]
+pub struct Input {
+    _opened: (),
+}
+
+impl Input {
+    pub fn open() -> Result<Self, NativeError> {
+        check(unsafe { nn_input_open() })?;
+        Ok(Self { _opened: () })
+    }
+
+    /// Compiles (cached by source hash) and injects a controller script,
+    /// in script order. Compilation is pipelined with injection, so the
+    /// first lines run while the rest still parses; on a syntax error
+    /// everything before the bad line has already been injected.
+    pub fn execute_script(&self, script: &str) -> Result<(), NativeError> {
+        let mut error = ScriptError { line: 0, message: [0; 124] };
+        let status = unsafe {
+            nn_script_stream(script.as_ptr().cast(), script.len(), &mut error)
+        };
+        script_result(status, &error)
+    }
+
+    pub fn key(&self, key: &str, action: KeyAction) -> Result<(), NativeError> {
+        let key = std::ffi::CString::new(key).map_err(|_| NativeError::Status(-2))?;
+        let action = match action {
+            KeyAction::Tap => NN_KEY_TAP,
+            KeyAction::Down => NN_KEY_DOWN,
+            KeyAction::Up => NN_KEY_UP,
+        };
+        check(unsafe { nn_input_key(key.as_ptr(), action) })
+    }
+
+    pub fn type_text(&self, text: &str, interval_seconds: f64) -> Result<(), NativeError> {
+        check(unsafe { nn_input_type(text.as_ptr().cast(), text.len(), interval_seconds) })
+    }
+
+    pub fn move_to(&self, x: i32, y: i32, seconds: f64) -> Result<(), NativeError> {
+        check(unsafe { nn_input_move(x, y, seconds) })
+    }
+
+    pub fn click(&self, x: i32, y: i32, button: Button) -> Result<(), NativeError> {
+        check(unsafe { nn_input_click(x, y, button as u32) })
+    }
+
+    pub fn screen_size(&self) -> Result<(i32, i32), NativeError> {
+        let (mut width, mut height) = (0, 0);
+        check(unsafe { nn_input_screen_size(&mut width, &mut height) })?;
+        Ok((width, height))
+    }
+}
+
+// =====================================================
+// Executor
+// =====================================================
+
+/// A finished (or cancelled) script submitted to an Executor.
+pub struct Completed {
+    pub ticket: u64,
+    pub group: u32,
+    pub result: Result<(), NativeError>,
+}
+
+/// The native executor thread: scripts run there in submission order,
+/// so submitting never blocks. Shareable; the library locks internally.
+pub struct Executor {
+    handle: *mut c_void,
+}
+
+unsafe impl Send for Executor {}
+unsafe impl Sync for Executor {}
+
+impl Executor {
+    /// `capacity` queued scripts at most; scripts still queued after
+    /// `stale_seconds` are cancelled (0 = never).
+    pub fn open(capacity: u32, stale_seconds: f64) -> Result<Self, NativeError> {
+        let options = ExecutorOptions { capacity, stale_seconds };
+        let mut handle = std::ptr::null_mut();
+        check(unsafe { nn_executor_create(&options, &mut handle) })?;
+        Ok(Self { handle })
+    }
+
+    /// Queues a script and returns its ticket; NN_ERR_BUSY when the
+    /// queue is full. `flags`: SUBMIT_SUPERSEDE / SUBMIT_INTERRUPT.
+    pub fn submit(&self, script: &str, group: u32, flags: u32) -> Result<u64, NativeError> {
+        let mut ticket = 0;
+        check(unsafe {
+            nn_executor_submit(self.handle, script.as_ptr().cast(), script.len(), group, flags, &mut ticket)
+        })?;
+        Ok(ticket)
+    }
+
+    /// submit() without copying the script: the executor reads it in
+    /// place and drops `text` (on its own thread) once it has completed.
+    pub fn submit_owned<T>(&self, text: T, group: u32, flags: u32) -> Result<u64, NativeError>
+    where
+        T: AsRef<str> + Send + 'static,
+    {
+        unsafe extern "C" fn release<T>(user: *mut c_void) {
+            drop(unsafe { Box::from_raw(user.cast::<T>()) });
+        }
+
+        let text = Box::new(text);
+        let script = (*text).as_ref();
+        let (ptr, len) = (script.as_ptr(), script.len());
+        let user = Box::into_raw(text);
+
+        let mut ticket = 0;
+        let status = unsafe {
+            nn_executor_submit_view(self.handle, ptr.cast(), len, release::<T>, user.cast(), group, flags,
+                                    &mut ticket)
+        };
+        if status == NN_ERR_INVALID_ARGUMENT {
+            // Not taken: still ours.
+            drop(unsafe { Box::from_raw(user) });
+        }
+        check(status)?;
+        Ok(ticket)
+    }
+
+    pub fn cancel(&self, ticket: u64) -> Result<(), NativeError> {
+        check(unsafe { nn_executor_cancel(self.handle, ticket) })
+    }
+
+    /// Blocks up to `timeout_ms` (< 0 = no limit); Ok(None) on timeout,
+    /// Err once closed and every completion has been handed out.
+    pub fn next(&self, timeout_ms: i32) -> Result<Option<Completed>, NativeError> {
+        let mut completion = Completion {
+            ticket: 0,
+            group: 0,
+            status: NN_OK,
+            error: ScriptError { line: 0, message: [0; 124] },
+        };
+        match unsafe { nn_executor_next(self.handle, &mut completion, timeout_ms) } {
+            NN_OK => Ok(Some(Completed {
+                ticket: completion.ticket,
+                group: completion.group,
+                result: script_result(completion.status, &completion.error),
+            })),
+            NN_ERR_TIMEOUT => Ok(None),
+            status => Err(NativeError::Status(status)),
+        }
+    }
+
+    /// Cancels everything and refuses new scripts (NN_ERR_UNAVAILABLE).
+    pub fn close(&self) {
+        unsafe { nn_executor_close(self.handle) };
+    }
+}
+
+impl Drop for Executor {
+    fn drop(&mut self) {
+        unsafe { nn_executor_free(self.handle) };
+    }
+}
+
+/// Latest pointer position seen by the mouse hook (started by the
+/// Python monitor); None while no hook runs.
+pub fn mouse_position() -> Option<(i32, i32)> {
+    let (mut x, mut y, mut timestamp) = (0, 0, 0);
+    let status = unsafe { nn_mouse_hook_position(&mut x, &mut y, &mut timestamp) };
+    (status == NN_OK).then_some((x, y))
+}
+
+// =====================================================
+// Metrics
+// =====================================================
+
+/// The native histograms the app records into (NN_METRIC_*); the
+/// library records injection, executor and capture timings itself.
+#[derive(Clone, Copy, Debug)]
+pub enum Metric {
+    GilWait = 0,
+    GilHold = 1,
+    WsSend = 6,
+    WsRecv = 7,
+}
+
+/// Platform backend family the library was built for ("win32", "x11",
+/// "uinput" or "null").
+pub fn backend_name() -> String {
+    let name = unsafe { CStr::from_ptr(nn_backend_name(nn_backend())) };
+    name.to_string_lossy().into_owned()
+}
+
+/// The native monotonic clock (every metric and trace timestamp).
+pub fn clock_ns() -> u64 {
+    unsafe { nn_clock_ns() }
+}
+
+/// Records the time since `start_ns` into `metric` (a trace span too
+/// while tracing) and returns now.
+pub fn span_since(metric: Metric, start_ns: u64) -> u64 {
+    let now = clock_ns();
+    unsafe { nn_metrics_span(metric as u32, start_ns, now) };
+    now
+}
+
+/// Starts the trace stream: the newest `capacity` events (0 = 65536).
+pub fn start_trace(capacity: u32) -> Result<(), NativeError> {
+    check(unsafe { nn_trace_start(capacity) })
+}
+
+/// Writes the trace as Chrome trace JSON (chrome://tracing, Perfetto).
+pub fn write_trace(path: &std::path::Path) -> Result<(), NativeError> {
+    let path = c_path(path)?;
+    check(unsafe { nn_trace_write(path.as_ptr()) })
+}
+
+// =====================================================
+// History log
+// =====================================================
+
+pub const CHANNEL_ACTIONS: u64 = 0;
+pub const CHANNEL_MOUSE: u64 = 1;
+/// Record::reserved of the records naming an id (skip them).
+pub const HISTORY_NAMES: u64 = 0xFFFF_FFFF;
+
+fn c_path(path: &std::path::Path) -> Result<std::ffi::CString, NativeError> {
+    std::ffi::CString::new(path.to_string_lossy().as_bytes())
+        .map_err(|_| NativeError::Status(NN_ERR_INVALID_ARGUMENT))
+}
+
+/// Starts logging the shared action and mouse channels to the memory-
+/// mapped segment at `path` (path.1, path.2, ... once rotated; 0 =
+/// defaults: 65536 records per segment, 4 kept).
+pub fn start_history(path: &std::path::Path, segment_records: u32, keep_segments: u32) -> Result<(), NativeError> {
+    let path = c_path(path)?;
+    let options = HistoryOptions { segment_records, keep_segments, rotate_seconds: 0, reserved: 0 };
+    check(unsafe { nn_history_start(path.as_ptr(), &options) })
+}
+
+/// One history segment, mapped read-only: the slices borrow the mapping,
+/// nothing is copied. The live segment grows between calls.
+pub struct HistoryFile {
+    handle: *mut c_void,
+}
+
+unsafe impl Send for HistoryFile {}
+unsafe impl Sync for HistoryFile {}
+
+impl HistoryFile {
+    pub fn open(path: &std::path::Path) -> Result<Self, NativeError> {
+        let path = c_path(path)?;
+        let mut handle = std::ptr::null_mut();
+        check(unsafe { nn_history_open(path.as_ptr(), &mut handle) })?;
+        Ok(Self { handle })
+    }
+
+    fn slice(&self, first: *const Record, count: usize) -> &[Record] {
+        if count == 0 {
+            return &[];
+        }
+        unsafe { std::slice::from_raw_parts(first, count) }
+    }
+
+    /// Every committed record, oldest first.
+    pub fn records(&self) -> &[Record] {
+        let mut first = std::ptr::null();
+        let count = unsafe { nn_history_records(self.handle, &mut first) };
+        self.slice(first, count)
+    }
+
+    /// The records stamped within `range` (Unix-epoch ns).
+    pub fn range(&self, range: std::ops::Range<u64>) -> &[Record] {
+        let mut first = std::ptr::null();
+        let count = unsafe { nn_history_range(self.handle, range.start, range.end, &mut first) };
+        self.slice(first, count)
+    }
+
+    /// The source/type name the segment recorded for `id`.
+    pub fn name_of(&self, id: u16) -> Option<&str> {
+        let name = unsafe { nn_history_name_of(self.handle, id) };
+        if name.is_null() {
+            return None;
+        }
+        unsafe { CStr::from_ptr(name) }.to_str().ok()
+    }
+}
+
+impl Drop for HistoryFile {
+    fn drop(&mut self) {
+        unsafe { nn_history_close(self.handle) };
+    }
+}
+
+// =====================================================
+// Window state
+// =====================================================
+
+pub struct Window {
+    pub id: u64,
+    pub pid: u32,
+    pub title: String,
+}
+
+/// Starts the process-wide window cache; Ok when it is (already) running.
+pub fn start_window_cache() -> Result<(), NativeError> {
+    match unsafe { nn_window_cache_start() } {
+        NN_ERR_BUSY => Ok(()),
+        status => check(status),
+    }
+}
+
+/// Bumped on every window change; compare before taking a snapshot.
+pub fn window_cache_version() -> u64 {
+    unsafe { nn_window_cache_version() }
+}
+
+/// Visible top-level windows in OS order and the index of the active one.
+pub fn windows() -> Result<(Vec<Window>, Option<usize>), NativeError> {
+    let mut snapshot = std::ptr::null_mut();
+    check(unsafe { nn_window_snapshot_get(&mut snapshot) })?;
+
+    let count = unsafe { nn_window_snapshot_count(snapshot) };
+    let mut windows = Vec::with_capacity(count);
+    for index in 0..count {
+        let mut info = WindowInfo { id: 0, pid: 0, title_len: 0, title: std::ptr::null() };
+        if unsafe { nn_window_snapshot_window(snapshot, index, &mut info) } != NN_OK {
+            continue;
+        }
+        let title = unsafe { std::slice::from_raw_parts(info.title.cast::<u8>(), info.title_len as usize) };
+        windows.push(Window {
+            id: info.id,
+            pid: info.pid,
+            title: String::from_utf8_lossy(title).into_owned(),
+        });
+    }
+    let active = unsafe { nn_window_snapshot_active(snapshot) };
+
+    unsafe { nn_window_snapshot_free(snapshot) };
+    Ok((windows, usize::try_from(active).ok()))
+}
+
+// =====================================================
+// Accessibility tree
+// =====================================================
+
+/// Starts the foreground window's accessibility tree; Ok when it is
+/// (already) running.
+pub fn start_ui_tree() -> Result<(), NativeError> {
+    match unsafe { nn_ui_tree_start() } {
+        NN_ERR_BUSY => Ok(()),
+        status => check(status),
+    }
+}
+
+/// Bumped on every tree change; compare before taking a snapshot.
+pub fn ui_tree_version() -> u64 {
+    unsafe { nn_ui_tree_version() }
+}
+
+/// Compact text form of the tree, at most `capacity` bytes: one line per
+/// element, indented by depth, the first line being the window.
+pub fn ui_text(capacity: usize) -> Result<String, NativeError> {
+    let mut snapshot = std::ptr::null_mut();
+    check(unsafe { nn_ui_snapshot_get(&mut snapshot) })?;
+
+    let mut buffer = vec![0u8; capacity + 1];
+    let mut len = 0usize;
+    let status = unsafe { nn_ui_snapshot_text(snapshot, buffer.as_mut_ptr().cast(), buffer.len(), &mut len) };
+    unsafe { nn_ui_snapshot_free(snapshot) };
+    check(status)?;
+
+    buffer.truncate(len);
+    Ok(String::from_utf8_lossy(&buffer).into_owned())
+}
+
+// =====================================================
+// Process tracking
+// =====================================================
+
+/// Incremental process table. Names are interned natively; `names`
+/// mirrors the table as it grows, so each is decoded once.
+pub struct ProcessTracker {
+    handle: *mut c_void,
+    names: Vec<String>,
+}
+
+// The handle is only ever used through &mut self.
+unsafe impl Send for ProcessTracker {}
+
+/// (pid, name id) pairs; resolve ids with ProcessTracker::name.
+pub type ProcessList = Vec<(u32, u32)>;
+
+impl ProcessTracker {
+    pub fn open() -> Result<Self, NativeError> {
+        let mut handle = std::ptr::null_mut();
+        check(unsafe { nn_process_tracker_create(&mut handle) })?;
+        Ok(Self { handle, names: Vec::new() })
+    }
+
+    /// (added, removed) since the previous refresh; the first one lists
+    /// every process as added. Apply the removals first.
+    pub fn refresh(&mut self) -> Result<(ProcessList, ProcessList), NativeError> {
+        check(unsafe { nn_process_tracker_refresh(self.handle) })?;
+
+        let count = unsafe { nn_process_name_count(self.handle) };
+        for id in self.names.len()..count {
+            let mut len = 0;
+            let name = unsafe { nn_process_name(self.handle, id as u32, &mut len) };
+            let bytes = unsafe { std::slice::from_raw_parts(name.cast::<u8>(), len as usize) };
+            self.names.push(String::from_utf8_lossy(bytes).into_owned());
+        }
+
+        let deltas = |fetch: unsafe extern "C" fn(*const c_void, *mut usize) -> *const ProcessDelta| {
+            let mut count = 0;
+            let list = unsafe { fetch(self.handle, &mut count) };
+            if list.is_null() {
+                return Vec::new();
+            }
+            unsafe { std::slice::from_raw_parts(list, count) }
+                .iter()
+                .map(|delta| (delta.pid, delta.name_id))
+                .collect()
+        };
+        Ok((deltas(nn_process_tracker_added), deltas(nn_process_tracker_removed)))
+    }
+
+    pub fn name(&self, id: u32) -> &str {
+        self.names.get(id as usize).map_or("", String::as_str)
+    }
+}
+
+impl Drop for ProcessTracker {
+    fn drop(&mut self) {
+        unsafe { nn_process_tracker_free(self.handle) };
+    }
+}
+
+// =====================================================
+// Frame capture and encoding
+// =====================================================
+
+/// Persistent capture session on one output. Shareable; the library
+/// locks internally.
+pub struct Capture {
+    handle: *mut c_void,
+}
+
+unsafe impl Send for Capture {}
+unsafe impl Sync for Capture {}
+
+impl Capture {
+    pub fn open(output: i32) -> Result<Self, NativeError> {
+        let options = CaptureOptions { output, ring_slots: 0 };
+        let mut handle = std::ptr::null_mut();
+        check(unsafe { nn_capture_open(&options, &mut handle) })?;
+        Ok(Self { handle })
+    }
+
+    /// Leases the next frame (the previous one again, marked unchanged,
+    /// when nothing new arrived within `timeout_ms`).
+    pub fn grab(&self, timeout_ms: u32) -> Result<Frame<'_>, NativeError> {
+        let mut raw = RawFrame {
+            data: std::ptr::null(),
+            width: 0,
+            height: 0,
+            stride: 0,
+            format: 0,
+            slot: 0,
+            flags: 0,
+            sequence: 0,
+            timestamp_ns: 0,
+        };
+        check(unsafe { nn_capture_grab(self.handle, timeout_ms, &mut raw) })?;
+        Ok(Frame { capture: self, raw })
+    }
+}
+
+impl Drop for Capture {
+    fn drop(&mut self) {
+        unsafe { nn_capture_close(self.handle) };
+    }
+}
+
+/// A leased capture slot, returned to the ring on drop.
+pub struct Frame<'a> {
+    capture: &'a Capture,
+    raw: RawFrame,
+}
+
+impl Frame<'_> {
+    pub fn unchanged(&self) -> bool {
+        self.raw.flags & NN_FRAME_UNCHANGED != 0
+    }
+
+    pub fn sequence(&self) -> u64 {
+        self.raw.sequence
+    }
+}
+
+impl Drop for Frame<'_> {
+    fn drop(&mut self) {
+        unsafe { nn_capture_release(self.capture.handle, self.raw.slot) };
+    }
+}
+
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum Codec {
+    Raw = 0,
+    Jpeg = 1,
+    Webp = 2,
+}
+
+#[derive(Clone, Copy, Debug)]
+pub struct EncodeOptions {
+    pub codec: Codec,
+    pub quality: i32,
+    /// Downscaled to fit, aspect kept; 0 = no limit.
+    pub max_width: i32,
+    pub max_height: i32,
+    pub threads: u32,
+    /// Packets in flight, submitted to dropped.
+    pub buffers: u32,
+}
+
+/// Native encoder pool fed from one Capture, which it keeps alive for
+/// as long as it may hold leases on it.
+pub struct Encoder {
+    handle: *mut c_void,
+    capture: Arc<Capture>,
+}
+
+unsafe impl Send for Encoder {}
+unsafe impl Sync for Encoder {}
+
+impl Encoder {
+    pub fn open(capture: Arc<Capture>, options: &EncodeOptions) -> Result<Arc<Self>, NativeError> {
+        let raw = EncoderOptions {
+            codec: options.codec as u32,
+            quality: options.quality,
+            max_width: options.max_width,
+            max_height: options.max_height,
+            filter: 0,
+            threads: options.threads,
+            buffers: options.buffers,
+        };
+        let mut handle = std::ptr::null_mut();
+        check(unsafe { nn_encoder_create(&raw, &mut handle) })?;
+        Ok(Arc::new(Self { handle, capture }))
+    }
+
+    /// Hands the frame's lease to the encoder. Busy when every buffer is
+    /// in flight; the frame is released then (the caller has fallen
+    /// behind, so the next one will do).
+    pub fn submit(&self, frame: Frame<'_>) -> Result<(), NativeError> {
+        assert!(std::ptr::eq(frame.capture, &*self.capture), "frame from another capture session");
+        let status = unsafe {
+            nn_encoder_submit(self.handle, self.capture.handle, &frame.raw, std::ptr::null(), 0)
+        };
+        if status == NN_OK {
+            std::mem::forget(frame); // the encoder returns the lease
+        }
+        check(status)
+    }
+
+    /// Next packet in submission order, waiting up to `timeout_ms`
+    /// (< 0 = no limit). Ok(None) on timeout, and for a frame that failed
+    /// to encode or was cancelled at close (released here, nothing to
+    /// send); Err once closed and drained.
+    pub fn next(self: &Arc<Self>, timeout_ms: i32) -> Result<Option<Packet>, NativeError> {
+        let mut raw = RawPacket {
+            id: 0,
+            status: NN_OK,
+            codec: 0,
+            width: 0,
+            height: 0,
+            source_width: 0,
+            source_height: 0,
+            sequence: 0,
+            timestamp_ns: 0,
+            data: std::ptr::null(),
+            size: 0,
+            rects: std::ptr::null(),
+            rect_count: 0,
+        };
+        match unsafe { nn_encoder_next(self.handle, &mut raw, timeout_ms) } {
+            NN_OK => {
+                let packet = Packet { encoder: self.clone(), raw };
+                if packet.raw.status != NN_OK {
+                    return Ok(None);
+                }
+                Ok(Some(packet))
+            }
+            NN_ERR_TIMEOUT => Ok(None),
+            status => Err(NativeError::Status(status)),
+        }
+    }
+
+    /// Refuses new frames; next() fails once the queued ones are out.
+    pub fn close(&self) {
+        unsafe { nn_encoder_close(self.handle) };
+    }
+}
+
+impl Drop for Encoder {
+    fn drop(&mut self) {
+        // Joins the workers, so every lease is back before `capture` goes.
+        unsafe { nn_encoder_free(self.handle) };
+    }
+}
+
+/// Perceptual hashes of observed frames (all-default native options):
+/// tells a frame that merely re-renders the same screen from one that
+/// changed.
+pub struct ScreenCache {
+    handle: *mut c_void,
+}
+
+// The handle is only ever used through &self from one thread at a time;
+// the library locks internally anyway.
+unsafe impl Send for ScreenCache {}
+
+impl ScreenCache {
+    pub fn open() -> Result<Self, NativeError> {
+        let options = ScreenCacheOptions { capacity: 0, tile_size: 0, history: 0, threshold: 0 };
+        let mut handle = std::ptr::null_mut();
+        check(unsafe { nn_screen_cache_create(&options, &mut handle) })?;
+        Ok(Self { handle })
+    }
+
+    pub fn observe(&self, frame: &Frame<'_>) -> Result<ScreenObservation, NativeError> {
+        let mut out = ScreenObservation::default();
+        check(unsafe { nn_screen_cache_observe(self.handle, &frame.raw, &mut out) })?;
+        Ok(out)
+    }
+
+    /// Tiles changed between frame `sequence` and the latest observed
+    /// one; Err once that frame has left the cache's history.
+    pub fn changed_since(&self, sequence: u64) -> Result<u32, NativeError> {
+        let mut changed = 0;
+        check(unsafe { nn_screen_cache_changed_since(self.handle, sequence, &mut changed) })?;
+        Ok(changed)
+    }
+}
+
+impl Drop for ScreenCache {
+    fn drop(&mut self) {
+        unsafe { nn_screen_cache_free(self.handle) };
+    }
+}
+
+/// An encoded frame, read in place from the encoder's buffer; the buffer
+/// goes back to the pool on drop.
+pub struct Packet {
+    encoder: Arc<Encoder>,
+    raw: RawPacket,
+}
+
+unsafe impl Send for Packet {}
+
+impl Packet {
+    /// Encoded size.
+    pub fn size(&self) -> (i32, i32) {
+        (self.raw.width, self.raw.height)
+    }
+
+    /// Capture sequence number of the frame.
+    pub fn sequence(&self) -> u64 {
+        self.raw.sequence
+    }
+
+    pub fn timestamp_ns(&self) -> u64 {
+        self.raw.timestamp_ns
+    }
+}
+
+impl fmt::Debug for Packet {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("Packet")
+            .field("sequence", &self.raw.sequence)
+            .field("size", &self.size())
+            .field("bytes", &self.raw.size)
+            .finish()
+    }
+}
+
+impl std::ops::Deref for Packet {
+    type Target = [u8];
+
+    fn deref(&self) -> &[u8] {
+        if self.raw.size == 0 {
+            return &[];
+        }
+        unsafe { std::slice::from_raw_parts(self.raw.data, self.raw.size) }
+    }
+}
+
+impl Drop for Packet {
+    fn drop(&mut self) {
+        unsafe { nn_encoder_release(self.encoder.handle, self.raw.id) };
+    }
+}
+
+// Checks the native compiler against the Python fallback parser
+// (backend/python/controller/actions.py): the expectations are what
+// ActionParser._parse_lines produces for the same scripts.
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const NN_OP_TYPE: u16 = 1;
+    const NN_OP_PRESS: u16 = 2;
+    const NN_OP_SHORTCUT: u16 = 5;
+    const NN_OP_MOVE_N: u16 = 7;
+    const NN_OP_CLICK: u16 = 8;
+    const NN_OP_CLICK_N: u16 = 9;
+    const NN_OP_PATH: u16 = 10;
+    const NN_OP_WAIT: u16 = 11;
+
+    const NN_LANE_KEYBOARD: u32 = 0;
+    const NN_TEXT_LAYOUT: u32 = 0;
+    const NN_TEXT_UNICODE: u32 = 1;
+
+    #[repr(C)]
+    struct Op {
+        code: u16,
+        button: u16,
+        line: u32,
+        x: i32,
+        y: i32,
+        index: u32,
+        count: u32,
+        seconds: f64,
+        nx: f64,
+        ny: f64,
+    }
+
+    #[repr(C)]
+    #[derive(Clone, Copy, Debug, PartialEq, Eq)]
+    struct Point {
+        x: i32,
+        y: i32,
+    }
+
+    type Callback = Option<unsafe extern "C" fn()>;
+
+    #[repr(C)]
+    struct ScriptHost {
+        user: *mut c_void,
+        type_text: Callback,
+        key: Callback,
+        shortcut: Callback,
+        move_to: Option<unsafe extern "C" fn(*mut c_void, i32, i32, f64) -> NnStatus>,
+        click: Option<unsafe extern "C" fn(*mut c_void, i32, i32, u32) -> NnStatus>,
+        path: Callback,
+        wait: Callback,
+        screen_size: Option<unsafe extern "C" fn(*mut c_void, *mut i32, *mut i32) -> NnStatus>,
+        flush: Callback,
+    }
+
+    #[repr(C)]
+    struct Action {
+        code: u16,
+        lane: u16,
+        arg: u32,
+        x: i32,
+        y: i32,
+        offset: u32,
+        count: u32,
+        seconds: f64,
+    }
+
+    #[repr(C)]
+    struct TextOptions {
+        mode: u32,
+        paste_threshold: u32,
+    }
+
+    unsafe extern "C" {
+        fn nn_script_compile(text: *const c_char, len: usize, out: *mut *mut c_void, error: *mut ScriptError)
+            -> NnStatus;
+        fn nn_script_free(script: *mut c_void);
+        fn nn_script_ops(script: *const c_void, count: *mut usize) -> *const Op;
+        fn nn_script_string(script: *const c_void, index: u32, len: *mut u32) -> *const c_char;
+        fn nn_script_points(script: *const c_void, index: u32) -> *const Point;
+        fn nn_script_run(script: *const c_void, host: *const ScriptHost) -> NnStatus;
+
+        fn nn_input_set_text_options(options: *const TextOptions) -> NnStatus;
+
+        fn nn_action_queue_create(out: *mut *mut c_void) -> NnStatus;
+        fn nn_action_queue_free(queue: *mut c_void);
+        fn nn_action_queue_key(queue: *mut c_void, lane: u32, key: *const c_char, action: u32, repeat: u32)
+            -> NnStatus;
+        fn nn_action_queue_type(queue: *mut c_void, lane: u32, text: *const c_char, len: usize,
+                                interval_seconds: f64) -> NnStatus;
+        fn nn_action_queue_records(queue: *const c_void, count: *mut usize) -> *const Action;
+        fn nn_action_queue_payload(queue: *const c_void, offset: u32) -> *const c_void;
+    }
+
+    struct Script(*mut c_void);
+
+    impl Script {
+        fn compile(text: &str) -> Result<Self, String> {
+            let mut handle = std::ptr::null_mut();
+            let mut error = ScriptError { line: 0, message: [0; 124] };
+            let status = unsafe { nn_script_compile(text.as_ptr().cast(), text.len(), &mut handle, &mut error) };
+            match script_result(status, &error) {
+                Ok(()) => Ok(Self(handle)),
+                // What ActionParser._syntax_error puts before the source line.
+                Err(NativeError::Syntax { line, message }) => Err(format!("Line {line}: {message}")),
+                Err(e) => panic!("compile failed: {e}"),
+            }
+        }
+
+        fn ops(&self) -> &[Op] {
+            let mut count = 0;
+            let ops = unsafe { nn_script_ops(self.0, &mut count) };
+            if count == 0 { &[] } else { unsafe { std::slice::from_raw_parts(ops, count) } }
+        }
+
+        fn string(&self, index: u32) -> String {
+            let mut len = 0;
+            let text = unsafe { nn_script_string(self.0, index, &mut len) };
+            let bytes = unsafe { std::slice::from_raw_parts(text.cast::<u8>(), len as usize) };
+            String::from_utf8_lossy(bytes).into_owned()
+        }
+
+        fn points(&self, op: &Op) -> Vec<Point> {
+            if op.count == 0 {
+                return Vec::new();
+            }
+            unsafe { std::slice::from_raw_parts(nn_script_points(self.0, op.index), op.count as usize) }.to_vec()
+        }
+    }
+
+    impl Drop for Script {
+        fn drop(&mut self) {
+            unsafe { nn_script_free(self.0) };
+        }
+    }
+
+    /// The script's ops the way the Python controllers would be called.
+    fn calls(text: &str) -> Result<Vec<String>, String> {
+        let script = Script::compile(text)?;
+        Ok(script.ops().iter().map(|op| match op.code {
+            NN_OP_TYPE => format!("TYPE {}", script.string(op.index)),
+            NN_OP_PRESS => format!("PRESS {}", script.string(op.index)),
+            NN_OP_SHORTCUT => {
+                let keys: Vec<_> = (0..op.count).map(|i| script.string(op.index + i)).collect();
+                format!("SHORTCUT {}", keys.join(" "))
+            }
+            NN_OP_CLICK => format!("CLICK {} {} {}", op.x, op.y, op.button),
+            NN_OP_PATH => format!("PATH {:?}", script.points(op).iter().map(|p| (p.x, p.y)).collect::<Vec<_>>()),
+            NN_OP_WAIT => format!("WAIT {}", op.seconds),
+            code => format!("op {code} line {}", op.line),
+        }).collect())
+    }
+
+    fn error(text: &str) -> String {
+        calls(text).expect_err(text)
+    }
+
+    #[test]
+    fn quoting_matches_shlex() {
+        assert_eq!(calls(r#"TYPE 'a  b' "c \"d\" \\e" f\ g"#).unwrap(), [r#"TYPE a  b c "d" \e f g"#]);
+        assert_eq!(calls(r#"PRESS "ctrl""#).unwrap(), ["PRESS ctrl"]);
+        // Backslashes are literal in '...' and before anything but " and \ in "...".
+        assert_eq!(calls(r#"TYPE "a\nb""#).unwrap(), [r"TYPE a\nb"]);
+        assert_eq!(calls(r"TYPE 'a\b'").unwrap(), [r"TYPE a\b"]);
+
+        assert_eq!(error("TYPE it's"), "Line 1: No closing quotation");
+        assert_eq!(error(r#"TYPE "bad"#), "Line 1: No closing quotation");
+        assert_eq!(error(r"TYPE x\"), "Line 1: No escaped character");
+    }
+
+    #[test]
+    fn commands_are_case_insensitive() {
+        assert_eq!(calls("type x\nenter\nShortcut ctrl c").unwrap(), ["TYPE x", "PRESS enter", "SHORTCUT ctrl c"]);
+        assert_eq!(calls("CLICK 1 2 right").unwrap(), ["CLICK 1 2 3"]);
+    }
+
+    #[test]
+    fn line_steps() {
+        assert_eq!(calls("LINE 0 0 10 5 STEPS 4").unwrap(), ["PATH [(0, 0), (2, 1), (5, 2), (7, 3), (10, 5)]"]);
+        // range(steps + 1) is empty: an empty path, not an error.
+        assert_eq!(calls("LINE 0 0 10 10 STEPS -3").unwrap(), ["PATH []"]);
+        assert_eq!(error("LINE 0 0 10 10 STEPS 0"), "Line 1: division by zero");
+        assert_eq!(error("LINE 0 0 1 1 STEPS"), "Line 1: list index out of range");
+    }
+
+    unsafe extern "C" fn record_move(user: *mut c_void, x: i32, y: i32, _seconds: f64) -> NnStatus {
+        unsafe { (*user.cast::<Vec<Point>>()).push(Point { x, y }) };
+        NN_OK
+    }
+
+    unsafe extern "C" fn record_click(user: *mut c_void, x: i32, y: i32, _button: u32) -> NnStatus {
+        unsafe { record_move(user, x, y, 0.0) }
+    }
+
+    unsafe extern "C" fn screen_1080p(_user: *mut c_void, width: *mut i32, height: *mut i32) -> NnStatus {
+        unsafe {
+            *width = 1920;
+            *height = 1080;
+        }
+        NN_OK
+    }
+
+    #[test]
+    fn normalized_coordinates_truncate() {
+        let script = Script::compile("MOVE_N 0.5 0.3333\nCLICK_N 0.9999 -0.0004\nMOVE_N 0.25 0.75").unwrap();
+        let codes: Vec<_> = script.ops().iter().map(|op| op.code).collect();
+        assert_eq!(codes, [NN_OP_MOVE_N, NN_OP_CLICK_N, NN_OP_MOVE_N]);
+
+        let mut points: Vec<Point> = Vec::new();
+        let host = ScriptHost {
+            user: (&mut points as *mut Vec<Point>).cast(),
+            type_text: None,
+            key: None,
+            shortcut: None,
+            move_to: Some(record_move),
+            click: Some(record_click),
+            path: None,
+            wait: None,
+            screen_size: Some(screen_1080p),
+            flush: None,
+        };
+        assert_eq!(unsafe { nn_script_run(script.0, &host) }, NN_OK);
+        // int(nx * width): toward zero, so -0.77 px is 0 as well.
+        assert_eq!(points, [Point { x: 960, y: 359 }, Point { x: 1919, y: 0 }, Point { x: 480, y: 810 }]);
+    }
+
+    #[test]
+    fn errors_carry_python_messages_and_lines() {
+        // Counted after strip(), blank and comment lines included.
+        assert_eq!(error("# c\n\n  TYPE ok\nMOVE 1 x"), "Line 4: invalid literal for int() with base 10: 'x'");
+        assert_eq!(error("\n\n  TYPE ok\n\nFOO"), "Line 3: Unknown command: FOO");
+        assert_eq!(error("ENTER\nFOO bar"), "Line 2: Unknown command: FOO");
+        assert_eq!(error("MOVE 1.5 2"), "Line 1: invalid literal for int() with base 10: '1.5'");
+        assert_eq!(error("WAIT abc"), "Line 1: could not convert string to float: 'abc'");
+        assert_eq!(error("PATH 1 2 3"), "Line 1: PATH requires even number of coordinates");
+        assert_eq!(error("PRESS"), "Line 1: PRESS key");
+        assert_eq!(error("SHORTCUT"), "Line 1: SHORTCUT key1 key2 ...");
+        assert_eq!(error("TYPE"), "Line 1: TYPE requires quoted text");
+    }
+
+    struct Queue(*mut c_void);
+
+    impl Queue {
+        fn new() -> Self {
+            let mut handle = std::ptr::null_mut();
+            check(unsafe { nn_action_queue_create(&mut handle) }).unwrap();
+            Self(handle)
+        }
+
+        fn tap(&self, key: &str, repeat: u32) -> &Self {
+            let key = std::ffi::CString::new(key).unwrap();
+            check(unsafe { nn_action_queue_key(self.0, NN_LANE_KEYBOARD, key.as_ptr(), NN_KEY_TAP, repeat) })
+                .unwrap();
+            self
+        }
+
+        fn text(&self, text: &str) -> &Self {
+            check(unsafe { nn_action_queue_type(self.0, NN_LANE_KEYBOARD, text.as_ptr().cast(), text.len(), 0.0) })
+                .unwrap();
+            self
+        }
+
+        fn records(&self) -> Vec<String> {
+            let mut count = 0;
+            let records = unsafe { nn_action_queue_records(self.0, &mut count) };
+            let records = if count == 0 { &[] } else { unsafe { std::slice::from_raw_parts(records, count) } };
+            records.iter().map(|record| {
+                let payload = unsafe { nn_action_queue_payload(self.0, record.offset) }.cast::<u8>();
+                let bytes = unsafe { std::slice::from_raw_parts(payload, record.count as usize) };
+                let payload = String::from_utf8_lossy(bytes);
+                match record.code {
+                    NN_OP_TYPE => format!("TYPE {payload:?}"),
+                    NN_OP_PRESS => format!("PRESS {payload} x{}", record.arg),
+                    code => format!("op {code}"),
+                }
+            }).collect()
+        }
+    }
+
+    impl Drop for Queue {
+        fn drop(&mut self) {
+            unsafe { nn_action_queue_free(self.0) };
+        }
+    }
+
+    fn set_text_options(mode: u32, paste_threshold: u32) {
+        check(unsafe { nn_input_set_text_options(&TextOptions { mode, paste_threshold }) }).unwrap();
+    }
+
+    // One test: the text options are process-wide.
+    #[test]
+    fn action_queue_coalescing() {
+        let queue = Queue::new();
+        queue.text("ab").text("c").tap("enter", 1).tap("tab", 1).tap("x", 2).tap("7", 1).tap("space", 1);
+        assert_eq!(queue.records(), [r#"TYPE "abc\n\txx7 ""#]);
+
+        // Taps repeat; keys that are not characters never fold into text.
+        let queue = Queue::new();
+        queue.tap("enter", 1).tap("enter", 2).text("a").tap("f5", 1).tap("A", 1).tap("f5", 1);
+        assert_eq!(queue.records(), ["PRESS enter x3", r#"TYPE "a""#, "PRESS f5 x1", "PRESS A x1", "PRESS f5 x1"]);
+
+        // Unicode or pasted text would not send these as the keys they are.
+        for (mode, paste_threshold) in [(NN_TEXT_UNICODE, 0), (NN_TEXT_LAYOUT, 8)] {
+            set_text_options(mode, paste_threshold);
+            let queue = Queue::new();
+            queue.text("ab").tap("enter", 1).tap("x", 1);
+            assert_eq!(queue.records(), [r#"TYPE "ab""#, "PRESS enter x1", "PRESS x x1"]);
+        }
+        set_text_options(NN_TEXT_LAYOUT, 0);
+    }
+}
@@ -1,8 +1,9 @@
 import shlex
-from typing import List, Tuple
+from typing import List, Optional, Tuple
 
+from . import native
 from .controls.keyboard import KeyboardController
-from .controls.mouse import MouseController, Point
+from .controls.mouse import MouseController, Point, from_record as mouse_record
 from .desktop import DesktopMonitor
 
 
@@ -10,9 +11,24 @@ class ActionParseError(Exception):
     pass
 
 
+_BUTTON_NAMES = {
+    native.NN_BUTTON_LEFT: "left",
+    native.NN_BUTTON_MIDDLE: "middle",
+    native.NN_BUTTON_RIGHT: "right",
+}
+
+
 class ActionParser:
     """
     Unified keyboard + mouse action parser.
+
+    With neuro_native available, scripts are compiled to bytecode once
+    (cached natively by source hash) and interpreted straight onto the
+    controllers; otherwise every line goes through shlex below.
+
+    Scripts are sequential: each command is followed by a barrier on
+    the shared InstructionTimeline, and WAIT is a single barrier delay
+    rather than one wait per device queue.
     """
 
     def __init__(self, keyboard: KeyboardController, mouse: MouseController, monitor: DesktopMonitor):
@@ -20,11 +36,65 @@ class ActionParser:
         self.mouse = mouse
         self.monitor = monitor
 
+        # Barriers only work when both queues share one timeline.
+        self.timeline = keyboard.timeline
+        if mouse.timeline is not self.timeline:
+            mouse.timeline = self.timeline
+            self.timeline.attach(native.NN_LANE_MOUSE, mouse.instruction_queue, mouse_record)
+
+        self._host = self._make_host() if native.load() is not None else None
+        self._host_error: Optional[BaseException] = None
+
     # ------------------------
     # Public API
     # ------------------------
 
     def parse(self, script: str):
+        if self._host is None:
+            return self._parse_lines(script)
+
+        try:
+            program = native.compile_script(script)
+        except native.ScriptSyntaxError as e:
+            raise self._syntax_error(script, e) from e
+
+        self.monitor.record_action(
+            source="parser",
+            action_type="SCRIPT",
+            data={"hash": program.hash, "ops": len(program.ops)}
+        )
+
+        self._host_error = None
+        status = program.run(self._host)
+        if status != native.NN_OK:
+            error, self._host_error = self._host_error, None
+            if error is not None:
+                raise error
+            raise native.NativeError(status, "script_run")
+
+    def stream(self, script: str):
+        """
+        Parses and runs `script` pipelined, so input starts before the
+        whole script is parsed: natively the compiler runs line by line
+        ahead of the injector, otherwise each line runs as soon as it
+        parses. A syntax error is still an ActionParseError with its line
+        number, raised after the lines before it have run.
+        """
+        try:
+            if native.execute_script(script, stream=True):
+                return
+        except native.ScriptSyntaxError as e:
+            raise self._syntax_error(script, e) from e
+
+        self._parse_lines(script, execute=True)
+
+    @staticmethod
+    def _syntax_error(script: str, e: "native.ScriptSyntaxError") -> ActionParseError:
+        lines = script.strip().splitlines()
+        line = lines[e.line - 1].strip() if 0 < e.line <= len(lines) else ""
+        return ActionParseError(f"Line {e.line}: {line}\n→ {e.message}")
+
+    def _parse_lines(self, script: str, execute: bool = False):
         lines = script.strip().splitlines()
 
         for line_no, raw_line in enumerate(lines, start=1):
@@ -35,13 +105,81 @@ class ActionParser:
 
             try:
                 self._parse_line(line)
+                self.timeline.sync()
+                if execute:
+                    self.timeline.execute()
             except Exception as e:
                 raise ActionParseError(
                     f"Line {line_no}: {line}\n→ {e}"
                 ) from e
 
     # ------------------------
-    # Line parser
+    # Native interpreter host
+    # ------------------------
+
+    def _make_host(self) -> "native.ScriptHost":
+        def guarded(fn):
+            def call(*args):
+                try:
+                    fn(*args[1:])  # drop the user pointer
+                    self.timeline.sync()
+                    return native.NN_OK
+                except BaseException as e:  # surfaced again by parse()
+                    self._host_error = e
+                    return native.NN_ERR_FAILED
+            return call
+
+        def type_text(text, length):
+            self.kbd.type(text.decode("utf-8", "surrogateescape"))
+
+        def key(code, name):
+            name = name.decode("utf-8", "surrogateescape")
+            if code == native.NN_OP_PRESS:
+                self.kbd.press(name)
+            elif code == native.NN_OP_HOLD:
+                self.kbd.hold(name)
+            else:
+                self.kbd.release(name)
+
+        def shortcut(keys, count):
+            self.kbd.shortcut(*(keys[i].decode("utf-8", "surrogateescape") for i in range(count)))
+
+        def move(x, y, seconds):
+            self.mouse.queue_move(x, y, seconds)
+
+        def click(x, y, button):
+            self.mouse.queue_click(x, y, _BUTTON_NAMES.get(button, "left"))
+
+        def path(points, count, step_seconds):
+            self.mouse.queue_path([(points[i].x, points[i].y) for i in range(count)], step_seconds)
+
+        def wait(seconds):
+            self._sync(seconds)
+
+        def flush():
+            # Before CLICK_IMAGE grabs the screen: what is queued so far
+            # has to have run.
+            self.timeline.execute()
+
+        def screen_size(width, height):
+            width[0] = self.mouse.screen_width
+            height[0] = self.mouse.screen_height
+
+        return native.ScriptHost(
+            None,
+            native._TypeTextFn(guarded(type_text)),
+            native._KeyFn(guarded(key)),
+            native._ShortcutFn(guarded(shortcut)),
+            native._MoveFn(guarded(move)),
+            native._ClickFn(guarded(click)),
+            native._PathFn(guarded(path)),
+            native._WaitFn(guarded(wait)),
+            native._ScreenSizeFn(guarded(screen_size)),
+            native._FlushFn(guarded(flush)),
+        )
+
+    # ------------------------
+    # Line parser (fallback)
     # ------------------------
 
     def _parse_line(self, line: str):
@@ -89,6 +227,10 @@ class ActionParser:
         elif cmd == "CLICK_N":
             self._mouse_click_normalized(tokens)
 
+        elif cmd == "CLICK_IMAGE":
+            # Needs the native locator (templates live there).
+            raise ActionParseError("CLICK_IMAGE requires neuro_native")
+
         elif cmd == "LINE":
             self._mouse_line(tokens)
 
@@ -199,5 +341,12 @@ class ActionParser:
         if len(tokens) != 2:
             raise ActionParseError("WAIT seconds")
         seconds = float(tokens[1])
-        self.kbd.wait(seconds)
-        self.mouse.queue_wait(seconds)
+        self._sync(seconds)
+
+    def _sync(self, seconds: float):
+        self.monitor.record_action(
+            source="parser",
+            action_type="WAIT",
+            data={"seconds": seconds}
+        )
+        self.timeline.sync(seconds)
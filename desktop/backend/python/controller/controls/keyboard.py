@@ -1,21 +1,53 @@
-import time
-import pyautogui
-from typing import List, Union
+from typing import List, Optional, Union
+from .. import native
+from ..lazy import lazy_import
 from ..desktop import DesktopMonitor
+from .timeline import InstructionTimeline
+
+pyautogui = lazy_import("pyautogui")  # fallback driver, imported on first use
+
 
 class KeyboardInstruction:
+    sequence = 0  # InstructionTimeline stamp
+
     def execute(self):
         raise NotImplementedError
 
+    def enqueue(self, batch: "native.InputBatch"):
+        """
+        Adds this instruction to a native injection batch. The default
+        sends what is pending and runs the pyautogui path.
+        """
+        batch.send()
+        self.execute()
+
+    def schedule(self, timeline: "native.Timeline", lane: int):
+        """
+        Places this instruction on a native timeline lane. The default
+        runs what is scheduled so far, then the pyautogui path.
+        """
+        timeline.run()
+        self.execute()
+
 
 class KeyTap(KeyboardInstruction):
-    def __init__(self, key: str, delay: float = 0.02):
+    def __init__(self, key: str, delay: float = 0.02, presses: int = 1):
         self.key = key
         self.delay = delay
+        self.presses = presses
 
     def execute(self):
-        pyautogui.press(self.key)
-        time.sleep(self.delay)
+        for _ in range(self.presses):
+            pyautogui.press(self.key)
+            native.sleep(self.delay)
+
+    def enqueue(self, batch):
+        for _ in range(self.presses):
+            batch.key(self.key)
+
+    def schedule(self, timeline, lane):
+        for _ in range(self.presses):
+            timeline.key(lane, self.key)
 
 
 class KeyDown(KeyboardInstruction):
@@ -25,6 +57,12 @@ class KeyDown(KeyboardInstruction):
     def execute(self):
         pyautogui.keyDown(self.key)
 
+    def enqueue(self, batch):
+        batch.key(self.key, native.NN_KEY_DOWN)
+
+    def schedule(self, timeline, lane):
+        timeline.key(lane, self.key, native.NN_KEY_DOWN)
+
 
 class KeyUp(KeyboardInstruction):
     def __init__(self, key: str):
@@ -33,15 +71,27 @@ class KeyUp(KeyboardInstruction):
     def execute(self):
         pyautogui.keyUp(self.key)
 
+    def enqueue(self, batch):
+        batch.key(self.key, native.NN_KEY_UP)
+
+    def schedule(self, timeline, lane):
+        timeline.key(lane, self.key, native.NN_KEY_UP)
+
 
 class TypeText(KeyboardInstruction):
-    def __init__(self, text: str, interval: float = 0.02):
+    def __init__(self, text: str, interval: float = 0.0):
         self.text = text
         self.interval = interval
 
     def execute(self):
         pyautogui.write(self.text, interval=self.interval)
 
+    def enqueue(self, batch):
+        batch.type(self.text, self.interval)
+
+    def schedule(self, timeline, lane):
+        timeline.type(lane, self.text, self.interval)
+
 
 class Shortcut(KeyboardInstruction):
     def __init__(self, *keys: str):
@@ -50,13 +100,43 @@ class Shortcut(KeyboardInstruction):
     def execute(self):
         pyautogui.hotkey(*self.keys)
 
+    def enqueue(self, batch):
+        batch.hotkey(*self.keys)
+
+    def schedule(self, timeline, lane):
+        timeline.hotkey(lane, *self.keys)
+
 
 class Wait(KeyboardInstruction):
     def __init__(self, duration: float):
         self.duration = duration
 
     def execute(self):
-        time.sleep(self.duration)
+        native.sleep(self.duration)
+
+    def enqueue(self, batch):
+        batch.wait(self.duration)
+
+    def schedule(self, timeline, lane):
+        timeline.wait(lane, self.duration)
+
+
+def from_record(actions: "native.ActionQueue", record: "native.Action") -> KeyboardInstruction:
+    """The instruction a native keyboard record stands for."""
+    code = record.code
+    if code == native.NN_OP_PRESS:
+        return KeyTap(actions.text(record), presses=record.arg)
+    if code == native.NN_OP_HOLD:
+        return KeyDown(actions.text(record))
+    if code == native.NN_OP_RELEASE:
+        return KeyUp(actions.text(record))
+    if code == native.NN_OP_TYPE:
+        return TypeText(actions.text(record), record.seconds)
+    if code == native.NN_OP_SHORTCUT:
+        return Shortcut(*actions.keys(record))
+    if code == native.NN_OP_WAIT:
+        return Wait(record.seconds)
+    raise ValueError(f"not a keyboard record: {code}")
 
 
 # -------------------------------------------------
@@ -68,21 +148,39 @@ class KeyboardController:
     High-level, AI-friendly keyboard abstraction.
     """
 
-    def __init__(self, monitor: DesktopMonitor):
+    def __init__(self, monitor: DesktopMonitor, timeline: Optional[InstructionTimeline] = None):
         self.queue: List[KeyboardInstruction] = []
         self.monitor = monitor
 
+        # Shared with the mouse controller by initialize_driver()
+        self.timeline = timeline or InstructionTimeline()
+        self.timeline.attach(native.NN_LANE_KEYBOARD, self.queue, from_record)
+        self._batch = None
+        self._batch_checked = False
+
+    @property
+    def actions(self) -> Optional["native.ActionQueue"]:
+        """The native record queue when there is one (see InstructionTimeline)."""
+        return self.timeline.actions
+
     # ------------------------
     # Intent-level API
     # ------------------------
 
-    def type(self, text: str, interval: float = 0.02):
+    def type(self, text: str, interval: float = 0.0):
+        """
+        Types `text`, any Unicode natively. interval paces it per character
+        (on the native scheduler's deadlines); 0 sends it in one go.
+        """
         self.monitor.record_action(
             source="keyboard",
             action_type="TYPE",
             data={"text": text}
         )
-        self.queue.append(TypeText(text, interval))
+        if self.actions is not None:
+            self.actions.type(native.NN_LANE_KEYBOARD, text, interval)
+        else:
+            self.queue.append(self.timeline.stamp(TypeText(text, interval)))
 
     def press(self, key: str):
         self.monitor.record_action(
@@ -90,7 +188,7 @@ class KeyboardController:
             action_type="PRESS",
             data={"key": key}
         )
-        self.queue.append(KeyTap(key))
+        self._tap(key)
 
     def shortcut(self, *keys: str):
         self.monitor.record_action(
@@ -98,7 +196,10 @@ class KeyboardController:
             action_type="SHORTCUT",
             data={"keys": keys}
         )
-        self.queue.append(Shortcut(*keys))
+        if self.actions is not None:
+            self.actions.shortcut(native.NN_LANE_KEYBOARD, *keys)
+        else:
+            self.queue.append(self.timeline.stamp(Shortcut(*keys)))
 
     def hold(self, key: str):
         self.monitor.record_action(
@@ -106,7 +207,10 @@ class KeyboardController:
             action_type="HOLD",
             data={"key": key}
         )
-        self.queue.append(KeyDown(key))
+        if self.actions is not None:
+            self.actions.key(native.NN_LANE_KEYBOARD, key, native.NN_KEY_DOWN)
+        else:
+            self.queue.append(self.timeline.stamp(KeyDown(key)))
 
     def release(self, key: str):
         self.monitor.record_action(
@@ -114,7 +218,10 @@ class KeyboardController:
             action_type="RELEASE",
             data={"key": key}
         )
-        self.queue.append(KeyUp(key))
+        if self.actions is not None:
+            self.actions.key(native.NN_LANE_KEYBOARD, key, native.NN_KEY_UP)
+        else:
+            self.queue.append(self.timeline.stamp(KeyUp(key)))
 
     def wait(self, seconds: float):
         self.monitor.record_action(
@@ -122,7 +229,17 @@ class KeyboardController:
             action_type="WAIT",
             data={"seconds": seconds}
         )
-        self.queue.append(Wait(seconds))
+        if self.actions is not None:
+            self.actions.wait(native.NN_LANE_KEYBOARD, seconds)
+        else:
+            self.queue.append(self.timeline.stamp(Wait(seconds)))
+
+    def _tap(self, key: str, presses: int = 1):
+        # One record however many presses.
+        if self.actions is not None:
+            self.actions.key(native.NN_LANE_KEYBOARD, key, native.NN_KEY_TAP, presses)
+        else:
+            self.queue.append(self.timeline.stamp(KeyTap(key, presses=presses)))
 
     # ------------------------
     # Macro helpers
@@ -142,28 +259,71 @@ class KeyboardController:
             action_type="BACKSPACE",
             data={"times": times}
         )
-        for _ in range(times):
-            self.press("backspace")
+        if times > 0:
+            self._tap("backspace", times)
 
     def delete_line(self):
         self.shortcut("ctrl", "a")
         self.press("backspace")
 
+    # ------------------------
+    # Text injection
+    # ------------------------
+
+    def set_text_mode(self, unicode: bool = False, paste_threshold: int = 0) -> bool:
+        """
+        Native text injection for every controller (see
+        native.set_text_options). False when only pyautogui is there.
+        """
+        return native.set_text_options(unicode, paste_threshold)
+
     # ------------------------
     # Execution
     # ------------------------
 
+    def _native_batch(self):
+        if not self._batch_checked:
+            self._batch_checked = True
+            self._batch = native.open_input_batch()
+        return self._batch
+
+    def instructions(self) -> List[KeyboardInstruction]:
+        """The keyboard queue as instruction objects (decoded when native)."""
+        if self.actions is None:
+            return list(self.queue)
+        return [instr for _, instr in self.timeline.decode(native.NN_LANE_KEYBOARD)]
+
     def execute(self, clear_queue: bool = True):
-        for instr in self.queue:
-            instr.execute()
+        """
+        Runs the keyboard queue on its own (see InstructionTimeline for
+        both devices merged). With the native engine everything between
+        two waits (or paced texts) is injected as one batch (one OS
+        call), straight from the native records; per-key delays only
+        apply on the pyautogui fallback.
+        """
+        batch = self._native_batch()
+        if batch is None:
+            for instr in self.instructions():
+                instr.execute()
+        elif self.actions is not None:
+            self.actions.execute(native.NN_LANE_KEYBOARD, batch)
+        else:
+            try:
+                for instr in self.queue:
+                    instr.enqueue(batch)
+                batch.send()
+            finally:
+                batch.clear()
         if clear_queue:
-            self.queue.clear()
+            self.clear()
 
     def clear(self):
         self.queue.clear()
+        if self.actions is not None:
+            self.actions.drop_lane(native.NN_LANE_KEYBOARD)
 
     def dump(self):
-        for i, instr in enumerate(self.queue):
+        for i, instr in enumerate(self.instructions()):
             print(f"{i:02d}: {instr.__class__.__name__}")
 
 # # Type a command safely
@@ -1,16 +1,41 @@
-import pyautogui
-import time
-from typing import List, Tuple, Union
+import math
+from typing import List, Optional, Tuple, Union
+from .. import native
+from ..lazy import lazy_import
 from ..desktop import DesktopMonitor
+from .timeline import InstructionTimeline
+
+pyautogui = lazy_import("pyautogui")  # fallback driver, imported on first use
 
 Point = Tuple[int, int]
 
+# Max pixels between generated stroke points (neuro_native's default).
+PATH_SPACING = 10.0
+
 
 class MouseInstruction:
     """Base class for mouse instructions."""
+    sequence = 0  # InstructionTimeline stamp
+
     def execute(self):
         raise NotImplementedError
 
+    def enqueue(self, batch: "native.InputBatch"):
+        """
+        Adds this instruction to a native injection batch. The default
+        sends what is pending and runs the pyautogui path.
+        """
+        batch.send()
+        self.execute()
+
+    def schedule(self, timeline: "native.Timeline", lane: int):
+        """
+        Places this instruction on a native timeline lane. The default
+        runs what is scheduled so far, then the pyautogui path.
+        """
+        timeline.run()
+        self.execute()
+
 
 class MoveInstruction(MouseInstruction):
     def __init__(self, x: int, y: int, duration: float = 0.1):
@@ -21,6 +46,12 @@ class MoveInstruction(MouseInstruction):
     def execute(self):
         pyautogui.moveTo(self.x, self.y, duration=self.duration)
 
+    def enqueue(self, batch):
+        batch.move(self.x, self.y, self.duration)
+
+    def schedule(self, timeline, lane):
+        timeline.move(lane, self.x, self.y, self.duration)
+
 
 class ClickInstruction(MouseInstruction):
     def __init__(self, x: int, y: int, button: str = "left"):
@@ -31,13 +62,25 @@ class ClickInstruction(MouseInstruction):
     def execute(self):
         pyautogui.click(self.x, self.y, button=self.button)
 
+    def enqueue(self, batch):
+        batch.click(self.x, self.y, self.button)
+
+    def schedule(self, timeline, lane):
+        timeline.click(lane, self.x, self.y, self.button)
+
 
 class WaitInstruction(MouseInstruction):
     def __init__(self, duration: float):
         self.duration = duration
 
     def execute(self):
-        time.sleep(self.duration)
+        native.sleep(self.duration)
+
+    def enqueue(self, batch):
+        batch.wait(self.duration)
+
+    def schedule(self, timeline, lane):
+        timeline.wait(lane, self.duration)
 
 
 class PathInstruction(MouseInstruction):
@@ -52,6 +95,26 @@ class PathInstruction(MouseInstruction):
         for x, y in self.points:
             pyautogui.moveTo(x, y, duration=self.step_duration)
 
+    def enqueue(self, batch):
+        batch.path(self.points, self.step_duration)
+
+    def schedule(self, timeline, lane):
+        timeline.path(lane, self.points, self.step_duration)
+
+
+def from_record(actions: "native.ActionQueue", record: "native.Action") -> MouseInstruction:
+    """The instruction a native mouse record stands for."""
+    code = record.code
+    if code == native.NN_OP_MOVE:
+        return MoveInstruction(record.x, record.y, record.seconds)
+    if code == native.NN_OP_CLICK:
+        return ClickInstruction(record.x, record.y, native.button_name(record.arg))
+    if code == native.NN_OP_PATH:
+        return PathInstruction(actions.points(record), record.seconds)
+    if code == native.NN_OP_WAIT:
+        return WaitInstruction(record.seconds)
+    raise ValueError(f"not a mouse record: {code}")
+
 
 # -------------------------------------------------
 # High-level Mouse Controller
@@ -62,27 +125,83 @@ class MouseController:
     High-level, AI-friendly mouse control abstraction.
     """
 
-    def __init__(self, monitor: DesktopMonitor):
-        self.screen_width, self.screen_height = pyautogui.size()
+    def __init__(self, monitor: DesktopMonitor, timeline: Optional[InstructionTimeline] = None):
+        self.screen_width, self.screen_height = monitor.get_screen_size()
         self.instruction_queue: List[MouseInstruction] = []
         self.monitor = monitor
 
+        # (x, y, width, height) per monitor, primary first, virtual-desktop
+        # pixels; see refresh_layout()
+        self.monitors: List[Tuple[int, int, int, int]] = []
+        self._load_layout()
+
+        # Shared with the keyboard controller by initialize_driver()
+        self.timeline = timeline or InstructionTimeline()
+        self.timeline.attach(native.NN_LANE_MOUSE, self.instruction_queue, from_record)
+        self._batch = None
+        self._batch_checked = False
+
+    @property
+    def actions(self) -> Optional["native.ActionQueue"]:
+        """The native record queue when there is one (see InstructionTimeline)."""
+        return self.timeline.actions
+
     # ------------------------
     # Coordinate mapping
     # ------------------------
 
-    def map_normalized(self, nx: float, ny: float) -> Point:
+    def _load_layout(self):
+        try:
+            self.monitors = [
+                (m["x"], m["y"], m["width"], m["height"]) for m in self.monitor.get_monitors()
+            ]
+        except Exception:
+            self.monitors = []
+        if not self.monitors:
+            self.monitors = [(0, 0, self.screen_width, self.screen_height)]
+
+    def refresh_layout(self):
         """
-        Maps normalized coordinates (0.0–1.0) to screen pixels.
+        Re-reads the monitor layout, e.g. after a display was plugged in.
+        """
+        native.refresh_monitors()
+        self.screen_width, self.screen_height = self.monitor.get_screen_size()
+        self._load_layout()
+
+    def map_normalized(self, nx: float, ny: float, monitor: int = 0) -> Point:
         """
-        x = int(nx * self.screen_width)
-        y = int(ny * self.screen_height)
+        Maps normalized coordinates (0.0–1.0) on a monitor (0 = primary) to
+        screen pixels. 1.0 is the monitor's last pixel, not the next one's
+        first.
+        """
+        if not 0 <= monitor < len(self.monitors):
+            raise ValueError(f"no monitor {monitor}")
+        left, top, width, height = self.monitors[monitor]
+        x = left + max(0, min(width - 1, int(nx * width)))
+        y = top + max(0, min(height - 1, int(ny * height)))
         return x, y
 
     def clamp_point(self, x: int, y: int) -> Point:
-        x = max(0, min(self.screen_width - 1, x))
-        y = max(0, min(self.screen_height - 1, y))
-        return x, y
+        """
+        Moves a point onto the nearest monitor; points on any monitor,
+        primary or not, are left alone.
+        """
+        best = None
+        for left, top, width, height in self.monitors:
+            cx = max(left, min(left + width - 1, x))
+            cy = max(top, min(top + height - 1, y))
+            if cx == x and cy == y:
+                return x, y
+            gap = (cx - x) ** 2 + (cy - y) ** 2
+            if best is None or gap < best[0]:
+                best = (gap, cx, cy)
+        return best[1], best[2]
+
+    def _clamp_path(self, path: "native.PointPath"):
+        # Natively onto the nearest monitor; without a native monitor
+        # layout only the primary is known to the path engine.
+        if not path.clamp_desktop():
+            path.clamp(self.screen_width, self.screen_height)
 
     # ------------------------
     # Instruction builders
@@ -95,7 +214,10 @@ class MouseController:
             data={"x": x, "y": y, "duration": duration}
         )
         x, y = self.clamp_point(x, y)
-        self.instruction_queue.append(MoveInstruction(x, y, duration))
+        if self.actions is not None:
+            self.actions.move(native.NN_LANE_MOUSE, x, y, duration)
+        else:
+            self.instruction_queue.append(self.timeline.stamp(MoveInstruction(x, y, duration)))
 
     def queue_click(self, x: int, y: int, button: str = "left"):
         self.monitor.record_action(
@@ -104,7 +226,10 @@ class MouseController:
             data={"x": x, "y": y, "button": button}
         )
         x, y = self.clamp_point(x, y)
-        self.instruction_queue.append(ClickInstruction(x, y, button))
+        if self.actions is not None:
+            self.actions.click(native.NN_LANE_MOUSE, x, y, button)
+        else:
+            self.instruction_queue.append(self.timeline.stamp(ClickInstruction(x, y, button)))
 
     def queue_wait(self, duration: float):
         self.monitor.record_action(
@@ -112,7 +237,10 @@ class MouseController:
             action_type="WAIT",
             data={"duration": duration}
         )
-        self.instruction_queue.append(WaitInstruction(duration))
+        if self.actions is not None:
+            self.actions.wait(native.NN_LANE_MOUSE, duration)
+        else:
+            self.instruction_queue.append(self.timeline.stamp(WaitInstruction(duration)))
 
     def queue_path(self, points: List[Point], step_duration: float = 0.02):
         self.monitor.record_action(
@@ -120,8 +248,15 @@ class MouseController:
             action_type="PATH",
             data={"points": points, "step_duration": step_duration}
         )
-        clamped = [self.clamp_point(x, y) for x, y in points]
-        self.instruction_queue.append(PathInstruction(clamped, step_duration))
+        if isinstance(points, native.PointPath):
+            self._clamp_path(points)
+            clamped = points
+        else:
+            clamped = [self.clamp_point(x, y) for x, y in points]
+        if self.actions is not None:
+            self.actions.path(native.NN_LANE_MOUSE, clamped, step_duration)  # copied into the arena
+        else:
+            self.instruction_queue.append(self.timeline.stamp(PathInstruction(clamped, step_duration)))
 
     # ------------------------
     # Drawing helpers (AI-friendly)
@@ -131,6 +266,13 @@ class MouseController:
         """
         Generates a straight-line path between two points.
         """
+        if steps > 0:
+            path = native.open_path()
+            if path is not None:
+                path.line_steps(start, end, steps)
+                self._clamp_path(path)
+                return path
+
         x1, y1 = start
         x2, y2 = end
 
@@ -142,39 +284,171 @@ class MouseController:
             points.append(self.clamp_point(x, y))
         return points
 
-    def draw_polyline(self, points: List[Point], steps_per_segment: int = 30) -> List[Point]:
+    @staticmethod
+    def _spacing(spacing: float, velocity: float, step_duration: float) -> float:
+        if velocity > 0 and step_duration > 0:
+            return velocity * step_duration
+        return spacing if spacing > 0 else PATH_SPACING
+
+    def draw_polyline(
+        self,
+        points: List[Point],
+        spacing: float = PATH_SPACING,
+        velocity: float = 0.0,
+        step_duration: float = 0.02,
+    ) -> List[Point]:
+        """
+        Draws connected line segments through multiple points, no more
+        than `spacing` px between steps (or velocity px/s when paced at
+        step_duration). Long segments get more points, short ones fewer.
+        """
+        path = native.open_path(spacing, velocity, step_duration)
+        if path is not None:
+            path.polyline(points)
+            self._clamp_path(path)
+            return path
+
+        # The native engine's DDA stepping, point for point.
+        step = self._spacing(spacing, velocity, step_duration)
+        out: List[Point] = []
+        for (x1, y1), (x2, y2) in zip(points, points[1:]):
+            dx, dy = x2 - x1, y2 - y1
+            length = math.sqrt(dx * dx + dy * dy)
+            steps = max(1, math.ceil(length / step)) if step > 1 else max(abs(dx), abs(dy), 1)
+            for i in range(steps + 1):
+                t = i / steps
+                point = (int(x1 + dx * t), int(y1 + dy * t))
+                if not out or out[-1] != point:
+                    out.append(point)
+        return [self.clamp_point(x, y) for x, y in out]
+
+    def draw_curve(
+        self,
+        points: List[Point],
+        spacing: float = PATH_SPACING,
+        velocity: float = 0.0,
+        step_duration: float = 0.02,
+    ) -> List[Point]:
+        """
+        Smooth stroke through every point (Catmull-Rom spline).
+        """
+        path = native.open_path(spacing, velocity, step_duration)
+        if path is not None:
+            path.catmull_rom(points)
+            self._clamp_path(path)
+            return path
+
+        out: List[Point] = []
+        n = len(points)
+        for i in range(n - 1):
+            p0, p1, p2, p3 = points[max(i - 1, 0)], points[i], points[i + 1], points[min(i + 2, n - 1)]
+            control = [
+                p1,
+                (p1[0] + (p2[0] - p0[0]) / 6, p1[1] + (p2[1] - p0[1]) / 6),
+                (p2[0] - (p3[0] - p1[0]) / 6, p2[1] - (p3[1] - p1[1]) / 6),
+                p2,
+            ]
+            self._sample_cubic(control, self._spacing(spacing, velocity, step_duration), out)
+        return [self.clamp_point(x, y) for x, y in out]
+
+    def draw_bezier(
+        self,
+        control: List[Point],
+        spacing: float = PATH_SPACING,
+        velocity: float = 0.0,
+        step_duration: float = 0.02,
+    ) -> List[Point]:
         """
-        Draws connected line segments through multiple points.
+        Bezier stroke: 3 control points for a quadratic, 4 for a cubic.
         """
-        path = []
-        for i in range(len(points) - 1):
-            segment = self.draw_line(points[i], points[i + 1], steps_per_segment)
-            path.extend(segment)
-        return path
+        if len(control) not in (3, 4):
+            raise ValueError("bezier needs 3 or 4 control points")
+
+        path = native.open_path(spacing, velocity, step_duration)
+        if path is not None:
+            path.bezier(control)
+            self._clamp_path(path)
+            return path
+
+        if len(control) == 3:
+            (x0, y0), (cx, cy), (x2, y2) = control
+            control = [
+                (x0, y0),
+                (x0 + (cx - x0) * 2 / 3, y0 + (cy - y0) * 2 / 3),
+                (x2 + (cx - x2) * 2 / 3, y2 + (cy - y2) * 2 / 3),
+                (x2, y2),
+            ]
+        out: List[Point] = []
+        self._sample_cubic(control, self._spacing(spacing, velocity, step_duration), out)
+        return [self.clamp_point(x, y) for x, y in out]
+
+    @staticmethod
+    def _sample_cubic(control, spacing: float, out: List[Point]):
+        # Fallback only: even parameter steps sized by the control polygon.
+        (x0, y0), (x1, y1), (x2, y2), (x3, y3) = control
+        length = math.dist((x0, y0), (x1, y1)) + math.dist((x1, y1), (x2, y2)) + math.dist((x2, y2), (x3, y3))
+        steps = max(1, math.ceil(length / max(1.0, spacing)))
+        for i in range(steps + 1):
+            t = i / steps
+            u = 1 - t
+            x = u * u * u * x0 + 3 * u * u * t * x1 + 3 * u * t * t * x2 + t * t * t * x3
+            y = u * u * u * y0 + 3 * u * u * t * y1 + 3 * u * t * t * y2 + t * t * t * y3
+            point = (round(x), round(y))
+            if not out or out[-1] != point:
+                out.append(point)
 
     # ------------------------
     # Execution
     # ------------------------
 
+    def _native_batch(self):
+        if not self._batch_checked:
+            self._batch_checked = True
+            self._batch = native.open_input_batch()
+        return self._batch
+
+    def instructions(self) -> List[MouseInstruction]:
+        """The mouse queue as instruction objects (decoded when native)."""
+        if self.actions is None:
+            return list(self.instruction_queue)
+        return [instr for _, instr in self.timeline.decode(native.NN_LANE_MOUSE)]
+
     def execute(self, clear_queue: bool = True):
         """
-        Executes all queued instructions sequentially.
+        Executes the mouse queue on its own, sequentially (see
+        InstructionTimeline for both devices merged). With the native
+        engine the instructions between two waits (or tweened moves and
+        paced paths) are injected as one batch, straight from the
+        native records.
         """
-        for instr in self.instruction_queue:
-            instr.execute()
+        batch = self._native_batch()
+        if batch is None:
+            for instr in self.instructions():
+                instr.execute()
+        elif self.actions is not None:
+            self.actions.execute(native.NN_LANE_MOUSE, batch)
+        else:
+            try:
+                for instr in self.instruction_queue:
+                    instr.enqueue(batch)
+                batch.send()
+            finally:
+                batch.clear()
 
         if clear_queue:
-            self.instruction_queue.clear()
+            self.clear()
 
     def clear(self):
         self.instruction_queue.clear()
+        if self.actions is not None:
+            self.actions.drop_lane(native.NN_LANE_MOUSE)
 
     # ------------------------
     # Debug / inspection
     # ------------------------
 
     def dump_queue(self):
-        for i, instr in enumerate(self.instruction_queue):
+        for i, instr in enumerate(self.instructions()):
             print(f"{i:02d}: {instr.__class__.__name__}")
 
 # # Draw a line across the screen example.
@@ -0,0 +1,146 @@
+import itertools
+from typing import Callable, Dict, List, Optional, Tuple
+
+from .. import native
+
+
+class Barrier:
+    """
+    Sync point between the device queues (a script WAIT): both streams
+    catch up with each other, then the delay is paid once.
+    """
+    sequence = 0
+
+    def __init__(self, duration: float = 0.0):
+        self.duration = duration
+
+    def execute(self):
+        native.sleep(self.duration)
+
+    def schedule(self, timeline: "native.Timeline", lane: Optional[int]):
+        timeline.sync(self.duration)
+
+
+class InstructionTimeline:
+    """
+    One script-ordered sequence shared by the keyboard and mouse queues.
+
+    The controllers stamp everything they queue with a sequence number
+    from here, and execute() merges both queues (plus barriers) by it
+    and runs them on a single executor. With the native engine that is
+    a native Timeline, one lane per device: a device's own waits only
+    delay its own stream, so the two overlap until the next barrier.
+    Without it, instructions run through pyautogui in sequence order.
+
+    With the native library the controllers queue into `actions`
+    instead (one POD record per instruction in a native arena, already
+    in script order, nothing to stamp); instruction objects are only
+    decoded from it for the pyautogui fallback and dump().
+    """
+
+    def __init__(self):
+        self._sequence = itertools.count(1)
+        self._last = 0
+        self._queues: Dict[int, list] = {}
+        self._decoders: Dict[int, Callable] = {}
+        self.barriers: List[Barrier] = []
+
+        self.actions: Optional["native.ActionQueue"] = native.open_action_queue()
+
+        self._native = None
+        self._native_checked = False
+
+    # ------------------------
+    # Building
+    # ------------------------
+
+    def attach(self, lane: int, queue: list, decode: Callable):
+        """
+        Registers a controller's queue as the stream for `lane`, and how
+        to turn its native records back into instructions.
+        """
+        self._queues[lane] = queue
+        self._decoders[lane] = decode
+
+    def stamp(self, instruction):
+        instruction.sequence = self._last = next(self._sequence)
+        return instruction
+
+    def sync(self, duration: float = 0.0):
+        if self.actions is not None:
+            self.actions.sync(duration)
+            return
+        # Back-to-back barriers fold into one.
+        last = self.barriers[-1] if self.barriers else None
+        if last is not None and last.sequence == self._last:
+            last.duration += max(0.0, duration)
+            return
+        self.barriers.append(self.stamp(Barrier(duration)))
+
+    def decode(self, lane: Optional[int] = None) -> List[Tuple[Optional[int], object]]:
+        """
+        (lane, instruction) pairs built from the native records, of one
+        lane or of all of them (barriers included) in script order.
+        """
+        entries = []
+        for record in self.actions.records():
+            if record.code == native.NN_OP_SYNC:
+                if lane is None:
+                    entries.append((None, Barrier(record.seconds)))
+            elif lane is None or record.lane == lane:
+                entries.append((record.lane, self._decoders[record.lane](self.actions, record)))
+        return entries
+
+    def entries(self) -> List[Tuple[Optional[int], object]]:
+        """(lane, instruction) pairs in script order; lane None = barrier."""
+        if self.actions is not None:
+            return self.decode()
+        merged = [
+            (instr.sequence, lane, instr)
+            for lane, queue in self._queues.items()
+            for instr in queue
+        ]
+        merged += [(barrier.sequence, None, barrier) for barrier in self.barriers]
+        merged.sort(key=lambda entry: entry[0])
+        return [(lane, instr) for _, lane, instr in merged]
+
+    # ------------------------
+    # Execution
+    # ------------------------
+
+    def _native_timeline(self) -> Optional["native.Timeline"]:
+        if not self._native_checked:
+            self._native_checked = True
+            self._native = native.open_timeline()
+        return self._native
+
+    def execute(self, clear_queue: bool = True):
+        timeline = self._native_timeline()
+        try:
+            if timeline is None:
+                for _, instr in self.entries():
+                    instr.execute()
+            elif self.actions is not None:
+                self.actions.schedule(timeline)
+                timeline.run()
+            else:
+                for lane, instr in self.entries():
+                    instr.schedule(timeline, lane)
+                timeline.run()
+        finally:
+            if timeline is not None:
+                timeline.clear()
+            if clear_queue:
+                self.clear()
+
+    def clear(self):
+        for queue in self._queues.values():
+            queue.clear()
+        self.barriers.clear()
+        if self.actions is not None:
+            self.actions.clear()  # resets the arena, keeps its memory
+
+    def dump(self):
+        for i, (lane, instr) in enumerate(self.entries()):
+            device = {native.NN_LANE_KEYBOARD: "kbd", native.NN_LANE_MOUSE: "mouse"}.get(lane, "sync")
+            print(f"{i:02d}: {device:5s} {instr.__class__.__name__}")
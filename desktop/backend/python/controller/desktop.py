@@ -1,13 +1,43 @@
+from __future__ import annotations  # Image.Image hints without importing PIL
+
 import time
 import threading
-from typing import List, Tuple, Optional, Dict, Any
+from collections import deque
+from typing import Deque, List, Tuple, Optional, Dict, Any
+
+from . import native
+from .lazy import lazy_import
+
+# Imported on first use: the native engine covers most of what they do.
+pyautogui = lazy_import("pyautogui")
+psutil = lazy_import("psutil")
+gw = lazy_import("pygetwindow")
+mouse = lazy_import("pynput.mouse")
+mss = lazy_import("mss")
+Image = lazy_import("PIL.Image")
+
+
+class IncrementalFrame:
+    """
+    Result of DesktopMonitor.capture_incremental(): only the regions that
+    changed since the previous capture, as tightly packed BGRA tiles.
+    """
+
+    def __init__(
+        self,
+        sequence: int,
+        size: Tuple[int, int],
+        tiles: List[Tuple[Tuple[int, int, int, int], bytes]],
+        full: bool,
+    ):
+        self.sequence = sequence
+        self.size = size
+        self.tiles = tiles    # [((x, y, w, h), bgra_bytes), ...]
+        self.full = full      # True when tiles cover the whole screen
 
-import pyautogui
-import psutil
-import pygetwindow as gw
-from pynput import mouse
-import mss
-from PIL import Image
+    @property
+    def unchanged(self) -> bool:
+        return not self.tiles
 
 
 class DesktopMonitor:
@@ -20,16 +50,43 @@ class DesktopMonitor:
         track_mouse: bool = True,
         max_mouse_history: int = 500,
         max_action_history: int = 1000,
+        mouse_sample_hz: int = 0,
+        history_path: Optional[str] = None,
+        history_segments: int = 4,
     ):
         self.track_mouse = track_mouse
+        self.mouse_sample_hz = mouse_sample_hz
         self.max_mouse_history = max_mouse_history
         self.max_action_history = max_action_history
 
+        # Native telemetry rings (None when neuro_native is not available;
+        # the deques below are the fallback storage). Both are the shared
+        # channels the native hook and native script execution write to.
+        self._mouse_ring = native.open_telemetry(max_mouse_history, native.NN_CHANNEL_MOUSE)
+        self._action_ring = native.open_telemetry(max_action_history, native.NN_CHANNEL_ACTIONS)
+
+        # Persistent history: both channels also go to the memory-mapped
+        # log at history_path (history_path.1, .2, ... once rotated; the
+        # previous run's log is rotated to .1 on start).
+        self._history_path: Optional[str] = None
+        self._history_segments = history_segments
+        if history_path and native.start_history(history_path, keep_segments=history_segments):
+            self._history_path = history_path
+
+        # monotonic record timestamps -> time.time()
+        self._wall_offset = time.time() - native.clock_ns() / 1e9 if native.load() else 0.0
+
+        if self._action_ring is not None:
+            # Dict payloads stay in Python, indexed by record sequence
+            self._action_data: List[Optional[Tuple[int, Dict[str, Any]]]] = (
+                [None] * self._action_ring.capacity
+            )
+
         # ------------------------
         # Mouse telemetry
         # ------------------------
 
-        self.mouse_history: List[Tuple[float, int, int]] = []
+        self.mouse_history: Deque[Tuple[float, int, int]] = deque(maxlen=max_mouse_history)
         self.last_mouse_position: Optional[Tuple[int, int]] = None
         self.last_mouse_move_time: Optional[float] = None
 
@@ -37,14 +94,47 @@ class DesktopMonitor:
         # Action telemetry
         # ------------------------
 
-        self.action_history: List[Dict[str, Any]] = []
+        self.action_history: Deque[Dict[str, Any]] = deque(maxlen=max_action_history)
 
         # ------------------------
         # Internals
         # ------------------------
 
         self._mouse_listener = None
+        self._mouse_hooked = False
         self._lock = threading.Lock()
+        self._closed = False
+
+        # Native capture session (opened on first capture, None = use mss)
+        # and the perceptual-hash cache of the frames it has handed out
+        self._capture = None
+        self._screen_cache = None
+        self._capture_checked = False
+        self._capture_lock = threading.Lock()
+        self._fallback_sequence = 0
+
+        # Sessions on the other monitors (capture_screen(monitor=n), opened
+        # on first use) and the all-monitors capture with a grab thread per
+        # output (capture_all_screens)
+        self._output_captures: Dict[int, Optional["native.CaptureSession"]] = {}
+        self._multi_capture: Optional["native.MultiCapture"] = None
+        self._multi_checked = False
+
+        # Native window cache (started on first query); _window_state is
+        # only rebuilt when the cache's version moves.
+        self._window_cache: Optional[bool] = None
+        self._window_state: Optional["native.WindowState"] = None
+
+        # Process table: native tracker when available (opened on first
+        # query, None = diff psutil listings), mirrored as pid -> name and
+        # kept current from the deltas. Changes accumulate until
+        # get_process_changes() collects them.
+        self._process_tracker: Optional["native.ProcessTracker"] = None
+        self._process_checked = False
+        self._process_lock = threading.Lock()
+        self._processes: Dict[int, str] = {}
+        self._process_added: Dict[int, str] = {}
+        self._process_removed: Dict[int, str] = {}
 
         if self.track_mouse:
             self._start_mouse_listener()
@@ -62,6 +152,12 @@ class DesktopMonitor:
         """
         Record a structured action event.
         """
+        ring = self._action_ring
+        if ring is not None:
+            sequence = ring.push(native.intern(source), native.intern(action_type))
+            self._action_data[sequence % ring.capacity] = (sequence, data or {})
+            return
+
         event = {
             "time": time.time(),
             "source": source,
@@ -71,54 +167,215 @@ class DesktopMonitor:
 
         with self._lock:
             self.action_history.append(event)
-            if len(self.action_history) > self.max_action_history:
-                self.action_history.pop(0)
+
+    def get_action_records(self):
+        """
+        Raw fixed-layout records (native.Record array), oldest first.
+        A single bulk copy; None without the native engine.
+        """
+        if self._action_ring is None:
+            return None
+        return self._action_ring.snapshot(limit=self.max_action_history)
 
     def get_action_history(self) -> List[Dict[str, Any]]:
-        with self._lock:
-            return list(self.action_history)
+        records = self.get_action_records()
+        if records is None:
+            with self._lock:
+                return list(self.action_history)
+
+        data = self._action_data
+        history = []
+        for record in records:
+            if record.source == native.NN_SOURCE_NATIVE:
+                # Executed natively: the payload lives in the record
+                payload = {"x": record.x, "y": record.y, "arg": record.arg, "value": record.value}
+            else:
+                # The payload may lag the record by a moment (or be
+                # overwritten once the ring wraps).
+                slot = data[record.sequence % len(data)]
+                payload = slot[1] if slot and slot[0] == record.sequence else {}
+
+            history.append({
+                "time": self._wall_time(record.timestamp_ns),
+                "source": native.name_of(record.source),
+                "type": native.name_of(record.type),
+                "data": payload,
+            })
+        return history
+
+    def get_logged_actions(
+        self,
+        start: Optional[float] = None,
+        end: Optional[float] = None,
+    ) -> List[Dict[str, Any]]:
+        """
+        Actions from the history log with start <= time < end (time.time()
+        seconds), oldest first, across the rotated segments too, so
+        earlier runs are included. Only the records in the range are
+        decoded; payloads recorded from Python appear while they are still
+        in the ring. Empty without a history_path.
+        """
+        if self._history_path is None:
+            return []
+
+        start = 0.0 if start is None else start
+        end = time.time() + 1.0 if end is None else end
+        paths = [f"{self._history_path}.{n}" for n in range(self._history_segments, 0, -1)]
+        paths.append(self._history_path)
+
+        data = self._action_data if self._action_ring is not None else None
+        actions = []
+        for path in paths:
+            try:
+                log = native.open_history(path)
+            except native.NativeError:
+                continue  # not rotated that far yet
+            if log is None:
+                return []
+
+            for record in log.range(start, end):
+                if record.reserved != native.NN_CHANNEL_ACTIONS:
+                    continue
+                if record.source == native.NN_SOURCE_NATIVE:
+                    payload = {"x": record.x, "y": record.y, "arg": record.arg, "value": record.value}
+                elif path == self._history_path and data is not None:
+                    slot = data[record.sequence % len(data)]
+                    payload = slot[1] if slot and slot[0] == record.sequence else {}
+                else:
+                    payload = {}
+
+                actions.append({
+                    "time": record.timestamp_ns / 1e9,
+                    "source": log.name_of(record.source),
+                    "type": log.name_of(record.type),
+                    "data": payload,
+                })
+        return actions
+
+    def get_metrics(self) -> Dict[str, Dict[str, int]]:
+        """
+        Native hot-path histograms (injection, executor queue depth and
+        script time, capture frame time, the app's GIL and websocket
+        timings), by name; empty without neuro_native. See
+        native.metrics().
+        """
+        return native.metrics() or {}
 
     def clear_action_history(self):
+        if self._action_ring is not None:
+            self._action_ring.clear()
+            return
+
         with self._lock:
             self.action_history.clear()
 
+    def _wall_time(self, timestamp_ns: int) -> float:
+        return self._wall_offset + timestamp_ns / 1e9
+
     # =================================================
     # Mouse tracking
     # =================================================
 
     def _start_mouse_listener(self):
+        ring = self._mouse_ring
+
+        # Native hook: events go straight into the ring from its own
+        # thread, timestamped at the OS callback, without touching Python.
+        if ring is not None:
+            interval_us = 1_000_000 // self.mouse_sample_hz if self.mouse_sample_hz else 0
+            self._mouse_hooked = native.start_mouse_hook(ring, interval_us)
+            if self._mouse_hooked:
+                return
+
+        move = native.NN_EVENT_MOUSE_MOVE
+
         def on_move(x, y):
-            with self._lock:
-                now = time.time()
-                self.last_mouse_position = (x, y)
-                self.last_mouse_move_time = now
+            now = time.time()
+            self.last_mouse_position = (x, y)
+            self.last_mouse_move_time = now
+
+            if ring is not None:
+                ring.push(native.NN_SOURCE_MOUSE, move, x, y)
+                return
 
+            with self._lock:
                 self.mouse_history.append((now, x, y))
-                if len(self.mouse_history) > self.max_mouse_history:
-                    self.mouse_history.pop(0)
 
-        self._mouse_listener = mouse.Listener(on_move=on_move)
-        self._mouse_listener.daemon = True
-        self._mouse_listener.start()
+        # pynput fallback: imported and started off the constructor's
+        # thread, it takes a while in the bundled interpreter.
+        def start_listener():
+            listener = mouse.Listener(on_move=on_move)
+            listener.daemon = True
+            with self._lock:
+                if self._closed:
+                    return
+                self._mouse_listener = listener
+            listener.start()
+
+        threading.Thread(target=start_listener, name="mouse-listener-start", daemon=True).start()
 
     def get_current_mouse_position(self) -> Tuple[int, int]:
         return pyautogui.position()
 
     def get_last_mouse_position(self) -> Optional[Tuple[int, int]]:
+        if self._mouse_hooked:
+            latest = native.mouse_hook_position()
+            return latest[:2] if latest else None
         return self.last_mouse_position
 
     def get_last_mouse_move_time(self) -> Optional[float]:
+        if self._mouse_hooked:
+            latest = native.mouse_hook_position()
+            return self._wall_time(latest[2]) if latest else None
         return self.last_mouse_move_time
 
+    def get_mouse_records(self):
+        """
+        Raw mouse records (native.Record array, x/y in the payload; the
+        hook also records NN_EVENT_MOUSE_BUTTON / _WHEEL events).
+        """
+        if self._mouse_ring is None:
+            return None
+        return self._mouse_ring.snapshot(limit=self.max_mouse_history)
+
     def get_mouse_history(self) -> List[Tuple[float, int, int]]:
-        with self._lock:
-            return list(self.mouse_history)
+        records = self.get_mouse_records()
+        if records is None:
+            with self._lock:
+                return list(self.mouse_history)
+
+        offset = self._wall_offset
+        move = native.NN_EVENT_MOUSE_MOVE
+        return [(offset + r.timestamp_ns / 1e9, r.x, r.y) for r in records if r.type == move]
 
     # =================================================
     # Window information
     # =================================================
 
+    def _windows(self) -> Optional["native.WindowState"]:
+        if self._window_cache is None:
+            self._window_cache = native.start_window_cache()
+        if not self._window_cache:
+            return None
+
+        state = self._window_state
+        if state is None or state.version != native.window_cache_version():
+            state = self._window_state = native.window_state()
+        return state
+
+    def get_window_version(self) -> Optional[int]:
+        """
+        Changes whenever the window list, a title or the active window
+        does, so pollers can skip unchanged state. None without the
+        native window cache.
+        """
+        return native.window_cache_version() if self._windows() is not None else None
+
     def get_open_windows(self) -> List[str]:
+        state = self._windows()
+        if state is not None:
+            return [title for title in state.titles if title]
+
         try:
             windows = gw.getAllWindows()
             return [w.title for w in windows if w.title]
@@ -126,6 +383,10 @@ class DesktopMonitor:
             return []
 
     def get_active_window(self) -> Optional[str]:
+        state = self._windows()
+        if state is not None:
+            return state.active_title
+
         try:
             win = gw.getActiveWindow()
             return win.title if win else None
@@ -137,24 +398,277 @@ class DesktopMonitor:
     # =================================================
 
     def get_screen_size(self) -> Tuple[int, int]:
+        layout = native.monitors()
+        if layout:
+            primary = layout[0].bounds
+            return primary.width, primary.height
         return pyautogui.size()
 
-    def capture_screen(self) -> Image.Image:
+    @staticmethod
+    def _mss_outputs(sct) -> List[Dict[str, int]]:
+        # Physical monitors, primary (the one at the desktop origin) first
+        # like the native layout, so indices mean the same either way.
+        return sorted(sct.monitors[1:], key=lambda m: (m["left"], m["top"]) != (0, 0))
+
+    def get_monitors(self) -> List[Dict[str, Any]]:
+        """
+        Every monitor, primary first. Bounds are virtual-desktop pixels (the
+        mouse's coordinate space, which may start below zero); `index` is
+        what capture_screen(monitor=...) and MouseController take.
+        """
+        layout = native.monitors()
+        if layout:
+            return [
+                {
+                    "index": m.index,
+                    "x": m.bounds.x,
+                    "y": m.bounds.y,
+                    "width": m.bounds.width,
+                    "height": m.bounds.height,
+                    "primary": bool(m.primary),
+                    "name": m.name.decode("utf-8", "replace"),
+                }
+                for m in layout
+            ]
+
+        with mss.mss() as sct:
+            return [
+                {
+                    "index": i,
+                    "x": m["left"],
+                    "y": m["top"],
+                    "width": m["width"],
+                    "height": m["height"],
+                    "primary": i == 0,
+                    "name": f"monitor{i}",
+                }
+                for i, m in enumerate(self._mss_outputs(sct))
+            ]
+
+    def _capture_session(self, monitor: int = 0) -> Optional["native.CaptureSession"]:
+        with self._capture_lock:
+            if monitor != 0:
+                if monitor not in self._output_captures:
+                    self._output_captures[monitor] = native.open_capture(monitor)
+                return self._output_captures[monitor]
+
+            if not self._capture_checked:
+                self._capture_checked = True
+                self._capture = native.open_capture()
+                if self._capture is not None:
+                    self._screen_cache = native.open_screen_cache()
+            return self._capture
+
+    def capture_frame(self, timeout_ms: int = 100, monitor: int = 0) -> Optional["native.FrameView"]:
+        """
+        Grabs a monitor (0 = primary) into the native capture ring and
+        returns a zero-copy BGRA view of it. Release the view (or use it as
+        a context manager) once done. Returns None when native capture is
+        unavailable.
+        """
+        session = self._capture_session(monitor)
+        if session is None:
+            return None
+        return session.grab(timeout_ms)
+
+    @staticmethod
+    def _frame_image(frame, size: Optional[Tuple[int, int]]) -> Image.Image:
+        if size is not None and tuple(size) != frame.size:
+            rgb = native.downscale_rgb(frame, *size)
+            image = Image.frombuffer("RGB", tuple(size), rgb, "raw", "RGB", 0, 1)
+        else:
+            rgb = native.convert_rgb(frame)
+            image = Image.frombuffer("RGB", frame.size, rgb, "raw", "RGB", 0, 1)
+        image.info["sequence"] = frame.sequence
+        return image
+
+    def _mss_image(self, sct, output: Dict[str, int], size: Optional[Tuple[int, int]]) -> Image.Image:
+        screenshot = sct.grab(output)
+        image = Image.frombytes("RGB", screenshot.size, screenshot.rgb)
+        image = image.resize(size, Image.BILINEAR) if size else image
+        self._fallback_sequence += 1
+        image.info["sequence"] = self._fallback_sequence
+        return image
+
+    def capture_screen(self, size: Optional[Tuple[int, int]] = None, monitor: int = 0) -> Image.Image:
+        """
+        Captures a monitor (0 = primary, see get_monitors) as an RGB image,
+        optionally resized to `size`. With the native engine the resize and
+        BGRA->RGB conversion run as SIMD kernels on the capture buffer
+        itself.
+
+        The frame's sequence number is stored in image.info["sequence"];
+        for the primary monitor, pass it to screen_changed_since() later to
+        find out whether the image is still current before redoing any
+        work on it.
+        """
+        session = self._capture_session(monitor)
+        if session is not None:
+            with session.grab() as frame:
+                if monitor == 0:
+                    self._observe(frame)
+                return self._frame_image(frame, size)
+
         with mss.mss() as sct:
-            monitor = sct.monitors[1]
-            screenshot = sct.grab(monitor)
-            return Image.frombytes("RGB", screenshot.size, screenshot.rgb)
+            return self._mss_image(sct, self._mss_outputs(sct)[monitor], size)
+
+    def capture_all_screens(self, size: Optional[Tuple[int, int]] = None) -> List[Image.Image]:
+        """
+        Every monitor at once, in get_monitors() order. Natively each
+        output is grabbed on its own thread, so this takes about as long
+        as one capture_screen(). `size` applies to each image.
+        """
+        with self._capture_lock:
+            if not self._multi_checked:
+                self._multi_checked = True
+                self._multi_capture = native.open_multi_capture()
+            multi = self._multi_capture
+
+        if multi is not None:
+            frames = multi.grab()
+            try:
+                if all(frame is not None for frame in frames):
+                    return [self._frame_image(frame, size) for frame in frames]
+            finally:
+                for frame in frames:
+                    if frame is not None:
+                        frame.release()
+
+        with mss.mss() as sct:
+            return [self._mss_image(sct, output, size) for output in self._mss_outputs(sct)]
+
+    def _observe(self, frame) -> Optional["native.ScreenObservation"]:
+        cache = self._screen_cache
+        return cache.observe(frame) if cache is not None else None
+
+    def screen_changed_since(self, sequence: int) -> bool:
+        """
+        Whether the screen looks meaningfully different from capture
+        `sequence` (see capture_screen). Only perceptual hashes of a fresh
+        frame are compared; no pixels reach Python. Without the native
+        engine, or for a frame too old to be remembered, this is True.
+        """
+        session = self._capture_session()
+        if session is None or self._screen_cache is None:
+            return True
+
+        with session.grab() as frame:
+            self._observe(frame)
+        changed = self._screen_cache.changed_since(sequence)
+        return changed is None or changed > 0
+
+    def capture_incremental(self, tile_size: int = 64) -> IncrementalFrame:
+        """
+        Returns only the screen regions that changed since the previous
+        call, so the cost scales with the amount of change instead of the
+        resolution. Without the native engine every call is a full frame.
+        """
+        session = self._capture_session()
+        if session is not None:
+            frame, rects = session.grab_damage(tile_size)
+            with frame:
+                tiles = [(rect, frame.region(*rect)) for rect in rects]
+                return IncrementalFrame(frame.sequence, frame.size, tiles, frame.full_damage)
+
+        with mss.mss() as sct:
+            screenshot = sct.grab(self._mss_outputs(sct)[0])
+            self._fallback_sequence += 1
+            width, height = screenshot.size
+            return IncrementalFrame(
+                self._fallback_sequence,
+                (width, height),
+                [((0, 0, width, height), bytes(screenshot.bgra))],
+                True,
+            )
 
     # =================================================
     # System info
     # =================================================
 
+    @staticmethod
+    def _list_processes() -> Dict[int, str]:
+        return {p.pid: p.info["name"] or "" for p in psutil.process_iter(attrs=["name"])}
+
+    def _refresh_processes(self):
+        # Caller holds _process_lock.
+        if not self._process_checked:
+            self._process_checked = True
+            tracker = self._process_tracker = native.open_process_tracker()
+            self._processes = dict(tracker.processes()) if tracker else self._list_processes()
+            return
+
+        tracker = self._process_tracker
+        if tracker is not None:
+            added, removed = tracker.refresh()
+        else:
+            current = self._list_processes()
+            previous = self._processes
+            removed = [(pid, name) for pid, name in previous.items() if current.get(pid) != name]
+            added = [(pid, name) for pid, name in current.items() if previous.get(pid) != name]
+
+        table = self._processes
+        pending_added, pending_removed = self._process_added, self._process_removed
+        for pid, name in removed:
+            table.pop(pid, None)
+            # Started and exited before anyone asked: nothing to report.
+            if pending_added.pop(pid, None) is None:
+                pending_removed[pid] = name
+        for pid, name in added:
+            table[pid] = name
+            pending_added[pid] = name
+
     def get_running_processes(self) -> List[str]:
-        return [p.name() for p in psutil.process_iter(attrs=["name"])]
+        with self._process_lock:
+            self._refresh_processes()
+            return list(self._processes.values())
+
+    def get_process_changes(self) -> Dict[str, List[Tuple[int, str]]]:
+        """
+        Processes started ("added") and exited ("removed") since the
+        previous call, as (pid, name) pairs, so the context can carry
+        changes instead of the full list. The first call starts tracking
+        and reports nothing; a pid can appear in both when it was reused.
+        """
+        with self._process_lock:
+            self._refresh_processes()
+            changes = {
+                "added": list(self._process_added.items()),
+                "removed": list(self._process_removed.items()),
+            }
+            self._process_added.clear()
+            self._process_removed.clear()
+            return changes
 
     def shutdown(self):
-        if self._mouse_listener:
-            self._mouse_listener.stop()
+        with self._lock:
+            self._closed = True
+            listener = self._mouse_listener
+        if listener:
+            listener.stop()
+        if self._mouse_hooked:
+            native.stop_mouse_hook()
+            self._mouse_hooked = False
+
+        with self._capture_lock:
+            if self._capture:
+                self._capture.close()
+                self._capture = None
+                self._screen_cache = None
+            for session in self._output_captures.values():
+                if session:
+                    session.close()
+            self._output_captures.clear()
+            if self._multi_capture:
+                self._multi_capture.close()
+                self._multi_capture = None
+
+        if self._window_cache:
+            native.stop_window_cache()
+            self._window_cache = None
+            self._window_state = None
+
+        if self._history_path is not None:
+            native.flush_history()
 
 # Example usage
 if __name__ == "__main__":
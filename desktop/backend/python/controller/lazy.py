@@ -0,0 +1,71 @@
+"""
+Deferred imports for the heavy pure-Python dependencies (pyautogui,
+psutil, pygetwindow, pynput, mss, PIL).
+
+The native engine covers input, capture and telemetry on its own, so
+most sessions only need these for fallbacks; importing them up front
+costs seconds in the bundled interpreter. A LazyModule stands in for
+the module and imports it on first attribute access; preload() imports
+them ahead of time (e.g. on a background thread once startup is done).
+"""
+
+import importlib
+import threading
+from types import ModuleType
+from typing import Dict, Optional
+
+
+class LazyModule:
+    def __init__(self, name: str):
+        self._name = name
+        self._module: Optional[ModuleType] = None
+
+    def load(self) -> ModuleType:
+        module = self._module
+        if module is None:
+            # importlib serializes concurrent first imports itself
+            module = self._module = importlib.import_module(self._name)
+        return module
+
+    @property
+    def loaded(self) -> bool:
+        return self._module is not None
+
+    def __getattr__(self, attr: str):
+        return getattr(self.load(), attr)
+
+    def __repr__(self) -> str:
+        state = "loaded" if self._module is not None else "not loaded"
+        return f"<lazy module {self._name!r} ({state})>"
+
+
+_modules: Dict[str, LazyModule] = {}
+_modules_lock = threading.Lock()
+
+
+def lazy_import(name: str) -> LazyModule:
+    """One shared stand-in per module name."""
+    with _modules_lock:
+        module = _modules.get(name)
+        if module is None:
+            module = _modules[name] = LazyModule(name)
+        return module
+
+
+def preload(*names: str) -> Dict[str, Optional[BaseException]]:
+    """
+    Imports the given lazy modules (every one handed out so far when no
+    names are given). Returns name -> the import error, None on success;
+    a missing optional dependency is reported, not raised.
+    """
+    with _modules_lock:
+        modules = [_modules[n] for n in names if n in _modules] if names else list(_modules.values())
+
+    errors: Dict[str, Optional[BaseException]] = {}
+    for module in modules:
+        try:
+            module.load()
+            errors[module._name] = None
+        except Exception as e:  # ImportError, or a display-less pyautogui
+            errors[module._name] = e
+    return errors
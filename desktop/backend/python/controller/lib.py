@@ -1,12 +1,22 @@
 from .controls.mouse import MouseController
 from .controls.keyboard import KeyboardController
+from .controls.timeline import InstructionTimeline
 
 from .actions import ActionParser
 from .desktop import DesktopMonitor
+from .lazy import preload
 
 def initialize_driver():
     monitor = DesktopMonitor()
-    mouse = MouseController(monitor)
-    keyboard = KeyboardController(monitor)
+    timeline = InstructionTimeline()
+    mouse = MouseController(monitor, timeline)
+    keyboard = KeyboardController(monitor, timeline)
     parser = ActionParser(keyboard, mouse, monitor)
-    return monitor, mouse, keyboard, parser
\ No newline at end of file
+    return monitor, mouse, keyboard, parser, timeline
+
+def preload_modules():
+    """
+    Imports the dependencies the drivers defer (pyautogui, psutil, mss,
+    PIL, ...), off the critical path; name -> import error or None.
+    """
+    return preload()
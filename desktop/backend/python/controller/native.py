@@ -0,0 +1,2503 @@
+"""
+ctypes bindings for the neuro_native engine (native/c_cpp).
+
+Everything in here is optional: load() returns None when the shared
+library cannot be found, and callers fall back to the pure Python path.
+"""
+
+import ctypes
+import math
+import os
+import sys
+import threading
+import time
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+# ------------------------
+# Status codes (neuro_native.h)
+# ------------------------
+
+NN_OK = 0
+NN_ERR_UNAVAILABLE = -1
+NN_ERR_INVALID_ARGUMENT = -2
+NN_ERR_BUSY = -3
+NN_ERR_TIMEOUT = -4
+NN_ERR_FAILED = -5
+NN_ERR_SYNTAX = -6
+NN_ERR_CANCELLED = -7
+
+NN_BACKEND_NULL = 0
+NN_BACKEND_WIN32 = 1
+NN_BACKEND_X11 = 2
+NN_BACKEND_UINPUT = 3
+
+NN_FRAME_UNCHANGED = 1 << 0
+NN_FRAME_FULL_DAMAGE = 1 << 1
+
+NN_FILTER_BOX = 0
+NN_FILTER_BILINEAR = 1
+
+NN_SOURCE_UNKNOWN = 0
+NN_SOURCE_PARSER = 1
+NN_SOURCE_KEYBOARD = 2
+NN_SOURCE_MOUSE = 3
+NN_SOURCE_HOOK = 4
+NN_SOURCE_NATIVE = 5
+NN_TYPE_OP = 32
+NN_SOURCE_USER = 64
+
+NN_CHANNEL_ACTIONS = 0
+NN_CHANNEL_MOUSE = 1
+NN_HISTORY_NAMES = 0xFFFFFFFF  # Record.reserved of the log's name records
+
+NN_METRIC_GIL_WAIT = 0
+NN_METRIC_GIL_HOLD = 1
+NN_METRIC_QUEUE_DEPTH = 2
+NN_METRIC_INJECT = 3
+NN_METRIC_SCRIPT = 4
+NN_METRIC_CAPTURE_FRAME = 5
+NN_METRIC_WS_SEND = 6
+NN_METRIC_WS_RECV = 7
+NN_METRIC_USER = 16
+NN_METRIC_COUNT = 32
+
+NN_EVENT_MOUSE_MOVE = 1
+NN_EVENT_MOUSE_BUTTON = 2
+NN_EVENT_MOUSE_WHEEL = 3
+
+NN_RECORD_INJECTED = 1 << 0
+
+NN_OP_TYPE = 1
+NN_OP_PRESS = 2
+NN_OP_HOLD = 3
+NN_OP_RELEASE = 4
+NN_OP_SHORTCUT = 5
+NN_OP_MOVE = 6
+NN_OP_MOVE_N = 7
+NN_OP_CLICK = 8
+NN_OP_CLICK_N = 9
+NN_OP_PATH = 10
+NN_OP_WAIT = 11
+NN_OP_SYNC = 12
+NN_OP_CLICK_IMAGE = 13
+
+NN_BUTTON_LEFT = 1
+NN_BUTTON_MIDDLE = 2
+NN_BUTTON_RIGHT = 3
+
+NN_KEY_TAP = 0
+NN_KEY_DOWN = 1
+NN_KEY_UP = 2
+
+NN_TEXT_LAYOUT = 0
+NN_TEXT_UNICODE = 1
+
+NN_LANE_KEYBOARD = 0
+NN_LANE_MOUSE = 1
+NN_LANE_COUNT = 2
+
+NN_UI_STATE_FOCUSED = 1 << 0
+NN_UI_STATE_DISABLED = 1 << 1
+NN_UI_STATE_SELECTED = 1 << 2
+NN_UI_STATE_CHECKED = 1 << 3
+NN_UI_STATE_EXPANDED = 1 << 4
+NN_UI_STATE_COLLAPSED = 1 << 5
+NN_UI_STATE_OFFSCREEN = 1 << 6
+NN_UI_STATE_PROTECTED = 1 << 7
+
+
+class NativeError(Exception):
+    def __init__(self, status: int, what: str = ""):
+        self.status = status
+        reason = _lib.nn_status_string(status).decode() if _lib else str(status)
+        super().__init__(f"{what}: {reason}" if what else reason)
+
+
+# ------------------------
+# ABI structs
+# ------------------------
+
+class CaptureOptions(ctypes.Structure):
+    _fields_ = [
+        ("output", ctypes.c_int32),
+        ("ring_slots", ctypes.c_uint32),
+    ]
+
+
+class Rect(ctypes.Structure):
+    _fields_ = [
+        ("x", ctypes.c_int32),
+        ("y", ctypes.c_int32),
+        ("width", ctypes.c_int32),
+        ("height", ctypes.c_int32),
+    ]
+
+
+class Monitor(ctypes.Structure):
+    _fields_ = [
+        ("index", ctypes.c_int32),
+        ("bounds", Rect),
+        ("primary", ctypes.c_uint32),
+        ("name", ctypes.c_char * 64),
+    ]
+
+
+class Frame(ctypes.Structure):
+    _fields_ = [
+        ("data", ctypes.POINTER(ctypes.c_uint8)),
+        ("width", ctypes.c_int32),
+        ("height", ctypes.c_int32),
+        ("stride", ctypes.c_int32),
+        ("format", ctypes.c_uint32),
+        ("slot", ctypes.c_uint32),
+        ("flags", ctypes.c_uint32),
+        ("sequence", ctypes.c_uint64),
+        ("timestamp_ns", ctypes.c_uint64),
+    ]
+
+
+class Record(ctypes.Structure):
+    _fields_ = [
+        ("sequence", ctypes.c_uint64),
+        ("timestamp_ns", ctypes.c_uint64),
+        ("source", ctypes.c_uint16),
+        ("type", ctypes.c_uint16),
+        ("flags", ctypes.c_uint32),
+        ("x", ctypes.c_int32),
+        ("y", ctypes.c_int32),
+        ("arg", ctypes.c_int64),
+        ("value", ctypes.c_double),
+        ("aux", ctypes.c_uint64),
+        ("reserved", ctypes.c_uint64),
+    ]
+
+
+class MouseHookOptions(ctypes.Structure):
+    _fields_ = [
+        ("min_interval_us", ctypes.c_uint32),
+        ("poll_hz", ctypes.c_uint32),
+    ]
+
+
+class Match(ctypes.Structure):
+    _fields_ = [
+        ("x", ctypes.c_int32),
+        ("y", ctypes.c_int32),
+        ("width", ctypes.c_int32),
+        ("height", ctypes.c_int32),
+        ("score", ctypes.c_double),
+    ]
+
+
+class MatchOptions(ctypes.Structure):
+    _fields_ = [
+        ("threshold", ctypes.c_double),
+        ("levels", ctypes.c_uint32),
+        ("reserved", ctypes.c_uint32),
+        ("region", Rect),
+    ]
+
+
+class HistoryOptions(ctypes.Structure):
+    _fields_ = [
+        ("segment_records", ctypes.c_uint32),
+        ("keep_segments", ctypes.c_uint32),
+        ("rotate_seconds", ctypes.c_uint32),
+        ("reserved", ctypes.c_uint32),
+    ]
+
+
+class Point(ctypes.Structure):
+    _fields_ = [
+        ("x", ctypes.c_int32),
+        ("y", ctypes.c_int32),
+    ]
+
+
+class TextOptions(ctypes.Structure):
+    _fields_ = [
+        ("mode", ctypes.c_uint32),
+        ("paste_threshold", ctypes.c_uint32),
+    ]
+
+
+class Op(ctypes.Structure):
+    _fields_ = [
+        ("code", ctypes.c_uint16),
+        ("button", ctypes.c_uint16),
+        ("line", ctypes.c_uint32),
+        ("x", ctypes.c_int32),
+        ("y", ctypes.c_int32),
+        ("index", ctypes.c_uint32),
+        ("count", ctypes.c_uint32),
+        ("seconds", ctypes.c_double),
+        ("nx", ctypes.c_double),
+        ("ny", ctypes.c_double),
+    ]
+
+
+class Action(ctypes.Structure):
+    _fields_ = [
+        ("code", ctypes.c_uint16),
+        ("lane", ctypes.c_uint16),
+        ("arg", ctypes.c_uint32),
+        ("x", ctypes.c_int32),
+        ("y", ctypes.c_int32),
+        ("offset", ctypes.c_uint32),
+        ("count", ctypes.c_uint32),
+        ("seconds", ctypes.c_double),
+    ]
+
+
+class MetricStats(ctypes.Structure):
+    _fields_ = [
+        ("count", ctypes.c_uint64),
+        ("sum", ctypes.c_uint64),
+        ("min", ctypes.c_uint64),
+        ("max", ctypes.c_uint64),
+        ("p50", ctypes.c_uint64),
+        ("p90", ctypes.c_uint64),
+        ("p99", ctypes.c_uint64),
+        ("p999", ctypes.c_uint64),
+    ]
+
+
+class ScheduleStats(ctypes.Structure):
+    _fields_ = [
+        ("waits", ctypes.c_uint64),
+        ("mean_error_ns", ctypes.c_int64),
+        ("min_error_ns", ctypes.c_int64),
+        ("max_error_ns", ctypes.c_int64),
+        ("stddev_ns", ctypes.c_uint64),
+    ]
+
+
+class PathOptions(ctypes.Structure):
+    _fields_ = [
+        ("spacing", ctypes.c_double),
+        ("velocity", ctypes.c_double),
+        ("step_seconds", ctypes.c_double),
+        ("tolerance", ctypes.c_double),
+    ]
+
+
+class WindowInfo(ctypes.Structure):
+    _fields_ = [
+        ("id", ctypes.c_uint64),
+        ("pid", ctypes.c_uint32),
+        ("title_len", ctypes.c_uint32),
+        ("title", ctypes.c_void_p),
+    ]
+
+
+class UiElement(ctypes.Structure):
+    _fields_ = [
+        ("id", ctypes.c_uint64),
+        ("parent", ctypes.c_uint64),
+        ("depth", ctypes.c_uint32),
+        ("role", ctypes.c_uint32),
+        ("states", ctypes.c_uint32),
+        ("name_len", ctypes.c_uint32),
+        ("value_len", ctypes.c_uint32),
+        ("reserved", ctypes.c_uint32),
+        ("bounds", Rect),
+        ("name", ctypes.c_void_p),
+        ("value", ctypes.c_void_p),
+    ]
+
+
+class ProcessDelta(ctypes.Structure):
+    _fields_ = [
+        ("pid", ctypes.c_uint32),
+        ("name_id", ctypes.c_uint32),
+    ]
+
+
+class ScreenCacheOptions(ctypes.Structure):
+    _fields_ = [
+        ("capacity", ctypes.c_uint32),
+        ("tile_size", ctypes.c_uint32),
+        ("history", ctypes.c_uint32),
+        ("threshold", ctypes.c_uint32),
+    ]
+
+
+class ScreenObservation(ctypes.Structure):
+    _fields_ = [
+        ("state", ctypes.c_uint64),
+        ("sequence", ctypes.c_uint64),
+        ("first_sequence", ctypes.c_uint64),
+        ("value", ctypes.c_uint64),
+        ("frame_hash", ctypes.c_uint64),
+        ("changed_tiles", ctypes.c_uint32),
+        ("tile_count", ctypes.c_uint32),
+        ("known", ctypes.c_uint32),
+    ]
+
+
+class ScriptError(ctypes.Structure):
+    _fields_ = [
+        ("line", ctypes.c_uint32),
+        ("message", ctypes.c_char * 124),
+    ]
+
+
+_TypeTextFn = ctypes.CFUNCTYPE(ctypes.c_int32, ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint32)
+_KeyFn = ctypes.CFUNCTYPE(ctypes.c_int32, ctypes.c_void_p, ctypes.c_uint32, ctypes.c_char_p)
+_ShortcutFn = ctypes.CFUNCTYPE(
+    ctypes.c_int32, ctypes.c_void_p, ctypes.POINTER(ctypes.c_char_p), ctypes.c_uint32
+)
+_MoveFn = ctypes.CFUNCTYPE(ctypes.c_int32, ctypes.c_void_p, ctypes.c_int32, ctypes.c_int32, ctypes.c_double)
+_ClickFn = ctypes.CFUNCTYPE(ctypes.c_int32, ctypes.c_void_p, ctypes.c_int32, ctypes.c_int32, ctypes.c_uint32)
+_PathFn = ctypes.CFUNCTYPE(
+    ctypes.c_int32, ctypes.c_void_p, ctypes.POINTER(Point), ctypes.c_uint32, ctypes.c_double
+)
+_WaitFn = ctypes.CFUNCTYPE(ctypes.c_int32, ctypes.c_void_p, ctypes.c_double)
+_ScreenSizeFn = ctypes.CFUNCTYPE(
+    ctypes.c_int32, ctypes.c_void_p, ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_int32)
+)
+_FlushFn = ctypes.CFUNCTYPE(ctypes.c_int32, ctypes.c_void_p)
+
+
+class ScriptHost(ctypes.Structure):
+    _fields_ = [
+        ("user", ctypes.c_void_p),
+        ("type_text", _TypeTextFn),
+        ("key", _KeyFn),
+        ("shortcut", _ShortcutFn),
+        ("move", _MoveFn),
+        ("click", _ClickFn),
+        ("path", _PathFn),
+        ("wait", _WaitFn),
+        ("screen_size", _ScreenSizeFn),
+        ("flush", _FlushFn),  # optional: sends what the host holds back
+    ]
+
+
+# ------------------------
+# Library loading
+# ------------------------
+
+_LIB_NAMES = {
+    "win32": "neuro_native_shared.dll",
+    "darwin": "libneuro_native_shared.dylib",
+}
+
+_lib = None
+_load_lock = threading.Lock()
+_load_attempted = False
+
+
+def _candidates() -> List[Path]:
+    name = _LIB_NAMES.get(sys.platform, "libneuro_native_shared.so")
+    here = Path(__file__).resolve().parent
+
+    paths = []
+    if os.environ.get("NEURO_NATIVE_LIB"):
+        paths.append(Path(os.environ["NEURO_NATIVE_LIB"]))
+
+    # Bundled: <app>/python/controller -> <app>/python, <app>
+    paths.append(here.parent / name)
+    paths.append(here.parent.parent / name)
+
+    # Dev tree: desktop/backend/python/controller -> desktop/native/c_cpp/build
+    build = here.parents[2] / "native" / "c_cpp" / "build"
+    paths.append(build / name)
+    paths.append(build / "Release" / name)
+    return paths
+
+
+def _bind(lib):
+    c = ctypes
+
+    lib.nn_status_string.argtypes = [c.c_int32]
+    lib.nn_status_string.restype = c.c_char_p
+    lib.nn_backend.argtypes = []
+    lib.nn_backend.restype = c.c_uint32
+    lib.nn_backend_name.argtypes = [c.c_uint32]
+    lib.nn_backend_name.restype = c.c_char_p
+
+    # -------- Capture --------
+    lib.nn_capture_open.argtypes = [c.POINTER(CaptureOptions), c.POINTER(c.c_void_p)]
+    lib.nn_capture_open.restype = c.c_int32
+    lib.nn_capture_close.argtypes = [c.c_void_p]
+    lib.nn_capture_close.restype = None
+    lib.nn_capture_grab.argtypes = [c.c_void_p, c.c_uint32, c.POINTER(Frame)]
+    lib.nn_capture_grab.restype = c.c_int32
+    lib.nn_capture_release.argtypes = [c.c_void_p, c.c_uint32]
+    lib.nn_capture_release.restype = c.c_int32
+    lib.nn_capture_grab_damage.argtypes = [
+        c.c_void_p, c.c_uint32, c.c_uint32, c.POINTER(Frame),
+        c.POINTER(Rect), c.c_uint32, c.POINTER(c.c_uint32),
+    ]
+    lib.nn_capture_grab_damage.restype = c.c_int32
+
+    # -------- Monitors --------
+    lib.nn_monitors.argtypes = [c.POINTER(Monitor), c.c_uint32, c.POINTER(c.c_uint32)]
+    lib.nn_monitors.restype = c.c_int32
+    lib.nn_monitors_refresh.argtypes = []
+    lib.nn_monitors_refresh.restype = c.c_int32
+    lib.nn_virtual_desktop.argtypes = [c.POINTER(Rect)]
+    lib.nn_virtual_desktop.restype = c.c_int32
+    lib.nn_map_normalized.argtypes = [
+        c.c_int32, c.c_double, c.c_double, c.POINTER(c.c_int32), c.POINTER(c.c_int32),
+    ]
+    lib.nn_map_normalized.restype = c.c_int32
+    lib.nn_clamp_point.argtypes = [c.POINTER(c.c_int32), c.POINTER(c.c_int32), c.POINTER(c.c_int32)]
+    lib.nn_clamp_point.restype = c.c_int32
+    lib.nn_path_clamp_desktop.argtypes = [c.c_void_p]
+    lib.nn_path_clamp_desktop.restype = c.c_int32
+    lib.nn_multi_capture_open.argtypes = [c.c_uint32, c.POINTER(c.c_void_p)]
+    lib.nn_multi_capture_open.restype = c.c_int32
+    lib.nn_multi_capture_close.argtypes = [c.c_void_p]
+    lib.nn_multi_capture_close.restype = None
+    lib.nn_multi_capture_count.argtypes = [c.c_void_p]
+    lib.nn_multi_capture_count.restype = c.c_uint32
+    lib.nn_multi_capture_monitor.argtypes = [c.c_void_p, c.c_uint32, c.POINTER(Monitor)]
+    lib.nn_multi_capture_monitor.restype = c.c_int32
+    lib.nn_multi_capture_grab.argtypes = [
+        c.c_void_p, c.c_uint32, c.POINTER(Frame), c.POINTER(c.c_int32), c.c_uint32,
+    ]
+    lib.nn_multi_capture_grab.restype = c.c_int32
+    lib.nn_multi_capture_release.argtypes = [c.c_void_p, c.c_uint32, c.c_uint32]
+    lib.nn_multi_capture_release.restype = c.c_int32
+
+    # -------- Frame kernels --------
+    lib.nn_cpu_features.argtypes = []
+    lib.nn_cpu_features.restype = c.c_uint32
+    lib.nn_kernel_isa.argtypes = []
+    lib.nn_kernel_isa.restype = c.c_char_p
+    for name in ("nn_convert_rgb", "nn_convert_gray"):
+        fn = getattr(lib, name)
+        fn.argtypes = [c.POINTER(Frame), c.c_void_p, c.c_int32]
+        fn.restype = c.c_int32
+    lib.nn_downscale.argtypes = [
+        c.POINTER(Frame), c.c_void_p, c.c_int32, c.c_int32, c.c_int32, c.c_uint32,
+    ]
+    lib.nn_downscale.restype = c.c_int32
+    lib.nn_tile_count.argtypes = [c.c_int32, c.c_int32, c.c_uint32]
+    lib.nn_tile_count.restype = c.c_size_t
+    lib.nn_tile_diff.argtypes = [
+        c.POINTER(Frame), c.POINTER(Frame), c.c_uint32, c.c_uint32,
+        c.c_void_p, c.c_size_t, c.POINTER(c.c_uint32),
+    ]
+    lib.nn_tile_diff.restype = c.c_int32
+    lib.nn_tile_hashes.argtypes = [c.POINTER(Frame), c.c_uint32, c.c_void_p, c.c_size_t]
+    lib.nn_tile_hashes.restype = c.c_int32
+    lib.nn_perceptual_hashes.argtypes = [
+        c.POINTER(Frame), c.c_uint32, c.POINTER(c.c_uint64), c.c_void_p, c.c_size_t,
+    ]
+    lib.nn_perceptual_hashes.restype = c.c_int32
+    lib.nn_phash_distance.argtypes = [c.c_uint64, c.c_uint64]
+    lib.nn_phash_distance.restype = c.c_uint32
+
+    # -------- Template matching --------
+    lib.nn_template_add.argtypes = [c.c_char_p, c.POINTER(Frame)]
+    lib.nn_template_add.restype = c.c_int32
+    lib.nn_template_remove.argtypes = [c.c_char_p]
+    lib.nn_template_remove.restype = c.c_int32
+    lib.nn_template_clear.argtypes = []
+    lib.nn_template_clear.restype = None
+    lib.nn_match_template.argtypes = [
+        c.POINTER(Frame), c.c_char_p, c.POINTER(MatchOptions), c.POINTER(Match),
+        c.c_uint32, c.POINTER(c.c_uint32),
+    ]
+    lib.nn_match_template.restype = c.c_int32
+    lib.nn_locate.argtypes = [c.c_char_p, c.POINTER(MatchOptions), c.POINTER(Match)]
+    lib.nn_locate.restype = c.c_int32
+
+    # -------- Screen-state cache --------
+    lib.nn_screen_cache_create.argtypes = [c.POINTER(ScreenCacheOptions), c.POINTER(c.c_void_p)]
+    lib.nn_screen_cache_create.restype = c.c_int32
+    lib.nn_screen_cache_free.argtypes = [c.c_void_p]
+    lib.nn_screen_cache_free.restype = None
+    lib.nn_screen_cache_observe.argtypes = [c.c_void_p, c.POINTER(Frame), c.POINTER(ScreenObservation)]
+    lib.nn_screen_cache_observe.restype = c.c_int32
+    lib.nn_screen_cache_changed_since.argtypes = [c.c_void_p, c.c_uint64, c.POINTER(c.c_uint32)]
+    lib.nn_screen_cache_changed_since.restype = c.c_int32
+    lib.nn_screen_cache_set_value.argtypes = [c.c_void_p, c.c_uint64, c.c_uint64]
+    lib.nn_screen_cache_set_value.restype = c.c_int32
+
+    # -------- Telemetry --------
+    lib.nn_clock_ns.argtypes = []
+    lib.nn_clock_ns.restype = c.c_uint64
+    lib.nn_telemetry_create.argtypes = [c.c_uint32, c.POINTER(c.c_void_p)]
+    lib.nn_telemetry_create.restype = c.c_int32
+    lib.nn_telemetry_destroy.argtypes = [c.c_void_p]
+    lib.nn_telemetry_destroy.restype = None
+    lib.nn_telemetry_capacity.argtypes = [c.c_void_p]
+    lib.nn_telemetry_capacity.restype = c.c_uint32
+    lib.nn_telemetry_push.argtypes = [c.c_void_p, c.POINTER(Record)]
+    lib.nn_telemetry_push.restype = c.c_uint64
+    lib.nn_telemetry_push_event.argtypes = [
+        c.c_void_p, c.c_uint16, c.c_uint16, c.c_int32, c.c_int32, c.c_int64, c.c_double,
+    ]
+    lib.nn_telemetry_push_event.restype = c.c_uint64
+    lib.nn_telemetry_snapshot.argtypes = [c.c_void_p, c.c_uint64, c.POINTER(Record), c.c_size_t]
+    lib.nn_telemetry_snapshot.restype = c.c_size_t
+    lib.nn_telemetry_head.argtypes = [c.c_void_p]
+    lib.nn_telemetry_head.restype = c.c_uint64
+    lib.nn_telemetry_clear.argtypes = [c.c_void_p]
+    lib.nn_telemetry_clear.restype = None
+    lib.nn_telemetry_channel.argtypes = [c.c_uint32, c.c_uint32]
+    lib.nn_telemetry_channel.restype = c.c_void_p
+
+    # -------- History log --------
+    lib.nn_history_start.argtypes = [c.c_char_p, c.POINTER(HistoryOptions)]
+    lib.nn_history_start.restype = c.c_int32
+    lib.nn_history_stop.argtypes = []
+    lib.nn_history_stop.restype = None
+    lib.nn_history_name.argtypes = [c.c_uint16, c.c_char_p]
+    lib.nn_history_name.restype = c.c_int32
+    lib.nn_history_flush.argtypes = []
+    lib.nn_history_flush.restype = c.c_int32
+    lib.nn_history_rotate.argtypes = []
+    lib.nn_history_rotate.restype = c.c_int32
+    lib.nn_history_open.argtypes = [c.c_char_p, c.POINTER(c.c_void_p)]
+    lib.nn_history_open.restype = c.c_int32
+    lib.nn_history_close.argtypes = [c.c_void_p]
+    lib.nn_history_close.restype = None
+    lib.nn_history_records.argtypes = [c.c_void_p, c.POINTER(c.c_void_p)]
+    lib.nn_history_records.restype = c.c_size_t
+    lib.nn_history_range.argtypes = [c.c_void_p, c.c_uint64, c.c_uint64, c.POINTER(c.c_void_p)]
+    lib.nn_history_range.restype = c.c_size_t
+    lib.nn_history_name_of.argtypes = [c.c_void_p, c.c_uint16]
+    lib.nn_history_name_of.restype = c.c_char_p
+
+    # -------- Input hook --------
+    lib.nn_mouse_hook_start.argtypes = [c.c_void_p, c.POINTER(MouseHookOptions)]
+    lib.nn_mouse_hook_start.restype = c.c_int32
+    lib.nn_mouse_hook_stop.argtypes = []
+    lib.nn_mouse_hook_stop.restype = None
+    lib.nn_mouse_hook_position.argtypes = [
+        c.POINTER(c.c_int32), c.POINTER(c.c_int32), c.POINTER(c.c_uint64),
+    ]
+    lib.nn_mouse_hook_position.restype = c.c_int32
+
+    # -------- Action scripts --------
+    lib.nn_script_compile.argtypes = [
+        c.c_char_p, c.c_size_t, c.POINTER(c.c_void_p), c.POINTER(ScriptError),
+    ]
+    lib.nn_script_compile.restype = c.c_int32
+    lib.nn_script_free.argtypes = [c.c_void_p]
+    lib.nn_script_free.restype = None
+    lib.nn_script_hash.argtypes = [c.c_void_p]
+    lib.nn_script_hash.restype = c.c_uint64
+    lib.nn_script_ops.argtypes = [c.c_void_p, c.POINTER(c.c_size_t)]
+    lib.nn_script_ops.restype = c.POINTER(Op)
+    lib.nn_script_string.argtypes = [c.c_void_p, c.c_uint32, c.POINTER(c.c_uint32)]
+    lib.nn_script_string.restype = c.c_void_p
+    lib.nn_script_points.argtypes = [c.c_void_p, c.c_uint32]
+    lib.nn_script_points.restype = c.POINTER(Point)
+    lib.nn_script_run.argtypes = [c.c_void_p, c.POINTER(ScriptHost)]
+    lib.nn_script_run.restype = c.c_int32
+    lib.nn_script_cache_stats.argtypes = [
+        c.POINTER(c.c_uint64), c.POINTER(c.c_uint64), c.POINTER(c.c_uint32),
+    ]
+    lib.nn_script_cache_stats.restype = None
+    lib.nn_script_cache_clear.argtypes = []
+    lib.nn_script_cache_clear.restype = None
+
+    # -------- Metrics --------
+    lib.nn_metrics_record.argtypes = [c.c_uint32, c.c_uint64]
+    lib.nn_metrics_record.restype = c.c_int32
+    lib.nn_metrics_span.argtypes = [c.c_uint32, c.c_uint64, c.c_uint64]
+    lib.nn_metrics_span.restype = c.c_int32
+    lib.nn_metrics_get.argtypes = [c.c_uint32, c.POINTER(MetricStats)]
+    lib.nn_metrics_get.restype = c.c_int32
+    lib.nn_metrics_reset.argtypes = []
+    lib.nn_metrics_reset.restype = None
+    lib.nn_metrics_name.argtypes = [c.c_uint32]
+    lib.nn_metrics_name.restype = c.c_char_p
+    lib.nn_trace_start.argtypes = [c.c_uint32]
+    lib.nn_trace_start.restype = c.c_int32
+    lib.nn_trace_stop.argtypes = []
+    lib.nn_trace_stop.restype = None
+    lib.nn_trace_write.argtypes = [c.c_char_p]
+    lib.nn_trace_write.restype = c.c_int32
+
+    # -------- Scheduler --------
+    lib.nn_schedule_wait.argtypes = [c.c_double]
+    lib.nn_schedule_wait.restype = c.c_int64
+    lib.nn_schedule_wait_until.argtypes = [c.c_uint64]
+    lib.nn_schedule_wait_until.restype = c.c_int64
+    lib.nn_schedule_deadline.argtypes = []
+    lib.nn_schedule_deadline.restype = c.c_uint64
+    lib.nn_schedule_stats_get.argtypes = [c.POINTER(ScheduleStats)]
+    lib.nn_schedule_stats_get.restype = None
+    lib.nn_schedule_stats_reset.argtypes = []
+    lib.nn_schedule_stats_reset.restype = None
+
+    # -------- Input injection --------
+    lib.nn_input_open.argtypes = []
+    lib.nn_input_open.restype = c.c_int32
+    lib.nn_input_type.argtypes = [c.c_char_p, c.c_size_t, c.c_double]
+    lib.nn_input_type.restype = c.c_int32
+    lib.nn_input_paste.argtypes = [c.c_char_p, c.c_size_t]
+    lib.nn_input_paste.restype = c.c_int32
+    lib.nn_input_set_text_options.argtypes = [c.POINTER(TextOptions)]
+    lib.nn_input_set_text_options.restype = c.c_int32
+    lib.nn_input_text_options.argtypes = [c.POINTER(TextOptions)]
+    lib.nn_input_text_options.restype = c.c_int32
+    lib.nn_input_move.argtypes = [c.c_int32, c.c_int32, c.c_double]
+    lib.nn_input_move.restype = c.c_int32
+    lib.nn_input_path.argtypes = [c.POINTER(Point), c.c_uint32, c.c_double]
+    lib.nn_input_path.restype = c.c_int32
+    lib.nn_script_execute.argtypes = [c.c_char_p, c.c_size_t, c.POINTER(ScriptError)]
+    lib.nn_script_execute.restype = c.c_int32
+    lib.nn_script_stream.argtypes = [c.c_char_p, c.c_size_t, c.POINTER(ScriptError)]
+    lib.nn_script_stream.restype = c.c_int32
+
+    lib.nn_input_batch_create.argtypes = [c.POINTER(c.c_void_p)]
+    lib.nn_input_batch_create.restype = c.c_int32
+    lib.nn_input_batch_free.argtypes = [c.c_void_p]
+    lib.nn_input_batch_free.restype = None
+    lib.nn_input_batch_key.argtypes = [c.c_void_p, c.c_char_p, c.c_uint32]
+    lib.nn_input_batch_key.restype = c.c_int32
+    lib.nn_input_batch_hotkey.argtypes = [c.c_void_p, c.POINTER(c.c_char_p), c.c_uint32]
+    lib.nn_input_batch_hotkey.restype = c.c_int32
+    lib.nn_input_batch_type.argtypes = [c.c_void_p, c.c_char_p, c.c_size_t]
+    lib.nn_input_batch_type.restype = c.c_int32
+    lib.nn_input_batch_move.argtypes = [c.c_void_p, c.c_int32, c.c_int32]
+    lib.nn_input_batch_move.restype = c.c_int32
+    lib.nn_input_batch_click.argtypes = [c.c_void_p, c.c_int32, c.c_int32, c.c_uint32]
+    lib.nn_input_batch_click.restype = c.c_int32
+    lib.nn_input_batch_path.argtypes = [c.c_void_p, c.POINTER(Point), c.c_uint32]
+    lib.nn_input_batch_path.restype = c.c_int32
+    lib.nn_input_batch_size.argtypes = [c.c_void_p]
+    lib.nn_input_batch_size.restype = c.c_size_t
+    lib.nn_input_batch_send.argtypes = [c.c_void_p]
+    lib.nn_input_batch_send.restype = c.c_int32
+    lib.nn_input_batch_clear.argtypes = [c.c_void_p]
+    lib.nn_input_batch_clear.restype = None
+
+    # -------- Input timeline --------
+    lib.nn_timeline_create.argtypes = [c.POINTER(c.c_void_p)]
+    lib.nn_timeline_create.restype = c.c_int32
+    lib.nn_timeline_free.argtypes = [c.c_void_p]
+    lib.nn_timeline_free.restype = None
+    lib.nn_timeline_key.argtypes = [c.c_void_p, c.c_uint32, c.c_char_p, c.c_uint32]
+    lib.nn_timeline_key.restype = c.c_int32
+    lib.nn_timeline_hotkey.argtypes = [c.c_void_p, c.c_uint32, c.POINTER(c.c_char_p), c.c_uint32]
+    lib.nn_timeline_hotkey.restype = c.c_int32
+    lib.nn_timeline_type.argtypes = [c.c_void_p, c.c_uint32, c.c_char_p, c.c_size_t, c.c_double]
+    lib.nn_timeline_type.restype = c.c_int32
+    lib.nn_timeline_move.argtypes = [c.c_void_p, c.c_uint32, c.c_int32, c.c_int32, c.c_double]
+    lib.nn_timeline_move.restype = c.c_int32
+    lib.nn_timeline_click.argtypes = [c.c_void_p, c.c_uint32, c.c_int32, c.c_int32, c.c_uint32]
+    lib.nn_timeline_click.restype = c.c_int32
+    lib.nn_timeline_path.argtypes = [c.c_void_p, c.c_uint32, c.POINTER(Point), c.c_uint32, c.c_double]
+    lib.nn_timeline_path.restype = c.c_int32
+    lib.nn_timeline_wait.argtypes = [c.c_void_p, c.c_uint32, c.c_double]
+    lib.nn_timeline_wait.restype = c.c_int32
+    lib.nn_timeline_sync.argtypes = [c.c_void_p, c.c_double]
+    lib.nn_timeline_sync.restype = c.c_int32
+    lib.nn_timeline_size.argtypes = [c.c_void_p]
+    lib.nn_timeline_size.restype = c.c_size_t
+    lib.nn_timeline_duration_ns.argtypes = [c.c_void_p]
+    lib.nn_timeline_duration_ns.restype = c.c_uint64
+    lib.nn_timeline_run.argtypes = [c.c_void_p]
+    lib.nn_timeline_run.restype = c.c_int32
+    lib.nn_timeline_clear.argtypes = [c.c_void_p]
+    lib.nn_timeline_clear.restype = None
+
+    # -------- Action queue --------
+    lib.nn_action_queue_create.argtypes = [c.POINTER(c.c_void_p)]
+    lib.nn_action_queue_create.restype = c.c_int32
+    lib.nn_action_queue_free.argtypes = [c.c_void_p]
+    lib.nn_action_queue_free.restype = None
+    lib.nn_action_queue_clear.argtypes = [c.c_void_p]
+    lib.nn_action_queue_clear.restype = None
+    lib.nn_action_queue_size.argtypes = [c.c_void_p]
+    lib.nn_action_queue_size.restype = c.c_size_t
+    lib.nn_action_queue_bytes.argtypes = [c.c_void_p]
+    lib.nn_action_queue_bytes.restype = c.c_size_t
+    lib.nn_action_queue_key.argtypes = [c.c_void_p, c.c_uint32, c.c_char_p, c.c_uint32, c.c_uint32]
+    lib.nn_action_queue_key.restype = c.c_int32
+    lib.nn_action_queue_type.argtypes = [c.c_void_p, c.c_uint32, c.c_char_p, c.c_size_t, c.c_double]
+    lib.nn_action_queue_type.restype = c.c_int32
+    lib.nn_action_queue_shortcut.argtypes = [c.c_void_p, c.c_uint32, c.POINTER(c.c_char_p), c.c_uint32]
+    lib.nn_action_queue_shortcut.restype = c.c_int32
+    lib.nn_action_queue_move.argtypes = [c.c_void_p, c.c_uint32, c.c_int32, c.c_int32, c.c_double]
+    lib.nn_action_queue_move.restype = c.c_int32
+    lib.nn_action_queue_click.argtypes = [c.c_void_p, c.c_uint32, c.c_int32, c.c_int32, c.c_uint32]
+    lib.nn_action_queue_click.restype = c.c_int32
+    lib.nn_action_queue_path.argtypes = [c.c_void_p, c.c_uint32, c.POINTER(Point), c.c_uint32, c.c_double]
+    lib.nn_action_queue_path.restype = c.c_int32
+    lib.nn_action_queue_wait.argtypes = [c.c_void_p, c.c_uint32, c.c_double]
+    lib.nn_action_queue_wait.restype = c.c_int32
+    lib.nn_action_queue_sync.argtypes = [c.c_void_p, c.c_double]
+    lib.nn_action_queue_sync.restype = c.c_int32
+    lib.nn_action_queue_records.argtypes = [c.c_void_p, c.POINTER(c.c_size_t)]
+    lib.nn_action_queue_records.restype = c.POINTER(Action)
+    lib.nn_action_queue_payload.argtypes = [c.c_void_p, c.c_uint32]
+    lib.nn_action_queue_payload.restype = c.c_void_p
+    lib.nn_action_queue_drop_lane.argtypes = [c.c_void_p, c.c_uint32]
+    lib.nn_action_queue_drop_lane.restype = c.c_int32
+    lib.nn_action_queue_schedule.argtypes = [c.c_void_p, c.c_void_p]
+    lib.nn_action_queue_schedule.restype = c.c_int32
+    lib.nn_action_queue_execute.argtypes = [c.c_void_p, c.c_uint32, c.c_void_p]
+    lib.nn_action_queue_execute.restype = c.c_int32
+
+    # -------- Path generation --------
+    lib.nn_path_create.argtypes = [c.POINTER(PathOptions), c.POINTER(c.c_void_p)]
+    lib.nn_path_create.restype = c.c_int32
+    lib.nn_path_free.argtypes = [c.c_void_p]
+    lib.nn_path_free.restype = None
+    lib.nn_path_clear.argtypes = [c.c_void_p]
+    lib.nn_path_clear.restype = None
+    lib.nn_path_line_steps.argtypes = [c.c_void_p, Point, Point, c.c_int64]
+    lib.nn_path_line_steps.restype = c.c_int32
+    lib.nn_path_line.argtypes = [c.c_void_p, Point, Point]
+    lib.nn_path_line.restype = c.c_int32
+    lib.nn_path_polyline.argtypes = [c.c_void_p, c.POINTER(Point), c.c_size_t]
+    lib.nn_path_polyline.restype = c.c_int32
+    lib.nn_path_bezier.argtypes = [c.c_void_p, c.POINTER(Point), c.c_size_t]
+    lib.nn_path_bezier.restype = c.c_int32
+    lib.nn_path_catmull_rom.argtypes = [c.c_void_p, c.POINTER(Point), c.c_size_t]
+    lib.nn_path_catmull_rom.restype = c.c_int32
+    lib.nn_path_clamp.argtypes = [c.c_void_p, c.c_int32, c.c_int32]
+    lib.nn_path_clamp.restype = c.c_int32
+    lib.nn_path_points.argtypes = [c.c_void_p, c.POINTER(c.c_size_t)]
+    lib.nn_path_points.restype = c.POINTER(Point)
+
+    # -------- Window state --------
+    lib.nn_window_cache_start.argtypes = []
+    lib.nn_window_cache_start.restype = c.c_int32
+    lib.nn_window_cache_stop.argtypes = []
+    lib.nn_window_cache_stop.restype = None
+    lib.nn_window_cache_version.argtypes = []
+    lib.nn_window_cache_version.restype = c.c_uint64
+    lib.nn_window_snapshot_get.argtypes = [c.POINTER(c.c_void_p)]
+    lib.nn_window_snapshot_get.restype = c.c_int32
+    lib.nn_window_snapshot_free.argtypes = [c.c_void_p]
+    lib.nn_window_snapshot_free.restype = None
+    lib.nn_window_snapshot_version.argtypes = [c.c_void_p]
+    lib.nn_window_snapshot_version.restype = c.c_uint64
+    lib.nn_window_snapshot_count.argtypes = [c.c_void_p]
+    lib.nn_window_snapshot_count.restype = c.c_size_t
+    lib.nn_window_snapshot_window.argtypes = [c.c_void_p, c.c_size_t, c.POINTER(WindowInfo)]
+    lib.nn_window_snapshot_window.restype = c.c_int32
+    lib.nn_window_snapshot_active.argtypes = [c.c_void_p]
+    lib.nn_window_snapshot_active.restype = c.c_int64
+
+    # -------- Accessibility tree --------
+    lib.nn_ui_tree_start.argtypes = []
+    lib.nn_ui_tree_start.restype = c.c_int32
+    lib.nn_ui_tree_stop.argtypes = []
+    lib.nn_ui_tree_stop.restype = None
+    lib.nn_ui_tree_version.argtypes = []
+    lib.nn_ui_tree_version.restype = c.c_uint64
+    lib.nn_ui_snapshot_get.argtypes = [c.POINTER(c.c_void_p)]
+    lib.nn_ui_snapshot_get.restype = c.c_int32
+    lib.nn_ui_snapshot_free.argtypes = [c.c_void_p]
+    lib.nn_ui_snapshot_free.restype = None
+    lib.nn_ui_snapshot_version.argtypes = [c.c_void_p]
+    lib.nn_ui_snapshot_version.restype = c.c_uint64
+    lib.nn_ui_snapshot_window.argtypes = [c.c_void_p]
+    lib.nn_ui_snapshot_window.restype = c.c_uint64
+    lib.nn_ui_snapshot_count.argtypes = [c.c_void_p]
+    lib.nn_ui_snapshot_count.restype = c.c_size_t
+    lib.nn_ui_snapshot_element.argtypes = [c.c_void_p, c.c_size_t, c.POINTER(UiElement)]
+    lib.nn_ui_snapshot_element.restype = c.c_int32
+    lib.nn_ui_snapshot_focus.argtypes = [c.c_void_p]
+    lib.nn_ui_snapshot_focus.restype = c.c_int64
+    lib.nn_ui_snapshot_truncated.argtypes = [c.c_void_p]
+    lib.nn_ui_snapshot_truncated.restype = c.c_int
+    lib.nn_ui_snapshot_text.argtypes = [c.c_void_p, c.c_char_p, c.c_size_t, c.POINTER(c.c_size_t)]
+    lib.nn_ui_snapshot_text.restype = c.c_int32
+    lib.nn_ui_role_name.argtypes = [c.c_uint32]
+    lib.nn_ui_role_name.restype = c.c_char_p
+
+    # -------- Process tracking --------
+    lib.nn_process_tracker_create.argtypes = [c.POINTER(c.c_void_p)]
+    lib.nn_process_tracker_create.restype = c.c_int32
+    lib.nn_process_tracker_free.argtypes = [c.c_void_p]
+    lib.nn_process_tracker_free.restype = None
+    lib.nn_process_tracker_refresh.argtypes = [c.c_void_p]
+    lib.nn_process_tracker_refresh.restype = c.c_int32
+    lib.nn_process_tracker_added.argtypes = [c.c_void_p, c.POINTER(c.c_size_t)]
+    lib.nn_process_tracker_added.restype = c.POINTER(ProcessDelta)
+    lib.nn_process_tracker_removed.argtypes = [c.c_void_p, c.POINTER(c.c_size_t)]
+    lib.nn_process_tracker_removed.restype = c.POINTER(ProcessDelta)
+    lib.nn_process_tracker_size.argtypes = [c.c_void_p]
+    lib.nn_process_tracker_size.restype = c.c_size_t
+    lib.nn_process_tracker_list.argtypes = [c.c_void_p, c.POINTER(ProcessDelta), c.c_size_t]
+    lib.nn_process_tracker_list.restype = c.c_size_t
+    lib.nn_process_name_count.argtypes = [c.c_void_p]
+    lib.nn_process_name_count.restype = c.c_size_t
+    lib.nn_process_name.argtypes = [c.c_void_p, c.c_uint32, c.POINTER(c.c_uint32)]
+    lib.nn_process_name.restype = c.c_void_p
+
+
+def load():
+    """
+    Returns the loaded library, or None if it is not available.
+    """
+    global _lib, _load_attempted
+
+    with _load_lock:
+        if _load_attempted:
+            return _lib
+        _load_attempted = True
+
+        # By bare name first: when embedded in the Rust app the library is
+        # already loaded, and both sides must share that one instance.
+        name = _LIB_NAMES.get(sys.platform, "libneuro_native_shared.so")
+
+        for path in [name] + _candidates():
+            if isinstance(path, Path) and not path.is_file():
+                continue
+            try:
+                lib = ctypes.CDLL(str(path))
+                _bind(lib)
+            except (OSError, AttributeError):
+                continue
+            _lib = lib
+            break
+
+        return _lib
+
+
+def _check(status: int, what: str):
+    if status != NN_OK:
+        raise NativeError(status, what)
+
+
+# =================================================
+# Screen capture
+# =================================================
+
+class FrameView:
+    """
+    Zero-copy view of a leased capture-ring slot (BGRA).
+
+    `buffer` aliases native memory and is only valid until release().
+    Use as a context manager to return the slot automatically.
+    """
+
+    def __init__(self, session: "CaptureSession", frame: Frame):
+        self._session = session
+        self._frame = frame
+        self._released = False
+
+        size = frame.stride * frame.height
+        array = (ctypes.c_uint8 * size).from_address(ctypes.addressof(frame.data.contents))
+        self.buffer = memoryview(array).cast("B")
+
+    width = property(lambda self: self._frame.width)
+    height = property(lambda self: self._frame.height)
+    stride = property(lambda self: self._frame.stride)
+    sequence = property(lambda self: self._frame.sequence)
+    timestamp_ns = property(lambda self: self._frame.timestamp_ns)
+    unchanged = property(lambda self: bool(self._frame.flags & NN_FRAME_UNCHANGED))
+    full_damage = property(lambda self: bool(self._frame.flags & NN_FRAME_FULL_DAMAGE))
+
+    @property
+    def size(self):
+        return self._frame.width, self._frame.height
+
+    def region(self, x: int, y: int, width: int, height: int) -> bytes:
+        """
+        Copies one rectangle out of the frame as tightly packed BGRA.
+        """
+        row = width * 4
+        start = y * self.stride + x * 4
+        return b"".join(
+            self.buffer[start + i * self.stride:start + i * self.stride + row]
+            for i in range(height)
+        )
+
+    def release(self):
+        if not self._released:
+            self._released = True
+            try:
+                self.buffer.release()
+            except BufferError:
+                pass  # still exported (e.g. numpy view); slot is returned anyway
+            self._session._release(self._frame.slot)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.release()
+
+    def __del__(self):
+        try:
+            self.release()
+        except Exception:
+            pass
+
+
+class CaptureSession:
+    """
+    Persistent capture session over a ring of preallocated frame buffers.
+    """
+
+    MAX_DAMAGE_RECTS = 4096
+
+    def __init__(self, lib, output: int = 0, ring_slots: int = 3):
+        self._lib = lib
+        self._handle = ctypes.c_void_p()
+
+        # Reused by every damage grab
+        self._rects = (Rect * self.MAX_DAMAGE_RECTS)()
+        self._rect_count = ctypes.c_uint32()
+
+        options = CaptureOptions(output, ring_slots)
+        _check(lib.nn_capture_open(ctypes.byref(options), ctypes.byref(self._handle)), "capture_open")
+
+    def grab(self, timeout_ms: int = 100) -> FrameView:
+        frame = Frame()
+        _check(self._lib.nn_capture_grab(self._handle, timeout_ms, ctypes.byref(frame)), "capture_grab")
+        return FrameView(self, frame)
+
+    def grab_damage(self, tile_size: int = 64, timeout_ms: int = 100):
+        """
+        Returns (FrameView, [(x, y, w, h), ...]) with only the regions that
+        changed since the previous grab.
+        """
+        frame = Frame()
+        _check(self._lib.nn_capture_grab_damage(
+            self._handle, timeout_ms, tile_size, ctypes.byref(frame),
+            self._rects, self.MAX_DAMAGE_RECTS, ctypes.byref(self._rect_count),
+        ), "capture_grab_damage")
+
+        rects = [
+            (r.x, r.y, r.width, r.height)
+            for r in self._rects[:self._rect_count.value]
+        ]
+        return FrameView(self, frame), rects
+
+    def _release(self, slot: int):
+        if self._handle:
+            self._lib.nn_capture_release(self._handle, slot)
+
+    def close(self):
+        if self._handle:
+            self._lib.nn_capture_close(self._handle)
+            self._handle = ctypes.c_void_p()
+
+
+def open_capture(output: int = 0, ring_slots: int = 3) -> Optional[CaptureSession]:
+    """
+    Opens a capture session, or returns None when native capture is not
+    available on this machine.
+    """
+    lib = load()
+    if lib is None:
+        return None
+    try:
+        return CaptureSession(lib, output, ring_slots)
+    except NativeError:
+        return None
+
+
+# =================================================
+# Monitors
+# =================================================
+
+def monitors() -> Optional[List[Monitor]]:
+    """
+    Every output, primary first, bounds in virtual-desktop pixels; None
+    without the native library or a capture backend. Enumerated once,
+    see refresh_monitors().
+    """
+    lib = load()
+    if lib is None:
+        return None
+    count = ctypes.c_uint32()
+    if lib.nn_monitors(None, 0, ctypes.byref(count)) != NN_OK:
+        return None
+    out = (Monitor * count.value)()
+    if lib.nn_monitors(out, count.value, ctypes.byref(count)) != NN_OK:
+        return None
+    return list(out[:count.value])
+
+
+def refresh_monitors() -> bool:
+    """Enumerates the outputs again, e.g. after a display change."""
+    lib = load()
+    return lib is not None and lib.nn_monitors_refresh() == NN_OK
+
+
+def virtual_desktop() -> Optional[Tuple[int, int, int, int]]:
+    """(x, y, width, height) covering every monitor."""
+    lib = load()
+    if lib is None:
+        return None
+    rect = Rect()
+    if lib.nn_virtual_desktop(ctypes.byref(rect)) != NN_OK:
+        return None
+    return rect.x, rect.y, rect.width, rect.height
+
+
+def map_normalized(nx: float, ny: float, monitor: int = 0) -> Optional[Tuple[int, int]]:
+    """
+    Normalized 0.0-1.0 coordinates on `monitor` (-1 = the whole virtual
+    desktop) to virtual-desktop pixels, or None without a layout.
+    """
+    lib = load()
+    if lib is None:
+        return None
+    x, y = ctypes.c_int32(), ctypes.c_int32()
+    status = lib.nn_map_normalized(monitor, nx, ny, ctypes.byref(x), ctypes.byref(y))
+    if status == NN_ERR_INVALID_ARGUMENT:
+        raise ValueError(f"no monitor {monitor}")
+    if status != NN_OK:
+        return None
+    return x.value, y.value
+
+
+def clamp_point(x: int, y: int) -> Optional[Tuple[int, int, int]]:
+    """
+    (x, y, monitor) with the point moved onto the nearest monitor, or None
+    without a layout.
+    """
+    lib = load()
+    if lib is None:
+        return None
+    cx, cy, index = ctypes.c_int32(x), ctypes.c_int32(y), ctypes.c_int32()
+    if lib.nn_clamp_point(ctypes.byref(cx), ctypes.byref(cy), ctypes.byref(index)) != NN_OK:
+        return None
+    return cx.value, cy.value, index.value
+
+
+class _MultiOutput:
+    """Release target for FrameViews of one MultiCapture output."""
+
+    def __init__(self, owner: "MultiCapture", output: int):
+        self._owner = owner
+        self._output = output
+
+    def _release(self, slot: int):
+        if self._owner._handle:
+            self._owner._lib.nn_multi_capture_release(self._owner._handle, self._output, slot)
+
+
+class MultiCapture:
+    """
+    Every monitor captured at once, one native session and grab thread
+    per output.
+    """
+
+    def __init__(self, lib, ring_slots: int = 3):
+        self._lib = lib
+        self._handle = ctypes.c_void_p()
+        _check(lib.nn_multi_capture_open(ring_slots, ctypes.byref(self._handle)), "multi_capture_open")
+
+        count = lib.nn_multi_capture_count(self._handle)
+        self.monitors: List[Monitor] = []
+        for i in range(count):
+            monitor = Monitor()
+            lib.nn_multi_capture_monitor(self._handle, i, ctypes.byref(monitor))
+            self.monitors.append(monitor)
+        self._outputs = [_MultiOutput(self, i) for i in range(count)]
+
+        # Reused by every grab
+        self._frames = (Frame * count)()
+        self._statuses = (ctypes.c_int32 * count)()
+
+    def grab(self, timeout_ms: int = 100) -> List[Optional[FrameView]]:
+        """
+        One FrameView per monitor (in self.monitors order), None for an
+        output whose grab failed.
+        """
+        count = len(self._outputs)
+        self._lib.nn_multi_capture_grab(self._handle, timeout_ms, self._frames, self._statuses, count)
+        return [
+            FrameView(self._outputs[i], Frame.from_buffer_copy(self._frames[i]))
+            if self._statuses[i] == NN_OK else None
+            for i in range(count)
+        ]
+
+    def close(self):
+        if self._handle:
+            self._lib.nn_multi_capture_close(self._handle)
+            self._handle = ctypes.c_void_p()
+
+
+def open_multi_capture(ring_slots: int = 3) -> Optional[MultiCapture]:
+    """
+    Opens a capture session per monitor, or returns None when native
+    capture is not available.
+    """
+    lib = load()
+    if lib is None:
+        return None
+    try:
+        return MultiCapture(lib, ring_slots)
+    except NativeError:
+        return None
+
+
+# =================================================
+# Frame kernels
+# =================================================
+
+def _address(buffer) -> int:
+    return ctypes.addressof((ctypes.c_uint8 * len(buffer)).from_buffer(buffer))
+
+
+def wrap_bgra(buffer: bytearray, width: int, height: int, stride: int = 0) -> Frame:
+    """
+    Describes a writable BGRA buffer as a Frame so kernels can read it.
+    """
+    frame = Frame()
+    frame.data = ctypes.cast(_address(buffer), ctypes.POINTER(ctypes.c_uint8))
+    frame.width = width
+    frame.height = height
+    frame.stride = stride or width * 4
+    return frame
+
+
+def _source(frame) -> Frame:
+    return frame._frame if isinstance(frame, FrameView) else frame
+
+
+def convert_rgb(frame) -> bytearray:
+    src = _source(frame)
+    out = bytearray(src.width * src.height * 3)
+    _check(_lib.nn_convert_rgb(ctypes.byref(src), _address(out), src.width * 3), "convert_rgb")
+    return out
+
+
+def convert_gray(frame) -> bytearray:
+    src = _source(frame)
+    out = bytearray(src.width * src.height)
+    _check(_lib.nn_convert_gray(ctypes.byref(src), _address(out), src.width), "convert_gray")
+    return out
+
+
+def downscale(frame, width: int, height: int, filter: int = NN_FILTER_BILINEAR) -> bytearray:
+    """
+    Resamples a BGRA frame to width x height (BGRA, tightly packed).
+    """
+    out = bytearray(width * height * 4)
+    _check(_lib.nn_downscale(
+        ctypes.byref(_source(frame)), _address(out), width, height, width * 4, filter
+    ), "downscale")
+    return out
+
+
+def downscale_rgb(frame, width: int, height: int, filter: int = NN_FILTER_BILINEAR) -> bytearray:
+    return convert_rgb(wrap_bgra(downscale(frame, width, height, filter), width, height))
+
+
+def tile_diff(a, b, tile_size: int = 64, threshold: int = 0):
+    """
+    Returns (changed_count, bytearray map) with 1 for every tile of b that
+    differs from a.
+    """
+    fa, fb = _source(a), _source(b)
+    map_ = bytearray(max(1, _lib.nn_tile_count(fa.width, fa.height, tile_size)))
+    changed = ctypes.c_uint32()
+    _check(_lib.nn_tile_diff(
+        ctypes.byref(fa), ctypes.byref(fb), tile_size, threshold,
+        _address(map_), len(map_), ctypes.byref(changed),
+    ), "tile_diff")
+    return changed.value, map_
+
+
+def tile_hashes(frame, tile_size: int = 64) -> List[int]:
+    src = _source(frame)
+    count = _lib.nn_tile_count(src.width, src.height, tile_size)
+    out = (ctypes.c_uint64 * max(1, count))()
+    _check(_lib.nn_tile_hashes(ctypes.byref(src), tile_size, out, count), "tile_hashes")
+    return list(out[:count])
+
+
+def perceptual_hashes(frame, tile_size: int = 64):
+    """
+    (frame_hash, [tile_hash, ...]): perceptual hashes, close for images
+    that look alike. Compare them with phash_distance.
+    """
+    src = _source(frame)
+    count = _lib.nn_tile_count(src.width, src.height, tile_size)
+    out = (ctypes.c_uint64 * max(1, count))()
+    frame_hash = ctypes.c_uint64()
+    _check(_lib.nn_perceptual_hashes(
+        ctypes.byref(src), tile_size, ctypes.byref(frame_hash), out, count
+    ), "perceptual_hashes")
+    return frame_hash.value, list(out[:count])
+
+
+def phash_distance(a: int, b: int) -> int:
+    return _lib.nn_phash_distance(a, b)
+
+
+# =================================================
+# Template matching
+# =================================================
+
+MatchResult = Tuple[int, int, int, int, float]  # x, y, width, height, score
+
+
+def _match_options(threshold: float, region: Optional[Tuple[int, int, int, int]]) -> MatchOptions:
+    options = MatchOptions()
+    options.threshold = threshold
+    if region is not None:
+        options.region = Rect(*region)
+    return options
+
+
+def add_template(name: str, image):
+    """
+    Registers `image` under `name` for match_template, locate and the
+    CLICK_IMAGE script command. Accepts a PIL image (any mode), a Frame
+    or FrameView, or a (bgra_bytes, width, height) tuple. The pixels are
+    copied; a single-colour image is refused.
+    """
+    pixels = None  # keeps a converted copy alive through the call
+    if isinstance(image, tuple):
+        data, width, height = image
+        pixels = bytearray(data)
+        frame = wrap_bgra(pixels, width, height)
+    elif hasattr(image, "tobytes"):
+        width, height = image.size
+        pixels = bytearray(image.convert("RGBA").tobytes("raw", "BGRA"))
+        frame = wrap_bgra(pixels, width, height)
+    else:
+        frame = _source(image)
+    _check(_lib.nn_template_add(name.encode(), ctypes.byref(frame)), "template_add")
+
+
+def remove_template(name: str) -> bool:
+    return _lib.nn_template_remove(name.encode()) == NN_OK
+
+
+def clear_templates():
+    _lib.nn_template_clear()
+
+
+def match_template(frame, name: str, threshold: float = 0.0, max_results: int = 8,
+                   region: Optional[Tuple[int, int, int, int]] = None) -> List[MatchResult]:
+    """
+    Non-overlapping matches of template `name` in `frame`, best first.
+    threshold 0 uses the native default (0.8); region is (x, y, w, h).
+    """
+    options = _match_options(threshold, region)
+    out = (Match * max(1, max_results))()
+    count = ctypes.c_uint32()
+    _check(_lib.nn_match_template(
+        ctypes.byref(_source(frame)), name.encode(), ctypes.byref(options), out, len(out),
+        ctypes.byref(count),
+    ), "match_template")
+    return [(m.x, m.y, m.width, m.height, m.score) for m in out[:count.value]]
+
+
+def locate(name: str, threshold: float = 0.0,
+           region: Optional[Tuple[int, int, int, int]] = None) -> Optional[MatchResult]:
+    """
+    Best match of `name` on the primary monitor right now, in desktop
+    pixels, or None when it is not on screen.
+    """
+    options = _match_options(threshold, region)
+    match = Match()
+    status = _lib.nn_locate(name.encode(), ctypes.byref(options), ctypes.byref(match))
+    if status == NN_ERR_FAILED:
+        return None
+    _check(status, "locate")
+    return match.x, match.y, match.width, match.height, match.score
+
+
+# =================================================
+# Screen-state cache
+# =================================================
+
+class ScreenCache:
+    """
+    Perceptual hashes of observed frames: how many tiles changed since an
+    earlier frame, and which previously seen screen state a frame matches
+    (with a caller value attached to each state).
+    """
+
+    def __init__(self, lib, handle: ctypes.c_void_p):
+        self._lib = lib
+        self._handle = handle
+        self._changed = ctypes.c_uint32()
+
+    def observe(self, frame) -> ScreenObservation:
+        out = ScreenObservation()
+        _check(self._lib.nn_screen_cache_observe(
+            self._handle, ctypes.byref(_source(frame)), ctypes.byref(out)
+        ), "screen_cache_observe")
+        return out
+
+    def changed_since(self, sequence: int) -> Optional[int]:
+        """
+        Tiles changed between frame `sequence` and the latest observed
+        one, or None when that frame is no longer remembered.
+        """
+        status = self._lib.nn_screen_cache_changed_since(self._handle, sequence, ctypes.byref(self._changed))
+        if status == NN_ERR_UNAVAILABLE:
+            return None
+        _check(status, "screen_cache_changed_since")
+        return self._changed.value
+
+    def set_value(self, state: int, value: int) -> bool:
+        """False when the state has already been evicted."""
+        return self._lib.nn_screen_cache_set_value(self._handle, state, value) == NN_OK
+
+    def __del__(self):
+        if self._handle:
+            self._lib.nn_screen_cache_free(self._handle)
+            self._handle = None
+
+
+def open_screen_cache(capacity: int = 0, tile_size: int = 0, history: int = 0,
+                      threshold: int = 0) -> Optional[ScreenCache]:
+    """Zeros pick the native defaults; None without the library."""
+    lib = load()
+    if lib is None:
+        return None
+
+    handle = ctypes.c_void_p()
+    options = ScreenCacheOptions(capacity, tile_size, history, threshold)
+    _check(lib.nn_screen_cache_create(ctypes.byref(options), ctypes.byref(handle)), "screen_cache_create")
+    return ScreenCache(lib, handle)
+
+
+# =================================================
+# Telemetry ring
+# =================================================
+
+# Source/type names <-> the 16-bit ids stored in records
+_names = {
+    "unknown": NN_SOURCE_UNKNOWN,
+    "parser": NN_SOURCE_PARSER,
+    "keyboard": NN_SOURCE_KEYBOARD,
+    "mouse": NN_SOURCE_MOUSE,
+    "hook": NN_SOURCE_HOOK,
+    "native": NN_SOURCE_NATIVE,
+}
+# Action types share ids with the native records (NN_TYPE_OP + NN_OP_*)
+_names.update({
+    name: NN_TYPE_OP + code
+    for name, code in (
+        ("TYPE", NN_OP_TYPE), ("PRESS", NN_OP_PRESS), ("HOLD", NN_OP_HOLD),
+        ("RELEASE", NN_OP_RELEASE), ("SHORTCUT", NN_OP_SHORTCUT), ("MOVE", NN_OP_MOVE),
+        ("MOVE_N", NN_OP_MOVE_N), ("CLICK", NN_OP_CLICK), ("CLICK_N", NN_OP_CLICK_N),
+        ("CLICK_IMAGE", NN_OP_CLICK_IMAGE), ("PATH", NN_OP_PATH), ("WAIT", NN_OP_WAIT),
+    )
+})
+_ids = {v: k for k, v in _names.items()}
+_next_id = NN_SOURCE_USER
+_intern_lock = threading.Lock()
+
+
+def intern(name: str) -> int:
+    global _next_id
+
+    id_ = _names.get(name)
+    if id_ is not None:
+        return id_
+    with _intern_lock:
+        id_ = _names.get(name)
+        if id_ is None:
+            if _next_id > 0xFFFF:
+                return NN_SOURCE_UNKNOWN
+            id_ = _next_id
+            _next_id += 1
+            _names[name] = id_
+            _ids[id_] = name
+            if _lib is not None:
+                # So history log segments read back without this process
+                _lib.nn_history_name(id_, name.encode())
+        return id_
+
+
+def name_of(id_: int) -> str:
+    return _ids.get(id_, str(id_))
+
+
+def backend() -> Optional[str]:
+    """
+    Platform backend family the library was built for ("win32", "x11",
+    "uinput" or "null"); None when the library is not loaded.
+    """
+    lib = load()
+    return lib.nn_backend_name(lib.nn_backend()).decode() if lib is not None else None
+
+
+def clock_ns() -> int:
+    return _lib.nn_clock_ns()
+
+
+class TelemetryRing:
+    """
+    Native fixed-capacity ring of Records (lock-free, overwrite-oldest).
+
+    With `channel` (NN_CHANNEL_*) this wraps the process-wide ring for
+    that channel, which the native input hook and the Rust app share.
+    """
+
+    def __init__(self, lib, capacity: int, channel: Optional[int] = None):
+        self._lib = lib
+        self._handle = ctypes.c_void_p()
+        if channel is None:
+            _check(lib.nn_telemetry_create(capacity, ctypes.byref(self._handle)), "telemetry_create")
+        else:
+            self._handle = ctypes.c_void_p(lib.nn_telemetry_channel(channel, capacity))
+            if not self._handle:
+                raise NativeError(NN_ERR_INVALID_ARGUMENT, "telemetry_channel")
+
+        self.capacity = lib.nn_telemetry_capacity(self._handle)
+        self._scratch = (Record * self.capacity)()
+        self._scratch_lock = threading.Lock()
+
+    @property
+    def head(self) -> int:
+        return self._lib.nn_telemetry_head(self._handle)
+
+    def push(self, source: int, type_: int, x: int = 0, y: int = 0,
+             arg: int = 0, value: float = 0.0) -> int:
+        return self._lib.nn_telemetry_push_event(self._handle, source, type_, x, y, arg, value)
+
+    def snapshot(self, since: int = 0, limit: Optional[int] = None):
+        """
+        Bulk-copies the newest records (sequence > since) into a new ctypes
+        array, oldest first.
+        """
+        limit = min(limit or self.capacity, self.capacity)
+        with self._scratch_lock:
+            count = self._lib.nn_telemetry_snapshot(self._handle, since, self._scratch, limit)
+            out = (Record * count)()
+            ctypes.memmove(out, self._scratch, ctypes.sizeof(Record) * count)
+        return out
+
+    def clear(self):
+        self._lib.nn_telemetry_clear(self._handle)
+
+    def __del__(self):
+        if self._handle:
+            self._lib.nn_telemetry_destroy(self._handle)
+            self._handle = ctypes.c_void_p()
+
+
+def open_telemetry(capacity: int, channel: Optional[int] = None) -> Optional[TelemetryRing]:
+    lib = load()
+    return TelemetryRing(lib, capacity, channel) if lib is not None else None
+
+
+# ------------------------
+# Input hook
+# ------------------------
+
+def start_mouse_hook(ring: TelemetryRing, min_interval_us: int = 0, poll_hz: int = 0) -> bool:
+    """
+    Starts the native mouse hook feeding `ring`. Returns False when the
+    platform has no hook backend (or it is already running elsewhere).
+    """
+    options = MouseHookOptions(min_interval_us, poll_hz)
+    status = ring._lib.nn_mouse_hook_start(ring._handle, ctypes.byref(options))
+    if status in (NN_ERR_UNAVAILABLE, NN_ERR_BUSY, NN_ERR_FAILED):
+        return False
+    _check(status, "mouse_hook_start")
+    return True
+
+
+def stop_mouse_hook():
+    if _lib is not None:
+        _lib.nn_mouse_hook_stop()
+
+
+def mouse_hook_position():
+    """
+    (x, y, timestamp_ns) of the latest hooked pointer event, or None.
+    """
+    if _lib is None:
+        return None
+    x, y, ts = ctypes.c_int32(), ctypes.c_int32(), ctypes.c_uint64()
+    if _lib.nn_mouse_hook_position(ctypes.byref(x), ctypes.byref(y), ctypes.byref(ts)) != NN_OK:
+        return None
+    return x.value, y.value, ts.value
+
+
+# =================================================
+# History log
+# =================================================
+
+def start_history(path: str, segment_records: int = 0, keep_segments: int = 0,
+                  rotate_seconds: int = 0) -> bool:
+    """
+    Starts appending every record of the shared channels to the memory-
+    mapped log at `path` (rotated to path.1, path.2, ...). Returns False
+    without neuro_native.
+    """
+    lib = load()
+    if lib is None:
+        return False
+    options = HistoryOptions(segment_records, keep_segments, rotate_seconds, 0)
+    _check(lib.nn_history_start(os.fsencode(path), ctypes.byref(options)), "history_start")
+    # Names interned before the library was loaded
+    for name, id_ in list(_names.items()):
+        if id_ >= NN_SOURCE_USER:
+            lib.nn_history_name(id_, name.encode())
+    return True
+
+
+def stop_history():
+    if _lib is not None:
+        _lib.nn_history_stop()
+
+
+def flush_history():
+    if _lib is not None:
+        _lib.nn_history_flush()
+
+
+def rotate_history():
+    if _lib is not None:
+        _check(_lib.nn_history_rotate(), "history_rotate")
+
+
+class HistoryFile:
+    """
+    One history segment mapped read-only (the live one or a rotated one,
+    from this run or an earlier one). records() and range() return
+    ctypes Record arrays over the mapping itself, no copy; they keep the
+    file open while referenced (an explicit close() invalidates them). In
+    them timestamp_ns is Unix-epoch ns and `reserved` the NN_CHANNEL_*
+    (NN_HISTORY_NAMES for name records).
+    """
+
+    def __init__(self, lib, path: str):
+        self._lib = lib
+        self._handle = ctypes.c_void_p()
+        _check(lib.nn_history_open(os.fsencode(path), ctypes.byref(self._handle)), "history_open")
+
+    def _view(self, count: int, first: ctypes.c_void_p):
+        if not count:
+            return (Record * 0)()
+        view = (Record * count).from_address(first.value)
+        view._file = self  # the mapping lives as long as the view
+        return view
+
+    def records(self):
+        first = ctypes.c_void_p()
+        return self._view(self._lib.nn_history_records(self._handle, ctypes.byref(first)), first)
+
+    def range(self, start: float, end: float):
+        """
+        Records with start <= time < end, in time.time() seconds.
+        """
+        first = ctypes.c_void_p()
+        count = self._lib.nn_history_range(
+            self._handle, int(max(start, 0) * 1e9), int(max(end, 0) * 1e9), ctypes.byref(first),
+        )
+        return self._view(count, first)
+
+    def name_of(self, id_: int) -> str:
+        name = self._lib.nn_history_name_of(self._handle, id_)
+        return name.decode(errors="replace") if name is not None else str(id_)
+
+    def close(self):
+        if self._handle:
+            self._lib.nn_history_close(self._handle)
+            self._handle = ctypes.c_void_p()
+
+    def __del__(self):
+        self.close()
+
+
+def open_history(path: str) -> Optional[HistoryFile]:
+    lib = load()
+    return HistoryFile(lib, path) if lib is not None else None
+
+
+# =================================================
+# Action scripts
+# =================================================
+
+class ScriptSyntaxError(NativeError):
+    def __init__(self, line: int, message: str):
+        self.status = NN_ERR_SYNTAX
+        self.line = line
+        self.message = message
+        Exception.__init__(self, f"line {line}: {message}")
+
+
+class Script:
+    """
+    A compiled action script (shared with the native cache).
+    """
+
+    def __init__(self, lib, handle: ctypes.c_void_p):
+        self._lib = lib
+        self._handle = handle
+        self.hash = lib.nn_script_hash(handle)
+
+        count = ctypes.c_size_t()
+        ops = lib.nn_script_ops(handle, ctypes.byref(count))
+        self.ops = ops[: count.value] if count.value else []
+
+    def string(self, index: int) -> str:
+        length = ctypes.c_uint32()
+        address = self._lib.nn_script_string(self._handle, index, ctypes.byref(length))
+        return ctypes.string_at(address, length.value).decode("utf-8", "surrogateescape")
+
+    def points(self, index: int, count: int) -> List[tuple]:
+        if not count:
+            return []
+        base = self._lib.nn_script_points(self._handle, index)
+        return [(base[i].x, base[i].y) for i in range(count)]
+
+    def run(self, host: ScriptHost) -> int:
+        """
+        Interprets the ops against `host`; returns the first non-NN_OK
+        status a callback (or the interpreter) reported.
+        """
+        return self._lib.nn_script_run(self._handle, ctypes.byref(host))
+
+    def __del__(self):
+        if self._handle:
+            self._lib.nn_script_free(self._handle)
+            self._handle = ctypes.c_void_p()
+
+
+def compile_script(text: str) -> Optional[Script]:
+    """
+    Compiles (or fetches from the native cache) `text`. Returns None
+    without the native library; raises ScriptSyntaxError on bad input.
+    """
+    lib = load()
+    if lib is None:
+        return None
+
+    data = text.encode("utf-8", "surrogateescape")
+    handle = ctypes.c_void_p()
+    error = ScriptError()
+    status = lib.nn_script_compile(data, len(data), ctypes.byref(handle), ctypes.byref(error))
+    if status == NN_ERR_SYNTAX:
+        raise ScriptSyntaxError(error.line, error.message.decode("utf-8", "replace"))
+    _check(status, "script_compile")
+    return Script(lib, handle)
+
+
+def script_cache_stats():
+    """
+    (hits, misses, entries) of the native compiled-script cache.
+    """
+    if _lib is None:
+        return 0, 0, 0
+    hits, misses, entries = ctypes.c_uint64(), ctypes.c_uint64(), ctypes.c_uint32()
+    _lib.nn_script_cache_stats(ctypes.byref(hits), ctypes.byref(misses), ctypes.byref(entries))
+    return hits.value, misses.value, entries.value
+
+
+def execute_script(text: str, stream: bool = False) -> bool:
+    """
+    Compiles and injects `text` entirely natively (no controller queues).
+    With `stream`, compiling is pipelined with injection: input starts
+    before the script is fully parsed, and a ScriptSyntaxError comes
+    after the lines before it have run. Returns False when there is no
+    injection backend.
+    """
+    lib = load()
+    if lib is None or lib.nn_input_open() != NN_OK:
+        return False
+
+    data = text.encode("utf-8", "surrogateescape")
+    error = ScriptError()
+    run = lib.nn_script_stream if stream else lib.nn_script_execute
+    status = run(data, len(data), ctypes.byref(error))
+    if status == NN_ERR_SYNTAX:
+        raise ScriptSyntaxError(error.line, error.message.decode("utf-8", "replace"))
+    _check(status, "script_execute")
+    return True
+
+
+# =================================================
+# Scheduler
+# =================================================
+
+def sleep(seconds: float):
+    """
+    Waits `seconds` on this thread's native deadline timeline (measured
+    from the previous deadline, high-resolution timer + spin), or
+    time.sleep() without the native library.
+    """
+    if not math.isfinite(seconds) or seconds < 0:
+        raise ValueError(f"sleep length must be a non-negative finite number: {seconds}")
+    lib = load()
+    if lib is None:
+        if seconds > 0:
+            time.sleep(seconds)
+        return
+    lib.nn_schedule_wait(seconds)
+
+
+def schedule_stats() -> Optional[dict]:
+    """
+    Wake jitter of every native wait since the last reset (ns), or None.
+    """
+    if _lib is None:
+        return None
+    stats = ScheduleStats()
+    _lib.nn_schedule_stats_get(ctypes.byref(stats))
+    return {name: getattr(stats, name) for name, _ in ScheduleStats._fields_}
+
+
+def reset_schedule_stats():
+    if _lib is not None:
+        _lib.nn_schedule_stats_reset()
+
+
+# =================================================
+# Metrics
+# =================================================
+
+def record_metric(metric: int, value: int):
+    """One value into an NN_METRIC_* histogram (a depth, a size, ...)."""
+    if _lib is not None:
+        _lib.nn_metrics_record(metric, value)
+
+
+class metric_span:
+    """
+    Times a block into an NN_METRIC_* histogram (a trace span too while
+    tracing):
+
+        with native.metric_span(native.NN_METRIC_USER):
+            ...
+    """
+
+    def __init__(self, metric: int):
+        self.metric = metric
+        self.start = 0
+
+    def __enter__(self):
+        if _lib is not None:
+            self.start = _lib.nn_clock_ns()
+        return self
+
+    def __exit__(self, *exc):
+        if _lib is not None:
+            _lib.nn_metrics_span(self.metric, self.start, _lib.nn_clock_ns())
+        return False
+
+
+def metrics() -> Optional[Dict[str, dict]]:
+    """
+    Every metric with records since the last reset, by name: count, sum,
+    min, max and p50/p90/p99/p999 (ns for timings). None without the
+    library.
+    """
+    if _lib is None:
+        return None
+    out = {}
+    stats = MetricStats()
+    for metric in range(NN_METRIC_COUNT):
+        name = _lib.nn_metrics_name(metric)
+        if name is None or _lib.nn_metrics_get(metric, ctypes.byref(stats)) != NN_OK or not stats.count:
+            continue
+        out[name.decode()] = {field: getattr(stats, field) for field, _ in MetricStats._fields_}
+    return out
+
+
+def reset_metrics():
+    if _lib is not None:
+        _lib.nn_metrics_reset()
+
+
+def start_trace(capacity: int = 0) -> bool:
+    """
+    Starts the native trace stream (newest `capacity` events kept, 0 =
+    65536). False without the library.
+    """
+    if _lib is None:
+        return False
+    _check(_lib.nn_trace_start(capacity), "trace_start")
+    return True
+
+
+def stop_trace():
+    if _lib is not None:
+        _lib.nn_trace_stop()
+
+
+def write_trace(path: str) -> bool:
+    """Writes the trace as Chrome trace JSON (chrome://tracing, Perfetto)."""
+    if _lib is None:
+        return False
+    _check(_lib.nn_trace_write(os.fsencode(path)), "trace_write")
+    return True
+
+
+# =================================================
+# Input injection
+# =================================================
+
+# pyautogui.moveTo() only tweens above this; shorter moves jump.
+_MIN_TWEEN_SECONDS = 0.1
+
+_BUTTONS = {
+    "left": NN_BUTTON_LEFT, "primary": NN_BUTTON_LEFT,
+    "middle": NN_BUTTON_MIDDLE,
+    "right": NN_BUTTON_RIGHT, "secondary": NN_BUTTON_RIGHT,
+}
+
+
+def _points(points):
+    if isinstance(points, PointPath):
+        return points.buffer()  # already packed, no copy
+    array = (Point * len(points))()
+    for i, (x, y) in enumerate(points):
+        array[i].x = x
+        array[i].y = y
+    return array
+
+
+class InputBatch:
+    """
+    Native injection batch. Everything added is resolved up front and
+    injected in order by send(): one SendInput call / one XFlush for the
+    whole run, however many keys it holds.
+
+    Nothing in a batch sleeps. wait(), tweened moves, paced paths and
+    paced text send what is pending first and then run timed, so they
+    are the boundaries between batches.
+    """
+
+    def __init__(self, lib, handle: ctypes.c_void_p):
+        self._lib = lib
+        self._handle = handle
+
+    def __len__(self) -> int:
+        return self._lib.nn_input_batch_size(self._handle)
+
+    def key(self, key: str, action: int = NN_KEY_TAP):
+        _check(self._lib.nn_input_batch_key(self._handle, key.encode("utf-8"), action), "batch_key")
+
+    def hotkey(self, *keys: str):
+        array = (ctypes.c_char_p * len(keys))(*(k.encode("utf-8") for k in keys))
+        _check(self._lib.nn_input_batch_hotkey(self._handle, array, len(keys)), "batch_hotkey")
+
+    def type(self, text: str, interval: float = 0.0):
+        data = text.encode("utf-8", "surrogateescape")
+        if interval <= 0:
+            _check(self._lib.nn_input_batch_type(self._handle, data, len(data)), "batch_type")
+            return
+        self.send()
+        _check(self._lib.nn_input_type(data, len(data), interval), "input_type")
+
+    def move(self, x: int, y: int, duration: float = 0.0):
+        if duration <= _MIN_TWEEN_SECONDS:
+            _check(self._lib.nn_input_batch_move(self._handle, x, y), "batch_move")
+            return
+        self.send()
+        _check(self._lib.nn_input_move(x, y, duration), "input_move")
+
+    def click(self, x: int, y: int, button: str = "left"):
+        code = _BUTTONS.get(button, 0)
+        _check(self._lib.nn_input_batch_click(self._handle, x, y, code), "batch_click")
+
+    def path(self, points, step_duration: float = 0.0):
+        array = _points(points)
+        if step_duration <= 0:
+            _check(self._lib.nn_input_batch_path(self._handle, array, len(points)), "batch_path")
+            return
+        self.send()
+        _check(self._lib.nn_input_path(array, len(points), step_duration), "input_path")
+
+    def wait(self, seconds: float):
+        self.send()
+        self._lib.nn_schedule_wait(seconds)
+
+    def send(self):
+        _check(self._lib.nn_input_batch_send(self._handle), "batch_send")
+
+    def clear(self):
+        self._lib.nn_input_batch_clear(self._handle)
+
+    def __del__(self):
+        if self._handle:
+            self._lib.nn_input_batch_free(self._handle)
+            self._handle = ctypes.c_void_p()
+
+
+def set_text_options(unicode: bool = False, paste_threshold: int = 0) -> bool:
+    """
+    How native injection types text, process-wide. unicode sends every
+    character as a Unicode event instead of the layout's keys; unpaced
+    text of at least paste_threshold bytes (0 = never) is pasted through
+    the clipboard, replacing what it held. False without the library.
+    """
+    lib = load()
+    if lib is None:
+        return False
+    options = TextOptions(NN_TEXT_UNICODE if unicode else NN_TEXT_LAYOUT, paste_threshold)
+    _check(lib.nn_input_set_text_options(ctypes.byref(options)), "set_text_options")
+    return True
+
+
+def paste(text: str) -> bool:
+    """
+    Pastes `text` through the clipboard (typed when the clipboard is not
+    available). False without a native injection backend.
+    """
+    lib = load()
+    if lib is None or lib.nn_input_open() != NN_OK:
+        return False
+    data = text.encode("utf-8", "surrogateescape")
+    _check(lib.nn_input_paste(data, len(data)), "input_paste")
+    return True
+
+
+def open_input_batch() -> Optional[InputBatch]:
+    """
+    A new InputBatch, or None when there is no native injection backend
+    (callers then fall back to pyautogui).
+    """
+    lib = load()
+    if lib is None or lib.nn_input_open() != NN_OK:
+        return None
+
+    handle = ctypes.c_void_p()
+    _check(lib.nn_input_batch_create(ctypes.byref(handle)), "batch_create")
+    return InputBatch(lib, handle)
+
+
+class Timeline:
+    """
+    Native merged input timeline. Every call stamps its events at the
+    lane's (NN_LANE_*) current time and advances only that lane, so the
+    keyboard and mouse streams overlap; sync() is the barrier between
+    them. run() executes everything in time order on this thread, with
+    events due together injected as one batch.
+    """
+
+    def __init__(self, lib, handle: ctypes.c_void_p):
+        self._lib = lib
+        self._handle = handle
+
+    def __len__(self) -> int:
+        return self._lib.nn_timeline_size(self._handle)
+
+    @property
+    def duration(self) -> float:
+        return self._lib.nn_timeline_duration_ns(self._handle) / 1e9
+
+    def key(self, lane: int, key: str, action: int = NN_KEY_TAP):
+        _check(self._lib.nn_timeline_key(self._handle, lane, key.encode("utf-8"), action), "timeline_key")
+
+    def hotkey(self, lane: int, *keys: str):
+        array = (ctypes.c_char_p * len(keys))(*(k.encode("utf-8") for k in keys))
+        _check(self._lib.nn_timeline_hotkey(self._handle, lane, array, len(keys)), "timeline_hotkey")
+
+    def type(self, lane: int, text: str, interval: float = 0.0):
+        data = text.encode("utf-8", "surrogateescape")
+        _check(self._lib.nn_timeline_type(self._handle, lane, data, len(data), interval), "timeline_type")
+
+    def move(self, lane: int, x: int, y: int, duration: float = 0.0):
+        _check(self._lib.nn_timeline_move(self._handle, lane, x, y, duration), "timeline_move")
+
+    def click(self, lane: int, x: int, y: int, button: str = "left"):
+        code = _BUTTONS.get(button, 0)
+        _check(self._lib.nn_timeline_click(self._handle, lane, x, y, code), "timeline_click")
+
+    def path(self, lane: int, points, step_duration: float = 0.0):
+        array = _points(points)
+        _check(self._lib.nn_timeline_path(self._handle, lane, array, len(points), step_duration),
+               "timeline_path")
+
+    def wait(self, lane: int, seconds: float):
+        _check(self._lib.nn_timeline_wait(self._handle, lane, seconds), "timeline_wait")
+
+    def sync(self, seconds: float = 0.0):
+        _check(self._lib.nn_timeline_sync(self._handle, seconds), "timeline_sync")
+
+    def run(self):
+        _check(self._lib.nn_timeline_run(self._handle), "timeline_run")
+
+    def clear(self):
+        self._lib.nn_timeline_clear(self._handle)
+
+    def __del__(self):
+        if self._handle:
+            self._lib.nn_timeline_free(self._handle)
+            self._handle = ctypes.c_void_p()
+
+
+def open_timeline() -> Optional[Timeline]:
+    """
+    A new native Timeline, or None without a native injection backend.
+    """
+    lib = load()
+    if lib is None or lib.nn_input_open() != NN_OK:
+        return None
+
+    handle = ctypes.c_void_p()
+    _check(lib.nn_timeline_create(ctypes.byref(handle)), "timeline_create")
+    return Timeline(lib, handle)
+
+
+# =================================================
+# Action queue
+# =================================================
+
+_BUTTON_NAMES = {NN_BUTTON_LEFT: "left", NN_BUTTON_MIDDLE: "middle", NN_BUTTON_RIGHT: "right"}
+
+
+def button_name(code: int) -> str:
+    return _BUTTON_NAMES.get(code, str(code))
+
+
+class ActionQueue:
+    """
+    Native store for the controllers' queued instructions: one fixed-size
+    Action record each, in a contiguous array, with text, key names and
+    points in a bump arena. clear() keeps the memory for the next script,
+    so building a queue allocates nothing once warm.
+
+    Lanes are NN_LANE_*; sync() records are on NN_LANE_COUNT. records()
+    and the payload decoders read what the fallback paths run.
+    """
+
+    def __init__(self, lib, handle: ctypes.c_void_p):
+        self._lib = lib
+        self._handle = handle
+
+    def __len__(self) -> int:
+        return self._lib.nn_action_queue_size(self._handle)
+
+    @property
+    def nbytes(self) -> int:
+        """Payload bytes in use."""
+        return self._lib.nn_action_queue_bytes(self._handle)
+
+    # ------------------------
+    # Building
+    # ------------------------
+
+    def key(self, lane: int, key: str, action: int = NN_KEY_TAP, repeat: int = 1):
+        _check(self._lib.nn_action_queue_key(self._handle, lane, key.encode("utf-8"), action, repeat),
+               "action_key")
+
+    def type(self, lane: int, text: str, interval: float = 0.0):
+        data = text.encode("utf-8", "surrogateescape")
+        _check(self._lib.nn_action_queue_type(self._handle, lane, data, len(data), interval), "action_type")
+
+    def shortcut(self, lane: int, *keys: str):
+        array = (ctypes.c_char_p * len(keys))(*(k.encode("utf-8") for k in keys))
+        _check(self._lib.nn_action_queue_shortcut(self._handle, lane, array, len(keys)), "action_shortcut")
+
+    def move(self, lane: int, x: int, y: int, duration: float = 0.0):
+        _check(self._lib.nn_action_queue_move(self._handle, lane, x, y, duration), "action_move")
+
+    def click(self, lane: int, x: int, y: int, button: str = "left"):
+        code = _BUTTONS.get(button, 0)
+        _check(self._lib.nn_action_queue_click(self._handle, lane, x, y, code), "action_click")
+
+    def path(self, lane: int, points, step_duration: float = 0.0):
+        array = _points(points)
+        _check(self._lib.nn_action_queue_path(self._handle, lane, array, len(points), step_duration),
+               "action_path")
+
+    def wait(self, lane: int, seconds: float):
+        _check(self._lib.nn_action_queue_wait(self._handle, lane, seconds), "action_wait")
+
+    def sync(self, seconds: float = 0.0):
+        _check(self._lib.nn_action_queue_sync(self._handle, seconds), "action_sync")
+
+    # ------------------------
+    # Reading
+    # ------------------------
+
+    def records(self) -> List[Action]:
+        """A copy of every record, in the order added."""
+        count = ctypes.c_size_t()
+        base = self._lib.nn_action_queue_records(self._handle, ctypes.byref(count))
+        if not count.value:
+            return []
+        return list((Action * count.value).from_buffer_copy(
+            ctypes.string_at(base, count.value * ctypes.sizeof(Action))))
+
+    def _payload(self, record: Action) -> int:
+        return self._lib.nn_action_queue_payload(self._handle, record.offset)
+
+    def text(self, record: Action) -> str:
+        """TYPE text, or the key of a PRESS / HOLD / RELEASE."""
+        if not record.count:
+            return ""
+        return ctypes.string_at(self._payload(record), record.count).decode("utf-8", "surrogateescape")
+
+    def keys(self, record: Action) -> Tuple[str, ...]:
+        """SHORTCUT keys."""
+        address = self._payload(record)
+        keys = []
+        for _ in range(record.count):
+            key = ctypes.string_at(address)
+            keys.append(key.decode("utf-8"))
+            address += len(key) + 1
+        return tuple(keys)
+
+    def points(self, record: Action) -> List[Tuple[int, int]]:
+        """PATH points."""
+        if not record.count:
+            return []
+        array = (Point * record.count).from_address(self._payload(record))
+        return [(p.x, p.y) for p in array]
+
+    # ------------------------
+    # Execution
+    # ------------------------
+
+    def schedule(self, timeline: Timeline):
+        """Adds every record to `timeline` (not run)."""
+        _check(self._lib.nn_action_queue_schedule(self._handle, timeline._handle), "action_schedule")
+
+    def execute(self, lane: int, batch: InputBatch):
+        """Injects one lane's records through `batch`, as the controllers do."""
+        _check(self._lib.nn_action_queue_execute(self._handle, lane, batch._handle), "action_execute")
+
+    def drop_lane(self, lane: int):
+        _check(self._lib.nn_action_queue_drop_lane(self._handle, lane), "action_drop_lane")
+
+    def clear(self):
+        self._lib.nn_action_queue_clear(self._handle)
+
+    def __del__(self):
+        if self._handle:
+            self._lib.nn_action_queue_free(self._handle)
+            self._handle = ctypes.c_void_p()
+
+
+def open_action_queue() -> Optional[ActionQueue]:
+    """
+    A new ActionQueue, or None without the native library. It does not
+    need an injection backend: the controllers' fallbacks read it back.
+    """
+    lib = load()
+    if lib is None:
+        return None
+
+    handle = ctypes.c_void_p()
+    _check(lib.nn_action_queue_create(ctypes.byref(handle)), "action_queue_create")
+    return ActionQueue(lib, handle)
+
+
+# =================================================
+# Path generation
+# =================================================
+
+class PointPath:
+    """
+    Mouse stroke generated natively into a packed point buffer.
+
+    Behaves as a read-only sequence of (x, y) tuples, and InputBatch /
+    Timeline take it without copying. Lines and curves are subdivided so
+    points are at most `spacing` px apart (velocity * step_seconds when
+    both are given); segments added back to back share their joint.
+    """
+
+    def __init__(self, lib, handle: ctypes.c_void_p):
+        self._lib = lib
+        self._handle = handle
+
+    def __len__(self) -> int:
+        count = ctypes.c_size_t()
+        self._lib.nn_path_points(self._handle, ctypes.byref(count))
+        return count.value
+
+    def __getitem__(self, index: int):
+        count = ctypes.c_size_t()
+        base = self._lib.nn_path_points(self._handle, ctypes.byref(count))
+        if index < 0:
+            index += count.value
+        if not 0 <= index < count.value:
+            raise IndexError("path index out of range")
+        return base[index].x, base[index].y
+
+    def __iter__(self):
+        count = ctypes.c_size_t()
+        base = self._lib.nn_path_points(self._handle, ctypes.byref(count))
+        for i in range(count.value):
+            yield base[i].x, base[i].y
+
+    def buffer(self):
+        """Pointer to the packed points; valid until the path changes."""
+        return self._lib.nn_path_points(self._handle, None)
+
+    def line_steps(self, start, end, steps: int):
+        """MouseController.draw_line(): exactly steps + 1 points."""
+        _check(self._lib.nn_path_line_steps(self._handle, Point(*start), Point(*end), steps), "path_line_steps")
+
+    def line(self, start, end):
+        _check(self._lib.nn_path_line(self._handle, Point(*start), Point(*end)), "path_line")
+
+    def polyline(self, points):
+        _check(self._lib.nn_path_polyline(self._handle, _points(points), len(points)), "path_polyline")
+
+    def bezier(self, control):
+        """3 control points = quadratic, 4 = cubic."""
+        _check(self._lib.nn_path_bezier(self._handle, _points(control), len(control)), "path_bezier")
+
+    def catmull_rom(self, points):
+        _check(self._lib.nn_path_catmull_rom(self._handle, _points(points), len(points)), "path_catmull_rom")
+
+    def clamp(self, width: int, height: int):
+        _check(self._lib.nn_path_clamp(self._handle, width, height), "path_clamp")
+
+    def clamp_desktop(self) -> bool:
+        """
+        Moves every point onto its nearest monitor. False (path left
+        alone) when there is no native monitor layout.
+        """
+        return self._lib.nn_path_clamp_desktop(self._handle) == NN_OK
+
+    def clear(self):
+        self._lib.nn_path_clear(self._handle)
+
+    def __del__(self):
+        if self._handle:
+            self._lib.nn_path_free(self._handle)
+            self._handle = ctypes.c_void_p()
+
+
+def open_path(spacing: float = 0.0, velocity: float = 0.0, step_seconds: float = 0.0,
+              tolerance: float = 0.0) -> Optional[PointPath]:
+    """
+    A new, empty PointPath, or None without the native library. Zero
+    options take the engine defaults (10 px spacing, 0.5 px tolerance).
+    """
+    lib = load()
+    if lib is None:
+        return None
+
+    options = PathOptions(spacing, velocity, step_seconds, tolerance)
+    handle = ctypes.c_void_p()
+    _check(lib.nn_path_create(ctypes.byref(options), ctypes.byref(handle)), "path_create")
+    return PointPath(lib, handle)
+
+
+# =================================================
+# Window state
+# =================================================
+
+class WindowState:
+    """
+    One immutable snapshot of the native window cache: the visible
+    top-level windows in OS order, as (id, pid, title) tuples, and the
+    index of the active one (None when it isn't listed).
+    """
+
+    def __init__(self, version: int, windows: List[tuple], active: Optional[int]):
+        self.version = version
+        self.windows = windows
+        self.active = active
+
+    @property
+    def titles(self) -> List[str]:
+        return [title for _, _, title in self.windows]
+
+    @property
+    def active_title(self) -> Optional[str]:
+        return self.windows[self.active][2] if self.active is not None else None
+
+
+def start_window_cache() -> bool:
+    """
+    Starts the native window cache (idempotent). False when it cannot
+    run here; callers then enumerate windows themselves.
+    """
+    lib = load()
+    if lib is None:
+        return False
+    status = lib.nn_window_cache_start()
+    return status in (NN_OK, NN_ERR_BUSY)
+
+
+def stop_window_cache():
+    lib = load()
+    if lib is not None:
+        lib.nn_window_cache_stop()
+
+
+def window_cache_version() -> int:
+    """Changes whenever the window state does; 0 when not running."""
+    lib = load()
+    return lib.nn_window_cache_version() if lib is not None else 0
+
+
+def window_state() -> Optional[WindowState]:
+    lib = load()
+    if lib is None:
+        return None
+
+    handle = ctypes.c_void_p()
+    if lib.nn_window_snapshot_get(ctypes.byref(handle)) != NN_OK:
+        return None
+    try:
+        info = WindowInfo()
+        windows = []
+        for i in range(lib.nn_window_snapshot_count(handle)):
+            lib.nn_window_snapshot_window(handle, i, ctypes.byref(info))
+            title = ctypes.string_at(info.title, info.title_len).decode("utf-8", "replace")
+            windows.append((info.id, info.pid, title))
+        active = lib.nn_window_snapshot_active(handle)
+        return WindowState(lib.nn_window_snapshot_version(handle), windows, active if active >= 0 else None)
+    finally:
+        lib.nn_window_snapshot_free(handle)
+
+
+# =================================================
+# Accessibility tree
+# =================================================
+
+def start_ui_tree() -> bool:
+    """
+    Starts the native accessibility tree of the foreground window
+    (idempotent). False when there is no accessibility backend here.
+    """
+    lib = load()
+    if lib is None:
+        return False
+    status = lib.nn_ui_tree_start()
+    return status in (NN_OK, NN_ERR_BUSY)
+
+
+def stop_ui_tree():
+    lib = load()
+    if lib is not None:
+        lib.nn_ui_tree_stop()
+
+
+def ui_tree_version() -> int:
+    """Changes whenever the tree does; 0 when not running."""
+    lib = load()
+    return lib.nn_ui_tree_version() if lib is not None else 0
+
+
+def ui_text(capacity: int = 4096) -> Optional[str]:
+    """
+    Compact text form of the current tree (one line per element, indented
+    by depth), at most `capacity` bytes. None when the tree isn't running.
+    """
+    lib = load()
+    if lib is None:
+        return None
+
+    handle = ctypes.c_void_p()
+    if lib.nn_ui_snapshot_get(ctypes.byref(handle)) != NN_OK:
+        return None
+    try:
+        buffer = ctypes.create_string_buffer(capacity + 1)
+        length = ctypes.c_size_t()
+        lib.nn_ui_snapshot_text(handle, buffer, len(buffer), ctypes.byref(length))
+        return buffer.raw[:length.value].decode("utf-8", "replace")
+    finally:
+        lib.nn_ui_snapshot_free(handle)
+
+
+def ui_elements() -> Optional[List[dict]]:
+    """
+    Every element of the current tree in pre-order (element 0 is the
+    window), as dicts with id, parent, depth, role, states, bounds, name
+    and value. None when the tree isn't running.
+    """
+    lib = load()
+    if lib is None:
+        return None
+
+    handle = ctypes.c_void_p()
+    if lib.nn_ui_snapshot_get(ctypes.byref(handle)) != NN_OK:
+        return None
+    try:
+        element = UiElement()
+        elements = []
+        for i in range(lib.nn_ui_snapshot_count(handle)):
+            lib.nn_ui_snapshot_element(handle, i, ctypes.byref(element))
+            bounds = element.bounds
+            elements.append({
+                "id": element.id,
+                "parent": element.parent,
+                "depth": element.depth,
+                "role": lib.nn_ui_role_name(element.role).decode(),
+                "states": element.states,
+                "bounds": (bounds.x, bounds.y, bounds.width, bounds.height),
+                "name": ctypes.string_at(element.name, element.name_len).decode("utf-8", "replace"),
+                "value": ctypes.string_at(element.value, element.value_len).decode("utf-8", "replace"),
+            })
+        return elements
+    finally:
+        lib.nn_ui_snapshot_free(handle)
+
+
+# =================================================
+# Process tracking
+# =================================================
+
+class ProcessTracker:
+    """
+    Incremental native process table. refresh() returns only what changed
+    since the previous refresh, as (pid, name) lists; names are mirrored
+    from the native interning table as new ones appear, so each is decoded
+    once per tracker.
+    """
+
+    def __init__(self, lib, handle: ctypes.c_void_p):
+        self._lib = lib
+        self._handle = handle
+        self._names: List[str] = []
+
+    def _sync_names(self):
+        lib, names = self._lib, self._names
+        length = ctypes.c_uint32()
+        for name_id in range(len(names), lib.nn_process_name_count(self._handle)):
+            text = lib.nn_process_name(self._handle, name_id, ctypes.byref(length))
+            names.append(ctypes.string_at(text, length.value).decode("utf-8", "replace"))
+
+    def _deltas(self, fetch) -> List[tuple]:
+        count = ctypes.c_size_t()
+        deltas = fetch(self._handle, ctypes.byref(count))
+        names = self._names
+        return [(deltas[i].pid, names[deltas[i].name_id]) for i in range(count.value)]
+
+    def refresh(self):
+        """
+        (added, removed) since the previous refresh. Apply the removals
+        first: a recycled pid shows up in both.
+        """
+        _check(self._lib.nn_process_tracker_refresh(self._handle), "process_tracker_refresh")
+        self._sync_names()
+        return (
+            self._deltas(self._lib.nn_process_tracker_added),
+            self._deltas(self._lib.nn_process_tracker_removed),
+        )
+
+    def processes(self) -> List[tuple]:
+        """Every process as of the last refresh, as (pid, name), unordered."""
+        lib = self._lib
+        size = lib.nn_process_tracker_size(self._handle)
+        out = (ProcessDelta * size)()
+        size = min(size, lib.nn_process_tracker_list(self._handle, out, size))
+        names = self._names
+        return [(out[i].pid, names[out[i].name_id]) for i in range(size)]
+
+    def __del__(self):
+        if self._handle:
+            self._lib.nn_process_tracker_free(self._handle)
+            self._handle = None
+
+
+def open_process_tracker() -> Optional[ProcessTracker]:
+    """
+    A tracker that has already taken its first snapshot (so processes()
+    is populated and the next refresh() reports changes), or None without
+    a native process backend.
+    """
+    lib = load()
+    if lib is None:
+        return None
+
+    handle = ctypes.c_void_p()
+    _check(lib.nn_process_tracker_create(ctypes.byref(handle)), "process_tracker_create")
+    tracker = ProcessTracker(lib, handle)
+    if lib.nn_process_tracker_refresh(handle) != NN_OK:
+        return None
+    tracker._sync_names()
+    return tracker
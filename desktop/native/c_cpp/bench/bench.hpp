@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "clock.hpp"
+
+namespace neuro::bench {
+
+// Events / sends that reached the no-op injection sink (input_sink.cpp).
+extern std::atomic<uint64_t> sink_events;
+extern std::atomic<uint64_t> sink_sends;
+
+// -------------------------------------------------
+// Per-iteration latency
+//
+// Google Benchmark reports the mean time per iteration; regressions in
+// the tail hide in that. Each iteration timed through a Sample is kept,
+// and p50 / p99 / p999 (microseconds) come out as counters once the
+// loop ends. Multi-threaded runs keep one Latency per thread and report
+// the average of the threads' percentiles. Samples include one clock
+// read (~20 ns), which only matters for the smallest operations.
+// -------------------------------------------------
+
+class Latency {
+public:
+    explicit Latency(benchmark::State& state) : state_(state) {
+        samples_.reserve(1 << 16);
+    }
+
+    ~Latency() { report(); }
+
+    Latency(const Latency&) = delete;
+    Latency& operator=(const Latency&) = delete;
+
+    class Sample {
+    public:
+        explicit Sample(Latency& latency) : latency_(latency), start_(monotonic_ns()) {}
+        ~Sample() { latency_.samples_.push_back(monotonic_ns() - start_); }
+
+    private:
+        Latency& latency_;
+        uint64_t start_;
+    };
+
+private:
+    void report() {
+        if (samples_.empty()) {
+            return;
+        }
+        std::sort(samples_.begin(), samples_.end());
+        auto at = [&](double q) {
+            size_t index = std::min(samples_.size() - 1, static_cast<size_t>(q * samples_.size()));
+            return benchmark::Counter(samples_[index] / 1e3, benchmark::Counter::kAvgThreads);
+        };
+        state_.counters["p50_us"]  = at(0.50);
+        state_.counters["p99_us"]  = at(0.99);
+        state_.counters["p999_us"] = at(0.999);
+    }
+
+    benchmark::State&     state_;
+    std::vector<uint64_t> samples_;
+};
+
+} // namespace neuro::bench
@@ -0,0 +1,156 @@
+// Frames: capture, pixel conversion, still encoding and the encoder
+// pipeline end to end. Everything past capture runs on a synthetic
+// 1080p BGRA frame, so it works without a display.
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "bench.hpp"
+
+#include "capture.hpp"
+#include "codec.hpp"
+#include "encoder.hpp"
+#include "kernels.hpp"
+
+namespace neuro::bench {
+
+static constexpr int32_t kWidth  = 1920;
+static constexpr int32_t kHeight = 1080;
+
+// Gradients plus a little noise: compresses like a desktop, not like a
+// flat colour.
+static const std::vector<uint8_t>& desktop_pixels() {
+    static const std::vector<uint8_t> pixels = [] {
+        std::vector<uint8_t> out(static_cast<size_t>(kWidth) * kHeight * 4);
+        uint32_t noise = 12345;
+        for (int32_t y = 0; y < kHeight; ++y) {
+            for (int32_t x = 0; x < kWidth; ++x) {
+                noise = noise * 1664525u + 1013904223u;
+                uint8_t* p = &out[(static_cast<size_t>(y) * kWidth + x) * 4];
+                p[0] = static_cast<uint8_t>(x / 8 + (noise >> 29));
+                p[1] = static_cast<uint8_t>(y / 4);
+                p[2] = static_cast<uint8_t>(((x / 64) ^ (y / 64)) * 40);
+                p[3] = 255;
+            }
+        }
+        return out;
+    }();
+    return pixels;
+}
+
+static ImageView desktop_view() {
+    return ImageView{desktop_pixels().data(), kWidth, kHeight, kWidth * 4};
+}
+
+static void BM_CaptureGrab(benchmark::State& state) {
+    std::unique_ptr<CaptureSession> session;
+    if (CaptureSession::open(CaptureOptions{}, session) != Status::Ok) {
+        state.SkipWithError("screen capture unavailable");
+        return;
+    }
+    Latency latency(state);
+
+    for (auto _ : state) {
+        Frame frame;
+        {
+            Latency::Sample sample(latency);
+            if (session->grab(1000, frame) != Status::Ok) {
+                state.SkipWithError("grab failed");
+                break;
+            }
+        }
+        session->release(frame.slot);
+    }
+}
+BENCHMARK(BM_CaptureGrab)->UseRealTime();
+
+static void BM_ConvertRgb(benchmark::State& state) {
+    ImageView image = desktop_view();
+    std::vector<uint8_t> rgb(static_cast<size_t>(kWidth) * kHeight * 3);
+    const KernelTable& table = kernels();
+    Latency latency(state);
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        table.bgra_to_rgb(image.data, image.stride, rgb.data(), kWidth * 3, kWidth, kHeight);
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(table.isa);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kWidth * kHeight * 4);
+}
+BENCHMARK(BM_ConvertRgb);
+
+// 1080p -> 720p, as an encoder with max_width 1280 does.
+static void BM_Downscale(benchmark::State& state) {
+    ImageView image = desktop_view();
+    const int32_t width = 1280, height = 720;
+    std::vector<uint8_t> out(static_cast<size_t>(width) * height * 4);
+    auto filter = static_cast<Filter>(state.range(0));
+    Latency latency(state);
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        downscale(image, out.data(), width, height, width * 4, filter);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_Downscale)->Arg(static_cast<int64_t>(Filter::Box))->Arg(static_cast<int64_t>(Filter::Bilinear));
+
+static void BM_EncodeImage(benchmark::State& state) {
+    auto codec = static_cast<Codec>(state.range(0));
+    if (!codec_available(codec)) {
+        state.SkipWithError("codec not compiled in");
+        return;
+    }
+    ImageView image = desktop_view();
+    ImageEncoder encoder;
+    std::vector<uint8_t> out;
+    Latency latency(state);
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        if (encoder.encode(codec, image, 75, out) != Status::Ok) {
+            state.SkipWithError("encode failed");
+            break;
+        }
+    }
+    state.counters["bytes"] = static_cast<double>(out.size());
+}
+BENCHMARK(BM_EncodeImage)
+    ->Arg(static_cast<int64_t>(Codec::Raw))
+    ->Arg(static_cast<int64_t>(Codec::Jpeg))
+    ->Arg(static_cast<int64_t>(Codec::Webp));
+
+// Submit to packet through the worker threads (downscale + JPEG).
+static void BM_EncoderPipeline(benchmark::State& state) {
+    EncoderOptions options;
+    options.codec     = codec_available(Codec::Jpeg) ? Codec::Jpeg : Codec::Raw;
+    options.max_width = 1280;
+    std::unique_ptr<FrameEncoder> encoder;
+    if (FrameEncoder::create(options, encoder) != Status::Ok) {
+        state.SkipWithError("encoder unavailable");
+        return;
+    }
+    Frame frame;
+    frame.data   = desktop_pixels().data();
+    frame.width  = kWidth;
+    frame.height = kHeight;
+    frame.stride = kWidth * 4;
+    Latency latency(state);
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        Packet packet;
+        ++frame.sequence;
+        if (encoder->submit(nullptr, frame, nullptr, 0) != Status::Ok || encoder->next(packet, -1) != Status::Ok
+            || packet.status != Status::Ok) {
+            state.SkipWithError("pipeline failed");
+            break;
+        }
+        encoder->release(packet.id);
+    }
+}
+BENCHMARK(BM_EncoderPipeline)->UseRealTime();
+
+} // namespace neuro::bench
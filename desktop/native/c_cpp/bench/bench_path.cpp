@@ -0,0 +1,68 @@
+// Path generation: the strokes LINE / PATH and the mouse controller
+// build, into a reused buffer.
+
+#include <vector>
+
+#include "bench.hpp"
+
+#include "path.hpp"
+
+namespace neuro::bench {
+
+static PathOptions options_for(benchmark::State& state) {
+    PathOptions options;
+    options.spacing = static_cast<double>(state.range(0));
+    return options;
+}
+
+static void BM_PathLine(benchmark::State& state) {
+    std::vector<nn_point> points;
+    PathOptions options = options_for(state);
+    Latency latency(state);
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        points.clear();
+        PathBuilder(points, options).line({0, 0}, {1900, 1060});
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.counters["points"] = static_cast<double>(points.size());
+}
+BENCHMARK(BM_PathLine)->Arg(1)->Arg(10);
+
+static void BM_PathBezier(benchmark::State& state) {
+    static const nn_point kControl[] = {{100, 900}, {400, 50}, {1500, 1000}, {1800, 120}};
+    std::vector<nn_point> points;
+    PathOptions options = options_for(state);
+    Latency latency(state);
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        points.clear();
+        PathBuilder(points, options).bezier(kControl, std::size(kControl));
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.counters["points"] = static_cast<double>(points.size());
+}
+BENCHMARK(BM_PathBezier)->Arg(1)->Arg(10);
+
+static void BM_PathCatmullRom(benchmark::State& state) {
+    std::vector<nn_point> knots;
+    for (int32_t i = 0; i < 32; ++i) {
+        knots.push_back({60 * i, 540 + ((i % 2) ? 300 : -300)});
+    }
+    std::vector<nn_point> points;
+    PathOptions options = options_for(state);
+    Latency latency(state);
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        points.clear();
+        PathBuilder(points, options).catmull_rom(knots.data(), knots.size());
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.counters["points"] = static_cast<double>(points.size());
+}
+BENCHMARK(BM_PathCatmullRom)->Arg(1)->Arg(10);
+
+} // namespace neuro::bench
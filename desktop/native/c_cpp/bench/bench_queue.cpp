@@ -0,0 +1,109 @@
+// Queue execution into the sink: the controllers' action queue (per
+// device and merged through a timeline) and a script's round trip
+// through the executor thread, submit to completion.
+
+#include <string>
+
+#include "bench.hpp"
+
+#include "action_queue.hpp"
+#include "executor.hpp"
+#include "input.hpp"
+#include "timeline.hpp"
+
+namespace neuro::bench {
+
+static constexpr uint32_t kKeyboard = 0;
+static constexpr uint32_t kMouse    = 1;
+
+// `count` rounds of typing, keys, clicks and a short unpaced stroke,
+// alternating between the two lanes behind syncs.
+static void fill(ActionQueue& queue, int64_t count) {
+    static const nn_point kStroke[] = {{10, 10}, {40, 20}, {80, 45}, {120, 90}};
+    static const char* const kKeys[] = {"ctrl", "s"};
+    for (int64_t i = 0; i < count; ++i) {
+        queue.type(kKeyboard, "hello from neuro", 0.0);
+        queue.key(kKeyboard, "enter", NN_KEY_TAP, 1);
+        queue.shortcut(kKeyboard, kKeys, 2);
+        queue.sync(0.0);
+        queue.move(kMouse, 640, 360, 0.0);
+        queue.click(kMouse, 640, 360, NN_BUTTON_LEFT);
+        queue.path(kMouse, kStroke, 4, 0.0);
+        queue.sync(0.0);
+    }
+}
+
+static bool open_sink(benchmark::State& state) {
+    if (InputInjector::instance().open() != Status::Ok) {
+        state.SkipWithError("injector unavailable");
+        return false;
+    }
+    return true;
+}
+
+// Build + execute one lane, as KeyboardController.execute() does.
+static void BM_ActionQueueExecute(benchmark::State& state) {
+    if (!open_sink(state)) return;
+    ActionQueue queue;
+    InputBatch batch;
+    Latency latency(state);
+    uint64_t events = sink_events.load();
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        fill(queue, state.range(0));
+        if (queue.execute(kKeyboard, batch) != Status::Ok || queue.execute(kMouse, batch) != Status::Ok) {
+            state.SkipWithError("execute failed");
+            break;
+        }
+        queue.clear();
+    }
+    state.counters["events"] = benchmark::Counter(static_cast<double>(sink_events.load() - events),
+                                                  benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ActionQueueExecute)->Arg(1)->Arg(32);
+
+// Both lanes merged: schedule onto a timeline and run it (nothing is
+// paced, so the run never sleeps).
+static void BM_ActionQueueTimeline(benchmark::State& state) {
+    if (!open_sink(state)) return;
+    ActionQueue queue;
+    Timeline timeline;
+    Latency latency(state);
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        fill(queue, state.range(0));
+        if (queue.schedule(timeline) != Status::Ok || timeline.run() != Status::Ok) {
+            state.SkipWithError("timeline failed");
+            break;
+        }
+        queue.clear();
+    }
+}
+BENCHMARK(BM_ActionQueueTimeline)->Arg(1)->Arg(32);
+
+// What a run_script action costs past the websocket: queue hop, compile
+// (cached after the first), batched injection, completion hop.
+static void BM_ExecutorRoundTrip(benchmark::State& state) {
+    if (!open_sink(state)) return;
+    const std::string text = "TYPE hello from neuro\nPRESS enter\nMOVE 640 360 0\nCLICK 640 360\n";
+    ExecutorOptions options;
+    ActionExecutor executor(options);
+    Latency latency(state);
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        uint64_t ticket = 0;
+        Completion done;
+        if (executor.submit(ScriptText(text), 1, 0, ticket) != Status::Ok
+            || executor.next(done, -1) != Status::Ok || done.status != Status::Ok) {
+            state.SkipWithError("executor failed");
+            break;
+        }
+    }
+    executor.close();
+}
+BENCHMARK(BM_ExecutorRoundTrip)->UseRealTime();
+
+} // namespace neuro::bench
@@ -0,0 +1,113 @@
+// Controller scripts: parse + compile, cache lookup, and running a
+// compiled program into the sink.
+
+#include <string>
+
+#include "bench.hpp"
+
+#include "input.hpp"
+#include "script.hpp"
+
+namespace neuro::bench {
+
+// `lines` lines of the mix Neuro sends: typing, keys, clicks, strokes.
+// untimed: no waits and no paced moves, so a run never sleeps.
+static std::string make_script(int64_t lines, bool untimed) {
+    static const char* const kTimed[] = {
+        "TYPE hello from neuro\n", "PRESS enter\n", "SHORTCUT ctrl shift t\n", "MOVE 640 360\n",
+        "CLICK 640 360\n",         "LINE 100 100 900 500 STEPS 40\n", "PATH 10 10 300 40 600 400 80 700\n",
+        "WAIT 0.05\n",
+    };
+    static const char* const kUntimed[] = {
+        "TYPE hello from neuro\n", "PRESS enter\n",  "SHORTCUT ctrl shift t\n",
+        "MOVE 640 360 0\n",        "CLICK 640 360\n", "CLICK 10 700 right\n",
+    };
+    std::string text;
+    for (int64_t i = 0; i < lines; ++i) {
+        text += untimed ? kUntimed[i % std::size(kUntimed)] : kTimed[i % std::size(kTimed)];
+    }
+    return text;
+}
+
+static void BM_ScriptCompile(benchmark::State& state) {
+    const std::string text = make_script(state.range(0), false);
+    Latency latency(state);
+    ScriptError error;
+
+    for (auto _ : state) {
+        ProgramPtr program;
+        {
+            Latency::Sample sample(latency);
+            if (compile_script(text, program, error) != Status::Ok) {
+                state.SkipWithError(error.message.c_str());
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(program);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_ScriptCompile)->Arg(1)->Arg(16)->Arg(256);
+
+static void BM_ScriptCacheHit(benchmark::State& state) {
+    const std::string text = make_script(state.range(0), false);
+    Latency latency(state);
+    ScriptError error;
+    ProgramPtr program;
+    ScriptCache::instance().compile(text, program, error);
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        ScriptCache::instance().compile(text, program, error);
+        benchmark::DoNotOptimize(program);
+    }
+}
+BENCHMARK(BM_ScriptCacheHit)->Arg(16)->Arg(256);
+
+// Compiled program through the batched host, one send per run.
+static void BM_ScriptRun(benchmark::State& state) {
+    const std::string text = make_script(state.range(0), true);
+    ProgramPtr program;
+    ScriptError error;
+    if (InputInjector::instance().open() != Status::Ok || compile_script(text, program, error) != Status::Ok) {
+        state.SkipWithError("script setup failed");
+        return;
+    }
+    Latency latency(state);
+    InputBatch batch;
+    nn_script_host host = batched_script_host(batch);
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        if (run_script(*program, host) != Status::Ok || batch.send() != Status::Ok) {
+            state.SkipWithError("run failed");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_ScriptRun)->Arg(16)->Arg(256);
+
+// nn_script_stream: compile pipelined with injection (cached after the
+// first run, like a script Neuro repeats).
+static void BM_ScriptStream(benchmark::State& state) {
+    const std::string text = make_script(state.range(0), true);
+    if (InputInjector::instance().open() != Status::Ok) {
+        state.SkipWithError("injector unavailable");
+        return;
+    }
+    Latency latency(state);
+    InputBatch batch;
+    nn_script_host host = batched_script_host(batch);
+    ScriptError error;
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        if (stream_script(text, host, {}, error) != Status::Ok || batch.send() != Status::Ok) {
+            state.SkipWithError("stream failed");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_ScriptStream)->Arg(16)->Arg(256);
+
+} // namespace neuro::bench
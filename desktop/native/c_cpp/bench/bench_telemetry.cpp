@@ -0,0 +1,68 @@
+// Telemetry ring contention: every producer thread pushing into one
+// ring, with and without a reader snapshotting alongside.
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+
+#include "telemetry.hpp"
+
+namespace neuro::bench {
+
+static TelemetryRing& shared_ring() {
+    static TelemetryRing ring(4096);
+    return ring;
+}
+
+static void BM_TelemetryPush(benchmark::State& state) {
+    TelemetryRing& ring = shared_ring();
+    Record record{};
+    record.timestamp_ns = 1; // skip the clock read inside push
+    Latency latency(state);
+
+    for (auto _ : state) {
+        Latency::Sample sample(latency);
+        benchmark::DoNotOptimize(ring.push(record));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TelemetryPush)->ThreadRange(1, 8)->UseRealTime();
+
+// Producers while one extra thread snapshots the newest records in a
+// loop, as the UI polling a channel does.
+static void BM_TelemetryPushWithReader(benchmark::State& state) {
+    TelemetryRing& ring = shared_ring();
+    std::atomic<bool> stop{false};
+    std::thread reader;
+    if (state.thread_index() == 0) {
+        reader = std::thread([&] {
+            std::vector<Record> out(256);
+            uint64_t since = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                size_t count = ring.snapshot(since, out.data(), out.size());
+                if (count) {
+                    since = out[count - 1].sequence;
+                }
+            }
+        });
+    }
+    Record record{};
+    record.timestamp_ns = 1;
+    {
+        Latency latency(state);
+        for (auto _ : state) {
+            Latency::Sample sample(latency);
+            benchmark::DoNotOptimize(ring.push(record));
+        }
+    }
+    if (reader.joinable()) {
+        stop = true;
+        reader.join();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TelemetryPushWithReader)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace neuro::bench
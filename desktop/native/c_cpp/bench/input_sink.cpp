@@ -0,0 +1,62 @@
+// Injection backend of the benchmark build: resolves everything and
+// drops the events, so a run measures the library and not the OS.
+
+#include "bench.hpp"
+
+#include "input.hpp"
+
+namespace neuro {
+
+namespace bench {
+std::atomic<uint64_t> sink_events{0};
+std::atomic<uint64_t> sink_sends{0};
+} // namespace bench
+
+struct PlatformInput::Impl {};
+
+PlatformInput::PlatformInput() = default;
+PlatformInput::~PlatformInput() = default;
+
+Status PlatformInput::open() {
+    return Status::Ok;
+}
+
+Status PlatformInput::send(const InputEvent*, size_t count) {
+    bench::sink_events.fetch_add(count, std::memory_order_relaxed);
+    bench::sink_sends.fetch_add(1, std::memory_order_relaxed);
+    return Status::Ok;
+}
+
+Status PlatformInput::screen_size(int32_t& width, int32_t& height) {
+    width  = 1920;
+    height = 1080;
+    return Status::Ok;
+}
+
+Status PlatformInput::cursor(int32_t& x, int32_t& y) {
+    x = 0;
+    y = 0;
+    return Status::Ok;
+}
+
+bool PlatformInput::resolve_key(std::string_view name, KeyStroke& out) {
+    out.code  = static_cast<uint32_t>(name.size());
+    out.shift = false;
+    return true;
+}
+
+bool PlatformInput::resolve_char(uint32_t codepoint, KeyStroke& out) {
+    out.code  = codepoint;
+    out.shift = codepoint >= 'A' && codepoint <= 'Z';
+    return true;
+}
+
+bool PlatformInput::supports_unicode() const {
+    return true;
+}
+
+Status PlatformInput::set_clipboard(std::string_view) {
+    return Status::Ok;
+}
+
+} // namespace neuro
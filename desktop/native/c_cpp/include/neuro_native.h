@@ -0,0 +1,1268 @@
+/*
+ * neuro_native - C ABI
+ *
+ * Stable entrypoint shared by the Rust app (linked) and the Python
+ * controller (loaded through ctypes). Everything behind this header is
+ * C++; only plain C types cross the boundary.
+ *
+ * Conventions:
+ *   - every fallible call returns an nn_status (NN_OK == 0, errors < 0)
+ *   - handles are opaque and owned by the caller until the matching *_close or *_free
+ *   - buffers handed out by the library stay valid until released
+ */
+
+#ifndef NEURO_NATIVE_H
+#define NEURO_NATIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(NEURO_NATIVE_EXPORTS)
+#    define NN_API __declspec(dllexport)
+#  else
+#    define NN_API
+#  endif
+#else
+#  define NN_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* =====================================================
+ * Status codes
+ * ===================================================== */
+
+typedef int32_t nn_status;
+
+enum {
+    NN_OK                   =  0,
+    NN_ERR_UNAVAILABLE      = -1, /* backend not compiled in / not supported here */
+    NN_ERR_INVALID_ARGUMENT = -2,
+    NN_ERR_BUSY             = -3, /* every buffer is currently leased */
+    NN_ERR_TIMEOUT          = -4,
+    NN_ERR_FAILED           = -5, /* OS call failed */
+    NN_ERR_SYNTAX           = -6, /* script did not compile (see nn_script_error) */
+    NN_ERR_CANCELLED        = -7, /* superseded, stale or cancelled before it finished */
+};
+
+NN_API const char* nn_status_string(nn_status status);
+
+/* Platform family the library was built for (CMake NEURO_BACKEND) */
+enum {
+    NN_BACKEND_NULL   = 0, /* no OS backend: capture and injection are NN_ERR_UNAVAILABLE */
+    NN_BACKEND_WIN32  = 1,
+    NN_BACKEND_X11    = 2,
+    NN_BACKEND_UINPUT = 3, /* Linux /dev/uinput injection (Wayland, console); no capture */
+};
+
+NN_API uint32_t    nn_backend(void);
+/* "null", "win32", "x11", "uinput"; "unknown" otherwise */
+NN_API const char* nn_backend_name(uint32_t backend);
+
+/* =====================================================
+ * Screen capture
+ * ===================================================== */
+
+typedef struct nn_capture nn_capture;
+
+enum {
+    NN_PIXEL_BGRA = 0, /* 4 bytes per pixel, B G R A/X in memory order */
+};
+
+enum {
+    NN_FRAME_UNCHANGED   = 1u << 0, /* no new frame since the previous grab */
+    NN_FRAME_FULL_DAMAGE = 1u << 1, /* damage grab: treat the whole frame as dirty */
+};
+
+typedef struct nn_rect {
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+} nn_rect;
+
+typedef struct nn_capture_options {
+    int32_t  output;      /* nn_monitor index, 0 = primary */
+    uint32_t ring_slots;  /* preallocated frame buffers, 0 = default (3) */
+} nn_capture_options;
+
+/* A leased frame. `data` points straight into the capture ring and stays
+ * valid until nn_capture_release(session, frame->slot). */
+typedef struct nn_frame {
+    const uint8_t* data;
+    int32_t  width;
+    int32_t  height;
+    int32_t  stride;      /* bytes per row */
+    uint32_t format;      /* NN_PIXEL_* */
+    uint32_t slot;
+    uint32_t flags;       /* NN_FRAME_* */
+    uint64_t sequence;    /* increments with every new frame */
+    uint64_t timestamp_ns;/* monotonic clock */
+} nn_frame;
+
+NN_API nn_status nn_capture_open(const nn_capture_options* options, nn_capture** out);
+NN_API void      nn_capture_close(nn_capture* session);
+
+NN_API nn_status nn_capture_grab(nn_capture* session, uint32_t timeout_ms, nn_frame* out);
+NN_API nn_status nn_capture_release(nn_capture* session, uint32_t slot);
+
+/* Damage-only grab. Leases the frame like nn_capture_grab and writes the
+ * tile_size-aligned regions changed since the previous grab to `rects`
+ * (dirty tiles merged into horizontal runs). Uses the OS dirty/move
+ * rectangles where available and a tile diff otherwise. With
+ * NN_FRAME_UNCHANGED, *rect_count is 0. When the damage does not fit in
+ * max_rects (or on the first grab) one full-frame rect is reported and
+ * NN_FRAME_FULL_DAMAGE is set. */
+NN_API nn_status nn_capture_grab_damage(nn_capture* session, uint32_t timeout_ms,
+                                        uint32_t tile_size, nn_frame* out,
+                                        nn_rect* rects, uint32_t max_rects,
+                                        uint32_t* rect_count);
+
+/* =====================================================
+ * Frame kernels
+ *
+ * Vectorized (AVX2 / SSE4.1 / NEON, scalar fallback) and selected once at
+ * runtime. Sources are nn_frame views, so a leased capture slot can be
+ * processed in place; any BGRA buffer can be wrapped in an nn_frame too.
+ * ===================================================== */
+
+enum {
+    NN_CPU_SSE41 = 1u << 0,
+    NN_CPU_AVX2  = 1u << 1,
+    NN_CPU_NEON  = 1u << 2,
+};
+
+enum {
+    NN_FILTER_BOX      = 0,
+    NN_FILTER_BILINEAR = 1,
+};
+
+NN_API uint32_t    nn_cpu_features(void);
+NN_API const char* nn_kernel_isa(void);
+
+/* dst: width*3 (RGB) or width (gray) bytes per row, dst_stride apart */
+NN_API nn_status nn_convert_rgb(const nn_frame* src, uint8_t* dst, int32_t dst_stride);
+NN_API nn_status nn_convert_gray(const nn_frame* src, uint8_t* dst, int32_t dst_stride);
+
+/* Resamples src into a width x height BGRA image (NN_FILTER_*) */
+NN_API nn_status nn_downscale(const nn_frame* src, uint8_t* dst, int32_t width,
+                              int32_t height, int32_t dst_stride, uint32_t filter);
+
+/* Number of tile_size tiles covering a width x height frame */
+NN_API size_t nn_tile_count(int32_t width, int32_t height, uint32_t tile_size);
+
+/* Per-tile SAD diff of two equally sized frames. map[i] = 1 when tile i
+ * differs by more than `threshold` (summed over BGRA) per pixel on
+ * average; 0 flags any change. */
+NN_API nn_status nn_tile_diff(const nn_frame* a, const nn_frame* b, uint32_t tile_size,
+                              uint32_t threshold, uint8_t* map, size_t map_len,
+                              uint32_t* changed);
+
+/* 64-bit content hash per tile (row-major) */
+NN_API nn_status nn_tile_hashes(const nn_frame* src, uint32_t tile_size,
+                                uint64_t* out, size_t out_len);
+
+/* Perceptual hashes: a whole-frame hash and, when `tiles` is non-NULL,
+ * one per tile (row-major). Bits 0..55 are a dHash over 8x8 cells, bits
+ * 56..63 the mean luma; near-identical images get near-identical hashes.
+ * Compare them with nn_phash_distance, not ==. */
+NN_API nn_status nn_perceptual_hashes(const nn_frame* src, uint32_t tile_size, uint64_t* frame_hash,
+                                      uint64_t* tiles, size_t tiles_len);
+
+/* Differing dHash bits plus one per 8 levels of mean luma difference */
+NN_API uint32_t  nn_phash_distance(uint64_t a, uint64_t b);
+
+/* =====================================================
+ * Template matching
+ *
+ * Locates UI elements on screen from a reference crop. Templates are
+ * registered once by name (any BGRA image, e.g. a crop of an earlier
+ * frame) and searched by normalized cross-correlation over luma
+ * pyramids: the coarsest level is scanned in full on a work-stealing
+ * thread pool, then each candidate is refined down to full resolution.
+ * Scores are -1..1 and unaffected by uniform brightness or contrast
+ * changes; the template is not searched at other scales.
+ * ===================================================== */
+
+typedef struct nn_match {
+    int32_t x;       /* top-left, frame pixels (desktop pixels for nn_locate) */
+    int32_t y;
+    int32_t width;   /* template size */
+    int32_t height;
+    double  score;
+} nn_match;
+
+typedef struct nn_match_options {
+    double   threshold; /* minimum score, 0 = default (0.8) */
+    uint32_t levels;    /* pyramid levels including full resolution, 0 = auto, at most 5 */
+    uint32_t reserved;
+    nn_rect  region;    /* searched area in frame pixels, width or height 0 = whole frame */
+} nn_match_options;
+
+/* Copies `image` in, replacing any template of that name.
+ * NN_ERR_INVALID_ARGUMENT for a flat (single-colour) image. */
+NN_API nn_status nn_template_add(const char* name, const nn_frame* image);
+NN_API nn_status nn_template_remove(const char* name);
+NN_API void      nn_template_clear(void);
+
+/* Up to `max` non-overlapping matches, best first. NN_OK with *count = 0
+ * when nothing reaches the threshold; `options` may be NULL. */
+NN_API nn_status nn_match_template(const nn_frame* frame, const char* name,
+                                   const nn_match_options* options, nn_match* out,
+                                   uint32_t max, uint32_t* count);
+
+/* Grabs the primary output (a session kept open across calls) and finds
+ * the best match, in virtual-desktop pixels; NN_ERR_FAILED when the
+ * template is not on screen. This is what CLICK_IMAGE runs. */
+NN_API nn_status nn_locate(const char* name, const nn_match_options* options, nn_match* out);
+
+/* =====================================================
+ * Telemetry ring
+ *
+ * Fixed-capacity, lock-free multi-producer ring of fixed-layout records.
+ * Pushing never allocates; once full the oldest records are overwritten.
+ * Snapshots copy the stable records in order without blocking producers.
+ * ===================================================== */
+
+typedef struct nn_telemetry nn_telemetry;
+
+enum {
+    NN_SOURCE_UNKNOWN  = 0,
+    NN_SOURCE_PARSER   = 1,
+    NN_SOURCE_KEYBOARD = 2,
+    NN_SOURCE_MOUSE    = 3,
+    NN_SOURCE_HOOK     = 4, /* native input hook */
+    NN_SOURCE_NATIVE   = 5, /* nn_script_execute / nn_input_script_host */
+    NN_TYPE_OP         = 32, /* action records: type = NN_TYPE_OP + NN_OP_* */
+    NN_SOURCE_USER     = 64, /* first id free for callers to intern */
+};
+
+/* One cache line. `source`/`type` are small ids (the Python controller
+ * interns its strings); the payload fields are free-form per type. */
+typedef struct nn_record {
+    uint64_t sequence;     /* assigned on push, 1-based */
+    uint64_t timestamp_ns; /* nn_clock_ns(); filled on push when 0 */
+    uint16_t source;
+    uint16_t type;
+    uint32_t flags;
+    int32_t  x;
+    int32_t  y;
+    int64_t  arg;
+    double   value;
+    uint64_t aux;
+    uint64_t reserved;
+} nn_record;
+
+/* Monotonic clock used for every native timestamp */
+NN_API uint64_t nn_clock_ns(void);
+
+NN_API nn_status nn_telemetry_create(uint32_t capacity, nn_telemetry** out);
+NN_API void      nn_telemetry_destroy(nn_telemetry* ring);
+NN_API uint32_t  nn_telemetry_capacity(const nn_telemetry* ring);
+
+/* Returns the record's sequence number (0 on invalid arguments) */
+NN_API uint64_t nn_telemetry_push(nn_telemetry* ring, const nn_record* record);
+NN_API uint64_t nn_telemetry_push_event(nn_telemetry* ring, uint16_t source, uint16_t type,
+                                        int32_t x, int32_t y, int64_t arg, double value);
+
+/* Copies up to `max` of the newest records with sequence > since */
+NN_API size_t    nn_telemetry_snapshot(const nn_telemetry* ring, uint64_t since,
+                                       nn_record* out, size_t max);
+NN_API uint64_t  nn_telemetry_head(const nn_telemetry* ring);
+NN_API void      nn_telemetry_clear(nn_telemetry* ring);
+
+/* Shared rings: one ring per channel per process, created on first use
+ * (capacity is only honoured then) and never destroyed, so the Rust app
+ * and the Python controller read the same telemetry stream.
+ * nn_telemetry_destroy ignores them. */
+enum {
+    NN_CHANNEL_ACTIONS = 0,
+    NN_CHANNEL_MOUSE   = 1,
+    NN_CHANNEL_COUNT,
+};
+
+NN_API nn_telemetry* nn_telemetry_channel(uint32_t channel, uint32_t capacity);
+
+/* =====================================================
+ * History log
+ *
+ * Append-only, memory-mapped log of the shared channels: while started,
+ * every record pushed into NN_CHANNEL_ACTIONS / NN_CHANNEL_MOUSE is also
+ * written to the segment file at `path`, so history survives restarts
+ * and crashes and costs one 64-byte copy to record. Full segments (and,
+ * with rotate_seconds, old ones) rotate to path.1, path.2, ... up to
+ * keep_segments; a segment left by an earlier run is rotated on start.
+ *
+ * In the log, timestamp_ns is Unix-epoch ns and `reserved` holds the
+ * NN_CHANNEL_* the record came from. Each segment also carries records
+ * naming the source/type ids interned so far (reserved =
+ * NN_HISTORY_NAMES); readers skip those and look names up with
+ * nn_history_name_of.
+ * ===================================================== */
+
+#define NN_HISTORY_NAMES 0xFFFFFFFFu
+
+typedef struct nn_history_options {
+    uint32_t segment_records; /* records per segment, 0 = 65536 (4 MiB) */
+    uint32_t keep_segments;   /* rotated segments kept, 0 = 4 */
+    uint32_t rotate_seconds;  /* also rotate segments this old, 0 = only when full */
+    uint32_t reserved;
+} nn_history_options;
+
+/* options may be NULL (defaults) */
+NN_API nn_status nn_history_start(const char* path, const nn_history_options* options);
+NN_API void      nn_history_stop(void);
+
+/* Names a source/type id in the log (the Python controller registers its
+ * interned names; the built-in ones are named already) */
+NN_API nn_status nn_history_name(uint16_t id, const char* name);
+
+NN_API nn_status nn_history_flush(void);
+NN_API nn_status nn_history_rotate(void);
+
+/* Zero-copy readers: one segment file (live or not, from this process or
+ * an earlier one) mapped read-only. Record pointers stay valid until
+ * nn_history_close; a live segment's count grows as it is appended to. */
+typedef struct nn_history_file nn_history_file;
+
+NN_API nn_status nn_history_open(const char* path, nn_history_file** out);
+NN_API void      nn_history_close(nn_history_file* file);
+
+/* Every committed record, oldest first */
+NN_API size_t    nn_history_records(const nn_history_file* file, const nn_record** records);
+
+/* The records with from_ns <= timestamp_ns < to_ns (Unix-epoch ns) */
+NN_API size_t    nn_history_range(const nn_history_file* file, uint64_t from_ns, uint64_t to_ns,
+                                  const nn_record** first);
+
+/* NULL when the segment has no name for `id` */
+NN_API const char* nn_history_name_of(const nn_history_file* file, uint16_t id);
+
+/* =====================================================
+ * Metrics
+ *
+ * Process-wide counters and HDR histograms for the hot paths. Each
+ * thread records into its own cache-line-aligned block with plain
+ * stores (no locks, no contended writes); nn_metrics_get merges every
+ * thread's block on demand. Histograms keep values below 32 exactly and
+ * anything up to 2^40 within ~3%; percentiles report the bucket's
+ * highest value (never above max).
+ *
+ * The library records injection, executor and capture timings itself;
+ * the app and the Python controller add theirs through the same ids.
+ * While tracing is on, spans and values also go into a trace ring that
+ * nn_trace_write exports as Chrome trace JSON (chrome://tracing,
+ * Perfetto).
+ * ===================================================== */
+
+enum {
+    NN_METRIC_GIL_WAIT      = 0,  /* ns waiting to acquire the GIL (app Controller) */
+    NN_METRIC_GIL_HOLD      = 1,  /* ns holding it */
+    NN_METRIC_QUEUE_DEPTH   = 2,  /* executor scripts queued, at every submit */
+    NN_METRIC_INJECT        = 3,  /* ns per platform injection call */
+    NN_METRIC_SCRIPT        = 4,  /* ns per executor script, start to completion */
+    NN_METRIC_CAPTURE_FRAME = 5,  /* ns per capture grab */
+    NN_METRIC_WS_SEND       = 6,  /* ns per websocket frame out (serialize + send) */
+    NN_METRIC_WS_RECV       = 7,  /* ns per websocket frame in (parse + hand-off) */
+    NN_METRIC_USER          = 16, /* first id free for callers */
+    NN_METRIC_COUNT         = 32,
+};
+
+typedef struct nn_metric_stats {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+} nn_metric_stats;
+
+/* One value (a depth, a size, a duration measured elsewhere) */
+NN_API nn_status nn_metrics_record(uint32_t metric, uint64_t value);
+
+/* end - start (nn_clock_ns), and a trace span while tracing */
+NN_API nn_status nn_metrics_span(uint32_t metric, uint64_t start_ns, uint64_t end_ns);
+
+/* Everything recorded since the last reset, all threads */
+NN_API nn_status nn_metrics_get(uint32_t metric, nn_metric_stats* out);
+NN_API void      nn_metrics_reset(void);
+
+/* "gil_hold", "inject", ..., "user_16"; NULL for unused ids */
+NN_API const char* nn_metrics_name(uint32_t metric);
+
+/* Keeps the newest `capacity` events (0 = 65536; only honoured on the
+ * first start). Every start clears the ring. */
+NN_API nn_status nn_trace_start(uint32_t capacity);
+NN_API void      nn_trace_stop(void);
+
+/* Writes what the ring holds (also after stop); NN_ERR_UNAVAILABLE
+ * before the first start */
+NN_API nn_status nn_trace_write(const char* path);
+
+/* =====================================================
+ * Input hook
+ *
+ * OS-level mouse hook (WH_MOUSE_LL on Windows, XInput2 raw events or
+ * pointer polling on X11) on its own thread. Events are timestamped
+ * with nn_clock_ns() as they arrive and pushed into a telemetry ring as
+ * NN_SOURCE_HOOK records; no interpreter lock is involved.
+ * ===================================================== */
+
+enum {
+    NN_EVENT_MOUSE_MOVE   = 1, /* x, y */
+    NN_EVENT_MOUSE_BUTTON = 2, /* x, y, arg = button (1 left, 2 middle, 3 right), value = 1 down / 0 up */
+    NN_EVENT_MOUSE_WHEEL  = 3, /* x, y, arg = delta (120 per notch, negative = down) */
+};
+
+enum {
+    NN_RECORD_INJECTED = 1u << 0, /* synthesized input (SendInput & co.), when the OS tells */
+};
+
+typedef struct nn_mouse_hook_options {
+    uint32_t min_interval_us; /* coalesce moves to one per interval, 0 = every event */
+    uint32_t poll_hz;         /* pointer polling rate where no event API exists, 0 = 1000 */
+} nn_mouse_hook_options;
+
+/* One hook per process; NN_ERR_BUSY when already running. */
+NN_API nn_status nn_mouse_hook_start(nn_telemetry* ring, const nn_mouse_hook_options* options);
+NN_API void      nn_mouse_hook_stop(void);
+
+/* Latest pointer position seen by the hook (not coalesced) */
+NN_API nn_status nn_mouse_hook_position(int32_t* x, int32_t* y, uint64_t* timestamp_ns);
+
+/* =====================================================
+ * Action scripts
+ *
+ * The controller's script language (TYPE, ENTER, PRESS, HOLD, RELEASE,
+ * SHORTCUT, MOVE, MOVE_N, CLICK, CLICK_N, CLICK_IMAGE, LINE, PATH, WAIT;
+ * one command per line, shell-style quoting, `#` comment lines) is
+ * compiled once into a flat array of nn_op and kept in a process-wide
+ * cache keyed by a hash of the source, so re-sent scripts skip parsing.
+ * nn_script_run interprets the ops against an nn_script_host.
+ * ===================================================== */
+
+typedef struct nn_script nn_script;
+
+enum {
+    NN_OP_TYPE     = 1,  /* index = text string */
+    NN_OP_PRESS    = 2,  /* index = key string (ENTER compiles to PRESS "enter") */
+    NN_OP_HOLD     = 3,
+    NN_OP_RELEASE  = 4,
+    NN_OP_SHORTCUT = 5,  /* index = first key string, count = keys (consecutive) */
+    NN_OP_MOVE     = 6,  /* x, y, seconds = duration */
+    NN_OP_MOVE_N   = 7,  /* nx, ny in 0..1, mapped by the host's screen size */
+    NN_OP_CLICK    = 8,  /* x, y, button */
+    NN_OP_CLICK_N  = 9,  /* nx, ny, button */
+    NN_OP_PATH     = 10, /* index = first point, count = points, seconds = per step (LINE too) */
+    NN_OP_WAIT     = 11, /* seconds */
+    /* 12 is the action queue's NN_OP_SYNC */
+    NN_OP_CLICK_IMAGE = 13, /* index = template name, button, nx = threshold (0 = default);
+                               clicks the centre of the nn_locate match, NN_ERR_FAILED when off screen */
+};
+
+enum {
+    NN_BUTTON_LEFT   = 1,
+    NN_BUTTON_MIDDLE = 2,
+    NN_BUTTON_RIGHT  = 3,
+};
+
+typedef struct nn_point {
+    int32_t x;
+    int32_t y;
+} nn_point;
+
+typedef struct nn_op {
+    uint16_t code;    /* NN_OP_* */
+    uint16_t button;  /* NN_BUTTON_* */
+    uint32_t line;    /* 1-based source line */
+    int32_t  x;
+    int32_t  y;
+    uint32_t index;   /* string / point table index */
+    uint32_t count;
+    double   seconds;
+    double   nx;
+    double   ny;
+} nn_op;
+
+typedef struct nn_script_error {
+    uint32_t line;        /* 1-based, counted like the Python parser (after strip) */
+    char     message[124];/* NUL-terminated */
+} nn_script_error;
+
+/* Callbacks the interpreter drives, one per primitive. A non-NN_OK
+ * return stops the run and is passed through. `user` is handed back
+ * verbatim; strings are NUL-terminated and owned by the script.
+ * flush (optional, NULL = nothing held back) is called before
+ * CLICK_IMAGE grabs the screen: a host that queues or batches input
+ * sends all of it there, so the match sees the earlier ops' effect. */
+typedef struct nn_script_host {
+    void* user;
+    nn_status (*type_text)(void* user, const char* text, uint32_t len);
+    nn_status (*key)(void* user, uint32_t code, const char* key); /* NN_OP_PRESS/HOLD/RELEASE */
+    nn_status (*shortcut)(void* user, const char* const* keys, uint32_t count);
+    nn_status (*move)(void* user, int32_t x, int32_t y, double seconds);
+    nn_status (*click)(void* user, int32_t x, int32_t y, uint32_t button);
+    nn_status (*path)(void* user, const nn_point* points, uint32_t count, double step_seconds);
+    nn_status (*wait)(void* user, double seconds);
+    nn_status (*screen_size)(void* user, int32_t* width, int32_t* height);
+    nn_status (*flush)(void* user);
+} nn_script_host;
+
+/* Returns a cached program when the same text was compiled before.
+ * On NN_ERR_SYNTAX, `error` (optional) says where and why. */
+NN_API nn_status nn_script_compile(const char* text, size_t len, nn_script** out,
+                                   nn_script_error* error);
+NN_API void      nn_script_free(nn_script* script);
+
+NN_API uint64_t      nn_script_hash(const nn_script* script);
+NN_API const nn_op*  nn_script_ops(const nn_script* script, size_t* count);
+NN_API const char*   nn_script_string(const nn_script* script, uint32_t index, uint32_t* len);
+NN_API const nn_point* nn_script_points(const nn_script* script, uint32_t index);
+
+NN_API nn_status nn_script_run(const nn_script* script, const nn_script_host* host);
+
+NN_API void nn_script_cache_stats(uint64_t* hits, uint64_t* misses, uint32_t* entries);
+NN_API void nn_script_cache_clear(void);
+
+/* =====================================================
+ * Scheduler
+ *
+ * Absolute-deadline waits: high-resolution waitable timers on Windows,
+ * clock_nanosleep elsewhere, with the last stretch spun so wakes land
+ * within microseconds. Each thread has a timeline that nn_schedule_wait
+ * advances before waiting, so a run of waits keeps to its deadlines no
+ * matter how long the work between them takes. The controller queues,
+ * scripts and paced injection on a thread all share its timeline; one
+ * that has fallen more than 50 ms behind restarts at now.
+ * ===================================================== */
+
+typedef struct nn_schedule_stats {
+    uint64_t waits;
+    int64_t  mean_error_ns; /* wake - deadline; positive = late */
+    int64_t  min_error_ns;
+    int64_t  max_error_ns;
+    uint64_t stddev_ns;
+} nn_schedule_stats;
+
+/* Advances this thread's timeline by `seconds` and waits for it.
+ * NaN and negative count as 0; longer than an hour (or inf) waits an
+ * hour. Returns the wake error in ns. */
+NN_API int64_t  nn_schedule_wait(double seconds);
+
+/* Waits for an absolute nn_clock_ns() deadline (timeline untouched) */
+NN_API int64_t  nn_schedule_wait_until(uint64_t deadline_ns);
+
+/* This thread's current deadline (0 before its first wait) */
+NN_API uint64_t nn_schedule_deadline(void);
+
+/* Jitter over every wait since the last reset, all threads */
+NN_API void     nn_schedule_stats_get(nn_schedule_stats* out);
+NN_API void     nn_schedule_stats_reset(void);
+
+/* =====================================================
+ * Input injection
+ *
+ * Direct OS injection (SendInput on Windows, XTest on X11) with the same
+ * semantics as the Python controls' pyautogui calls: pyautogui key
+ * names, coordinates clamped onto the nearest monitor (see Monitors), moves longer than
+ * 0.1 s tweened. Callable from any thread; calls are serialized. Paced
+ * calls (typing intervals, tweens, path steps) wait on the caller's
+ * scheduler timeline.
+ *
+ * Text is typed with the active layout's keys; characters it lacks go
+ * out as Unicode events (KEYEVENTF_UNICODE on Windows, a keysym bound
+ * to a spare keycode on X11), so any UTF-8 text can be typed.
+ * ===================================================== */
+
+enum {
+    NN_KEY_TAP  = 0,
+    NN_KEY_DOWN = 1,
+    NN_KEY_UP   = 2,
+};
+
+/* Opens the backend (also done lazily by every call below) */
+NN_API nn_status nn_input_open(void);
+
+NN_API nn_status nn_input_key(const char* key, uint32_t action);
+NN_API nn_status nn_input_hotkey(const char* const* keys, uint32_t count);
+NN_API nn_status nn_input_type(const char* text, size_t len, double interval_seconds);
+
+NN_API nn_status nn_input_move(int32_t x, int32_t y, double seconds);
+NN_API nn_status nn_input_click(int32_t x, int32_t y, uint32_t button);
+/* One move per point, step_seconds apart (0 = a single batched send) */
+NN_API nn_status nn_input_path(const nn_point* points, uint32_t count, double step_seconds);
+NN_API nn_status nn_input_screen_size(int32_t* width, int32_t* height);
+
+enum {
+    NN_TEXT_LAYOUT  = 0, /* layout keys, Unicode events for the rest (default) */
+    NN_TEXT_UNICODE = 1, /* every character as a Unicode event where supported */
+};
+
+typedef struct nn_text_options {
+    uint32_t mode;            /* NN_TEXT_* */
+    /* Unpaced text of at least this many bytes is pasted through the
+     * clipboard (ctrl+v; the previous clipboard text is lost), typed if
+     * the clipboard is unavailable. 0 = never. */
+    uint32_t paste_threshold;
+} nn_text_options;
+
+/* Process-wide: every type call, batch and timeline */
+NN_API nn_status nn_input_set_text_options(const nn_text_options* options);
+NN_API nn_status nn_input_text_options(nn_text_options* out);
+
+/* Sets the clipboard and sends ctrl+v, whatever the threshold */
+NN_API nn_status nn_input_paste(const char* text, size_t len);
+
+/* Host that injects each op directly and records it on
+ * NN_CHANNEL_ACTIONS (source NN_SOURCE_NATIVE) */
+NN_API const nn_script_host* nn_input_script_host(void);
+
+/* Compile (cached) + run in script order. Untimed ops between waits go
+ * out as one batch (see below); TYPE is unpaced. */
+NN_API nn_status nn_script_execute(const char* text, size_t len, nn_script_error* error);
+
+/* nn_script_execute, pipelined: a worker thread compiles line by line
+ * while the caller injects, so input starts before the script is fully
+ * parsed. Pending batched ops go out whenever the injector catches up
+ * with the compiler. On NN_ERR_SYNTAX the lines before the error have
+ * already run. */
+NN_API nn_status nn_script_stream(const char* text, size_t len, nn_script_error* error);
+
+/* Batches: events resolved as they are added and injected in order by a
+ * single nn_input_batch_send (one SendInput call / one XFlush). Nothing
+ * in a batch sleeps; send, then wait, then keep adding for timed
+ * sequences. A batch is single-threaded; send clears it even on error. */
+typedef struct nn_input_batch nn_input_batch;
+
+NN_API nn_status nn_input_batch_create(nn_input_batch** out);
+NN_API void      nn_input_batch_free(nn_input_batch* batch);
+
+NN_API nn_status nn_input_batch_key(nn_input_batch* batch, const char* key, uint32_t action);
+NN_API nn_status nn_input_batch_hotkey(nn_input_batch* batch, const char* const* keys, uint32_t count);
+NN_API nn_status nn_input_batch_type(nn_input_batch* batch, const char* text, size_t len);
+NN_API nn_status nn_input_batch_move(nn_input_batch* batch, int32_t x, int32_t y);
+NN_API nn_status nn_input_batch_click(nn_input_batch* batch, int32_t x, int32_t y, uint32_t button);
+NN_API nn_status nn_input_batch_path(nn_input_batch* batch, const nn_point* points, uint32_t count);
+
+/* Pending events (key down and up count separately, a paste is one) */
+NN_API size_t    nn_input_batch_size(const nn_input_batch* batch);
+NN_API nn_status nn_input_batch_send(nn_input_batch* batch);
+NN_API void      nn_input_batch_clear(nn_input_batch* batch);
+
+/* =====================================================
+ * Input timeline
+ *
+ * Keyboard and mouse instructions merged onto one time axis and run by
+ * a single executor. Each lane (device stream) has its own cursor: an
+ * instruction starts at its lane's cursor and only advances that lane,
+ * so independent streams overlap. nn_timeline_sync is the barrier
+ * between them (a script WAIT): all lanes meet, then wait once.
+ *
+ * nn_timeline_run executes everything on the calling thread in
+ * deadline order (ties in the order added) against its scheduler
+ * timeline; events due together go out as one batch. Paced
+ * instructions expand into one entry per step. A timeline is
+ * single-threaded; run clears it, also on error.
+ * ===================================================== */
+
+typedef struct nn_timeline nn_timeline;
+
+enum {
+    NN_LANE_KEYBOARD = 0,
+    NN_LANE_MOUSE    = 1,
+    NN_LANE_COUNT,
+};
+
+NN_API nn_status nn_timeline_create(nn_timeline** out);
+NN_API void      nn_timeline_free(nn_timeline* timeline);
+
+NN_API nn_status nn_timeline_key(nn_timeline* timeline, uint32_t lane, const char* key, uint32_t action);
+NN_API nn_status nn_timeline_hotkey(nn_timeline* timeline, uint32_t lane,
+                                    const char* const* keys, uint32_t count);
+NN_API nn_status nn_timeline_type(nn_timeline* timeline, uint32_t lane, const char* text, size_t len,
+                                  double interval_seconds);
+NN_API nn_status nn_timeline_move(nn_timeline* timeline, uint32_t lane, int32_t x, int32_t y,
+                                  double seconds);
+NN_API nn_status nn_timeline_click(nn_timeline* timeline, uint32_t lane, int32_t x, int32_t y,
+                                   uint32_t button);
+NN_API nn_status nn_timeline_path(nn_timeline* timeline, uint32_t lane, const nn_point* points,
+                                  uint32_t count, double step_seconds);
+
+/* Advances one lane */
+NN_API nn_status nn_timeline_wait(nn_timeline* timeline, uint32_t lane, double seconds);
+/* All lanes meet at the furthest one, then wait `seconds` */
+NN_API nn_status nn_timeline_sync(nn_timeline* timeline, double seconds);
+
+/* Entries queued / furthest lane offset in ns */
+NN_API size_t    nn_timeline_size(const nn_timeline* timeline);
+NN_API uint64_t  nn_timeline_duration_ns(const nn_timeline* timeline);
+
+NN_API nn_status nn_timeline_run(nn_timeline* timeline);
+NN_API void      nn_timeline_clear(nn_timeline* timeline);
+
+/* =====================================================
+ * Path generation
+ *
+ * Builds mouse strokes into a packed nn_point buffer that
+ * nn_input_path, nn_input_batch_path and nn_timeline_path take as-is.
+ * Lines and curves are subdivided by distance: consecutive points are
+ * at most `spacing` pixels apart, or velocity * step_seconds when both
+ * are set, so a stroke paced at step_seconds moves at that speed.
+ * Spacing <= 1 draws every pixel (Bresenham). Segments appended back to
+ * back share their joint point instead of repeating it.
+ *
+ * Calls fail with NN_ERR_INVALID_ARGUMENT once the buffer would exceed
+ * 2^20 points. A path is single-threaded.
+ * ===================================================== */
+
+typedef struct nn_path nn_path;
+
+typedef struct nn_path_options {
+    double spacing;      /* px between points, 0 = 10 */
+    double velocity;     /* px/s, with step_seconds; 0 = use spacing */
+    double step_seconds;
+    double tolerance;    /* curve flatness in px, 0 = 0.5 */
+} nn_path_options;
+
+/* options may be NULL for the defaults */
+NN_API nn_status nn_path_create(const nn_path_options* options, nn_path** out);
+NN_API void      nn_path_free(nn_path* path);
+NN_API void      nn_path_clear(nn_path* path);
+
+/* Exactly steps + 1 evenly spaced points, repeats included (LINE ... STEPS) */
+NN_API nn_status nn_path_line_steps(nn_path* path, nn_point from, nn_point to, int64_t steps);
+NN_API nn_status nn_path_line(nn_path* path, nn_point from, nn_point to);
+NN_API nn_status nn_path_polyline(nn_path* path, const nn_point* points, size_t count);
+/* 3 control points = quadratic, 4 = cubic */
+NN_API nn_status nn_path_bezier(nn_path* path, const nn_point* control, size_t count);
+/* Spline through every point */
+NN_API nn_status nn_path_catmull_rom(nn_path* path, const nn_point* points, size_t count);
+
+/* Clamps every point into [0, width) x [0, height) */
+NN_API nn_status nn_path_clamp(nn_path* path, int32_t width, int32_t height);
+
+/* Valid until the next call that modifies the path */
+NN_API const nn_point* nn_path_points(const nn_path* path, size_t* count);
+
+/* =====================================================
+ * Window state
+ *
+ * Process-wide cache of the visible top-level windows and the active
+ * one, kept current on its own thread by OS window events
+ * (SetWinEventHook on Windows; _NET_CLIENT_LIST, _NET_ACTIVE_WINDOW and
+ * per-window name changes through PropertyNotify on X11, which needs an
+ * EWMH window manager). Reads never enumerate: the version is a
+ * counter bumped on every change, and a snapshot is an immutable view
+ * that stays valid until freed.
+ * ===================================================== */
+
+typedef struct nn_window_snapshot nn_window_snapshot;
+
+typedef struct nn_window_info {
+    uint64_t    id;        /* HWND / X11 Window */
+    uint32_t    pid;       /* 0 when unknown */
+    uint32_t    title_len;
+    const char* title;     /* UTF-8, NUL-terminated, owned by the snapshot */
+} nn_window_info;
+
+/* NN_ERR_BUSY when already running, NN_ERR_UNAVAILABLE without a backend */
+NN_API nn_status nn_window_cache_start(void);
+NN_API void      nn_window_cache_stop(void);
+
+/* 0 until started; changes whenever the window state does */
+NN_API uint64_t  nn_window_cache_version(void);
+
+/* NN_ERR_UNAVAILABLE while the cache is not running */
+NN_API nn_status nn_window_snapshot_get(nn_window_snapshot** out);
+NN_API void      nn_window_snapshot_free(nn_window_snapshot* snapshot);
+
+NN_API uint64_t  nn_window_snapshot_version(const nn_window_snapshot* snapshot);
+NN_API size_t    nn_window_snapshot_count(const nn_window_snapshot* snapshot);
+/* Top-level windows in OS order (z-order / stacking) */
+NN_API nn_status nn_window_snapshot_window(const nn_window_snapshot* snapshot, size_t index,
+                                           nn_window_info* out);
+/* Index of the active window, or -1 */
+NN_API int64_t   nn_window_snapshot_active(const nn_window_snapshot* snapshot);
+
+/* =====================================================
+ * Accessibility tree
+ *
+ * The foreground window's UI element tree, kept current on its own
+ * thread (UI Automation on Windows, AT-SPI on Linux). The tree is
+ * walked once when a window comes to the front and afterwards only
+ * where focus, structure-changed and property events say it moved. It
+ * is bounded (4096 elements, 48 levels, 256 bytes per string); a
+ * snapshot is an immutable pre-order view whose element 0 is the
+ * window. nn_ui_snapshot_text gives the compact form sent to the model:
+ * one line per element, indented by depth, that is stable enough to be
+ * diffed line by line between two versions.
+ * ===================================================== */
+
+typedef struct nn_ui_snapshot nn_ui_snapshot;
+
+enum {
+    NN_UI_ROLE_UNKNOWN = 0,
+    NN_UI_ROLE_WINDOW,
+    NN_UI_ROLE_DIALOG,
+    NN_UI_ROLE_PANE,
+    NN_UI_ROLE_GROUP,
+    NN_UI_ROLE_BUTTON,
+    NN_UI_ROLE_CHECKBOX,
+    NN_UI_ROLE_RADIO,
+    NN_UI_ROLE_COMBOBOX,
+    NN_UI_ROLE_EDIT,
+    NN_UI_ROLE_TEXT,
+    NN_UI_ROLE_LINK,
+    NN_UI_ROLE_IMAGE,
+    NN_UI_ROLE_LIST,
+    NN_UI_ROLE_LIST_ITEM,
+    NN_UI_ROLE_MENU,
+    NN_UI_ROLE_MENU_BAR,
+    NN_UI_ROLE_MENU_ITEM,
+    NN_UI_ROLE_TAB,
+    NN_UI_ROLE_TAB_ITEM,
+    NN_UI_ROLE_TREE,
+    NN_UI_ROLE_TREE_ITEM,
+    NN_UI_ROLE_TABLE,
+    NN_UI_ROLE_ROW,
+    NN_UI_ROLE_CELL,
+    NN_UI_ROLE_HEADER,
+    NN_UI_ROLE_TOOLBAR,
+    NN_UI_ROLE_STATUS_BAR,
+    NN_UI_ROLE_SCROLL_BAR,
+    NN_UI_ROLE_SLIDER,
+    NN_UI_ROLE_SPINNER,
+    NN_UI_ROLE_PROGRESS,
+    NN_UI_ROLE_DOCUMENT,
+    NN_UI_ROLE_HEADING,
+    NN_UI_ROLE_SEPARATOR,
+    NN_UI_ROLE_TOOLTIP,
+    NN_UI_ROLE_TITLE_BAR,
+    NN_UI_ROLE_COUNT
+};
+
+enum {
+    NN_UI_STATE_FOCUSED   = 1u << 0,
+    NN_UI_STATE_DISABLED  = 1u << 1,
+    NN_UI_STATE_SELECTED  = 1u << 2,
+    NN_UI_STATE_CHECKED   = 1u << 3,
+    NN_UI_STATE_EXPANDED  = 1u << 4,
+    NN_UI_STATE_COLLAPSED = 1u << 5,
+    NN_UI_STATE_OFFSCREEN = 1u << 6,
+    NN_UI_STATE_PROTECTED = 1u << 7, /* password field: the value is never exposed */
+};
+
+typedef struct nn_ui_element {
+    uint64_t    id;        /* stable for the element's lifetime */
+    uint64_t    parent;    /* 0 for the window */
+    uint32_t    depth;     /* 0 = the window */
+    uint32_t    role;      /* NN_UI_ROLE_* */
+    uint32_t    states;    /* NN_UI_STATE_* */
+    uint32_t    name_len;
+    uint32_t    value_len;
+    uint32_t    reserved;
+    nn_rect     bounds;    /* virtual-desktop pixels */
+    const char* name;      /* UTF-8, NUL-terminated, owned by the snapshot */
+    const char* value;
+} nn_ui_element;
+
+/* NN_ERR_BUSY when already running, NN_ERR_UNAVAILABLE without a backend */
+NN_API nn_status nn_ui_tree_start(void);
+NN_API void      nn_ui_tree_stop(void);
+
+/* 0 until started; changes whenever the tree does */
+NN_API uint64_t  nn_ui_tree_version(void);
+
+/* NN_ERR_UNAVAILABLE while the tree is not running */
+NN_API nn_status nn_ui_snapshot_get(nn_ui_snapshot** out);
+NN_API void      nn_ui_snapshot_free(nn_ui_snapshot* snapshot);
+
+NN_API uint64_t  nn_ui_snapshot_version(const nn_ui_snapshot* snapshot);
+/* HWND on Windows, 0 when the backend cannot tell */
+NN_API uint64_t  nn_ui_snapshot_window(const nn_ui_snapshot* snapshot);
+NN_API size_t    nn_ui_snapshot_count(const nn_ui_snapshot* snapshot);
+NN_API nn_status nn_ui_snapshot_element(const nn_ui_snapshot* snapshot, size_t index,
+                                        nn_ui_element* out);
+/* Index of the focused element, or -1 */
+NN_API int64_t   nn_ui_snapshot_focus(const nn_ui_snapshot* snapshot);
+/* 1 when the application exposed more than the bounds allow */
+NN_API int       nn_ui_snapshot_truncated(const nn_ui_snapshot* snapshot);
+
+/* Compact text form, at most capacity - 1 bytes plus the NUL; *len (if
+ * not NULL) receives the length. Lines are cut whole, ending with a
+ * "... N more" line when the tree does not fit. */
+NN_API nn_status nn_ui_snapshot_text(const nn_ui_snapshot* snapshot, char* out, size_t capacity,
+                                     size_t* len);
+
+/* "button", "edit", ...; "unknown" for anything out of range */
+NN_API const char* nn_ui_role_name(uint32_t role);
+
+/* =====================================================
+ * Process tracking
+ *
+ * Incremental process table. Each refresh diffs the live processes
+ * against the previous one and exposes only the difference: apply the
+ * removals first, then the additions. On Windows a refresh is one
+ * NtQuerySystemInformation call; on Linux it replays the kernel's
+ * process events (netlink proc connector, which needs CAP_NET_ADMIN)
+ * or, without them, rescans /proc. Names are interned per tracker with
+ * dense ids that are never reused, so a consumer only has to fetch the
+ * names past the last nn_process_name_count it saw. A tracker is not
+ * thread-safe.
+ * ===================================================== */
+
+typedef struct nn_process_tracker nn_process_tracker;
+
+typedef struct nn_process_delta {
+    uint32_t pid;
+    uint32_t name_id;   /* nn_process_name */
+} nn_process_delta;
+
+NN_API nn_status nn_process_tracker_create(nn_process_tracker** out);
+NN_API void      nn_process_tracker_free(nn_process_tracker* tracker);
+
+/* NN_ERR_UNAVAILABLE without a backend. The first refresh reports every
+ * live process as added. */
+NN_API nn_status nn_process_tracker_refresh(nn_process_tracker* tracker);
+
+/* Deltas of the last refresh; valid until the next one */
+NN_API const nn_process_delta* nn_process_tracker_added(const nn_process_tracker* tracker,
+                                                        size_t* count);
+NN_API const nn_process_delta* nn_process_tracker_removed(const nn_process_tracker* tracker,
+                                                          size_t* count);
+
+/* Every live process, unordered: copies up to `max` and returns the total */
+NN_API size_t    nn_process_tracker_size(const nn_process_tracker* tracker);
+NN_API size_t    nn_process_tracker_list(const nn_process_tracker* tracker,
+                                         nn_process_delta* out, size_t max);
+
+/* UTF-8, NUL-terminated, owned by the tracker; NULL for an unknown id */
+NN_API size_t      nn_process_name_count(const nn_process_tracker* tracker);
+NN_API const char* nn_process_name(const nn_process_tracker* tracker, uint32_t id, uint32_t* len);
+
+/* =====================================================
+ * Action executor
+ *
+ * A dedicated thread that runs submitted scripts one at a time, in
+ * order, exactly like nn_script_stream, so submitting never waits on
+ * injection. The queue is bounded (NN_ERR_BUSY when full). Each script
+ * has a caller-chosen group: NN_SUBMIT_SUPERSEDE cancels the queued
+ * scripts of the same group, NN_SUBMIT_INTERRUPT also stops the one
+ * running (at its next primitive or during a WAIT; a started tween or
+ * paced path finishes). Every accepted script yields one completion,
+ * NN_ERR_CANCELLED for the ones that never ran or were stopped.
+ * ===================================================== */
+
+typedef struct nn_executor nn_executor;
+
+typedef struct nn_executor_options {
+    uint32_t capacity;      /* queued scripts, 0 = 16 */
+    double   stale_seconds; /* cancel scripts queued longer than this, 0 = never */
+} nn_executor_options;
+
+enum {
+    NN_SUBMIT_SUPERSEDE = 1u << 0,
+    NN_SUBMIT_INTERRUPT = 1u << 1,
+};
+
+typedef struct nn_completion {
+    uint64_t        ticket;
+    uint32_t        group;
+    nn_status       status;
+    nn_script_error error;  /* NN_ERR_SYNTAX only */
+} nn_completion;
+
+NN_API nn_status nn_executor_create(const nn_executor_options* options, nn_executor** out);
+/* Closes, then waits for the running script to stop */
+NN_API void      nn_executor_free(nn_executor* executor);
+
+/* NN_ERR_UNAVAILABLE once closed */
+NN_API nn_status nn_executor_submit(nn_executor* executor, const char* text, size_t len,
+                                    uint32_t group, uint32_t flags, uint64_t* ticket);
+/* nn_executor_submit without the copy: the executor reads `text` in
+ * place and calls release(user) once it is done with it (after the
+ * completion, or right away when the script is refused). On
+ * NN_ERR_INVALID_ARGUMENT nothing was taken and release is not called. */
+typedef void (*nn_release_fn)(void* user);
+
+NN_API nn_status nn_executor_submit_view(nn_executor* executor, const char* text, size_t len,
+                                         nn_release_fn release, void* user, uint32_t group,
+                                         uint32_t flags, uint64_t* ticket);
+
+/* NN_ERR_INVALID_ARGUMENT when the ticket has already completed */
+NN_API nn_status nn_executor_cancel(nn_executor* executor, uint64_t ticket);
+
+/* Next completion, waiting up to timeout_ms (< 0 = no limit): NN_ERR_TIMEOUT
+ * when none arrived, NN_ERR_UNAVAILABLE once closed and fully collected. */
+NN_API nn_status nn_executor_next(nn_executor* executor, nn_completion* out, int32_t timeout_ms);
+
+/* Stops accepting scripts and cancels everything queued or running;
+ * nn_executor_next still hands out the remaining completions. */
+NN_API void      nn_executor_close(nn_executor* executor);
+
+/* Queued plus running */
+NN_API size_t    nn_executor_pending(const nn_executor* executor);
+
+/* =====================================================
+ * Frame encoder
+ *
+ * Turns leased capture frames into compressed buffers on a pool of
+ * worker threads: downscaled with the frame kernels to fit max_width x
+ * max_height, then encoded as JPEG (libjpeg-turbo) or WebP (libwebp), or
+ * shipped raw. NN_CODEC_RAW with damage rects carries only those
+ * regions, unscaled: each rect's BGRA rows back to back, in rect order.
+ *
+ * Packets come out in submission order. Each frame in flight holds one
+ * of `buffers` preallocated buffers from submit until nn_encoder_release,
+ * so nothing is allocated once the pipeline is warm, and a consumer that
+ * falls behind sees NN_ERR_BUSY rather than a growing backlog.
+ * ===================================================== */
+
+typedef struct nn_encoder nn_encoder;
+
+enum {
+    NN_CODEC_RAW  = 0, /* packed BGRA */
+    NN_CODEC_JPEG = 1,
+    NN_CODEC_WEBP = 2,
+};
+
+typedef struct nn_encoder_options {
+    uint32_t codec;      /* NN_CODEC_* */
+    int32_t  quality;    /* 1..100, 0 = 75 */
+    int32_t  max_width;  /* fit inside, aspect kept; 0 = no limit */
+    int32_t  max_height;
+    uint32_t filter;     /* NN_FILTER_* */
+    uint32_t threads;    /* workers, 0 = 2 */
+    uint32_t buffers;    /* frames in flight, 0 = 4 */
+} nn_encoder_options;
+
+/* An encoded frame. data and rects stay valid until
+ * nn_encoder_release(encoder, packet->id). */
+typedef struct nn_packet {
+    uint32_t       id;
+    nn_status      status;        /* NN_ERR_CANCELLED when closed before encoding */
+    uint32_t       codec;
+    int32_t        width;         /* encoded size */
+    int32_t        height;
+    int32_t        source_width;
+    int32_t        source_height;
+    uint64_t       sequence;      /* of the captured frame */
+    uint64_t       timestamp_ns;
+    const uint8_t* data;
+    size_t         size;
+    const nn_rect* rects;         /* damage passed to submit, source coordinates */
+    uint32_t       rect_count;
+} nn_packet;
+
+/* Non-zero when the codec was compiled in (NN_CODEC_RAW always is) */
+NN_API int       nn_codec_available(uint32_t codec);
+
+/* NN_ERR_UNAVAILABLE when the codec is not compiled in */
+NN_API nn_status nn_encoder_create(const nn_encoder_options* options, nn_encoder** out);
+/* Closes and joins the workers. Outstanding packets become invalid; free
+ * the encoder before the capture sessions it holds leases on. */
+NN_API void      nn_encoder_free(nn_encoder* encoder);
+
+/* Queues a leased frame. On NN_OK the encoder owns the lease and returns
+ * it to `capture` once the pixels are encoded; with a NULL capture the
+ * caller keeps frame->data valid until the packet comes out. On
+ * NN_ERR_BUSY (every buffer in flight) or NN_ERR_UNAVAILABLE (closed)
+ * the lease stays the caller's. */
+NN_API nn_status nn_encoder_submit(nn_encoder* encoder, nn_capture* capture, const nn_frame* frame,
+                                   const nn_rect* rects, uint32_t rect_count);
+
+/* Oldest submitted frame, once encoded, waiting up to timeout_ms (< 0 = no
+ * limit): NN_ERR_TIMEOUT when it isn't ready, NN_ERR_UNAVAILABLE once
+ * closed and every packet has been handed out. */
+NN_API nn_status nn_encoder_next(nn_encoder* encoder, nn_packet* out, int32_t timeout_ms);
+NN_API nn_status nn_encoder_release(nn_encoder* encoder, uint32_t id);
+
+/* Stops accepting frames; queued ones come out NN_ERR_CANCELLED */
+NN_API void      nn_encoder_close(nn_encoder* encoder);
+
+/* =====================================================
+ * Screen-state cache
+ *
+ * Perceptual tile hashes of observed frames, so "has anything changed
+ * meaningfully since frame N?" is answered without touching pixels: a
+ * tile changed when its nn_phash_distance exceeds `threshold`. Keeps
+ * the last `history` frames, plus an LRU of `capacity` distinct screen
+ * states (all tiles within threshold = same state). Each state can carry
+ * a caller value, e.g. the id of a vision result already computed for
+ * it, so returning to a screen seen before is recognised.
+ * ===================================================== */
+
+typedef struct nn_screen_cache nn_screen_cache;
+
+typedef struct nn_screen_cache_options {
+    uint32_t capacity;  /* distinct states, 0 = 32 */
+    uint32_t tile_size; /* 0 = 64 */
+    uint32_t history;   /* frames answerable by changed_since, 0 = 64 */
+    uint32_t threshold; /* per-tile distance that counts as a change, 0 = 4 */
+} nn_screen_cache_options;
+
+typedef struct nn_screen_observation {
+    uint64_t state;          /* id of the matching state, 1-based */
+    uint64_t sequence;       /* frame->sequence */
+    uint64_t first_sequence; /* first frame seen in this state */
+    uint64_t value;          /* set with nn_screen_cache_set_value, else 0 */
+    uint64_t frame_hash;
+    uint32_t changed_tiles;  /* vs the previous observed frame; all on the first */
+    uint32_t tile_count;
+    uint32_t known;          /* non-zero when the state was already cached */
+} nn_screen_observation;
+
+NN_API nn_status nn_screen_cache_create(const nn_screen_cache_options* options, nn_screen_cache** out);
+NN_API void      nn_screen_cache_free(nn_screen_cache* cache);
+
+/* Hashes the frame. Observing the latest sequence again (an
+ * NN_FRAME_UNCHANGED re-lease) reports it again without hashing. */
+NN_API nn_status nn_screen_cache_observe(nn_screen_cache* cache, const nn_frame* frame,
+                                         nn_screen_observation* out);
+
+/* Tiles changed between frame `sequence` and the latest observed one;
+ * NN_ERR_UNAVAILABLE when that frame has left the history. */
+NN_API nn_status nn_screen_cache_changed_since(const nn_screen_cache* cache, uint64_t sequence,
+                                               uint32_t* changed_tiles);
+
+/* NN_ERR_INVALID_ARGUMENT when the state has been evicted */
+NN_API nn_status nn_screen_cache_set_value(nn_screen_cache* cache, uint64_t state, uint64_t value);
+
+/* =====================================================
+ * Monitors
+ *
+ * Every output, primary first, in virtual-desktop pixels (the space of
+ * the input calls; may start at negative coordinates). The layout is
+ * enumerated once and kept until nn_monitors_refresh(). The multi-
+ * monitor capture opens one session per output and grabs them all at
+ * once, each on its own thread.
+ * ===================================================== */
+
+typedef struct nn_monitor {
+    int32_t index;    /* nn_capture_options.output */
+    nn_rect bounds;
+    uint32_t primary; /* non-zero for the primary output */
+    char    name[64]; /* OS output name, UTF-8 */
+} nn_monitor;
+
+/* Writes up to max monitors; *count is the total, which may be larger. */
+NN_API nn_status nn_monitors(nn_monitor* out, uint32_t max, uint32_t* count);
+/* Enumerates again, e.g. after a display change */
+NN_API nn_status nn_monitors_refresh(void);
+/* Bounding rectangle of every monitor */
+NN_API nn_status nn_virtual_desktop(nn_rect* out);
+
+/* Normalized 0.0-1.0 coordinates on a monitor (-1 = the whole virtual
+ * desktop) to virtual-desktop pixels on a monitor. */
+NN_API nn_status nn_map_normalized(int32_t monitor, double nx, double ny, int32_t* x, int32_t* y);
+/* Moves (x, y) onto the nearest monitor, its index in *monitor
+ * (optional). Points already on a monitor are left alone. */
+NN_API nn_status nn_clamp_point(int32_t* x, int32_t* y, int32_t* monitor);
+/* nn_clamp_point on every point of the path */
+NN_API nn_status nn_path_clamp_desktop(nn_path* path);
+
+typedef struct nn_multi_capture nn_multi_capture;
+
+/* One capture session and grab thread per monitor; ring_slots as
+ * nn_capture_options (0 = default). */
+NN_API nn_status nn_multi_capture_open(uint32_t ring_slots, nn_multi_capture** out);
+NN_API void      nn_multi_capture_close(nn_multi_capture* capture);
+
+NN_API uint32_t  nn_multi_capture_count(const nn_multi_capture* capture);
+NN_API nn_status nn_multi_capture_monitor(const nn_multi_capture* capture, uint32_t output, nn_monitor* out);
+/* The output's session, for nn_capture_release / nn_encoder_submit. Owned
+ * by the multi capture: never pass it to nn_capture_close. */
+NN_API nn_capture* nn_multi_capture_session(nn_multi_capture* capture, uint32_t output);
+
+/* Grabs every output concurrently and waits for all of them. `frames`
+ * (and the optional `statuses`) hold count entries, which must equal
+ * nn_multi_capture_count. NN_OK when every output grabbed; otherwise the
+ * first failure, and only outputs whose status is NN_OK hold a lease. */
+NN_API nn_status nn_multi_capture_grab(nn_multi_capture* capture, uint32_t timeout_ms,
+                                       nn_frame* frames, nn_status* statuses, uint32_t count);
+NN_API nn_status nn_multi_capture_release(nn_multi_capture* capture, uint32_t output, uint32_t slot);
+
+/* =====================================================
+ * Action queue
+ *
+ * What the keyboard and mouse controllers queue between executes, as
+ * fixed-size records in one contiguous array with their text, key names
+ * and points in a bump arena (no per-action objects). Records use the
+ * script's NN_OP_* codes plus NN_OP_SYNC. Adjacent records of a lane
+ * coalesce: text into text, a tap repeated into one record, and (under
+ * the default nn_text_options) taps of enter, tab, space, a-z and 0-9
+ * into the text before them.
+ * nn_action_queue_clear keeps both allocations for the next script.
+ *
+ * nn_action_queue_schedule adds every record to a timeline (not run);
+ * nn_action_queue_execute injects one lane through a batch the way the
+ * controllers' per-device execute does: untimed records accumulate,
+ * waits, tweens, paced paths and paced text send first and then run
+ * timed, on the scheduler. A queue is single-threaded.
+ * ===================================================== */
+
+typedef struct nn_action_queue nn_action_queue;
+
+enum {
+    NN_OP_SYNC = 12, /* queue only: lane = NN_LANE_COUNT, seconds = wait */
+};
+
+typedef struct nn_action {
+    uint16_t code;    /* NN_OP_* */
+    uint16_t lane;    /* NN_LANE_* */
+    uint32_t arg;     /* CLICK: NN_BUTTON_*; PRESS/HOLD/RELEASE: repeat */
+    int32_t  x;       /* MOVE, CLICK; PATH: first point */
+    int32_t  y;
+    uint32_t offset;  /* nn_action_queue_payload: text, NUL-separated keys, points */
+    uint32_t count;   /* bytes (TYPE, key name), keys (SHORTCUT), points (PATH) */
+    double   seconds; /* MOVE duration, TYPE interval, PATH step, WAIT, SYNC */
+} nn_action;
+
+NN_API nn_status nn_action_queue_create(nn_action_queue** out);
+NN_API void      nn_action_queue_free(nn_action_queue* queue);
+NN_API void      nn_action_queue_clear(nn_action_queue* queue);
+
+/* Records queued / payload bytes in use */
+NN_API size_t    nn_action_queue_size(const nn_action_queue* queue);
+NN_API size_t    nn_action_queue_bytes(const nn_action_queue* queue);
+
+/* action: NN_KEY_*; repeat >= 1 */
+NN_API nn_status nn_action_queue_key(nn_action_queue* queue, uint32_t lane, const char* key,
+                                     uint32_t action, uint32_t repeat);
+NN_API nn_status nn_action_queue_type(nn_action_queue* queue, uint32_t lane, const char* text, size_t len,
+                                      double interval_seconds);
+NN_API nn_status nn_action_queue_shortcut(nn_action_queue* queue, uint32_t lane,
+                                          const char* const* keys, uint32_t count);
+NN_API nn_status nn_action_queue_move(nn_action_queue* queue, uint32_t lane, int32_t x, int32_t y,
+                                      double seconds);
+NN_API nn_status nn_action_queue_click(nn_action_queue* queue, uint32_t lane, int32_t x, int32_t y,
+                                       uint32_t button);
+NN_API nn_status nn_action_queue_path(nn_action_queue* queue, uint32_t lane, const nn_point* points,
+                                      uint32_t count, double step_seconds);
+NN_API nn_status nn_action_queue_wait(nn_action_queue* queue, uint32_t lane, double seconds);
+/* Barrier across lanes; back-to-back syncs fold into one record */
+NN_API nn_status nn_action_queue_sync(nn_action_queue* queue, double seconds);
+
+/* Valid until the next call that modifies the queue */
+NN_API const nn_action* nn_action_queue_records(const nn_action_queue* queue, size_t* count);
+NN_API const void*      nn_action_queue_payload(const nn_action_queue* queue, uint32_t offset);
+
+/* Removes one lane's records (after its device executed); the arena is
+ * reset once only syncs are left. */
+NN_API nn_status nn_action_queue_drop_lane(nn_action_queue* queue, uint32_t lane);
+
+NN_API nn_status nn_action_queue_schedule(const nn_action_queue* queue, nn_timeline* timeline);
+/* The batch is left empty, also on error */
+NN_API nn_status nn_action_queue_execute(const nn_action_queue* queue, uint32_t lane,
+                                         nn_input_batch* batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NEURO_NATIVE_H */
@@ -0,0 +1,346 @@
+#include "action_queue.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "scheduler.hpp"
+
+namespace neuro {
+
+Action& ActionQueue::push(uint16_t code, uint32_t lane) {
+    Action record{};
+    record.code = code;
+    record.lane = static_cast<uint16_t>(lane);
+    records_.push_back(record);
+    return records_.back();
+}
+
+uint32_t ActionQueue::store(const void* data, size_t bytes, size_t align) {
+    return static_cast<uint32_t>(arena_.copy(data, bytes, align));
+}
+
+// Payload offsets are 32-bit.
+static bool fits(size_t used, size_t bytes) {
+    return bytes <= std::numeric_limits<uint32_t>::max() - used - BumpArena::kAlign;
+}
+
+// =====================================================
+// Coalescing
+//
+// Only into the very last record, so the order across lanes (which the
+// fallbacks replay sequentially) never changes.
+// =====================================================
+
+// Text a tapped key types exactly like, on every backend, as long as the
+// text options are the defaults (InputInjector::types_keys): names that
+// resolve as keys before characters only where they mean the same.
+static std::string_view text_of_key(std::string_view name) {
+    if (name == "enter" || name == "return" || name == "\n" || name == "\r") return "\n";
+    if (name == "tab" || name == "\t") return "\t";
+    if (name == "space" || name == " ") return " ";
+    if (name.size() == 1 && ((name[0] >= 'a' && name[0] <= 'z') || (name[0] >= '0' && name[0] <= '9'))) {
+        return name;
+    }
+    return {};
+}
+
+Action* ActionQueue::last(uint16_t code, uint32_t lane) {
+    if (records_.empty() || records_.back().code != code || records_.back().lane != lane) {
+        return nullptr;
+    }
+    return &records_.back();
+}
+
+// A TYPE whose text ends the arena, so more can be appended in place.
+Action* ActionQueue::open_text(uint32_t lane, double interval_seconds) {
+    Action* record = last(NN_OP_TYPE, lane);
+    if (!record || record->seconds != interval_seconds
+        || static_cast<size_t>(record->offset) + record->count != arena_.used()) {
+        return nullptr;
+    }
+    return record;
+}
+
+Status ActionQueue::key(uint32_t lane, std::string_view name, uint32_t action, uint32_t repeat) {
+    if (lane >= kSyncLane || action > NN_KEY_UP || repeat == 0 || !fits(arena_.used(), name.size() + 1)) {
+        return Status::InvalidArgument;
+    }
+    static const uint16_t kCodes[] = {NN_OP_PRESS, NN_OP_HOLD, NN_OP_RELEASE};
+
+    if (action == NN_KEY_TAP) {
+        // Same key again: one more repeat.
+        Action* press = last(NN_OP_PRESS, lane);
+        if (press && press->arg <= std::numeric_limits<uint32_t>::max() - repeat
+            && std::string_view(reinterpret_cast<const char*>(arena_.at(press->offset)), press->count) == name) {
+            press->arg += repeat;
+            return Status::Ok;
+        }
+
+        // A key that types a character, right after text (any interval).
+        // Pasted or Unicode text would send it as something else.
+        std::string_view text = InputInjector::instance().types_keys() ? text_of_key(name) : std::string_view();
+        Action* typed = text.empty() ? nullptr : last(NN_OP_TYPE, lane);
+        if (typed && open_text(lane, typed->seconds) && fits(arena_.used(), text.size() * repeat)) {
+            for (uint32_t i = 0; i < repeat; ++i) {
+                arena_.copy(text.data(), text.size());
+            }
+            typed->count += static_cast<uint32_t>(text.size() * repeat);
+            return Status::Ok;
+        }
+    }
+
+    uint32_t offset = store(name.data(), name.size(), 1);
+    arena_.copy("", 1);
+
+    Action& record = push(kCodes[action], lane);
+    record.arg    = repeat;
+    record.offset = offset;
+    record.count  = static_cast<uint32_t>(name.size());
+    return Status::Ok;
+}
+
+Status ActionQueue::type(uint32_t lane, std::string_view utf8, double interval_seconds) {
+    if (lane >= kSyncLane || !std::isfinite(interval_seconds) || !fits(arena_.used(), utf8.size())) {
+        return Status::InvalidArgument;
+    }
+    if (Action* typed = open_text(lane, interval_seconds)) {
+        arena_.copy(utf8.data(), utf8.size());
+        typed->count += static_cast<uint32_t>(utf8.size());
+        return Status::Ok;
+    }
+    uint32_t offset = store(utf8.data(), utf8.size(), 1);
+
+    Action& record = push(NN_OP_TYPE, lane);
+    record.offset  = offset;
+    record.count   = static_cast<uint32_t>(utf8.size());
+    record.seconds = interval_seconds;
+    return Status::Ok;
+}
+
+// Keys are stored back to back, each NUL-terminated.
+Status ActionQueue::shortcut(uint32_t lane, const char* const* keys, uint32_t count) {
+    if (lane >= kSyncLane || (!keys && count)) {
+        return Status::InvalidArgument;
+    }
+    size_t total = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!keys[i]) {
+            return Status::InvalidArgument;
+        }
+        total += std::strlen(keys[i]) + 1;
+    }
+    if (!fits(arena_.used(), total)) {
+        return Status::InvalidArgument;
+    }
+
+    uint32_t offset = static_cast<uint32_t>(arena_.allocate(total));
+    uint8_t* out = arena_.at(offset);
+    for (uint32_t i = 0; i < count; ++i) {
+        size_t len = std::strlen(keys[i]) + 1;
+        std::memcpy(out, keys[i], len);
+        out += len;
+    }
+
+    Action& record = push(NN_OP_SHORTCUT, lane);
+    record.offset = offset;
+    record.count  = count;
+    return Status::Ok;
+}
+
+Status ActionQueue::move(uint32_t lane, int32_t x, int32_t y, double seconds) {
+    if (lane >= kSyncLane || !std::isfinite(seconds)) {
+        return Status::InvalidArgument;
+    }
+    Action& record = push(NN_OP_MOVE, lane);
+    record.x       = x;
+    record.y       = y;
+    record.seconds = seconds;
+    return Status::Ok;
+}
+
+Status ActionQueue::click(uint32_t lane, int32_t x, int32_t y, uint32_t button) {
+    if (lane >= kSyncLane) {
+        return Status::InvalidArgument;
+    }
+    Action& record = push(NN_OP_CLICK, lane);
+    record.x   = x;
+    record.y   = y;
+    record.arg = button;
+    return Status::Ok;
+}
+
+Status ActionQueue::path(uint32_t lane, const nn_point* points, uint32_t count, double step_seconds) {
+    if (lane >= kSyncLane || (!points && count) || !std::isfinite(step_seconds)
+        || !fits(arena_.used(), static_cast<size_t>(count) * sizeof(nn_point))) {
+        return Status::InvalidArgument;
+    }
+    uint32_t offset = store(points, static_cast<size_t>(count) * sizeof(nn_point), alignof(nn_point));
+
+    Action& record = push(NN_OP_PATH, lane);
+    record.x       = count ? points[0].x : 0;
+    record.y       = count ? points[0].y : 0;
+    record.offset  = offset;
+    record.count   = count;
+    record.seconds = step_seconds;
+    return Status::Ok;
+}
+
+Status ActionQueue::wait(uint32_t lane, double seconds) {
+    if (lane >= kSyncLane || !std::isfinite(seconds)) {
+        return Status::InvalidArgument;
+    }
+    push(NN_OP_WAIT, lane).seconds = seconds;
+    return Status::Ok;
+}
+
+void ActionQueue::sync(double seconds) {
+    seconds = std::isfinite(seconds) ? std::max(0.0, seconds) : 0.0;
+    if (!records_.empty() && records_.back().code == NN_OP_SYNC) {
+        records_.back().seconds += seconds;
+        return;
+    }
+    push(NN_OP_SYNC, kSyncLane).seconds = seconds;
+}
+
+const char* const* ActionQueue::keys(const Action& record) const {
+    scratch_.clear();
+    const char* key = reinterpret_cast<const char*>(arena_.at(record.offset));
+    for (uint32_t i = 0; i < record.count; ++i) {
+        scratch_.push_back(key);
+        key += std::strlen(key) + 1;
+    }
+    return scratch_.data();
+}
+
+static uint32_t key_action(uint16_t code) {
+    return code == NN_OP_HOLD ? NN_KEY_DOWN : code == NN_OP_RELEASE ? NN_KEY_UP : NN_KEY_TAP;
+}
+
+// =====================================================
+// Execution
+// =====================================================
+
+Status ActionQueue::schedule(Timeline& timeline) const {
+    for (const Action& record : records_) {
+        const char* text = reinterpret_cast<const char*>(arena_.at(record.offset));
+        Status status = Status::Ok;
+
+        switch (record.code) {
+            case NN_OP_PRESS:
+            case NN_OP_HOLD:
+            case NN_OP_RELEASE:
+                for (uint32_t i = 0; i < record.arg && status == Status::Ok; ++i) {
+                    status = timeline.key(record.lane, std::string_view(text, record.count),
+                                          key_action(record.code));
+                }
+                break;
+            case NN_OP_TYPE:
+                status = timeline.type(record.lane, std::string_view(text, record.count), record.seconds);
+                break;
+            case NN_OP_SHORTCUT:
+                status = timeline.hotkey(record.lane, keys(record), record.count);
+                break;
+            case NN_OP_MOVE:
+                status = timeline.move(record.lane, record.x, record.y, record.seconds);
+                break;
+            case NN_OP_CLICK:
+                status = timeline.click(record.lane, record.x, record.y, record.arg);
+                break;
+            case NN_OP_PATH:
+                status = timeline.path(record.lane, reinterpret_cast<const nn_point*>(text), record.count,
+                                       record.seconds);
+                break;
+            case NN_OP_WAIT:
+                status = timeline.wait(record.lane, record.seconds);
+                break;
+            case NN_OP_SYNC:
+                timeline.sync(record.seconds);
+                break;
+        }
+        if (status != Status::Ok) {
+            return status;
+        }
+    }
+    return Status::Ok;
+}
+
+Status ActionQueue::execute(uint32_t lane, InputBatch& batch) const {
+    InputInjector& injector = InputInjector::instance();
+    Status status = Status::Ok;
+
+    for (const Action& record : records_) {
+        if (record.lane != lane) {
+            continue;
+        }
+        const char* text = reinterpret_cast<const char*>(arena_.at(record.offset));
+
+        switch (record.code) {
+            case NN_OP_PRESS:
+            case NN_OP_HOLD:
+            case NN_OP_RELEASE:
+                for (uint32_t i = 0; i < record.arg && status == Status::Ok; ++i) {
+                    status = batch.key(std::string_view(text, record.count), key_action(record.code));
+                }
+                break;
+            case NN_OP_TYPE:
+                if (record.seconds <= 0) {
+                    status = batch.type(std::string_view(text, record.count));
+                } else if ((status = batch.send()) == Status::Ok) {
+                    status = injector.type(std::string_view(text, record.count), record.seconds);
+                }
+                break;
+            case NN_OP_SHORTCUT:
+                status = batch.hotkey(keys(record), record.count);
+                break;
+            case NN_OP_MOVE:
+                if (record.seconds <= kMinTweenSeconds) {
+                    status = batch.move(record.x, record.y);
+                } else if ((status = batch.send()) == Status::Ok) {
+                    status = injector.move(record.x, record.y, record.seconds);
+                }
+                break;
+            case NN_OP_CLICK:
+                status = batch.click(record.x, record.y, record.arg);
+                break;
+            case NN_OP_PATH: {
+                auto* points = reinterpret_cast<const nn_point*>(text);
+                if (record.seconds <= 0) {
+                    status = batch.path(points, record.count);
+                } else if ((status = batch.send()) == Status::Ok) {
+                    status = injector.path(points, record.count, record.seconds);
+                }
+                break;
+            }
+            case NN_OP_WAIT:
+                if ((status = batch.send()) == Status::Ok) {
+                    Scheduler::instance().wait(record.seconds);
+                }
+                break;
+        }
+        if (status != Status::Ok) {
+            batch.clear();
+            return status;
+        }
+    }
+    return batch.send();
+}
+
+void ActionQueue::drop_lane(uint32_t lane) {
+    records_.erase(std::remove_if(records_.begin(), records_.end(),
+                                  [lane](const Action& record) { return record.lane == lane; }),
+                   records_.end());
+    // Syncs only order the lanes against each other.
+    if (std::all_of(records_.begin(), records_.end(),
+                    [](const Action& record) { return record.code == NN_OP_SYNC; })) {
+        clear();
+    }
+}
+
+void ActionQueue::clear() {
+    records_.clear();
+    arena_.reset();
+}
+
+} // namespace neuro
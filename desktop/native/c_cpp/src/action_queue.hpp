@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "arena.hpp"
+#include "input.hpp"
+#include "status.hpp"
+#include "timeline.hpp"
+
+namespace neuro {
+
+// ABI-identical view of a queued record (see neuro_native.h).
+using Action = nn_action;
+
+// -------------------------------------------------
+// Controller action queue (C ABI nn_action_queue_*)
+//
+// What the keyboard and mouse controllers queue between executes:
+// fixed-size tagged records in one contiguous array, in the order they
+// were added, with their variable parts (text, key names, points) in a
+// bump arena. clear() keeps both allocations, so a queue reused script
+// after script stops allocating once it has held its largest one.
+//
+// schedule() lays every lane onto a Timeline in queue order; execute()
+// injects one lane through an InputBatch the way the controllers'
+// per-device execute does: untimed events accumulate, waits, tweens and
+// paced paths and paced text send first and then run timed. Not
+// thread-safe.
+//
+// Adjacent records on the same lane coalesce: text appended to text
+// (same interval), a key tapped again, or a key like "enter" or "a"
+// tapped right after text become one record.
+// -------------------------------------------------
+
+class ActionQueue {
+public:
+    static constexpr uint32_t kSyncLane = NN_LANE_COUNT;
+
+    // action: NN_KEY_*; stored as NN_OP_PRESS / HOLD / RELEASE.
+    Status key(uint32_t lane, std::string_view name, uint32_t action, uint32_t repeat);
+    Status type(uint32_t lane, std::string_view utf8, double interval_seconds);
+    Status shortcut(uint32_t lane, const char* const* keys, uint32_t count);
+
+    Status move(uint32_t lane, int32_t x, int32_t y, double seconds);
+    Status click(uint32_t lane, int32_t x, int32_t y, uint32_t button);
+    Status path(uint32_t lane, const nn_point* points, uint32_t count, double step_seconds);
+
+    Status wait(uint32_t lane, double seconds);
+
+    // Barrier across lanes; back-to-back syncs fold into one.
+    void sync(double seconds);
+
+    const std::vector<Action>& records() const { return records_; }
+    const uint8_t* payload(uint32_t offset) const { return arena_.at(offset); }
+    size_t         payload_bytes() const { return arena_.used(); }
+
+    // Every record onto `timeline` (not run).
+    Status schedule(Timeline& timeline) const;
+
+    // One lane's records through `batch`; syncs are skipped. The batch is
+    // left empty, also on failure.
+    Status execute(uint32_t lane, InputBatch& batch) const;
+
+    // Removes one lane's records; the arena is reset once none are left.
+    void drop_lane(uint32_t lane);
+    void clear();
+
+private:
+    Action& push(uint16_t code, uint32_t lane);
+    Action* last(uint16_t code, uint32_t lane);
+    Action* open_text(uint32_t lane, double interval_seconds);
+    uint32_t store(const void* data, size_t bytes, size_t align);
+
+    // Key-name pointers of a SHORTCUT record, in scratch_.
+    const char* const* keys(const Action& record) const;
+
+    std::vector<Action>              records_;
+    BumpArena                        arena_;
+    mutable std::vector<const char*> scratch_;
+};
+
+} // namespace neuro
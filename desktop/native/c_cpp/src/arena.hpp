@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace neuro {
+
+// -------------------------------------------------
+// Bump arena
+//
+// One contiguous block handed out front to back and addressed by
+// offset, so growing it (doubling, contents moved once) never leaves a
+// dangling reference behind. reset() forgets everything but keeps the
+// block: a reused arena allocates nothing once it has seen its largest
+// workload.
+// -------------------------------------------------
+
+class BumpArena {
+public:
+    static constexpr size_t kAlign = alignof(std::max_align_t);
+
+    BumpArena() = default;
+    BumpArena(const BumpArena&) = delete;
+    BumpArena& operator=(const BumpArena&) = delete;
+
+    // Offset of `bytes` bytes aligned to `align` (a power of two, at most
+    // kAlign). The memory is uninitialized.
+    size_t allocate(size_t bytes, size_t align = 1) {
+        size_t offset = (used_ + align - 1) & ~(align - 1);
+        if (offset + bytes > capacity_) {
+            grow(offset + bytes);
+        }
+        used_ = offset + bytes;
+        return offset;
+    }
+
+    // Copies `bytes` bytes in and returns their offset.
+    size_t copy(const void* data, size_t bytes, size_t align = 1) {
+        size_t offset = allocate(bytes, align);
+        if (bytes) {
+            std::memcpy(block_.get() + offset, data, bytes);
+        }
+        return offset;
+    }
+
+    uint8_t*       at(size_t offset) { return block_.get() + offset; }
+    const uint8_t* at(size_t offset) const { return block_.get() + offset; }
+
+    void   reset() { used_ = 0; }
+    size_t used() const { return used_; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    void grow(size_t needed) {
+        size_t capacity = capacity_ ? capacity_ : 4096;
+        while (capacity < needed) {
+            capacity *= 2;
+        }
+        // operator new[] storage is aligned for any fundamental type.
+        std::unique_ptr<uint8_t[]> block(new uint8_t[capacity]);
+        if (used_) {
+            std::memcpy(block.get(), block_.get(), used_);
+        }
+        block_    = std::move(block);
+        capacity_ = capacity;
+    }
+
+    std::unique_ptr<uint8_t[]> block_;
+    size_t                     used_     = 0;
+    size_t                     capacity_ = 0;
+};
+
+} // namespace neuro
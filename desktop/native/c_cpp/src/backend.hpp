@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+#include "neuro_native.h"
+
+namespace neuro {
+
+// -------------------------------------------------
+// Platform family of this build (CMake NEURO_BACKEND, C ABI nn_backend)
+//
+// The family decides which src/platform/<os>/ file implements each
+// Platform* class, so calls into a backend are plain direct calls.
+// Shared code whose path depends on the family tests these constants
+// with `if constexpr`, and a build carries only its own path.
+// -------------------------------------------------
+
+enum class Backend : uint32_t {
+    Null   = NN_BACKEND_NULL,
+    Win32  = NN_BACKEND_WIN32,
+    X11    = NN_BACKEND_X11,
+    Uinput = NN_BACKEND_UINPUT,
+};
+
+#if defined(NEURO_BACKEND_ID)
+inline constexpr Backend kBackend = static_cast<Backend>(NEURO_BACKEND_ID);
+#else
+inline constexpr Backend kBackend = Backend::Null;
+#endif
+
+// Whether the family's injection backend can ever type characters off
+// the keyboard layout (InputEvent::Kind::Unicode) or own the clipboard.
+// uinput only knows evdev key codes and has no display connection.
+inline constexpr bool kInjectsUnicode = kBackend == Backend::Win32 || kBackend == Backend::X11;
+inline constexpr bool kOwnsClipboard  = kBackend == Backend::Win32 || kBackend == Backend::X11;
+
+} // namespace neuro
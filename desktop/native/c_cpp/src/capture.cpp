@@ -0,0 +1,248 @@
+#include "capture.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "clock.hpp"
+#include "metrics.hpp"
+
+namespace neuro {
+
+Status CaptureSession::open(const CaptureOptions& options, std::unique_ptr<CaptureSession>& out) {
+    uint32_t slots = options.ring_slots ? options.ring_slots : 3;
+    if (slots < 2 || slots > 16) {
+        return Status::InvalidArgument;
+    }
+
+    std::unique_ptr<CaptureSession> session(new CaptureSession());
+
+    Status status = session->platform_.open(options, slots);
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    session->slots_.reset(new FrameSlot[slots]);
+    session->slot_count_ = slots;
+
+    out = std::move(session);
+    return Status::Ok;
+}
+
+Status CaptureSession::grab(uint32_t timeout_ms, Frame& out) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return grab_locked(timeout_ms, out, false);
+}
+
+Status CaptureSession::grab_damage(uint32_t timeout_ms, uint32_t tile_size, Frame& out,
+                                   Rect* rects, uint32_t max_rects, uint32_t& rect_count) {
+    rect_count = 0;
+    if (tile_size < 8 || tile_size > 1024 || (!rects && max_rects)) {
+        return Status::InvalidArgument;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    Status status = grab_locked(timeout_ms, out, true);
+    if (status != Status::Ok || (out.flags & NN_FRAME_UNCHANGED)) {
+        return status;
+    }
+
+    // Tile grid (only reallocated when the tile size or resolution changes)
+    int32_t tiles_x = (out.width + tile_size - 1) / tile_size;
+    int32_t tiles_y = (out.height + tile_size - 1) / tile_size;
+    if (tile_size != tile_size_ || tiles_x != tiles_x_ || tiles_y != tiles_y_) {
+        tile_size_ = tile_size;
+        tiles_x_   = tiles_x;
+        tiles_y_   = tiles_y;
+        tile_map_.assign(static_cast<size_t>(tiles_x) * tiles_y, 0);
+    } else {
+        std::fill(tile_map_.begin(), tile_map_.end(), 0);
+    }
+
+    const FrameSlot* previous = previous_ >= 0 ? &slots_[previous_] : nullptr;
+    bool full = !previous
+             || previous->width != out.width
+             || previous->height != out.height;
+
+    if (!full && os_damage_reported_) {
+        for (const Rect& rect : os_damage_) {
+            mark_rect(rect, out.width, out.height);
+        }
+    } else if (!full) {
+        diff_tiles(*previous, slots_[out.slot]);
+    }
+
+    uint32_t runs = full ? max_rects + 1 : emit_runs(out.width, out.height, rects, max_rects);
+    if (runs > max_rects) {
+        out.flags |= NN_FRAME_FULL_DAMAGE;
+        if (max_rects == 0) {
+            return Status::Ok;
+        }
+        rects[0] = Rect{0, 0, out.width, out.height};
+        runs = 1;
+    }
+
+    rect_count = runs;
+    return Status::Ok;
+}
+
+Status CaptureSession::grab_locked(uint32_t timeout_ms, Frame& out, bool want_damage) {
+    ScopedSpan span(NN_METRIC_CAPTURE_FRAME);
+
+    previous_ = latest_;
+    os_damage_reported_ = false;
+
+    int slot = pick_write_slot();
+    if (slot < 0) {
+        // Every slot is leased; hand out the newest one again rather than
+        // stalling the caller.
+        if (latest_ < 0) {
+            return Status::Busy;
+        }
+        lease(static_cast<uint32_t>(latest_), NN_FRAME_UNCHANGED, out);
+        return Status::Ok;
+    }
+
+    FrameSlot& target = slots_[slot];
+    Status status = platform_.grab(static_cast<uint32_t>(slot), timeout_ms, target,
+                                   want_damage ? &os_damage_ : nullptr,
+                                   &os_damage_reported_);
+
+    if (status == Status::Timeout && latest_ >= 0) {
+        lease(static_cast<uint32_t>(latest_), NN_FRAME_UNCHANGED, out);
+        return Status::Ok;
+    }
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    target.sequence     = ++sequence_;
+    target.timestamp_ns = monotonic_ns();
+    latest_ = slot;
+
+    lease(static_cast<uint32_t>(slot), 0, out);
+    return Status::Ok;
+}
+
+Status CaptureSession::release(uint32_t slot) {
+    if (slot >= slot_count_) {
+        return Status::InvalidArgument;
+    }
+
+    std::atomic<uint32_t>& leases = slots_[slot].leases;
+    uint32_t current = leases.load(std::memory_order_relaxed);
+    while (current != 0) {
+        if (leases.compare_exchange_weak(current, current - 1, std::memory_order_release)) {
+            return Status::Ok;
+        }
+    }
+    return Status::InvalidArgument;
+}
+
+// Oldest free slot that is not the latest frame (which readers may still
+// be about to lease).
+int CaptureSession::pick_write_slot() const {
+    int best = -1;
+    for (uint32_t i = 0; i < slot_count_; ++i) {
+        if (static_cast<int>(i) == latest_) continue;
+        if (slots_[i].leases.load(std::memory_order_acquire) != 0) continue;
+
+        if (best < 0 || slots_[i].sequence < slots_[best].sequence) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+void CaptureSession::lease(uint32_t slot, uint32_t flags, Frame& out) {
+    FrameSlot& source = slots_[slot];
+    source.leases.fetch_add(1, std::memory_order_acq_rel);
+
+    out.data         = source.data;
+    out.width        = source.width;
+    out.height       = source.height;
+    out.stride       = source.stride;
+    out.slot         = slot;
+    out.flags        = flags;
+    out.sequence     = source.sequence;
+    out.timestamp_ns = source.timestamp_ns;
+}
+
+// -------------------------------------------------
+// Damage tracking
+// -------------------------------------------------
+
+void CaptureSession::mark_rect(const Rect& rect, int32_t width, int32_t height) {
+    int32_t x0 = std::max(rect.x, 0);
+    int32_t y0 = std::max(rect.y, 0);
+    int32_t x1 = std::min(rect.x + rect.width, width);
+    int32_t y1 = std::min(rect.y + rect.height, height);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    int32_t tile = static_cast<int32_t>(tile_size_);
+    for (int32_t ty = y0 / tile; ty <= (y1 - 1) / tile; ++ty) {
+        uint8_t* row = &tile_map_[static_cast<size_t>(ty) * tiles_x_];
+        std::fill(row + x0 / tile, row + (x1 - 1) / tile + 1, uint8_t{1});
+    }
+}
+
+// Fallback when the OS keeps no dirty list: compare every tile of the new
+// frame against the previous one, stopping at the first differing row.
+void CaptureSession::diff_tiles(const FrameSlot& previous, const FrameSlot& current) {
+    int32_t tile = static_cast<int32_t>(tile_size_);
+
+    for (int32_t ty = 0; ty < tiles_y_; ++ty) {
+        int32_t y0 = ty * tile;
+        int32_t y1 = std::min(y0 + tile, current.height);
+
+        for (int32_t tx = 0; tx < tiles_x_; ++tx) {
+            int32_t x0    = tx * tile;
+            size_t  bytes = static_cast<size_t>(std::min(tile, current.width - x0)) * 4;
+
+            for (int32_t y = y0; y < y1; ++y) {
+                const uint8_t* a = previous.data + static_cast<size_t>(y) * previous.stride + x0 * 4;
+                const uint8_t* b = current.data + static_cast<size_t>(y) * current.stride + x0 * 4;
+                if (std::memcmp(a, b, bytes) != 0) {
+                    tile_map_[static_cast<size_t>(ty) * tiles_x_ + tx] = 1;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Merges horizontally adjacent dirty tiles into one rect per run. Returns
+// the number of runs found, which may exceed max_rects (only the first
+// max_rects are written).
+uint32_t CaptureSession::emit_runs(int32_t width, int32_t height, Rect* rects, uint32_t max_rects) const {
+    int32_t  tile  = static_cast<int32_t>(tile_size_);
+    uint32_t count = 0;
+
+    for (int32_t ty = 0; ty < tiles_y_; ++ty) {
+        const uint8_t* row = &tile_map_[static_cast<size_t>(ty) * tiles_x_];
+
+        for (int32_t tx = 0; tx < tiles_x_;) {
+            if (!row[tx]) {
+                ++tx;
+                continue;
+            }
+
+            int32_t start = tx;
+            while (tx < tiles_x_ && row[tx]) ++tx;
+
+            if (count < max_rects) {
+                Rect& rect  = rects[count];
+                rect.x      = start * tile;
+                rect.y      = ty * tile;
+                rect.width  = std::min(tx * tile, width) - rect.x;
+                rect.height = std::min(rect.y + tile, height) - rect.y;
+            }
+            ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace neuro
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "status.hpp"
+
+namespace neuro {
+
+struct Rect {
+    int32_t x      = 0;
+    int32_t y      = 0;
+    int32_t width  = 0;
+    int32_t height = 0;
+};
+
+struct CaptureOptions {
+    int32_t  output     = 0;
+    uint32_t ring_slots = 3;
+};
+
+// One preallocated buffer of the capture ring. The pixel storage itself
+// is owned by the platform backend (shm segment, mapped staging texture),
+// so a grab writes straight into memory the caller can read.
+struct FrameSlot {
+    const uint8_t* data   = nullptr;
+    int32_t  width        = 0;
+    int32_t  height       = 0;
+    int32_t  stride       = 0;
+    uint64_t sequence     = 0;
+    uint64_t timestamp_ns = 0;
+
+    std::atomic<uint32_t> leases{0};
+};
+
+// Borrowed view of a leased slot (see CaptureSession::release).
+struct Frame {
+    const uint8_t* data   = nullptr;
+    int32_t  width        = 0;
+    int32_t  height       = 0;
+    int32_t  stride       = 0;
+    uint32_t slot         = 0;
+    uint32_t flags        = 0;
+    uint64_t sequence     = 0;
+    uint64_t timestamp_ns = 0;
+};
+
+// -------------------------------------------------
+// Platform half of a session
+//
+// Exactly one implementation is compiled into the library
+// (src/platform/<os>/capture_*.cpp), so there is no runtime dispatch.
+// -------------------------------------------------
+
+class PlatformCapture {
+public:
+    PlatformCapture();
+    ~PlatformCapture();
+
+    PlatformCapture(const PlatformCapture&) = delete;
+    PlatformCapture& operator=(const PlatformCapture&) = delete;
+
+    Status open(const CaptureOptions& options, uint32_t slots);
+
+    int32_t width() const;
+    int32_t height() const;
+
+    // Captures the output into `slot`, filling data/width/height/stride.
+    // Returns Timeout when the OS reports nothing new within timeout_ms.
+    //
+    // When `damage` is non-null and the OS tracks dirty regions, the
+    // changed rectangles since the previous grab are written to it and
+    // `*damage_reported` is set; otherwise the session diffs tiles itself.
+    Status grab(uint32_t slot, uint32_t timeout_ms, FrameSlot& out,
+                std::vector<Rect>* damage, bool* damage_reported);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// -------------------------------------------------
+// Persistent capture session
+// -------------------------------------------------
+
+class CaptureSession {
+public:
+    static Status open(const CaptureOptions& options, std::unique_ptr<CaptureSession>& out);
+
+    // Grabs into a free ring slot and leases it to the caller. When the
+    // OS has nothing new, the latest frame is leased again with
+    // NN_FRAME_UNCHANGED set. No allocation happens after open().
+    Status grab(uint32_t timeout_ms, Frame& out);
+
+    // Damage-only grab: leases the frame like grab() and writes the
+    // tile-aligned regions that changed since the previous grab into
+    // `rects` (horizontal runs of dirty tiles, at most max_rects). The
+    // first grab, a resize or an overflow reports the whole frame with
+    // NN_FRAME_FULL_DAMAGE set. An unchanged frame reports zero rects.
+    Status grab_damage(uint32_t timeout_ms, uint32_t tile_size, Frame& out,
+                       Rect* rects, uint32_t max_rects, uint32_t& rect_count);
+
+    // Returns a leased slot to the ring.
+    Status release(uint32_t slot);
+
+    int32_t width() const { return platform_.width(); }
+    int32_t height() const { return platform_.height(); }
+
+private:
+    CaptureSession() = default;
+
+    Status grab_locked(uint32_t timeout_ms, Frame& out, bool want_damage);
+    int    pick_write_slot() const;
+    void   lease(uint32_t slot, uint32_t flags, Frame& out);
+
+    void   mark_rect(const Rect& rect, int32_t width, int32_t height);
+    void   diff_tiles(const FrameSlot& previous, const FrameSlot& current);
+    uint32_t emit_runs(int32_t width, int32_t height, Rect* rects, uint32_t max_rects) const;
+
+    PlatformCapture              platform_;
+    std::unique_ptr<FrameSlot[]> slots_;
+    uint32_t                     slot_count_ = 0;
+    int                          latest_     = -1;
+    uint64_t                     sequence_   = 0;
+    std::mutex                   mutex_;
+
+    // Damage tracking scratch (reused across grabs)
+    std::vector<Rect>    os_damage_;
+    bool                 os_damage_reported_ = false;
+    int                  previous_           = -1;
+    uint32_t             tile_size_          = 0;
+    int32_t              tiles_x_            = 0;
+    int32_t              tiles_y_            = 0;
+    std::vector<uint8_t> tile_map_;
+};
+
+} // namespace neuro
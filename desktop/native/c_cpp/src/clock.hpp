@@ -0,0 +1,22 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace neuro {
+
+// Monotonic nanoseconds (QPC on Windows, CLOCK_MONOTONIC elsewhere).
+inline uint64_t monotonic_ns() {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(
+        duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+// Wall-clock nanoseconds since the Unix epoch (persisted timestamps).
+inline uint64_t unix_ns() {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(
+        duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count());
+}
+
+} // namespace neuro
@@ -0,0 +1,213 @@
+#include "codec.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(NEURO_HAVE_JPEG)
+#include <csetjmp>
+#include <cstdio>
+#include <jpeglib.h>
+#endif
+
+#if defined(NEURO_HAVE_WEBP)
+#include <webp/encode.h>
+#endif
+
+namespace neuro {
+
+bool codec_available(Codec codec) {
+    switch (codec) {
+    case Codec::Raw:
+        return true;
+    case Codec::Jpeg:
+#if defined(NEURO_HAVE_JPEG)
+        return true;
+#else
+        return false;
+#endif
+    case Codec::Webp:
+#if defined(NEURO_HAVE_WEBP)
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+// =====================================================
+// JPEG (libjpeg-turbo)
+// =====================================================
+
+#if defined(NEURO_HAVE_JPEG)
+
+struct ImageEncoder::Jpeg {
+    // error_exit must not return; it jumps back into jpeg().
+    struct Error {
+        jpeg_error_mgr manager;
+        std::jmp_buf   jump;
+    };
+
+    // Destination writing into a std::vector, grown by doubling.
+    struct Destination {
+        jpeg_destination_mgr manager;
+        std::vector<uint8_t>* out;
+    };
+
+    jpeg_compress_struct cinfo;
+    Error                error;
+    Destination          destination;
+
+    Jpeg() {
+        cinfo.err = jpeg_std_error(&error.manager);
+        error.manager.error_exit = [](j_common_ptr info) {
+            std::longjmp(reinterpret_cast<Error*>(info->err)->jump, 1);
+        };
+        jpeg_create_compress(&cinfo);
+
+        destination.out = nullptr;
+        destination.manager.init_destination = [](j_compress_ptr info) {
+            auto* self = reinterpret_cast<Destination*>(info->dest);
+            self->out->resize(std::max<size_t>(self->out->capacity(), 64 * 1024));
+            self->manager.next_output_byte = self->out->data();
+            self->manager.free_in_buffer   = self->out->size();
+        };
+        destination.manager.empty_output_buffer = [](j_compress_ptr info) -> boolean {
+            auto*  self = reinterpret_cast<Destination*>(info->dest);
+            size_t used = self->out->size();
+            self->out->resize(used * 2);
+            self->manager.next_output_byte = self->out->data() + used;
+            self->manager.free_in_buffer   = self->out->size() - used;
+            return TRUE;
+        };
+        destination.manager.term_destination = [](j_compress_ptr info) {
+            auto* self = reinterpret_cast<Destination*>(info->dest);
+            self->out->resize(self->out->size() - self->manager.free_in_buffer);
+        };
+        cinfo.dest = &destination.manager;
+    }
+
+    ~Jpeg() { jpeg_destroy_compress(&cinfo); }
+};
+
+Status ImageEncoder::jpeg(const ImageView& image, int quality, std::vector<uint8_t>& out) {
+    if (!jpeg_) {
+        jpeg_.reset(new Jpeg());
+    }
+    Jpeg& state = *jpeg_;
+    jpeg_compress_struct& cinfo = state.cinfo;
+
+    if (setjmp(state.error.jump)) {
+        jpeg_abort_compress(&cinfo);
+        out.clear();
+        return Status::Failed;
+    }
+
+    state.destination.out = &out;
+    cinfo.image_width  = static_cast<JDIMENSION>(image.width);
+    cinfo.image_height = static_cast<JDIMENSION>(image.height);
+#if defined(JCS_EXTENSIONS)
+    cinfo.input_components = 4;
+    cinfo.in_color_space   = JCS_EXT_BGRX;
+#else
+    cinfo.input_components = 3;
+    cinfo.in_color_space   = JCS_RGB;
+    row_.resize(static_cast<size_t>(image.width) * 3);
+#endif
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    cinfo.dct_method = JDCT_ISLOW;
+    jpeg_start_compress(&cinfo, TRUE);
+
+    while (cinfo.next_scanline < cinfo.image_height) {
+        const uint8_t* src = image.data + static_cast<size_t>(cinfo.next_scanline) * image.stride;
+#if defined(JCS_EXTENSIONS)
+        JSAMPROW row = const_cast<JSAMPROW>(src);
+#else
+        kernels().bgra_to_rgb(src, image.stride, row_.data(), static_cast<int32_t>(row_.size()),
+                              image.width, 1);
+        JSAMPROW row = row_.data();
+#endif
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+
+    jpeg_finish_compress(&cinfo);
+    return Status::Ok;
+}
+
+#else
+
+struct ImageEncoder::Jpeg {};
+
+Status ImageEncoder::jpeg(const ImageView&, int, std::vector<uint8_t>&) {
+    return Status::Unavailable;
+}
+
+#endif
+
+// =====================================================
+// WebP (libwebp)
+// =====================================================
+
+#if defined(NEURO_HAVE_WEBP)
+
+Status ImageEncoder::webp(const ImageView& image, int quality, std::vector<uint8_t>& out) {
+    WebPConfig config;
+    WebPPicture picture;
+    if (!WebPConfigInit(&config) || !WebPPictureInit(&picture)) {
+        return Status::Failed;
+    }
+    config.quality = static_cast<float>(quality);
+    config.method  = 2; // speed over size: frames are sent continuously
+
+    picture.width      = image.width;
+    picture.height     = image.height;
+    picture.use_argb   = 1;
+    picture.custom_ptr = &out;
+    picture.writer     = [](const uint8_t* data, size_t size, const WebPPicture* pic) -> int {
+        auto* sink = static_cast<std::vector<uint8_t>*>(pic->custom_ptr);
+        sink->insert(sink->end(), data, data + size);
+        return 1;
+    };
+
+    out.clear();
+    bool ok = WebPPictureImportBGRX(&picture, image.data, image.stride)
+           && WebPEncode(&config, &picture);
+    WebPPictureFree(&picture);
+    return ok ? Status::Ok : Status::Failed;
+}
+
+#else
+
+Status ImageEncoder::webp(const ImageView&, int, std::vector<uint8_t>&) {
+    return Status::Unavailable;
+}
+
+#endif
+
+// =====================================================
+// Dispatch
+// =====================================================
+
+ImageEncoder::ImageEncoder() = default;
+ImageEncoder::~ImageEncoder() = default;
+
+Status ImageEncoder::encode(Codec codec, const ImageView& image, int quality, std::vector<uint8_t>& out) {
+    switch (codec) {
+    case Codec::Raw: {
+        size_t row = static_cast<size_t>(image.width) * 4;
+        out.resize(row * image.height);
+        for (int32_t y = 0; y < image.height; ++y) {
+            std::memcpy(out.data() + row * y, image.data + static_cast<size_t>(y) * image.stride, row);
+        }
+        return Status::Ok;
+    }
+    case Codec::Jpeg:
+        return jpeg(image, quality, out);
+    case Codec::Webp:
+        return webp(image, quality, out);
+    }
+    return Status::InvalidArgument;
+}
+
+} // namespace neuro
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "kernels.hpp"
+#include "status.hpp"
+
+namespace neuro {
+
+enum class Codec : uint32_t {
+    Raw  = NN_CODEC_RAW,
+    Jpeg = NN_CODEC_JPEG,
+    Webp = NN_CODEC_WEBP,
+};
+
+// Whether the codec was compiled in (libjpeg-turbo / libwebp found at
+// configure time). Raw is always available.
+bool codec_available(Codec codec);
+
+// -------------------------------------------------
+// Still-image encoder for BGRA frames
+//
+// One per worker thread: the codec state is created once and reused, and
+// the output is written straight into a caller-owned vector that keeps
+// its capacity between frames.
+// -------------------------------------------------
+
+class ImageEncoder {
+public:
+    ImageEncoder();
+    ~ImageEncoder();
+
+    ImageEncoder(const ImageEncoder&) = delete;
+    ImageEncoder& operator=(const ImageEncoder&) = delete;
+
+    // Replaces `out` with the encoded image. quality: 1..100. Unavailable
+    // when the codec is not compiled in.
+    Status encode(Codec codec, const ImageView& image, int quality, std::vector<uint8_t>& out);
+
+private:
+    Status jpeg(const ImageView& image, int quality, std::vector<uint8_t>& out);
+    Status webp(const ImageView& image, int quality, std::vector<uint8_t>& out);
+
+    struct Jpeg;
+    std::unique_ptr<Jpeg> jpeg_;
+    std::vector<uint8_t>  row_; // BGRA -> RGB scanline when libjpeg lacks BGRX input
+};
+
+} // namespace neuro
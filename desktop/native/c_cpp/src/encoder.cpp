@@ -0,0 +1,219 @@
+#include "encoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace neuro {
+
+Status FrameEncoder::create(const EncoderOptions& options, std::unique_ptr<FrameEncoder>& out) {
+    if (options.quality < 1 || options.quality > 100 || options.max_width < 0 || options.max_height < 0
+        || options.threads < 1 || options.threads > 16 || options.buffers < 1 || options.buffers > 64
+        || options.filter > Filter::Bilinear) {
+        return Status::InvalidArgument;
+    }
+    if (!codec_available(options.codec)) {
+        return Status::Unavailable;
+    }
+
+    out.reset(new FrameEncoder(options));
+    return Status::Ok;
+}
+
+FrameEncoder::FrameEncoder(const EncoderOptions& options) : options_(options), slots_(options.buffers) {
+    for (uint32_t i = 0; i < options_.threads; ++i) {
+        workers_.emplace_back([this] { work(); });
+    }
+}
+
+FrameEncoder::~FrameEncoder() {
+    close();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+Status FrameEncoder::submit(CaptureSession* source, const Frame& frame, const Rect* rects, uint32_t rect_count) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (closed_) {
+        return Status::Unavailable;
+    }
+
+    auto free = std::find_if(slots_.begin(), slots_.end(), [](const Slot& slot) { return slot.state == State::Free; });
+    if (free == slots_.end()) {
+        return Status::Busy;
+    }
+
+    Slot& slot  = *free;
+    slot.state  = State::Queued;
+    slot.source = source;
+    slot.frame  = frame;
+    slot.rects.assign(rects, rects + rect_count);
+
+    uint32_t id = static_cast<uint32_t>(free - slots_.begin());
+    slot.packet = Packet{};
+    slot.packet.id            = id;
+    slot.packet.codec         = options_.codec;
+    slot.packet.source_width  = frame.width;
+    slot.packet.source_height = frame.height;
+    slot.packet.sequence      = frame.sequence;
+    slot.packet.timestamp_ns  = frame.timestamp_ns;
+
+    queue_.push_back(id);
+    order_.push_back(id);
+    work_.notify_one();
+    return Status::Ok;
+}
+
+Status FrameEncoder::next(Packet& out, int32_t timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto ready = [this] {
+        return order_.empty() ? closed_ : slots_[order_.front()].state == State::Done;
+    };
+    if (timeout_ms < 0) {
+        done_.wait(lock, ready);
+    } else if (!done_.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready)) {
+        return Status::Timeout;
+    }
+
+    if (order_.empty()) {
+        return Status::Unavailable;
+    }
+    Slot& slot = slots_[order_.front()];
+    order_.pop_front();
+    slot.state = State::Delivered;
+    out = slot.packet;
+    return Status::Ok;
+}
+
+Status FrameEncoder::release(uint32_t id) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (id >= slots_.size() || slots_[id].state != State::Delivered) {
+        return Status::InvalidArgument;
+    }
+    slots_[id].state = State::Free;
+    return Status::Ok;
+}
+
+void FrameEncoder::close() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    for (uint32_t id : queue_) {
+        return_lease(slots_[id]);
+        finish(id, Status::Cancelled);
+    }
+    queue_.clear();
+    work_.notify_all();
+    done_.notify_all();
+}
+
+void FrameEncoder::finish(uint32_t id, Status status) {
+    Slot& slot = slots_[id];
+    slot.state         = State::Done;
+    slot.packet.status = status;
+    if (status == Status::Ok) {
+        slot.packet.data       = slot.data.data();
+        slot.packet.size       = slot.data.size();
+        slot.packet.rects      = slot.rects.data();
+        slot.packet.rect_count = static_cast<uint32_t>(slot.rects.size());
+    }
+    done_.notify_all();
+}
+
+void FrameEncoder::return_lease(Slot& slot) {
+    if (slot.source) {
+        slot.source->release(slot.frame.slot);
+        slot.source = nullptr;
+    }
+}
+
+// -------------------------------------------------
+// Workers
+// -------------------------------------------------
+
+void FrameEncoder::work() {
+    // Per worker, reused for every frame it encodes
+    ImageEncoder         codec;
+    std::vector<uint8_t> scaled;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            break; // closed
+        }
+
+        uint32_t id = queue_.front();
+        queue_.pop_front();
+        Slot& slot = slots_[id];
+        slot.state = State::Encoding;
+        lock.unlock();
+
+        // The slot is this worker's until finish(): nobody else touches
+        // a slot in the Encoding state.
+        Status status = encode(slot, codec, scaled);
+        return_lease(slot);
+
+        lock.lock();
+        finish(id, status);
+    }
+}
+
+Status FrameEncoder::encode(Slot& slot, ImageEncoder& codec, std::vector<uint8_t>& scaled) {
+    const Frame& frame = slot.frame;
+    ImageView source{frame.data, frame.width, frame.height, frame.stride};
+    Packet& packet = slot.packet;
+
+    // Damage regions, unscaled, rows packed back to back
+    if (options_.codec == Codec::Raw && !slot.rects.empty()) {
+        size_t total = 0;
+        for (Rect& rect : slot.rects) {
+            int32_t x0 = std::clamp(rect.x, 0, frame.width);
+            int32_t y0 = std::clamp(rect.y, 0, frame.height);
+            rect.width  = std::clamp(rect.x + rect.width, x0, frame.width) - x0;
+            rect.height = std::clamp(rect.y + rect.height, y0, frame.height) - y0;
+            rect.x = x0;
+            rect.y = y0;
+            total += static_cast<size_t>(rect.width) * rect.height * 4;
+        }
+
+        slot.data.resize(total);
+        uint8_t* out = slot.data.data();
+        for (const Rect& rect : slot.rects) {
+            size_t row = static_cast<size_t>(rect.width) * 4;
+            for (int32_t y = rect.y; y < rect.y + rect.height; ++y, out += row) {
+                std::memcpy(out, frame.data + static_cast<size_t>(y) * frame.stride + rect.x * 4, row);
+            }
+        }
+        packet.width  = frame.width;
+        packet.height = frame.height;
+        return Status::Ok;
+    }
+
+    // Fit inside max_width x max_height; only ever shrinks
+    double scale = 1.0;
+    if (options_.max_width && frame.width > options_.max_width) {
+        scale = std::min(scale, static_cast<double>(options_.max_width) / frame.width);
+    }
+    if (options_.max_height && frame.height > options_.max_height) {
+        scale = std::min(scale, static_cast<double>(options_.max_height) / frame.height);
+    }
+
+    ImageView image = source;
+    if (scale < 1.0) {
+        image.width  = std::max(1, static_cast<int32_t>(frame.width * scale + 0.5));
+        image.height = std::max(1, static_cast<int32_t>(frame.height * scale + 0.5));
+        image.stride = image.width * 4;
+        scaled.resize(static_cast<size_t>(image.stride) * image.height);
+        downscale(source, scaled.data(), image.width, image.height, image.stride, options_.filter);
+        image.data = scaled.data();
+    }
+
+    packet.width  = image.width;
+    packet.height = image.height;
+    return codec.encode(options_.codec, image, options_.quality, slot.data);
+}
+
+} // namespace neuro
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "capture.hpp"
+#include "codec.hpp"
+#include "kernels.hpp"
+#include "status.hpp"
+
+namespace neuro {
+
+struct EncoderOptions {
+    Codec    codec      = Codec::Jpeg;
+    int32_t  quality    = 75;  // 1..100, JPEG / WebP
+    int32_t  max_width  = 0;   // downscale to fit, aspect kept; 0 = no limit
+    int32_t  max_height = 0;
+    Filter   filter     = Filter::Box;
+    uint32_t threads    = 2;   // worker threads
+    uint32_t buffers    = 4;   // frames in flight, submitted to released
+};
+
+// A finished frame. data/rects stay valid until FrameEncoder::release(id).
+struct Packet {
+    uint32_t       id            = 0;
+    Status         status        = Status::Ok; // Cancelled when closed before encoding
+    Codec          codec         = Codec::Raw;
+    int32_t        width         = 0;          // encoded size
+    int32_t        height        = 0;
+    int32_t        source_width  = 0;
+    int32_t        source_height = 0;
+    uint64_t       sequence      = 0;
+    uint64_t       timestamp_ns  = 0;
+    const uint8_t* data          = nullptr;
+    size_t         size          = 0;
+    const Rect*    rects         = nullptr;    // damage, source coordinates
+    uint32_t       rect_count    = 0;
+};
+
+// -------------------------------------------------
+// Frame encoder pipeline (C ABI nn_encoder_*)
+//
+// Leased capture frames go in, compressed buffers come out. Workers
+// downscale with the frame kernels and encode with their own codec
+// state; the capture lease is returned as soon as a worker is done with
+// the pixels. Packets come out in submission order whatever worker
+// finished first.
+//
+// Every frame in flight owns one of a fixed set of buffers from submit()
+// until release(), so a caller that stops releasing gets Busy instead of
+// unbounded memory, and a warmed-up pipeline allocates nothing.
+//
+// Raw with damage rects ships just those regions, unscaled: the packet
+// payload is each rect's BGRA rows back to back, in rect order. Without
+// rects (or for JPEG/WebP) the whole frame is scaled and encoded; rects
+// are passed through for the consumer.
+// -------------------------------------------------
+
+class FrameEncoder {
+public:
+    // Unavailable when the codec is not compiled in.
+    static Status create(const EncoderOptions& options, std::unique_ptr<FrameEncoder>& out);
+    ~FrameEncoder(); // close() and join; outstanding packets become invalid
+
+    FrameEncoder(const FrameEncoder&) = delete;
+    FrameEncoder& operator=(const FrameEncoder&) = delete;
+
+    // Takes over the lease on `frame` (released through `source`) when it
+    // returns Ok. With a null source the caller keeps `frame.data` valid
+    // until the packet comes out. Busy when every buffer is in flight,
+    // Unavailable once closed; the lease stays the caller's then.
+    Status submit(CaptureSession* source, const Frame& frame, const Rect* rects, uint32_t rect_count);
+
+    // Oldest submitted frame once it is encoded. Timeout when it isn't
+    // within timeout_ms (< 0 = no limit); Unavailable once closed and
+    // every packet has been handed out.
+    Status next(Packet& out, int32_t timeout_ms);
+
+    // Returns a packet's buffer to the pipeline.
+    Status release(uint32_t id);
+
+    // Stops accepting frames; queued ones come out Cancelled.
+    void close();
+
+private:
+    enum class State : uint8_t { Free, Queued, Encoding, Done, Delivered };
+
+    struct Slot {
+        State             state  = State::Free;
+        CaptureSession*   source = nullptr;
+        Frame             frame;
+        std::vector<Rect> rects;
+        Packet            packet;
+        std::vector<uint8_t> data;
+    };
+
+    explicit FrameEncoder(const EncoderOptions& options);
+
+    void   work();
+    Status encode(Slot& slot, ImageEncoder& codec, std::vector<uint8_t>& scaled);
+    // Caller holds mutex_.
+    void   finish(uint32_t id, Status status);
+    void   return_lease(Slot& slot);
+
+    const EncoderOptions options_;
+
+    std::mutex              mutex_;
+    std::condition_variable work_;
+    std::condition_variable done_;
+    std::vector<Slot>       slots_;
+    std::deque<uint32_t>    queue_; // submitted, not yet picked by a worker
+    std::deque<uint32_t>    order_; // submitted, not yet handed out
+    bool                    closed_ = false;
+
+    std::vector<std::thread> workers_; // last: started once the rest exists
+};
+
+} // namespace neuro
@@ -0,0 +1,199 @@
+#include "executor.hpp"
+
+#include <algorithm>
+
+#include "clock.hpp"
+#include "metrics.hpp"
+#include "scheduler.hpp"
+
+namespace neuro {
+
+ScriptText::ScriptText(ScriptText&& other) noexcept
+    : owned_(std::move(other.owned_)), view_(other.view_), release_(other.release_), user_(other.user_) {
+    other.release_ = nullptr;
+}
+
+ScriptText& ScriptText::operator=(ScriptText&& other) noexcept {
+    if (this != &other) {
+        reset();
+        owned_   = std::move(other.owned_);
+        view_    = other.view_;
+        release_ = other.release_;
+        user_    = other.user_;
+        other.release_ = nullptr;
+    }
+    return *this;
+}
+
+void ScriptText::reset() {
+    if (release_) {
+        release_(user_);
+        release_ = nullptr;
+    }
+}
+
+ActionExecutor::ActionExecutor(const ExecutorOptions& options)
+    : options_(options), thread_([this] { run(); }) {}
+
+ActionExecutor::~ActionExecutor() {
+    close();
+    thread_.join();
+}
+
+Status ActionExecutor::submit(ScriptText text, uint32_t group, uint32_t flags, uint64_t& ticket) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (closed_) {
+        return Status::Unavailable;
+    }
+
+    if (flags & kSupersede) {
+        for (auto it = queue_.begin(); it != queue_.end();) {
+            if (it->group == group) {
+                finish(it->ticket, it->group, Status::Cancelled);
+                it = queue_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    if ((flags & kInterrupt) && running_ && running_group_ == group) {
+        running_->cancel();
+    }
+
+    if (queue_.size() >= std::max<uint32_t>(options_.capacity, 1)) {
+        return Status::Busy;
+    }
+
+    ticket = ++next_ticket_;
+    queue_.push_back(Job{ticket, group, monotonic_ns(), std::move(text)});
+    Metrics::record(NN_METRIC_QUEUE_DEPTH, queue_.size());
+    work_.notify_one();
+    return Status::Ok;
+}
+
+Status ActionExecutor::cancel(uint64_t ticket) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = std::find_if(queue_.begin(), queue_.end(), [&](const Job& job) { return job.ticket == ticket; });
+    if (it != queue_.end()) {
+        finish(it->ticket, it->group, Status::Cancelled);
+        queue_.erase(it);
+        return Status::Ok;
+    }
+    if (running_ && running_ticket_ == ticket) {
+        running_->cancel(); // completes once the run notices
+        return Status::Ok;
+    }
+    return Status::InvalidArgument;
+}
+
+Status ActionExecutor::next(Completion& out, int32_t timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto ready = [this] { return !completions_.empty() || drained(); };
+    if (timeout_ms < 0) {
+        done_.wait(lock, ready);
+    } else if (!done_.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready)) {
+        return Status::Timeout;
+    }
+
+    if (completions_.empty()) {
+        return Status::Unavailable;
+    }
+    out = std::move(completions_.front());
+    completions_.pop_front();
+    return Status::Ok;
+}
+
+void ActionExecutor::close() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    for (const Job& job : queue_) {
+        finish(job.ticket, job.group, Status::Cancelled);
+    }
+    queue_.clear();
+    if (running_) {
+        running_->cancel();
+    }
+    work_.notify_all();
+    done_.notify_all();
+}
+
+size_t ActionExecutor::pending() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return queue_.size() + (running_ ? 1 : 0);
+}
+
+void ActionExecutor::finish(uint64_t ticket, uint32_t group, Status status, ScriptError error) {
+    completions_.push_back(Completion{ticket, group, status, std::move(error)});
+    done_.notify_all();
+}
+
+bool ActionExecutor::drained() const {
+    return closed_ && queue_.empty() && !running_;
+}
+
+void ActionExecutor::run() {
+    const uint64_t stale_ns = wait_ns(options_.stale_seconds);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            break; // closed
+        }
+
+        Job job = std::move(queue_.front());
+        queue_.pop_front();
+        if (stale_ns && monotonic_ns() - job.submitted_ns > stale_ns) {
+            finish(job.ticket, job.group, Status::Cancelled);
+            continue;
+        }
+
+        CancellableRun run;
+        running_        = &run;
+        running_ticket_ = job.ticket;
+        running_group_  = job.group;
+        lock.unlock();
+
+        ScriptError error;
+        uint64_t started = monotonic_ns();
+        Status status = execute(job, run, error);
+        Metrics::span(NN_METRIC_SCRIPT, started, monotonic_ns());
+
+        lock.lock();
+        running_ = nullptr;
+        finish(job.ticket, job.group, status, std::move(error));
+    }
+    done_.notify_all();
+}
+
+Status ActionExecutor::execute(const Job& job, CancellableRun& run, ScriptError& error) {
+    InputBatch&    batch = run.batch();
+    nn_script_host host  = cancellable_script_host(run);
+
+    Status status = stream_script(job.text.view(), host, [&] {
+        if (run.cancelled()) {
+            return Status::Cancelled;
+        }
+        return batch.size() ? batch.send() : Status::Ok;
+    }, error);
+
+    // A cancelled run drops what it batched; anything else sends it, as
+    // nn_script_stream does (lines before a syntax error still run).
+    // Either way a run that stopped early never reached its RELEASEs,
+    // so keys and buttons it left down go back up.
+    if (status == Status::Cancelled || run.cancelled()) {
+        batch.clear();
+        batch.release_held();
+        return Status::Cancelled;
+    }
+    Status sent = batch.send();
+    if (status != Status::Ok || sent != Status::Ok) {
+        batch.release_held();
+    }
+    return status != Status::Ok ? status : sent;
+}
+
+} // namespace neuro
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "input.hpp"
+#include "script.hpp"
+#include "status.hpp"
+
+namespace neuro {
+
+struct ExecutorOptions {
+    uint32_t capacity      = 16;  // queued (not yet running) scripts
+    double   stale_seconds = 0.0; // queued longer than this = cancelled, 0 = never
+};
+
+// Script source: owned, or borrowed from the submitter, who gets it back
+// through `release` once the script has completed.
+class ScriptText {
+public:
+    using Release = void (*)(void* user);
+
+    explicit ScriptText(std::string text) : owned_(std::move(text)) {}
+    ScriptText(std::string_view view, Release release, void* user)
+        : view_(view), release_(release), user_(user) {}
+
+    ScriptText(ScriptText&& other) noexcept;
+    ScriptText& operator=(ScriptText&& other) noexcept;
+    ~ScriptText() { reset(); }
+
+    std::string_view view() const { return release_ ? view_ : std::string_view(owned_); }
+
+private:
+    void reset();
+
+    std::string      owned_;
+    std::string_view view_;
+    Release          release_ = nullptr;
+    void*            user_    = nullptr;
+};
+
+struct Completion {
+    uint64_t    ticket = 0;
+    uint32_t    group  = 0;
+    Status      status = Status::Ok;
+    ScriptError error; // Status::Syntax only
+};
+
+// -------------------------------------------------
+// Action executor (C ABI nn_executor_*)
+//
+// Runs submitted scripts one at a time, in order, on its own thread
+// (streamed and batched like nn_script_stream), so the submitter never
+// waits on injection. The queue is bounded: a full queue refuses new
+// work with Busy. Scripts carry a caller-chosen group; a submission can
+// supersede the queued scripts of its group and interrupt the running
+// one. Every accepted script produces exactly one Completion, cancelled
+// ones included, collected with next().
+// -------------------------------------------------
+
+class ActionExecutor {
+public:
+    static constexpr uint32_t kSupersede = NN_SUBMIT_SUPERSEDE;
+    static constexpr uint32_t kInterrupt = NN_SUBMIT_INTERRUPT;
+
+    explicit ActionExecutor(const ExecutorOptions& options);
+    ~ActionExecutor(); // close() and join
+
+    // Busy when the queue is full, Unavailable once closed. A refused
+    // text is released on the spot.
+    Status submit(ScriptText text, uint32_t group, uint32_t flags, uint64_t& ticket);
+
+    // InvalidArgument for tickets that already completed (or never existed).
+    Status cancel(uint64_t ticket);
+
+    // Timeout when nothing completed within timeout_ms (< 0 = no limit);
+    // Unavailable once closed and every completion has been collected.
+    Status next(Completion& out, int32_t timeout_ms);
+
+    // Stops accepting work and cancels everything queued or running.
+    void close();
+
+    size_t pending() const;
+
+private:
+    struct Job {
+        uint64_t   ticket;
+        uint32_t   group;
+        uint64_t   submitted_ns;
+        ScriptText text;
+    };
+
+    void   run();
+    Status execute(const Job& job, CancellableRun& run, ScriptError& error);
+    // Caller holds mutex_.
+    void   finish(uint64_t ticket, uint32_t group, Status status, ScriptError error = {});
+    bool   drained() const;
+
+    const ExecutorOptions options_;
+
+    mutable std::mutex      mutex_;
+    std::condition_variable work_;
+    std::condition_variable done_;
+    std::deque<Job>         queue_;
+    std::deque<Completion>  completions_;
+    uint64_t                next_ticket_ = 0;
+    bool                    closed_      = false;
+
+    // The running script, if any
+    CancellableRun* running_        = nullptr;
+    uint64_t        running_ticket_ = 0;
+    uint32_t        running_group_  = 0;
+
+    std::thread thread_; // last: starts once everything above exists
+};
+
+} // namespace neuro
@@ -0,0 +1,348 @@
+#include "history.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#include "clock.hpp"
+
+namespace neuro {
+
+namespace {
+
+constexpr char     kMagic[8]       = {'N', 'N', 'H', 'I', 'S', 'T', 0, 0};
+constexpr uint32_t kVersion        = 1;
+constexpr uint32_t kDefaultRecords = 1u << 16;
+constexpr uint32_t kMinRecords     = 256;
+constexpr uint32_t kMaxRecords     = 1u << 24;
+constexpr uint32_t kDefaultKeep    = 4;
+constexpr uint32_t kMaxKeep        = 1000;
+constexpr size_t   kNameBytes      = 32; // x through aux
+constexpr size_t   kNameOffset     = offsetof(Record, x);
+
+static_assert(kNameOffset + kNameBytes == offsetof(Record, reserved), "names fill x..aux");
+
+const Record* records_of(const MappedFile& file) {
+    return reinterpret_cast<const Record*>(file.data() + sizeof(HistoryHeader));
+}
+
+struct Log {
+    Log() {
+        // The built-in ids, named as the Python controller names them.
+        static const struct {
+            uint16_t    id;
+            const char* name;
+        } kBuiltin[] = {
+            {NN_SOURCE_UNKNOWN, "unknown"},
+            {NN_SOURCE_PARSER, "parser"},
+            {NN_SOURCE_KEYBOARD, "keyboard"},
+            {NN_SOURCE_MOUSE, "mouse"},
+            {NN_SOURCE_HOOK, "hook"},
+            {NN_SOURCE_NATIVE, "native"},
+            {NN_TYPE_OP + NN_OP_TYPE, "TYPE"},
+            {NN_TYPE_OP + NN_OP_PRESS, "PRESS"},
+            {NN_TYPE_OP + NN_OP_HOLD, "HOLD"},
+            {NN_TYPE_OP + NN_OP_RELEASE, "RELEASE"},
+            {NN_TYPE_OP + NN_OP_SHORTCUT, "SHORTCUT"},
+            {NN_TYPE_OP + NN_OP_MOVE, "MOVE"},
+            {NN_TYPE_OP + NN_OP_MOVE_N, "MOVE_N"},
+            {NN_TYPE_OP + NN_OP_CLICK, "CLICK"},
+            {NN_TYPE_OP + NN_OP_CLICK_N, "CLICK_N"},
+            {NN_TYPE_OP + NN_OP_CLICK_IMAGE, "CLICK_IMAGE"},
+            {NN_TYPE_OP + NN_OP_PATH, "PATH"},
+            {NN_TYPE_OP + NN_OP_WAIT, "WAIT"},
+        };
+        for (const auto& builtin : kBuiltin) {
+            names.emplace(builtin.id, builtin.name);
+        }
+    }
+
+    std::mutex     mutex;
+    MappedFile     file;
+    HistoryHeader* header  = nullptr;
+    Record*        records = nullptr;
+    std::string    path;
+    HistoryOptions options{};
+    uint64_t       wall_offset = 0; // unix_ns() - monotonic_ns() at start
+    uint64_t       opened_ns   = 0; // monotonic, when the segment was started
+    uint64_t       last_ns     = 0; // latest timestamp written (Unix ns)
+
+    std::map<uint16_t, std::string> names;
+};
+
+// Leaked on purpose: channel pushes may still arrive while statics are
+// torn down.
+Log& history_log() {
+    static Log* instance = new Log;
+    return *instance;
+}
+
+bool exists(const std::string& path) {
+    if (std::FILE* file = std::fopen(path.c_str(), "rb")) {
+        std::fclose(file);
+        return true;
+    }
+    return false;
+}
+
+// path -> path.1 -> path.2 ... ; the one past `keep` is deleted.
+void shift_segments(const std::string& path, uint32_t keep) {
+    auto numbered = [&](uint32_t n) { return path + "." + std::to_string(n); };
+
+    std::remove(numbered(keep).c_str());
+    for (uint32_t n = keep; n > 1; --n) {
+        std::rename(numbered(n - 1).c_str(), numbered(n).c_str());
+    }
+    std::rename(path.c_str(), numbered(1).c_str());
+}
+
+// Producers stamp their own records (a coalesced hook move can be an
+// interval old, channels race between stamping and appending), so a
+// timestamp behind the last one written is moved up to it: the log stays
+// sorted, which HistoryFile::range relies on.
+void write_locked(Log& log, const Record& record) {
+    uint64_t n = log.header->committed.load(std::memory_order_relaxed);
+    std::memcpy(&log.records[n], &record, sizeof(Record));
+    log.last_ns = std::max(log.last_ns, record.timestamp_ns);
+    log.records[n].timestamp_ns = log.last_ns;
+    log.header->committed.store(n + 1, std::memory_order_release);
+}
+
+void write_name_locked(Log& log, uint16_t id, const std::string& name) {
+    Record record = {};
+    record.timestamp_ns = monotonic_ns() + log.wall_offset;
+    record.source       = id;
+    record.reserved     = NN_HISTORY_NAMES;
+
+    char bytes[kNameBytes] = {};
+    std::memcpy(bytes, name.data(), std::min(name.size(), kNameBytes - 1));
+    std::memcpy(reinterpret_cast<uint8_t*>(&record) + kNameOffset, bytes, kNameBytes);
+    write_locked(log, record);
+}
+
+Status open_segment_locked(Log& log) {
+    uint64_t capacity = log.options.segment_records;
+    Status status = log.file.open(log.path.c_str(), (capacity + 1) * sizeof(Record), true);
+    if (status != Status::Ok) {
+        log.header = nullptr;
+        return status;
+    }
+
+    std::memset(log.file.data(), 0, sizeof(HistoryHeader));
+    log.header = reinterpret_cast<HistoryHeader*>(log.file.data());
+    std::memcpy(log.header->magic, kMagic, sizeof(kMagic));
+    log.header->version     = kVersion;
+    log.header->record_size = sizeof(Record);
+    log.header->capacity    = capacity;
+    log.header->created_ns  = unix_ns();
+    log.header->committed.store(0, std::memory_order_release);
+    log.records   = reinterpret_cast<Record*>(log.file.data() + sizeof(HistoryHeader));
+    log.opened_ns = monotonic_ns();
+
+    // Each segment names what it uses; half the segment at most, so a
+    // rotation always leaves room for records.
+    size_t budget = capacity / 2;
+    for (const auto& [id, name] : log.names) {
+        if (budget-- == 0) {
+            break;
+        }
+        write_name_locked(log, id, name);
+    }
+    return Status::Ok;
+}
+
+Status rotate_locked(Log& log) {
+    log.file.flush();
+    log.file.close();
+    log.header = nullptr;
+    shift_segments(log.path, log.options.keep_segments);
+    return open_segment_locked(log);
+}
+
+} // namespace
+
+// =====================================================
+// History
+// =====================================================
+
+std::atomic<bool> History::enabled_{false};
+
+Status History::start(const char* path, const HistoryOptions& options) {
+    if (!path || !*path) {
+        return Status::InvalidArgument;
+    }
+    HistoryOptions resolved = options;
+    if (resolved.segment_records == 0) {
+        resolved.segment_records = kDefaultRecords;
+    }
+    if (resolved.keep_segments == 0) {
+        resolved.keep_segments = kDefaultKeep;
+    }
+    if (resolved.segment_records < kMinRecords || resolved.segment_records > kMaxRecords
+        || resolved.keep_segments > kMaxKeep) {
+        return Status::InvalidArgument;
+    }
+
+    Log& log = history_log();
+    std::lock_guard<std::mutex> guard(log.mutex);
+    enabled_.store(false, std::memory_order_release);
+    if (log.header) {
+        log.file.flush();
+        log.file.close();
+        log.header = nullptr;
+    }
+
+    log.path        = path;
+    log.options     = resolved;
+    log.wall_offset = unix_ns() - monotonic_ns();
+    if (exists(log.path)) {
+        shift_segments(log.path, resolved.keep_segments);
+    }
+
+    Status status = open_segment_locked(log);
+    if (status == Status::Ok) {
+        enabled_.store(true, std::memory_order_release);
+    }
+    return status;
+}
+
+void History::stop() {
+    Log& log = history_log();
+    std::lock_guard<std::mutex> guard(log.mutex);
+    enabled_.store(false, std::memory_order_release);
+    if (log.header) {
+        log.file.flush();
+        log.file.close();
+        log.header = nullptr;
+    }
+}
+
+void History::append(uint32_t channel, const Record& record) {
+    if (!enabled()) {
+        return;
+    }
+    Log& log = history_log();
+    std::lock_guard<std::mutex> guard(log.mutex);
+    if (!log.header) {
+        return;
+    }
+
+    uint64_t age_limit = uint64_t(log.options.rotate_seconds) * 1'000'000'000;
+    bool full = log.header->committed.load(std::memory_order_relaxed) >= log.header->capacity;
+    bool old  = age_limit && record.timestamp_ns > log.opened_ns
+                && record.timestamp_ns - log.opened_ns >= age_limit;
+    if ((full || old) && rotate_locked(log) != Status::Ok) {
+        enabled_.store(false, std::memory_order_release);
+        return;
+    }
+
+    Record entry = record;
+    entry.timestamp_ns += log.wall_offset;
+    entry.reserved = channel;
+    write_locked(log, entry);
+}
+
+Status History::name(uint16_t id, const char* name) {
+    if (!name) {
+        return Status::InvalidArgument;
+    }
+    Log& log = history_log();
+    std::lock_guard<std::mutex> guard(log.mutex);
+    // First name wins: ids are never reused within a process.
+    auto [it, added] = log.names.emplace(id, name);
+    if (added && log.header && log.header->committed.load(std::memory_order_relaxed) < log.header->capacity) {
+        write_name_locked(log, id, it->second);
+    }
+    return Status::Ok;
+}
+
+Status History::flush() {
+    Log& log = history_log();
+    std::lock_guard<std::mutex> guard(log.mutex);
+    return log.header ? log.file.flush() : Status::Unavailable;
+}
+
+Status History::rotate() {
+    Log& log = history_log();
+    std::lock_guard<std::mutex> guard(log.mutex);
+    if (!log.header) {
+        return Status::Unavailable;
+    }
+    Status status = rotate_locked(log);
+    if (status != Status::Ok) {
+        enabled_.store(false, std::memory_order_release);
+    }
+    return status;
+}
+
+// =====================================================
+// HistoryFile
+// =====================================================
+
+Status HistoryFile::open(const char* path) {
+    if (!path) {
+        return Status::InvalidArgument;
+    }
+    Status status = file_.open(path, 0, false);
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    const auto* header = reinterpret_cast<const HistoryHeader*>(file_.data());
+    bool valid = file_.size() >= sizeof(HistoryHeader)
+                 && std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0
+                 && header->version == kVersion && header->record_size == sizeof(Record)
+                 && file_.size() / sizeof(Record) >= header->capacity + 1;
+    if (!valid) {
+        file_.close();
+        return Status::InvalidArgument;
+    }
+    return Status::Ok;
+}
+
+size_t HistoryFile::count() const {
+    if (!file_.is_open()) {
+        return 0;
+    }
+    const auto* header = reinterpret_cast<const HistoryHeader*>(file_.data());
+    return static_cast<size_t>(
+        std::min(header->committed.load(std::memory_order_acquire), header->capacity));
+}
+
+const Record* HistoryFile::records() const {
+    return file_.is_open() ? records_of(file_) : nullptr;
+}
+
+size_t HistoryFile::range(uint64_t from_ns, uint64_t to_ns, const Record** first) const {
+    const Record* begin = records();
+    const Record* end   = begin + count();
+    auto before = [](const Record& record, uint64_t t) { return record.timestamp_ns < t; };
+
+    const Record* lo = std::lower_bound(begin, end, from_ns, before);
+    const Record* hi = to_ns > from_ns ? std::lower_bound(lo, end, to_ns, before) : lo;
+    if (first) {
+        *first = lo;
+    }
+    return static_cast<size_t>(hi - lo);
+}
+
+const char* HistoryFile::name(uint16_t id) const {
+    std::lock_guard<std::mutex> guard(names_lock_);
+
+    const Record* records = this->records();
+    size_t       count   = this->count();
+    for (; names_scanned_ < count; ++names_scanned_) {
+        const Record& record = records[names_scanned_];
+        if (record.reserved != NN_HISTORY_NAMES) {
+            continue;
+        }
+        const char* bytes = reinterpret_cast<const char*>(&record) + kNameOffset;
+        names_.emplace(record.source, std::string(bytes, std::find(bytes, bytes + kNameBytes, '\0')));
+    }
+
+    auto it = names_.find(id);
+    return it != names_.end() ? it->second.c_str() : nullptr;
+}
+
+} // namespace neuro
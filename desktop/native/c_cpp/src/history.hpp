@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "neuro_native.h"
+#include "status.hpp"
+#include "telemetry.hpp"
+
+namespace neuro {
+
+using HistoryOptions = nn_history_options;
+
+// -------------------------------------------------
+// Memory-mapped file (platform backend: posix mmap / Win32 views)
+// -------------------------------------------------
+
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Writable: creates the file or resizes it to `size` and maps it
+    // shared. Read-only: maps the whole file (`size` is ignored).
+    Status open(const char* path, size_t size, bool writable);
+    void   close();
+
+    // Starts writing dirty pages back (msync / FlushViewOfFile). What
+    // sits in the mapping survives a crash of the process either way.
+    Status flush();
+
+    uint8_t* data() const;
+    size_t   size() const;
+    bool     is_open() const { return data() != nullptr; }
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// -------------------------------------------------
+// History segment layout
+//
+// One header record, then fixed 64-byte records in append order.
+// `committed` is published with release after each record, so a reader
+// mapping the same file (in this process or another) sees whole records
+// only. Timestamps are Unix-epoch ns; `reserved` holds the channel the
+// record came from, or NN_HISTORY_NAMES for the records naming an id.
+// -------------------------------------------------
+
+struct HistoryHeader {
+    char                  magic[8];
+    uint32_t              version;
+    uint32_t              record_size;
+    uint64_t              capacity;
+    std::atomic<uint64_t> committed;
+    uint64_t              created_ns;
+    uint64_t              reserved[3];
+};
+
+static_assert(sizeof(HistoryHeader) == sizeof(Record), "the header takes one record slot");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "committed is shared through the mapping");
+
+// -------------------------------------------------
+// Action-history log (C ABI nn_history_*)
+//
+// Process-wide, like the shared telemetry channels it records: while
+// started, every record pushed into NN_CHANNEL_ACTIONS or
+// NN_CHANNEL_MOUSE is also appended to the current segment file. A full
+// segment (or one older than rotate_seconds) is rotated: `path` becomes
+// `path.1`, `path.1` becomes `path.2` and so on, and the oldest beyond
+// keep_segments is deleted. Every segment starts with the names of the
+// ids interned so far, so it reads on its own after the process exits.
+// -------------------------------------------------
+
+class History {
+public:
+    // A segment left at `path` by an earlier run is rotated, not resumed
+    // (its interned ids meant something else).
+    static Status start(const char* path, const HistoryOptions& options);
+    static void   stop();
+    static bool   enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Called by the channels' TelemetryRing::push.
+    static void append(uint32_t channel, const Record& record);
+
+    // Names `id` in this and every later segment (up to 31 bytes kept).
+    static Status name(uint16_t id, const char* name);
+
+    static Status flush();
+    static Status rotate();
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+// -------------------------------------------------
+// Read-only view of one segment
+//
+// Records point straight into the mapping and stay valid until close();
+// a live segment keeps growing (count() moves), and a rotated one is
+// only renamed, so an open view survives rotation.
+// -------------------------------------------------
+
+class HistoryFile {
+public:
+    Status open(const char* path);
+
+    size_t        count() const;
+    const Record* records() const;
+
+    // Records with from_ns <= timestamp < to_ns. The writer keeps the
+    // timestamps non-decreasing (a late-stamped record takes the previous
+    // one's), so this is a binary search.
+    size_t range(uint64_t from_ns, uint64_t to_ns, const Record** first) const;
+
+    // The name recorded for `id`, nullptr when there is none.
+    const char* name(uint16_t id) const;
+
+private:
+    MappedFile file_;
+
+    mutable std::mutex                      names_lock_;
+    mutable std::map<uint16_t, std::string> names_;
+    mutable size_t                          names_scanned_ = 0;
+};
+
+} // namespace neuro
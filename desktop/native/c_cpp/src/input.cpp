@@ -0,0 +1,805 @@
+#include "input.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "backend.hpp"
+#include "clock.hpp"
+#include "metrics.hpp"
+#include "scheduler.hpp"
+
+namespace neuro {
+
+// Pacing runs on the calling thread's scheduler timeline, so a paced
+// run keeps to its deadlines however long each send takes.
+static void sleep_seconds(double seconds) {
+    if (seconds > 0) {
+        Scheduler::instance().wait(seconds);
+    }
+}
+
+uint32_t next_codepoint(std::string_view s, size_t& i) {
+    auto byte = [&](size_t k) { return static_cast<unsigned char>(s[k]); };
+
+    unsigned char c = byte(i++);
+    if (c < 0x80) {
+        return c;
+    }
+
+    int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : -1;
+    if (extra < 0 || i + static_cast<size_t>(extra) > s.size()) {
+        return 0xFFFD;
+    }
+
+    uint32_t cp = c & (0x3F >> extra);
+    for (int k = 0; k < extra; ++k) {
+        unsigned char next = byte(i);
+        if ((next & 0xC0) != 0x80) {
+            return 0xFFFD;
+        }
+        cp = (cp << 6) | (next & 0x3F);
+        ++i;
+    }
+    return cp;
+}
+
+static void push_stroke(std::vector<InputEvent>& events, const KeyStroke& stroke, bool down) {
+    InputEvent event;
+    event.kind = InputEvent::Kind::Key;
+    event.code = stroke.code;
+    event.down = down;
+    events.push_back(event);
+}
+
+// =====================================================
+// Injector
+// =====================================================
+
+InputInjector& InputInjector::instance() {
+    static InputInjector injector;
+    return injector;
+}
+
+Status InputInjector::open() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return open_locked();
+}
+
+Status InputInjector::open_locked() {
+    if (opened_ == Status::Busy) {
+        opened_ = platform_.open();
+        if (opened_ == Status::Ok) {
+            platform_.screen_size(width_, height_);
+        }
+    }
+    return opened_;
+}
+
+Status InputInjector::screen_size(int32_t& width, int32_t& height) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    Status status = open_locked();
+    width  = width_;
+    height = height_;
+    return status;
+}
+
+void InputInjector::clamp(int32_t& x, int32_t& y) {
+    // Copy the layout again only after a refresh; the generation is read
+    // first so a refresh racing the copy is picked up next time.
+    MonitorLayout& layout = MonitorLayout::instance();
+    uint64_t generation = layout.generation();
+    if (generation == 0 || generation != monitors_generation_) {
+        layout.monitors(monitors_);
+        monitors_generation_ = generation ? generation : layout.generation();
+    }
+    if (clamp_to_monitors(monitors_.data(), monitors_.size(), x, y) >= 0) {
+        return;
+    }
+    x = std::max(0, std::min(width_ - 1, x));
+    y = std::max(0, std::min(height_ - 1, y));
+}
+
+// pyautogui lowercases multi-character names; single characters keep
+// their case (and so their shift state).
+bool InputInjector::resolve(std::string_view name, KeyStroke& out) {
+    if (name.empty()) {
+        return false;
+    }
+
+    size_t i = 0;
+    uint32_t cp = next_codepoint(name, i);
+    if (i == name.size()) {
+        return platform_.resolve_key(name, out) || platform_.resolve_char(cp, out);
+    }
+
+    std::string lower(name);
+    for (char& c : lower) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return platform_.resolve_key(lower, out);
+}
+
+// -------------------------------------------------
+// Event builders (mutex_ held, backend open)
+// -------------------------------------------------
+
+void InputInjector::append_key(std::vector<InputEvent>& events, std::string_view name, uint32_t action) {
+    // Unknown keys are ignored, as pyautogui does.
+    KeyStroke stroke;
+    if (!resolve(name, stroke)) {
+        return;
+    }
+
+    KeyStroke shift;
+    bool with_shift = stroke.shift && action == NN_KEY_TAP && platform_.resolve_key("shift", shift);
+
+    if (with_shift) push_stroke(events, shift, true);
+    if (action != NN_KEY_UP) push_stroke(events, stroke, true);
+    if (action != NN_KEY_DOWN) push_stroke(events, stroke, false);
+    if (with_shift) push_stroke(events, shift, false);
+}
+
+void InputInjector::append_hotkey(std::vector<InputEvent>& events, const char* const* keys, uint32_t count) {
+    std::vector<KeyStroke> strokes;
+    for (uint32_t i = 0; i < count; ++i) {
+        KeyStroke stroke;
+        if (keys[i] && resolve(keys[i], stroke)) {
+            strokes.push_back(stroke);
+        }
+    }
+
+    for (const KeyStroke& stroke : strokes) {
+        push_stroke(events, stroke, true);
+    }
+    for (auto it = strokes.rbegin(); it != strokes.rend(); ++it) {
+        push_stroke(events, *it, false);
+    }
+}
+
+void InputInjector::append_char(std::vector<InputEvent>& events, uint32_t cp) {
+    bool unicode = false;
+    if constexpr (kInjectsUnicode) {
+        unicode = platform_.supports_unicode();
+    }
+
+    KeyStroke stroke;
+    bool found = cp == '\n' || cp == '\r'                   ? platform_.resolve_key("enter", stroke)
+               : cp == '\t'                                ? platform_.resolve_key("tab", stroke)
+               : text_mode_ == NN_TEXT_UNICODE && unicode ? false
+               : platform_.resolve_char(cp, stroke);
+
+    if (found) {
+        KeyStroke shift;
+        bool with_shift = stroke.shift && platform_.resolve_key("shift", shift);
+        if (with_shift) push_stroke(events, shift, true);
+        push_stroke(events, stroke, true);
+        push_stroke(events, stroke, false);
+        if (with_shift) push_stroke(events, shift, false);
+        return;
+    }
+
+    if (!unicode || cp == '\n' || cp == '\r' || cp == '\t') {
+        return; // no way to type it here
+    }
+
+    // Outside the layout (or NN_TEXT_UNICODE): the character itself.
+    for (bool down : {true, false}) {
+        InputEvent event;
+        event.kind = InputEvent::Kind::Unicode;
+        event.code = cp;
+        event.down = down;
+        events.push_back(event);
+    }
+}
+
+bool InputInjector::pastes(size_t bytes) const {
+    if constexpr (!kOwnsClipboard) {
+        return false; // a paste would only be typed afterwards
+    }
+    return paste_threshold_ && bytes >= paste_threshold_
+        && bytes <= static_cast<size_t>(std::numeric_limits<int32_t>::max());
+}
+
+void InputInjector::append_text(std::vector<InputEvent>& events, std::string& clips, std::string_view utf8) {
+    if (pastes(utf8.size()) && clips.size() <= std::numeric_limits<int32_t>::max() - utf8.size()) {
+        // A pasted newline or tab is no Enter / Tab press (single-line
+        // fields drop it), so those go out as keys between pasted runs.
+        size_t start = 0;
+        for (size_t i = 0; i <= utf8.size(); ++i) {
+            bool key = i < utf8.size() && (utf8[i] == '\n' || utf8[i] == '\r' || utf8[i] == '\t');
+            if (!key && i < utf8.size()) {
+                continue;
+            }
+            if (i > start) {
+                InputEvent event;
+                event.kind = InputEvent::Kind::Paste;
+                event.x    = static_cast<int32_t>(clips.size());
+                event.y    = static_cast<int32_t>(i - start);
+                events.push_back(event);
+                clips.append(utf8.substr(start, i - start));
+            }
+            if (key) {
+                append_char(events, static_cast<unsigned char>(utf8[i]));
+            }
+            start = i + 1;
+        }
+        return;
+    }
+
+    events.reserve(events.size() + utf8.size() * 2);
+    for (size_t i = 0; i < utf8.size();) {
+        append_char(events, next_codepoint(utf8, i));
+    }
+}
+
+void InputInjector::append_move(std::vector<InputEvent>& events, int32_t x, int32_t y) {
+    clamp(x, y);
+    InputEvent event;
+    event.kind = InputEvent::Kind::Move;
+    event.x = x;
+    event.y = y;
+    events.push_back(event);
+}
+
+Status InputInjector::append_click(std::vector<InputEvent>& events, int32_t x, int32_t y, uint32_t button) {
+    if (button < NN_BUTTON_LEFT || button > NN_BUTTON_RIGHT) {
+        return Status::InvalidArgument;
+    }
+    append_move(events, x, y);
+    for (bool down : {true, false}) {
+        InputEvent event;
+        event.kind = InputEvent::Kind::Button;
+        event.code = button;
+        event.down = down;
+        events.push_back(event);
+    }
+    return Status::Ok;
+}
+
+// -------------------------------------------------
+// Sending (mutex_ held, backend open)
+// -------------------------------------------------
+
+// Every OS injection call goes through here, timed.
+Status InputInjector::inject(const InputEvent* events, size_t count) {
+    ScopedSpan span(NN_METRIC_INJECT);
+    return platform_.send(events, count);
+}
+
+Status InputInjector::send_locked(const InputEvent* events, size_t count, std::string_view clips) {
+    size_t start = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (events[i].kind != InputEvent::Kind::Paste) {
+            continue;
+        }
+        Status status = i > start ? inject(events + start, i - start) : Status::Ok;
+        if (status == Status::Ok) {
+            status = paste_locked(clips.substr(static_cast<size_t>(events[i].x),
+                                               static_cast<size_t>(events[i].y)));
+        }
+        if (status != Status::Ok) {
+            return status;
+        }
+        start = i + 1;
+    }
+    return start < count || count == 0 ? inject(events + start, count - start) : Status::Ok;
+}
+
+// The clipboard is set right before its shortcut goes out, so pastes
+// queued together still land in order. Its previous text is not kept.
+Status InputInjector::paste_locked(std::string_view utf8) {
+    static const char* const kShortcut[] = {"ctrl", "v"};
+
+    std::vector<InputEvent> events;
+    bool clipboard = false;
+    if constexpr (kOwnsClipboard) {
+        clipboard = platform_.set_clipboard(utf8) == Status::Ok;
+    }
+    if (clipboard) {
+        append_hotkey(events, kShortcut, 2);
+    } else {
+        events.reserve(utf8.size() * 2);
+        for (size_t i = 0; i < utf8.size();) {
+            append_char(events, next_codepoint(utf8, i));
+        }
+    }
+    return inject(events.data(), events.size());
+}
+
+void InputInjector::set_text_options(uint32_t mode, uint32_t paste_threshold) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    text_mode_       = mode;
+    paste_threshold_ = paste_threshold;
+}
+
+void InputInjector::text_options(uint32_t& mode, uint32_t& paste_threshold) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    mode            = text_mode_;
+    paste_threshold = paste_threshold_;
+}
+
+bool InputInjector::types_keys() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return text_mode_ == NN_TEXT_LAYOUT && paste_threshold_ == 0;
+}
+
+// -------------------------------------------------
+// Direct calls
+// -------------------------------------------------
+
+Status InputInjector::key(std::string_view name, uint32_t action) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    Status status = open_locked();
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    std::vector<InputEvent> events;
+    append_key(events, name, action);
+    return inject(events.data(), events.size());
+}
+
+Status InputInjector::hotkey(const char* const* keys, uint32_t count) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    Status status = open_locked();
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    std::vector<InputEvent> events;
+    append_hotkey(events, keys, count);
+    return inject(events.data(), events.size());
+}
+
+Status InputInjector::type(std::string_view utf8, double interval_seconds) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    Status status = open_locked();
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    // Unpaced text goes out as a single send (or paste).
+    if (interval_seconds <= 0) {
+        std::vector<InputEvent> events;
+        std::string clips;
+        append_text(events, clips, utf8);
+        return send_locked(events.data(), events.size(), clips);
+    }
+
+    // Paced: one character per deadline on the scheduler timeline.
+    std::vector<InputEvent> events;
+    events.reserve(4);
+    for (size_t i = 0; i < utf8.size();) {
+        events.clear();
+        append_char(events, next_codepoint(utf8, i));
+        if (events.empty()) {
+            continue;
+        }
+
+        status = inject(events.data(), events.size());
+        if (status != Status::Ok) {
+            return status;
+        }
+        sleep_seconds(interval_seconds);
+    }
+    return Status::Ok;
+}
+
+Status InputInjector::paste(std::string_view utf8) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    Status status = open_locked();
+    if (status != Status::Ok) {
+        return status;
+    }
+    return paste_locked(utf8);
+}
+
+Status InputInjector::move(int32_t x, int32_t y, double seconds) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    Status status = open_locked();
+    if (status != Status::Ok) {
+        return status;
+    }
+    clamp(x, y);
+    seconds = wait_seconds(seconds);
+
+    InputEvent event;
+    event.kind = InputEvent::Kind::Move;
+
+    int32_t from_x, from_y;
+    if (seconds <= kMinTweenSeconds || platform_.cursor(from_x, from_y) != Status::Ok) {
+        event.x = x;
+        event.y = y;
+        return inject(&event, 1);
+    }
+
+    // Linear tween, like pyautogui's default easing.
+    int steps = std::max(1, static_cast<int>(seconds / kTweenStepSeconds));
+    for (int i = 1; i <= steps; ++i) {
+        double t = static_cast<double>(i) / steps;
+        event.x = static_cast<int32_t>(from_x + (x - from_x) * t);
+        event.y = static_cast<int32_t>(from_y + (y - from_y) * t);
+        status = inject(&event, 1);
+        if (status != Status::Ok) {
+            return status;
+        }
+        sleep_seconds(seconds / steps);
+    }
+    return Status::Ok;
+}
+
+Status InputInjector::click(int32_t x, int32_t y, uint32_t button) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    Status status = open_locked();
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    std::vector<InputEvent> events;
+    status = append_click(events, x, y, button);
+    if (status != Status::Ok) {
+        return status;
+    }
+    return inject(events.data(), events.size());
+}
+
+Status InputInjector::path(const nn_point* points, uint32_t count, double step_seconds) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    Status status = open_locked();
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    std::vector<InputEvent> events;
+    events.reserve(step_seconds > 0 ? 1 : count);
+
+    // Unpaced paths go out as a single send.
+    if (step_seconds <= 0) {
+        for (uint32_t i = 0; i < count; ++i) {
+            append_move(events, points[i].x, points[i].y);
+        }
+        return inject(events.data(), events.size());
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        events.clear();
+        append_move(events, points[i].x, points[i].y);
+        status = inject(events.data(), events.size());
+        if (status != Status::Ok) {
+            return status;
+        }
+        sleep_seconds(step_seconds);
+    }
+    return Status::Ok;
+}
+
+// =====================================================
+// Batch
+// =====================================================
+
+template <typename Fn>
+Status InputBatch::append(Fn&& fn) {
+    InputInjector& injector = InputInjector::instance();
+    std::lock_guard<std::mutex> guard(injector.mutex_);
+    Status status = injector.open_locked();
+    if (status != Status::Ok) {
+        return status;
+    }
+    return fn(injector);
+}
+
+Status InputBatch::key(std::string_view name, uint32_t action) {
+    return append([&](InputInjector& injector) {
+        injector.append_key(events_, name, action);
+        return Status::Ok;
+    });
+}
+
+Status InputBatch::hotkey(const char* const* keys, uint32_t count) {
+    return append([&](InputInjector& injector) {
+        injector.append_hotkey(events_, keys, count);
+        return Status::Ok;
+    });
+}
+
+Status InputBatch::type(std::string_view utf8) {
+    return append([&](InputInjector& injector) {
+        injector.append_text(events_, clips_, utf8);
+        return Status::Ok;
+    });
+}
+
+Status InputBatch::move(int32_t x, int32_t y) {
+    return append([&](InputInjector& injector) {
+        injector.append_move(events_, x, y);
+        return Status::Ok;
+    });
+}
+
+Status InputBatch::click(int32_t x, int32_t y, uint32_t button) {
+    return append([&](InputInjector& injector) {
+        return injector.append_click(events_, x, y, button);
+    });
+}
+
+Status InputBatch::path(const nn_point* points, uint32_t count) {
+    return append([&](InputInjector& injector) {
+        events_.reserve(events_.size() + count);
+        for (uint32_t i = 0; i < count; ++i) {
+            injector.append_move(events_, points[i].x, points[i].y);
+        }
+        return Status::Ok;
+    });
+}
+
+Status InputBatch::send() {
+    if (events_.empty()) {
+        return Status::Ok;
+    }
+    Status status = append([&](InputInjector& injector) {
+        return injector.send_locked(events_.data(), events_.size(), clips_);
+    });
+    if (status == Status::Ok) {
+        track(events_.data(), events_.size());
+    }
+    clear();
+    return status;
+}
+
+void InputBatch::track(const InputEvent* events, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const InputEvent& event = events[i];
+        if (event.kind != InputEvent::Kind::Key && event.kind != InputEvent::Kind::Button) {
+            continue;
+        }
+        auto it = std::find_if(held_.begin(), held_.end(), [&](const InputEvent& down) {
+            return down.kind == event.kind && down.code == event.code;
+        });
+        if (event.down && it == held_.end()) {
+            held_.push_back(event);
+        } else if (!event.down && it != held_.end()) {
+            held_.erase(it);
+        }
+    }
+}
+
+Status InputBatch::release_held() {
+    if (held_.empty()) {
+        return Status::Ok;
+    }
+    // Most recent first, as a RELEASE sequence would have gone.
+    std::vector<InputEvent> ups(held_.rbegin(), held_.rend());
+    for (InputEvent& up : ups) {
+        up.down = false;
+    }
+    held_.clear();
+    return append([&](InputInjector& injector) {
+        return injector.send_locked(ups.data(), ups.size(), {});
+    });
+}
+
+// =====================================================
+// Script host
+// =====================================================
+
+// One action record per primitive on the shared actions channel, so the
+// Python history sees natively executed scripts too.
+static void record(uint16_t code, int32_t x, int32_t y, int64_t arg, double value) {
+    nn_telemetry_push_event(nn_telemetry_channel(NN_CHANNEL_ACTIONS, 0), NN_SOURCE_NATIVE,
+                            static_cast<uint16_t>(NN_TYPE_OP + code), x, y, arg, value);
+}
+
+// With a batch as the host's user pointer, untimed ops accumulate in it
+// and go out together at the next wait, tween, paced path or the end of
+// the run; without one every op is injected as it comes.
+static InputBatch* batch_of(void* user) {
+    return static_cast<InputBatch*>(user);
+}
+
+static Status flush(void* user) {
+    InputBatch* batch = batch_of(user);
+    return batch ? batch->send() : Status::Ok;
+}
+
+static nn_status host_type_text(void* user, const char* text, uint32_t len) {
+    std::string_view utf8(text, len);
+    if (InputBatch* batch = batch_of(user)) {
+        record(NN_OP_TYPE, 0, 0, len, 0.0);
+        return to_c(batch->type(utf8));
+    }
+    record(NN_OP_TYPE, 0, 0, len, 0.0);
+    return to_c(InputInjector::instance().type(utf8, 0.0));
+}
+
+static nn_status host_key(void* user, uint32_t code, const char* key) {
+    record(static_cast<uint16_t>(code), 0, 0, 0, 0.0);
+    uint32_t action = code == NN_OP_HOLD ? NN_KEY_DOWN : code == NN_OP_RELEASE ? NN_KEY_UP : NN_KEY_TAP;
+    if (InputBatch* batch = batch_of(user)) {
+        return to_c(batch->key(key, action));
+    }
+    return to_c(InputInjector::instance().key(key, action));
+}
+
+static nn_status host_shortcut(void* user, const char* const* keys, uint32_t count) {
+    record(NN_OP_SHORTCUT, 0, 0, count, 0.0);
+    if (InputBatch* batch = batch_of(user)) {
+        return to_c(batch->hotkey(keys, count));
+    }
+    return to_c(InputInjector::instance().hotkey(keys, count));
+}
+
+static nn_status host_move(void* user, int32_t x, int32_t y, double seconds) {
+    record(NN_OP_MOVE, x, y, 0, seconds);
+    InputBatch* batch = batch_of(user);
+    if (batch && seconds <= kMinTweenSeconds) {
+        return to_c(batch->move(x, y));
+    }
+    Status status = flush(user);
+    return to_c(status != Status::Ok ? status : InputInjector::instance().move(x, y, seconds));
+}
+
+static nn_status host_click(void* user, int32_t x, int32_t y, uint32_t button) {
+    record(NN_OP_CLICK, x, y, button, 0.0);
+    if (InputBatch* batch = batch_of(user)) {
+        return to_c(batch->click(x, y, button));
+    }
+    return to_c(InputInjector::instance().click(x, y, button));
+}
+
+static nn_status host_path(void* user, const nn_point* points, uint32_t count, double step_seconds) {
+    record(NN_OP_PATH, count ? points[0].x : 0, count ? points[0].y : 0, count, step_seconds);
+    InputBatch* batch = batch_of(user);
+    if (batch && step_seconds <= 0) {
+        return to_c(batch->path(points, count));
+    }
+    Status status = flush(user);
+    return to_c(status != Status::Ok ? status : InputInjector::instance().path(points, count, step_seconds));
+}
+
+static nn_status host_wait(void* user, double seconds) {
+    record(NN_OP_WAIT, 0, 0, 0, seconds);
+    Status status = flush(user);
+    if (status == Status::Ok) {
+        sleep_seconds(seconds);
+    }
+    return to_c(status);
+}
+
+static nn_status host_screen_size(void*, int32_t* width, int32_t* height) {
+    return to_c(InputInjector::instance().screen_size(*width, *height));
+}
+
+static nn_status host_flush(void* user) {
+    return to_c(flush(user));
+}
+
+const nn_script_host& native_script_host() {
+    static const nn_script_host host = {
+        nullptr,
+        host_type_text,
+        host_key,
+        host_shortcut,
+        host_move,
+        host_click,
+        host_path,
+        host_wait,
+        host_screen_size,
+        host_flush,
+    };
+    return host;
+}
+
+nn_script_host batched_script_host(InputBatch& batch) {
+    nn_script_host host = native_script_host();
+    host.user = &batch;
+    return host;
+}
+
+// =====================================================
+// Cancellable run
+// =====================================================
+
+// The scheduler spins the last stretch of a wait; the condition
+// variable hands over this far ahead of the deadline.
+static constexpr uint64_t kHandoverNs = 2'000'000;
+
+void CancellableRun::cancel() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        cancelled_.store(true, std::memory_order_release);
+    }
+    wake_.notify_all();
+}
+
+bool CancellableRun::sleep(double seconds) {
+    Scheduler& scheduler = Scheduler::instance();
+    uint64_t   deadline  = scheduler.anchor() + wait_ns(seconds);
+
+    if (deadline > monotonic_ns() + kHandoverNs) {
+        using namespace std::chrono;
+        steady_clock::time_point until{nanoseconds(deadline - kHandoverNs)};
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (wake_.wait_until(lock, until, [this] { return cancelled(); })) {
+            return false;
+        }
+    }
+    if (cancelled()) {
+        return false;
+    }
+    scheduler.advance_to(deadline);
+    scheduler.wait_until(deadline);
+    return true;
+}
+
+static CancellableRun* run_of(void* user) {
+    return static_cast<CancellableRun*>(user);
+}
+
+// Each primitive goes to the batched host, unless the run is cancelled.
+template <typename Fn>
+static nn_status unless_cancelled(void* user, Fn&& fn) {
+    CancellableRun* run = run_of(user);
+    return run->cancelled() ? NN_ERR_CANCELLED : fn(&run->batch());
+}
+
+static nn_status cancellable_type_text(void* user, const char* text, uint32_t len) {
+    return unless_cancelled(user, [&](InputBatch* batch) { return host_type_text(batch, text, len); });
+}
+
+static nn_status cancellable_key(void* user, uint32_t code, const char* key) {
+    return unless_cancelled(user, [&](InputBatch* batch) { return host_key(batch, code, key); });
+}
+
+static nn_status cancellable_shortcut(void* user, const char* const* keys, uint32_t count) {
+    return unless_cancelled(user, [&](InputBatch* batch) { return host_shortcut(batch, keys, count); });
+}
+
+static nn_status cancellable_move(void* user, int32_t x, int32_t y, double seconds) {
+    return unless_cancelled(user, [&](InputBatch* batch) { return host_move(batch, x, y, seconds); });
+}
+
+static nn_status cancellable_click(void* user, int32_t x, int32_t y, uint32_t button) {
+    return unless_cancelled(user, [&](InputBatch* batch) { return host_click(batch, x, y, button); });
+}
+
+static nn_status cancellable_path(void* user, const nn_point* points, uint32_t count, double step_seconds) {
+    return unless_cancelled(user, [&](InputBatch* batch) {
+        return host_path(batch, points, count, step_seconds);
+    });
+}
+
+static nn_status cancellable_wait(void* user, double seconds) {
+    return unless_cancelled(user, [&](InputBatch* batch) -> nn_status {
+        record(NN_OP_WAIT, 0, 0, 0, seconds);
+        Status status = batch->send();
+        if (status != Status::Ok) {
+            return to_c(status);
+        }
+        return run_of(user)->sleep(seconds) ? NN_OK : NN_ERR_CANCELLED;
+    });
+}
+
+static nn_status cancellable_flush(void* user) {
+    return unless_cancelled(user, [&](InputBatch* batch) { return to_c(batch->send()); });
+}
+
+nn_script_host cancellable_script_host(CancellableRun& run) {
+    return nn_script_host{
+        &run,
+        cancellable_type_text,
+        cancellable_key,
+        cancellable_shortcut,
+        cancellable_move,
+        cancellable_click,
+        cancellable_path,
+        cancellable_wait,
+        host_screen_size,
+        cancellable_flush,
+    };
+}
+
+} // namespace neuro
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "monitors.hpp"
+#include "status.hpp"
+
+namespace neuro {
+
+// Platform-neutral synthetic input event. Key codes are whatever the
+// backend resolved (virtual-key on Windows, keycode on X11).
+struct InputEvent {
+    // Paste never reaches the platform: the injector sets the clipboard
+    // and sends the paste shortcut in its place (see send_locked).
+    enum class Kind : uint8_t { Key, Unicode, Move, Button, Wheel, Paste };
+
+    Kind     kind = Kind::Key;
+    bool     down = false; // Key / Unicode / Button
+    uint32_t code = 0;     // key code, codepoint (Unicode), NN_BUTTON_* (Button)
+    int32_t  x    = 0;     // Move: absolute pixels; Wheel: y = delta; Paste: text offset
+    int32_t  y    = 0;     // Paste: text bytes
+};
+
+// A key plus whether shift has to be held for it (characters).
+struct KeyStroke {
+    uint32_t code  = 0;
+    bool     shift = false;
+};
+
+// pyautogui.moveTo() only tweens above this; shorter moves jump.
+constexpr double kMinTweenSeconds  = 0.1;
+constexpr double kTweenStepSeconds = 0.01;
+
+// Decodes one UTF-8 sequence at s[i], advancing i. Invalid bytes come
+// back as U+FFFD so a bad byte never stalls the loop.
+uint32_t next_codepoint(std::string_view s, size_t& i);
+
+// -------------------------------------------------
+// Platform half (src/platform/<os>/input_*.cpp)
+// -------------------------------------------------
+
+class PlatformInput {
+public:
+    PlatformInput();
+    ~PlatformInput();
+
+    Status open();
+
+    // Injects `count` events in order with as few OS calls as possible.
+    Status send(const InputEvent* events, size_t count);
+
+    Status screen_size(int32_t& width, int32_t& height);
+    Status cursor(int32_t& x, int32_t& y);
+
+    // pyautogui key names ("enter", "ctrl", "f5", ...), already lowercase.
+    bool resolve_key(std::string_view name, KeyStroke& out);
+
+    // Character on the current layout; false when it has no key.
+    bool resolve_char(uint32_t codepoint, KeyStroke& out);
+
+    // True when send() accepts InputEvent::Kind::Unicode.
+    bool supports_unicode() const;
+
+    // Replaces the clipboard text; Unavailable when the backend cannot
+    // own the clipboard (or not with this much text).
+    Status set_clipboard(std::string_view utf8);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// -------------------------------------------------
+// Process-wide injector (C ABI nn_input_*)
+//
+// Mirrors the pyautogui calls the Python controls make (press, keyDown,
+// keyUp, hotkey, write, moveTo, click) so a script behaves the same
+// whichever side runs it, minus the interpreter.
+// -------------------------------------------------
+
+class InputInjector {
+public:
+    static InputInjector& instance();
+
+    // Opens the backend on first use; Unavailable when none is compiled in.
+    Status open();
+
+    Status key(std::string_view name, uint32_t action); // NN_KEY_*
+    Status hotkey(const char* const* keys, uint32_t count);
+    Status type(std::string_view utf8, double interval_seconds);
+
+    Status move(int32_t x, int32_t y, double seconds);
+    Status click(int32_t x, int32_t y, uint32_t button);
+    Status path(const nn_point* points, uint32_t count, double step_seconds);
+
+    // Clipboard + paste shortcut; typed instead when the clipboard is
+    // unavailable.
+    Status paste(std::string_view utf8);
+
+    Status screen_size(int32_t& width, int32_t& height);
+
+    // NN_TEXT_* mode and paste threshold (nn_text_options).
+    void set_text_options(uint32_t mode, uint32_t paste_threshold);
+    void text_options(uint32_t& mode, uint32_t& paste_threshold);
+
+    // True under the default text options (layout keys, never pasted),
+    // the only ones where tapping enter, tab, space, a-z or 0-9 and
+    // typing its character send the same input.
+    bool types_keys();
+
+private:
+    friend class InputBatch;
+    friend class Timeline;
+
+    InputInjector() = default;
+
+    Status open_locked();
+    bool   resolve(std::string_view name, KeyStroke& out);
+    // Onto the nearest monitor; the primary screen when there is no layout.
+    void   clamp(int32_t& x, int32_t& y);
+
+    // Event builders shared by the direct calls and InputBatch; the
+    // caller holds mutex_ and has opened the backend.
+    void   append_key(std::vector<InputEvent>& events, std::string_view name, uint32_t action);
+    void   append_hotkey(std::vector<InputEvent>& events, const char* const* keys, uint32_t count);
+    void   append_char(std::vector<InputEvent>& events, uint32_t codepoint);
+    // Unpaced text: one Paste event over the threshold (its bytes appended
+    // to `clips`), characters otherwise.
+    void   append_text(std::vector<InputEvent>& events, std::string& clips, std::string_view utf8);
+    void   append_move(std::vector<InputEvent>& events, int32_t x, int32_t y);
+    Status append_click(std::vector<InputEvent>& events, int32_t x, int32_t y, uint32_t button);
+
+    // platform_.send, timed into NN_METRIC_INJECT.
+    Status inject(const InputEvent* events, size_t count);
+    // platform_.send with Paste events (texts in `clips`) carried out.
+    Status send_locked(const InputEvent* events, size_t count, std::string_view clips);
+    Status paste_locked(std::string_view utf8);
+    bool   pastes(size_t bytes) const;
+
+    std::mutex    mutex_;
+    PlatformInput platform_;
+    Status        opened_ = Status::Busy; // Busy = not tried yet
+    int32_t       width_  = 0;
+    int32_t       height_ = 0;
+
+    uint32_t      text_mode_       = NN_TEXT_LAYOUT;
+    uint32_t      paste_threshold_ = 0; // bytes, 0 = never paste
+
+    std::vector<Monitor> monitors_;              // MonitorLayout copy
+    uint64_t             monitors_generation_ = 0;
+};
+
+// -------------------------------------------------
+// Batched injection (C ABI nn_input_batch_*)
+//
+// Resolves a run of non-timed instructions up front and injects all of
+// it with one send(): one SendInput call on Windows, one XFlush on X11.
+// Nothing in a batch sleeps, so waits, tweens and paced paths are the
+// caller's batch boundaries. Not thread-safe; one batch per producer.
+// -------------------------------------------------
+
+class InputBatch {
+public:
+    Status key(std::string_view name, uint32_t action);
+    Status hotkey(const char* const* keys, uint32_t count);
+    Status type(std::string_view utf8);
+
+    Status move(int32_t x, int32_t y);
+    Status click(int32_t x, int32_t y, uint32_t button);
+    Status path(const nn_point* points, uint32_t count);
+
+    size_t size() const { return events_.size(); }
+    void   clear() { events_.clear(); clips_.clear(); }
+
+    // Injects everything queued so far and clears the batch (also on
+    // failure, so a refused batch is never replayed).
+    Status send();
+
+    // Sends the key-ups (and button-ups) for whatever send() pressed and
+    // no later send() released: a HOLD whose RELEASE never ran.
+    Status release_held();
+
+private:
+    template <typename Fn>
+    Status append(Fn&& fn);
+
+    void track(const InputEvent* events, size_t count);
+
+    std::vector<InputEvent> events_;
+    std::string             clips_; // Paste texts
+    std::vector<InputEvent> held_;  // Key / Button downs sent, in order
+};
+
+// nn_script_host that injects directly (nn_input_script_host).
+const nn_script_host& native_script_host();
+
+// Same host, accumulating untimed ops into `batch` between waits; the
+// caller sends whatever is left once the run ends.
+nn_script_host batched_script_host(InputBatch& batch);
+
+// -------------------------------------------------
+// Cancellable run (ActionExecutor)
+//
+// A batch plus a cancel flag for one script run. The host checks the
+// flag before every primitive and sleeps through waits on a condition
+// variable, so cancel() stops a run within one primitive: a tween or a
+// paced path that has started still finishes. Cancelled runs return
+// Status::Cancelled; what was batched is dropped, not sent, and the
+// executor releases whatever the run left held (batch().release_held()).
+// -------------------------------------------------
+
+class CancellableRun {
+public:
+    void cancel();
+    bool cancelled() const { return cancelled_.load(std::memory_order_acquire); }
+
+    InputBatch& batch() { return batch_; }
+
+    // On the calling thread's scheduler timeline; false once cancelled.
+    bool sleep(double seconds);
+
+private:
+    InputBatch              batch_;
+    std::atomic<bool>       cancelled_{false};
+    std::mutex              mutex_;
+    std::condition_variable wake_;
+};
+
+nn_script_host cancellable_script_host(CancellableRun& run);
+
+} // namespace neuro
@@ -0,0 +1,124 @@
+#include "input_hook.hpp"
+
+#include <algorithm>
+
+namespace neuro {
+
+static constexpr uint64_t kIdleWakeNs = 50'000'000; // 50 ms
+
+MouseHook& MouseHook::instance() {
+    static MouseHook hook;
+    return hook;
+}
+
+Status MouseHook::start(TelemetryRing& ring, uint32_t min_interval_us, uint32_t poll_hz) {
+    std::lock_guard<std::mutex> guard(control_);
+    if (running_) {
+        return Status::Busy;
+    }
+
+    ring_         = &ring;
+    interval_ns_  = static_cast<uint64_t>(min_interval_us) * 1000;
+    poll_hz_      = poll_hz ? std::min<uint32_t>(poll_hz, 8000) : 1000;
+    last_push_ns_ = 0;
+    pending_      = false;
+
+    Status status = platform_.start(*this);
+    running_ = status == Status::Ok;
+    return status;
+}
+
+void MouseHook::stop() {
+    std::lock_guard<std::mutex> guard(control_);
+    if (!running_) {
+        return;
+    }
+
+    platform_.stop();
+    running_ = false;
+
+    // Don't lose the final position of a coalesced burst.
+    push_pending();
+}
+
+bool MouseHook::position(int32_t& x, int32_t& y, uint64_t& timestamp_ns) const {
+    timestamp_ns = last_ns_.load(std::memory_order_acquire);
+    if (timestamp_ns == 0) {
+        return false;
+    }
+
+    uint64_t xy = last_xy_.load(std::memory_order_acquire);
+    x = static_cast<int32_t>(static_cast<uint32_t>(xy >> 32));
+    y = static_cast<int32_t>(static_cast<uint32_t>(xy));
+    return true;
+}
+
+void MouseHook::on_move(int32_t x, int32_t y, uint64_t timestamp_ns, uint32_t flags) {
+    last_xy_.store(static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y),
+                   std::memory_order_release);
+    last_ns_.store(timestamp_ns, std::memory_order_release);
+
+    if (interval_ns_ == 0 || timestamp_ns - last_push_ns_ >= interval_ns_) {
+        push(NN_EVENT_MOUSE_MOVE, x, y, 0, 0.0, timestamp_ns, flags);
+        last_push_ns_ = timestamp_ns;
+        pending_ = false;
+        return;
+    }
+
+    pending_       = true;
+    pending_x_     = x;
+    pending_y_     = y;
+    pending_ns_    = timestamp_ns;
+    pending_flags_ = flags;
+}
+
+void MouseHook::on_button(int32_t x, int32_t y, int32_t button, bool pressed,
+                          uint64_t timestamp_ns, uint32_t flags) {
+    // A click must land after the move that led to it.
+    push_pending();
+    push(NN_EVENT_MOUSE_BUTTON, x, y, button, pressed ? 1.0 : 0.0, timestamp_ns, flags);
+}
+
+void MouseHook::on_wheel(int32_t x, int32_t y, int32_t delta, uint64_t timestamp_ns, uint32_t flags) {
+    push_pending();
+    push(NN_EVENT_MOUSE_WHEEL, x, y, delta, 0.0, timestamp_ns, flags);
+}
+
+uint64_t MouseHook::flush(uint64_t now_ns) {
+    if (!pending_) {
+        return kIdleWakeNs;
+    }
+
+    uint64_t due = last_push_ns_ + interval_ns_;
+    if (now_ns < due) {
+        return std::min(due - now_ns, kIdleWakeNs);
+    }
+
+    push_pending();
+    last_push_ns_ = now_ns;
+    return kIdleWakeNs;
+}
+
+void MouseHook::push_pending() {
+    if (pending_) {
+        push(NN_EVENT_MOUSE_MOVE, pending_x_, pending_y_, 0, 0.0, pending_ns_, pending_flags_);
+        last_push_ns_ = pending_ns_;
+        pending_ = false;
+    }
+}
+
+void MouseHook::push(uint16_t type, int32_t x, int32_t y, int64_t arg, double value,
+                     uint64_t timestamp_ns, uint32_t flags) {
+    Record record = {};
+    record.timestamp_ns = timestamp_ns;
+    record.source       = NN_SOURCE_HOOK;
+    record.type         = type;
+    record.flags        = flags;
+    record.x            = x;
+    record.y            = y;
+    record.arg          = arg;
+    record.value        = value;
+    ring_->push(record);
+}
+
+} // namespace neuro
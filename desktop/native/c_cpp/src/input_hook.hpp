@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "status.hpp"
+#include "telemetry.hpp"
+
+namespace neuro {
+
+class MouseHook;
+
+// -------------------------------------------------
+// Platform half of the hook (src/platform/<os>/input_hook_*.cpp)
+//
+// Runs its own thread, timestamps every event with monotonic_ns() and
+// reports to the MouseHook sink. It also calls sink.flush() whenever it
+// wakes so coalesced moves go out on time.
+// -------------------------------------------------
+
+class PlatformMouseHook {
+public:
+    PlatformMouseHook();
+    ~PlatformMouseHook();
+
+    Status start(MouseHook& sink);
+    void   stop();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// -------------------------------------------------
+// Process-wide low-level mouse hook feeding a telemetry ring
+// -------------------------------------------------
+
+class MouseHook {
+public:
+    static MouseHook& instance();
+
+    // min_interval_us > 0 coalesces moves to at most one record per
+    // interval (the latest position wins). poll_hz is only used by
+    // backends that have to poll the pointer.
+    Status start(TelemetryRing& ring, uint32_t min_interval_us, uint32_t poll_hz);
+    void   stop();
+
+    // Latest observed pointer position (not coalesced).
+    bool position(int32_t& x, int32_t& y, uint64_t& timestamp_ns) const;
+
+    uint32_t poll_hz() const { return poll_hz_; }
+
+    // -------- Called from the hook thread only --------
+    void on_move(int32_t x, int32_t y, uint64_t timestamp_ns, uint32_t flags);
+    void on_button(int32_t x, int32_t y, int32_t button, bool pressed,
+                   uint64_t timestamp_ns, uint32_t flags);
+    void on_wheel(int32_t x, int32_t y, int32_t delta, uint64_t timestamp_ns, uint32_t flags);
+
+    // Pushes a pending coalesced move once its interval has elapsed.
+    // Returns how long the hook thread may sleep before calling again.
+    uint64_t flush(uint64_t now_ns);
+
+private:
+    MouseHook() = default;
+
+    void push_pending();
+    void push(uint16_t type, int32_t x, int32_t y, int64_t arg, double value,
+              uint64_t timestamp_ns, uint32_t flags);
+
+    std::mutex         control_;
+    PlatformMouseHook  platform_;
+    bool               running_ = false;
+
+    TelemetryRing*     ring_        = nullptr;
+    uint64_t           interval_ns_ = 0;
+    uint32_t           poll_hz_     = 1000;
+
+    // Hook-thread state
+    uint64_t last_push_ns_  = 0;
+    bool     pending_       = false;
+    int32_t  pending_x_     = 0;
+    int32_t  pending_y_     = 0;
+    uint64_t pending_ns_    = 0;
+    uint32_t pending_flags_ = 0;
+
+    // Readable from any thread: x/y packed into one word
+    std::atomic<uint64_t> last_xy_{0};
+    std::atomic<uint64_t> last_ns_{0};
+};
+
+} // namespace neuro
@@ -0,0 +1,421 @@
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace neuro {
+
+// =====================================================
+// Scalar reference kernels
+// =====================================================
+
+static void scalar_bgra_to_rgb(const uint8_t* src, int32_t src_stride,
+                               uint8_t* dst, int32_t dst_stride,
+                               int32_t width, int32_t height) {
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* s = src + static_cast<size_t>(y) * src_stride;
+        uint8_t*       d = dst + static_cast<size_t>(y) * dst_stride;
+        for (int32_t x = 0; x < width; ++x, s += 4, d += 3) {
+            d[0] = s[2];
+            d[1] = s[1];
+            d[2] = s[0];
+        }
+    }
+}
+
+static void scalar_bgra_to_gray(const uint8_t* src, int32_t src_stride,
+                                uint8_t* dst, int32_t dst_stride,
+                                int32_t width, int32_t height) {
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* s = src + static_cast<size_t>(y) * src_stride;
+        uint8_t*       d = dst + static_cast<size_t>(y) * dst_stride;
+        for (int32_t x = 0; x < width; ++x, s += 4) {
+            d[x] = static_cast<uint8_t>((s[0] * 15 + s[1] * 75 + s[2] * 38 + 64) >> 7);
+        }
+    }
+}
+
+static void scalar_lerp_row(const uint8_t* a, const uint8_t* b, uint8_t* dst,
+                            size_t bytes, uint32_t weight) {
+    uint32_t inv = 256 - weight;
+    for (size_t i = 0; i < bytes; ++i) {
+        dst[i] = static_cast<uint8_t>((a[i] * inv + b[i] * weight + 128) >> 8);
+    }
+}
+
+static void scalar_halve(const uint8_t* src, int32_t src_stride,
+                         uint8_t* dst, int32_t dst_stride,
+                         int32_t dst_width, int32_t dst_height) {
+    for (int32_t y = 0; y < dst_height; ++y) {
+        const uint8_t* r0 = src + static_cast<size_t>(y) * 2 * src_stride;
+        const uint8_t* r1 = r0 + src_stride;
+        uint8_t*       d  = dst + static_cast<size_t>(y) * dst_stride;
+
+        for (int32_t x = 0; x < dst_width; ++x, r0 += 8, r1 += 8, d += 4) {
+            for (int c = 0; c < 4; ++c) {
+                d[c] = static_cast<uint8_t>((r0[c] + r0[c + 4] + r1[c] + r1[c + 4] + 2) >> 2);
+            }
+        }
+    }
+}
+
+static uint64_t scalar_sad(const uint8_t* a, int32_t a_stride,
+                           const uint8_t* b, int32_t b_stride,
+                           int32_t width_bytes, int32_t height) {
+    uint64_t total = 0;
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* ra = a + static_cast<size_t>(y) * a_stride;
+        const uint8_t* rb = b + static_cast<size_t>(y) * b_stride;
+        uint32_t row = 0;
+        for (int32_t x = 0; x < width_bytes; ++x) {
+            row += ra[x] > rb[x] ? ra[x] - rb[x] : rb[x] - ra[x];
+        }
+        total += row;
+    }
+    return total;
+}
+
+static uint64_t scalar_dot(const uint8_t* a, int32_t a_stride,
+                           const uint8_t* b, int32_t b_stride,
+                           int32_t width, int32_t height) {
+    uint64_t total = 0;
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* ra = a + static_cast<size_t>(y) * a_stride;
+        const uint8_t* rb = b + static_cast<size_t>(y) * b_stride;
+        uint64_t row = 0;
+        for (int32_t x = 0; x < width; ++x) {
+            row += static_cast<uint32_t>(ra[x]) * rb[x];
+        }
+        total += row;
+    }
+    return total;
+}
+
+const KernelTable kScalarKernels = {
+    "scalar",
+    scalar_bgra_to_rgb,
+    scalar_bgra_to_gray,
+    scalar_lerp_row,
+    scalar_halve,
+    scalar_sad,
+    scalar_dot,
+};
+
+// =====================================================
+// Runtime dispatch
+// =====================================================
+
+uint32_t cpu_features() {
+    uint32_t features = 0;
+
+#if defined(NEURO_KERNELS_X86)
+#  if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    bool sse41   = (info[2] & (1 << 19)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+
+    bool avx2 = false;
+    if (max_leaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#  else
+    __builtin_cpu_init();
+    bool sse41 = __builtin_cpu_supports("sse4.1");
+    bool avx2  = __builtin_cpu_supports("avx2");
+#  endif
+    if (sse41) features |= CpuSse41;
+    if (avx2 && sse41) features |= CpuAvx2;
+#elif defined(NEURO_KERNELS_NEON)
+    features |= CpuNeon; // baseline on AArch64
+#endif
+
+    return features;
+}
+
+static const KernelTable& select_kernels() {
+    uint32_t features = cpu_features();
+    (void)features;
+
+#if defined(NEURO_KERNELS_X86)
+    if (features & CpuAvx2)  return kAvx2Kernels;
+    if (features & CpuSse41) return kSse41Kernels;
+#elif defined(NEURO_KERNELS_NEON)
+    if (features & CpuNeon)  return kNeonKernels;
+#endif
+    return kScalarKernels;
+}
+
+const KernelTable& kernels() {
+    static const KernelTable& table = select_kernels();
+    return table;
+}
+
+// =====================================================
+// Frame-level operations
+// =====================================================
+
+// Area average over integer source spans. Exact 2:1 reductions take the
+// vectorized halve kernel.
+static void downscale_box(const ImageView& src, uint8_t* dst, int32_t dst_width,
+                          int32_t dst_height, int32_t dst_stride) {
+    const KernelTable& k = kernels();
+
+    if (src.width == dst_width * 2 && src.height == dst_height * 2) {
+        k.halve(src.data, src.stride, dst, dst_stride, dst_width, dst_height);
+        return;
+    }
+
+    thread_local std::vector<uint32_t> columns;
+    columns.assign(static_cast<size_t>(src.width) * 4, 0);
+
+    for (int32_t dy = 0; dy < dst_height; ++dy) {
+        int32_t y0 = static_cast<int32_t>(static_cast<int64_t>(dy) * src.height / dst_height);
+        int32_t y1 = static_cast<int32_t>(static_cast<int64_t>(dy + 1) * src.height / dst_height);
+        y1 = std::max(y1, y0 + 1);
+
+        std::fill(columns.begin(), columns.end(), 0u);
+        for (int32_t y = y0; y < y1; ++y) {
+            const uint8_t* row = src.data + static_cast<size_t>(y) * src.stride;
+            for (size_t i = 0; i < columns.size(); ++i) {
+                columns[i] += row[i];
+            }
+        }
+
+        uint8_t* out = dst + static_cast<size_t>(dy) * dst_stride;
+        for (int32_t dx = 0; dx < dst_width; ++dx) {
+            int32_t x0 = static_cast<int32_t>(static_cast<int64_t>(dx) * src.width / dst_width);
+            int32_t x1 = static_cast<int32_t>(static_cast<int64_t>(dx + 1) * src.width / dst_width);
+            x1 = std::max(x1, x0 + 1);
+
+            uint32_t area = static_cast<uint32_t>((x1 - x0) * (y1 - y0));
+            for (int c = 0; c < 4; ++c) {
+                uint32_t sum = 0;
+                for (int32_t x = x0; x < x1; ++x) {
+                    sum += columns[static_cast<size_t>(x) * 4 + c];
+                }
+                out[dx * 4 + c] = static_cast<uint8_t>((sum + area / 2) / area);
+            }
+        }
+    }
+}
+
+// Separable fixed-point bilinear: the vertical blend of two source rows is
+// the vectorized part, the horizontal pass gathers from that blended row.
+static void downscale_bilinear(const ImageView& src, uint8_t* dst, int32_t dst_width,
+                               int32_t dst_height, int32_t dst_stride) {
+    const KernelTable& k = kernels();
+
+    thread_local std::vector<uint8_t> blended;
+    blended.resize(static_cast<size_t>(src.width) * 4);
+
+    // 16.16 source step, sampling pixel centres
+    int64_t step_x = (static_cast<int64_t>(src.width) << 16) / dst_width;
+    int64_t step_y = (static_cast<int64_t>(src.height) << 16) / dst_height;
+
+    for (int32_t dy = 0; dy < dst_height; ++dy) {
+        int64_t fy = std::max<int64_t>(0, dy * step_y + step_y / 2 - 0x8000);
+        int32_t y0 = std::min(static_cast<int32_t>(fy >> 16), src.height - 1);
+        int32_t y1 = std::min(y0 + 1, src.height - 1);
+        uint32_t wy = static_cast<uint32_t>((fy >> 8) & 0xFF);
+
+        k.lerp_row(src.data + static_cast<size_t>(y0) * src.stride,
+                   src.data + static_cast<size_t>(y1) * src.stride,
+                   blended.data(), blended.size(), wy);
+
+        uint8_t* out = dst + static_cast<size_t>(dy) * dst_stride;
+        for (int32_t dx = 0; dx < dst_width; ++dx) {
+            int64_t fx = std::max<int64_t>(0, dx * step_x + step_x / 2 - 0x8000);
+            int32_t x0 = std::min(static_cast<int32_t>(fx >> 16), src.width - 1);
+            int32_t x1 = std::min(x0 + 1, src.width - 1);
+            uint32_t wx  = static_cast<uint32_t>((fx >> 8) & 0xFF);
+            uint32_t inv = 256 - wx;
+
+            const uint8_t* p0 = &blended[static_cast<size_t>(x0) * 4];
+            const uint8_t* p1 = &blended[static_cast<size_t>(x1) * 4];
+            for (int c = 0; c < 4; ++c) {
+                out[dx * 4 + c] = static_cast<uint8_t>((p0[c] * inv + p1[c] * wx + 128) >> 8);
+            }
+        }
+    }
+}
+
+void downscale(const ImageView& src, uint8_t* dst, int32_t dst_width,
+               int32_t dst_height, int32_t dst_stride, Filter filter) {
+    if (filter == Filter::Box) {
+        downscale_box(src, dst, dst_width, dst_height, dst_stride);
+    } else {
+        downscale_bilinear(src, dst, dst_width, dst_height, dst_stride);
+    }
+}
+
+uint32_t tile_diff(const ImageView& a, const ImageView& b, uint32_t tile_size,
+                   uint32_t threshold, uint8_t* map) {
+    const KernelTable& k = kernels();
+    int32_t tile = static_cast<int32_t>(tile_size);
+    uint32_t changed = 0;
+
+    for (int32_t y = 0; y < a.height; y += tile) {
+        int32_t h = std::min(tile, a.height - y);
+
+        for (int32_t x = 0; x < a.width; x += tile) {
+            int32_t w = std::min(tile, a.width - x);
+            size_t offset_a = static_cast<size_t>(y) * a.stride + static_cast<size_t>(x) * 4;
+            size_t offset_b = static_cast<size_t>(y) * b.stride + static_cast<size_t>(x) * 4;
+
+            uint64_t sad = k.sad(a.data + offset_a, a.stride,
+                                 b.data + offset_b, b.stride, w * 4, h);
+            bool dirty = sad > static_cast<uint64_t>(threshold) * w * h;
+
+            *map++ = dirty ? 1 : 0;
+            changed += dirty ? 1 : 0;
+        }
+    }
+    return changed;
+}
+
+static inline uint64_t mix64(uint64_t h, uint64_t v) {
+    h ^= v * 0x9E3779B97F4A7C15ull;
+    h = (h << 27) | (h >> 37);
+    return h * 0xBF58476D1CE4E5B9ull;
+}
+
+void tile_hashes(const ImageView& image, uint32_t tile_size, uint64_t* out) {
+    int32_t tile = static_cast<int32_t>(tile_size);
+
+    for (int32_t y = 0; y < image.height; y += tile) {
+        int32_t h = std::min(tile, image.height - y);
+
+        for (int32_t x = 0; x < image.width; x += tile) {
+            int32_t w     = std::min(tile, image.width - x);
+            size_t  bytes = static_cast<size_t>(w) * 4;
+            uint64_t hash = 0xCBF29CE484222325ull ^ (static_cast<uint64_t>(w) << 32 | static_cast<uint32_t>(h));
+
+            for (int32_t row = 0; row < h; ++row) {
+                const uint8_t* p = image.data + static_cast<size_t>(y + row) * image.stride
+                                 + static_cast<size_t>(x) * 4;
+                size_t i = 0;
+                for (; i + 8 <= bytes; i += 8) {
+                    uint64_t word;
+                    std::memcpy(&word, p + i, 8);
+                    hash = mix64(hash, word);
+                }
+                for (; i < bytes; i += 4) {
+                    uint32_t word;
+                    std::memcpy(&word, p + i, 4);
+                    hash = mix64(hash, word);
+                }
+            }
+            *out++ = hash ^ (hash >> 31);
+        }
+    }
+}
+
+// -------------------------------------------------
+// Perceptual hashes
+// -------------------------------------------------
+
+static inline uint32_t popcount64(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_popcountll(value));
+#else
+    // No __popcnt: it needs POPCNT, which the baseline build can't assume.
+    value = value - ((value >> 1) & 0x5555555555555555ull);
+    value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<uint32_t>((value * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// Up to 4 evenly spaced positions inside [start, end); end > start.
+static constexpr int32_t kHashSamples = 4;
+
+static int32_t sample_count(int32_t start, int32_t end) {
+    return std::min(end - start, kHashSamples);
+}
+
+static int32_t sample_at(int32_t start, int32_t end, int32_t index, int32_t count) {
+    return start + ((end - start) * (2 * index + 1)) / (2 * count);
+}
+
+uint64_t perceptual_hash(const ImageView& image, int32_t x, int32_t y, int32_t width, int32_t height) {
+    constexpr int32_t kCells = 8;
+
+    // Cell c spans [c * size / 8, (c + 1) * size / 8), widened to one pixel
+    // when the region is smaller than the grid.
+    auto span = [](int32_t origin, int32_t size, int32_t cell, int32_t& start, int32_t& end) {
+        start = origin + std::min(cell * size / kCells, size - 1);
+        end   = std::max(origin + (cell + 1) * size / kCells, start + 1);
+    };
+
+    uint32_t cells[kCells][kCells];
+    uint32_t total = 0;
+
+    for (int32_t cy = 0; cy < kCells; ++cy) {
+        int32_t y0, y1;
+        span(y, height, cy, y0, y1);
+        int32_t ny = sample_count(y0, y1);
+
+        for (int32_t cx = 0; cx < kCells; ++cx) {
+            int32_t x0, x1;
+            span(x, width, cx, x0, x1);
+            int32_t  nx  = sample_count(x0, x1);
+            uint32_t sum = 0;
+
+            for (int32_t sy = 0; sy < ny; ++sy) {
+                const uint8_t* row = image.data + static_cast<size_t>(sample_at(y0, y1, sy, ny)) * image.stride;
+                for (int32_t sx = 0; sx < nx; ++sx) {
+                    const uint8_t* p = row + static_cast<size_t>(sample_at(x0, x1, sx, nx)) * 4;
+                    sum += (p[0] * 15 + p[1] * 75 + p[2] * 38 + 64) >> 7;
+                }
+            }
+
+            // x16 fixed point, so gentle gradients survive the average
+            cells[cy][cx] = sum * 16 / static_cast<uint32_t>(nx * ny);
+            total += cells[cy][cx];
+        }
+    }
+
+    uint64_t hash = 0;
+    int      bit  = 0;
+    for (int32_t cy = 0; cy < kCells; ++cy) {
+        for (int32_t cx = 0; cx + 1 < kCells; ++cx, ++bit) {
+            if (cells[cy][cx] < cells[cy][cx + 1]) {
+                hash |= 1ull << bit;
+            }
+        }
+    }
+    uint64_t mean = total / (kCells * kCells * 16);
+    return hash | mean << 56;
+}
+
+void tile_perceptual_hashes(const ImageView& image, uint32_t tile_size, uint64_t* out) {
+    int32_t tile = static_cast<int32_t>(tile_size);
+
+    for (int32_t y = 0; y < image.height; y += tile) {
+        int32_t h = std::min(tile, image.height - y);
+        for (int32_t x = 0; x < image.width; x += tile) {
+            *out++ = perceptual_hash(image, x, y, std::min(tile, image.width - x), h);
+        }
+    }
+}
+
+uint32_t phash_distance(uint64_t a, uint64_t b) {
+    constexpr uint64_t kBits = (1ull << 56) - 1;
+
+    uint32_t ma = static_cast<uint32_t>(a >> 56);
+    uint32_t mb = static_cast<uint32_t>(b >> 56);
+    return popcount64((a ^ b) & kBits) + (ma > mb ? ma - mb : mb - ma) / 8;
+}
+
+} // namespace neuro
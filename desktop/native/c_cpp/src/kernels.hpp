@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace neuro {
+
+// -------------------------------------------------
+// Pixel kernels for capture post-processing
+//
+// Every entry works on strided BGRA rows so it can run directly on a
+// leased capture slot. One table per ISA; kernels() picks the best one
+// the CPU supports on first use.
+//
+// NOTE: the SIMD translation units are compiled with ISA flags, so they
+// stick to intrinsics and plain loops; std:: templates instantiated there
+// could be merged into baseline code and fault on older CPUs.
+// -------------------------------------------------
+
+struct KernelTable {
+    const char* isa;
+
+    // BGRA -> packed RGB / 8-bit luma (BT.601, (38R + 75G + 15B + 64) >> 7)
+    void (*bgra_to_rgb)(const uint8_t* src, int32_t src_stride,
+                        uint8_t* dst, int32_t dst_stride,
+                        int32_t width, int32_t height);
+    void (*bgra_to_gray)(const uint8_t* src, int32_t src_stride,
+                         uint8_t* dst, int32_t dst_stride,
+                         int32_t width, int32_t height);
+
+    // dst[i] = (a[i] * (256 - weight) + b[i] * weight + 128) >> 8, weight in [0, 256)
+    void (*lerp_row)(const uint8_t* a, const uint8_t* b, uint8_t* dst,
+                     size_t bytes, uint32_t weight);
+
+    // 2x2 box average of BGRA pixels into a (dst_width x dst_height) image
+    void (*halve)(const uint8_t* src, int32_t src_stride,
+                  uint8_t* dst, int32_t dst_stride,
+                  int32_t dst_width, int32_t dst_height);
+
+    // Sum of absolute byte differences over a width_bytes x height block
+    uint64_t (*sad)(const uint8_t* a, int32_t a_stride,
+                    const uint8_t* b, int32_t b_stride,
+                    int32_t width_bytes, int32_t height);
+
+    // Sum of a[i] * b[i] over a width x height block of 8-bit samples
+    // (the cross term of template matching)
+    uint64_t (*dot)(const uint8_t* a, int32_t a_stride,
+                    const uint8_t* b, int32_t b_stride,
+                    int32_t width, int32_t height);
+};
+
+enum CpuFeature : uint32_t {
+    CpuSse41 = 1u << 0,
+    CpuAvx2  = 1u << 1,
+    CpuNeon  = 1u << 2,
+};
+
+uint32_t cpu_features();
+const KernelTable& kernels();
+
+// Per-ISA tables (defined in kernels_<isa>.cpp when compiled in)
+extern const KernelTable kScalarKernels;
+extern const KernelTable kSse41Kernels;
+extern const KernelTable kAvx2Kernels;
+extern const KernelTable kNeonKernels;
+
+// Shared by the SSE4.1 and AVX2 tables
+void sse41_halve(const uint8_t* src, int32_t src_stride, uint8_t* dst,
+                 int32_t dst_stride, int32_t dst_width, int32_t dst_height);
+
+// -------------------------------------------------
+// Frame-level operations (built on the table)
+// -------------------------------------------------
+
+struct ImageView {
+    const uint8_t* data   = nullptr;
+    int32_t        width  = 0;
+    int32_t        height = 0;
+    int32_t        stride = 0;
+};
+
+enum class Filter : uint32_t {
+    Box      = 0,
+    Bilinear = 1,
+};
+
+// Resamples BGRA `src` into a dst_width x dst_height BGRA buffer.
+void downscale(const ImageView& src, uint8_t* dst, int32_t dst_width,
+               int32_t dst_height, int32_t dst_stride, Filter filter);
+
+// Compares a and b tile by tile; map[i] = 1 when the tile's SAD exceeds
+// threshold * tile pixels. Returns the number of changed tiles.
+uint32_t tile_diff(const ImageView& a, const ImageView& b, uint32_t tile_size,
+                   uint32_t threshold, uint8_t* map);
+
+// 64-bit content hash of every tile, row-major.
+void tile_hashes(const ImageView& image, uint32_t tile_size, uint64_t* out);
+
+// Perceptual hash of a region: bits 0..55 are a dHash over 8x8 cells
+// (each cell darker than its right neighbour), bits 56..63 the mean luma,
+// so a flat region that changes colour still changes its hash. Cells are
+// sampled on a grid of at most 4x4 pixels, so the cost depends on the
+// cell count rather than the region size, and pixel noise and subpixel
+// shifts barely move the bits.
+uint64_t perceptual_hash(const ImageView& image, int32_t x, int32_t y, int32_t width, int32_t height);
+
+// perceptual_hash of every tile, row-major.
+void tile_perceptual_hashes(const ImageView& image, uint32_t tile_size, uint64_t* out);
+
+// Differing dHash bits plus one per 8 levels of mean luma difference.
+uint32_t phash_distance(uint64_t a, uint64_t b);
+
+} // namespace neuro
@@ -0,0 +1,172 @@
+// AVX2 kernels (compiled with -mavx2; selected at runtime). Operations
+// that do not gain from 256-bit lanes reuse the SSE4.1 versions.
+
+#include "kernels.hpp"
+
+#include <immintrin.h>
+
+namespace neuro {
+
+static void avx2_bgra_to_rgb(const uint8_t* src, int32_t src_stride,
+                             uint8_t* dst, int32_t dst_stride,
+                             int32_t width, int32_t height) {
+    // Per 128-bit lane: 4 BGRA pixels -> 12 RGB bytes
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    // Pack the two 12-byte lane results into the low 24 bytes
+    const __m256i pack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* s = src + static_cast<size_t>(y) * src_stride;
+        uint8_t*       d = dst + static_cast<size_t>(y) * dst_stride;
+
+        int32_t x = 0;
+        // 32-byte stores spill 8 bytes, so keep 3 pixels of headroom.
+        for (; x + 11 <= width; x += 8, s += 32, d += 24) {
+            __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+            __m256i rgb = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(px, shuffle), pack);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d), rgb);
+        }
+        for (; x < width; ++x, s += 4, d += 3) {
+            d[0] = s[2];
+            d[1] = s[1];
+            d[2] = s[0];
+        }
+    }
+}
+
+static void avx2_bgra_to_gray(const uint8_t* src, int32_t src_stride,
+                              uint8_t* dst, int32_t dst_stride,
+                              int32_t width, int32_t height) {
+    const __m256i weights = _mm256_setr_epi8(
+        15, 75, 38, 0, 15, 75, 38, 0, 15, 75, 38, 0, 15, 75, 38, 0,
+        15, 75, 38, 0, 15, 75, 38, 0, 15, 75, 38, 0, 15, 75, 38, 0);
+    const __m256i round = _mm256_set1_epi16(64);
+    // hadd/packus work per lane; this restores pixel order.
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* s = src + static_cast<size_t>(y) * src_stride;
+        uint8_t*       d = dst + static_cast<size_t>(y) * dst_stride;
+
+        int32_t x = 0;
+        for (; x + 32 <= width; x += 32, s += 128) {
+            __m256i m0 = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)), weights);
+            __m256i m1 = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 32)), weights);
+            __m256i m2 = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 64)), weights);
+            __m256i m3 = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 96)), weights);
+
+            __m256i lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_hadd_epi16(m0, m1), round), 7);
+            __m256i hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_hadd_epi16(m2, m3), round), 7);
+
+            __m256i gray = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), order);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + x), gray);
+        }
+        for (; x < width; ++x, s += 4) {
+            d[x] = static_cast<uint8_t>((s[0] * 15 + s[1] * 75 + s[2] * 38 + 64) >> 7);
+        }
+    }
+}
+
+static void avx2_lerp_row(const uint8_t* a, const uint8_t* b, uint8_t* dst,
+                          size_t bytes, uint32_t weight) {
+    const __m256i wb    = _mm256_set1_epi16(static_cast<short>(weight));
+    const __m256i wa    = _mm256_set1_epi16(static_cast<short>(256 - weight));
+    const __m256i round = _mm256_set1_epi16(128);
+
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16));
+        __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16));
+
+        __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_cvtepu8_epi16(a0), wa),
+                                      _mm256_mullo_epi16(_mm256_cvtepu8_epi16(b0), wb));
+        __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_cvtepu8_epi16(a1), wa),
+                                      _mm256_mullo_epi16(_mm256_cvtepu8_epi16(b1), wb));
+
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, round), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, round), 8);
+
+        // packus interleaves lanes: (lo.l, hi.l, lo.h, hi.h) -> fix with a 64-bit permute
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+    }
+
+    uint32_t inv = 256 - weight;
+    for (; i < bytes; ++i) {
+        dst[i] = static_cast<uint8_t>((a[i] * inv + b[i] * weight + 128) >> 8);
+    }
+}
+
+static uint64_t avx2_sad(const uint8_t* a, int32_t a_stride,
+                         const uint8_t* b, int32_t b_stride,
+                         int32_t width_bytes, int32_t height) {
+    __m256i acc = _mm256_setzero_si256();
+    uint64_t tail = 0;
+
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* ra = a + static_cast<size_t>(y) * a_stride;
+        const uint8_t* rb = b + static_cast<size_t>(y) * b_stride;
+
+        int32_t x = 0;
+        for (; x + 32 <= width_bytes; x += 32) {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ra + x));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rb + x));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(va, vb));
+        }
+        for (; x < width_bytes; ++x) {
+            tail += ra[x] > rb[x] ? ra[x] - rb[x] : rb[x] - ra[x];
+        }
+    }
+
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + tail;
+}
+
+static uint64_t avx2_dot(const uint8_t* a, int32_t a_stride,
+                         const uint8_t* b, int32_t b_stride,
+                         int32_t width, int32_t height) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total = _mm256_setzero_si256();
+    uint64_t tail = 0;
+
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* ra = a + static_cast<size_t>(y) * a_stride;
+        const uint8_t* rb = b + static_cast<size_t>(y) * b_stride;
+
+        // u32 lanes gain at most 2 * 255^2 per step; flushed every row
+        __m256i acc = _mm256_setzero_si256();
+        int32_t x = 0;
+        for (; x + 16 <= width; x += 16) {
+            __m256i va = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ra + x)));
+            __m256i vb = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rb + x)));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+        }
+        total = _mm256_add_epi64(total, _mm256_unpacklo_epi32(acc, zero));
+        total = _mm256_add_epi64(total, _mm256_unpackhi_epi32(acc, zero));
+
+        for (; x < width; ++x) {
+            tail += static_cast<uint32_t>(ra[x]) * rb[x];
+        }
+    }
+
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + tail;
+}
+
+const KernelTable kAvx2Kernels = {
+    "avx2",
+    avx2_bgra_to_rgb,
+    avx2_bgra_to_gray,
+    avx2_lerp_row,
+    sse41_halve,
+    avx2_sad,
+    avx2_dot,
+};
+
+} // namespace neuro
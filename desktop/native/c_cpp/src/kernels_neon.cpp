@@ -0,0 +1,156 @@
+// NEON kernels (baseline on AArch64). The 2x2 halve stays scalar.
+
+#include "kernels.hpp"
+
+#include <arm_neon.h>
+
+namespace neuro {
+
+static void neon_bgra_to_rgb(const uint8_t* src, int32_t src_stride,
+                             uint8_t* dst, int32_t dst_stride,
+                             int32_t width, int32_t height) {
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* s = src + static_cast<size_t>(y) * src_stride;
+        uint8_t*       d = dst + static_cast<size_t>(y) * dst_stride;
+
+        int32_t x = 0;
+        for (; x + 16 <= width; x += 16, s += 64, d += 48) {
+            uint8x16x4_t bgra = vld4q_u8(s);
+            uint8x16x3_t rgb;
+            rgb.val[0] = bgra.val[2];
+            rgb.val[1] = bgra.val[1];
+            rgb.val[2] = bgra.val[0];
+            vst3q_u8(d, rgb);
+        }
+        for (; x < width; ++x, s += 4, d += 3) {
+            d[0] = s[2];
+            d[1] = s[1];
+            d[2] = s[0];
+        }
+    }
+}
+
+static void neon_bgra_to_gray(const uint8_t* src, int32_t src_stride,
+                              uint8_t* dst, int32_t dst_stride,
+                              int32_t width, int32_t height) {
+    const uint8x8_t wb = vdup_n_u8(15);
+    const uint8x8_t wg = vdup_n_u8(75);
+    const uint8x8_t wr = vdup_n_u8(38);
+
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* s = src + static_cast<size_t>(y) * src_stride;
+        uint8_t*       d = dst + static_cast<size_t>(y) * dst_stride;
+
+        int32_t x = 0;
+        for (; x + 8 <= width; x += 8, s += 32) {
+            uint8x8x4_t bgra = vld4_u8(s);
+            uint16x8_t sum = vmull_u8(bgra.val[0], wb);
+            sum = vmlal_u8(sum, bgra.val[1], wg);
+            sum = vmlal_u8(sum, bgra.val[2], wr);
+            vst1_u8(d + x, vrshrn_n_u16(sum, 7));
+        }
+        for (; x < width; ++x, s += 4) {
+            d[x] = static_cast<uint8_t>((s[0] * 15 + s[1] * 75 + s[2] * 38 + 64) >> 7);
+        }
+    }
+}
+
+static void neon_lerp_row(const uint8_t* a, const uint8_t* b, uint8_t* dst,
+                          size_t bytes, uint32_t weight) {
+    size_t i = 0;
+    if (weight == 0) {
+        for (; i < bytes; ++i) dst[i] = a[i];
+        return;
+    }
+
+    // weight in [1, 255] so both factors fit in u8
+    const uint8x8_t wb = vdup_n_u8(static_cast<uint8_t>(weight));
+    const uint8x8_t wa = vdup_n_u8(static_cast<uint8_t>(256 - weight));
+
+    for (; i + 16 <= bytes; i += 16) {
+        uint8x16_t va = vld1q_u8(a + i);
+        uint8x16_t vb = vld1q_u8(b + i);
+
+        uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(va), wa), vget_low_u8(vb), wb);
+        uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(va), wa), vget_high_u8(vb), wb);
+        vst1q_u8(dst + i, vcombine_u8(vrshrn_n_u16(lo, 8), vrshrn_n_u16(hi, 8)));
+    }
+
+    uint32_t inv = 256 - weight;
+    for (; i < bytes; ++i) {
+        dst[i] = static_cast<uint8_t>((a[i] * inv + b[i] * weight + 128) >> 8);
+    }
+}
+
+static void neon_halve(const uint8_t* src, int32_t src_stride,
+                       uint8_t* dst, int32_t dst_stride,
+                       int32_t dst_width, int32_t dst_height) {
+    kScalarKernels.halve(src, src_stride, dst, dst_stride, dst_width, dst_height);
+}
+
+static uint64_t neon_sad(const uint8_t* a, int32_t a_stride,
+                         const uint8_t* b, int32_t b_stride,
+                         int32_t width_bytes, int32_t height) {
+    uint64_t total = 0;
+
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* ra = a + static_cast<size_t>(y) * a_stride;
+        const uint8_t* rb = b + static_cast<size_t>(y) * b_stride;
+
+        uint32x4_t acc = vdupq_n_u32(0);
+        int32_t x = 0;
+        while (x + 16 <= width_bytes) {
+            // u16 lanes hold at most 128 * 510 before they would overflow
+            uint16x8_t part = vdupq_n_u16(0);
+            for (int n = 0; n < 128 && x + 16 <= width_bytes; ++n, x += 16) {
+                part = vpadalq_u8(part, vabdq_u8(vld1q_u8(ra + x), vld1q_u8(rb + x)));
+            }
+            acc = vpadalq_u16(acc, part);
+        }
+        total += vaddvq_u32(acc);
+
+        for (; x < width_bytes; ++x) {
+            total += ra[x] > rb[x] ? ra[x] - rb[x] : rb[x] - ra[x];
+        }
+    }
+    return total;
+}
+
+static uint64_t neon_dot(const uint8_t* a, int32_t a_stride,
+                         const uint8_t* b, int32_t b_stride,
+                         int32_t width, int32_t height) {
+    uint64_t total = 0;
+
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* ra = a + static_cast<size_t>(y) * a_stride;
+        const uint8_t* rb = b + static_cast<size_t>(y) * b_stride;
+
+        // u32 lanes gain at most 4 * 255^2 per step; widened every row
+        uint32x4_t acc = vdupq_n_u32(0);
+        int32_t x = 0;
+        for (; x + 16 <= width; x += 16) {
+            uint8x16_t va = vld1q_u8(ra + x);
+            uint8x16_t vb = vld1q_u8(rb + x);
+            acc = vpadalq_u16(acc, vmull_u8(vget_low_u8(va), vget_low_u8(vb)));
+            acc = vpadalq_u16(acc, vmull_high_u8(va, vb));
+        }
+        total += vaddlvq_u32(acc);
+
+        for (; x < width; ++x) {
+            total += static_cast<uint32_t>(ra[x]) * rb[x];
+        }
+    }
+    return total;
+}
+
+const KernelTable kNeonKernels = {
+    "neon",
+    neon_bgra_to_rgb,
+    neon_bgra_to_gray,
+    neon_lerp_row,
+    neon_halve,
+    neon_sad,
+    neon_dot,
+};
+
+} // namespace neuro
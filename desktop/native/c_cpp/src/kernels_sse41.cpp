@@ -0,0 +1,193 @@
+// SSE4.1 kernels (compiled with -msse4.1; selected at runtime).
+
+#include "kernels.hpp"
+
+#include <smmintrin.h>
+
+namespace neuro {
+
+static void sse41_bgra_to_rgb(const uint8_t* src, int32_t src_stride,
+                              uint8_t* dst, int32_t dst_stride,
+                              int32_t width, int32_t height) {
+    // 4 BGRA pixels -> 12 RGB bytes (last 4 lanes zeroed)
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* s = src + static_cast<size_t>(y) * src_stride;
+        uint8_t*       d = dst + static_cast<size_t>(y) * dst_stride;
+
+        int32_t x = 0;
+        // Each 16-byte store spills 4 bytes that the next one overwrites,
+        // so stop while at least 2 more pixels remain in the row.
+        for (; x + 6 <= width; x += 4, s += 16, d += 12) {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm_shuffle_epi8(px, shuffle));
+        }
+        for (; x < width; ++x, s += 4, d += 3) {
+            d[0] = s[2];
+            d[1] = s[1];
+            d[2] = s[0];
+        }
+    }
+}
+
+static void sse41_bgra_to_gray(const uint8_t* src, int32_t src_stride,
+                               uint8_t* dst, int32_t dst_stride,
+                               int32_t width, int32_t height) {
+    const __m128i weights = _mm_setr_epi8(15, 75, 38, 0, 15, 75, 38, 0, 15, 75, 38, 0, 15, 75, 38, 0);
+    const __m128i round   = _mm_set1_epi16(64);
+
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* s = src + static_cast<size_t>(y) * src_stride;
+        uint8_t*       d = dst + static_cast<size_t>(y) * dst_stride;
+
+        int32_t x = 0;
+        for (; x + 16 <= width; x += 16, s += 64) {
+            __m128i m0 = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s)), weights);
+            __m128i m1 = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16)), weights);
+            __m128i m2 = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32)), weights);
+            __m128i m3 = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48)), weights);
+
+            __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_hadd_epi16(m0, m1), round), 7);
+            __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_hadd_epi16(m2, m3), round), 7);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x), _mm_packus_epi16(lo, hi));
+        }
+        for (; x < width; ++x, s += 4) {
+            d[x] = static_cast<uint8_t>((s[0] * 15 + s[1] * 75 + s[2] * 38 + 64) >> 7);
+        }
+    }
+}
+
+static void sse41_lerp_row(const uint8_t* a, const uint8_t* b, uint8_t* dst,
+                           size_t bytes, uint32_t weight) {
+    const __m128i wb    = _mm_set1_epi16(static_cast<short>(weight));
+    const __m128i wa    = _mm_set1_epi16(static_cast<short>(256 - weight));
+    const __m128i round = _mm_set1_epi16(128);
+
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_cvtepu8_epi16(va), wa),
+                                   _mm_mullo_epi16(_mm_cvtepu8_epi16(vb), wb));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(va, 8)), wa),
+                                   _mm_mullo_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(vb, 8)), wb));
+
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+
+    uint32_t inv = 256 - weight;
+    for (; i < bytes; ++i) {
+        dst[i] = static_cast<uint8_t>((a[i] * inv + b[i] * weight + 128) >> 8);
+    }
+}
+
+void sse41_halve(const uint8_t* src, int32_t src_stride,
+                        uint8_t* dst, int32_t dst_stride,
+                        int32_t dst_width, int32_t dst_height) {
+    const __m128i round = _mm_set1_epi16(2);
+
+    for (int32_t y = 0; y < dst_height; ++y) {
+        const uint8_t* r0 = src + static_cast<size_t>(y) * 2 * src_stride;
+        const uint8_t* r1 = r0 + src_stride;
+        uint8_t*       d  = dst + static_cast<size_t>(y) * dst_stride;
+
+        int32_t x = 0;
+        // 4 source pixels per row -> 2 output pixels
+        for (; x + 2 <= dst_width; x += 2, r0 += 16, r1 += 16, d += 8) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1));
+
+            __m128i lo = _mm_add_epi16(_mm_cvtepu8_epi16(a), _mm_cvtepu8_epi16(b));
+            __m128i hi = _mm_add_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(a, 8)),
+                                       _mm_cvtepu8_epi16(_mm_srli_si128(b, 8)));
+
+            // Add horizontally neighbouring pixels (upper 64 bits onto lower)
+            lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+            hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+            __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), round), 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(d), _mm_packus_epi16(sum, sum));
+        }
+        for (; x < dst_width; ++x, r0 += 8, r1 += 8, d += 4) {
+            for (int c = 0; c < 4; ++c) {
+                d[c] = static_cast<uint8_t>((r0[c] + r0[c + 4] + r1[c] + r1[c + 4] + 2) >> 2);
+            }
+        }
+    }
+}
+
+static uint64_t sse41_sad(const uint8_t* a, int32_t a_stride,
+                          const uint8_t* b, int32_t b_stride,
+                          int32_t width_bytes, int32_t height) {
+    __m128i acc = _mm_setzero_si128();
+    uint64_t tail = 0;
+
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* ra = a + static_cast<size_t>(y) * a_stride;
+        const uint8_t* rb = b + static_cast<size_t>(y) * b_stride;
+
+        int32_t x = 0;
+        for (; x + 16 <= width_bytes; x += 16) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ra + x));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rb + x));
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+        }
+        for (; x < width_bytes; ++x) {
+            tail += ra[x] > rb[x] ? ra[x] - rb[x] : rb[x] - ra[x];
+        }
+    }
+
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + tail;
+}
+
+static uint64_t sse41_dot(const uint8_t* a, int32_t a_stride,
+                          const uint8_t* b, int32_t b_stride,
+                          int32_t width, int32_t height) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i total = _mm_setzero_si128();
+    uint64_t tail = 0;
+
+    for (int32_t y = 0; y < height; ++y) {
+        const uint8_t* ra = a + static_cast<size_t>(y) * a_stride;
+        const uint8_t* rb = b + static_cast<size_t>(y) * b_stride;
+
+        // u32 lanes gain at most 4 * 255^2 per step: flushed every row,
+        // they hold rows up to ~64K samples
+        __m128i acc = _mm_setzero_si128();
+        int32_t x = 0;
+        for (; x + 16 <= width; x += 16) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ra + x));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rb + x));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(va, zero), _mm_unpacklo_epi8(vb, zero)));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpackhi_epi8(va, zero), _mm_unpackhi_epi8(vb, zero)));
+        }
+        total = _mm_add_epi64(total, _mm_unpacklo_epi32(acc, zero));
+        total = _mm_add_epi64(total, _mm_unpackhi_epi32(acc, zero));
+
+        for (; x < width; ++x) {
+            tail += static_cast<uint32_t>(ra[x]) * rb[x];
+        }
+    }
+
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), total);
+    return lanes[0] + lanes[1] + tail;
+}
+
+const KernelTable kSse41Kernels = {
+    "sse4.1",
+    sse41_bgra_to_rgb,
+    sse41_bgra_to_gray,
+    sse41_lerp_row,
+    sse41_halve,
+    sse41_sad,
+    sse41_dot,
+};
+
+} // namespace neuro
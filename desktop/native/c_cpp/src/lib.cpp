@@ -0,0 +1,1898 @@
+// C ABI entrypoint for neuro_native (see include/neuro_native.h).
+//
+// Thin wrappers only: every function converts arguments, forwards to the
+// C++ engine and maps the result back to an nn_status.
+
+#include "neuro_native.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#include "action_queue.hpp"
+#include "backend.hpp"
+#include "capture.hpp"
+#include "input.hpp"
+#include "input_hook.hpp"
+#include "kernels.hpp"
+#include "matcher.hpp"
+#include "clock.hpp"
+#include "metrics.hpp"
+#include "encoder.hpp"
+#include "executor.hpp"
+#include "history.hpp"
+#include "monitors.hpp"
+#include "path.hpp"
+#include "process_tracker.hpp"
+#include "scheduler.hpp"
+#include "screen_state.hpp"
+#include "script.hpp"
+#include "status.hpp"
+#include "telemetry.hpp"
+#include "timeline.hpp"
+#include "ui_tree.hpp"
+#include "window_cache.hpp"
+
+using namespace neuro;
+
+// =====================================================
+// Status codes
+// =====================================================
+
+extern "C" NN_API const char* nn_status_string(nn_status status) {
+    switch (status) {
+        case NN_OK:                   return "ok";
+        case NN_ERR_UNAVAILABLE:      return "unavailable";
+        case NN_ERR_INVALID_ARGUMENT: return "invalid argument";
+        case NN_ERR_BUSY:             return "busy";
+        case NN_ERR_TIMEOUT:          return "timeout";
+        case NN_ERR_FAILED:           return "failed";
+        case NN_ERR_SYNTAX:           return "syntax error";
+        case NN_ERR_CANCELLED:        return "cancelled";
+        default:                      return "unknown";
+    }
+}
+
+extern "C" NN_API uint32_t nn_backend(void) {
+    return static_cast<uint32_t>(kBackend);
+}
+
+extern "C" NN_API const char* nn_backend_name(uint32_t backend) {
+    switch (backend) {
+        case NN_BACKEND_NULL:   return "null";
+        case NN_BACKEND_WIN32:  return "win32";
+        case NN_BACKEND_X11:    return "x11";
+        case NN_BACKEND_UINPUT: return "uinput";
+        default:                return "unknown";
+    }
+}
+
+// =====================================================
+// Screen capture
+// =====================================================
+
+struct nn_capture {
+    std::unique_ptr<CaptureSession> owned; // null for multi-capture outputs
+    CaptureSession*                 session = nullptr;
+};
+
+extern "C" NN_API nn_status nn_capture_open(const nn_capture_options* options, nn_capture** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+
+    CaptureOptions opts;
+    if (options) {
+        opts.output     = options->output;
+        opts.ring_slots = options->ring_slots;
+    }
+
+    auto handle = std::make_unique<nn_capture>();
+    Status status = CaptureSession::open(opts, handle->owned);
+    if (status != Status::Ok) {
+        return to_c(status);
+    }
+    handle->session = handle->owned.get();
+
+    *out = handle.release();
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_capture_close(nn_capture* session) {
+    delete session;
+}
+
+static void export_frame(const Frame& frame, nn_frame* out) {
+    out->data         = frame.data;
+    out->width        = frame.width;
+    out->height       = frame.height;
+    out->stride       = frame.stride;
+    out->format       = NN_PIXEL_BGRA;
+    out->slot         = frame.slot;
+    out->flags        = frame.flags;
+    out->sequence     = frame.sequence;
+    out->timestamp_ns = frame.timestamp_ns;
+}
+
+extern "C" NN_API nn_status nn_capture_grab(nn_capture* session, uint32_t timeout_ms, nn_frame* out) {
+    if (!session || !out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    Frame frame;
+    Status status = session->session->grab(timeout_ms, frame);
+    if (status != Status::Ok) {
+        return to_c(status);
+    }
+
+    export_frame(frame, out);
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_capture_grab_damage(nn_capture* session, uint32_t timeout_ms,
+                                                   uint32_t tile_size, nn_frame* out,
+                                                   nn_rect* rects, uint32_t max_rects,
+                                                   uint32_t* rect_count) {
+    if (!session || !out || !rect_count) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    static_assert(sizeof(nn_rect) == sizeof(Rect), "nn_rect must mirror neuro::Rect");
+
+    Frame frame;
+    Status status = session->session->grab_damage(timeout_ms, tile_size, frame,
+                                                  reinterpret_cast<Rect*>(rects),
+                                                  max_rects, *rect_count);
+    if (status != Status::Ok) {
+        return to_c(status);
+    }
+
+    export_frame(frame, out);
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_capture_release(nn_capture* session, uint32_t slot) {
+    if (!session) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(session->session->release(slot));
+}
+
+// =====================================================
+// Frame kernels
+// =====================================================
+
+static bool view_of(const nn_frame* frame, ImageView& view) {
+    if (!frame || !frame->data || frame->width <= 0 || frame->height <= 0
+        || frame->stride < frame->width * 4 || frame->format != NN_PIXEL_BGRA) {
+        return false;
+    }
+    view.data   = frame->data;
+    view.width  = frame->width;
+    view.height = frame->height;
+    view.stride = frame->stride;
+    return true;
+}
+
+static bool valid_tile(uint32_t tile_size) {
+    return tile_size >= 4 && tile_size <= 4096;
+}
+
+extern "C" NN_API uint32_t nn_cpu_features(void) {
+    return cpu_features();
+}
+
+extern "C" NN_API const char* nn_kernel_isa(void) {
+    return kernels().isa;
+}
+
+extern "C" NN_API nn_status nn_convert_rgb(const nn_frame* src, uint8_t* dst, int32_t dst_stride) {
+    ImageView view;
+    if (!view_of(src, view) || !dst || dst_stride < view.width * 3) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    kernels().bgra_to_rgb(view.data, view.stride, dst, dst_stride, view.width, view.height);
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_convert_gray(const nn_frame* src, uint8_t* dst, int32_t dst_stride) {
+    ImageView view;
+    if (!view_of(src, view) || !dst || dst_stride < view.width) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    kernels().bgra_to_gray(view.data, view.stride, dst, dst_stride, view.width, view.height);
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_downscale(const nn_frame* src, uint8_t* dst, int32_t width,
+                                         int32_t height, int32_t dst_stride, uint32_t filter) {
+    ImageView view;
+    if (!view_of(src, view) || !dst || width <= 0 || height <= 0 || dst_stride < width * 4
+        || filter > NN_FILTER_BILINEAR) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    downscale(view, dst, width, height, dst_stride, static_cast<Filter>(filter));
+    return NN_OK;
+}
+
+extern "C" NN_API size_t nn_tile_count(int32_t width, int32_t height, uint32_t tile_size) {
+    if (width <= 0 || height <= 0 || !valid_tile(tile_size)) {
+        return 0;
+    }
+    size_t tiles_x = (static_cast<size_t>(width) + tile_size - 1) / tile_size;
+    size_t tiles_y = (static_cast<size_t>(height) + tile_size - 1) / tile_size;
+    return tiles_x * tiles_y;
+}
+
+extern "C" NN_API nn_status nn_tile_diff(const nn_frame* a, const nn_frame* b, uint32_t tile_size,
+                                         uint32_t threshold, uint8_t* map, size_t map_len,
+                                         uint32_t* changed) {
+    ImageView va, vb;
+    if (!view_of(a, va) || !view_of(b, vb) || !map || !valid_tile(tile_size)
+        || va.width != vb.width || va.height != vb.height
+        || map_len < nn_tile_count(va.width, va.height, tile_size)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    uint32_t count = tile_diff(va, vb, tile_size, threshold, map);
+    if (changed) {
+        *changed = count;
+    }
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_tile_hashes(const nn_frame* src, uint32_t tile_size,
+                                           uint64_t* out, size_t out_len) {
+    ImageView view;
+    if (!view_of(src, view) || !out || !valid_tile(tile_size)
+        || out_len < nn_tile_count(view.width, view.height, tile_size)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    tile_hashes(view, tile_size, out);
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_perceptual_hashes(const nn_frame* src, uint32_t tile_size, uint64_t* frame_hash,
+                                                 uint64_t* tiles, size_t tiles_len) {
+    ImageView view;
+    if (!view_of(src, view) || (tiles && (!valid_tile(tile_size)
+                                          || tiles_len < nn_tile_count(view.width, view.height, tile_size)))) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    if (frame_hash) {
+        *frame_hash = perceptual_hash(view, 0, 0, view.width, view.height);
+    }
+    if (tiles) {
+        tile_perceptual_hashes(view, tile_size, tiles);
+    }
+    return NN_OK;
+}
+
+extern "C" NN_API uint32_t nn_phash_distance(uint64_t a, uint64_t b) {
+    return phash_distance(a, b);
+}
+
+// =====================================================
+// Template matching
+// =====================================================
+
+extern "C" NN_API nn_status nn_template_add(const char* name, const nn_frame* image) {
+    ImageView view;
+    if (!name || !view_of(image, view)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(TemplateMatcher::instance().add(name, view));
+}
+
+extern "C" NN_API nn_status nn_template_remove(const char* name) {
+    if (!name) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(TemplateMatcher::instance().remove(name));
+}
+
+extern "C" NN_API void nn_template_clear(void) {
+    TemplateMatcher::instance().clear();
+}
+
+extern "C" NN_API nn_status nn_match_template(const nn_frame* frame, const char* name,
+                                              const nn_match_options* options, nn_match* out,
+                                              uint32_t max, uint32_t* count) {
+    ImageView view;
+    if (!name || !count || !view_of(frame, view)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    MatchOptions resolved = options ? *options : MatchOptions{};
+    return to_c(TemplateMatcher::instance().match(view, name, resolved, out, max, *count));
+}
+
+extern "C" NN_API nn_status nn_locate(const char* name, const nn_match_options* options, nn_match* out) {
+    if (!name || !out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    MatchOptions resolved = options ? *options : MatchOptions{};
+    return to_c(TemplateMatcher::instance().locate(name, resolved, *out));
+}
+
+// =====================================================
+// Telemetry ring
+// =====================================================
+
+struct nn_telemetry {
+    explicit nn_telemetry(size_t capacity, bool shared = false, int journal = -1)
+        : ring(capacity, journal), shared(shared) {}
+    TelemetryRing ring;
+    bool          shared;
+};
+
+extern "C" NN_API uint64_t nn_clock_ns(void) {
+    return monotonic_ns();
+}
+
+extern "C" NN_API nn_status nn_telemetry_create(uint32_t capacity, nn_telemetry** out) {
+    if (!out || capacity == 0 || capacity > (1u << 24)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = new nn_telemetry(capacity);
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_telemetry_destroy(nn_telemetry* ring) {
+    if (ring && !ring->shared) {
+        delete ring;
+    }
+}
+
+extern "C" NN_API uint32_t nn_telemetry_capacity(const nn_telemetry* ring) {
+    return ring ? static_cast<uint32_t>(ring->ring.capacity()) : 0;
+}
+
+extern "C" NN_API uint64_t nn_telemetry_push(nn_telemetry* ring, const nn_record* record) {
+    if (!ring || !record) {
+        return 0;
+    }
+    return ring->ring.push(*record);
+}
+
+extern "C" NN_API uint64_t nn_telemetry_push_event(nn_telemetry* ring, uint16_t source, uint16_t type,
+                                                   int32_t x, int32_t y, int64_t arg, double value) {
+    if (!ring) {
+        return 0;
+    }
+
+    Record record = {};
+    record.source = source;
+    record.type   = type;
+    record.x      = x;
+    record.y      = y;
+    record.arg    = arg;
+    record.value  = value;
+    return ring->ring.push(record);
+}
+
+extern "C" NN_API size_t nn_telemetry_snapshot(const nn_telemetry* ring, uint64_t since,
+                                               nn_record* out, size_t max) {
+    if (!ring || (!out && max)) {
+        return 0;
+    }
+    return ring->ring.snapshot(since, out, max);
+}
+
+extern "C" NN_API uint64_t nn_telemetry_head(const nn_telemetry* ring) {
+    return ring ? ring->ring.head() : 0;
+}
+
+extern "C" NN_API void nn_telemetry_clear(nn_telemetry* ring) {
+    if (ring) {
+        ring->ring.clear();
+    }
+}
+
+extern "C" NN_API nn_telemetry* nn_telemetry_channel(uint32_t channel, uint32_t capacity) {
+    static std::mutex    lock;
+    static nn_telemetry* channels[NN_CHANNEL_COUNT] = {};
+
+    if (channel >= NN_CHANNEL_COUNT || capacity > (1u << 24)) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (!channels[channel]) {
+        // Leaked on purpose: readers may outlive any particular owner.
+        channels[channel] = new nn_telemetry(capacity ? capacity : 4096, true, static_cast<int>(channel));
+    }
+    return channels[channel];
+}
+
+// =====================================================
+// History log
+// =====================================================
+
+struct nn_history_file {
+    HistoryFile file;
+};
+
+extern "C" NN_API nn_status nn_history_start(const char* path, const nn_history_options* options) {
+    HistoryOptions resolved = {};
+    if (options) {
+        resolved = *options;
+    }
+    return to_c(History::start(path, resolved));
+}
+
+extern "C" NN_API void nn_history_stop(void) {
+    History::stop();
+}
+
+extern "C" NN_API nn_status nn_history_name(uint16_t id, const char* name) {
+    return to_c(History::name(id, name));
+}
+
+extern "C" NN_API nn_status nn_history_flush(void) {
+    return to_c(History::flush());
+}
+
+extern "C" NN_API nn_status nn_history_rotate(void) {
+    return to_c(History::rotate());
+}
+
+extern "C" NN_API nn_status nn_history_open(const char* path, nn_history_file** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+
+    auto file = std::make_unique<nn_history_file>();
+    Status status = file->file.open(path);
+    if (status != Status::Ok) {
+        return to_c(status);
+    }
+    *out = file.release();
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_history_close(nn_history_file* file) {
+    delete file;
+}
+
+extern "C" NN_API size_t nn_history_records(const nn_history_file* file, const nn_record** records) {
+    if (!file) {
+        return 0;
+    }
+    if (records) {
+        *records = file->file.records();
+    }
+    return file->file.count();
+}
+
+extern "C" NN_API size_t nn_history_range(const nn_history_file* file, uint64_t from_ns, uint64_t to_ns,
+                                          const nn_record** first) {
+    return file ? file->file.range(from_ns, to_ns, first) : 0;
+}
+
+extern "C" NN_API const char* nn_history_name_of(const nn_history_file* file, uint16_t id) {
+    return file ? file->file.name(id) : nullptr;
+}
+
+// =====================================================
+// Metrics
+// =====================================================
+
+extern "C" NN_API nn_status nn_metrics_record(uint32_t metric, uint64_t value) {
+    if (metric >= NN_METRIC_COUNT) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    Metrics::record(metric, value);
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_metrics_span(uint32_t metric, uint64_t start_ns, uint64_t end_ns) {
+    if (metric >= NN_METRIC_COUNT) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    Metrics::span(metric, start_ns, end_ns);
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_metrics_get(uint32_t metric, nn_metric_stats* out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(Metrics::get(metric, *out));
+}
+
+extern "C" NN_API void nn_metrics_reset(void) {
+    Metrics::reset();
+}
+
+extern "C" NN_API const char* nn_metrics_name(uint32_t metric) {
+    return Metrics::name(metric);
+}
+
+extern "C" NN_API nn_status nn_trace_start(uint32_t capacity) {
+    return to_c(Trace::start(capacity));
+}
+
+extern "C" NN_API void nn_trace_stop(void) {
+    Trace::stop();
+}
+
+extern "C" NN_API nn_status nn_trace_write(const char* path) {
+    return to_c(Trace::write(path));
+}
+
+// =====================================================
+// Input hook
+// =====================================================
+
+extern "C" NN_API nn_status nn_mouse_hook_start(nn_telemetry* ring, const nn_mouse_hook_options* options) {
+    if (!ring) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    uint32_t min_interval_us = options ? options->min_interval_us : 0;
+    uint32_t poll_hz         = options ? options->poll_hz : 0;
+    return to_c(MouseHook::instance().start(ring->ring, min_interval_us, poll_hz));
+}
+
+extern "C" NN_API void nn_mouse_hook_stop(void) {
+    MouseHook::instance().stop();
+}
+
+extern "C" NN_API nn_status nn_mouse_hook_position(int32_t* x, int32_t* y, uint64_t* timestamp_ns) {
+    if (!x || !y) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    uint64_t ts = 0;
+    if (!MouseHook::instance().position(*x, *y, ts)) {
+        return NN_ERR_UNAVAILABLE;
+    }
+    if (timestamp_ns) {
+        *timestamp_ns = ts;
+    }
+    return NN_OK;
+}
+
+// =====================================================
+// Action scripts
+// =====================================================
+
+struct nn_script {
+    ProgramPtr program;
+};
+
+static void copy_error(const ScriptError& failure, nn_script_error* error) {
+    if (error) {
+        error->line = failure.line;
+        size_t n = std::min(failure.message.size(), sizeof(error->message) - 1);
+        std::memcpy(error->message, failure.message.data(), n);
+        error->message[n] = '\0';
+    }
+}
+
+extern "C" NN_API nn_status nn_script_compile(const char* text, size_t len, nn_script** out,
+                                              nn_script_error* error) {
+    if (!out || (!text && len)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+
+    ProgramPtr program;
+    ScriptError failure;
+    Status status = ScriptCache::instance().compile(std::string_view(text ? text : "", len),
+                                                    program, failure);
+    if (status != Status::Ok) {
+        copy_error(failure, error);
+        return to_c(status);
+    }
+
+    *out = new nn_script{std::move(program)};
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_script_free(nn_script* script) {
+    delete script;
+}
+
+extern "C" NN_API uint64_t nn_script_hash(const nn_script* script) {
+    return script ? script->program->hash() : 0;
+}
+
+extern "C" NN_API const nn_op* nn_script_ops(const nn_script* script, size_t* count) {
+    if (!script) {
+        if (count) {
+            *count = 0;
+        }
+        return nullptr;
+    }
+
+    const auto& ops = script->program->ops();
+    if (count) {
+        *count = ops.size();
+    }
+    return ops.data();
+}
+
+extern "C" NN_API const char* nn_script_string(const nn_script* script, uint32_t index, uint32_t* len) {
+    return script ? script->program->string(index, len) : nullptr;
+}
+
+extern "C" NN_API const nn_point* nn_script_points(const nn_script* script, uint32_t index) {
+    return script ? script->program->points(index) : nullptr;
+}
+
+extern "C" NN_API nn_status nn_script_run(const nn_script* script, const nn_script_host* host) {
+    if (!script || !host) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(run_script(*script->program, *host));
+}
+
+extern "C" NN_API void nn_script_cache_stats(uint64_t* hits, uint64_t* misses, uint32_t* entries) {
+    uint64_t h = 0, m = 0;
+    uint32_t e = 0;
+    ScriptCache::instance().stats(h, m, e);
+    if (hits)    *hits = h;
+    if (misses)  *misses = m;
+    if (entries) *entries = e;
+}
+
+extern "C" NN_API void nn_script_cache_clear(void) {
+    ScriptCache::instance().clear();
+}
+
+// =====================================================
+// Scheduler
+// =====================================================
+
+extern "C" NN_API int64_t nn_schedule_wait(double seconds) {
+    return Scheduler::instance().wait(seconds);
+}
+
+extern "C" NN_API int64_t nn_schedule_wait_until(uint64_t deadline_ns) {
+    return Scheduler::instance().wait_until(deadline_ns);
+}
+
+extern "C" NN_API uint64_t nn_schedule_deadline(void) {
+    return Scheduler::instance().deadline();
+}
+
+extern "C" NN_API void nn_schedule_stats_get(nn_schedule_stats* out) {
+    if (!out) {
+        return;
+    }
+    ScheduleStats stats = Scheduler::instance().stats();
+    out->waits         = stats.waits;
+    out->mean_error_ns = stats.mean_error_ns;
+    out->min_error_ns  = stats.min_error_ns;
+    out->max_error_ns  = stats.max_error_ns;
+    out->stddev_ns     = stats.stddev_ns;
+}
+
+extern "C" NN_API void nn_schedule_stats_reset(void) {
+    Scheduler::instance().reset_stats();
+}
+
+// =====================================================
+// Input injection
+// =====================================================
+
+extern "C" NN_API nn_status nn_input_open(void) {
+    return to_c(InputInjector::instance().open());
+}
+
+extern "C" NN_API nn_status nn_input_key(const char* key, uint32_t action) {
+    if (!key || action > NN_KEY_UP) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(InputInjector::instance().key(key, action));
+}
+
+extern "C" NN_API nn_status nn_input_hotkey(const char* const* keys, uint32_t count) {
+    if (!keys && count) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(InputInjector::instance().hotkey(keys, count));
+}
+
+extern "C" NN_API nn_status nn_input_type(const char* text, size_t len, double interval_seconds) {
+    if (!text && len) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(InputInjector::instance().type(std::string_view(text ? text : "", len),
+                                               interval_seconds));
+}
+
+extern "C" NN_API nn_status nn_input_move(int32_t x, int32_t y, double seconds) {
+    return to_c(InputInjector::instance().move(x, y, seconds));
+}
+
+extern "C" NN_API nn_status nn_input_click(int32_t x, int32_t y, uint32_t button) {
+    return to_c(InputInjector::instance().click(x, y, button));
+}
+
+extern "C" NN_API nn_status nn_input_path(const nn_point* points, uint32_t count, double step_seconds) {
+    if (!points && count) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(InputInjector::instance().path(points, count, step_seconds));
+}
+
+extern "C" NN_API nn_status nn_input_screen_size(int32_t* width, int32_t* height) {
+    if (!width || !height) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(InputInjector::instance().screen_size(*width, *height));
+}
+
+extern "C" NN_API nn_status nn_input_set_text_options(const nn_text_options* options) {
+    if (!options || options->mode > NN_TEXT_UNICODE) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    InputInjector::instance().set_text_options(options->mode, options->paste_threshold);
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_input_text_options(nn_text_options* out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    InputInjector::instance().text_options(out->mode, out->paste_threshold);
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_input_paste(const char* text, size_t len) {
+    if (!text && len) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(InputInjector::instance().paste(std::string_view(text ? text : "", len)));
+}
+
+extern "C" NN_API const nn_script_host* nn_input_script_host(void) {
+    return &native_script_host();
+}
+
+extern "C" NN_API nn_status nn_script_execute(const char* text, size_t len, nn_script_error* error) {
+    nn_script* script = nullptr;
+    nn_status status = nn_script_compile(text, len, &script, error);
+    if (status != NN_OK) {
+        return status;
+    }
+
+    InputBatch batch;
+    nn_script_host host = batched_script_host(batch);
+    status = nn_script_run(script, &host);
+    nn_script_free(script);
+
+    nn_status sent = to_c(batch.send());
+    return status != NN_OK ? status : sent;
+}
+
+extern "C" NN_API nn_status nn_script_stream(const char* text, size_t len, nn_script_error* error) {
+    if (!text && len) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    InputBatch batch;
+    nn_script_host host = batched_script_host(batch);
+    ScriptError failure;
+    Status status = stream_script(std::string_view(text ? text : "", len), host,
+                                  [&] { return batch.size() ? batch.send() : Status::Ok; }, failure);
+    if (status == Status::Syntax) {
+        copy_error(failure, error);
+    }
+
+    Status sent = batch.send();
+    return to_c(status != Status::Ok ? status : sent);
+}
+
+// -----------------------------------------------------
+// Batches
+// -----------------------------------------------------
+
+struct nn_input_batch {
+    InputBatch batch;
+};
+
+extern "C" NN_API nn_status nn_input_batch_create(nn_input_batch** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = new nn_input_batch();
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_input_batch_free(nn_input_batch* batch) {
+    delete batch;
+}
+
+extern "C" NN_API nn_status nn_input_batch_key(nn_input_batch* batch, const char* key, uint32_t action) {
+    if (!batch || !key || action > NN_KEY_UP) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(batch->batch.key(key, action));
+}
+
+extern "C" NN_API nn_status nn_input_batch_hotkey(nn_input_batch* batch, const char* const* keys,
+                                                  uint32_t count) {
+    if (!batch || (!keys && count)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(batch->batch.hotkey(keys, count));
+}
+
+extern "C" NN_API nn_status nn_input_batch_type(nn_input_batch* batch, const char* text, size_t len) {
+    if (!batch || (!text && len)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(batch->batch.type(std::string_view(text ? text : "", len)));
+}
+
+extern "C" NN_API nn_status nn_input_batch_move(nn_input_batch* batch, int32_t x, int32_t y) {
+    if (!batch) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(batch->batch.move(x, y));
+}
+
+extern "C" NN_API nn_status nn_input_batch_click(nn_input_batch* batch, int32_t x, int32_t y,
+                                                 uint32_t button) {
+    if (!batch) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(batch->batch.click(x, y, button));
+}
+
+extern "C" NN_API nn_status nn_input_batch_path(nn_input_batch* batch, const nn_point* points,
+                                                uint32_t count) {
+    if (!batch || (!points && count)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(batch->batch.path(points, count));
+}
+
+extern "C" NN_API size_t nn_input_batch_size(const nn_input_batch* batch) {
+    return batch ? batch->batch.size() : 0;
+}
+
+extern "C" NN_API nn_status nn_input_batch_send(nn_input_batch* batch) {
+    if (!batch) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(batch->batch.send());
+}
+
+extern "C" NN_API void nn_input_batch_clear(nn_input_batch* batch) {
+    if (batch) {
+        batch->batch.clear();
+    }
+}
+
+// =====================================================
+// Input timeline
+// =====================================================
+
+struct nn_timeline {
+    Timeline timeline;
+};
+
+extern "C" NN_API nn_status nn_timeline_create(nn_timeline** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = new nn_timeline();
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_timeline_free(nn_timeline* timeline) {
+    delete timeline;
+}
+
+extern "C" NN_API nn_status nn_timeline_key(nn_timeline* timeline, uint32_t lane, const char* key,
+                                            uint32_t action) {
+    if (!timeline || !key || action > NN_KEY_UP) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(timeline->timeline.key(lane, key, action));
+}
+
+extern "C" NN_API nn_status nn_timeline_hotkey(nn_timeline* timeline, uint32_t lane,
+                                               const char* const* keys, uint32_t count) {
+    if (!timeline || (!keys && count)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(timeline->timeline.hotkey(lane, keys, count));
+}
+
+extern "C" NN_API nn_status nn_timeline_type(nn_timeline* timeline, uint32_t lane, const char* text,
+                                             size_t len, double interval_seconds) {
+    if (!timeline || (!text && len)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(timeline->timeline.type(lane, std::string_view(text ? text : "", len),
+                                        interval_seconds));
+}
+
+extern "C" NN_API nn_status nn_timeline_move(nn_timeline* timeline, uint32_t lane, int32_t x,
+                                             int32_t y, double seconds) {
+    if (!timeline) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(timeline->timeline.move(lane, x, y, seconds));
+}
+
+extern "C" NN_API nn_status nn_timeline_click(nn_timeline* timeline, uint32_t lane, int32_t x,
+                                              int32_t y, uint32_t button) {
+    if (!timeline) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(timeline->timeline.click(lane, x, y, button));
+}
+
+extern "C" NN_API nn_status nn_timeline_path(nn_timeline* timeline, uint32_t lane,
+                                             const nn_point* points, uint32_t count,
+                                             double step_seconds) {
+    if (!timeline || (!points && count)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(timeline->timeline.path(lane, points, count, step_seconds));
+}
+
+extern "C" NN_API nn_status nn_timeline_wait(nn_timeline* timeline, uint32_t lane, double seconds) {
+    if (!timeline) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(timeline->timeline.wait(lane, seconds));
+}
+
+extern "C" NN_API nn_status nn_timeline_sync(nn_timeline* timeline, double seconds) {
+    if (!timeline) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    timeline->timeline.sync(seconds);
+    return NN_OK;
+}
+
+extern "C" NN_API size_t nn_timeline_size(const nn_timeline* timeline) {
+    return timeline ? timeline->timeline.size() : 0;
+}
+
+extern "C" NN_API uint64_t nn_timeline_duration_ns(const nn_timeline* timeline) {
+    return timeline ? timeline->timeline.duration_ns() : 0;
+}
+
+extern "C" NN_API nn_status nn_timeline_run(nn_timeline* timeline) {
+    if (!timeline) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(timeline->timeline.run());
+}
+
+extern "C" NN_API void nn_timeline_clear(nn_timeline* timeline) {
+    if (timeline) {
+        timeline->timeline.clear();
+    }
+}
+
+// =====================================================
+// Path generation
+// =====================================================
+
+struct nn_path {
+    PathOptions           options;
+    std::vector<nn_point> points;
+};
+
+template <typename Fn>
+static nn_status path_append(nn_path* path, Fn&& fn) {
+    if (!path) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    PathBuilder builder(path->points, path->options);
+    return fn(builder) ? NN_OK : NN_ERR_INVALID_ARGUMENT;
+}
+
+extern "C" NN_API nn_status nn_path_create(const nn_path_options* options, nn_path** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = new nn_path();
+    if (options) {
+        (*out)->options.spacing      = options->spacing;
+        (*out)->options.velocity     = options->velocity;
+        (*out)->options.step_seconds = options->step_seconds;
+        if (options->tolerance > 0) {
+            (*out)->options.tolerance = options->tolerance;
+        }
+    }
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_path_free(nn_path* path) {
+    delete path;
+}
+
+extern "C" NN_API void nn_path_clear(nn_path* path) {
+    if (path) {
+        path->points.clear();
+    }
+}
+
+extern "C" NN_API nn_status nn_path_line_steps(nn_path* path, nn_point from, nn_point to, int64_t steps) {
+    if (steps <= 0) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return path_append(path, [&](PathBuilder& builder) { return builder.line_steps(from, to, steps); });
+}
+
+extern "C" NN_API nn_status nn_path_line(nn_path* path, nn_point from, nn_point to) {
+    return path_append(path, [&](PathBuilder& builder) { return builder.line(from, to); });
+}
+
+extern "C" NN_API nn_status nn_path_polyline(nn_path* path, const nn_point* points, size_t count) {
+    if (!points && count) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return path_append(path, [&](PathBuilder& builder) { return builder.polyline(points, count); });
+}
+
+extern "C" NN_API nn_status nn_path_bezier(nn_path* path, const nn_point* control, size_t count) {
+    if (!control) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return path_append(path, [&](PathBuilder& builder) { return builder.bezier(control, count); });
+}
+
+extern "C" NN_API nn_status nn_path_catmull_rom(nn_path* path, const nn_point* points, size_t count) {
+    if (!points && count) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return path_append(path, [&](PathBuilder& builder) { return builder.catmull_rom(points, count); });
+}
+
+extern "C" NN_API nn_status nn_path_clamp(nn_path* path, int32_t width, int32_t height) {
+    if (!path || width <= 0 || height <= 0) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    clamp_points(path->points.data(), path->points.size(), width, height);
+    return NN_OK;
+}
+
+extern "C" NN_API const nn_point* nn_path_points(const nn_path* path, size_t* count) {
+    if (count) {
+        *count = path ? path->points.size() : 0;
+    }
+    return path ? path->points.data() : nullptr;
+}
+
+// =====================================================
+// Window state
+// =====================================================
+
+struct nn_window_snapshot {
+    WindowSnapshotPtr snapshot;
+};
+
+extern "C" NN_API nn_status nn_window_cache_start(void) {
+    return to_c(WindowCache::instance().start());
+}
+
+extern "C" NN_API void nn_window_cache_stop(void) {
+    WindowCache::instance().stop();
+}
+
+extern "C" NN_API uint64_t nn_window_cache_version(void) {
+    return WindowCache::instance().version();
+}
+
+extern "C" NN_API nn_status nn_window_snapshot_get(nn_window_snapshot** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+
+    WindowSnapshotPtr snapshot = WindowCache::instance().snapshot();
+    if (!snapshot) {
+        return NN_ERR_UNAVAILABLE;
+    }
+    *out = new nn_window_snapshot{std::move(snapshot)};
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_window_snapshot_free(nn_window_snapshot* snapshot) {
+    delete snapshot;
+}
+
+extern "C" NN_API uint64_t nn_window_snapshot_version(const nn_window_snapshot* snapshot) {
+    return snapshot ? snapshot->snapshot->version : 0;
+}
+
+extern "C" NN_API size_t nn_window_snapshot_count(const nn_window_snapshot* snapshot) {
+    return snapshot ? snapshot->snapshot->windows.size() : 0;
+}
+
+extern "C" NN_API nn_status nn_window_snapshot_window(const nn_window_snapshot* snapshot, size_t index,
+                                                      nn_window_info* out) {
+    if (!snapshot || !out || index >= snapshot->snapshot->windows.size()) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    const WindowInfo& info = snapshot->snapshot->windows[index];
+    out->id        = info.id;
+    out->pid       = info.pid;
+    out->title_len = static_cast<uint32_t>(info.title.size());
+    out->title     = info.title.c_str();
+    return NN_OK;
+}
+
+extern "C" NN_API int64_t nn_window_snapshot_active(const nn_window_snapshot* snapshot) {
+    return snapshot ? snapshot->snapshot->active : -1;
+}
+
+// =====================================================
+// Accessibility tree
+// =====================================================
+
+struct nn_ui_snapshot {
+    UiSnapshotPtr snapshot;
+};
+
+extern "C" NN_API nn_status nn_ui_tree_start(void) {
+    return to_c(UiTree::instance().start());
+}
+
+extern "C" NN_API void nn_ui_tree_stop(void) {
+    UiTree::instance().stop();
+}
+
+extern "C" NN_API uint64_t nn_ui_tree_version(void) {
+    return UiTree::instance().version();
+}
+
+extern "C" NN_API nn_status nn_ui_snapshot_get(nn_ui_snapshot** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+
+    UiSnapshotPtr snapshot = UiTree::instance().snapshot();
+    if (!snapshot) {
+        return NN_ERR_UNAVAILABLE;
+    }
+    *out = new nn_ui_snapshot{std::move(snapshot)};
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_ui_snapshot_free(nn_ui_snapshot* snapshot) {
+    delete snapshot;
+}
+
+extern "C" NN_API uint64_t nn_ui_snapshot_version(const nn_ui_snapshot* snapshot) {
+    return snapshot ? snapshot->snapshot->version : 0;
+}
+
+extern "C" NN_API uint64_t nn_ui_snapshot_window(const nn_ui_snapshot* snapshot) {
+    return snapshot ? snapshot->snapshot->window : 0;
+}
+
+extern "C" NN_API size_t nn_ui_snapshot_count(const nn_ui_snapshot* snapshot) {
+    return snapshot ? snapshot->snapshot->elements.size() : 0;
+}
+
+extern "C" NN_API nn_status nn_ui_snapshot_element(const nn_ui_snapshot* snapshot, size_t index,
+                                                   nn_ui_element* out) {
+    if (!snapshot || !out || index >= snapshot->snapshot->elements.size()) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    const UiElement& element = snapshot->snapshot->elements[index];
+    const UiNode&    node    = element.node;
+    out->id        = node.id;
+    out->parent    = node.parent;
+    out->depth     = element.depth;
+    out->role      = node.role;
+    out->states    = node.states;
+    out->name_len  = static_cast<uint32_t>(node.name.size());
+    out->value_len = static_cast<uint32_t>(node.value.size());
+    out->reserved  = 0;
+    out->bounds    = nn_rect{node.bounds.x, node.bounds.y, node.bounds.width, node.bounds.height};
+    out->name      = node.name.c_str();
+    out->value     = node.value.c_str();
+    return NN_OK;
+}
+
+extern "C" NN_API int64_t nn_ui_snapshot_focus(const nn_ui_snapshot* snapshot) {
+    return snapshot ? snapshot->snapshot->focus : -1;
+}
+
+extern "C" NN_API int nn_ui_snapshot_truncated(const nn_ui_snapshot* snapshot) {
+    return snapshot && snapshot->snapshot->truncated ? 1 : 0;
+}
+
+extern "C" NN_API nn_status nn_ui_snapshot_text(const nn_ui_snapshot* snapshot, char* out, size_t capacity,
+                                                size_t* len) {
+    if (!snapshot || !out || capacity == 0) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    std::string text;
+    ui_text(*snapshot->snapshot, capacity - 1, text);
+    std::memcpy(out, text.data(), text.size());
+    out[text.size()] = '\0';
+    if (len) {
+        *len = text.size();
+    }
+    return NN_OK;
+}
+
+extern "C" NN_API const char* nn_ui_role_name(uint32_t role) {
+    return ui_role_name(role);
+}
+
+// =====================================================
+// Process tracking
+// =====================================================
+
+struct nn_process_tracker {
+    ProcessTracker tracker;
+};
+
+extern "C" NN_API nn_status nn_process_tracker_create(nn_process_tracker** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = new nn_process_tracker{};
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_process_tracker_free(nn_process_tracker* tracker) {
+    delete tracker;
+}
+
+extern "C" NN_API nn_status nn_process_tracker_refresh(nn_process_tracker* tracker) {
+    if (!tracker) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(tracker->tracker.refresh());
+}
+
+static const nn_process_delta* deltas(const std::vector<ProcessDelta>& list, size_t* count) {
+    if (count) {
+        *count = list.size();
+    }
+    return list.empty() ? nullptr : list.data();
+}
+
+extern "C" NN_API const nn_process_delta* nn_process_tracker_added(const nn_process_tracker* tracker,
+                                                                   size_t* count) {
+    if (!tracker) {
+        if (count) *count = 0;
+        return nullptr;
+    }
+    return deltas(tracker->tracker.added(), count);
+}
+
+extern "C" NN_API const nn_process_delta* nn_process_tracker_removed(const nn_process_tracker* tracker,
+                                                                     size_t* count) {
+    if (!tracker) {
+        if (count) *count = 0;
+        return nullptr;
+    }
+    return deltas(tracker->tracker.removed(), count);
+}
+
+extern "C" NN_API size_t nn_process_tracker_size(const nn_process_tracker* tracker) {
+    return tracker ? tracker->tracker.size() : 0;
+}
+
+extern "C" NN_API size_t nn_process_tracker_list(const nn_process_tracker* tracker,
+                                                 nn_process_delta* out, size_t max) {
+    if (!tracker) {
+        return 0;
+    }
+    return tracker->tracker.list(out, out ? max : 0);
+}
+
+extern "C" NN_API size_t nn_process_name_count(const nn_process_tracker* tracker) {
+    return tracker ? tracker->tracker.name_count() : 0;
+}
+
+extern "C" NN_API const char* nn_process_name(const nn_process_tracker* tracker, uint32_t id,
+                                              uint32_t* len) {
+    if (!tracker || id >= tracker->tracker.name_count()) {
+        if (len) *len = 0;
+        return nullptr;
+    }
+    std::string_view name = tracker->tracker.name(id);
+    if (len) {
+        *len = static_cast<uint32_t>(name.size());
+    }
+    return name.data();
+}
+
+// =====================================================
+// Action executor
+// =====================================================
+
+struct nn_executor {
+    ActionExecutor executor;
+};
+
+extern "C" NN_API nn_status nn_executor_create(const nn_executor_options* options, nn_executor** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    ExecutorOptions opts;
+    if (options) {
+        if (options->capacity) {
+            opts.capacity = options->capacity;
+        }
+        opts.stale_seconds = options->stale_seconds;
+    }
+    *out = new nn_executor{ActionExecutor(opts)};
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_executor_free(nn_executor* executor) {
+    delete executor;
+}
+
+extern "C" NN_API nn_status nn_executor_submit(nn_executor* executor, const char* text, size_t len,
+                                               uint32_t group, uint32_t flags, uint64_t* ticket) {
+    if (!executor || (!text && len)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    uint64_t assigned = 0;
+    Status status = executor->executor.submit(ScriptText(std::string(text ? text : "", len)), group, flags,
+                                              assigned);
+    if (ticket) {
+        *ticket = assigned;
+    }
+    return to_c(status);
+}
+
+extern "C" NN_API nn_status nn_executor_submit_view(nn_executor* executor, const char* text, size_t len,
+                                                    nn_release_fn release, void* user, uint32_t group,
+                                                    uint32_t flags, uint64_t* ticket) {
+    if (!executor || (!text && len) || !release) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    uint64_t assigned = 0;
+    Status status = executor->executor.submit(ScriptText(std::string_view(text ? text : "", len), release, user),
+                                              group, flags, assigned);
+    if (ticket) {
+        *ticket = assigned;
+    }
+    return to_c(status);
+}
+
+extern "C" NN_API nn_status nn_executor_cancel(nn_executor* executor, uint64_t ticket) {
+    if (!executor) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(executor->executor.cancel(ticket));
+}
+
+extern "C" NN_API nn_status nn_executor_next(nn_executor* executor, nn_completion* out, int32_t timeout_ms) {
+    if (!executor || !out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    Completion completion;
+    Status status = executor->executor.next(completion, timeout_ms);
+    if (status != Status::Ok) {
+        return to_c(status);
+    }
+    out->ticket = completion.ticket;
+    out->group  = completion.group;
+    out->status = to_c(completion.status);
+    out->error  = nn_script_error{};
+    copy_error(completion.error, &out->error);
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_executor_close(nn_executor* executor) {
+    if (executor) {
+        executor->executor.close();
+    }
+}
+
+extern "C" NN_API size_t nn_executor_pending(const nn_executor* executor) {
+    return executor ? executor->executor.pending() : 0;
+}
+
+// =====================================================
+// Frame encoder
+// =====================================================
+
+struct nn_encoder {
+    std::unique_ptr<FrameEncoder> encoder;
+};
+
+extern "C" NN_API int nn_codec_available(uint32_t codec) {
+    return codec <= NN_CODEC_WEBP && codec_available(static_cast<Codec>(codec)) ? 1 : 0;
+}
+
+extern "C" NN_API nn_status nn_encoder_create(const nn_encoder_options* options, nn_encoder** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+
+    EncoderOptions opts;
+    if (options) {
+        if (options->codec > NN_CODEC_WEBP || options->filter > NN_FILTER_BILINEAR) {
+            return NN_ERR_INVALID_ARGUMENT;
+        }
+        opts.codec      = static_cast<Codec>(options->codec);
+        opts.max_width  = options->max_width;
+        opts.max_height = options->max_height;
+        opts.filter     = static_cast<Filter>(options->filter);
+        if (options->quality) {
+            opts.quality = options->quality;
+        }
+        if (options->threads) {
+            opts.threads = options->threads;
+        }
+        if (options->buffers) {
+            opts.buffers = options->buffers;
+        }
+    }
+
+    auto handle = std::make_unique<nn_encoder>();
+    Status status = FrameEncoder::create(opts, handle->encoder);
+    if (status != Status::Ok) {
+        return to_c(status);
+    }
+
+    *out = handle.release();
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_encoder_free(nn_encoder* encoder) {
+    delete encoder;
+}
+
+extern "C" NN_API nn_status nn_encoder_submit(nn_encoder* encoder, nn_capture* capture, const nn_frame* frame,
+                                              const nn_rect* rects, uint32_t rect_count) {
+    ImageView view;
+    if (!encoder || !view_of(frame, view) || (!rects && rect_count)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    Frame source;
+    source.data         = frame->data;
+    source.width        = frame->width;
+    source.height       = frame->height;
+    source.stride       = frame->stride;
+    source.slot         = frame->slot;
+    source.flags        = frame->flags;
+    source.sequence     = frame->sequence;
+    source.timestamp_ns = frame->timestamp_ns;
+
+    static_assert(sizeof(nn_rect) == sizeof(Rect), "nn_rect and Rect must match");
+    return to_c(encoder->encoder->submit(capture ? capture->session : nullptr, source,
+                                         reinterpret_cast<const Rect*>(rects), rect_count));
+}
+
+extern "C" NN_API nn_status nn_encoder_next(nn_encoder* encoder, nn_packet* out, int32_t timeout_ms) {
+    if (!encoder || !out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    Packet packet;
+    Status status = encoder->encoder->next(packet, timeout_ms);
+    if (status != Status::Ok) {
+        return to_c(status);
+    }
+
+    out->id            = packet.id;
+    out->status        = to_c(packet.status);
+    out->codec         = static_cast<uint32_t>(packet.codec);
+    out->width         = packet.width;
+    out->height        = packet.height;
+    out->source_width  = packet.source_width;
+    out->source_height = packet.source_height;
+    out->sequence      = packet.sequence;
+    out->timestamp_ns  = packet.timestamp_ns;
+    out->data          = packet.data;
+    out->size          = packet.size;
+    out->rects         = reinterpret_cast<const nn_rect*>(packet.rects);
+    out->rect_count    = packet.rect_count;
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_encoder_release(nn_encoder* encoder, uint32_t id) {
+    if (!encoder) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(encoder->encoder->release(id));
+}
+
+extern "C" NN_API void nn_encoder_close(nn_encoder* encoder) {
+    if (encoder) {
+        encoder->encoder->close();
+    }
+}
+
+// =====================================================
+// Screen-state cache
+// =====================================================
+
+struct nn_screen_cache {
+    ScreenStateCache cache;
+};
+
+extern "C" NN_API nn_status nn_screen_cache_create(const nn_screen_cache_options* options, nn_screen_cache** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+
+    ScreenCacheOptions opts;
+    if (options) {
+        if (options->capacity) {
+            opts.capacity = options->capacity;
+        }
+        if (options->tile_size) {
+            opts.tile_size = options->tile_size;
+        }
+        if (options->history) {
+            opts.history = options->history;
+        }
+        if (options->threshold) {
+            opts.threshold = options->threshold;
+        }
+    }
+    if (opts.capacity > 1024 || opts.history > 4096 || opts.tile_size < 8 || opts.tile_size > 1024) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    *out = new nn_screen_cache{ScreenStateCache(opts)};
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_screen_cache_free(nn_screen_cache* cache) {
+    delete cache;
+}
+
+extern "C" NN_API nn_status nn_screen_cache_observe(nn_screen_cache* cache, const nn_frame* frame,
+                                                    nn_screen_observation* out) {
+    ImageView view;
+    if (!cache || !view_of(frame, view) || !out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    ScreenObservation observation;
+    Status status = cache->cache.observe(view, frame->sequence, observation);
+    if (status != Status::Ok) {
+        return to_c(status);
+    }
+
+    out->state          = observation.state;
+    out->sequence       = observation.sequence;
+    out->first_sequence = observation.first_sequence;
+    out->value          = observation.value;
+    out->frame_hash     = observation.frame_hash;
+    out->changed_tiles  = observation.changed_tiles;
+    out->tile_count     = observation.tile_count;
+    out->known          = observation.known ? 1 : 0;
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_screen_cache_changed_since(const nn_screen_cache* cache, uint64_t sequence,
+                                                          uint32_t* changed_tiles) {
+    if (!cache || !changed_tiles) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(cache->cache.changed_since(sequence, *changed_tiles));
+}
+
+extern "C" NN_API nn_status nn_screen_cache_set_value(nn_screen_cache* cache, uint64_t state, uint64_t value) {
+    if (!cache) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(cache->cache.set_value(state, value));
+}
+
+// =====================================================
+// Monitors
+// =====================================================
+
+static void export_monitor(const Monitor& monitor, nn_monitor* out) {
+    out->index = monitor.index;
+    std::memcpy(&out->bounds, &monitor.bounds, sizeof(nn_rect));
+    out->primary = monitor.primary ? 1 : 0;
+    static_assert(sizeof(out->name) == sizeof(monitor.name), "nn_monitor name must mirror neuro::Monitor");
+    std::memcpy(out->name, monitor.name, sizeof(out->name));
+}
+
+extern "C" NN_API nn_status nn_monitors(nn_monitor* out, uint32_t max, uint32_t* count) {
+    if ((!out && max) || !count) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    std::vector<Monitor> monitors;
+    Status status = MonitorLayout::instance().monitors(monitors);
+    *count = static_cast<uint32_t>(monitors.size());
+    for (uint32_t i = 0; i < std::min(max, *count); ++i) {
+        export_monitor(monitors[i], &out[i]);
+    }
+    return to_c(status);
+}
+
+extern "C" NN_API nn_status nn_monitors_refresh(void) {
+    return to_c(MonitorLayout::instance().refresh());
+}
+
+extern "C" NN_API nn_status nn_virtual_desktop(nn_rect* out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    Rect desktop;
+    Status status = MonitorLayout::instance().desktop(desktop);
+    std::memcpy(out, &desktop, sizeof(nn_rect));
+    return to_c(status);
+}
+
+extern "C" NN_API nn_status nn_map_normalized(int32_t monitor, double nx, double ny, int32_t* x, int32_t* y) {
+    if (!x || !y) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(MonitorLayout::instance().map_normalized(monitor, nx, ny, *x, *y));
+}
+
+extern "C" NN_API nn_status nn_clamp_point(int32_t* x, int32_t* y, int32_t* monitor) {
+    if (!x || !y) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    int32_t index = -1;
+    Status status = MonitorLayout::instance().clamp(*x, *y, index);
+    if (monitor) {
+        *monitor = index;
+    }
+    return to_c(status);
+}
+
+extern "C" NN_API nn_status nn_path_clamp_desktop(nn_path* path) {
+    if (!path) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    std::vector<Monitor> monitors;
+    Status status = MonitorLayout::instance().monitors(monitors);
+    if (status != Status::Ok) {
+        return to_c(status);
+    }
+    for (nn_point& point : path->points) {
+        clamp_to_monitors(monitors.data(), monitors.size(), point.x, point.y);
+    }
+    return NN_OK;
+}
+
+struct nn_multi_capture {
+    std::unique_ptr<MultiCapture> capture;
+    std::vector<nn_capture>       sessions; // borrowed views for nn_capture_* / nn_encoder_*
+    std::mutex                    mutex;    // guards the grab scratch below
+    std::vector<Frame>            frames;
+    std::vector<Status>           statuses;
+};
+
+extern "C" NN_API nn_status nn_multi_capture_open(uint32_t ring_slots, nn_multi_capture** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+
+    auto handle = std::make_unique<nn_multi_capture>();
+    Status status = MultiCapture::open(ring_slots, handle->capture);
+    if (status != Status::Ok) {
+        return to_c(status);
+    }
+
+    uint32_t count = handle->capture->count();
+    handle->sessions.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        handle->sessions[i].session = handle->capture->session(i);
+    }
+    handle->frames.resize(count);
+    handle->statuses.resize(count);
+
+    *out = handle.release();
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_multi_capture_close(nn_multi_capture* capture) {
+    delete capture;
+}
+
+extern "C" NN_API uint32_t nn_multi_capture_count(const nn_multi_capture* capture) {
+    return capture ? capture->capture->count() : 0;
+}
+
+extern "C" NN_API nn_status nn_multi_capture_monitor(const nn_multi_capture* capture, uint32_t output,
+                                                     nn_monitor* out) {
+    if (!capture || output >= capture->capture->count() || !out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    export_monitor(capture->capture->monitor(output), out);
+    return NN_OK;
+}
+
+extern "C" NN_API nn_capture* nn_multi_capture_session(nn_multi_capture* capture, uint32_t output) {
+    if (!capture || output >= capture->sessions.size()) {
+        return nullptr;
+    }
+    return &capture->sessions[output];
+}
+
+extern "C" NN_API nn_status nn_multi_capture_grab(nn_multi_capture* capture, uint32_t timeout_ms,
+                                                  nn_frame* frames, nn_status* statuses, uint32_t count) {
+    if (!capture || !frames || count != capture->capture->count()) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> guard(capture->mutex);
+    Status status = capture->capture->grab(timeout_ms, capture->frames.data(), capture->statuses.data());
+    for (uint32_t i = 0; i < count; ++i) {
+        export_frame(capture->frames[i], &frames[i]);
+        if (statuses) {
+            statuses[i] = to_c(capture->statuses[i]);
+        }
+    }
+    return to_c(status);
+}
+
+extern "C" NN_API nn_status nn_multi_capture_release(nn_multi_capture* capture, uint32_t output, uint32_t slot) {
+    if (!capture) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(capture->capture->release(output, slot));
+}
+
+// =====================================================
+// Action queue
+// =====================================================
+
+struct nn_action_queue {
+    ActionQueue queue;
+};
+
+extern "C" NN_API nn_status nn_action_queue_create(nn_action_queue** out) {
+    if (!out) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    *out = new nn_action_queue();
+    return NN_OK;
+}
+
+extern "C" NN_API void nn_action_queue_free(nn_action_queue* queue) {
+    delete queue;
+}
+
+extern "C" NN_API void nn_action_queue_clear(nn_action_queue* queue) {
+    if (queue) {
+        queue->queue.clear();
+    }
+}
+
+extern "C" NN_API size_t nn_action_queue_size(const nn_action_queue* queue) {
+    return queue ? queue->queue.records().size() : 0;
+}
+
+extern "C" NN_API size_t nn_action_queue_bytes(const nn_action_queue* queue) {
+    return queue ? queue->queue.payload_bytes() : 0;
+}
+
+extern "C" NN_API nn_status nn_action_queue_key(nn_action_queue* queue, uint32_t lane, const char* key,
+                                                uint32_t action, uint32_t repeat) {
+    if (!queue || !key) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(queue->queue.key(lane, key, action, repeat));
+}
+
+extern "C" NN_API nn_status nn_action_queue_type(nn_action_queue* queue, uint32_t lane, const char* text,
+                                                 size_t len, double interval_seconds) {
+    if (!queue || (!text && len)) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(queue->queue.type(lane, std::string_view(text ? text : "", len), interval_seconds));
+}
+
+extern "C" NN_API nn_status nn_action_queue_shortcut(nn_action_queue* queue, uint32_t lane,
+                                                     const char* const* keys, uint32_t count) {
+    if (!queue) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(queue->queue.shortcut(lane, keys, count));
+}
+
+extern "C" NN_API nn_status nn_action_queue_move(nn_action_queue* queue, uint32_t lane, int32_t x,
+                                                 int32_t y, double seconds) {
+    if (!queue) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(queue->queue.move(lane, x, y, seconds));
+}
+
+extern "C" NN_API nn_status nn_action_queue_click(nn_action_queue* queue, uint32_t lane, int32_t x,
+                                                  int32_t y, uint32_t button) {
+    if (!queue) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(queue->queue.click(lane, x, y, button));
+}
+
+extern "C" NN_API nn_status nn_action_queue_path(nn_action_queue* queue, uint32_t lane,
+                                                 const nn_point* points, uint32_t count,
+                                                 double step_seconds) {
+    if (!queue) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(queue->queue.path(lane, points, count, step_seconds));
+}
+
+extern "C" NN_API nn_status nn_action_queue_wait(nn_action_queue* queue, uint32_t lane, double seconds) {
+    if (!queue) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(queue->queue.wait(lane, seconds));
+}
+
+extern "C" NN_API nn_status nn_action_queue_sync(nn_action_queue* queue, double seconds) {
+    if (!queue) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    queue->queue.sync(seconds);
+    return NN_OK;
+}
+
+extern "C" NN_API const nn_action* nn_action_queue_records(const nn_action_queue* queue, size_t* count) {
+    if (!queue) {
+        if (count) {
+            *count = 0;
+        }
+        return nullptr;
+    }
+    const std::vector<Action>& records = queue->queue.records();
+    if (count) {
+        *count = records.size();
+    }
+    return records.data();
+}
+
+extern "C" NN_API const void* nn_action_queue_payload(const nn_action_queue* queue, uint32_t offset) {
+    if (!queue || offset > queue->queue.payload_bytes()) {
+        return nullptr;
+    }
+    return queue->queue.payload(offset);
+}
+
+extern "C" NN_API nn_status nn_action_queue_drop_lane(nn_action_queue* queue, uint32_t lane) {
+    if (!queue || lane >= NN_LANE_COUNT) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    queue->queue.drop_lane(lane);
+    return NN_OK;
+}
+
+extern "C" NN_API nn_status nn_action_queue_schedule(const nn_action_queue* queue, nn_timeline* timeline) {
+    if (!queue || !timeline) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(queue->queue.schedule(timeline->timeline));
+}
+
+extern "C" NN_API nn_status nn_action_queue_execute(const nn_action_queue* queue, uint32_t lane,
+                                                    nn_input_batch* batch) {
+    if (!queue || !batch || lane >= NN_LANE_COUNT) {
+        return NN_ERR_INVALID_ARGUMENT;
+    }
+    return to_c(queue->queue.execute(lane, batch->batch));
+}
@@ -0,0 +1,421 @@
+#include "matcher.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "monitors.hpp"
+#include "work_pool.hpp"
+
+namespace neuro {
+
+namespace {
+
+// The box filter blurs edges, so true matches score lower on coarse
+// levels; candidates are kept down to threshold - slack and re-scored.
+constexpr double   kCoarseSlack   = 0.15;
+constexpr int32_t  kRefineRadius  = 2;
+constexpr int32_t  kBandRows      = 32; // rows per pool item when building pyramids
+constexpr uint32_t kMinCandidates = 16;
+
+struct GrayImage {
+    int32_t              width  = 0;
+    int32_t              height = 0;
+    std::vector<uint8_t> pixels; // packed, stride = width
+
+    const uint8_t* row(int32_t y) const { return pixels.data() + static_cast<size_t>(y) * width; }
+};
+
+// Reused by every search on a thread: a frame pyramid is megabytes, so
+// a warmed-up caller allocates nothing.
+struct Scratch {
+    std::vector<uint8_t>   bgra[2];
+    std::vector<GrayImage> gray; // one per level
+    std::vector<float>     scores;
+};
+
+Scratch& scratch() {
+    static thread_local Scratch instance;
+    return instance;
+}
+
+struct Candidate {
+    int32_t x     = 0;
+    int32_t y     = 0;
+    double  score = 0;
+};
+
+// Calls fn(first_row, end_row) for bands of `rows` on the pool.
+template <typename Fn>
+void for_bands(int32_t rows, Fn&& fn) {
+    auto bands = static_cast<uint32_t>((rows + kBandRows - 1) / kBandRows);
+    WorkPool::shared().parallel_for(bands, [&](uint32_t band) {
+        int32_t first = static_cast<int32_t>(band) * kBandRows;
+        fn(first, std::min(rows, first + kBandRows));
+    });
+}
+
+// Luma of `image` and of `levels - 1` successive 2x halvings of it.
+void build_pyramid(const ImageView& image, uint32_t levels, std::vector<uint8_t> (&bgra)[2],
+                   std::vector<GrayImage>& out) {
+    const KernelTable& k = kernels();
+    out.resize(levels);
+
+    ImageView source = image;
+    for (uint32_t level = 0; level < levels; ++level) {
+        if (level > 0) {
+            int32_t width  = source.width / 2;
+            int32_t height = source.height / 2;
+            std::vector<uint8_t>& halved = bgra[level % 2]; // never the one `source` points into
+            halved.resize(static_cast<size_t>(width) * height * 4);
+
+            ImageView from = source;
+            for_bands(height, [&](int32_t first, int32_t end) {
+                k.halve(from.data + static_cast<size_t>(first) * 2 * from.stride, from.stride,
+                        halved.data() + static_cast<size_t>(first) * width * 4, width * 4, width, end - first);
+            });
+            source = {halved.data(), width, height, width * 4};
+        }
+
+        GrayImage& gray = out[level];
+        gray.width  = source.width;
+        gray.height = source.height;
+        gray.pixels.resize(static_cast<size_t>(source.width) * source.height);
+        for_bands(source.height, [&](int32_t first, int32_t end) {
+            k.bgra_to_gray(source.data + static_cast<size_t>(first) * source.stride, source.stride,
+                           gray.pixels.data() + static_cast<size_t>(first) * gray.width, gray.width,
+                           gray.width, end - first);
+        });
+    }
+}
+
+// (n * sum(wt) - sum(w) * sum(t)) / sqrt(var(w) * var(t)), both
+// variances scaled by n^2; a flat window scores 0.
+double ncc(double cross, double sum, double sum_sq, const TemplateLevel& t) {
+    double n   = static_cast<double>(t.width) * t.height;
+    double var = n * sum_sq - sum * sum;
+    if (var <= 0) {
+        return 0;
+    }
+    return (n * cross - sum * t.sum) / std::sqrt(var * t.energy);
+}
+
+// Score of one window, every term from the kernels (refinement path).
+double score_at(const GrayImage& frame, const TemplateLevel& t, int32_t x, int32_t y) {
+    static thread_local std::vector<uint8_t> zeros;
+    if (zeros.size() < static_cast<size_t>(t.width)) {
+        zeros.assign(t.width, 0);
+    }
+
+    const KernelTable& k = kernels();
+    const uint8_t* window = frame.row(y) + x;
+    auto sum    = static_cast<double>(k.sad(window, frame.width, zeros.data(), 0, t.width, t.height));
+    auto sum_sq = static_cast<double>(k.dot(window, frame.width, window, frame.width, t.width, t.height));
+    auto cross  = static_cast<double>(k.dot(window, frame.width, t.gray.data(), t.width, t.width, t.height));
+    return ncc(cross, sum, sum_sq, t);
+}
+
+// Scores every position of row y (full search). Column sums over the
+// template's rows slide across the row, so the window statistics cost
+// O(1) per position and only the cross term goes through dot().
+void score_row(const GrayImage& frame, const TemplateLevel& t, int32_t y, float* scores) {
+    static thread_local std::vector<uint32_t> column_sum, column_sq;
+    column_sum.assign(frame.width, 0);
+    column_sq.assign(frame.width, 0);
+    for (int32_t r = 0; r < t.height; ++r) {
+        const uint8_t* row = frame.row(y + r);
+        for (int32_t x = 0; x < frame.width; ++x) {
+            column_sum[x] += row[x];
+            column_sq[x]  += static_cast<uint32_t>(row[x]) * row[x];
+        }
+    }
+
+    uint64_t sum = 0, sum_sq = 0;
+    for (int32_t x = 0; x < t.width; ++x) {
+        sum    += column_sum[x];
+        sum_sq += column_sq[x];
+    }
+
+    const KernelTable& k = kernels();
+    const uint8_t* row = frame.row(y);
+    int32_t positions = frame.width - t.width + 1;
+    for (int32_t x = 0;; ++x) {
+        uint64_t cross = k.dot(row + x, frame.width, t.gray.data(), t.width, t.width, t.height);
+        scores[x] = static_cast<float>(ncc(static_cast<double>(cross), static_cast<double>(sum),
+                                           static_cast<double>(sum_sq), t));
+        if (x + 1 == positions) {
+            break;
+        }
+        sum    = sum + column_sum[x + t.width] - column_sum[x];
+        sum_sq = sum_sq + column_sq[x + t.width] - column_sq[x];
+    }
+}
+
+// Two same-size boxes sharing more than half their area.
+bool overlaps(const Candidate& a, const Candidate& b, int32_t width, int32_t height) {
+    int64_t dx = std::max<int64_t>(0, width - std::abs(a.x - b.x));
+    int64_t dy = std::max<int64_t>(0, height - std::abs(a.y - b.y));
+    return dx * dy * 2 > static_cast<int64_t>(width) * height;
+}
+
+// Best first, dropping any candidate that overlaps a better one.
+void suppress(std::vector<Candidate>& candidates, int32_t width, int32_t height, size_t limit) {
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+
+    size_t kept = 0;
+    for (size_t i = 0; i < candidates.size() && kept < limit; ++i) {
+        bool covered = false;
+        for (size_t j = 0; j < kept && !covered; ++j) {
+            covered = overlaps(candidates[i], candidates[j], width, height);
+        }
+        if (!covered) {
+            candidates[kept++] = candidates[i];
+        }
+    }
+    candidates.resize(kept);
+}
+
+// Local maxima of a positions_x x positions_y score map at or above `minimum`.
+void find_peaks(const float* scores, int32_t positions_x, int32_t positions_y, double minimum,
+                std::vector<Candidate>& out) {
+    for (int32_t y = 0; y < positions_y; ++y) {
+        for (int32_t x = 0; x < positions_x; ++x) {
+            float score = scores[static_cast<size_t>(y) * positions_x + x];
+            if (score < minimum) {
+                continue;
+            }
+            bool peak = true;
+            for (int32_t dy = -1; dy <= 1 && peak; ++dy) {
+                for (int32_t dx = -1; dx <= 1 && peak; ++dx) {
+                    int32_t nx = x + dx, ny = y + dy;
+                    if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= positions_x || ny >= positions_y) {
+                        continue;
+                    }
+                    float other = scores[static_cast<size_t>(ny) * positions_x + nx];
+                    // Plateaus keep their first position in raster order.
+                    bool before = dy < 0 || (dy == 0 && dx < 0);
+                    peak = before ? score > other : score >= other;
+                }
+            }
+            if (peak) {
+                out.push_back({x, y, score});
+            }
+        }
+    }
+}
+
+} // namespace
+
+// =====================================================
+// Templates
+// =====================================================
+
+TemplateMatcher& TemplateMatcher::instance() {
+    static TemplateMatcher* matcher = new TemplateMatcher;
+    return *matcher;
+}
+
+Status TemplateMatcher::add(const std::string& name, const ImageView& bgra) {
+    if (name.empty() || !bgra.data || bgra.width <= 0 || bgra.height <= 0 || bgra.stride < bgra.width * 4) {
+        return Status::InvalidArgument;
+    }
+
+    uint32_t levels = 1;
+    while (levels < kMaxLevels && (bgra.width >> levels) >= kMinSide && (bgra.height >> levels) >= kMinSide) {
+        ++levels;
+    }
+
+    std::vector<uint8_t>   halved[2];
+    std::vector<GrayImage> gray;
+    build_pyramid(bgra, levels, halved, gray);
+
+    auto entry = std::make_shared<Template>();
+    for (GrayImage& image : gray) {
+        uint64_t sum = 0, sum_sq = 0;
+        for (uint8_t v : image.pixels) {
+            sum    += v;
+            sum_sq += static_cast<uint32_t>(v) * v;
+        }
+
+        TemplateLevel level;
+        level.width  = image.width;
+        level.height = image.height;
+        level.sum    = static_cast<double>(sum);
+        level.energy = static_cast<double>(image.pixels.size()) * static_cast<double>(sum_sq)
+                       - level.sum * level.sum;
+        if (level.energy <= 0) {
+            break; // flat from here on down
+        }
+        level.gray = std::move(image.pixels);
+        entry->levels.push_back(std::move(level));
+    }
+    if (entry->levels.empty()) {
+        return Status::InvalidArgument;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    templates_[name] = std::move(entry);
+    return Status::Ok;
+}
+
+Status TemplateMatcher::remove(const std::string& name) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return templates_.erase(name) ? Status::Ok : Status::InvalidArgument;
+}
+
+void TemplateMatcher::clear() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        templates_.clear();
+    }
+    std::lock_guard<std::mutex> guard(capture_mutex_);
+    capture_.reset();
+}
+
+TemplateMatcher::TemplatePtr TemplateMatcher::find(const std::string& name) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = templates_.find(name);
+    return it != templates_.end() ? it->second : nullptr;
+}
+
+// =====================================================
+// Search
+// =====================================================
+
+Status TemplateMatcher::match(const ImageView& frame, const std::string& name, const MatchOptions& options,
+                              Match* out, uint32_t max, uint32_t& count) {
+    count = 0;
+    double threshold = options.threshold == 0 ? kDefaultThreshold : options.threshold;
+    if (!frame.data || frame.width <= 0 || frame.height <= 0 || frame.stride < frame.width * 4
+        || !out || max == 0 || !(threshold > 0 && threshold <= 1) || options.levels > kMaxLevels) {
+        return Status::InvalidArgument;
+    }
+    TemplatePtr entry = find(name);
+    if (!entry) {
+        return Status::InvalidArgument;
+    }
+
+    // Region clipped to the frame; width or height 0 means all of it.
+    Rect region = {0, 0, frame.width, frame.height};
+    if (options.region.width > 0 && options.region.height > 0) {
+        int32_t x0 = std::max(0, options.region.x);
+        int32_t y0 = std::max(0, options.region.y);
+        int32_t x1 = static_cast<int32_t>(std::min<int64_t>(frame.width, int64_t(options.region.x) + options.region.width));
+        int32_t y1 = static_cast<int32_t>(std::min<int64_t>(frame.height, int64_t(options.region.y) + options.region.height));
+        region = {x0, y0, x1 - x0, y1 - y0};
+    }
+    const TemplateLevel& full = entry->levels[0];
+    if (region.width < full.width || region.height < full.height) {
+        return Status::Ok;
+    }
+
+    auto levels = static_cast<uint32_t>(entry->levels.size());
+    if (options.levels != 0) {
+        levels = std::min(levels, options.levels);
+    }
+
+    Scratch& work = scratch();
+    ImageView view = {frame.data + static_cast<size_t>(region.y) * frame.stride + static_cast<size_t>(region.x) * 4,
+                      region.width, region.height, frame.stride};
+    build_pyramid(view, levels, work.bgra, work.gray);
+
+    // Full search of the coarsest level.
+    const uint32_t       top         = levels - 1;
+    const GrayImage&     coarse      = work.gray[top];
+    const TemplateLevel& coarse_t    = entry->levels[top];
+    const int32_t        positions_x = coarse.width - coarse_t.width + 1;
+    const int32_t        positions_y = coarse.height - coarse_t.height + 1;
+    work.scores.resize(static_cast<size_t>(positions_x) * positions_y);
+
+    float* scores = work.scores.data();
+    WorkPool::shared().parallel_for(static_cast<uint32_t>(positions_y), [&](uint32_t y) {
+        score_row(coarse, coarse_t, static_cast<int32_t>(y), scores + static_cast<size_t>(y) * positions_x);
+    });
+
+    std::vector<Candidate> candidates;
+    find_peaks(scores, positions_x, positions_y, top == 0 ? threshold : threshold - kCoarseSlack, candidates);
+    suppress(candidates, coarse_t.width, coarse_t.height, std::max<size_t>(size_t(max) * 4, kMinCandidates));
+
+    // Each candidate walks down the pyramid on its own.
+    WorkPool::shared().parallel_for(static_cast<uint32_t>(candidates.size()), [&](uint32_t i) {
+        Candidate& candidate = candidates[i];
+        for (uint32_t level = top; level-- > 0;) {
+            const GrayImage&     image = work.gray[level];
+            const TemplateLevel& t     = entry->levels[level];
+            const int32_t        max_x = image.width - t.width;
+            const int32_t        max_y = image.height - t.height;
+
+            Candidate best = {0, 0, -2};
+            for (int32_t dy = -kRefineRadius; dy <= kRefineRadius; ++dy) {
+                for (int32_t dx = -kRefineRadius; dx <= kRefineRadius; ++dx) {
+                    int32_t x = candidate.x * 2 + dx, y = candidate.y * 2 + dy;
+                    if (x < 0 || y < 0 || x > max_x || y > max_y) {
+                        continue;
+                    }
+                    double score = score_at(image, t, x, y);
+                    if (score > best.score) {
+                        best = {x, y, score};
+                    }
+                }
+            }
+            candidate = best;
+        }
+    });
+
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                    [&](const Candidate& c) { return c.score < threshold; }),
+                     candidates.end());
+    suppress(candidates, full.width, full.height, max);
+
+    for (const Candidate& candidate : candidates) {
+        Match& match = out[count++];
+        match.x      = region.x + candidate.x;
+        match.y      = region.y + candidate.y;
+        match.width  = full.width;
+        match.height = full.height;
+        match.score  = candidate.score;
+    }
+    return Status::Ok;
+}
+
+Status TemplateMatcher::locate(const std::string& name, const MatchOptions& options, Match& out) {
+    std::lock_guard<std::mutex> guard(capture_mutex_);
+    if (!capture_) {
+        Status status = CaptureSession::open(CaptureOptions{}, capture_);
+        if (status != Status::Ok) {
+            return status;
+        }
+    }
+
+    Frame frame;
+    Status status = capture_->grab(kLocateTimeoutMs, frame);
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    uint32_t count = 0;
+    status = match({frame.data, frame.width, frame.height, frame.stride}, name, options, &out, 1, count);
+    capture_->release(frame.slot);
+    if (status != Status::Ok) {
+        return status;
+    }
+    if (count == 0) {
+        return Status::Failed;
+    }
+
+    // Output 0 is the primary monitor, wherever it sits on the desktop.
+    std::vector<Monitor> monitors;
+    if (MonitorLayout::instance().monitors(monitors) == Status::Ok) {
+        for (const Monitor& monitor : monitors) {
+            if (monitor.index == 0) {
+                out.x += monitor.bounds.x;
+                out.y += monitor.bounds.y;
+                break;
+            }
+        }
+    }
+    return Status::Ok;
+}
+
+} // namespace neuro
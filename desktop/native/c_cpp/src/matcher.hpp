@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "capture.hpp"
+#include "kernels.hpp"
+#include "neuro_native.h"
+#include "status.hpp"
+
+namespace neuro {
+
+using Match        = nn_match;
+using MatchOptions = nn_match_options;
+
+// -------------------------------------------------
+// UI-element locator (C ABI nn_template_* / nn_match_template / nn_locate)
+//
+// Templates are BGRA crops registered by name and kept as 8-bit luma
+// pyramids (2x box steps, the SIMD halve + gray kernels). A search
+// scores every position of the coarsest level by normalized
+// cross-correlation, row by row on the shared WorkPool, then refines
+// each local maximum +-2 px per level down to full resolution, so the
+// full-resolution cost is a few dozen windows per candidate instead of
+// the whole frame. NCC ignores uniform brightness and contrast changes
+// (hover highlights, dimmed windows); it does not follow scaling.
+// -------------------------------------------------
+
+// One pyramid level of a registered template.
+struct TemplateLevel {
+    int32_t              width  = 0;
+    int32_t              height = 0;
+    std::vector<uint8_t> gray;       // width x height, packed
+    double               sum    = 0;
+    double               energy = 0; // n * sum(t^2) - sum(t)^2
+};
+
+class TemplateMatcher {
+public:
+    static constexpr double   kDefaultThreshold = 0.8;
+    static constexpr uint32_t kMaxLevels        = 5;
+    static constexpr int32_t  kMinSide          = 8;   // coarsest template side, in pixels
+    static constexpr uint32_t kLocateTimeoutMs  = 250;
+
+    static TemplateMatcher& instance();
+
+    // Replaces any template of the same name. InvalidArgument for an
+    // empty or flat (single-colour) image: NCC has nothing to correlate.
+    Status add(const std::string& name, const ImageView& bgra);
+    Status remove(const std::string& name);
+    // Drops every template and the locate() capture session.
+    void   clear();
+
+    // Up to `max` non-overlapping matches scoring >= threshold, best
+    // first, in frame pixels. Ok with count = 0 when nothing matches;
+    // InvalidArgument for an unknown name.
+    Status match(const ImageView& frame, const std::string& name, const MatchOptions& options,
+                 Match* out, uint32_t max, uint32_t& count);
+
+    // match() on a fresh grab of the primary output (session opened on
+    // first use and kept), in virtual-desktop pixels. Failed when the
+    // template is not on screen.
+    Status locate(const std::string& name, const MatchOptions& options, Match& out);
+
+private:
+    struct Template {
+        std::vector<TemplateLevel> levels; // [0] = full resolution
+    };
+
+    using TemplatePtr = std::shared_ptr<const Template>;
+
+    TemplateMatcher() = default;
+
+    TemplatePtr find(const std::string& name);
+
+    std::mutex                                   mutex_;
+    std::unordered_map<std::string, TemplatePtr> templates_;
+
+    std::mutex                      capture_mutex_; // one locate() grab at a time
+    std::unique_ptr<CaptureSession> capture_;
+};
+
+} // namespace neuro
@@ -0,0 +1,359 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "telemetry.hpp"
+
+namespace neuro {
+
+namespace {
+
+constexpr uint64_t kNoMin = std::numeric_limits<uint64_t>::max();
+
+// Owner-only update: a relaxed load and store, never contended.
+inline void bump(std::atomic<uint64_t>& cell, uint64_t delta) {
+    cell.store(cell.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline uint32_t highest_bit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - static_cast<uint32_t>(__builtin_clzll(value));
+#else
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<uint32_t>(index);
+#endif
+}
+
+struct alignas(64) Series {
+    Series() { clear(); }
+
+    void clear() {
+        count.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        min.store(kNoMin, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+        for (auto& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> min;
+    std::atomic<uint64_t> max;
+    alignas(64) std::atomic<uint64_t> buckets[Metrics::kBuckets];
+};
+
+struct alignas(64) Block {
+    uint32_t              thread = 0; // trace track, 1-based
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<Series*>  series[Metrics::kMetrics] = {};
+};
+
+// Blocks are never freed: the block of a thread that exited goes back to
+// the free list, counts and all, for the next new thread.
+struct Registry {
+    std::mutex            mutex;
+    std::vector<Block*>   blocks;
+    std::vector<Block*>   spare;
+    std::atomic<uint64_t> epoch{1};
+};
+
+// Leaked on purpose: threads may still record while statics are torn down.
+Registry& registry() {
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+struct Owner {
+    Block* block = nullptr;
+
+    ~Owner() {
+        if (block) {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> guard(reg.mutex);
+            reg.spare.push_back(block);
+        }
+    }
+};
+
+thread_local Owner owner;
+
+Block& this_block() {
+    if (!owner.block) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> guard(reg.mutex);
+        if (!reg.spare.empty()) {
+            owner.block = reg.spare.back();
+            reg.spare.pop_back();
+        } else {
+            owner.block = new Block;
+            owner.block->thread = static_cast<uint32_t>(reg.blocks.size() + 1);
+            reg.blocks.push_back(owner.block);
+        }
+    }
+    return *owner.block;
+}
+
+Series& series_of(Block& block, uint32_t metric) {
+    uint64_t epoch = registry().epoch.load(std::memory_order_acquire);
+    if (block.epoch.load(std::memory_order_relaxed) != epoch) {
+        for (auto& series : block.series) {
+            if (Series* s = series.load(std::memory_order_relaxed)) {
+                s->clear();
+            }
+        }
+        block.epoch.store(epoch, std::memory_order_release);
+    }
+
+    Series* series = block.series[metric].load(std::memory_order_relaxed);
+    if (!series) {
+        series = new Series;
+        block.series[metric].store(series, std::memory_order_release);
+    }
+    return *series;
+}
+
+void add(Series& series, uint64_t value) {
+    bump(series.count, 1);
+    bump(series.sum, value);
+    if (value < series.min.load(std::memory_order_relaxed)) {
+        series.min.store(value, std::memory_order_relaxed);
+    }
+    if (value > series.max.load(std::memory_order_relaxed)) {
+        series.max.store(value, std::memory_order_relaxed);
+    }
+    bump(series.buckets[Metrics::bucket_of(value)], 1);
+}
+
+// Trace record kinds (Record::type)
+constexpr uint16_t kTraceSpan  = 0;
+constexpr uint16_t kTraceValue = 1;
+
+} // namespace
+
+// =====================================================
+// Metrics
+// =====================================================
+
+uint32_t Metrics::bucket_of(uint64_t value) {
+    if (value < kSubBuckets) {
+        return static_cast<uint32_t>(value);
+    }
+    uint32_t bit = highest_bit(value);
+    if (bit >= kMaxBits) {
+        return kBuckets - 1;
+    }
+    uint32_t shift = bit - kSubBits;
+    return kSubBuckets + shift * kSubBuckets + static_cast<uint32_t>((value >> shift) - kSubBuckets);
+}
+
+uint64_t Metrics::bucket_high(uint32_t bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    if (bucket >= kBuckets - 1) {
+        return kNoMin; // everything past 2^40; reported as the max
+    }
+    uint32_t shift = (bucket - kSubBuckets) / kSubBuckets;
+    uint64_t sub   = (bucket - kSubBuckets) % kSubBuckets;
+    return ((kSubBuckets + sub) << shift) + (uint64_t(1) << shift) - 1;
+}
+
+void Metrics::record(uint32_t metric, uint64_t value) {
+    if (metric >= kMetrics) {
+        return;
+    }
+    Block& block = this_block();
+    add(series_of(block, metric), value);
+    if (Trace::enabled()) {
+        Trace::push(metric, kTraceValue, monotonic_ns(), value, block.thread);
+    }
+}
+
+void Metrics::span(uint32_t metric, uint64_t start_ns, uint64_t end_ns) {
+    if (metric >= kMetrics) {
+        return;
+    }
+    uint64_t duration = end_ns > start_ns ? end_ns - start_ns : 0;
+    Block& block = this_block();
+    add(series_of(block, metric), duration);
+    if (Trace::enabled()) {
+        Trace::push(metric, kTraceSpan, start_ns, duration, block.thread);
+    }
+}
+
+Status Metrics::get(uint32_t metric, MetricStats& out) {
+    out = MetricStats{};
+    if (metric >= kMetrics) {
+        return Status::InvalidArgument;
+    }
+
+    std::vector<uint64_t> buckets(kBuckets);
+    uint64_t min = kNoMin;
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> guard(reg.mutex);
+        uint64_t epoch = reg.epoch.load(std::memory_order_acquire);
+
+        for (Block* block : reg.blocks) {
+            Series* series = block->series[metric].load(std::memory_order_acquire);
+            if (!series || block->epoch.load(std::memory_order_acquire) != epoch) {
+                continue;
+            }
+            out.count += series->count.load(std::memory_order_relaxed);
+            out.sum += series->sum.load(std::memory_order_relaxed);
+            min     = std::min(min, series->min.load(std::memory_order_relaxed));
+            out.max = std::max(out.max, series->max.load(std::memory_order_relaxed));
+            for (uint32_t i = 0; i < kBuckets; ++i) {
+                buckets[i] += series->buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    out.min = out.count ? min : 0;
+
+    // Percentiles from the merged buckets (their total, not count, so a
+    // record landing mid-read can't push the rank past the end).
+    uint64_t total = 0;
+    for (uint64_t n : buckets) {
+        total += n;
+    }
+    if (total == 0) {
+        return Status::Ok;
+    }
+    struct Rank {
+        double    q;
+        uint64_t* out;
+    } ranks[] = {{0.50, &out.p50}, {0.90, &out.p90}, {0.99, &out.p99}, {0.999, &out.p999}};
+
+    uint64_t seen = 0;
+    size_t   next = 0;
+    for (uint32_t i = 0; i < kBuckets && next < std::size(ranks); ++i) {
+        seen += buckets[i];
+        while (next < std::size(ranks)
+               && seen >= std::max<uint64_t>(1, static_cast<uint64_t>(ranks[next].q * total + 0.5))) {
+            *ranks[next].out = std::min(bucket_high(i), out.max);
+            ++next;
+        }
+    }
+    return Status::Ok;
+}
+
+void Metrics::reset() {
+    registry().epoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+const char* Metrics::name(uint32_t metric) {
+    static const char* const kNames[] = {
+        "gil_wait", "gil_hold", "queue_depth", "inject", "script", "capture_frame", "ws_send", "ws_recv",
+    };
+    static const char* const kUser[] = {
+        "user_16", "user_17", "user_18", "user_19", "user_20", "user_21", "user_22", "user_23",
+        "user_24", "user_25", "user_26", "user_27", "user_28", "user_29", "user_30", "user_31",
+    };
+    static_assert(std::size(kUser) == NN_METRIC_COUNT - NN_METRIC_USER, "one name per user metric");
+
+    if (metric < std::size(kNames)) {
+        return kNames[metric];
+    }
+    if (metric >= NN_METRIC_USER && metric < NN_METRIC_COUNT) {
+        return kUser[metric - NN_METRIC_USER];
+    }
+    return nullptr;
+}
+
+// =====================================================
+// Trace
+// =====================================================
+
+std::atomic<bool> Trace::enabled_{false};
+
+static std::mutex     trace_lock;
+static std::atomic<TelemetryRing*> trace_ring{nullptr}; // leaked, like the telemetry channels
+
+Status Trace::start(uint32_t capacity) {
+    if (capacity > (1u << 24)) {
+        return Status::InvalidArgument;
+    }
+    std::lock_guard<std::mutex> guard(trace_lock);
+    TelemetryRing* ring = trace_ring.load(std::memory_order_relaxed);
+    if (!ring) {
+        ring = new TelemetryRing(capacity ? capacity : 1u << 16);
+        trace_ring.store(ring, std::memory_order_release);
+    }
+    ring->clear();
+    enabled_.store(true, std::memory_order_release);
+    return Status::Ok;
+}
+
+void Trace::stop() {
+    enabled_.store(false, std::memory_order_release);
+}
+
+void Trace::push(uint32_t metric, uint16_t kind, uint64_t timestamp_ns, uint64_t value, uint32_t thread) {
+    // Never replaced once set.
+    TelemetryRing* ring = trace_ring.load(std::memory_order_acquire);
+    if (!ring) {
+        return;
+    }
+    Record record = {};
+    record.timestamp_ns = timestamp_ns ? timestamp_ns : 1;
+    record.source       = static_cast<uint16_t>(metric);
+    record.type         = kind;
+    record.arg          = static_cast<int64_t>(value);
+    record.aux          = thread;
+    ring->push(record);
+}
+
+Status Trace::write(const char* path) {
+    if (!path) {
+        return Status::InvalidArgument;
+    }
+    std::vector<Record> records;
+    {
+        TelemetryRing* ring = trace_ring.load(std::memory_order_acquire);
+        if (!ring) {
+            return Status::Unavailable;
+        }
+        records.resize(ring->capacity());
+        records.resize(ring->snapshot(0, records.data(), records.size()));
+    }
+
+    std::FILE* file = std::fopen(path, "wb");
+    if (!file) {
+        return Status::Failed;
+    }
+    // Microsecond timestamps, as the format expects.
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+    for (size_t i = 0; i < records.size(); ++i) {
+        const Record& r = records[i];
+        const char* name = Metrics::name(r.source);
+        double ts = r.timestamp_ns / 1e3;
+        if (r.type == kTraceSpan) {
+            std::fprintf(file, "{\"name\":\"%s\",\"cat\":\"neuro\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                               "\"pid\":1,\"tid\":%" PRIu64 "}",
+                         name ? name : "metric", ts, static_cast<uint64_t>(r.arg) / 1e3, r.aux);
+        } else {
+            std::fprintf(file, "{\"name\":\"%s\",\"cat\":\"neuro\",\"ph\":\"C\",\"ts\":%.3f,"
+                               "\"pid\":1,\"tid\":%" PRIu64 ",\"args\":{\"value\":%" PRIu64 "}}",
+                         name ? name : "metric", ts, r.aux, static_cast<uint64_t>(r.arg));
+        }
+        std::fputs(i + 1 < records.size() ? ",\n" : "\n", file);
+    }
+    std::fputs("]}\n", file);
+    return std::fclose(file) == 0 ? Status::Ok : Status::Failed;
+}
+
+} // namespace neuro
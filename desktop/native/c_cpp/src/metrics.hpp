@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "clock.hpp"
+#include "neuro_native.h"
+#include "status.hpp"
+
+namespace neuro {
+
+using MetricStats = nn_metric_stats;
+
+// -------------------------------------------------
+// Hot-path metrics (C ABI nn_metrics_*, nn_trace_*)
+//
+// Every thread records into its own block of series, each on its own
+// cache lines and written only by that thread (relaxed loads and
+// stores, no read-modify-write), so recording costs a few ns and never
+// contends. Readers merge every block on demand. A series' histogram is
+// allocated the first time its thread records that metric.
+//
+// Histograms are HDR style: values below 32 are exact, above that each
+// power of two is split into 32 linear buckets (at most ~3% wide), up
+// to 2^40 (about 18 minutes in ns); larger values land in the last
+// bucket. Percentiles report the bucket's highest value.
+//
+// reset() starts a new epoch: blocks from an older one read as empty
+// and their owner clears them on its next record, so a reset never
+// writes into another thread's block.
+// -------------------------------------------------
+
+class Metrics {
+public:
+    static constexpr uint32_t kMetrics    = NN_METRIC_COUNT;
+    static constexpr uint32_t kSubBits    = 5;
+    static constexpr uint32_t kSubBuckets = 1u << kSubBits;
+    static constexpr uint32_t kMaxBits    = 40;
+    static constexpr uint32_t kBuckets    = kSubBuckets + (kMaxBits - kSubBits) * kSubBuckets;
+
+    static void record(uint32_t metric, uint64_t value);
+
+    // Records end - start, and a trace span while tracing.
+    static void span(uint32_t metric, uint64_t start_ns, uint64_t end_ns);
+
+    static Status get(uint32_t metric, MetricStats& out);
+    static void   reset();
+
+    static const char* name(uint32_t metric);
+
+    // Bucket of a value, and the highest value a bucket holds.
+    static uint32_t bucket_of(uint64_t value);
+    static uint64_t bucket_high(uint32_t bucket);
+};
+
+// Times a scope into one metric (as a span).
+class ScopedSpan {
+public:
+    explicit ScopedSpan(uint32_t metric) : metric_(metric), start_(monotonic_ns()) {}
+    ~ScopedSpan() { Metrics::span(metric_, start_, monotonic_ns()); }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+private:
+    uint32_t metric_;
+    uint64_t start_;
+};
+
+// -------------------------------------------------
+// Trace stream
+//
+// While started, every span and recorded value also goes into one
+// process-wide telemetry ring (newest `capacity` kept). write() exports
+// what it holds as Chrome trace JSON: spans as complete events, plain
+// values as counters, one track per recording thread. Loads in
+// chrome://tracing and Perfetto.
+// -------------------------------------------------
+
+class Trace {
+public:
+    // The ring is created on the first start (capacity is only honoured
+    // then); every start clears it.
+    static Status start(uint32_t capacity);
+    static void   stop();
+    static bool   enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    static Status write(const char* path);
+
+private:
+    friend class Metrics;
+
+    static void push(uint32_t metric, uint16_t kind, uint64_t timestamp_ns, uint64_t value, uint32_t thread);
+
+    static std::atomic<bool> enabled_;
+};
+
+} // namespace neuro
@@ -0,0 +1,250 @@
+#include "monitors.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace neuro {
+
+int32_t clamp_to_monitors(const Monitor* monitors, size_t count, int32_t& x, int32_t& y) {
+    int32_t best     = -1;
+    int64_t best_gap = std::numeric_limits<int64_t>::max();
+    int32_t best_x = x, best_y = y;
+
+    for (size_t i = 0; i < count; ++i) {
+        const Rect& r = monitors[i].bounds;
+        if (r.width <= 0 || r.height <= 0) {
+            continue;
+        }
+        int32_t cx = std::clamp(x, r.x, r.x + r.width - 1);
+        int32_t cy = std::clamp(y, r.y, r.y + r.height - 1);
+        int64_t dx = static_cast<int64_t>(cx) - x;
+        int64_t dy = static_cast<int64_t>(cy) - y;
+        int64_t gap = dx * dx + dy * dy;
+        if (gap < best_gap) {
+            best     = static_cast<int32_t>(i);
+            best_gap = gap;
+            best_x   = cx;
+            best_y   = cy;
+            if (gap == 0) {
+                break;
+            }
+        }
+    }
+
+    x = best_x;
+    y = best_y;
+    return best < 0 ? -1 : monitors[best].index;
+}
+
+Rect bounding_rect(const Monitor* monitors, size_t count) {
+    if (count == 0) {
+        return Rect{};
+    }
+    int32_t x0 = monitors[0].bounds.x, y0 = monitors[0].bounds.y;
+    int32_t x1 = x0 + monitors[0].bounds.width, y1 = y0 + monitors[0].bounds.height;
+    for (size_t i = 1; i < count; ++i) {
+        const Rect& r = monitors[i].bounds;
+        x0 = std::min(x0, r.x);
+        y0 = std::min(y0, r.y);
+        x1 = std::max(x1, r.x + r.width);
+        y1 = std::max(y1, r.y + r.height);
+    }
+    return Rect{x0, y0, x1 - x0, y1 - y0};
+}
+
+// =====================================================
+// MonitorLayout
+// =====================================================
+
+MonitorLayout& MonitorLayout::instance() {
+    static MonitorLayout layout;
+    return layout;
+}
+
+Status MonitorLayout::load_locked() {
+    if (loaded_ == Status::Busy) {
+        std::vector<Monitor> monitors;
+        loaded_ = enumerate_monitors(monitors);
+        if (loaded_ == Status::Ok && monitors.empty()) {
+            loaded_ = Status::Unavailable;
+        }
+        monitors_.swap(monitors);
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+    return loaded_;
+}
+
+Status MonitorLayout::refresh() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    loaded_ = Status::Busy;
+    return load_locked();
+}
+
+Status MonitorLayout::monitors(std::vector<Monitor>& out) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    Status status = load_locked();
+    out = monitors_;
+    return status;
+}
+
+Status MonitorLayout::desktop(Rect& out) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    Status status = load_locked();
+    out = bounding_rect(monitors_.data(), monitors_.size());
+    return status;
+}
+
+// int(nx * width) like MouseController.map_normalized, kept on the
+// monitor so 1.0 lands on its last pixel rather than the next output.
+Status MonitorLayout::map_normalized(int32_t monitor, double nx, double ny, int32_t& x, int32_t& y) {
+    if (!std::isfinite(nx) || !std::isfinite(ny)) {
+        return Status::InvalidArgument;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    Status status = load_locked();
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    Rect area;
+    if (monitor < 0) {
+        area = bounding_rect(monitors_.data(), monitors_.size());
+    } else if (static_cast<size_t>(monitor) < monitors_.size()) {
+        area = monitors_[monitor].bounds;
+    } else {
+        return Status::InvalidArgument;
+    }
+
+    double px = area.x + std::floor(std::clamp(nx, 0.0, 1.0) * area.width);
+    double py = area.y + std::floor(std::clamp(ny, 0.0, 1.0) * area.height);
+    x = static_cast<int32_t>(std::min<double>(px, area.x + area.width - 1));
+    y = static_cast<int32_t>(std::min<double>(py, area.y + area.height - 1));
+
+    // The virtual desktop can have holes between outputs of different sizes.
+    if (monitor < 0) {
+        clamp_to_monitors(monitors_.data(), monitors_.size(), x, y);
+    }
+    return Status::Ok;
+}
+
+Status MonitorLayout::clamp(int32_t& x, int32_t& y, int32_t& monitor) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    Status status = load_locked();
+    monitor = clamp_to_monitors(monitors_.data(), monitors_.size(), x, y);
+    return status;
+}
+
+// =====================================================
+// MultiCapture
+// =====================================================
+
+Status MultiCapture::open(uint32_t ring_slots, std::unique_ptr<MultiCapture>& out) {
+    std::vector<Monitor> monitors;
+    Status status = MonitorLayout::instance().monitors(monitors);
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    std::unique_ptr<MultiCapture> multi(new MultiCapture());
+    multi->outputs_.reset(new Output[monitors.size()]);
+
+    // Sessions first: a failing output must not leave threads to stop.
+    for (size_t i = 0; i < monitors.size(); ++i) {
+        Output& output = multi->outputs_[i];
+        output.monitor = monitors[i];
+
+        CaptureOptions options;
+        options.output     = monitors[i].index;
+        options.ring_slots = ring_slots;
+        status = CaptureSession::open(options, output.session);
+        if (status != Status::Ok) {
+            return status;
+        }
+    }
+
+    multi->count_ = static_cast<uint32_t>(monitors.size());
+    for (uint32_t i = 0; i < multi->count_; ++i) {
+        Output& output = multi->outputs_[i];
+        output.thread = std::thread([raw = multi.get(), &output] { raw->run(output); });
+    }
+
+    out = std::move(multi);
+    return Status::Ok;
+}
+
+MultiCapture::~MultiCapture() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stopping_ = true;
+    }
+    start_.notify_all();
+    for (uint32_t i = 0; i < count_; ++i) {
+        if (outputs_[i].thread.joinable()) {
+            outputs_[i].thread.join();
+        }
+    }
+}
+
+void MultiCapture::run(Output& output) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        start_.wait(lock, [&] { return stopping_ || round_ != seen; });
+        if (stopping_) {
+            return;
+        }
+        seen = round_;
+        uint32_t timeout_ms = timeout_ms_;
+        lock.unlock();
+
+        // output.frame/status are this thread's until pending_ drops.
+        Frame frame;
+        output.status = output.session->grab(timeout_ms, frame);
+        output.frame  = output.status == Status::Ok ? frame : Frame{};
+
+        lock.lock();
+        if (--pending_ == 0) {
+            done_.notify_all();
+        }
+    }
+}
+
+Status MultiCapture::grab(uint32_t timeout_ms, Frame* frames, Status* statuses) {
+    if (!frames) {
+        return Status::InvalidArgument;
+    }
+
+    std::lock_guard<std::mutex> serial(grab_mutex_);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        timeout_ms_ = timeout_ms;
+        pending_    = count_;
+        ++round_;
+        start_.notify_all();
+        done_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+    Status first = Status::Ok;
+    for (uint32_t i = 0; i < count_; ++i) {
+        const Output& output = outputs_[i];
+        frames[i] = output.frame;
+        if (statuses) {
+            statuses[i] = output.status;
+        }
+        if (first == Status::Ok) {
+            first = output.status;
+        }
+    }
+    return first;
+}
+
+Status MultiCapture::release(uint32_t output, uint32_t slot) {
+    if (output >= count_) {
+        return Status::InvalidArgument;
+    }
+    return outputs_[output].session->release(slot);
+}
+
+} // namespace neuro
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "capture.hpp"
+#include "status.hpp"
+
+namespace neuro {
+
+struct Monitor {
+    int32_t index   = 0;     // capture output, 0 = primary
+    Rect    bounds;          // virtual-desktop pixels
+    bool    primary = false;
+    char    name[64] = {};   // OS output name, UTF-8
+};
+
+// -------------------------------------------------
+// Platform half (in the capture backend, which opens outputs by the same
+// index): every active output, primary first, then in OS order.
+// Unavailable when the backend has no capture API.
+// -------------------------------------------------
+
+Status enumerate_monitors(std::vector<Monitor>& out);
+
+// Index of the monitor containing (x, y), or of the nearest one when the
+// point is off every monitor; the point is moved onto it. -1 (point left
+// alone) when count is 0.
+int32_t clamp_to_monitors(const Monitor* monitors, size_t count, int32_t& x, int32_t& y);
+
+// Smallest rectangle covering every monitor.
+Rect bounding_rect(const Monitor* monitors, size_t count);
+
+// -------------------------------------------------
+// Process-wide monitor layout (C ABI nn_monitors_*)
+//
+// Enumerated on first use and kept until refresh(): the OS is asked only
+// when the caller knows the layout changed. generation() lets holders of
+// a copy (the input injector) notice a refresh with one atomic load.
+// -------------------------------------------------
+
+class MonitorLayout {
+public:
+    static MonitorLayout& instance();
+
+    Status   refresh();
+    Status   monitors(std::vector<Monitor>& out);
+    Status   desktop(Rect& out);
+    uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+    // Normalized (0.0-1.0) coordinates on one monitor, or on the whole
+    // virtual desktop with monitor = -1, to pixels on a monitor.
+    Status map_normalized(int32_t monitor, double nx, double ny, int32_t& x, int32_t& y);
+
+    // clamp_to_monitors() on the current layout.
+    Status clamp(int32_t& x, int32_t& y, int32_t& monitor);
+
+private:
+    MonitorLayout() = default;
+
+    Status load_locked();
+
+    std::mutex            mutex_;
+    std::vector<Monitor>  monitors_;
+    Status                loaded_ = Status::Busy; // Busy = not enumerated yet
+    std::atomic<uint64_t> generation_{0};
+};
+
+// -------------------------------------------------
+// Multi-monitor capture (C ABI nn_multi_capture_*)
+//
+// One capture session per monitor (its own duplication / XShm
+// connection), each grabbed by its own persistent thread, so a 3-output
+// desktop costs about one output's grab latency instead of three. Frames
+// are in each monitor's own pixels; Monitor::bounds places them on the
+// virtual desktop.
+// -------------------------------------------------
+
+class MultiCapture {
+public:
+    // Every monitor of the current layout; ring_slots as CaptureOptions.
+    static Status open(uint32_t ring_slots, std::unique_ptr<MultiCapture>& out);
+    ~MultiCapture(); // stops and joins the threads; leases become invalid
+
+    MultiCapture(const MultiCapture&) = delete;
+    MultiCapture& operator=(const MultiCapture&) = delete;
+
+    uint32_t        count() const { return count_; }
+    const Monitor&  monitor(uint32_t output) const { return outputs_[output].monitor; }
+    CaptureSession* session(uint32_t output) { return outputs_[output].session.get(); }
+
+    // Grabs every output at once and waits for all of them. frames and
+    // statuses (optional) hold count() entries. Ok when every grab was;
+    // otherwise the first failure, and only the outputs whose status is
+    // Ok hold a lease.
+    Status grab(uint32_t timeout_ms, Frame* frames, Status* statuses);
+
+    Status release(uint32_t output, uint32_t slot);
+
+private:
+    struct Output {
+        Monitor                         monitor;
+        std::unique_ptr<CaptureSession> session;
+        Frame                           frame;
+        Status                          status = Status::Ok;
+        std::thread                     thread;
+    };
+
+    MultiCapture() = default;
+
+    void run(Output& output);
+
+    std::unique_ptr<Output[]> outputs_;
+    uint32_t                  count_ = 0;
+
+    std::mutex              grab_mutex_; // one grab() at a time
+    std::mutex              mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    uint64_t                round_      = 0; // bumped by grab() to start the threads
+    uint32_t                pending_    = 0;
+    uint32_t                timeout_ms_ = 0;
+    bool                    stopping_   = false;
+};
+
+} // namespace neuro
@@ -0,0 +1,217 @@
+#include "path.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace neuro {
+
+// De Casteljau splits before a piece counts as flat regardless.
+static constexpr int kMaxCurveDepth = 16;
+
+double PathOptions::effective_spacing() const {
+    if (velocity > 0 && step_seconds > 0) {
+        return velocity * step_seconds;
+    }
+    return spacing > 0 ? spacing : 10.0;
+}
+
+PathBuilder::PathBuilder(std::vector<nn_point>& out, const PathOptions& options)
+    : out_(out), options_(options), spacing_(options.effective_spacing()) {}
+
+bool PathBuilder::reserve(double extra) {
+    if (!ok_ || static_cast<double>(out_.size()) + extra > static_cast<double>(options_.max_points)) {
+        ok_ = false;
+        return false;
+    }
+    out_.reserve(out_.size() + static_cast<size_t>(extra));
+    return true;
+}
+
+void PathBuilder::push(nn_point p) {
+    if (!out_.empty() && out_.back().x == p.x && out_.back().y == p.y) {
+        return;
+    }
+    if (out_.size() >= options_.max_points) {
+        ok_ = false;
+        return;
+    }
+    out_.push_back(p);
+}
+
+// -------------------------------------------------
+// Lines
+// -------------------------------------------------
+
+bool PathBuilder::line_steps(nn_point a, nn_point b, int64_t steps) {
+    if (steps < 0) {
+        return ok_;
+    }
+    if (steps == 0 || !reserve(static_cast<double>(steps) + 1)) {
+        ok_ = false;
+        return false;
+    }
+
+    double dx = static_cast<double>(b.x) - a.x;
+    double dy = static_cast<double>(b.y) - a.y;
+    for (int64_t i = 0; i <= steps; ++i) {
+        double t = static_cast<double>(i) / static_cast<double>(steps);
+        out_.push_back(nn_point{static_cast<int32_t>(a.x + dx * t), static_cast<int32_t>(a.y + dy * t)});
+    }
+    return true;
+}
+
+bool PathBuilder::line(nn_point a, nn_point b) {
+    double dx = static_cast<double>(b.x) - a.x;
+    double dy = static_cast<double>(b.y) - a.y;
+
+    if (spacing_ <= 1.0) {
+        // Bresenham: every pixel, integer only.
+        int64_t x = a.x, y = a.y;
+        int64_t adx = std::llabs(static_cast<int64_t>(b.x) - x);
+        int64_t ady = -std::llabs(static_cast<int64_t>(b.y) - y);
+        int64_t sx = a.x < b.x ? 1 : -1;
+        int64_t sy = a.y < b.y ? 1 : -1;
+        if (!reserve(static_cast<double>(std::max(adx, -ady)) + 1)) {
+            return false;
+        }
+
+        int64_t err = adx + ady;
+        for (;;) {
+            push(nn_point{static_cast<int32_t>(x), static_cast<int32_t>(y)});
+            if (x == b.x && y == b.y) {
+                break;
+            }
+            int64_t e2 = 2 * err;
+            if (e2 >= ady) { err += ady; x += sx; }
+            if (e2 <= adx) { err += adx; y += sy; }
+        }
+        return ok_;
+    }
+
+    // DDA with as few steps as the spacing allows (sqrt, not hypot, so
+    // the Python fallback lands on the same step counts).
+    double length = std::sqrt(dx * dx + dy * dy);
+    auto steps = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(length / spacing_)));
+    if (!reserve(static_cast<double>(steps) + 1)) {
+        return false;
+    }
+    for (int64_t i = 0; i <= steps; ++i) {
+        double t = static_cast<double>(i) / static_cast<double>(steps);
+        push(nn_point{static_cast<int32_t>(a.x + dx * t), static_cast<int32_t>(a.y + dy * t)});
+    }
+    return ok_;
+}
+
+bool PathBuilder::polyline(const nn_point* points, size_t count) {
+    for (size_t i = 0; i + 1 < count && ok_; ++i) {
+        line(points[i], points[i + 1]);
+    }
+    return ok_;
+}
+
+// -------------------------------------------------
+// Curves
+// -------------------------------------------------
+
+bool PathBuilder::bezier(const nn_point* control, size_t count) {
+    auto vec = [&](size_t i) { return Vec{static_cast<double>(control[i].x), static_cast<double>(control[i].y)}; };
+
+    if (count == 3) {
+        // Degree elevation: the same curve as a cubic.
+        Vec p0 = vec(0), c = vec(1), p2 = vec(2);
+        cubic(p0, Vec{p0.x + (c.x - p0.x) * 2 / 3, p0.y + (c.y - p0.y) * 2 / 3},
+              Vec{p2.x + (c.x - p2.x) * 2 / 3, p2.y + (c.y - p2.y) * 2 / 3}, p2);
+    } else if (count == 4) {
+        cubic(vec(0), vec(1), vec(2), vec(3));
+    } else {
+        return false;
+    }
+    return ok_;
+}
+
+bool PathBuilder::catmull_rom(const nn_point* points, size_t count) {
+    auto vec = [&](size_t i) { return Vec{static_cast<double>(points[i].x), static_cast<double>(points[i].y)}; };
+
+    // Each span p1 -> p2 as the equivalent cubic Bezier; the end spans
+    // repeat their outer point as the missing neighbour.
+    for (size_t i = 0; i + 1 < count && ok_; ++i) {
+        Vec p0 = vec(i ? i - 1 : 0), p1 = vec(i), p2 = vec(i + 1), p3 = vec(std::min(i + 2, count - 1));
+        cubic(p1, Vec{p1.x + (p2.x - p0.x) / 6, p1.y + (p2.y - p0.y) / 6},
+              Vec{p2.x - (p3.x - p1.x) / 6, p2.y - (p3.y - p1.y) / 6}, p2);
+    }
+    return ok_;
+}
+
+void PathBuilder::cubic(Vec p0, Vec p1, Vec p2, Vec p3) {
+    std::vector<Vec> flat{p0};
+    flatten(p0, p1, p2, p3, 0, flat);
+    resample(flat);
+}
+
+// Splits until the control points sit within `tolerance` of the chord,
+// so straight-ish stretches cost one piece and tight bends many.
+void PathBuilder::flatten(Vec p0, Vec p1, Vec p2, Vec p3, int depth, std::vector<Vec>& out) const {
+    double cx = p3.x - p0.x, cy = p3.y - p0.y;
+    double chord = std::sqrt(cx * cx + cy * cy);
+    double d1, d2;
+    if (chord > 1e-9) {
+        d1 = std::fabs((p1.x - p0.x) * cy - (p1.y - p0.y) * cx) / chord;
+        d2 = std::fabs((p2.x - p0.x) * cy - (p2.y - p0.y) * cx) / chord;
+    } else {
+        d1 = std::hypot(p1.x - p0.x, p1.y - p0.y);
+        d2 = std::hypot(p2.x - p0.x, p2.y - p0.y);
+    }
+
+    if (depth >= kMaxCurveDepth || std::max(d1, d2) <= options_.tolerance) {
+        out.push_back(p3);
+        return;
+    }
+
+    auto mid = [](Vec a, Vec b) { return Vec{(a.x + b.x) / 2, (a.y + b.y) / 2}; };
+    Vec p01 = mid(p0, p1), p12 = mid(p1, p2), p23 = mid(p2, p3);
+    Vec p012 = mid(p01, p12), p123 = mid(p12, p23);
+    Vec m = mid(p012, p123);
+    flatten(p0, p01, p012, m, depth + 1, out);
+    flatten(m, p123, p23, p3, depth + 1, out);
+}
+
+// Walks the flattened curve by arc length, one point per spacing.
+void PathBuilder::resample(const std::vector<Vec>& polyline) {
+    double step = std::max(1.0, spacing_);
+    double total = 0;
+    for (size_t i = 1; i < polyline.size(); ++i) {
+        total += std::hypot(polyline[i].x - polyline[i - 1].x, polyline[i].y - polyline[i - 1].y);
+    }
+    if (!reserve(total / step + 2)) {
+        return;
+    }
+
+    auto emit = [&](Vec v) {
+        push(nn_point{static_cast<int32_t>(std::llround(v.x)), static_cast<int32_t>(std::llround(v.y))});
+    };
+
+    emit(polyline.front());
+    double next = step; // arc length of the next point
+    double walked = 0;
+    for (size_t i = 1; i < polyline.size(); ++i) {
+        Vec a = polyline[i - 1], b = polyline[i];
+        double length = std::hypot(b.x - a.x, b.y - a.y);
+        while (length > 0 && next <= walked + length) {
+            double t = (next - walked) / length;
+            emit(Vec{a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t});
+            next += step;
+        }
+        walked += length;
+    }
+    emit(polyline.back());
+}
+
+void clamp_points(nn_point* points, size_t count, int32_t width, int32_t height) {
+    for (size_t i = 0; i < count; ++i) {
+        points[i].x = std::max(0, std::min(width - 1, points[i].x));
+        points[i].y = std::max(0, std::min(height - 1, points[i].y));
+    }
+}
+
+} // namespace neuro
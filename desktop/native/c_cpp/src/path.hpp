@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "neuro_native.h"
+
+namespace neuro {
+
+// Density of generated strokes. With velocity and step_seconds both set
+// the spacing follows from them (velocity * step_seconds pixels apart),
+// so a paced stroke moves at that speed whatever its length.
+struct PathOptions {
+    double spacing      = 10.0; // max pixels between consecutive points
+    double velocity     = 0.0;  // px/s
+    double step_seconds = 0.0;
+    double tolerance    = 0.5;  // curve flatness, pixels
+    size_t max_points   = size_t(1) << 20;
+
+    double effective_spacing() const;
+};
+
+// -------------------------------------------------
+// Path engine (C ABI nn_path_*)
+//
+// Appends points to a caller-owned packed buffer, which the batch and
+// timeline backends take as-is. Every primitive skips a first point
+// equal to the last one already in the buffer, so joints between
+// segments are never doubled. Appending stops (and ok() turns false)
+// at max_points.
+// -------------------------------------------------
+
+class PathBuilder {
+public:
+    PathBuilder(std::vector<nn_point>& out, const PathOptions& options);
+
+    // MouseController.draw_line() exactly: steps + 1 points, truncated
+    // like int(), repeats and all (LINE ... STEPS n).
+    bool line_steps(nn_point a, nn_point b, int64_t steps);
+
+    // Even steps no further apart than the spacing (ceil(length /
+    // spacing) of them, truncated like int()); every pixel, Bresenham,
+    // when the spacing is 1 or less.
+    bool line(nn_point a, nn_point b);
+    bool polyline(const nn_point* points, size_t count);
+
+    // 3 control points = quadratic, 4 = cubic.
+    bool bezier(const nn_point* control, size_t count);
+
+    // Uniform Catmull-Rom spline through every point.
+    bool catmull_rom(const nn_point* points, size_t count);
+
+    bool ok() const { return ok_; }
+
+private:
+    struct Vec {
+        double x, y;
+    };
+
+    bool reserve(double extra);
+    void push(nn_point p);
+    void cubic(Vec p0, Vec p1, Vec p2, Vec p3);
+    void flatten(Vec p0, Vec p1, Vec p2, Vec p3, int depth, std::vector<Vec>& out) const;
+    void resample(const std::vector<Vec>& polyline);
+
+    std::vector<nn_point>& out_;
+    PathOptions            options_;
+    double                 spacing_;
+    bool                   ok_ = true;
+};
+
+// Clamps every point into [0, width) x [0, height).
+void clamp_points(nn_point* points, size_t count, int32_t width, int32_t height);
+
+} // namespace neuro
@@ -0,0 +1,332 @@
+// uinput backend, for Wayland sessions (no protocol lets one client
+// inject into another) and bare consoles. open() creates a virtual
+// keyboard + absolute pointer through /dev/uinput, below the
+// compositor, so events reach whatever has focus; it needs write access
+// to /dev/uinput (the input group or a udev rule). Every send() is one
+// write() of the whole batch.
+//
+// The kernel takes key codes, not characters: characters resolve
+// through a built-in US table and come out as whatever the active
+// layout puts on those keys. The pointer spans the screen size read
+// from DRM (first connected connector's preferred mode) or
+// NEURO_UINPUT_SCREEN=WxH; the compositor maps it onto its outputs.
+// Nothing reads the pointer back, so cursor() is the last position
+// this backend moved to.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <linux/input.h>
+#include <linux/uinput.h>
+
+#include "input.hpp"
+
+namespace neuro {
+
+struct NamedKey {
+    const char* name;
+    uint16_t    code;
+};
+
+// pyautogui's KEYBOARD_KEYS names; single characters go to kUsLayout.
+static const NamedKey kNamedKeys[] = {
+    {"backspace", KEY_BACKSPACE}, {"\b", KEY_BACKSPACE}, {"tab", KEY_TAB}, {"\t", KEY_TAB},
+    {"enter", KEY_ENTER}, {"return", KEY_ENTER}, {"\n", KEY_ENTER}, {"\r", KEY_ENTER},
+    {"shift", KEY_LEFTSHIFT}, {"shiftleft", KEY_LEFTSHIFT}, {"shiftright", KEY_RIGHTSHIFT},
+    {"ctrl", KEY_LEFTCTRL}, {"ctrlleft", KEY_LEFTCTRL}, {"ctrlright", KEY_RIGHTCTRL},
+    {"alt", KEY_LEFTALT}, {"altleft", KEY_LEFTALT}, {"altright", KEY_RIGHTALT},
+    {"win", KEY_LEFTMETA}, {"winleft", KEY_LEFTMETA}, {"winright", KEY_RIGHTMETA}, {"apps", KEY_COMPOSE},
+    {"pause", KEY_PAUSE}, {"capslock", KEY_CAPSLOCK}, {"numlock", KEY_NUMLOCK}, {"scrolllock", KEY_SCROLLLOCK},
+    {"esc", KEY_ESC}, {"escape", KEY_ESC}, {"space", KEY_SPACE}, {" ", KEY_SPACE},
+    {"pageup", KEY_PAGEUP}, {"pgup", KEY_PAGEUP}, {"pagedown", KEY_PAGEDOWN}, {"pgdn", KEY_PAGEDOWN},
+    {"end", KEY_END}, {"home", KEY_HOME},
+    {"left", KEY_LEFT}, {"up", KEY_UP}, {"right", KEY_RIGHT}, {"down", KEY_DOWN},
+    {"select", KEY_SELECT}, {"print", KEY_SYSRQ}, {"printscreen", KEY_SYSRQ}, {"prtsc", KEY_SYSRQ},
+    {"prtscr", KEY_SYSRQ}, {"prntscrn", KEY_SYSRQ},
+    {"insert", KEY_INSERT}, {"delete", KEY_DELETE}, {"del", KEY_DELETE}, {"help", KEY_HELP},
+    {"multiply", KEY_KPASTERISK}, {"add", KEY_KPPLUS}, {"separator", KEY_KPCOMMA},
+    {"subtract", KEY_KPMINUS}, {"decimal", KEY_KPDOT}, {"divide", KEY_KPSLASH},
+    {"volumemute", KEY_MUTE}, {"volumedown", KEY_VOLUMEDOWN}, {"volumeup", KEY_VOLUMEUP},
+    {"playpause", KEY_PLAYPAUSE}, {"stop", KEY_STOPCD}, {"prevtrack", KEY_PREVIOUSSONG},
+    {"nexttrack", KEY_NEXTSONG},
+};
+
+static const uint16_t kFunctionKeys[24] = {
+    KEY_F1,  KEY_F2,  KEY_F3,  KEY_F4,  KEY_F5,  KEY_F6,  KEY_F7,  KEY_F8,
+    KEY_F9,  KEY_F10, KEY_F11, KEY_F12, KEY_F13, KEY_F14, KEY_F15, KEY_F16,
+    KEY_F17, KEY_F18, KEY_F19, KEY_F20, KEY_F21, KEY_F22, KEY_F23, KEY_F24,
+};
+
+static const uint16_t kKeypadDigits[10] = {
+    KEY_KP0, KEY_KP1, KEY_KP2, KEY_KP3, KEY_KP4, KEY_KP5, KEY_KP6, KEY_KP7, KEY_KP8, KEY_KP9,
+};
+
+// Printable ASCII on a US keyboard: plain on the left, shifted on the right.
+static const struct {
+    char     plain;
+    char     shifted;
+    uint16_t code;
+} kUsLayout[] = {
+    {'1', '!', KEY_1}, {'2', '@', KEY_2}, {'3', '#', KEY_3}, {'4', '$', KEY_4}, {'5', '%', KEY_5},
+    {'6', '^', KEY_6}, {'7', '&', KEY_7}, {'8', '*', KEY_8}, {'9', '(', KEY_9}, {'0', ')', KEY_0},
+    {'-', '_', KEY_MINUS}, {'=', '+', KEY_EQUAL}, {'[', '{', KEY_LEFTBRACE}, {']', '}', KEY_RIGHTBRACE},
+    {'\\', '|', KEY_BACKSLASH}, {';', ':', KEY_SEMICOLON}, {'\'', '"', KEY_APOSTROPHE},
+    {'`', '~', KEY_GRAVE}, {',', '<', KEY_COMMA}, {'.', '>', KEY_DOT}, {'/', '?', KEY_SLASH},
+    {' ', ' ', KEY_SPACE},
+    {'q', 'Q', KEY_Q}, {'w', 'W', KEY_W}, {'e', 'E', KEY_E}, {'r', 'R', KEY_R}, {'t', 'T', KEY_T},
+    {'y', 'Y', KEY_Y}, {'u', 'U', KEY_U}, {'i', 'I', KEY_I}, {'o', 'O', KEY_O}, {'p', 'P', KEY_P},
+    {'a', 'A', KEY_A}, {'s', 'S', KEY_S}, {'d', 'D', KEY_D}, {'f', 'F', KEY_F}, {'g', 'G', KEY_G},
+    {'h', 'H', KEY_H}, {'j', 'J', KEY_J}, {'k', 'K', KEY_K}, {'l', 'L', KEY_L},
+    {'z', 'Z', KEY_Z}, {'x', 'X', KEY_X}, {'c', 'C', KEY_C}, {'v', 'V', KEY_V}, {'b', 'B', KEY_B},
+    {'n', 'N', KEY_N}, {'m', 'M', KEY_M},
+};
+
+// "WxH" from NEURO_UINPUT_SCREEN, else the first connected DRM
+// connector's preferred (first listed) mode.
+static bool screen_of(int32_t& width, int32_t& height) {
+    if (const char* env = std::getenv("NEURO_UINPUT_SCREEN")) {
+        return std::sscanf(env, "%dx%d", &width, &height) == 2 && width > 0 && height > 0;
+    }
+
+    DIR* drm = opendir("/sys/class/drm");
+    if (!drm) {
+        return false;
+    }
+    bool found = false;
+    while (dirent* entry = readdir(drm)) {
+        if (std::strncmp(entry->d_name, "card", 4) != 0 || !std::strchr(entry->d_name, '-')) {
+            continue; // connectors are cardN-<type>-M
+        }
+        std::string base = std::string("/sys/class/drm/") + entry->d_name;
+
+        char  line[64]  = {};
+        FILE* file      = std::fopen((base + "/status").c_str(), "r");
+        bool  connected = file && std::fgets(line, sizeof(line), file) && std::strncmp(line, "connected", 9) == 0;
+        if (file) {
+            std::fclose(file);
+        }
+        if (!connected) {
+            continue;
+        }
+
+        file  = std::fopen((base + "/modes").c_str(), "r");
+        found = file && std::fgets(line, sizeof(line), file) && std::sscanf(line, "%dx%d", &width, &height) == 2
+                && width > 0 && height > 0;
+        if (file) {
+            std::fclose(file);
+        }
+        if (found) {
+            break;
+        }
+    }
+    closedir(drm);
+    return found;
+}
+
+struct PlatformInput::Impl {
+    int     fd     = -1;
+    int32_t width  = 0;
+    int32_t height = 0;
+    int32_t x      = 0;
+    int32_t y      = 0;
+    bool    moved  = false; // x, y hold a position we injected
+
+    std::unordered_map<std::string, uint16_t> names;
+    std::vector<input_event>                  batch;
+
+    ~Impl() {
+        if (fd >= 0) {
+            ioctl(fd, UI_DEV_DESTROY);
+            close(fd);
+        }
+    }
+
+    void push(uint16_t type, uint16_t code, int32_t value) {
+        input_event event{};
+        event.type  = type;
+        event.code  = code;
+        event.value = value;
+        batch.push_back(event);
+    }
+
+    void sync() { push(EV_SYN, SYN_REPORT, 0); }
+};
+
+PlatformInput::PlatformInput() = default;
+PlatformInput::~PlatformInput() = default;
+
+Status PlatformInput::open() {
+    auto impl = std::make_unique<Impl>();
+    if (!screen_of(impl->width, impl->height)) {
+        return Status::Unavailable;
+    }
+
+    impl->fd = ::open("/dev/uinput", O_WRONLY | O_CLOEXEC);
+    if (impl->fd < 0) {
+        return Status::Unavailable;
+    }
+    int fd = impl->fd;
+
+    bool ok = ioctl(fd, UI_SET_EVBIT, EV_KEY) == 0 && ioctl(fd, UI_SET_EVBIT, EV_SYN) == 0
+              && ioctl(fd, UI_SET_EVBIT, EV_ABS) == 0 && ioctl(fd, UI_SET_EVBIT, EV_REL) == 0
+              && ioctl(fd, UI_SET_ABSBIT, ABS_X) == 0 && ioctl(fd, UI_SET_ABSBIT, ABS_Y) == 0
+              && ioctl(fd, UI_SET_RELBIT, REL_WHEEL) == 0;
+    for (int code = KEY_ESC; ok && code <= KEY_MICMUTE; ++code) {
+        ok = ioctl(fd, UI_SET_KEYBIT, code) == 0;
+    }
+    for (int code : {BTN_LEFT, BTN_RIGHT, BTN_MIDDLE}) {
+        ok = ok && ioctl(fd, UI_SET_KEYBIT, code) == 0;
+    }
+
+    uinput_setup setup{};
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor  = 0x4e4e; // "NN"
+    setup.id.product = 0x0001;
+    std::snprintf(setup.name, sizeof(setup.name), "neuro_native input");
+    ok = ok && ioctl(fd, UI_DEV_SETUP, &setup) == 0;
+
+    for (uint16_t axis : {ABS_X, ABS_Y}) {
+        uinput_abs_setup abs{};
+        abs.code            = axis;
+        abs.absinfo.minimum = 0;
+        abs.absinfo.maximum = (axis == ABS_X ? impl->width : impl->height) - 1;
+        ok = ok && ioctl(fd, UI_ABS_SETUP, &abs) == 0;
+    }
+    if (!ok || ioctl(fd, UI_DEV_CREATE) != 0) {
+        return Status::Failed;
+    }
+    // The compositor picks new devices up asynchronously; events sent
+    // before it opened this one would be lost.
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    for (const NamedKey& key : kNamedKeys) {
+        impl->names.emplace(key.name, key.code);
+    }
+    for (int i = 0; i < 10; ++i) {
+        impl->names.emplace("num" + std::to_string(i), kKeypadDigits[i]);
+    }
+    for (int i = 1; i <= 24; ++i) {
+        impl->names.emplace("f" + std::to_string(i), kFunctionKeys[i - 1]);
+    }
+
+    impl_ = std::move(impl);
+    return Status::Ok;
+}
+
+Status PlatformInput::screen_size(int32_t& width, int32_t& height) {
+    width  = impl_->width;
+    height = impl_->height;
+    return Status::Ok;
+}
+
+Status PlatformInput::cursor(int32_t& x, int32_t& y) {
+    if (!impl_->moved) {
+        return Status::Unavailable;
+    }
+    x = impl_->x;
+    y = impl_->y;
+    return Status::Ok;
+}
+
+bool PlatformInput::resolve_key(std::string_view name, KeyStroke& out) {
+    auto it = impl_->names.find(std::string(name));
+    if (it == impl_->names.end()) {
+        return false;
+    }
+    out = KeyStroke{it->second, false};
+    return true;
+}
+
+bool PlatformInput::resolve_char(uint32_t codepoint, KeyStroke& out) {
+    for (const auto& key : kUsLayout) {
+        if (codepoint == static_cast<unsigned char>(key.plain)) {
+            out = KeyStroke{key.code, false};
+            return true;
+        }
+        if (codepoint == static_cast<unsigned char>(key.shifted)) {
+            out = KeyStroke{key.code, true};
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PlatformInput::supports_unicode() const {
+    return false;
+}
+
+Status PlatformInput::set_clipboard(std::string_view) {
+    return Status::Unavailable;
+}
+
+Status PlatformInput::send(const InputEvent* events, size_t count) {
+    Impl& impl = *impl_;
+    impl.batch.clear();
+
+    for (size_t i = 0; i < count; ++i) {
+        const InputEvent& event = events[i];
+        switch (event.kind) {
+            case InputEvent::Kind::Key:
+                impl.push(EV_KEY, static_cast<uint16_t>(event.code), event.down ? 1 : 0);
+                impl.sync();
+                break;
+
+            case InputEvent::Kind::Move:
+                impl.push(EV_ABS, ABS_X, event.x);
+                impl.push(EV_ABS, ABS_Y, event.y);
+                impl.sync();
+                impl.x     = event.x;
+                impl.y     = event.y;
+                impl.moved = true;
+                break;
+
+            case InputEvent::Kind::Button: {
+                uint16_t button = event.code == NN_BUTTON_RIGHT  ? BTN_RIGHT
+                                : event.code == NN_BUTTON_MIDDLE ? BTN_MIDDLE
+                                                                 : BTN_LEFT;
+                impl.push(EV_KEY, button, event.down ? 1 : 0);
+                impl.sync();
+                break;
+            }
+
+            case InputEvent::Kind::Wheel:
+                // One detent per 120 units, positive away from the user.
+                if (event.y / 120 != 0) {
+                    impl.push(EV_REL, REL_WHEEL, event.y / 120);
+                    impl.sync();
+                }
+                break;
+
+            case InputEvent::Kind::Unicode:
+                return Status::Unavailable;
+
+            case InputEvent::Kind::Paste:
+                break; // carried out by the injector
+        }
+    }
+
+    const char* data = reinterpret_cast<const char*>(impl.batch.data());
+    size_t      left = impl.batch.size() * sizeof(input_event);
+    while (left > 0) {
+        ssize_t written = write(impl.fd, data, left);
+        if (written < 0) {
+            return Status::Failed;
+        }
+        data += written;
+        left -= static_cast<size_t>(written);
+    }
+    return Status::Ok;
+}
+
+} // namespace neuro
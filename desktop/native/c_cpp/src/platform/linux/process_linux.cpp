@@ -0,0 +1,259 @@
+// Linux process source. The first refresh scans /proc. After that, if
+// the kernel's process event connector is available (netlink
+// NETLINK_CONNECTOR / CN_IDX_PROC: needs CAP_NET_ADMIN and the initial
+// pid namespace), refreshes only replay the fork/exec/exit events queued
+// since the last one. Otherwise every refresh rescans /proc, reading
+// comm and stat only for pids the tracker doesn't know yet.
+
+#include "process_tracker.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+
+namespace neuro {
+
+// How long to wait for the connector to acknowledge the subscription.
+// The kernel ignores (without an error) listeners outside the initial
+// namespaces, so no ack means no events.
+constexpr int kAckTimeoutMs = 100;
+
+constexpr size_t kRecvBuffer = 16 * 1024;
+
+static bool read_file(const char* path, char* out, size_t size, size_t& length) {
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t n = ::read(fd, out, size - 1);
+    ::close(fd);
+    if (n < 0) {
+        return false;
+    }
+    length = static_cast<size_t>(n);
+    out[length] = '\0';
+    return true;
+}
+
+// comm (the kernel's 15-byte task name, what ps shows) and the start
+// time in clock ticks since boot (stat field 22). False once the
+// process is gone.
+static bool read_process(uint32_t pid, std::string& name, uint64_t& start_time) {
+    char   path[64];
+    char   text[1024];
+    size_t length = 0;
+
+    snprintf(path, sizeof(path), "/proc/%u/comm", pid);
+    if (!read_file(path, text, sizeof(text), length)) {
+        return false;
+    }
+    while (length && text[length - 1] == '\n') {
+        --length;
+    }
+    name.assign(text, length);
+
+    // comm can hold spaces and parentheses: fields resume after the last ')'.
+    snprintf(path, sizeof(path), "/proc/%u/stat", pid);
+    if (!read_file(path, text, sizeof(text), length)) {
+        return false;
+    }
+    const char* cursor = strrchr(text, ')');
+    if (!cursor) {
+        return false;
+    }
+    // Field 3 (state) follows; start time is 19 fields later.
+    ++cursor;
+    for (int field = 3; field < 22 && *cursor; ++field) {
+        while (*cursor == ' ') ++cursor;
+        while (*cursor && *cursor != ' ') ++cursor;
+    }
+    start_time = strtoull(cursor, nullptr, 10);
+    return true;
+}
+
+struct PlatformProcessSource::Impl {
+    int          events = -1; // connector socket, -1 = scanning
+    bool         seeded = false;
+    std::string  name;
+
+    ~Impl() { close_events(); }
+
+    void close_events() {
+        if (events >= 0) {
+            ::close(events);
+            events = -1;
+        }
+    }
+
+    bool send_op(enum proc_cn_mcast_op op) {
+        alignas(nlmsghdr) char buffer[NLMSG_SPACE(sizeof(cn_msg) + sizeof(op))] = {};
+
+        auto* header        = reinterpret_cast<nlmsghdr*>(buffer);
+        header->nlmsg_len   = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(op));
+        header->nlmsg_type  = NLMSG_DONE;
+
+        auto* message   = static_cast<cn_msg*>(NLMSG_DATA(header));
+        message->id.idx = CN_IDX_PROC;
+        message->id.val = CN_VAL_PROC;
+        message->len    = sizeof(op);
+        memcpy(message + 1, &op, sizeof(op));
+
+        return ::send(events, buffer, header->nlmsg_len, 0) == static_cast<ssize_t>(header->nlmsg_len);
+    }
+
+    // Subscribes before the first scan, so nothing that happens during it
+    // is lost; replaying an event the scan already saw is a no-op.
+    void open_events() {
+        events = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+        if (events < 0) {
+            return;
+        }
+
+        sockaddr_nl address = {};
+        address.nl_family   = AF_NETLINK;
+        address.nl_groups   = CN_IDX_PROC;
+        if (bind(events, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+            || !send_op(PROC_CN_MCAST_LISTEN) || !wait_ack()) {
+            close_events();
+        }
+    }
+
+    bool wait_ack() {
+        pollfd fd = {events, POLLIN, 0};
+        alignas(nlmsghdr) char buffer[kRecvBuffer];
+        while (poll(&fd, 1, kAckTimeoutMs) > 0) {
+            ssize_t n = recv(events, buffer, sizeof(buffer), 0);
+            if (n <= 0) {
+                return false;
+            }
+            // Other processes' events may arrive first; the ack is the
+            // PROC_EVENT_NONE carrying err = 0.
+            auto* header = reinterpret_cast<nlmsghdr*>(buffer);
+            for (auto length = static_cast<unsigned>(n); NLMSG_OK(header, length);
+                 header = NLMSG_NEXT(header, length)) {
+                const auto* event = event_of(header);
+                if (event && event->what == proc_event::PROC_EVENT_NONE) {
+                    return event->event_data.ack.err == 0;
+                }
+            }
+        }
+        return false;
+    }
+
+    static const proc_event* event_of(const nlmsghdr* header) {
+        if (header->nlmsg_len < NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_event))) {
+            return nullptr;
+        }
+        const auto* message = static_cast<const cn_msg*>(NLMSG_DATA(header));
+        if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC) {
+            return nullptr;
+        }
+        return reinterpret_cast<const proc_event*>(message + 1);
+    }
+
+    void report(ProcessTracker& sink, uint32_t pid) {
+        uint64_t start_time = 0;
+        if (read_process(pid, name, start_time)) {
+            sink.add(pid, start_time, name);
+        }
+    }
+
+    void scan(ProcessTracker& sink) {
+        DIR* dir = opendir("/proc");
+        if (!dir) {
+            return;
+        }
+        while (dirent* entry = readdir(dir)) {
+            char* end = nullptr;
+            unsigned long pid = strtoul(entry->d_name, &end, 10);
+            if (end == entry->d_name || *end || !pid) {
+                continue;
+            }
+            if (!sink.keep(static_cast<uint32_t>(pid), 0)) {
+                report(sink, static_cast<uint32_t>(pid));
+            }
+        }
+        closedir(dir);
+    }
+
+    void apply(ProcessTracker& sink, const proc_event& event) {
+        // Threads raise the same events; only thread-group leaders count.
+        switch (event.what) {
+            case proc_event::PROC_EVENT_FORK:
+                if (event.event_data.fork.child_pid == event.event_data.fork.child_tgid) {
+                    report(sink, static_cast<uint32_t>(event.event_data.fork.child_tgid));
+                }
+                break;
+            case proc_event::PROC_EVENT_EXEC:
+                report(sink, static_cast<uint32_t>(event.event_data.exec.process_tgid));
+                break;
+            case proc_event::PROC_EVENT_COMM:
+                if (event.event_data.comm.process_pid == event.event_data.comm.process_tgid) {
+                    report(sink, static_cast<uint32_t>(event.event_data.comm.process_tgid));
+                }
+                break;
+            case proc_event::PROC_EVENT_EXIT:
+                if (event.event_data.exit.process_pid == event.event_data.exit.process_tgid) {
+                    sink.remove(static_cast<uint32_t>(event.event_data.exit.process_tgid));
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    // False when the socket overflowed and events were dropped.
+    bool drain(ProcessTracker& sink) {
+        alignas(nlmsghdr) char buffer[kRecvBuffer];
+        for (;;) {
+            ssize_t n = recv(events, buffer, sizeof(buffer), 0);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            auto* header = reinterpret_cast<nlmsghdr*>(buffer);
+            for (auto length = static_cast<unsigned>(n); NLMSG_OK(header, length);
+                 header = NLMSG_NEXT(header, length)) {
+                if (const auto* event = event_of(header)) {
+                    apply(sink, *event);
+                }
+            }
+        }
+    }
+};
+
+PlatformProcessSource::PlatformProcessSource() : impl_(std::make_unique<Impl>()) {}
+PlatformProcessSource::~PlatformProcessSource() = default;
+
+Status PlatformProcessSource::refresh(ProcessTracker& sink, bool& full) {
+    Impl& impl = *impl_;
+    if (!impl.seeded) {
+        impl.open_events();
+        impl.seeded = true;
+    } else if (impl.events >= 0) {
+        if (impl.drain(sink)) {
+            full = false;
+            return Status::Ok;
+        }
+        // ENOBUFS: the kernel dropped events. Drain what's left, then
+        // rescan to resynchronise.
+        impl.drain(sink);
+    }
+
+    impl.scan(sink);
+    full = true;
+    return Status::Ok;
+}
+
+} // namespace neuro
@@ -0,0 +1,506 @@
+// AT-SPI backend. Accessible applications (GTK, Qt, Firefox, Chromium,
+// LibreOffice) publish their trees on the accessibility bus; start()
+// connects, registers the listeners and walks the active frame, then
+// the thread runs libatspi's GLib loop, which delivers the events on
+// it. Events only mark what moved; a short timer folds everything
+// marked into one batch (children-changed re-walks the parent, state
+// and name changes refresh the element) and commits once. libatspi is
+// not thread-safe, so after start() every call into it happens on the
+// loop thread until stop() has joined it.
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <atspi/atspi.h>
+
+#include "ui_tree.hpp"
+
+namespace neuro {
+
+namespace {
+
+constexpr guint kFlushMs  = 50; // events folded into one batch
+constexpr int   kMaxClimb = 8;  // ancestors tried for an unknown event source
+
+uint32_t role_of(AtspiRole role, bool editable) {
+    switch (role) {
+        case ATSPI_ROLE_FRAME:
+        case ATSPI_ROLE_WINDOW:              return NN_UI_ROLE_WINDOW;
+        case ATSPI_ROLE_DIALOG:
+        case ATSPI_ROLE_ALERT:
+        case ATSPI_ROLE_FILE_CHOOSER:        return NN_UI_ROLE_DIALOG;
+        case ATSPI_ROLE_PANEL:
+        case ATSPI_ROLE_FILLER:
+        case ATSPI_ROLE_SCROLL_PANE:
+        case ATSPI_ROLE_SPLIT_PANE:
+        case ATSPI_ROLE_VIEWPORT:
+        case ATSPI_ROLE_SECTION:
+        case ATSPI_ROLE_LAYERED_PANE:
+        case ATSPI_ROLE_ROOT_PANE:
+        case ATSPI_ROLE_INTERNAL_FRAME:      return NN_UI_ROLE_PANE;
+        case ATSPI_ROLE_GROUPING:
+        case ATSPI_ROLE_FORM:                return NN_UI_ROLE_GROUP;
+        case ATSPI_ROLE_PUSH_BUTTON:
+        case ATSPI_ROLE_TOGGLE_BUTTON:       return NN_UI_ROLE_BUTTON;
+        case ATSPI_ROLE_CHECK_BOX:           return NN_UI_ROLE_CHECKBOX;
+        case ATSPI_ROLE_RADIO_BUTTON:        return NN_UI_ROLE_RADIO;
+        case ATSPI_ROLE_COMBO_BOX:           return NN_UI_ROLE_COMBOBOX;
+        case ATSPI_ROLE_ENTRY:
+        case ATSPI_ROLE_PASSWORD_TEXT:       return NN_UI_ROLE_EDIT;
+        case ATSPI_ROLE_TEXT:
+        case ATSPI_ROLE_PARAGRAPH:           return editable ? NN_UI_ROLE_EDIT : NN_UI_ROLE_TEXT;
+        case ATSPI_ROLE_LABEL:
+        case ATSPI_ROLE_STATIC:              return NN_UI_ROLE_TEXT;
+        case ATSPI_ROLE_LINK:                return NN_UI_ROLE_LINK;
+        case ATSPI_ROLE_IMAGE:
+        case ATSPI_ROLE_ICON:                return NN_UI_ROLE_IMAGE;
+        case ATSPI_ROLE_LIST:
+        case ATSPI_ROLE_LIST_BOX:            return NN_UI_ROLE_LIST;
+        case ATSPI_ROLE_LIST_ITEM:           return NN_UI_ROLE_LIST_ITEM;
+        case ATSPI_ROLE_MENU:
+        case ATSPI_ROLE_POPUP_MENU:          return NN_UI_ROLE_MENU;
+        case ATSPI_ROLE_MENU_BAR:            return NN_UI_ROLE_MENU_BAR;
+        case ATSPI_ROLE_MENU_ITEM:
+        case ATSPI_ROLE_CHECK_MENU_ITEM:
+        case ATSPI_ROLE_RADIO_MENU_ITEM:     return NN_UI_ROLE_MENU_ITEM;
+        case ATSPI_ROLE_PAGE_TAB_LIST:       return NN_UI_ROLE_TAB;
+        case ATSPI_ROLE_PAGE_TAB:            return NN_UI_ROLE_TAB_ITEM;
+        case ATSPI_ROLE_TREE:
+        case ATSPI_ROLE_TREE_TABLE:          return NN_UI_ROLE_TREE;
+        case ATSPI_ROLE_TREE_ITEM:           return NN_UI_ROLE_TREE_ITEM;
+        case ATSPI_ROLE_TABLE:               return NN_UI_ROLE_TABLE;
+        case ATSPI_ROLE_TABLE_ROW:           return NN_UI_ROLE_ROW;
+        case ATSPI_ROLE_TABLE_CELL:          return NN_UI_ROLE_CELL;
+        case ATSPI_ROLE_HEADER:
+        case ATSPI_ROLE_TABLE_COLUMN_HEADER:
+        case ATSPI_ROLE_TABLE_ROW_HEADER:    return NN_UI_ROLE_HEADER;
+        case ATSPI_ROLE_TOOL_BAR:            return NN_UI_ROLE_TOOLBAR;
+        case ATSPI_ROLE_STATUS_BAR:          return NN_UI_ROLE_STATUS_BAR;
+        case ATSPI_ROLE_SCROLL_BAR:          return NN_UI_ROLE_SCROLL_BAR;
+        case ATSPI_ROLE_SLIDER:              return NN_UI_ROLE_SLIDER;
+        case ATSPI_ROLE_SPIN_BUTTON:         return NN_UI_ROLE_SPINNER;
+        case ATSPI_ROLE_PROGRESS_BAR:        return NN_UI_ROLE_PROGRESS;
+        case ATSPI_ROLE_DOCUMENT_FRAME:
+        case ATSPI_ROLE_DOCUMENT_WEB:
+        case ATSPI_ROLE_DOCUMENT_TEXT:       return NN_UI_ROLE_DOCUMENT;
+        case ATSPI_ROLE_HEADING:             return NN_UI_ROLE_HEADING;
+        case ATSPI_ROLE_SEPARATOR:           return NN_UI_ROLE_SEPARATOR;
+        case ATSPI_ROLE_TOOL_TIP:            return NN_UI_ROLE_TOOLTIP;
+        default:                             return NN_UI_ROLE_UNKNOWN;
+    }
+}
+
+// FNV-1a of bus name + object path, which name the object for its lifetime.
+uint64_t key_of(AtspiAccessible* accessible) {
+    AtspiObject* object = ATSPI_OBJECT(accessible);
+    uint64_t     hash   = 14695981039346656037ull;
+    auto         mix    = [&hash](const char* text) {
+        for (; text && *text; ++text) {
+            hash ^= static_cast<unsigned char>(*text);
+            hash *= 1099511628211ull;
+        }
+        hash *= 1099511628211ull; // the NUL between the two
+    };
+    mix(object->app ? object->app->bus_name : nullptr);
+    mix(object->path);
+    return hash;
+}
+
+// Fills `node`; false for an object that is already gone.
+bool node_of(AtspiAccessible* accessible, uint64_t parent, UiNode& node) {
+    AtspiStateSet* states = atspi_accessible_get_state_set(accessible);
+    if (!states || atspi_state_set_contains(states, ATSPI_STATE_DEFUNCT)) {
+        if (states) {
+            g_object_unref(states);
+        }
+        return false;
+    }
+
+    node        = UiNode{};
+    node.id     = key_of(accessible);
+    node.parent = parent;
+
+    bool expandable = atspi_state_set_contains(states, ATSPI_STATE_EXPANDABLE);
+    bool editable   = atspi_state_set_contains(states, ATSPI_STATE_EDITABLE);
+    if (!atspi_state_set_contains(states, ATSPI_STATE_ENABLED)) {
+        node.states |= NN_UI_STATE_DISABLED;
+    }
+    if (atspi_state_set_contains(states, ATSPI_STATE_FOCUSED)) {
+        node.states |= NN_UI_STATE_FOCUSED;
+    }
+    if (atspi_state_set_contains(states, ATSPI_STATE_SELECTED)) {
+        node.states |= NN_UI_STATE_SELECTED;
+    }
+    if (atspi_state_set_contains(states, ATSPI_STATE_CHECKED) || atspi_state_set_contains(states, ATSPI_STATE_PRESSED)) {
+        node.states |= NN_UI_STATE_CHECKED;
+    }
+    if (atspi_state_set_contains(states, ATSPI_STATE_EXPANDED)) {
+        node.states |= NN_UI_STATE_EXPANDED;
+    } else if (expandable) {
+        node.states |= NN_UI_STATE_COLLAPSED;
+    }
+    if (!atspi_state_set_contains(states, ATSPI_STATE_SHOWING)) {
+        node.states |= NN_UI_STATE_OFFSCREEN;
+    }
+    g_object_unref(states);
+
+    AtspiRole role = atspi_accessible_get_role(accessible, nullptr);
+    node.role      = role_of(role, editable);
+    if (role == ATSPI_ROLE_PASSWORD_TEXT) {
+        node.states |= NN_UI_STATE_PROTECTED;
+    }
+
+    if (gchar* name = atspi_accessible_get_name(accessible, nullptr)) {
+        node.name = name;
+        g_free(name);
+    }
+
+    if (AtspiComponent* component = atspi_accessible_get_component_iface(accessible)) {
+        if (AtspiRect* rect = atspi_component_get_extents(component, ATSPI_COORD_TYPE_SCREEN, nullptr)) {
+            node.bounds = Rect{rect->x, rect->y, rect->width, rect->height};
+            g_free(rect);
+        }
+        g_object_unref(component);
+    }
+
+    if (node.states & NN_UI_STATE_PROTECTED) {
+        return true;
+    }
+    if (node.role == NN_UI_ROLE_EDIT || node.role == NN_UI_ROLE_COMBOBOX) {
+        if (AtspiText* text = atspi_accessible_get_text_iface(accessible)) {
+            gint count = atspi_text_get_character_count(text, nullptr);
+            // Characters, not bytes; UiTree clips the UTF-8 afterwards.
+            gint end = count < static_cast<gint>(UiTree::kMaxText) ? count : static_cast<gint>(UiTree::kMaxText);
+            if (end > 0) {
+                if (gchar* value = atspi_text_get_text(text, 0, end, nullptr)) {
+                    node.value = value;
+                    g_free(value);
+                }
+            }
+            g_object_unref(text);
+        }
+    } else if (node.role == NN_UI_ROLE_SLIDER || node.role == NN_UI_ROLE_SPINNER || node.role == NN_UI_ROLE_PROGRESS) {
+        if (AtspiValue* value = atspi_accessible_get_value_iface(accessible)) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%g", atspi_value_get_current_value(value, nullptr));
+            node.value = buffer;
+            g_object_unref(value);
+        }
+    }
+    return true;
+}
+
+bool is_active_frame(AtspiAccessible* accessible) {
+    AtspiStateSet* states = atspi_accessible_get_state_set(accessible);
+    bool active = states && atspi_state_set_contains(states, ATSPI_STATE_ACTIVE);
+    if (states) {
+        g_object_unref(states);
+    }
+    return active;
+}
+
+} // namespace
+
+struct PlatformUiWatch::Impl {
+    std::thread thread;
+    bool        initialized = false; // atspi_init() was ours to undo
+
+    // Loop-thread state (start() before the thread exists)
+    UiTree*                                         sink   = nullptr;
+    AtspiAccessible*                                window = nullptr; // owned reference
+    std::vector<std::pair<AtspiEventListener*, const char*>> listeners; // with their event type
+    std::unordered_map<uint64_t, AtspiAccessible*> rewalks; // owned references
+    std::unordered_map<uint64_t, AtspiAccessible*> updates;
+    uint64_t                                        focus      = 0;
+    bool                                            focus_set  = false;
+    guint                                           flush_timer = 0;
+
+    // Pre-order walk of `from` (whose parent is `parent`) into `out`,
+    // bounded by kMaxNodes elements and kMaxDepth levels below `from`.
+    static void walk(AtspiAccessible* from, uint64_t parent, std::vector<UiNode>& out, uint64_t& focused) {
+        struct Pending {
+            AtspiAccessible* accessible; // owned reference
+            uint64_t         parent;
+            uint32_t         depth;
+        };
+        std::vector<Pending> pending;
+        pending.push_back(Pending{static_cast<AtspiAccessible*>(g_object_ref(from)), parent, 0});
+
+        while (!pending.empty()) {
+            Pending item = pending.back();
+            pending.pop_back();
+
+            UiNode node;
+            if (out.size() < UiTree::kMaxNodes && node_of(item.accessible, item.parent, node)) {
+                if (node.states & NN_UI_STATE_FOCUSED) {
+                    focused = node.id;
+                }
+                uint64_t id = node.id;
+                out.push_back(std::move(node));
+
+                gint count = item.depth < UiTree::kMaxDepth
+                                 ? atspi_accessible_get_child_count(item.accessible, nullptr)
+                                 : 0;
+                // Lists that manage their descendants can report millions
+                // of children; nothing past the budget would be kept.
+                gint room = static_cast<gint>(UiTree::kMaxNodes - out.size());
+                for (gint i = (count < room ? count : room) - 1; i >= 0; --i) {
+                    if (AtspiAccessible* child = atspi_accessible_get_child_at_index(item.accessible, i, nullptr)) {
+                        pending.push_back(Pending{child, id, item.depth + 1});
+                    }
+                }
+            }
+            g_object_unref(item.accessible);
+        }
+    }
+
+    void follow(AtspiAccessible* next) {
+        if (window) {
+            g_object_unref(window);
+        }
+        window = next ? static_cast<AtspiAccessible*>(g_object_ref(next)) : nullptr;
+        drop_pending();
+
+        std::vector<UiNode> nodes;
+        uint64_t            focused = 0;
+        if (window) {
+            walk(window, 0, nodes, focused);
+        }
+        sink->reset(0, std::move(nodes)); // no portable frame -> X11 window mapping
+        sink->set_focus(focused);
+        sink->commit();
+    }
+
+    // The active frame, found by scanning every application's top level.
+    static AtspiAccessible* active_frame() {
+        AtspiAccessible* desktop = atspi_get_desktop(0);
+        if (!desktop) {
+            return nullptr;
+        }
+        AtspiAccessible* found = nullptr;
+        gint apps = atspi_accessible_get_child_count(desktop, nullptr);
+        for (gint a = 0; a < apps && !found; ++a) {
+            AtspiAccessible* app = atspi_accessible_get_child_at_index(desktop, a, nullptr);
+            if (!app) {
+                continue;
+            }
+            gint frames = atspi_accessible_get_child_count(app, nullptr);
+            for (gint f = 0; f < frames && !found; ++f) {
+                AtspiAccessible* frame = atspi_accessible_get_child_at_index(app, f, nullptr);
+                if (frame && is_active_frame(frame)) {
+                    found = frame;
+                } else if (frame) {
+                    g_object_unref(frame);
+                }
+            }
+            g_object_unref(app);
+        }
+        g_object_unref(desktop);
+        return found;
+    }
+
+    void drop_pending() {
+        for (auto& entry : rewalks) {
+            g_object_unref(entry.second);
+        }
+        for (auto& entry : updates) {
+            g_object_unref(entry.second);
+        }
+        rewalks.clear();
+        updates.clear();
+        focus_set = false;
+    }
+
+    static void mark(std::unordered_map<uint64_t, AtspiAccessible*>& set, AtspiAccessible* accessible) {
+        uint64_t key = key_of(accessible);
+        if (set.count(key) == 0) {
+            set.emplace(key, static_cast<AtspiAccessible*>(g_object_ref(accessible)));
+        }
+    }
+
+    void schedule() {
+        if (flush_timer == 0) {
+            flush_timer = g_timeout_add(kFlushMs, &Impl::on_flush, this);
+        }
+    }
+
+    // Structure first (it may bring in the elements the other changes
+    // are about), then properties, then focus.
+    void flush() {
+        std::unordered_set<uint64_t> done;
+        for (auto& entry : rewalks) {
+            AtspiAccessible* accessible = static_cast<AtspiAccessible*>(g_object_ref(entry.second));
+            for (int climb = 0; accessible && climb < kMaxClimb; ++climb) {
+                uint64_t key = key_of(accessible);
+                if (sink->contains(key)) {
+                    if (done.insert(key).second) {
+                        std::vector<UiNode> nodes;
+                        uint64_t            focused = 0;
+                        walk(accessible, 0, nodes, focused);
+                        sink->replace(std::move(nodes));
+                    }
+                    break;
+                }
+                AtspiAccessible* parent = atspi_accessible_get_parent(accessible, nullptr);
+                g_object_unref(accessible);
+                accessible = parent;
+            }
+            if (accessible) {
+                g_object_unref(accessible);
+            }
+        }
+        for (auto& entry : updates) {
+            UiNode node;
+            if (sink->contains(entry.first) && done.count(entry.first) == 0) {
+                if (node_of(entry.second, 0, node)) {
+                    sink->update(node);
+                } else {
+                    sink->remove(entry.first);
+                }
+            }
+        }
+        if (focus_set) {
+            sink->set_focus(focus);
+        }
+        drop_pending();
+        sink->commit();
+    }
+
+    static gboolean on_flush(gpointer user) {
+        auto* self        = static_cast<Impl*>(user);
+        self->flush_timer = 0;
+        self->flush();
+        return G_SOURCE_REMOVE;
+    }
+
+    static void on_event(AtspiEvent* event, void* user) {
+        auto*       self = static_cast<Impl*>(user);
+        const char* type = event->type ? event->type : "";
+
+        if (event->source) {
+            if (g_str_has_prefix(type, "window:activate")) {
+                self->follow(event->source);
+            } else if (g_str_has_prefix(type, "object:children-changed")) {
+                mark(self->rewalks, event->source);
+                self->schedule();
+            } else if (g_str_has_prefix(type, "object:state-changed:focused")) {
+                if (event->detail1) {
+                    self->focus     = key_of(event->source);
+                    self->focus_set = true;
+                }
+                mark(self->updates, event->source);
+                self->schedule();
+            } else {
+                mark(self->updates, event->source);
+                self->schedule();
+            }
+        }
+        g_boxed_free(ATSPI_TYPE_EVENT, event);
+    }
+
+    void unregister() {
+        for (auto& [listener, type] : listeners) {
+            atspi_event_listener_deregister(listener, type, nullptr);
+            g_object_unref(listener);
+        }
+        listeners.clear();
+    }
+};
+
+PlatformUiWatch::PlatformUiWatch() : impl_(std::make_unique<Impl>()) {}
+PlatformUiWatch::~PlatformUiWatch() { stop(); }
+
+Status PlatformUiWatch::start(UiTree& sink) {
+    Impl& impl = *impl_;
+
+    int init = atspi_init();
+    if (init != 0 && init != 1) { // 1: someone in the process already did
+        return Status::Unavailable;
+    }
+    impl.initialized = init == 0;
+
+    GError*          error   = nullptr;
+    AtspiAccessible* desktop = atspi_get_desktop(0);
+    if (desktop) {
+        atspi_accessible_get_child_count(desktop, &error); // reaches the bus
+        g_object_unref(desktop);
+    }
+    if (!desktop || error) {
+        if (error) {
+            g_error_free(error);
+        }
+        if (impl.initialized) {
+            atspi_exit();
+        }
+        return Status::Unavailable;
+    }
+
+    static const char* const kEvents[] = {
+        "window:activate",
+        "object:children-changed",
+        "object:state-changed",
+        "object:property-change:accessible-name",
+        "object:property-change:accessible-value",
+        "object:text-changed",
+    };
+    impl.sink = &sink;
+    bool registered = true;
+    for (const char* type : kEvents) {
+        AtspiEventListener* listener = atspi_event_listener_new(&Impl::on_event, &impl, nullptr);
+        impl.listeners.emplace_back(listener, type);
+        registered = registered && atspi_event_listener_register(listener, type, nullptr);
+    }
+    if (!registered) {
+        impl.unregister();
+        if (impl.initialized) {
+            atspi_exit();
+        }
+        return Status::Failed;
+    }
+
+    AtspiAccessible* frame = Impl::active_frame();
+    impl.follow(frame);
+    if (frame) {
+        g_object_unref(frame);
+    }
+
+    impl.thread = std::thread(atspi_event_main);
+    return Status::Ok;
+}
+
+void PlatformUiWatch::stop() {
+    Impl& impl = *impl_;
+    if (!impl.thread.joinable()) {
+        return;
+    }
+
+    // Quitting from inside the loop also covers a loop not yet running.
+    g_idle_add([](gpointer) -> gboolean {
+        atspi_event_quit();
+        return G_SOURCE_REMOVE;
+    }, nullptr);
+    impl.thread.join();
+
+    if (impl.flush_timer) {
+        g_source_remove(impl.flush_timer);
+        impl.flush_timer = 0;
+    }
+    impl.unregister();
+    impl.drop_pending();
+    if (impl.window) {
+        g_object_unref(impl.window);
+        impl.window = nullptr;
+    }
+    if (impl.initialized) {
+        atspi_exit();
+        impl.initialized = false;
+    }
+    impl.sink = nullptr;
+}
+
+} // namespace neuro
@@ -0,0 +1,28 @@
+// Fallback for builds without a supported capture API.
+
+#include "capture.hpp"
+#include "monitors.hpp"
+
+namespace neuro {
+
+Status enumerate_monitors(std::vector<Monitor>&) {
+    return Status::Unavailable;
+}
+
+struct PlatformCapture::Impl {};
+
+PlatformCapture::PlatformCapture() = default;
+PlatformCapture::~PlatformCapture() = default;
+
+Status PlatformCapture::open(const CaptureOptions&, uint32_t) {
+    return Status::Unavailable;
+}
+
+int32_t PlatformCapture::width() const { return 0; }
+int32_t PlatformCapture::height() const { return 0; }
+
+Status PlatformCapture::grab(uint32_t, uint32_t, FrameSlot&, std::vector<Rect>*, bool*) {
+    return Status::Unavailable;
+}
+
+} // namespace neuro
@@ -0,0 +1,18 @@
+// Fallback for builds without a supported input hook API.
+
+#include "input_hook.hpp"
+
+namespace neuro {
+
+struct PlatformMouseHook::Impl {};
+
+PlatformMouseHook::PlatformMouseHook() = default;
+PlatformMouseHook::~PlatformMouseHook() = default;
+
+Status PlatformMouseHook::start(MouseHook&) {
+    return Status::Unavailable;
+}
+
+void PlatformMouseHook::stop() {}
+
+} // namespace neuro
@@ -0,0 +1,44 @@
+// Fallback for builds without a supported input injection API.
+
+#include "input.hpp"
+
+namespace neuro {
+
+struct PlatformInput::Impl {};
+
+PlatformInput::PlatformInput() = default;
+PlatformInput::~PlatformInput() = default;
+
+Status PlatformInput::open() {
+    return Status::Unavailable;
+}
+
+Status PlatformInput::send(const InputEvent*, size_t) {
+    return Status::Unavailable;
+}
+
+Status PlatformInput::screen_size(int32_t&, int32_t&) {
+    return Status::Unavailable;
+}
+
+Status PlatformInput::cursor(int32_t&, int32_t&) {
+    return Status::Unavailable;
+}
+
+bool PlatformInput::resolve_key(std::string_view, KeyStroke&) {
+    return false;
+}
+
+bool PlatformInput::resolve_char(uint32_t, KeyStroke&) {
+    return false;
+}
+
+bool PlatformInput::supports_unicode() const {
+    return false;
+}
+
+Status PlatformInput::set_clipboard(std::string_view) {
+    return Status::Unavailable;
+}
+
+} // namespace neuro
@@ -0,0 +1,16 @@
+// Fallback for platforms without a supported process table API.
+
+#include "process_tracker.hpp"
+
+namespace neuro {
+
+struct PlatformProcessSource::Impl {};
+
+PlatformProcessSource::PlatformProcessSource() = default;
+PlatformProcessSource::~PlatformProcessSource() = default;
+
+Status PlatformProcessSource::refresh(ProcessTracker&, bool&) {
+    return Status::Unavailable;
+}
+
+} // namespace neuro
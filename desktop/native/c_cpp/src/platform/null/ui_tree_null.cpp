@@ -0,0 +1,18 @@
+// Fallback for builds without an accessibility API.
+
+#include "ui_tree.hpp"
+
+namespace neuro {
+
+struct PlatformUiWatch::Impl {};
+
+PlatformUiWatch::PlatformUiWatch() = default;
+PlatformUiWatch::~PlatformUiWatch() = default;
+
+Status PlatformUiWatch::start(UiTree&) {
+    return Status::Unavailable;
+}
+
+void PlatformUiWatch::stop() {}
+
+} // namespace neuro
@@ -0,0 +1,18 @@
+// Fallback for builds without a supported window event API.
+
+#include "window_cache.hpp"
+
+namespace neuro {
+
+struct PlatformWindowWatch::Impl {};
+
+PlatformWindowWatch::PlatformWindowWatch() = default;
+PlatformWindowWatch::~PlatformWindowWatch() = default;
+
+Status PlatformWindowWatch::start(WindowCache&) {
+    return Status::Unavailable;
+}
+
+void PlatformWindowWatch::stop() {}
+
+} // namespace neuro
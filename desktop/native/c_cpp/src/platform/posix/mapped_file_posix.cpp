@@ -0,0 +1,81 @@
+// mmap backend. Shared mappings write through the page cache, so what
+// is in them survives the process; msync only matters for the machine
+// going down.
+
+#include "history.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace neuro {
+
+struct MappedFile::Impl {
+    uint8_t* data = nullptr;
+    size_t   size = 0;
+};
+
+MappedFile::MappedFile() : impl_(new Impl) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+Status MappedFile::open(const char* path, size_t size, bool writable) {
+    close();
+
+    int fd = ::open(path, writable ? O_RDWR | O_CREAT | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return Status::Failed;
+    }
+
+    if (writable) {
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            return Status::Failed;
+        }
+    } else {
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return Status::Failed;
+        }
+        size = static_cast<size_t>(st.st_size);
+    }
+
+    void* data = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps the file
+    if (data == MAP_FAILED) {
+        return Status::Failed;
+    }
+
+    impl_->data = static_cast<uint8_t*>(data);
+    impl_->size = size;
+    return Status::Ok;
+}
+
+void MappedFile::close() {
+    if (impl_->data) {
+        munmap(impl_->data, impl_->size);
+        impl_->data = nullptr;
+        impl_->size = 0;
+    }
+}
+
+Status MappedFile::flush() {
+    if (!impl_->data) {
+        return Status::Unavailable;
+    }
+    return msync(impl_->data, impl_->size, MS_ASYNC) == 0 ? Status::Ok : Status::Failed;
+}
+
+uint8_t* MappedFile::data() const {
+    return impl_->data;
+}
+
+size_t MappedFile::size() const {
+    return impl_->size;
+}
+
+} // namespace neuro
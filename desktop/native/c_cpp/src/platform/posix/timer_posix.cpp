@@ -0,0 +1,45 @@
+// clock_nanosleep backend. Absolute CLOCK_MONOTONIC sleeps (the clock
+// behind monotonic_ns) wake within the thread's timer slack, 50 us by
+// default on Linux.
+
+#include "scheduler.hpp"
+
+#include <cerrno>
+#include <time.h>
+
+#include "clock.hpp"
+
+namespace neuro {
+
+struct PlatformTimer::Impl {};
+
+PlatformTimer::PlatformTimer() = default;
+PlatformTimer::~PlatformTimer() = default;
+
+void PlatformTimer::sleep_until(uint64_t deadline_ns) {
+#if defined(TIMER_ABSTIME)
+    timespec ts;
+    ts.tv_sec  = static_cast<time_t>(deadline_ns / 1'000'000'000);
+    ts.tv_nsec = static_cast<long>(deadline_ns % 1'000'000'000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+#else
+    // No absolute sleeps (macOS): relative, re-armed after signals.
+    uint64_t now;
+    while ((now = monotonic_ns()) < deadline_ns) {
+        uint64_t left = deadline_ns - now;
+        timespec ts;
+        ts.tv_sec  = static_cast<time_t>(left / 1'000'000'000);
+        ts.tv_nsec = static_cast<long>(left % 1'000'000'000);
+        if (nanosleep(&ts, nullptr) == 0) {
+            break;
+        }
+    }
+#endif
+}
+
+uint64_t PlatformTimer::slack_ns() const {
+    return 100'000;
+}
+
+} // namespace neuro
@@ -0,0 +1,269 @@
+// DXGI Desktop Duplication backend. Each ring slot is a CPU-readable
+// staging texture that stays mapped while it holds a frame, so the only
+// copy per grab is the GPU-side CopyResource. Outputs are numbered across
+// every adapter, and each session creates its device on the adapter that
+// drives its output (duplication only works there).
+
+#include "capture.hpp"
+#include "monitors.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <d3d11.h>
+#include <dxgi1_2.h>
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+namespace neuro {
+
+struct DxgiOutput {
+    ComPtr<IDXGIAdapter1> adapter;
+    ComPtr<IDXGIOutput>   output;
+    Monitor               monitor;
+};
+
+// Desktop-attached outputs of every adapter: primary (the one at the
+// desktop origin) first, then in adapter/output order.
+static bool list_outputs(std::vector<DxgiOutput>& out) {
+    out.clear();
+    ComPtr<IDXGIFactory1> factory;
+    if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&factory)))) {
+        return false;
+    }
+
+    ComPtr<IDXGIAdapter1> adapter;
+    for (UINT a = 0; factory->EnumAdapters1(a, &adapter) != DXGI_ERROR_NOT_FOUND; ++a) {
+        ComPtr<IDXGIOutput> output;
+        for (UINT o = 0; adapter->EnumOutputs(o, &output) != DXGI_ERROR_NOT_FOUND; ++o) {
+            DXGI_OUTPUT_DESC desc;
+            if (FAILED(output->GetDesc(&desc)) || !desc.AttachedToDesktop) {
+                continue;
+            }
+            const RECT& r = desc.DesktopCoordinates;
+
+            DxgiOutput entry;
+            entry.adapter = adapter;
+            entry.output  = output;
+            entry.monitor.bounds  = Rect{r.left, r.top, r.right - r.left, r.bottom - r.top};
+            entry.monitor.primary = r.left == 0 && r.top == 0;
+            WideCharToMultiByte(CP_UTF8, 0, desc.DeviceName, -1, entry.monitor.name,
+                                static_cast<int>(sizeof(entry.monitor.name)) - 1, nullptr, nullptr);
+            out.push_back(std::move(entry));
+        }
+    }
+
+    std::stable_partition(out.begin(), out.end(), [](const DxgiOutput& entry) { return entry.monitor.primary; });
+    for (size_t i = 0; i < out.size(); ++i) {
+        out[i].monitor.index = static_cast<int32_t>(i);
+    }
+    return true;
+}
+
+Status enumerate_monitors(std::vector<Monitor>& out) {
+    std::vector<DxgiOutput> outputs;
+    if (!list_outputs(outputs)) {
+        return Status::Unavailable;
+    }
+    out.clear();
+    for (const DxgiOutput& entry : outputs) {
+        out.push_back(entry.monitor);
+    }
+    return Status::Ok;
+}
+
+struct StagingSlot {
+    ComPtr<ID3D11Texture2D> texture;
+    bool mapped = false;
+};
+
+struct PlatformCapture::Impl {
+    ComPtr<ID3D11Device>           device;
+    ComPtr<ID3D11DeviceContext>    context;
+    ComPtr<IDXGIOutput1>           output;
+    ComPtr<IDXGIOutputDuplication> duplication;
+
+    int32_t width  = 0;
+    int32_t height = 0;
+
+    std::vector<StagingSlot> slots;
+    std::vector<uint8_t>     metadata; // dirty/move rect scratch, grows to the OS maximum
+
+    ~Impl() {
+        for (StagingSlot& slot : slots) {
+            if (slot.mapped) {
+                context->Unmap(slot.texture.Get(), 0);
+            }
+        }
+    }
+
+    bool duplicate() {
+        duplication.Reset();
+        if (FAILED(output->DuplicateOutput(device.Get(), &duplication))) {
+            return false;
+        }
+
+        DXGI_OUTDUPL_DESC desc;
+        duplication->GetDesc(&desc);
+        width  = static_cast<int32_t>(desc.ModeDesc.Width);
+        height = static_cast<int32_t>(desc.ModeDesc.Height);
+        return true;
+    }
+
+    bool create_slot(StagingSlot& slot) {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.Width            = static_cast<UINT>(width);
+        desc.Height           = static_cast<UINT>(height);
+        desc.MipLevels        = 1;
+        desc.ArraySize        = 1;
+        desc.Format           = DXGI_FORMAT_B8G8R8A8_UNORM;
+        desc.SampleDesc.Count = 1;
+        desc.Usage            = D3D11_USAGE_STAGING;
+        desc.CPUAccessFlags   = D3D11_CPU_ACCESS_READ;
+
+        return SUCCEEDED(device->CreateTexture2D(&desc, nullptr, &slot.texture));
+    }
+
+    // Copies the frame's move + dirty rectangles into `damage`. Move rects
+    // only change their destination, so only that side is reported.
+    bool collect_damage(const DXGI_OUTDUPL_FRAME_INFO& info, std::vector<Rect>& damage) {
+        damage.clear();
+        if (info.TotalMetadataBufferSize == 0) {
+            return true;
+        }
+        if (metadata.size() < info.TotalMetadataBufferSize) {
+            metadata.resize(info.TotalMetadataBufferSize);
+        }
+
+        UINT size = static_cast<UINT>(metadata.size());
+        UINT used = 0;
+
+        auto* moves = reinterpret_cast<DXGI_OUTDUPL_MOVE_RECT*>(metadata.data());
+        if (FAILED(duplication->GetFrameMoveRects(size, moves, &used))) {
+            return false;
+        }
+        for (UINT i = 0; i < used / sizeof(DXGI_OUTDUPL_MOVE_RECT); ++i) {
+            const RECT& r = moves[i].DestinationRect;
+            damage.push_back(Rect{r.left, r.top, r.right - r.left, r.bottom - r.top});
+        }
+
+        auto* dirty = reinterpret_cast<RECT*>(metadata.data());
+        if (FAILED(duplication->GetFrameDirtyRects(size, dirty, &used))) {
+            return false;
+        }
+        for (UINT i = 0; i < used / sizeof(RECT); ++i) {
+            const RECT& r = dirty[i];
+            damage.push_back(Rect{r.left, r.top, r.right - r.left, r.bottom - r.top});
+        }
+        return true;
+    }
+};
+
+PlatformCapture::PlatformCapture() = default;
+PlatformCapture::~PlatformCapture() = default;
+
+Status PlatformCapture::open(const CaptureOptions& options, uint32_t slots) {
+    std::vector<DxgiOutput> outputs;
+    if (!list_outputs(outputs)) {
+        return Status::Unavailable;
+    }
+    if (options.output < 0 || static_cast<size_t>(options.output) >= outputs.size()) {
+        return Status::InvalidArgument;
+    }
+    DxgiOutput& target = outputs[options.output];
+
+    auto impl = std::make_unique<Impl>();
+
+    // An explicit adapter requires D3D_DRIVER_TYPE_UNKNOWN.
+    D3D_FEATURE_LEVEL level;
+    HRESULT hr = D3D11CreateDevice(target.adapter.Get(), D3D_DRIVER_TYPE_UNKNOWN, nullptr, 0,
+                                   nullptr, 0, D3D11_SDK_VERSION,
+                                   &impl->device, &level, &impl->context);
+    if (FAILED(hr)) {
+        return Status::Unavailable;
+    }
+    if (FAILED(target.output.As(&impl->output)) || !impl->duplicate()) {
+        return Status::Unavailable;
+    }
+
+    impl->slots.resize(slots);
+    for (StagingSlot& slot : impl->slots) {
+        if (!impl->create_slot(slot)) {
+            return Status::Failed;
+        }
+    }
+
+    impl_ = std::move(impl);
+    return Status::Ok;
+}
+
+int32_t PlatformCapture::width() const { return impl_ ? impl_->width : 0; }
+int32_t PlatformCapture::height() const { return impl_ ? impl_->height : 0; }
+
+Status PlatformCapture::grab(uint32_t slot, uint32_t timeout_ms, FrameSlot& out,
+                             std::vector<Rect>* damage, bool* damage_reported) {
+    Impl& impl = *impl_;
+    StagingSlot& target = impl.slots[slot];
+
+    DXGI_OUTDUPL_FRAME_INFO info;
+    ComPtr<IDXGIResource> resource;
+
+    HRESULT hr = impl.duplication->AcquireNextFrame(timeout_ms, &info, &resource);
+    if (hr == DXGI_ERROR_WAIT_TIMEOUT) {
+        return Status::Timeout;
+    }
+    if (hr == DXGI_ERROR_ACCESS_LOST) {
+        // Mode change / secure desktop: rebuild the duplication and let the
+        // caller retry on the next grab. A resolution change invalidates
+        // the staging ring, so the session has to be reopened.
+        int32_t width = impl.width, height = impl.height;
+        if (!impl.duplicate()) {
+            return Status::Failed;
+        }
+        return width == impl.width && height == impl.height ? Status::Timeout : Status::Unavailable;
+    }
+    if (FAILED(hr)) {
+        return Status::Failed;
+    }
+
+    // Pointer-only updates carry no new image.
+    if (info.LastPresentTime.QuadPart == 0) {
+        impl.duplication->ReleaseFrame();
+        return Status::Timeout;
+    }
+
+    ComPtr<ID3D11Texture2D> texture;
+    if (FAILED(resource.As(&texture))) {
+        impl.duplication->ReleaseFrame();
+        return Status::Failed;
+    }
+
+    if (target.mapped) {
+        impl.context->Unmap(target.texture.Get(), 0);
+        target.mapped = false;
+    }
+
+    if (damage) {
+        *damage_reported = impl.collect_damage(info, *damage);
+    }
+
+    impl.context->CopyResource(target.texture.Get(), texture.Get());
+    impl.duplication->ReleaseFrame();
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (FAILED(impl.context->Map(target.texture.Get(), 0, D3D11_MAP_READ, 0, &mapped))) {
+        return Status::Failed;
+    }
+    target.mapped = true;
+
+    out.data   = static_cast<const uint8_t*>(mapped.pData);
+    out.width  = impl.width;
+    out.height = impl.height;
+    out.stride = static_cast<int32_t>(mapped.RowPitch);
+    return Status::Ok;
+}
+
+} // namespace neuro
@@ -0,0 +1,118 @@
+// WH_MOUSE_LL backend. The hook has to be installed from a thread that
+// pumps messages, so it gets a dedicated one; the callback only copies
+// the event into the ring and returns to keep system input latency flat.
+
+#include "input_hook.hpp"
+
+#include <atomic>
+#include <thread>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#include "clock.hpp"
+
+namespace neuro {
+
+// Low-level hook procs get no user pointer.
+static std::atomic<MouseHook*> g_sink{nullptr};
+
+static LRESULT CALLBACK mouse_proc(int code, WPARAM wparam, LPARAM lparam) {
+    MouseHook* sink = g_sink.load(std::memory_order_acquire);
+    if (code == HC_ACTION && sink) {
+        const auto* info = reinterpret_cast<const MSLLHOOKSTRUCT*>(lparam);
+        uint64_t now   = monotonic_ns();
+        uint32_t flags = (info->flags & LLMHF_INJECTED) ? NN_RECORD_INJECTED : 0;
+        int32_t  x     = info->pt.x;
+        int32_t  y     = info->pt.y;
+
+        switch (wparam) {
+            case WM_MOUSEMOVE:   sink->on_move(x, y, now, flags); break;
+            case WM_LBUTTONDOWN: sink->on_button(x, y, 1, true, now, flags); break;
+            case WM_LBUTTONUP:   sink->on_button(x, y, 1, false, now, flags); break;
+            case WM_MBUTTONDOWN: sink->on_button(x, y, 2, true, now, flags); break;
+            case WM_MBUTTONUP:   sink->on_button(x, y, 2, false, now, flags); break;
+            case WM_RBUTTONDOWN: sink->on_button(x, y, 3, true, now, flags); break;
+            case WM_RBUTTONUP:   sink->on_button(x, y, 3, false, now, flags); break;
+            case WM_MOUSEWHEEL:
+                sink->on_wheel(x, y, GET_WHEEL_DELTA_WPARAM(info->mouseData), now, flags);
+                break;
+            default: break;
+        }
+    }
+    return CallNextHookEx(nullptr, code, wparam, lparam);
+}
+
+struct PlatformMouseHook::Impl {
+    std::thread        thread;
+    std::atomic<DWORD> thread_id{0};
+
+    void run(MouseHook& sink, HANDLE ready, Status& status) {
+        // Make sure the queue exists before anyone posts WM_QUIT to it.
+        MSG msg;
+        PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+        thread_id.store(GetCurrentThreadId(), std::memory_order_release);
+
+        g_sink.store(&sink, std::memory_order_release);
+        HHOOK hook = SetWindowsHookExW(WH_MOUSE_LL, mouse_proc, GetModuleHandleW(nullptr), 0);
+        status = hook ? Status::Ok : Status::Failed;
+        SetEvent(ready);
+        if (!hook) {
+            g_sink.store(nullptr, std::memory_order_release);
+            return;
+        }
+
+        for (;;) {
+            uint64_t wait_ns = sink.flush(monotonic_ns());
+            DWORD wait_ms = static_cast<DWORD>((wait_ns + 999'999) / 1'000'000);
+            MsgWaitForMultipleObjects(0, nullptr, FALSE, wait_ms, QS_ALLINPUT);
+
+            bool quit = false;
+            while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE)) {
+                if (msg.message == WM_QUIT) {
+                    quit = true;
+                    break;
+                }
+                DispatchMessageW(&msg);
+            }
+            if (quit) {
+                break;
+            }
+        }
+
+        UnhookWindowsHookEx(hook);
+        g_sink.store(nullptr, std::memory_order_release);
+    }
+};
+
+PlatformMouseHook::PlatformMouseHook() : impl_(std::make_unique<Impl>()) {}
+PlatformMouseHook::~PlatformMouseHook() { stop(); }
+
+Status PlatformMouseHook::start(MouseHook& sink) {
+    HANDLE ready = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!ready) {
+        return Status::Failed;
+    }
+
+    Status status = Status::Failed;
+    impl_->thread = std::thread([this, &sink, ready, &status] {
+        impl_->run(sink, ready, status);
+    });
+    WaitForSingleObject(ready, INFINITE);
+    CloseHandle(ready);
+
+    if (status != Status::Ok) {
+        impl_->thread.join();
+    }
+    return status;
+}
+
+void PlatformMouseHook::stop() {
+    if (!impl_->thread.joinable()) {
+        return;
+    }
+    PostThreadMessageW(impl_->thread_id.load(std::memory_order_acquire), WM_QUIT, 0, 0);
+    impl_->thread.join();
+}
+
+} // namespace neuro
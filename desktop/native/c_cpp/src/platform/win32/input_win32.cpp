@@ -0,0 +1,270 @@
+// SendInput backend. Every send() is a single SendInput call; mouse
+// moves are absolute over the virtual desktop so multi-monitor layouts
+// with negative origins work. Characters off the layout go out as
+// KEYEVENTF_UNICODE (VK_PACKET) events.
+
+#include "input.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace neuro {
+
+struct NamedKey {
+    const char* name;
+    WORD        vk;
+};
+
+// pyautogui's KEYBOARD_KEYS names (single characters go through VkKeyScanW).
+static const NamedKey kNamedKeys[] = {
+    {"backspace", VK_BACK}, {"\b", VK_BACK}, {"tab", VK_TAB}, {"\t", VK_TAB},
+    {"enter", VK_RETURN}, {"return", VK_RETURN}, {"\n", VK_RETURN}, {"\r", VK_RETURN},
+    {"shift", VK_SHIFT}, {"shiftleft", VK_LSHIFT}, {"shiftright", VK_RSHIFT},
+    {"ctrl", VK_CONTROL}, {"ctrlleft", VK_LCONTROL}, {"ctrlright", VK_RCONTROL},
+    {"alt", VK_MENU}, {"altleft", VK_LMENU}, {"altright", VK_RMENU},
+    {"win", VK_LWIN}, {"winleft", VK_LWIN}, {"winright", VK_RWIN}, {"apps", VK_APPS},
+    {"pause", VK_PAUSE}, {"capslock", VK_CAPITAL}, {"numlock", VK_NUMLOCK}, {"scrolllock", VK_SCROLL},
+    {"esc", VK_ESCAPE}, {"escape", VK_ESCAPE}, {"space", VK_SPACE}, {" ", VK_SPACE},
+    {"pageup", VK_PRIOR}, {"pgup", VK_PRIOR}, {"pagedown", VK_NEXT}, {"pgdn", VK_NEXT},
+    {"end", VK_END}, {"home", VK_HOME},
+    {"left", VK_LEFT}, {"up", VK_UP}, {"right", VK_RIGHT}, {"down", VK_DOWN},
+    {"select", VK_SELECT}, {"print", VK_PRINT}, {"execute", VK_EXECUTE},
+    {"printscreen", VK_SNAPSHOT}, {"prtsc", VK_SNAPSHOT}, {"prtscr", VK_SNAPSHOT}, {"prntscrn", VK_SNAPSHOT},
+    {"insert", VK_INSERT}, {"delete", VK_DELETE}, {"del", VK_DELETE}, {"help", VK_HELP}, {"sleep", VK_SLEEP},
+    {"multiply", VK_MULTIPLY}, {"add", VK_ADD}, {"separator", VK_SEPARATOR},
+    {"subtract", VK_SUBTRACT}, {"decimal", VK_DECIMAL}, {"divide", VK_DIVIDE},
+    {"volumemute", VK_VOLUME_MUTE}, {"volumedown", VK_VOLUME_DOWN}, {"volumeup", VK_VOLUME_UP},
+    {"nexttrack", VK_MEDIA_NEXT_TRACK}, {"prevtrack", VK_MEDIA_PREV_TRACK},
+    {"stop", VK_MEDIA_STOP}, {"playpause", VK_MEDIA_PLAY_PAUSE},
+    {"browserback", VK_BROWSER_BACK}, {"browserforward", VK_BROWSER_FORWARD},
+    {"browserrefresh", VK_BROWSER_REFRESH}, {"browserhome", VK_BROWSER_HOME},
+};
+
+// Keys that need KEYEVENTF_EXTENDEDKEY to reach apps reading scan codes.
+static bool is_extended(WORD vk) {
+    switch (vk) {
+        case VK_INSERT: case VK_DELETE: case VK_HOME: case VK_END:
+        case VK_PRIOR: case VK_NEXT: case VK_LEFT: case VK_UP: case VK_RIGHT: case VK_DOWN:
+        case VK_RCONTROL: case VK_RMENU: case VK_LWIN: case VK_RWIN: case VK_APPS:
+        case VK_DIVIDE: case VK_NUMLOCK: case VK_SNAPSHOT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+struct PlatformInput::Impl {
+    std::unordered_map<std::string, WORD> keys;
+    std::vector<INPUT>                    inputs;
+};
+
+PlatformInput::PlatformInput() = default;
+PlatformInput::~PlatformInput() = default;
+
+Status PlatformInput::open() {
+    // Same as pyautogui: physical pixels, whatever the display scaling.
+    SetProcessDPIAware();
+
+    auto impl = std::make_unique<Impl>();
+    for (const NamedKey& key : kNamedKeys) {
+        impl->keys.emplace(key.name, key.vk);
+    }
+    for (int i = 0; i < 10; ++i) {
+        impl->keys.emplace("num" + std::to_string(i), static_cast<WORD>(VK_NUMPAD0 + i));
+    }
+    for (int i = 1; i <= 24; ++i) {
+        impl->keys.emplace("f" + std::to_string(i), static_cast<WORD>(VK_F1 + i - 1));
+    }
+
+    impl_ = std::move(impl);
+    return Status::Ok;
+}
+
+Status PlatformInput::screen_size(int32_t& width, int32_t& height) {
+    width  = GetSystemMetrics(SM_CXSCREEN);
+    height = GetSystemMetrics(SM_CYSCREEN);
+    return Status::Ok;
+}
+
+Status PlatformInput::cursor(int32_t& x, int32_t& y) {
+    POINT point;
+    if (!GetCursorPos(&point)) {
+        return Status::Failed;
+    }
+    x = point.x;
+    y = point.y;
+    return Status::Ok;
+}
+
+bool PlatformInput::resolve_key(std::string_view name, KeyStroke& out) {
+    auto it = impl_->keys.find(std::string(name));
+    if (it == impl_->keys.end()) {
+        return false;
+    }
+    out.code  = it->second;
+    out.shift = false;
+    return true;
+}
+
+bool PlatformInput::resolve_char(uint32_t codepoint, KeyStroke& out) {
+    if (codepoint >= 0x10000) {
+        return false;
+    }
+
+    SHORT scan = VkKeyScanW(static_cast<WCHAR>(codepoint));
+    // -1: not on the layout; ctrl/alt combinations are better sent as Unicode.
+    if (scan == -1 || (HIBYTE(scan) & ~1)) {
+        return false;
+    }
+    out.code  = LOBYTE(scan);
+    out.shift = (HIBYTE(scan) & 1) != 0;
+    return true;
+}
+
+bool PlatformInput::supports_unicode() const {
+    return true;
+}
+
+Status PlatformInput::set_clipboard(std::string_view utf8) {
+    if (utf8.size() > static_cast<size_t>(INT_MAX)) {
+        return Status::Unavailable;
+    }
+    int units = utf8.empty() ? 0 : MultiByteToWideChar(CP_UTF8, 0, utf8.data(), static_cast<int>(utf8.size()),
+                                                         nullptr, 0);
+    if (!utf8.empty() && units == 0) {
+        return Status::Failed;
+    }
+
+    HGLOBAL memory = GlobalAlloc(GMEM_MOVEABLE, (static_cast<size_t>(units) + 1) * sizeof(WCHAR));
+    if (!memory) {
+        return Status::Failed;
+    }
+    auto* text = static_cast<WCHAR*>(GlobalLock(memory));
+    if (units) {
+        MultiByteToWideChar(CP_UTF8, 0, utf8.data(), static_cast<int>(utf8.size()), text, units);
+    }
+    text[units] = 0;
+    GlobalUnlock(memory);
+
+    // SetClipboardData needs an owner window; a throwaway message-only
+    // one does, the data outlives it.
+    HWND owner = CreateWindowExW(0, L"STATIC", L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, nullptr, nullptr);
+
+    // Another process may have the clipboard open for a moment.
+    bool opened = false;
+    for (int attempt = 0; attempt < 10 && !(opened = OpenClipboard(owner) != 0); ++attempt) {
+        Sleep(5);
+    }
+    bool set = false;
+    if (opened) {
+        EmptyClipboard();
+        set = SetClipboardData(CF_UNICODETEXT, memory) != nullptr;
+        CloseClipboard();
+    }
+    if (owner) {
+        DestroyWindow(owner);
+    }
+    if (!set) {
+        GlobalFree(memory); // still ours unless SetClipboardData took it
+        return opened ? Status::Failed : Status::Busy;
+    }
+    return Status::Ok;
+}
+
+Status PlatformInput::send(const InputEvent* events, size_t count) {
+    if (count == 0) {
+        return Status::Ok;
+    }
+
+    std::vector<INPUT>& inputs = impl_->inputs;
+    inputs.clear();
+    inputs.reserve(count);
+
+    int32_t vx = GetSystemMetrics(SM_XVIRTUALSCREEN);
+    int32_t vy = GetSystemMetrics(SM_YVIRTUALSCREEN);
+    int64_t vw = std::max(1, GetSystemMetrics(SM_CXVIRTUALSCREEN));
+    int64_t vh = std::max(1, GetSystemMetrics(SM_CYVIRTUALSCREEN));
+
+    for (size_t i = 0; i < count; ++i) {
+        const InputEvent& event = events[i];
+        INPUT input{};
+
+        switch (event.kind) {
+            case InputEvent::Kind::Key:
+                input.type       = INPUT_KEYBOARD;
+                input.ki.wVk     = static_cast<WORD>(event.code);
+                input.ki.dwFlags = (event.down ? 0 : KEYEVENTF_KEYUP)
+                                 | (is_extended(input.ki.wVk) ? KEYEVENTF_EXTENDEDKEY : 0);
+                break;
+
+            case InputEvent::Kind::Unicode: {
+                // One event per UTF-16 unit: a surrogate pair is two.
+                uint32_t cp = event.code;
+                WORD units[2] = {static_cast<WORD>(cp), 0};
+                int n = 1;
+                if (cp >= 0x10000) {
+                    cp -= 0x10000;
+                    units[0] = static_cast<WORD>(0xD800 + (cp >> 10));
+                    units[1] = static_cast<WORD>(0xDC00 + (cp & 0x3FF));
+                    n = 2;
+                }
+                input.type       = INPUT_KEYBOARD;
+                input.ki.dwFlags = KEYEVENTF_UNICODE | (event.down ? 0 : KEYEVENTF_KEYUP);
+                for (int k = 0; k < n; ++k) {
+                    input.ki.wScan = units[k];
+                    inputs.push_back(input);
+                }
+                continue;
+            }
+
+            case InputEvent::Kind::Move:
+                // Round up so the normalized coordinate maps back onto the
+                // requested pixel rather than the one before it.
+                input.type       = INPUT_MOUSE;
+                input.mi.dx      = static_cast<LONG>(((event.x - vx) * 65536 + vw - 1) / vw);
+                input.mi.dy      = static_cast<LONG>(((event.y - vy) * 65536 + vh - 1) / vh);
+                input.mi.dwFlags = MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE | MOUSEEVENTF_VIRTUALDESK;
+                break;
+
+            case InputEvent::Kind::Button:
+                input.type = INPUT_MOUSE;
+                switch (event.code) {
+                    case NN_BUTTON_LEFT:
+                        input.mi.dwFlags = event.down ? MOUSEEVENTF_LEFTDOWN : MOUSEEVENTF_LEFTUP;
+                        break;
+                    case NN_BUTTON_MIDDLE:
+                        input.mi.dwFlags = event.down ? MOUSEEVENTF_MIDDLEDOWN : MOUSEEVENTF_MIDDLEUP;
+                        break;
+                    default:
+                        input.mi.dwFlags = event.down ? MOUSEEVENTF_RIGHTDOWN : MOUSEEVENTF_RIGHTUP;
+                        break;
+                }
+                break;
+
+            case InputEvent::Kind::Wheel:
+                input.type         = INPUT_MOUSE;
+                input.mi.mouseData = static_cast<DWORD>(event.y);
+                input.mi.dwFlags   = MOUSEEVENTF_WHEEL;
+                break;
+
+            case InputEvent::Kind::Paste:
+                continue; // carried out by the injector
+        }
+        inputs.push_back(input);
+    }
+    if (inputs.empty()) {
+        return Status::Ok;
+    }
+
+    // Fewer inserted than asked: blocked by UIPI or the secure desktop.
+    UINT sent = SendInput(static_cast<UINT>(inputs.size()), inputs.data(), sizeof(INPUT));
+    return sent == inputs.size() ? Status::Ok : Status::Failed;
+}
+
+} // namespace neuro
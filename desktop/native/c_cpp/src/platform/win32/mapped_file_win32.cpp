@@ -0,0 +1,85 @@
+// File-mapping backend. Files are shared for delete, so a reader's view
+// of a segment doesn't stop the writer from rotating it.
+
+#include "history.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace neuro {
+
+struct MappedFile::Impl {
+    uint8_t* data = nullptr;
+    size_t   size = 0;
+};
+
+MappedFile::MappedFile() : impl_(new Impl) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+Status MappedFile::open(const char* path, size_t size, bool writable) {
+    close();
+
+    HANDLE file = CreateFileA(path, writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return Status::Failed;
+    }
+
+    if (!writable) {
+        LARGE_INTEGER length;
+        if (!GetFileSizeEx(file, &length) || length.QuadPart <= 0) {
+            CloseHandle(file);
+            return Status::Failed;
+        }
+        size = static_cast<size_t>(length.QuadPart);
+    }
+
+    // A writable mapping of `size` grows the file to it.
+    uint64_t length  = size;
+    HANDLE   mapping = CreateFileMappingW(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                          static_cast<DWORD>(length >> 32), static_cast<DWORD>(length),
+                                          nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return Status::Failed;
+    }
+
+    void* data = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+    CloseHandle(mapping); // the view keeps the mapping
+    if (!data) {
+        return Status::Failed;
+    }
+
+    impl_->data = static_cast<uint8_t*>(data);
+    impl_->size = size;
+    return Status::Ok;
+}
+
+void MappedFile::close() {
+    if (impl_->data) {
+        UnmapViewOfFile(impl_->data);
+        impl_->data = nullptr;
+        impl_->size = 0;
+    }
+}
+
+Status MappedFile::flush() {
+    if (!impl_->data) {
+        return Status::Unavailable;
+    }
+    return FlushViewOfFile(impl_->data, 0) ? Status::Ok : Status::Failed;
+}
+
+uint8_t* MappedFile::data() const {
+    return impl_->data;
+}
+
+size_t MappedFile::size() const {
+    return impl_->size;
+}
+
+} // namespace neuro
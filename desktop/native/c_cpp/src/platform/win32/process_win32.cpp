@@ -0,0 +1,119 @@
+// NtQuerySystemInformation(SystemProcessInformation) backend. One call
+// returns every process with its pid, creation time and image name, so
+// each refresh is a full scan that only converts the names of processes
+// the tracker hasn't seen. The buffer is kept between refreshes and
+// grown when the kernel says it is too small.
+
+#include "process_tracker.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace neuro {
+
+// winternl.h only declares a truncated version of this struct.
+struct SystemProcessEntry {
+    ULONG         NextEntryOffset;
+    ULONG         NumberOfThreads;
+    LARGE_INTEGER WorkingSetPrivateSize;
+    ULONG         HardFaultCount;
+    ULONG         NumberOfThreadsHighWatermark;
+    ULONGLONG     CycleTime;
+    LARGE_INTEGER CreateTime;
+    LARGE_INTEGER UserTime;
+    LARGE_INTEGER KernelTime;
+    USHORT        ImageNameLength;        // UNICODE_STRING, in bytes
+    USHORT        ImageNameMaximumLength;
+    PWSTR         ImageNameBuffer;
+    LONG          BasePriority;
+    HANDLE        UniqueProcessId;
+    // ... more fields and the thread array, unused
+};
+
+using NtQuerySystemInformationFn = LONG(NTAPI*)(ULONG, PVOID, ULONG, PULONG);
+
+constexpr ULONG kSystemProcessInformation = 5;
+constexpr LONG  kStatusInfoLengthMismatch = static_cast<LONG>(0xC0000004L);
+constexpr ULONG kInitialBuffer            = 256 * 1024;
+
+static std::string utf8_of(const wchar_t* text, int length) {
+    int bytes = WideCharToMultiByte(CP_UTF8, 0, text, length, nullptr, 0, nullptr, nullptr);
+    std::string out(static_cast<size_t>(bytes > 0 ? bytes : 0), '\0');
+    if (bytes > 0) {
+        WideCharToMultiByte(CP_UTF8, 0, text, length, out.data(), bytes, nullptr, nullptr);
+    }
+    return out;
+}
+
+struct PlatformProcessSource::Impl {
+    NtQuerySystemInformationFn query = nullptr;
+    std::vector<unsigned char> buffer;
+
+    Impl() {
+        if (HMODULE ntdll = GetModuleHandleW(L"ntdll.dll")) {
+            query = reinterpret_cast<NtQuerySystemInformationFn>(
+                GetProcAddress(ntdll, "NtQuerySystemInformation"));
+        }
+    }
+
+    bool snapshot() {
+        if (buffer.empty()) {
+            buffer.resize(kInitialBuffer);
+        }
+        for (;;) {
+            ULONG needed = 0;
+            LONG  status = query(kSystemProcessInformation, buffer.data(),
+                                 static_cast<ULONG>(buffer.size()), &needed);
+            if (status == kStatusInfoLengthMismatch) {
+                // Processes can start between the two calls: leave room.
+                buffer.resize((std::max<size_t>)(needed, buffer.size()) + 64 * 1024);
+                continue;
+            }
+            return status >= 0;
+        }
+    }
+};
+
+PlatformProcessSource::PlatformProcessSource() : impl_(std::make_unique<Impl>()) {}
+PlatformProcessSource::~PlatformProcessSource() = default;
+
+Status PlatformProcessSource::refresh(ProcessTracker& sink, bool& full) {
+    Impl& impl = *impl_;
+    if (!impl.query) {
+        return Status::Unavailable;
+    }
+    if (!impl.snapshot()) {
+        return Status::Failed;
+    }
+
+    const unsigned char* cursor = impl.buffer.data();
+    for (;;) {
+        const auto* entry = reinterpret_cast<const SystemProcessEntry*>(cursor);
+        auto pid   = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(entry->UniqueProcessId));
+        auto start = static_cast<uint64_t>(entry->CreateTime.QuadPart);
+
+        if (!sink.keep(pid, start)) {
+            if (entry->ImageNameBuffer && entry->ImageNameLength) {
+                sink.add(pid, start, utf8_of(entry->ImageNameBuffer,
+                                             static_cast<int>(entry->ImageNameLength / sizeof(wchar_t))));
+            } else {
+                // The idle process has no image.
+                sink.add(pid, start, pid == 0 ? "System Idle Process" : "");
+            }
+        }
+
+        if (!entry->NextEntryOffset) {
+            break;
+        }
+        cursor += entry->NextEntryOffset;
+    }
+
+    full = true;
+    return Status::Ok;
+}
+
+} // namespace neuro
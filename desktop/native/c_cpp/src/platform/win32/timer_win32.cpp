@@ -0,0 +1,64 @@
+// Waitable-timer backend. Windows 10 1803+ has high-resolution timers
+// that wake within ~0.5 ms without touching the global timer period;
+// older systems get a plain timer plus timeBeginPeriod(1) while the
+// thread's timer lives.
+
+#include "scheduler.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <timeapi.h>
+
+#include "clock.hpp"
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace neuro {
+
+struct PlatformTimer::Impl {
+    HANDLE timer    = nullptr;
+    bool   high_res = false;
+};
+
+PlatformTimer::PlatformTimer() : impl_(new Impl) {
+    impl_->timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                          TIMER_ALL_ACCESS);
+    impl_->high_res = impl_->timer != nullptr;
+    if (!impl_->high_res) {
+        timeBeginPeriod(1);
+        impl_->timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+    }
+}
+
+PlatformTimer::~PlatformTimer() {
+    if (impl_->timer) {
+        CloseHandle(impl_->timer);
+    }
+    if (!impl_->high_res) {
+        timeEndPeriod(1);
+    }
+}
+
+void PlatformTimer::sleep_until(uint64_t deadline_ns) {
+    uint64_t now = monotonic_ns();
+    if (deadline_ns <= now) {
+        return;
+    }
+
+    // Relative due time in 100 ns units: absolute ones are wall-clock.
+    LARGE_INTEGER due;
+    due.QuadPart = -static_cast<LONGLONG>((deadline_ns - now) / 100);
+    if (!impl_->timer || !SetWaitableTimer(impl_->timer, &due, 0, nullptr, nullptr, FALSE)) {
+        Sleep(static_cast<DWORD>((deadline_ns - now) / 1'000'000));
+        return;
+    }
+    WaitForSingleObject(impl_->timer, INFINITE);
+}
+
+uint64_t PlatformTimer::slack_ns() const {
+    return impl_->high_res ? 1'000'000 : 2'000'000;
+}
+
+} // namespace neuro
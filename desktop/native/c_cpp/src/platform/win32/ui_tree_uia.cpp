@@ -0,0 +1,576 @@
+// UI Automation backend. The watch thread is a COM MTA client: it polls
+// the foreground window, walks it with a cache request (every property
+// the tree needs comes back with the element, so a walk costs one
+// cross-process call per element with children instead of one per
+// property) and registers structure-changed and property-changed
+// handlers on it, plus the global focus handler. UIA calls the handlers
+// on its own threads; they only queue the sender and wake the watch
+// thread, which folds everything queued into one batch and commits once.
+
+#include "ui_tree.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <uiautomation.h>
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+namespace neuro {
+
+namespace {
+
+constexpr DWORD  kPollMs      = 250; // foreground window check
+constexpr UINT   kWakeMessage = WM_APP + 1;
+constexpr size_t kMaxQueued   = 1024; // past this a batch re-walks the window
+constexpr int    kMaxClimb    = 8;    // ancestors tried for an unknown event sender
+
+const PROPERTYID kCachedProperties[] = {
+    UIA_RuntimeIdPropertyId,         UIA_NamePropertyId,
+    UIA_ControlTypePropertyId,       UIA_BoundingRectanglePropertyId,
+    UIA_IsEnabledPropertyId,         UIA_HasKeyboardFocusPropertyId,
+    UIA_IsOffscreenPropertyId,       UIA_IsPasswordPropertyId,
+    UIA_ValueValuePropertyId,        UIA_ToggleToggleStatePropertyId,
+    UIA_ExpandCollapseExpandCollapseStatePropertyId, UIA_SelectionItemIsSelectedPropertyId,
+};
+
+// Changes that only touch the element itself; bounds are refreshed by
+// the next re-walk instead (they change on every scroll and resize).
+PROPERTYID kWatchedProperties[] = {
+    UIA_NamePropertyId,       UIA_IsEnabledPropertyId,         UIA_IsOffscreenPropertyId,
+    UIA_ValueValuePropertyId, UIA_ToggleToggleStatePropertyId, UIA_ExpandCollapseExpandCollapseStatePropertyId,
+    UIA_SelectionItemIsSelectedPropertyId,
+};
+
+uint64_t id_of(HWND hwnd) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(hwnd));
+}
+
+uint32_t role_of(CONTROLTYPEID type) {
+    switch (type) {
+        case UIA_WindowControlTypeId:      return NN_UI_ROLE_WINDOW;
+        case UIA_PaneControlTypeId:        return NN_UI_ROLE_PANE;
+        case UIA_GroupControlTypeId:       return NN_UI_ROLE_GROUP;
+        case UIA_ButtonControlTypeId:
+        case UIA_SplitButtonControlTypeId: return NN_UI_ROLE_BUTTON;
+        case UIA_CheckBoxControlTypeId:    return NN_UI_ROLE_CHECKBOX;
+        case UIA_RadioButtonControlTypeId: return NN_UI_ROLE_RADIO;
+        case UIA_ComboBoxControlTypeId:    return NN_UI_ROLE_COMBOBOX;
+        case UIA_EditControlTypeId:        return NN_UI_ROLE_EDIT;
+        case UIA_TextControlTypeId:        return NN_UI_ROLE_TEXT;
+        case UIA_HyperlinkControlTypeId:   return NN_UI_ROLE_LINK;
+        case UIA_ImageControlTypeId:       return NN_UI_ROLE_IMAGE;
+        case UIA_ListControlTypeId:        return NN_UI_ROLE_LIST;
+        case UIA_ListItemControlTypeId:    return NN_UI_ROLE_LIST_ITEM;
+        case UIA_MenuControlTypeId:        return NN_UI_ROLE_MENU;
+        case UIA_MenuBarControlTypeId:     return NN_UI_ROLE_MENU_BAR;
+        case UIA_MenuItemControlTypeId:    return NN_UI_ROLE_MENU_ITEM;
+        case UIA_TabControlTypeId:         return NN_UI_ROLE_TAB;
+        case UIA_TabItemControlTypeId:     return NN_UI_ROLE_TAB_ITEM;
+        case UIA_TreeControlTypeId:        return NN_UI_ROLE_TREE;
+        case UIA_TreeItemControlTypeId:    return NN_UI_ROLE_TREE_ITEM;
+        case UIA_TableControlTypeId:
+        case UIA_DataGridControlTypeId:    return NN_UI_ROLE_TABLE;
+        case UIA_DataItemControlTypeId:    return NN_UI_ROLE_ROW;
+        case UIA_HeaderControlTypeId:
+        case UIA_HeaderItemControlTypeId:  return NN_UI_ROLE_HEADER;
+        case UIA_ToolBarControlTypeId:     return NN_UI_ROLE_TOOLBAR;
+        case UIA_StatusBarControlTypeId:   return NN_UI_ROLE_STATUS_BAR;
+        case UIA_ScrollBarControlTypeId:   return NN_UI_ROLE_SCROLL_BAR;
+        case UIA_SliderControlTypeId:      return NN_UI_ROLE_SLIDER;
+        case UIA_SpinnerControlTypeId:     return NN_UI_ROLE_SPINNER;
+        case UIA_ProgressBarControlTypeId: return NN_UI_ROLE_PROGRESS;
+        case UIA_DocumentControlTypeId:    return NN_UI_ROLE_DOCUMENT;
+        case UIA_SeparatorControlTypeId:   return NN_UI_ROLE_SEPARATOR;
+        case UIA_ToolTipControlTypeId:     return NN_UI_ROLE_TOOLTIP;
+        case UIA_TitleBarControlTypeId:    return NN_UI_ROLE_TITLE_BAR;
+        default:                           return NN_UI_ROLE_UNKNOWN;
+    }
+}
+
+std::string utf8(const wchar_t* text, UINT length) {
+    int bytes = WideCharToMultiByte(CP_UTF8, 0, text, static_cast<int>(length), nullptr, 0, nullptr, nullptr);
+    std::string out(static_cast<size_t>(bytes > 0 ? bytes : 0), '\0');
+    if (bytes > 0) {
+        WideCharToMultiByte(CP_UTF8, 0, text, static_cast<int>(length), out.data(), bytes, nullptr, nullptr);
+    }
+    return out;
+}
+
+// Unsupported patterns come back as the reserved "not supported"
+// VT_UNKNOWN value, which the type checks below turn into the fallback.
+int32_t cached_int(IUIAutomationElement* element, PROPERTYID id, int32_t fallback) {
+    VARIANT value;
+    VariantInit(&value);
+    int32_t result = fallback;
+    if (SUCCEEDED(element->GetCachedPropertyValue(id, &value)) && value.vt == VT_I4) {
+        result = value.lVal;
+    }
+    VariantClear(&value);
+    return result;
+}
+
+bool cached_bool(IUIAutomationElement* element, PROPERTYID id) {
+    VARIANT value;
+    VariantInit(&value);
+    bool result = SUCCEEDED(element->GetCachedPropertyValue(id, &value)) && value.vt == VT_BOOL
+                  && value.boolVal == VARIANT_TRUE;
+    VariantClear(&value);
+    return result;
+}
+
+std::string cached_string(IUIAutomationElement* element, PROPERTYID id) {
+    VARIANT value;
+    VariantInit(&value);
+    std::string result;
+    if (SUCCEEDED(element->GetCachedPropertyValue(id, &value)) && value.vt == VT_BSTR && value.bstrVal) {
+        result = utf8(value.bstrVal, SysStringLen(value.bstrVal));
+    }
+    VariantClear(&value);
+    return result;
+}
+
+// FNV-1a of the runtime id, which UIA keeps for the element's lifetime.
+uint64_t key_of(IUIAutomationElement* element) {
+    VARIANT value;
+    VariantInit(&value);
+    uint64_t hash = 0;
+    if (SUCCEEDED(element->GetCachedPropertyValue(UIA_RuntimeIdPropertyId, &value))
+        && value.vt == (VT_ARRAY | VT_I4) && value.parray) {
+        LONG  lower = 0, upper = -1;
+        void* data  = nullptr;
+        SafeArrayGetLBound(value.parray, 1, &lower);
+        SafeArrayGetUBound(value.parray, 1, &upper);
+        if (upper >= lower && SUCCEEDED(SafeArrayAccessData(value.parray, &data))) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            size_t      size  = static_cast<size_t>(upper - lower + 1) * sizeof(int32_t);
+            hash = 14695981039346656037ull;
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            SafeArrayUnaccessData(value.parray);
+        }
+    }
+    VariantClear(&value);
+    return hash;
+}
+
+UiNode node_of(IUIAutomationElement* element, uint64_t parent) {
+    UiNode node;
+    node.id     = key_of(element);
+    node.parent = parent;
+
+    CONTROLTYPEID type = 0;
+    element->get_CachedControlType(&type);
+    node.role = role_of(type);
+
+    BSTR name = nullptr;
+    if (SUCCEEDED(element->get_CachedName(&name)) && name) {
+        node.name = utf8(name, SysStringLen(name));
+        SysFreeString(name);
+    }
+
+    RECT rect = {};
+    if (SUCCEEDED(element->get_CachedBoundingRectangle(&rect))) {
+        node.bounds = Rect{rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top};
+    }
+
+    BOOL flag = FALSE;
+    if (SUCCEEDED(element->get_CachedIsEnabled(&flag)) && !flag) {
+        node.states |= NN_UI_STATE_DISABLED;
+    }
+    if (SUCCEEDED(element->get_CachedHasKeyboardFocus(&flag)) && flag) {
+        node.states |= NN_UI_STATE_FOCUSED;
+    }
+    if (SUCCEEDED(element->get_CachedIsOffscreen(&flag)) && flag) {
+        node.states |= NN_UI_STATE_OFFSCREEN;
+    }
+    if (SUCCEEDED(element->get_CachedIsPassword(&flag)) && flag) {
+        node.states |= NN_UI_STATE_PROTECTED;
+    } else {
+        node.value = cached_string(element, UIA_ValueValuePropertyId);
+    }
+
+    if (cached_int(element, UIA_ToggleToggleStatePropertyId, -1) == ToggleState_On) {
+        node.states |= NN_UI_STATE_CHECKED;
+    }
+    switch (cached_int(element, UIA_ExpandCollapseExpandCollapseStatePropertyId, -1)) {
+        case ExpandCollapseState_Expanded:
+        case ExpandCollapseState_PartiallyExpanded:
+            node.states |= NN_UI_STATE_EXPANDED;
+            break;
+        case ExpandCollapseState_Collapsed:
+            node.states |= NN_UI_STATE_COLLAPSED;
+            break;
+        default:
+            break;
+    }
+    if (cached_bool(element, UIA_SelectionItemIsSelectedPropertyId)) {
+        node.states |= NN_UI_STATE_SELECTED;
+    }
+    return node;
+}
+
+// One object for every event kind; it only queues.
+class EventHandler final : public IUIAutomationFocusChangedEventHandler,
+                           public IUIAutomationStructureChangedEventHandler,
+                           public IUIAutomationPropertyChangedEventHandler {
+public:
+    enum class Kind { Focus, Structure, Property };
+
+    struct Event {
+        Kind                         kind;
+        ComPtr<IUIAutomationElement> element;
+    };
+
+    explicit EventHandler(DWORD thread) : thread_(thread) {}
+
+    ULONG STDMETHODCALLTYPE AddRef() override { return refs_.fetch_add(1) + 1; }
+
+    ULONG STDMETHODCALLTYPE Release() override {
+        ULONG refs = refs_.fetch_sub(1) - 1;
+        if (refs == 0) {
+            delete this;
+        }
+        return refs;
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** out) override {
+        if (!out) {
+            return E_POINTER;
+        }
+        if (riid == __uuidof(IUnknown) || riid == __uuidof(IUIAutomationFocusChangedEventHandler)) {
+            *out = static_cast<IUIAutomationFocusChangedEventHandler*>(this);
+        } else if (riid == __uuidof(IUIAutomationStructureChangedEventHandler)) {
+            *out = static_cast<IUIAutomationStructureChangedEventHandler*>(this);
+        } else if (riid == __uuidof(IUIAutomationPropertyChangedEventHandler)) {
+            *out = static_cast<IUIAutomationPropertyChangedEventHandler*>(this);
+        } else {
+            *out = nullptr;
+            return E_NOINTERFACE;
+        }
+        AddRef();
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE HandleFocusChangedEvent(IUIAutomationElement* sender) override {
+        push(Kind::Focus, sender);
+        return S_OK;
+    }
+
+    // For a removed child the sender is its former parent, so the
+    // element to re-walk is the sender in every case.
+    HRESULT STDMETHODCALLTYPE HandleStructureChangedEvent(IUIAutomationElement* sender, StructureChangeType,
+                                                          SAFEARRAY*) override {
+        push(Kind::Structure, sender);
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE HandlePropertyChangedEvent(IUIAutomationElement* sender, PROPERTYID,
+                                                         VARIANT) override {
+        push(Kind::Property, sender);
+        return S_OK;
+    }
+
+    // Everything queued since the last call; `overflow` when some of it
+    // was dropped.
+    std::vector<Event> take(bool& overflow) {
+        std::vector<Event> events;
+        std::lock_guard<std::mutex> guard(mutex_);
+        events.swap(queue_);
+        overflow  = overflow_;
+        overflow_ = false;
+        return events;
+    }
+
+private:
+    ~EventHandler() = default;
+
+    void push(Kind kind, IUIAutomationElement* sender) {
+        if (!sender) {
+            return;
+        }
+        bool wake;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            wake = queue_.empty() && !overflow_;
+            if (queue_.size() < kMaxQueued) {
+                queue_.push_back(Event{kind, sender});
+            } else {
+                overflow_ = true;
+            }
+        }
+        if (wake) {
+            PostThreadMessageW(thread_, kWakeMessage, 0, 0);
+        }
+    }
+
+    std::atomic<ULONG> refs_{1};
+    const DWORD        thread_;
+    std::mutex         mutex_;
+    std::vector<Event> queue_;
+    bool               overflow_ = false;
+};
+
+} // namespace
+
+struct PlatformUiWatch::Impl {
+    std::thread        thread;
+    std::atomic<DWORD> thread_id{0};
+
+    // Watch-thread state
+    ComPtr<IUIAutomation>             automation;
+    ComPtr<IUIAutomationCacheRequest> cache;
+    ComPtr<IUIAutomationCondition>    control_view;
+    ComPtr<IUIAutomationTreeWalker>   walker;
+    EventHandler*                     handler = nullptr;
+    HWND                              hwnd    = nullptr;
+    ComPtr<IUIAutomationElement>      root;
+
+    Status setup() {
+        HRESULT hr = CoCreateInstance(__uuidof(CUIAutomation), nullptr, CLSCTX_INPROC_SERVER,
+                                      __uuidof(IUIAutomation), reinterpret_cast<void**>(automation.GetAddressOf()));
+        if (FAILED(hr) || FAILED(automation->CreateCacheRequest(&cache))
+            || FAILED(automation->get_ControlViewCondition(&control_view))
+            || FAILED(automation->get_ControlViewWalker(&walker))) {
+            return Status::Unavailable;
+        }
+        for (PROPERTYID id : kCachedProperties) {
+            cache->AddProperty(id);
+        }
+
+        handler = new EventHandler(thread_id.load(std::memory_order_relaxed));
+        if (FAILED(automation->AddFocusChangedEventHandler(cache.Get(), handler))) {
+            return Status::Failed;
+        }
+        return Status::Ok;
+    }
+
+    void teardown() {
+        if (automation) {
+            automation->RemoveAllEventHandlers();
+        }
+        root.Reset();
+        walker.Reset();
+        control_view.Reset();
+        cache.Reset();
+        automation.Reset();
+        if (handler) {
+            handler->Release();
+            handler = nullptr;
+        }
+    }
+
+    // Pre-order walk of `from` (whose parent is `parent`) into `out`,
+    // one FindAllBuildCache per element, bounded by kMaxNodes elements
+    // and kMaxDepth levels below `from`.
+    void walk(IUIAutomationElement* from, uint64_t parent, std::vector<UiNode>& out, uint64_t& focus) {
+        struct Pending {
+            ComPtr<IUIAutomationElement> element;
+            uint64_t                     parent;
+            uint32_t                     depth;
+        };
+        std::vector<Pending> pending;
+        pending.push_back(Pending{from, parent, 0});
+
+        while (!pending.empty() && out.size() < UiTree::kMaxNodes) {
+            Pending item = std::move(pending.back());
+            pending.pop_back();
+
+            UiNode node = node_of(item.element.Get(), item.parent);
+            if (node.id == 0) {
+                continue;
+            }
+            if (node.states & NN_UI_STATE_FOCUSED) {
+                focus = node.id;
+            }
+            uint64_t id = node.id;
+            out.push_back(std::move(node));
+            if (item.depth >= UiTree::kMaxDepth) {
+                continue;
+            }
+
+            ComPtr<IUIAutomationElementArray> children;
+            if (FAILED(item.element->FindAllBuildCache(TreeScope_Children, control_view.Get(), cache.Get(),
+                                                       &children))
+                || !children) {
+                continue;
+            }
+            int length = 0;
+            children->get_Length(&length);
+            for (int i = length - 1; i >= 0; --i) { // reversed onto the stack: popped in order
+                ComPtr<IUIAutomationElement> child;
+                if (SUCCEEDED(children->GetElement(i, &child)) && child) {
+                    pending.push_back(Pending{std::move(child), id, item.depth + 1});
+                }
+            }
+        }
+    }
+
+    // Moves the subtree handlers to the new foreground window and walks
+    // it. Handlers first, so nothing that changes during the walk is
+    // missed; the events it raises only re-walk what is already current.
+    void follow(UiTree& sink, HWND next) {
+        if (root) {
+            automation->RemoveStructureChangedEventHandler(root.Get(), handler);
+            automation->RemovePropertyChangedEventHandler(root.Get(), handler);
+            root.Reset();
+        }
+        hwnd = next;
+
+        std::vector<UiNode> nodes;
+        uint64_t            focus = 0;
+        if (next && SUCCEEDED(automation->ElementFromHandleBuildCache(next, cache.Get(), &root)) && root) {
+            automation->AddStructureChangedEventHandler(root.Get(), TreeScope_Subtree, cache.Get(), handler);
+            automation->AddPropertyChangedEventHandlerNativeArray(
+                root.Get(), TreeScope_Subtree, cache.Get(), handler, kWatchedProperties,
+                static_cast<int>(sizeof(kWatchedProperties) / sizeof(kWatchedProperties[0])));
+            walk(root.Get(), 0, nodes, focus);
+        }
+        sink.reset(id_of(next), std::move(nodes));
+        sink.set_focus(focus);
+    }
+
+    // Re-walks `element`, or the nearest ancestor the tree knows.
+    void rewalk(UiTree& sink, ComPtr<IUIAutomationElement> element, std::unordered_set<uint64_t>& done) {
+        for (int climb = 0; element && climb < kMaxClimb; ++climb) {
+            uint64_t key = key_of(element.Get());
+            if (sink.contains(key)) {
+                if (done.insert(key).second) {
+                    std::vector<UiNode> nodes;
+                    uint64_t            focus = 0;
+                    walk(element.Get(), 0, nodes, focus);
+                    sink.replace(std::move(nodes));
+                }
+                return;
+            }
+            ComPtr<IUIAutomationElement> parent;
+            walker->GetParentElementBuildCache(element.Get(), cache.Get(), &parent);
+            element = std::move(parent);
+        }
+    }
+
+    void drain(UiTree& sink) {
+        bool overflow = false;
+        std::vector<EventHandler::Event> events = handler->take(overflow);
+        if (overflow) {
+            follow(sink, hwnd);
+            return;
+        }
+
+        // Structure first (it may bring in the elements the other events
+        // are about), then properties, then the last focus change.
+        std::unordered_set<uint64_t> done;
+        for (const auto& event : events) {
+            if (event.kind == EventHandler::Kind::Structure) {
+                rewalk(sink, event.element, done);
+            }
+        }
+        ComPtr<IUIAutomationElement> focus;
+        for (const auto& event : events) {
+            if (event.kind == EventHandler::Kind::Property) {
+                uint64_t key = key_of(event.element.Get());
+                if (sink.contains(key) && done.count(key) == 0) {
+                    sink.update(node_of(event.element.Get(), 0));
+                }
+            } else if (event.kind == EventHandler::Kind::Focus) {
+                focus = event.element;
+            }
+        }
+        if (focus) {
+            sink.set_focus(key_of(focus.Get()));
+        }
+    }
+
+    void run(UiTree& sink, HANDLE ready, Status& status) {
+        MSG msg;
+        PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+        thread_id.store(GetCurrentThreadId(), std::memory_order_release);
+
+        if (FAILED(CoInitializeEx(nullptr, COINIT_MULTITHREADED))) {
+            status = Status::Failed;
+            SetEvent(ready);
+            return;
+        }
+        status = setup();
+        if (status != Status::Ok) {
+            teardown();
+            CoUninitialize();
+            SetEvent(ready);
+            return;
+        }
+
+        follow(sink, GetAncestor(GetForegroundWindow(), GA_ROOT));
+        sink.commit();
+        SetEvent(ready);
+
+        for (;;) {
+            MsgWaitForMultipleObjects(0, nullptr, FALSE, kPollMs, QS_ALLINPUT);
+
+            bool quit = false;
+            while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE)) {
+                if (msg.message == WM_QUIT) {
+                    quit = true;
+                    break;
+                }
+                DispatchMessageW(&msg);
+            }
+            if (quit) {
+                break;
+            }
+
+            HWND foreground = GetAncestor(GetForegroundWindow(), GA_ROOT);
+            if (foreground != hwnd) {
+                bool dropped = false;
+                handler->take(dropped); // about the old window
+                follow(sink, foreground);
+            } else {
+                drain(sink);
+            }
+            sink.commit();
+        }
+
+        teardown();
+        CoUninitialize();
+    }
+};
+
+PlatformUiWatch::PlatformUiWatch() : impl_(std::make_unique<Impl>()) {}
+PlatformUiWatch::~PlatformUiWatch() { stop(); }
+
+Status PlatformUiWatch::start(UiTree& sink) {
+    HANDLE ready = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!ready) {
+        return Status::Failed;
+    }
+
+    Status status = Status::Failed;
+    impl_->thread = std::thread([this, &sink, ready, &status] {
+        impl_->run(sink, ready, status);
+    });
+    WaitForSingleObject(ready, INFINITE);
+    CloseHandle(ready);
+
+    if (status != Status::Ok) {
+        impl_->thread.join();
+    }
+    return status;
+}
+
+void PlatformUiWatch::stop() {
+    if (!impl_->thread.joinable()) {
+        return;
+    }
+    PostThreadMessageW(impl_->thread_id.load(std::memory_order_acquire), WM_QUIT, 0, 0);
+    impl_->thread.join();
+}
+
+} // namespace neuro
@@ -0,0 +1,189 @@
+// SetWinEventHook backend. Out-of-context WinEvent hooks are delivered
+// to the installing thread through its message queue, so the watch gets
+// a dedicated thread that pumps messages and commits once per drain.
+// Tracked: visible top-level windows (what EnumWindows + IsWindowVisible
+// returns), renamed, shown/hidden, created/destroyed, and the
+// foreground window.
+
+#include "window_cache.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace neuro {
+
+// WinEvent procs get no user pointer.
+static std::atomic<WindowCache*> g_sink{nullptr};
+
+static uint64_t id_of(HWND hwnd) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(hwnd));
+}
+
+static bool tracked(HWND hwnd) {
+    return IsWindowVisible(hwnd) && GetAncestor(hwnd, GA_ROOT) == hwnd;
+}
+
+static uint32_t pid_of(HWND hwnd) {
+    DWORD pid = 0;
+    GetWindowThreadProcessId(hwnd, &pid);
+    return pid;
+}
+
+static std::string title_of(HWND hwnd) {
+    int length = GetWindowTextLengthW(hwnd);
+    if (length <= 0) {
+        return {};
+    }
+
+    std::wstring wide(static_cast<size_t>(length) + 1, L'\0');
+    length = GetWindowTextW(hwnd, wide.data(), length + 1);
+    int bytes = WideCharToMultiByte(CP_UTF8, 0, wide.data(), length, nullptr, 0, nullptr, nullptr);
+    std::string title(static_cast<size_t>(bytes > 0 ? bytes : 0), '\0');
+    if (bytes > 0) {
+        WideCharToMultiByte(CP_UTF8, 0, wide.data(), length, title.data(), bytes, nullptr, nullptr);
+    }
+    return title;
+}
+
+static void CALLBACK win_event(HWINEVENTHOOK, DWORD event, HWND hwnd, LONG object, LONG child,
+                               DWORD, DWORD) {
+    WindowCache* sink = g_sink.load(std::memory_order_acquire);
+    if (!sink || !hwnd) {
+        return;
+    }
+
+    if (event == EVENT_SYSTEM_FOREGROUND) {
+        sink->set_active(id_of(hwnd));
+        return;
+    }
+    if (object != OBJID_WINDOW || child != CHILDID_SELF) {
+        return;
+    }
+
+    switch (event) {
+        case EVENT_OBJECT_DESTROY:
+        case EVENT_OBJECT_HIDE:
+            sink->remove(id_of(hwnd));
+            break;
+        case EVENT_OBJECT_CREATE:
+        case EVENT_OBJECT_SHOW:
+        case EVENT_OBJECT_NAMECHANGE:
+            if (tracked(hwnd)) {
+                sink->upsert(id_of(hwnd), pid_of(hwnd), title_of(hwnd));
+            } else {
+                sink->remove(id_of(hwnd));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static BOOL CALLBACK enum_window(HWND hwnd, LPARAM user) {
+    if (tracked(hwnd)) {
+        auto* windows = reinterpret_cast<std::vector<WindowInfo>*>(user);
+        windows->push_back(WindowInfo{id_of(hwnd), pid_of(hwnd), title_of(hwnd)});
+    }
+    return TRUE;
+}
+
+struct PlatformWindowWatch::Impl {
+    std::thread        thread;
+    std::atomic<DWORD> thread_id{0};
+
+    void run(WindowCache& sink, HANDLE ready, Status& status) {
+        // Make sure the queue exists before anyone posts WM_QUIT to it.
+        MSG msg;
+        PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+        thread_id.store(GetCurrentThreadId(), std::memory_order_release);
+
+        // Hooks first, so nothing that happens during the enumeration
+        // is missed; the events wait in the queue until the first drain.
+        constexpr DWORD flags = WINEVENT_OUTOFCONTEXT;
+        HWINEVENTHOOK hooks[] = {
+            SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_HIDE, nullptr, win_event, 0, 0, flags),
+            SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE, nullptr, win_event, 0, 0, flags),
+            SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr, win_event, 0, 0, flags),
+        };
+
+        bool hooked = true;
+        for (HWINEVENTHOOK hook : hooks) {
+            hooked = hooked && hook;
+        }
+        if (!hooked) {
+            for (HWINEVENTHOOK hook : hooks) {
+                if (hook) UnhookWinEvent(hook);
+            }
+            status = Status::Failed;
+            SetEvent(ready);
+            return;
+        }
+
+        std::vector<WindowInfo> windows;
+        EnumWindows(enum_window, reinterpret_cast<LPARAM>(&windows));
+        sink.reset(std::move(windows), id_of(GetForegroundWindow()));
+        sink.commit();
+
+        g_sink.store(&sink, std::memory_order_release);
+        status = Status::Ok;
+        SetEvent(ready);
+
+        for (;;) {
+            MsgWaitForMultipleObjects(0, nullptr, FALSE, INFINITE, QS_ALLINPUT);
+
+            bool quit = false;
+            while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE)) {
+                if (msg.message == WM_QUIT) {
+                    quit = true;
+                    break;
+                }
+                DispatchMessageW(&msg);
+            }
+            sink.commit();
+            if (quit) {
+                break;
+            }
+        }
+
+        g_sink.store(nullptr, std::memory_order_release);
+        for (HWINEVENTHOOK hook : hooks) {
+            UnhookWinEvent(hook);
+        }
+    }
+};
+
+PlatformWindowWatch::PlatformWindowWatch() : impl_(std::make_unique<Impl>()) {}
+PlatformWindowWatch::~PlatformWindowWatch() { stop(); }
+
+Status PlatformWindowWatch::start(WindowCache& sink) {
+    HANDLE ready = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!ready) {
+        return Status::Failed;
+    }
+
+    Status status = Status::Failed;
+    impl_->thread = std::thread([this, &sink, ready, &status] {
+        impl_->run(sink, ready, status);
+    });
+    WaitForSingleObject(ready, INFINITE);
+    CloseHandle(ready);
+
+    if (status != Status::Ok) {
+        impl_->thread.join();
+    }
+    return status;
+}
+
+void PlatformWindowWatch::stop() {
+    if (!impl_->thread.joinable()) {
+        return;
+    }
+    PostThreadMessageW(impl_->thread_id.load(std::memory_order_acquire), WM_QUIT, 0, 0);
+    impl_->thread.join();
+}
+
+} // namespace neuro
@@ -0,0 +1,213 @@
+// X11 capture backend: one MIT-SHM segment per ring slot, so XShmGetImage
+// lands directly in the memory handed to callers. Multi-head desktops are
+// one root window; each output (XRandR monitor) is captured as its crop
+// of it, through its own connection.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+
+#if defined(NEURO_HAVE_XRANDR)
+#include <X11/extensions/Xrandr.h>
+#endif
+
+// Xlib's `#define Status int` collides with neuro::Status.
+#undef Status
+
+#include "capture.hpp"
+#include "monitors.hpp"
+
+namespace neuro {
+
+// Primary first, then left to right, indexed in that order.
+static void query_monitors(Display* display, std::vector<Monitor>& out) {
+    out.clear();
+    int screen  = DefaultScreen(display);
+    Window root = RootWindow(display, screen);
+
+#if defined(NEURO_HAVE_XRANDR)
+    // GetMonitors is RandR 1.5; older servers would answer BadRequest.
+    int event_base, error_base, major = 0, minor = 0, count = 0;
+    bool monitors = XRRQueryExtension(display, &event_base, &error_base)
+                 && XRRQueryVersion(display, &major, &minor)
+                 && (major > 1 || (major == 1 && minor >= 5));
+    XRRMonitorInfo* info = monitors ? XRRGetMonitors(display, root, True, &count) : nullptr;
+    for (int i = 0; i < count; ++i) {
+        Monitor monitor;
+        monitor.bounds  = Rect{info[i].x, info[i].y, info[i].width, info[i].height};
+        monitor.primary = info[i].primary != 0;
+        if (char* name = info[i].name ? XGetAtomName(display, info[i].name) : nullptr) {
+            std::strncpy(monitor.name, name, sizeof(monitor.name) - 1);
+            XFree(name);
+        }
+        out.push_back(monitor);
+    }
+    if (info) {
+        XRRFreeMonitors(info);
+    }
+#else
+    (void)root;
+#endif
+
+    // No RandR 1.5: the whole screen is the one output.
+    if (out.empty()) {
+        Monitor monitor;
+        monitor.bounds  = Rect{0, 0, DisplayWidth(display, screen), DisplayHeight(display, screen)};
+        monitor.primary = true;
+        std::strncpy(monitor.name, "screen", sizeof(monitor.name) - 1);
+        out.push_back(monitor);
+    }
+
+    std::stable_sort(out.begin(), out.end(), [](const Monitor& a, const Monitor& b) {
+        if (a.primary != b.primary) {
+            return a.primary;
+        }
+        return a.bounds.x != b.bounds.x ? a.bounds.x < b.bounds.x : a.bounds.y < b.bounds.y;
+    });
+    // With no primary set RandR reports none; the leftmost stands in.
+    out.front().primary = true;
+    for (size_t i = 0; i < out.size(); ++i) {
+        out[i].index = static_cast<int32_t>(i);
+    }
+}
+
+Status enumerate_monitors(std::vector<Monitor>& out) {
+    Display* display = XOpenDisplay(nullptr);
+    if (!display) {
+        return Status::Unavailable;
+    }
+    query_monitors(display, out);
+    XCloseDisplay(display);
+    return Status::Ok;
+}
+
+struct ShmSlot {
+    XImage*         image    = nullptr;
+    XShmSegmentInfo shm{};
+    bool            attached = false;
+};
+
+struct PlatformCapture::Impl {
+    Display* display = nullptr;
+    Window   root    = 0;
+    int32_t  x       = 0; // output origin on the root window
+    int32_t  y       = 0;
+    int32_t  width   = 0;
+    int32_t  height  = 0;
+
+    std::vector<ShmSlot> slots;
+
+    ~Impl() {
+        for (ShmSlot& slot : slots) {
+            if (slot.attached) {
+                XShmDetach(display, &slot.shm);
+            }
+            if (slot.image) {
+                slot.image->data = nullptr; // shm memory, not Xlib's to free
+                XDestroyImage(slot.image);
+            }
+            if (slot.shm.shmaddr && slot.shm.shmaddr != reinterpret_cast<char*>(-1)) {
+                shmdt(slot.shm.shmaddr);
+            }
+        }
+        if (display) {
+            XCloseDisplay(display);
+        }
+    }
+
+    bool create_slot(ShmSlot& slot) {
+        int screen = DefaultScreen(display);
+
+        slot.image = XShmCreateImage(display, DefaultVisual(display, screen),
+                                     DefaultDepth(display, screen), ZPixmap,
+                                     nullptr, &slot.shm, width, height);
+        if (!slot.image || slot.image->bits_per_pixel != 32) {
+            return false;
+        }
+
+        size_t bytes = static_cast<size_t>(slot.image->bytes_per_line) * height;
+        slot.shm.shmid = shmget(IPC_PRIVATE, bytes, IPC_CREAT | 0600);
+        if (slot.shm.shmid < 0) {
+            return false;
+        }
+
+        slot.shm.shmaddr = static_cast<char*>(shmat(slot.shm.shmid, nullptr, 0));
+        slot.image->data = slot.shm.shmaddr;
+        slot.shm.readOnly = False;
+
+        slot.attached = slot.shm.shmaddr != reinterpret_cast<char*>(-1)
+                     && XShmAttach(display, &slot.shm);
+        XSync(display, False);
+
+        // Mark for removal now; the segment lives until both sides detach.
+        shmctl(slot.shm.shmid, IPC_RMID, nullptr);
+        return slot.attached;
+    }
+};
+
+PlatformCapture::PlatformCapture() = default;
+PlatformCapture::~PlatformCapture() = default;
+
+Status PlatformCapture::open(const CaptureOptions& options, uint32_t slots) {
+    auto impl = std::make_unique<Impl>();
+
+    impl->display = XOpenDisplay(nullptr);
+    if (!impl->display) {
+        return Status::Unavailable;
+    }
+    if (!XShmQueryExtension(impl->display)) {
+        return Status::Unavailable;
+    }
+
+    std::vector<Monitor> monitors;
+    query_monitors(impl->display, monitors);
+    if (options.output < 0 || static_cast<size_t>(options.output) >= monitors.size()) {
+        return Status::InvalidArgument;
+    }
+    const Rect& bounds = monitors[options.output].bounds;
+
+    impl->root   = RootWindow(impl->display, DefaultScreen(impl->display));
+    impl->x      = bounds.x;
+    impl->y      = bounds.y;
+    impl->width  = bounds.width;
+    impl->height = bounds.height;
+
+    impl->slots.resize(slots);
+    for (ShmSlot& slot : impl->slots) {
+        if (!impl->create_slot(slot)) {
+            return Status::Failed;
+        }
+    }
+
+    impl_ = std::move(impl);
+    return Status::Ok;
+}
+
+int32_t PlatformCapture::width() const { return impl_ ? impl_->width : 0; }
+int32_t PlatformCapture::height() const { return impl_ ? impl_->height : 0; }
+
+// Core X11 keeps no dirty list (XDamage would need its own event loop),
+// so damage grabs fall back to the session's tile diff.
+Status PlatformCapture::grab(uint32_t slot, uint32_t /*timeout_ms*/, FrameSlot& out,
+                             std::vector<Rect>* /*damage*/, bool* /*damage_reported*/) {
+    ShmSlot& target = impl_->slots[slot];
+
+    if (!XShmGetImage(impl_->display, impl_->root, target.image, impl_->x, impl_->y, AllPlanes)) {
+        return Status::Failed;
+    }
+
+    out.data   = reinterpret_cast<const uint8_t*>(target.image->data);
+    out.width  = impl_->width;
+    out.height = impl_->height;
+    out.stride = target.image->bytes_per_line;
+    return Status::Ok;
+}
+
+} // namespace neuro
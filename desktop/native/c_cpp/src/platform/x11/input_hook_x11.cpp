@@ -0,0 +1,232 @@
+// X11 input hook. With XInput2 the thread listens for raw motion/button
+// events on the root window (delivered no matter which client has the
+// pointer grab) and reads the absolute position with XQueryPointer;
+// without it, the pointer is polled at poll_hz. Either way the thread
+// owns a private Display connection and a pipe to wake it for stop().
+
+#include <atomic>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <X11/Xlib.h>
+#if defined(NEURO_HAVE_XI2)
+#  include <X11/extensions/XInput2.h>
+#endif
+
+// Xlib's `#define Status int` collides with neuro::Status.
+#undef Status
+
+#include "clock.hpp"
+#include "input_hook.hpp"
+
+namespace neuro {
+
+struct PlatformMouseHook::Impl {
+    Display*          display = nullptr;
+    Window            root    = 0;
+    int               wake[2] = {-1, -1};
+    int               xi_opcode = -1;
+    std::thread       thread;
+    std::atomic<bool> stopping{false};
+
+    ~Impl() { close(); }
+
+    void close() {
+        if (display) {
+            XCloseDisplay(display);
+            display = nullptr;
+        }
+        for (int& fd : wake) {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+    }
+
+    bool query(int32_t& x, int32_t& y, unsigned& buttons) {
+        Window root_return, child;
+        int root_x, root_y, win_x, win_y;
+        if (!XQueryPointer(display, root, &root_return, &child,
+                           &root_x, &root_y, &win_x, &win_y, &buttons)) {
+            return false; // pointer on another screen
+        }
+        x = root_x;
+        y = root_y;
+        return true;
+    }
+
+    bool select_raw_events() {
+#if defined(NEURO_HAVE_XI2)
+        int event, error;
+        if (!XQueryExtension(display, "XInputExtension", &xi_opcode, &event, &error)) {
+            return false;
+        }
+        int major = 2, minor = 0;
+        if (XIQueryVersion(display, &major, &minor) != Success) {
+            return false;
+        }
+
+        unsigned char bits[XIMaskLen(XI_LASTEVENT)] = {};
+        XISetMask(bits, XI_RawMotion);
+        XISetMask(bits, XI_RawButtonPress);
+        XISetMask(bits, XI_RawButtonRelease);
+
+        XIEventMask mask;
+        mask.deviceid = XIAllMasterDevices;
+        mask.mask_len = sizeof(bits);
+        mask.mask     = bits;
+        XISelectEvents(display, root, &mask, 1);
+        XFlush(display);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Buttons 4-7 are the wheel on X11.
+    static void report_button(MouseHook& sink, int32_t x, int32_t y, int button,
+                              bool pressed, uint64_t now) {
+        switch (button) {
+            case 1: case 2: case 3:
+                sink.on_button(x, y, button, pressed, now, 0);
+                break;
+            case 4: case 5:
+                if (pressed) {
+                    sink.on_wheel(x, y, button == 4 ? 120 : -120, now, 0);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    void drain_events(MouseHook& sink) {
+#if defined(NEURO_HAVE_XI2)
+        while (XPending(display)) {
+            XEvent event;
+            XNextEvent(display, &event);
+
+            XGenericEventCookie& cookie = event.xcookie;
+            if (cookie.type != GenericEvent || cookie.extension != xi_opcode
+                || !XGetEventData(display, &cookie)) {
+                continue;
+            }
+
+            uint64_t now = monotonic_ns();
+            int32_t  x = 0, y = 0;
+            unsigned buttons = 0;
+            if (query(x, y, buttons)) {
+                const auto* raw = static_cast<const XIRawEvent*>(cookie.data);
+                switch (cookie.evtype) {
+                    case XI_RawMotion:        sink.on_move(x, y, now, 0); break;
+                    case XI_RawButtonPress:   report_button(sink, x, y, raw->detail, true, now); break;
+                    case XI_RawButtonRelease: report_button(sink, x, y, raw->detail, false, now); break;
+                    default: break;
+                }
+            }
+            XFreeEventData(display, &cookie);
+        }
+#else
+        (void)sink;
+#endif
+    }
+
+    void run_events(MouseHook& sink) {
+        pollfd fds[2] = {
+            {ConnectionNumber(display), POLLIN, 0},
+            {wake[0], POLLIN, 0},
+        };
+
+        while (!stopping.load(std::memory_order_acquire)) {
+            drain_events(sink);
+
+            uint64_t wait_ns = sink.flush(monotonic_ns());
+            int wait_ms = static_cast<int>((wait_ns + 999'999) / 1'000'000);
+            poll(fds, 2, wait_ms);
+        }
+    }
+
+    void run_polling(MouseHook& sink) {
+        const uint64_t period_ns = 1'000'000'000ull / sink.poll_hz();
+        const unsigned kButtons[3] = {Button1Mask, Button2Mask, Button3Mask};
+
+        int32_t  last_x = INT32_MIN, last_y = INT32_MIN;
+        unsigned last_buttons = 0;
+        pollfd   fds = {wake[0], POLLIN, 0};
+
+        while (!stopping.load(std::memory_order_acquire)) {
+            uint64_t now = monotonic_ns();
+            int32_t  x, y;
+            unsigned buttons;
+            if (query(x, y, buttons)) {
+                if (x != last_x || y != last_y) {
+                    sink.on_move(x, y, now, 0);
+                    last_x = x;
+                    last_y = y;
+                }
+                for (int i = 0; i < 3; ++i) {
+                    if ((buttons ^ last_buttons) & kButtons[i]) {
+                        sink.on_button(x, y, i + 1, (buttons & kButtons[i]) != 0, now, 0);
+                    }
+                }
+                last_buttons = buttons;
+            }
+            sink.flush(now);
+
+            uint64_t elapsed = monotonic_ns() - now;
+            if (elapsed < period_ns) {
+                timespec ts = {0, static_cast<long>(period_ns - elapsed)};
+                ppoll(&fds, 1, &ts, nullptr);
+            }
+        }
+    }
+};
+
+PlatformMouseHook::PlatformMouseHook() : impl_(std::make_unique<Impl>()) {}
+PlatformMouseHook::~PlatformMouseHook() { stop(); }
+
+Status PlatformMouseHook::start(MouseHook& sink) {
+    Impl& impl = *impl_;
+
+    impl.display = XOpenDisplay(nullptr);
+    if (!impl.display) {
+        return Status::Unavailable;
+    }
+    impl.root = DefaultRootWindow(impl.display);
+
+    if (pipe(impl.wake) != 0) {
+        impl.close();
+        return Status::Failed;
+    }
+    fcntl(impl.wake[0], F_SETFL, O_NONBLOCK);
+
+    bool events = impl.select_raw_events();
+    impl.stopping.store(false, std::memory_order_release);
+    impl.thread = std::thread([&impl, &sink, events] {
+        if (events) {
+            impl.run_events(sink);
+        } else {
+            impl.run_polling(sink);
+        }
+    });
+    return Status::Ok;
+}
+
+void PlatformMouseHook::stop() {
+    Impl& impl = *impl_;
+    if (!impl.thread.joinable()) {
+        return;
+    }
+
+    impl.stopping.store(true, std::memory_order_release);
+    char byte = 0;
+    (void)!write(impl.wake[1], &byte, 1);
+    impl.thread.join();
+    impl.close();
+}
+
+} // namespace neuro
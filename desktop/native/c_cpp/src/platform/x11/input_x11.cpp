@@ -0,0 +1,465 @@
+// XTest backend. Keys and characters resolve through the server's
+// keyboard mapping (read once at open), so typing follows the active
+// layout; every send() is one batch of fake events and a single flush.
+// Characters off the layout are typed by binding their keysym to one of
+// the keycodes the mapping leaves empty, for as long as it is needed.
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/keysym.h>
+#include <X11/extensions/XTest.h>
+
+// Xlib's `#define Status int` collides with neuro::Status.
+#undef Status
+
+#include "input.hpp"
+
+namespace neuro {
+
+struct NamedKey {
+    const char* name;
+    KeySym      keysym;
+};
+
+// pyautogui's KEYBOARD_KEYS names; anything else goes to XStringToKeysym.
+static const NamedKey kNamedKeys[] = {
+    {"backspace", XK_BackSpace}, {"\b", XK_BackSpace}, {"tab", XK_Tab}, {"\t", XK_Tab},
+    {"enter", XK_Return}, {"return", XK_Return}, {"\n", XK_Return}, {"\r", XK_Return},
+    {"shift", XK_Shift_L}, {"shiftleft", XK_Shift_L}, {"shiftright", XK_Shift_R},
+    {"ctrl", XK_Control_L}, {"ctrlleft", XK_Control_L}, {"ctrlright", XK_Control_R},
+    {"alt", XK_Alt_L}, {"altleft", XK_Alt_L}, {"altright", XK_Alt_R},
+    {"win", XK_Super_L}, {"winleft", XK_Super_L}, {"winright", XK_Super_R}, {"apps", XK_Menu},
+    {"pause", XK_Pause}, {"capslock", XK_Caps_Lock}, {"numlock", XK_Num_Lock}, {"scrolllock", XK_Scroll_Lock},
+    {"esc", XK_Escape}, {"escape", XK_Escape}, {"space", XK_space}, {" ", XK_space},
+    {"pageup", XK_Page_Up}, {"pgup", XK_Page_Up}, {"pagedown", XK_Page_Down}, {"pgdn", XK_Page_Down},
+    {"end", XK_End}, {"home", XK_Home},
+    {"left", XK_Left}, {"up", XK_Up}, {"right", XK_Right}, {"down", XK_Down},
+    {"select", XK_Select}, {"print", XK_Print}, {"execute", XK_Execute},
+    {"printscreen", XK_Print}, {"prtsc", XK_Print}, {"prtscr", XK_Print}, {"prntscrn", XK_Print},
+    {"insert", XK_Insert}, {"delete", XK_Delete}, {"del", XK_Delete}, {"help", XK_Help},
+    {"multiply", XK_KP_Multiply}, {"add", XK_KP_Add}, {"separator", XK_KP_Separator},
+    {"subtract", XK_KP_Subtract}, {"decimal", XK_KP_Decimal}, {"divide", XK_KP_Divide},
+    // XF86 multimedia keysyms (X11/XF86keysym.h)
+    {"volumemute", 0x1008FF12}, {"volumedown", 0x1008FF11}, {"volumeup", 0x1008FF13},
+    {"playpause", 0x1008FF14}, {"stop", 0x1008FF15}, {"prevtrack", 0x1008FF16}, {"nexttrack", 0x1008FF17},
+};
+
+// Latin-1 keysyms equal the codepoint; the rest of Unicode is 0x01000000 + cp.
+static KeySym keysym_of(uint32_t codepoint) {
+    return (codepoint >= 0x20 && codepoint <= 0x7E) || (codepoint >= 0xA0 && codepoint <= 0xFF)
+         ? codepoint
+         : 0x01000000 | codepoint;
+}
+
+// -------------------------------------------------
+// Clipboard owner
+//
+// X selections are served by their owner on request, so set() hands the
+// text to a thread with its own connection that takes CLIPBOARD and
+// answers SelectionRequests until another client takes it over. Text
+// that does not fit one ChangeProperty request (no INCR) is refused.
+// -------------------------------------------------
+
+class ClipboardOwner {
+public:
+    ~ClipboardOwner() {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                stopping_ = true;
+            }
+            wake();
+            thread_.join();
+        }
+        if (display_) {
+            XCloseDisplay(display_);
+        }
+        for (int fd : wake_) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    Status set(std::string_view utf8) {
+        if (!start()) {
+            return Status::Unavailable;
+        }
+        if (utf8.size() > max_bytes_) {
+            return Status::Unavailable;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        // Let a paste still in flight fetch its text before replacing it.
+        changed_.wait_for(lock, std::chrono::milliseconds(250), [this] { return !owner_ || served_; });
+
+        pending_.assign(utf8.data(), utf8.size());
+        uint64_t ticket = ++requested_;
+        lock.unlock();
+        wake();
+        lock.lock();
+
+        if (!changed_.wait_for(lock, std::chrono::seconds(1), [&] { return taken_ >= ticket; })) {
+            return Status::Timeout;
+        }
+        return owner_ ? Status::Ok : Status::Failed;
+    }
+
+private:
+    bool start() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (thread_.joinable() || failed_) {
+            return !failed_;
+        }
+
+        failed_ = true;
+        display_ = XOpenDisplay(nullptr);
+        if (!display_ || pipe(wake_) != 0) {
+            return false;
+        }
+        fcntl(wake_[0], F_SETFL, O_NONBLOCK);
+
+        window_    = XCreateSimpleWindow(display_, DefaultRootWindow(display_), 0, 0, 1, 1, 0, 0, 0);
+        clipboard_ = XInternAtom(display_, "CLIPBOARD", False);
+        targets_   = XInternAtom(display_, "TARGETS", False);
+        utf8_      = XInternAtom(display_, "UTF8_STRING", False);
+        text_atom_ = XInternAtom(display_, "TEXT", False);
+
+        long max_request = XExtendedMaxRequestSize(display_);
+        if (max_request == 0) {
+            max_request = XMaxRequestSize(display_);
+        }
+        max_bytes_ = static_cast<size_t>(max_request) * 4 - 256; // request header room
+        XFlush(display_);
+
+        failed_ = false;
+        thread_ = std::thread([this] { run(); });
+        return true;
+    }
+
+    void wake() {
+        char byte = 0;
+        (void)!write(wake_[1], &byte, 1);
+    }
+
+    void run() {
+        pollfd fds[2] = {{ConnectionNumber(display_), POLLIN, 0}, {wake_[0], POLLIN, 0}};
+        for (;;) {
+            while (XPending(display_)) {
+                XEvent event;
+                XNextEvent(display_, &event);
+                if (event.type == SelectionRequest) {
+                    serve(event.xselectionrequest);
+                } else if (event.type == SelectionClear) {
+                    std::lock_guard<std::mutex> guard(mutex_);
+                    owner_ = false;
+                    text_.clear();
+                    changed_.notify_all();
+                }
+            }
+
+            poll(fds, 2, -1);
+            if (!(fds[1].revents & POLLIN)) {
+                continue;
+            }
+            char drain[64];
+            while (read(wake_[0], drain, sizeof(drain)) > 0) {
+            }
+
+            std::lock_guard<std::mutex> guard(mutex_);
+            if (stopping_) {
+                return;
+            }
+            if (taken_ < requested_) {
+                text_.swap(pending_);
+                XSetSelectionOwner(display_, clipboard_, window_, CurrentTime);
+                owner_  = XGetSelectionOwner(display_, clipboard_) == window_;
+                served_ = false;
+                taken_  = requested_;
+                changed_.notify_all();
+            }
+        }
+    }
+
+    void serve(const XSelectionRequestEvent& request) {
+        XSelectionEvent reply{};
+        reply.type      = SelectionNotify;
+        reply.display   = request.display;
+        reply.requestor = request.requestor;
+        reply.selection = request.selection;
+        reply.target    = request.target;
+        reply.time      = request.time;
+        reply.property  = None;
+
+        // Obsolete clients leave the property out.
+        Atom property = request.property != None ? request.property : request.target;
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (request.selection == clipboard_ && owner_) {
+            if (request.target == targets_) {
+                Atom targets[] = {targets_, utf8_, text_atom_, XA_STRING};
+                XChangeProperty(display_, request.requestor, property, XA_ATOM, 32, PropModeReplace,
+                                reinterpret_cast<unsigned char*>(targets), 4);
+                reply.property = property;
+            } else if (request.target == utf8_ || request.target == text_atom_ || request.target == XA_STRING) {
+                Atom type = request.target == XA_STRING ? XA_STRING : utf8_;
+                XChangeProperty(display_, request.requestor, property, type, 8, PropModeReplace,
+                                reinterpret_cast<const unsigned char*>(text_.data()),
+                                static_cast<int>(text_.size()));
+                reply.property = property;
+                served_ = true;
+                changed_.notify_all();
+            }
+        }
+
+        XSendEvent(display_, request.requestor, False, 0, reinterpret_cast<XEvent*>(&reply));
+        XFlush(display_);
+    }
+
+    // display_ is the thread's once it runs.
+    Display* display_   = nullptr;
+    Window   window_    = 0;
+    Atom     clipboard_ = None, targets_ = None, utf8_ = None, text_atom_ = None;
+    size_t   max_bytes_ = 0;
+    int      wake_[2]   = {-1, -1};
+
+    std::thread             thread_;
+    std::mutex              mutex_;
+    std::condition_variable changed_;
+    std::string             text_;    // being served
+    std::string             pending_; // next set()
+    uint64_t                requested_ = 0, taken_ = 0;
+    bool                    owner_    = false;
+    bool                    served_   = false; // text_ fetched since it was set
+    bool                    stopping_ = false;
+    bool                    failed_   = false;
+};
+
+struct PlatformInput::Impl {
+    Display* display = nullptr;
+    Window   root    = 0;
+
+    std::unordered_map<std::string, KeySym> names;
+    std::unordered_map<KeySym, KeyStroke>   strokes; // keysym -> first keycode producing it
+
+    // Empty keycodes borrowed for characters off the layout, in turn;
+    // bound[i] is what spare[i] produces now (NoSymbol = nothing yet).
+    std::vector<KeyCode> spare;
+    std::vector<KeySym>  bound;
+    size_t               next_spare = 0;
+
+    std::unique_ptr<ClipboardOwner> clipboard;
+
+    ~Impl() {
+        clipboard.reset();
+        if (display) {
+            // Hand the borrowed keycodes back empty.
+            KeySym none = NoSymbol;
+            for (size_t i = 0; i < spare.size(); ++i) {
+                if (bound[i] != NoSymbol) {
+                    XChangeKeyboardMapping(display, spare[i], 1, &none, 1);
+                }
+            }
+            XSync(display, False);
+            XCloseDisplay(display);
+        }
+    }
+
+    KeyCode bind(KeySym sym) {
+        for (size_t i = 0; i < spare.size(); ++i) {
+            if (bound[i] == sym) {
+                return spare[i];
+            }
+        }
+        // Once every spare is taken, let the server (and so clients, via
+        // MappingNotify) catch up before one is rebound.
+        size_t i = next_spare++ % spare.size();
+        if (i == 0 && next_spare > spare.size()) {
+            XSync(display, False);
+        }
+        XChangeKeyboardMapping(display, spare[i], 1, &sym, 1);
+        bound[i] = sym;
+        return spare[i];
+    }
+
+    void load_mapping() {
+        int min_code = 0, max_code = 0, per_code = 0;
+        XDisplayKeycodes(display, &min_code, &max_code);
+
+        KeySym* map = XGetKeyboardMapping(display, static_cast<KeyCode>(min_code),
+                                          max_code - min_code + 1, &per_code);
+        if (!map) {
+            return;
+        }
+
+        // Column 0 is the plain key, column 1 the shifted one; prefer
+        // unshifted when a keysym appears in both.
+        for (int column = 0; column < 2 && column < per_code; ++column) {
+            for (int code = min_code; code <= max_code; ++code) {
+                KeySym sym = map[(code - min_code) * per_code + column];
+                if (sym != NoSymbol) {
+                    strokes.emplace(sym, KeyStroke{static_cast<uint32_t>(code), column == 1});
+                }
+            }
+        }
+
+        // Keycodes without any keysym (8 is never used, but check anyway).
+        for (int code = min_code; code <= max_code; ++code) {
+            bool empty = true;
+            for (int column = 0; column < per_code && empty; ++column) {
+                empty = map[(code - min_code) * per_code + column] == NoSymbol;
+            }
+            if (empty) {
+                spare.push_back(static_cast<KeyCode>(code));
+            }
+        }
+        bound.assign(spare.size(), NoSymbol);
+        XFree(map);
+    }
+
+    bool stroke_of(KeySym sym, KeyStroke& out) const {
+        auto it = strokes.find(sym);
+        if (it == strokes.end()) {
+            return false;
+        }
+        out = it->second;
+        return true;
+    }
+};
+
+PlatformInput::PlatformInput() = default;
+PlatformInput::~PlatformInput() = default;
+
+Status PlatformInput::open() {
+    auto impl = std::make_unique<Impl>();
+
+    impl->display = XOpenDisplay(nullptr);
+    if (!impl->display) {
+        return Status::Unavailable;
+    }
+
+    int event, error, major, minor;
+    if (!XTestQueryExtension(impl->display, &event, &error, &major, &minor)) {
+        return Status::Unavailable;
+    }
+    impl->root = DefaultRootWindow(impl->display);
+
+    for (const NamedKey& key : kNamedKeys) {
+        impl->names.emplace(key.name, key.keysym);
+    }
+    for (int i = 0; i < 10; ++i) {
+        impl->names.emplace("num" + std::to_string(i), XK_KP_0 + i);
+    }
+    for (int i = 1; i <= 24; ++i) {
+        impl->names.emplace("f" + std::to_string(i), XK_F1 + i - 1);
+    }
+    impl->load_mapping();
+
+    impl_ = std::move(impl);
+    return Status::Ok;
+}
+
+Status PlatformInput::screen_size(int32_t& width, int32_t& height) {
+    int screen = DefaultScreen(impl_->display);
+    width  = DisplayWidth(impl_->display, screen);
+    height = DisplayHeight(impl_->display, screen);
+    return Status::Ok;
+}
+
+Status PlatformInput::cursor(int32_t& x, int32_t& y) {
+    Window root, child;
+    int root_x, root_y, win_x, win_y;
+    unsigned mask;
+    if (!XQueryPointer(impl_->display, impl_->root, &root, &child,
+                       &root_x, &root_y, &win_x, &win_y, &mask)) {
+        return Status::Failed;
+    }
+    x = root_x;
+    y = root_y;
+    return Status::Ok;
+}
+
+bool PlatformInput::resolve_key(std::string_view name, KeyStroke& out) {
+    std::string key(name);
+    auto it = impl_->names.find(key);
+    KeySym sym = it != impl_->names.end() ? it->second : XStringToKeysym(key.c_str());
+    if (sym == NoSymbol || !impl_->stroke_of(sym, out)) {
+        return false;
+    }
+    out.shift = false; // named keys are pressed as-is
+    return true;
+}
+
+bool PlatformInput::resolve_char(uint32_t codepoint, KeyStroke& out) {
+    return impl_->stroke_of(keysym_of(codepoint), out);
+}
+
+bool PlatformInput::supports_unicode() const {
+    return !impl_->spare.empty();
+}
+
+Status PlatformInput::set_clipboard(std::string_view utf8) {
+    if (!impl_->clipboard) {
+        impl_->clipboard = std::make_unique<ClipboardOwner>();
+    }
+    return impl_->clipboard->set(utf8);
+}
+
+Status PlatformInput::send(const InputEvent* events, size_t count) {
+    Display* display = impl_->display;
+
+    for (size_t i = 0; i < count; ++i) {
+        const InputEvent& event = events[i];
+        switch (event.kind) {
+            case InputEvent::Kind::Key:
+                XTestFakeKeyEvent(display, event.code, event.down, CurrentTime);
+                break;
+
+            case InputEvent::Kind::Move:
+                XTestFakeMotionEvent(display, -1, event.x, event.y, CurrentTime);
+                break;
+
+            case InputEvent::Kind::Button:
+                XTestFakeButtonEvent(display, event.code, event.down, CurrentTime);
+                break;
+
+            case InputEvent::Kind::Wheel: {
+                // Buttons 4/5, one click per 120 units.
+                unsigned button = event.y > 0 ? 4 : 5;
+                for (int n = std::abs(event.y) / 120; n > 0; --n) {
+                    XTestFakeButtonEvent(display, button, True, CurrentTime);
+                    XTestFakeButtonEvent(display, button, False, CurrentTime);
+                }
+                break;
+            }
+
+            case InputEvent::Kind::Unicode:
+                if (impl_->spare.empty()) {
+                    return Status::Unavailable;
+                }
+                // Down and up of one character are adjacent, so the up
+                // finds the keycode the down bound.
+                XTestFakeKeyEvent(display, impl_->bind(keysym_of(event.code)), event.down, CurrentTime);
+                break;
+
+            case InputEvent::Kind::Paste:
+                break; // carried out by the injector
+        }
+    }
+
+    XFlush(display);
+    return Status::Ok;
+}
+
+} // namespace neuro
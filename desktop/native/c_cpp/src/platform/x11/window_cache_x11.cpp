@@ -0,0 +1,245 @@
+// X11 window watch. The window manager publishes the managed windows as
+// _NET_CLIENT_LIST and the focused one as _NET_ACTIVE_WINDOW on the root
+// window; PropertyNotify on the root and on every client (for
+// _NET_WM_NAME / WM_NAME) keeps the cache current. Needs an EWMH window
+// manager. The thread owns a private Display connection and a pipe to
+// wake it for stop().
+
+#include <atomic>
+#include <climits>
+#include <thread>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+
+// Xlib's `#define Status int` collides with neuro::Status.
+#undef Status
+
+#include "window_cache.hpp"
+
+namespace neuro {
+
+// Clients can vanish between an event and our next request about them.
+// Xlib's error handler is process-wide: swallow errors on our own
+// connection and hand everything else to whoever was installed before.
+using XErrorHandlerFn = int (*)(Display*, XErrorEvent*);
+static std::atomic<Display*> g_display{nullptr};
+static XErrorHandlerFn       g_previous_handler = nullptr;
+
+static int ignore_own_errors(Display* display, XErrorEvent* event) {
+    if (display == g_display.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    return g_previous_handler ? g_previous_handler(display, event) : 0;
+}
+
+struct PlatformWindowWatch::Impl {
+    Display*          display = nullptr;
+    Window            root    = 0;
+    int               wake[2] = {-1, -1};
+    std::thread       thread;
+    std::atomic<bool> stopping{false};
+
+    Atom client_list = None;
+    Atom active      = None;
+    Atom net_name    = None;
+    Atom utf8        = None;
+    Atom pid         = None;
+
+    std::unordered_set<Window> clients;
+
+    ~Impl() { close(); }
+
+    void close() {
+        if (display) {
+            XSetErrorHandler(g_previous_handler);
+            g_display.store(nullptr, std::memory_order_release);
+            XCloseDisplay(display);
+            display = nullptr;
+        }
+        for (int& fd : wake) {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        clients.clear();
+    }
+
+    // Format-32 items come back as longs whatever their wire size.
+    bool get_longs(Window window, Atom name, Atom type, std::vector<unsigned long>& out) {
+        Atom           actual_type;
+        int            format;
+        unsigned long  count, remaining;
+        unsigned char* data = nullptr;
+        out.clear();
+        if (XGetWindowProperty(display, window, name, 0, LONG_MAX / 4, False, type, &actual_type,
+                               &format, &count, &remaining, &data) != Success) {
+            return false;
+        }
+        bool ok = data && actual_type == type && format == 32;
+        if (ok) {
+            const auto* items = reinterpret_cast<const unsigned long*>(data);
+            out.assign(items, items + count);
+        }
+        if (data) XFree(data);
+        return ok;
+    }
+
+    bool get_text(Window window, Atom name, Atom type, std::string& out) {
+        Atom           actual_type;
+        int            format;
+        unsigned long  count, remaining;
+        unsigned char* data = nullptr;
+        if (XGetWindowProperty(display, window, name, 0, LONG_MAX / 4, False, type, &actual_type,
+                               &format, &count, &remaining, &data) != Success) {
+            return false;
+        }
+        bool ok = data && actual_type != None && format == 8;
+        if (ok) {
+            out.assign(reinterpret_cast<const char*>(data), count);
+        }
+        if (data) XFree(data);
+        return ok;
+    }
+
+    std::string title_of(Window window) {
+        std::string title;
+        if (!get_text(window, net_name, utf8, title)) {
+            get_text(window, XA_WM_NAME, AnyPropertyType, title);
+        }
+        return title;
+    }
+
+    uint32_t pid_of(Window window) {
+        std::vector<unsigned long> value;
+        return get_longs(window, pid, XA_CARDINAL, value) && !value.empty()
+                   ? static_cast<uint32_t>(value[0]) : 0;
+    }
+
+    Window active_window() {
+        std::vector<unsigned long> value;
+        return get_longs(root, active, XA_WINDOW, value) && !value.empty() ? value[0] : 0;
+    }
+
+    void report(WindowCache& sink, Window window) {
+        sink.upsert(window, pid_of(window), title_of(window));
+    }
+
+    // Diffs _NET_CLIENT_LIST against the clients we already watch.
+    void refresh_clients(WindowCache& sink) {
+        std::vector<unsigned long> list;
+        get_longs(root, client_list, XA_WINDOW, list);
+
+        std::unordered_set<Window> current(list.begin(), list.end());
+        for (auto it = clients.begin(); it != clients.end();) {
+            if (!current.count(*it)) {
+                sink.remove(*it);
+                it = clients.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (Window window : list) {
+            if (clients.insert(window).second) {
+                // Subscribe before reading, so no rename slips between.
+                XSelectInput(display, window, PropertyChangeMask);
+                report(sink, window);
+            }
+        }
+    }
+
+    void run(WindowCache& sink) {
+        pollfd fds[2] = {
+            {ConnectionNumber(display), POLLIN, 0},
+            {wake[0], POLLIN, 0},
+        };
+
+        while (!stopping.load(std::memory_order_acquire)) {
+            while (XPending(display)) {
+                XEvent event;
+                XNextEvent(display, &event);
+                if (event.type != PropertyNotify) {
+                    continue;
+                }
+
+                const XPropertyEvent& property = event.xproperty;
+                if (property.window == root) {
+                    if (property.atom == client_list) {
+                        refresh_clients(sink);
+                    } else if (property.atom == active) {
+                        sink.set_active(active_window());
+                    }
+                } else if ((property.atom == net_name || property.atom == XA_WM_NAME)
+                           && clients.count(property.window)) {
+                    report(sink, property.window);
+                }
+            }
+            sink.commit();
+            poll(fds, 2, -1);
+        }
+    }
+};
+
+PlatformWindowWatch::PlatformWindowWatch() : impl_(std::make_unique<Impl>()) {}
+PlatformWindowWatch::~PlatformWindowWatch() { stop(); }
+
+Status PlatformWindowWatch::start(WindowCache& sink) {
+    Impl& impl = *impl_;
+
+    impl.display = XOpenDisplay(nullptr);
+    if (!impl.display) {
+        return Status::Unavailable;
+    }
+    impl.root = DefaultRootWindow(impl.display);
+    g_display.store(impl.display, std::memory_order_release);
+    g_previous_handler = XSetErrorHandler(ignore_own_errors);
+
+    impl.client_list = XInternAtom(impl.display, "_NET_CLIENT_LIST", False);
+    impl.active      = XInternAtom(impl.display, "_NET_ACTIVE_WINDOW", False);
+    impl.net_name    = XInternAtom(impl.display, "_NET_WM_NAME", False);
+    impl.utf8        = XInternAtom(impl.display, "UTF8_STRING", False);
+    impl.pid         = XInternAtom(impl.display, "_NET_WM_PID", False);
+
+    // Without an EWMH window manager there is no client list to follow.
+    XSelectInput(impl.display, impl.root, PropertyChangeMask);
+    std::vector<unsigned long> probe;
+    if (!impl.get_longs(impl.root, impl.client_list, XA_WINDOW, probe)) {
+        impl.close();
+        return Status::Unavailable;
+    }
+
+    if (pipe(impl.wake) != 0) {
+        impl.close();
+        return Status::Failed;
+    }
+    fcntl(impl.wake[0], F_SETFL, O_NONBLOCK);
+
+    impl.refresh_clients(sink);
+    sink.set_active(impl.active_window());
+    sink.commit();
+
+    impl.stopping.store(false, std::memory_order_release);
+    impl.thread = std::thread([&impl, &sink] { impl.run(sink); });
+    return Status::Ok;
+}
+
+void PlatformWindowWatch::stop() {
+    Impl& impl = *impl_;
+    if (!impl.thread.joinable()) {
+        return;
+    }
+
+    impl.stopping.store(true, std::memory_order_release);
+    char byte = 0;
+    (void)!write(impl.wake[1], &byte, 1);
+    impl.thread.join();
+    impl.close();
+}
+
+} // namespace neuro
@@ -0,0 +1,115 @@
+#include "process_tracker.hpp"
+
+#include <algorithm>
+
+namespace neuro {
+
+Status ProcessTracker::refresh() {
+    added_.clear();
+    removed_.clear();
+    ++epoch_;
+
+    bool full = false;
+    Status status = platform_.refresh(*this, full);
+    if (status == Status::Ok && full) {
+        sweep();
+    }
+    return status;
+}
+
+size_t ProcessTracker::list(ProcessDelta* out, size_t max) const {
+    size_t i = 0;
+    for (auto it = table_.begin(); it != table_.end() && i < max; ++it, ++i) {
+        out[i] = ProcessDelta{it->first, it->second.name_id};
+    }
+    return table_.size();
+}
+
+std::string_view ProcessTracker::name(uint32_t id) const {
+    return id < names_.size() ? std::string_view(names_[id]) : std::string_view();
+}
+
+bool ProcessTracker::keep(uint32_t pid, uint64_t start_time) {
+    auto it = table_.find(pid);
+    if (it == table_.end()) {
+        return false;
+    }
+    if (start_time && it->second.start_time && it->second.start_time != start_time) {
+        // Same pid, different process: the old one went away unseen.
+        retire(pid, it->second);
+        table_.erase(it);
+        return false;
+    }
+    it->second.epoch = epoch_;
+    return true;
+}
+
+void ProcessTracker::add(uint32_t pid, uint64_t start_time, std::string_view name) {
+    uint32_t id = intern(name);
+
+    auto it = table_.find(pid);
+    if (it != table_.end()) {
+        // exec() or a recycled pid seen through events.
+        Entry& entry = it->second;
+        entry.epoch = epoch_;
+        if (entry.name_id == id && (!start_time || entry.start_time == start_time)) {
+            return;
+        }
+        retire(pid, entry);
+        entry.start_time = start_time;
+        entry.name_id    = id;
+        entry.born       = epoch_;
+    } else {
+        table_.emplace(pid, Entry{start_time, id, epoch_, epoch_});
+    }
+    added_.push_back(ProcessDelta{pid, id});
+}
+
+void ProcessTracker::remove(uint32_t pid) {
+    auto it = table_.find(pid);
+    if (it == table_.end()) {
+        return;
+    }
+
+    retire(pid, it->second);
+    table_.erase(it);
+}
+
+void ProcessTracker::retire(uint32_t pid, const Entry& entry) {
+    if (entry.born == epoch_) {
+        // Added during this refresh: the consumer never saw it, so take
+        // the addition back instead of reporting a removal.
+        added_.erase(std::remove_if(added_.begin(), added_.end(),
+                                    [pid](const ProcessDelta& d) { return d.pid == pid; }),
+                     added_.end());
+    } else {
+        removed_.push_back(ProcessDelta{pid, entry.name_id});
+    }
+}
+
+uint32_t ProcessTracker::intern(std::string_view name) {
+    std::string key(name);
+    auto it = name_ids_.find(key);
+    if (it != name_ids_.end()) {
+        return it->second;
+    }
+
+    auto id = static_cast<uint32_t>(names_.size());
+    names_.push_back(key);
+    name_ids_.emplace(std::move(key), id);
+    return id;
+}
+
+// After a full scan: whatever the scan didn't touch has exited.
+void ProcessTracker::sweep() {
+    for (auto it = table_.begin(); it != table_.end();) {
+        if (it->second.epoch != epoch_) {
+            removed_.push_back(ProcessDelta{it->first, it->second.name_id});
+            it = table_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace neuro
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "status.hpp"
+
+namespace neuro {
+
+class ProcessTracker;
+
+// ABI-identical to the C view (see neuro_native.h).
+using ProcessDelta = nn_process_delta;
+
+// -------------------------------------------------
+// Platform half of the tracker (src/platform/<os>/process_*.cpp)
+//
+// refresh() brings the sink up to date, either with a full scan (every
+// live process goes through keep(), and add() for the ones it doesn't
+// know; `full` = true so the rest get swept) or, where the OS streams
+// process events, by replaying them with add() / remove().
+// -------------------------------------------------
+
+class PlatformProcessSource {
+public:
+    PlatformProcessSource();
+    ~PlatformProcessSource();
+
+    Status refresh(ProcessTracker& sink, bool& full);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// -------------------------------------------------
+// Incremental process table (C ABI nn_process_tracker_*)
+//
+// Each refresh() diffs the live processes against the previous table
+// and leaves the difference in added() / removed(): apply the removals
+// first, then the additions. Names are interned
+// per tracker: ids are dense and never reused, so a consumer only has
+// to learn the names with ids past the last count it saw. A process is
+// a pid plus its start time, so a recycled pid is a removal and an
+// addition. Not thread-safe.
+// -------------------------------------------------
+
+class ProcessTracker {
+public:
+    Status refresh();
+
+    const std::vector<ProcessDelta>& added() const { return added_; }
+    const std::vector<ProcessDelta>& removed() const { return removed_; }
+
+    size_t size() const { return table_.size(); }
+    // Every live process, unordered; returns the total.
+    size_t list(ProcessDelta* out, size_t max) const;
+
+    size_t           name_count() const { return names_.size(); }
+    std::string_view name(uint32_t id) const;
+
+    // -------- Called from PlatformProcessSource::refresh --------
+
+    // Full scans: true when `pid` (started at `start_time`, 0 = unknown)
+    // is already in the table.
+    bool keep(uint32_t pid, uint64_t start_time);
+    void add(uint32_t pid, uint64_t start_time, std::string_view name);
+    void remove(uint32_t pid);
+
+private:
+    struct Entry {
+        uint64_t start_time;
+        uint32_t name_id;
+        uint32_t epoch; // last refresh that saw it
+        uint32_t born;  // refresh that added it
+    };
+
+    uint32_t intern(std::string_view name);
+    void     retire(uint32_t pid, const Entry& entry);
+    void     sweep();
+
+    PlatformProcessSource                  platform_;
+    std::unordered_map<uint32_t, Entry>    table_;
+    std::vector<ProcessDelta>              added_;
+    std::vector<ProcessDelta>              removed_;
+    uint32_t                               epoch_ = 0;
+
+    std::vector<std::string>                  names_;
+    std::unordered_map<std::string, uint32_t> name_ids_;
+};
+
+} // namespace neuro
@@ -0,0 +1,106 @@
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "clock.hpp"
+
+namespace neuro {
+
+static PlatformTimer& thread_timer() {
+    thread_local PlatformTimer timer;
+    return timer;
+}
+
+// Per-thread timeline cursor (monotonic_ns)
+static thread_local uint64_t t_deadline = 0;
+
+double wait_seconds(double seconds) {
+    if (!(seconds > 0)) {
+        return 0;
+    }
+    return std::min(seconds, Scheduler::kMaxWaitSeconds);
+}
+
+uint64_t wait_ns(double seconds) {
+    return static_cast<uint64_t>(std::llround(wait_seconds(seconds) * 1e9));
+}
+
+Scheduler& Scheduler::instance() {
+    static Scheduler scheduler;
+    return scheduler;
+}
+
+int64_t Scheduler::wait_until(uint64_t deadline_ns) {
+    PlatformTimer& timer = thread_timer();
+
+    // Sleep through most of it, then spin out the platform's wake slack.
+    uint64_t now = monotonic_ns();
+    uint64_t slack = timer.slack_ns();
+    if (deadline_ns > now + slack) {
+        timer.sleep_until(deadline_ns - slack);
+    }
+    while ((now = monotonic_ns()) < deadline_ns) {
+        std::this_thread::yield();
+    }
+
+    int64_t error = static_cast<int64_t>(now - deadline_ns);
+    record(error);
+    return error;
+}
+
+uint64_t Scheduler::anchor() {
+    uint64_t now = monotonic_ns();
+    if (t_deadline + kStaleNs < now) {
+        t_deadline = now;
+    }
+    return t_deadline;
+}
+
+void Scheduler::advance_to(uint64_t deadline_ns) {
+    t_deadline = std::max(t_deadline, deadline_ns);
+}
+
+int64_t Scheduler::wait(double seconds) {
+    anchor();
+    t_deadline += wait_ns(seconds);
+    return wait_until(t_deadline);
+}
+
+uint64_t Scheduler::deadline() const {
+    return t_deadline;
+}
+
+void Scheduler::record(int64_t error_ns) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    min_ = waits_ ? std::min(min_, error_ns) : error_ns;
+    max_ = waits_ ? std::max(max_, error_ns) : error_ns;
+    ++waits_;
+    sum_ += static_cast<double>(error_ns);
+    sum_sq_ += static_cast<double>(error_ns) * static_cast<double>(error_ns);
+}
+
+ScheduleStats Scheduler::stats() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    ScheduleStats out;
+    out.waits = waits_;
+    if (waits_) {
+        double mean = sum_ / static_cast<double>(waits_);
+        double variance = std::max(0.0, sum_sq_ / static_cast<double>(waits_) - mean * mean);
+        out.mean_error_ns = static_cast<int64_t>(std::llround(mean));
+        out.min_error_ns = min_;
+        out.max_error_ns = max_;
+        out.stddev_ns = static_cast<uint64_t>(std::llround(std::sqrt(variance)));
+    }
+    return out;
+}
+
+void Scheduler::reset_stats() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    waits_ = 0;
+    sum_ = sum_sq_ = 0;
+    min_ = max_ = 0;
+}
+
+} // namespace neuro
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "status.hpp"
+
+namespace neuro {
+
+// -------------------------------------------------
+// Platform half (src/platform/<os>/timer_*.cpp)
+// -------------------------------------------------
+
+// One per thread: a Windows waitable timer can't be waited on from two
+// threads at once.
+class PlatformTimer {
+public:
+    PlatformTimer();
+    ~PlatformTimer();
+
+    // Blocks until about `deadline_ns` (monotonic_ns clock). May wake up
+    // to slack_ns() late; never intentionally early.
+    void sleep_until(uint64_t deadline_ns);
+
+    // How late sleep_until typically wakes; the scheduler stops sleeping
+    // this far ahead of a deadline and spins the rest.
+    uint64_t slack_ns() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// -------------------------------------------------
+// Deadline scheduler (C ABI nn_schedule_*)
+//
+// Every thread has a timeline: a cursor that wait() advances by the
+// requested duration before waiting for it, so waits are measured from
+// the previous deadline instead of from whenever the caller got around
+// to it, and injection time never accumulates as drift. Anything that
+// paces input on a thread (controller queues, scripts, tweens, paths)
+// shares that thread's timeline.
+// -------------------------------------------------
+
+// A duration as the timeline uses it: NaN and <= 0 are 0, anything
+// above Scheduler::kMaxWaitSeconds (including inf) is that, so the
+// conversion to ns never overflows.
+double   wait_seconds(double seconds);
+uint64_t wait_ns(double seconds);
+
+struct ScheduleStats {
+    uint64_t waits         = 0;
+    int64_t  mean_error_ns = 0; // wake - deadline; positive = late
+    int64_t  min_error_ns  = 0;
+    int64_t  max_error_ns  = 0;
+    uint64_t stddev_ns     = 0;
+};
+
+class Scheduler {
+public:
+    static Scheduler& instance();
+
+    // A timeline further behind than this restarts at now, so an idle
+    // gap between runs never turns into a burst of catch-up events.
+    static constexpr uint64_t kStaleNs = 50'000'000;
+
+    // Longest single wait a script may ask for; longer (or non-finite)
+    // durations are rejected or clamped before they reach the timeline.
+    static constexpr double kMaxWaitSeconds = 3600;
+
+    // Waits until an absolute monotonic_ns deadline; returns the wake
+    // error in ns (positive = late). Does not touch the timeline.
+    int64_t wait_until(uint64_t deadline_ns);
+
+    // Advances the calling thread's timeline by `seconds` (<= 0 waits
+    // for the current deadline only) and waits for it.
+    int64_t wait(double seconds);
+
+    // The thread's deadline after the stale-restart rule: where a run
+    // scheduled against this timeline starts.
+    uint64_t anchor();
+
+    // Moves the thread's deadline forward to `deadline_ns` (never back).
+    void advance_to(uint64_t deadline_ns);
+
+    // The calling thread's current deadline (0 before its first wait).
+    uint64_t deadline() const;
+
+    ScheduleStats stats();
+    void          reset_stats();
+
+private:
+    Scheduler() = default;
+
+    void record(int64_t error_ns);
+
+    std::mutex mutex_;
+    uint64_t   waits_   = 0;
+    double     sum_     = 0; // of error_ns
+    double     sum_sq_  = 0;
+    int64_t    min_     = 0;
+    int64_t    max_     = 0;
+};
+
+} // namespace neuro
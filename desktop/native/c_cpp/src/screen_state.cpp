@@ -0,0 +1,143 @@
+#include "screen_state.hpp"
+
+#include <algorithm>
+
+namespace neuro {
+
+ScreenStateCache::ScreenStateCache(const ScreenCacheOptions& options)
+    : options_(options), history_(options.history), states_(options.capacity) {}
+
+Status ScreenStateCache::observe(const ImageView& image, uint64_t sequence, ScreenObservation& out) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (count_ && sequence == latest_.sequence) {
+        out = latest_;
+        return Status::Ok;
+    }
+
+    const uint32_t tile = options_.tile_size;
+    size_t tiles = ((static_cast<size_t>(image.width) + tile - 1) / tile)
+                 * ((static_cast<size_t>(image.height) + tile - 1) / tile);
+
+    Seen& seen = history_[head_];
+    seen.sequence   = sequence;
+    seen.width      = image.width;
+    seen.height     = image.height;
+    seen.frame_hash = perceptual_hash(image, 0, 0, image.width, image.height);
+    seen.tiles.resize(tiles);
+    tile_perceptual_hashes(image, tile, seen.tiles.data());
+
+    const Seen* previous = count_ ? &history_[(head_ + history_.size() - 1) % history_.size()] : nullptr;
+    uint32_t changed = previous && previous->width == seen.width && previous->height == seen.height
+                     ? distance(previous->tiles, seen.tiles)
+                     : static_cast<uint32_t>(tiles);
+
+    head_  = (head_ + 1) % history_.size();
+    count_ = std::min(count_ + 1, history_.size());
+
+    bool   known = false;
+    State& state = match_state(seen, known);
+
+    latest_.state          = state.id;
+    latest_.sequence       = sequence;
+    latest_.first_sequence = state.first_sequence;
+    latest_.value          = state.value;
+    latest_.frame_hash     = seen.frame_hash;
+    latest_.changed_tiles  = changed;
+    latest_.tile_count     = static_cast<uint32_t>(tiles);
+    latest_.known          = known;
+    out = latest_;
+    return Status::Ok;
+}
+
+Status ScreenStateCache::changed_since(uint64_t sequence, uint32_t& changed_tiles) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    const Seen* then = find(sequence);
+    if (!then) {
+        return Status::Unavailable;
+    }
+
+    const Seen& now = history_[(head_ + history_.size() - 1) % history_.size()];
+    changed_tiles = now.width == then->width && now.height == then->height
+                  ? distance(then->tiles, now.tiles)
+                  : static_cast<uint32_t>(now.tiles.size());
+    return Status::Ok;
+}
+
+Status ScreenStateCache::set_value(uint64_t state, uint64_t value) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (State& entry : states_) {
+        if (entry.id && entry.id == state) {
+            entry.value = value;
+            if (latest_.state == state) {
+                latest_.value = value;
+            }
+            return Status::Ok;
+        }
+    }
+    return Status::InvalidArgument;
+}
+
+uint32_t ScreenStateCache::distance(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) const {
+    uint32_t changed = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        changed += phash_distance(a[i], b[i]) > options_.threshold;
+    }
+    return changed;
+}
+
+const ScreenStateCache::Seen* ScreenStateCache::find(uint64_t sequence) const {
+    for (size_t i = 0; i < count_; ++i) {
+        const Seen& seen = history_[(head_ + history_.size() - 1 - i) % history_.size()];
+        if (seen.sequence == sequence) {
+            return &seen;
+        }
+        if (seen.sequence < sequence) {
+            break; // older from here on
+        }
+    }
+    return nullptr;
+}
+
+// The cached state every tile of `frame` is within threshold of, or a new
+// one in place of the least recently seen. States keep the tiles of the
+// frame that created them, so slow drift eventually makes a new state
+// rather than dragging the old one along.
+ScreenStateCache::State& ScreenStateCache::match_state(const Seen& frame, bool& known) {
+    State* victim = &states_.front();
+
+    for (State& state : states_) {
+        if (!state.id) {
+            if (victim->id) {
+                victim = &state;
+            }
+            continue;
+        }
+        if (state.width == frame.width && state.height == frame.height) {
+            bool same = true;
+            for (size_t i = 0; i < frame.tiles.size() && same; ++i) {
+                same = phash_distance(state.tiles[i], frame.tiles[i]) <= options_.threshold;
+            }
+            if (same) {
+                state.last_used = ++clock_;
+                known = true;
+                return state;
+            }
+        }
+        if (victim->id && state.last_used < victim->last_used) {
+            victim = &state;
+        }
+    }
+
+    known = false;
+    victim->id             = ++next_state_;
+    victim->first_sequence = frame.sequence;
+    victim->value          = 0;
+    victim->last_used      = ++clock_;
+    victim->frame_hash     = frame.frame_hash;
+    victim->width          = frame.width;
+    victim->height         = frame.height;
+    victim->tiles.assign(frame.tiles.begin(), frame.tiles.end());
+    return *victim;
+}
+
+} // namespace neuro
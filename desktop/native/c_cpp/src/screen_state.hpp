@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "kernels.hpp"
+#include "status.hpp"
+
+namespace neuro {
+
+struct ScreenCacheOptions {
+    uint32_t capacity  = 32; // distinct screen states remembered (LRU)
+    uint32_t tile_size = 64;
+    uint32_t history   = 64; // recent frames answerable by changed_since()
+    uint32_t threshold = 4;  // phash_distance above which a tile changed
+};
+
+struct ScreenObservation {
+    uint64_t state          = 0; // id of the matching cached state, 1-based
+    uint64_t sequence       = 0;
+    uint64_t first_sequence = 0; // first frame seen in this state
+    uint64_t value          = 0; // caller value attached to the state
+    uint64_t frame_hash     = 0;
+    uint32_t changed_tiles  = 0; // vs the previous observed frame
+    uint32_t tile_count     = 0;
+    bool     known          = false; // state was already cached
+};
+
+// -------------------------------------------------
+// Screen-state cache (C ABI nn_screen_cache_*)
+//
+// Perceptual hashes of observed frames, so callers can tell whether
+// anything changed meaningfully without looking at pixels again:
+//
+//  - a ring of the last `history` frames, for "how many tiles changed
+//    since frame N?";
+//  - an LRU of distinct screen states (every tile within `threshold` of
+//    a cached state = the same state), each able to carry a caller value
+//    such as the id of a vision result already computed for it.
+//
+// Storage is sized while the ring first fills (and again after a
+// resolution change); observing allocates nothing after that.
+// -------------------------------------------------
+
+class ScreenStateCache {
+public:
+    explicit ScreenStateCache(const ScreenCacheOptions& options);
+
+    // Hashes `image` (capture frame `sequence`). Re-observing the latest
+    // sequence reports it again without hashing.
+    Status observe(const ImageView& image, uint64_t sequence, ScreenObservation& out);
+
+    // Tiles that changed between frame `sequence` and the latest one.
+    // Unavailable when that frame is not in the history any more.
+    Status changed_since(uint64_t sequence, uint32_t& changed_tiles) const;
+
+    // InvalidArgument when the state has been evicted.
+    Status set_value(uint64_t state, uint64_t value);
+
+    const ScreenCacheOptions& options() const { return options_; }
+
+private:
+    struct Seen {
+        uint64_t              sequence   = 0;
+        uint64_t              frame_hash = 0;
+        int32_t               width      = 0;
+        int32_t               height     = 0;
+        std::vector<uint64_t> tiles;
+    };
+
+    struct State {
+        uint64_t              id             = 0; // 0 = unused entry
+        uint64_t              first_sequence = 0;
+        uint64_t              value          = 0;
+        uint64_t              last_used      = 0;
+        uint64_t              frame_hash     = 0;
+        int32_t               width          = 0;
+        int32_t               height         = 0;
+        std::vector<uint64_t> tiles;
+    };
+
+    // Caller holds mutex_.
+    uint32_t    distance(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) const;
+    const Seen* find(uint64_t sequence) const;
+    State&      match_state(const Seen& frame, bool& known);
+
+    const ScreenCacheOptions options_;
+
+    mutable std::mutex  mutex_;
+    std::vector<Seen>   history_; // ring, oldest overwritten
+    size_t              head_  = 0; // next slot to write
+    size_t              count_ = 0;
+    std::vector<State>  states_;
+    uint64_t            next_state_ = 0;
+    uint64_t            clock_      = 0;
+    ScreenObservation   latest_;
+};
+
+} // namespace neuro
@@ -0,0 +1,773 @@
+#include "script.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "matcher.hpp"
+#include "path.hpp"
+#include "scheduler.hpp"
+#include "spsc_queue.hpp"
+
+namespace neuro {
+
+// Keys in one SHORTCUT; the interpreter passes them on the stack.
+static constexpr uint32_t kMaxShortcutKeys = 16;
+
+// Compiled lines the streaming compiler may run ahead of the executor.
+static constexpr size_t kStreamDepth = 256;
+
+// Points one LINE / PATH may expand to.
+static constexpr int64_t kMaxPathPoints = 1 << 20;
+
+// Defaults of the Python controller methods the ops stand in for.
+static constexpr double kDefaultMoveSeconds = 0.1;
+static constexpr double kDefaultStepSeconds = 0.02;
+static constexpr int    kDefaultLineSteps   = 50;
+
+uint64_t script_hash(std::string_view text) {
+    // FNV-1a; the cache compares the full source on a hit anyway.
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (unsigned char c : text) {
+        h = (h ^ c) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+// =====================================================
+// Program
+// =====================================================
+
+const char* Program::string(uint32_t index, uint32_t* len) const {
+    if (index >= string_offsets_.size()) {
+        return nullptr;
+    }
+    if (len) {
+        *len = string_lengths_[index];
+    }
+    return pool_.data() + string_offsets_[index];
+}
+
+const Point* Program::points(uint32_t index) const {
+    return index < points_.size() ? points_.data() + index : nullptr;
+}
+
+void Program::append(const Program& chunk) {
+    auto strings = static_cast<uint32_t>(string_offsets_.size());
+    auto points  = static_cast<uint32_t>(points_.size());
+    auto pool    = static_cast<uint32_t>(pool_.size());
+
+    for (Op op : chunk.ops_) {
+        switch (op.code) {
+            case NN_OP_TYPE:
+            case NN_OP_PRESS:
+            case NN_OP_HOLD:
+            case NN_OP_RELEASE:
+            case NN_OP_SHORTCUT:
+            case NN_OP_CLICK_IMAGE:
+                op.index += strings;
+                break;
+            case NN_OP_PATH:
+                op.index += points;
+                break;
+        }
+        ops_.push_back(op);
+    }
+
+    pool_.insert(pool_.end(), chunk.pool_.begin(), chunk.pool_.end());
+    for (uint32_t offset : chunk.string_offsets_) {
+        string_offsets_.push_back(pool + offset);
+    }
+    string_lengths_.insert(string_lengths_.end(), chunk.string_lengths_.begin(),
+                           chunk.string_lengths_.end());
+    points_.insert(points_.end(), chunk.points_.begin(), chunk.points_.end());
+}
+
+// =====================================================
+// Compiler
+// =====================================================
+
+// Python's str.isspace() over ASCII, which is what strip() removes.
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'
+        || (c >= '\x1c' && c <= '\x1f');
+}
+
+// Line breaks recognised by str.splitlines() (ASCII subset).
+static bool is_line_break(char c) {
+    return c == '\n' || c == '\r' || c == '\v' || c == '\f' || (c >= '\x1c' && c <= '\x1e');
+}
+
+static std::string_view strip(std::string_view s) {
+    while (!s.empty() && is_space(s.front())) s.remove_prefix(1);
+    while (!s.empty() && is_space(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+class ScriptCompiler {
+public:
+    explicit ScriptCompiler(Program& program) : program_(&program) {}
+
+    Status compile(std::string_view text, ScriptError& error) {
+        return compile(text, error, [] { return true; });
+    }
+
+    // Calls `after_line()` once each command line has compiled; it may
+    // retarget() the compiler, or return false to stop early (Ok).
+    template <typename Fn>
+    Status compile(std::string_view text, ScriptError& error, Fn&& after_line) {
+        std::string_view rest = strip(text);
+
+        for (uint32_t line_no = 1; !rest.empty(); ++line_no) {
+            size_t end = 0;
+            while (end < rest.size() && !is_line_break(rest[end])) ++end;
+
+            std::string_view line = strip(rest.substr(0, end));
+            if (end < rest.size()) {
+                end += (rest[end] == '\r' && end + 1 < rest.size() && rest[end + 1] == '\n') ? 2 : 1;
+            }
+            rest.remove_prefix(end);
+
+            if (line.empty() || line.front() == '#') {
+                continue;
+            }
+
+            line_ = line_no;
+            if (!tokenize(line) || !compile_line()) {
+                error.line    = line_no;
+                error.message = std::move(message_);
+                return Status::Syntax;
+            }
+            if (!after_line()) {
+                break;
+            }
+        }
+        return Status::Ok;
+    }
+
+    // Continues into another program. Path limits still count the
+    // points compiled into the previous ones.
+    void retarget(Program& program) {
+        base_points_ += program_->points_.size();
+        program_ = &program;
+    }
+
+private:
+    Program*                 program_;
+    size_t                   base_points_ = 0;
+    std::vector<std::string> tokens_;
+    std::string              message_;
+    uint32_t                 line_ = 0;
+
+    bool fail(std::string message) {
+        message_ = std::move(message);
+        return false;
+    }
+
+    // shlex.split() in POSIX mode: whitespace-separated words, '...'
+    // literal, "..." with \" and \\ escapes, \x outside quotes.
+    bool tokenize(std::string_view line) {
+        tokens_.clear();
+        std::string token;
+        bool in_token = false;
+
+        for (size_t i = 0; i < line.size();) {
+            char c = line[i];
+
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                if (in_token) {
+                    tokens_.push_back(std::move(token));
+                    token.clear();
+                    in_token = false;
+                }
+                ++i;
+            } else if (c == '\'') {
+                size_t close = line.find('\'', i + 1);
+                if (close == std::string_view::npos) {
+                    return fail("No closing quotation");
+                }
+                token.append(line.substr(i + 1, close - i - 1));
+                in_token = true;
+                i = close + 1;
+            } else if (c == '"') {
+                for (++i;; ++i) {
+                    if (i >= line.size()) {
+                        return fail("No closing quotation");
+                    }
+                    if (line[i] == '"') {
+                        break;
+                    }
+                    if (line[i] == '\\' && i + 1 < line.size()
+                        && (line[i + 1] == '"' || line[i + 1] == '\\')) {
+                        ++i;
+                    }
+                    token.push_back(line[i]);
+                }
+                in_token = true;
+                ++i;
+            } else if (c == '\\') {
+                if (i + 1 >= line.size()) {
+                    return fail("No escaped character");
+                }
+                token.push_back(line[i + 1]);
+                in_token = true;
+                i += 2;
+            } else {
+                token.push_back(c);
+                in_token = true;
+                ++i;
+            }
+        }
+
+        if (in_token) {
+            tokens_.push_back(std::move(token));
+        }
+        return true;
+    }
+
+    // int() / float() on a token, with Python's messages.
+    bool to_int(const std::string& token, int32_t& out) {
+        const char* begin = token.c_str();
+        char* end = nullptr;
+        errno = 0;
+        long long value = std::strtoll(begin, &end, 10);
+        if (token.empty() || *end != '\0' || is_space(token.front())) {
+            return fail("invalid literal for int() with base 10: '" + token + "'");
+        }
+        if (errno == ERANGE || value < INT32_MIN || value > INT32_MAX) {
+            return fail("integer out of range: " + token);
+        }
+        out = static_cast<int32_t>(value);
+        return true;
+    }
+
+    bool to_float(const std::string& token, double& out) {
+        const char* begin = token.c_str();
+        char* end = nullptr;
+        out = std::strtod(begin, &end);
+        if (token.empty() || *end != '\0' || is_space(token.front())
+            || token.find_first_of("xX") != std::string::npos) {
+            return fail("could not convert string to float: '" + token + "'");
+        }
+        return true;
+    }
+
+    // A WAIT / MOVE duration. time.sleep() rejects the same values, and
+    // the native host would otherwise block the injecting thread on them.
+    bool to_seconds(const std::string& token, double& out) {
+        if (!to_float(token, out)) {
+            return false;
+        }
+        if (std::isnan(out)) {
+            return fail("Invalid value NaN (not a number)");
+        }
+        if (out < 0) {
+            return fail("sleep length must be non-negative");
+        }
+        if (out > Scheduler::kMaxWaitSeconds) {
+            return fail("duration out of range: " + token);
+        }
+        return true;
+    }
+
+    uint32_t add_string(std::string_view s) {
+        auto offset = static_cast<uint32_t>(program_->pool_.size());
+        program_->pool_.insert(program_->pool_.end(), s.begin(), s.end());
+        program_->pool_.push_back('\0');
+        program_->string_offsets_.push_back(offset);
+        program_->string_lengths_.push_back(static_cast<uint32_t>(s.size()));
+        return static_cast<uint32_t>(program_->string_offsets_.size() - 1);
+    }
+
+    Op& emit(uint16_t code) {
+        Op op = {};
+        op.code = code;
+        op.line = line_;
+        program_->ops_.push_back(op);
+        return program_->ops_.back();
+    }
+
+    // Runs one stroke through the path engine into the shared point
+    // buffer. Built apart so its first point is never merged into the
+    // previous op's last one.
+    template <typename Fn>
+    bool append_stroke(Fn&& fn) {
+        PathOptions options;
+        options.max_points = static_cast<size_t>(kMaxPathPoints) - base_points_ - program_->points_.size();
+
+        std::vector<Point> stroke;
+        PathBuilder builder(stroke, options);
+        if (!fn(builder)) {
+            return fail("path too long");
+        }
+        program_->points_.insert(program_->points_.end(), stroke.begin(), stroke.end());
+        return true;
+    }
+
+    bool to_button(const std::string& token, uint16_t& out) {
+        if (token == "left" || token == "primary") {
+            out = NN_BUTTON_LEFT;
+        } else if (token == "middle") {
+            out = NN_BUTTON_MIDDLE;
+        } else if (token == "right" || token == "secondary") {
+            out = NN_BUTTON_RIGHT;
+        } else {
+            return fail("unknown button: " + token);
+        }
+        return true;
+    }
+
+    bool normalized(const std::string& tx, const std::string& ty, Op& op) {
+        if (!to_float(tx, op.nx) || !to_float(ty, op.ny)) {
+            return false;
+        }
+        if (!std::isfinite(op.nx) || !std::isfinite(op.ny)) {
+            return fail("cannot convert float NaN or infinity to integer");
+        }
+        return true;
+    }
+
+    bool compile_line() {
+        if (tokens_.empty()) {
+            return true;
+        }
+
+        std::string cmd = tokens_[0];
+        for (char& c : cmd) {
+            if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+        }
+        const size_t n = tokens_.size();
+
+        // -------- Keyboard --------
+        if (cmd == "TYPE") {
+            if (n < 2) return fail("TYPE requires quoted text");
+            std::string text = tokens_[1];
+            for (size_t i = 2; i < n; ++i) {
+                text += ' ';
+                text += tokens_[i];
+            }
+            emit(NN_OP_TYPE).index = add_string(text);
+        } else if (cmd == "ENTER") {
+            emit(NN_OP_PRESS).index = add_string("enter");
+        } else if (cmd == "PRESS" || cmd == "HOLD" || cmd == "RELEASE") {
+            if (n != 2) return fail(cmd + " key");
+            uint16_t code = cmd == "PRESS" ? NN_OP_PRESS : cmd == "HOLD" ? NN_OP_HOLD : NN_OP_RELEASE;
+            emit(code).index = add_string(tokens_[1]);
+        } else if (cmd == "SHORTCUT") {
+            if (n < 2) return fail("SHORTCUT key1 key2 ...");
+            if (n - 1 > kMaxShortcutKeys) return fail("SHORTCUT takes at most 16 keys");
+            uint32_t first = add_string(tokens_[1]);
+            for (size_t i = 2; i < n; ++i) {
+                add_string(tokens_[i]);
+            }
+            Op& op = emit(NN_OP_SHORTCUT);
+            op.index = first;
+            op.count = static_cast<uint32_t>(n - 1);
+        }
+
+        // -------- Mouse --------
+        else if (cmd == "MOVE") {
+            if (n != 3 && n != 4) return fail("MOVE x y [duration]");
+            int32_t x, y;
+            double seconds = kDefaultMoveSeconds;
+            if (!to_int(tokens_[1], x) || !to_int(tokens_[2], y)
+                || (n == 4 && !to_seconds(tokens_[3], seconds))) {
+                return false;
+            }
+            Op& op = emit(NN_OP_MOVE);
+            op.x = x;
+            op.y = y;
+            op.seconds = seconds;
+        } else if (cmd == "MOVE_N") {
+            if (n != 3) return fail("MOVE_N nx ny");
+            Op op = {};
+            if (!normalized(tokens_[1], tokens_[2], op)) return false;
+            Op& out = emit(NN_OP_MOVE_N);
+            out.nx = op.nx;
+            out.ny = op.ny;
+            out.seconds = kDefaultMoveSeconds;
+        } else if (cmd == "CLICK") {
+            if (n != 3 && n != 4) return fail("CLICK x y [button]");
+            int32_t x, y;
+            uint16_t button = NN_BUTTON_LEFT;
+            if (!to_int(tokens_[1], x) || !to_int(tokens_[2], y)
+                || (n == 4 && !to_button(tokens_[3], button))) {
+                return false;
+            }
+            Op& op = emit(NN_OP_CLICK);
+            op.x = x;
+            op.y = y;
+            op.button = button;
+        } else if (cmd == "CLICK_N") {
+            if (n != 3) return fail("CLICK_N nx ny");
+            Op op = {};
+            if (!normalized(tokens_[1], tokens_[2], op)) return false;
+            Op& out = emit(NN_OP_CLICK_N);
+            out.nx = op.nx;
+            out.ny = op.ny;
+            out.button = NN_BUTTON_LEFT;
+        } else if (cmd == "CLICK_IMAGE") {
+            if (n < 2 || n > 4) return fail("CLICK_IMAGE template [button] [threshold]");
+            uint16_t button = NN_BUTTON_LEFT;
+            double threshold = 0;
+            if ((n >= 3 && !to_button(tokens_[2], button)) || (n == 4 && !to_float(tokens_[3], threshold))) {
+                return false;
+            }
+            if (!(threshold >= 0 && threshold <= 1)) return fail("threshold must be between 0 and 1");
+            Op& op = emit(NN_OP_CLICK_IMAGE);
+            op.index  = add_string(tokens_[1]);
+            op.button = button;
+            op.nx     = threshold;
+        } else if (cmd == "LINE") {
+            if (n < 5) return fail("LINE x1 y1 x2 y2 [STEPS n]");
+            Point a, b;
+            if (!to_int(tokens_[1], a.x) || !to_int(tokens_[2], a.y)
+                || !to_int(tokens_[3], b.x) || !to_int(tokens_[4], b.y)) {
+                return false;
+            }
+
+            int32_t steps = kDefaultLineSteps;
+            auto it = std::find(tokens_.begin(), tokens_.end(), "STEPS");
+            if (it != tokens_.end()) {
+                if (it + 1 == tokens_.end()) return fail("list index out of range");
+                if (!to_int(*(it + 1), steps)) return false;
+            }
+
+            auto first = static_cast<uint32_t>(program_->points_.size());
+            if (steps == 0) return fail("division by zero");
+            if (!append_stroke([&](PathBuilder& path) { return path.line_steps(a, b, steps); })) {
+                return false;
+            }
+            emit_path(first);
+        } else if (cmd == "PATH") {
+            if ((n - 1) % 2 != 0) return fail("PATH requires even number of coordinates");
+            std::vector<Point> corners((n - 1) / 2);
+            for (size_t i = 0; i < corners.size(); ++i) {
+                if (!to_int(tokens_[1 + 2 * i], corners[i].x)
+                    || !to_int(tokens_[2 + 2 * i], corners[i].y)) {
+                    return false;
+                }
+            }
+
+            auto first = static_cast<uint32_t>(program_->points_.size());
+            // MouseController.draw_polyline(): adaptive density, shared joints.
+            if (!append_stroke([&](PathBuilder& path) { return path.polyline(corners.data(), corners.size()); })) {
+                return false;
+            }
+            emit_path(first);
+        }
+
+        // -------- Shared --------
+        else if (cmd == "WAIT") {
+            if (n != 2) return fail("WAIT seconds");
+            double seconds;
+            if (!to_seconds(tokens_[1], seconds)) return false;
+            emit(NN_OP_WAIT).seconds = seconds;
+        } else {
+            return fail("Unknown command: " + cmd);
+        }
+        return true;
+    }
+
+    void emit_path(uint32_t first) {
+        Op& op = emit(NN_OP_PATH);
+        op.index   = first;
+        op.count   = static_cast<uint32_t>(program_->points_.size() - first);
+        op.seconds = kDefaultStepSeconds;
+    }
+};
+
+Status compile_script(std::string_view text, ProgramPtr& out, ScriptError& error) {
+    auto program = std::make_shared<Program>();
+    program->hash_   = script_hash(text);
+    program->source_ = std::string(text);
+
+    Status status = ScriptCompiler(*program).compile(text, error);
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    out = std::move(program);
+    return Status::Ok;
+}
+
+// =====================================================
+// Interpreter
+// =====================================================
+
+static int32_t to_pixel(double n, int32_t extent) {
+    double v = std::trunc(n * extent);
+    return static_cast<int32_t>(std::max<double>(INT32_MIN, std::min<double>(INT32_MAX, v)));
+}
+
+Status run_script(const Program& program, const ScriptHost& host) {
+    void* user = host.user;
+
+    // Queried lazily, once per run, for MOVE_N / CLICK_N.
+    int32_t width = -1, height = -1;
+    auto screen = [&]() -> Status {
+        if (width >= 0) return Status::Ok;
+        if (!host.screen_size) return Status::Unavailable;
+        return static_cast<Status>(host.screen_size(user, &width, &height));
+    };
+
+    for (const Op& op : program.ops()) {
+        nn_status result = NN_OK;
+
+        switch (op.code) {
+            case NN_OP_TYPE: {
+                if (!host.type_text) return Status::Unavailable;
+                uint32_t len = 0;
+                const char* text = program.string(op.index, &len);
+                result = host.type_text(user, text, len);
+                break;
+            }
+            case NN_OP_PRESS:
+            case NN_OP_HOLD:
+            case NN_OP_RELEASE:
+                if (!host.key) return Status::Unavailable;
+                result = host.key(user, op.code, program.string(op.index, nullptr));
+                break;
+
+            case NN_OP_SHORTCUT: {
+                if (!host.shortcut) return Status::Unavailable;
+                const char* keys[kMaxShortcutKeys];
+                for (uint32_t i = 0; i < op.count; ++i) {
+                    keys[i] = program.string(op.index + i, nullptr);
+                }
+                result = host.shortcut(user, keys, op.count);
+                break;
+            }
+            case NN_OP_MOVE:
+                if (!host.move) return Status::Unavailable;
+                result = host.move(user, op.x, op.y, op.seconds);
+                break;
+
+            case NN_OP_CLICK:
+                if (!host.click) return Status::Unavailable;
+                result = host.click(user, op.x, op.y, op.button);
+                break;
+
+            case NN_OP_MOVE_N:
+            case NN_OP_CLICK_N: {
+                Status status = screen();
+                if (status != Status::Ok) return status;
+
+                int32_t x = to_pixel(op.nx, width);
+                int32_t y = to_pixel(op.ny, height);
+                if (op.code == NN_OP_MOVE_N) {
+                    if (!host.move) return Status::Unavailable;
+                    result = host.move(user, x, y, op.seconds);
+                } else {
+                    if (!host.click) return Status::Unavailable;
+                    result = host.click(user, x, y, op.button);
+                }
+                break;
+            }
+            case NN_OP_CLICK_IMAGE: {
+                // Resolved here rather than by the host, so every host
+                // (native injector, Python controllers) gets it.
+                if (!host.click) return Status::Unavailable;
+                // The earlier ops have to be on screen before it is grabbed.
+                if (host.flush && (result = host.flush(user)) != NN_OK) break;
+                MatchOptions options = {};
+                options.threshold = op.nx;
+                Match match;
+                Status status = TemplateMatcher::instance().locate(program.string(op.index, nullptr), options, match);
+                if (status != Status::Ok) return status;
+                result = host.click(user, match.x + match.width / 2, match.y + match.height / 2, op.button);
+                break;
+            }
+            case NN_OP_PATH:
+                if (!host.path) return Status::Unavailable;
+                result = host.path(user, op.count ? program.points(op.index) : nullptr,
+                                   op.count, op.seconds);
+                break;
+
+            case NN_OP_WAIT:
+                if (!host.wait) return Status::Unavailable;
+                result = host.wait(user, op.seconds);
+                break;
+
+            default:
+                return Status::InvalidArgument;
+        }
+
+        if (result != NN_OK) {
+            return static_cast<Status>(result);
+        }
+    }
+    return Status::Ok;
+}
+
+// =====================================================
+// Streaming
+// =====================================================
+
+Status stream_script(std::string_view text, const ScriptHost& host, const std::function<Status()>& idle,
+                     ScriptError& error) {
+    ProgramPtr cached;
+    if (ScriptCache::instance().find(text, cached)) {
+        return run_script(*cached, host);
+    }
+
+    SpscQueue<std::unique_ptr<Program>> queue(kStreamDepth);
+    std::atomic<bool> done{false};
+    std::atomic<bool> stop{false};
+    Status     compiled = Status::Ok;
+    ScriptError failure;
+
+    // Either side blocks here rather than spinning: the compiler while
+    // the queue is full (the executor sits in a long WAIT), the executor
+    // while it is empty (the compiler is behind).
+    std::mutex              bell_mutex;
+    std::condition_variable bell;
+    auto ring = [&] {
+        { std::lock_guard<std::mutex> guard(bell_mutex); }
+        bell.notify_all();
+    };
+
+    // Compiler: one chunk per command line, merged into the program
+    // that goes into the cache once the whole script has compiled.
+    std::thread compiler_thread([&] {
+        auto program = std::make_shared<Program>();
+        program->hash_   = script_hash(text);
+        program->source_ = std::string(text);
+
+        auto chunk = std::make_unique<Program>();
+        ScriptCompiler compiler(*chunk);
+        compiled = compiler.compile(text, failure, [&] {
+            program->append(*chunk);
+            while (!queue.push(std::move(chunk))) {
+                std::unique_lock<std::mutex> lock(bell_mutex);
+                bell.wait(lock, [&] { return !queue.full() || stop.load(std::memory_order_relaxed); });
+                if (stop.load(std::memory_order_relaxed)) {
+                    return false;
+                }
+            }
+            ring();
+            chunk = std::make_unique<Program>();
+            compiler.retarget(*chunk);
+            return true;
+        });
+
+        done.store(true, std::memory_order_release);
+        ring();
+        if (compiled == Status::Ok && !stop.load(std::memory_order_relaxed)) {
+            ScriptCache::instance().insert(std::move(program));
+        }
+    });
+
+    // Executor: this thread, running each chunk as soon as it lands.
+    Status status = Status::Ok;
+    std::unique_ptr<Program> chunk;
+    while (status == Status::Ok) {
+        if (queue.pop(chunk)) {
+            ring();
+            status = run_script(*chunk, host);
+            continue;
+        }
+        if (done.load(std::memory_order_acquire)) {
+            if (queue.empty()) {
+                break; // every push happens before `done`
+            }
+            continue;
+        }
+        // Caught up with the compiler: let anything held back go now.
+        if (idle && (status = idle()) != Status::Ok) {
+            break;
+        }
+        std::unique_lock<std::mutex> lock(bell_mutex);
+        bell.wait(lock, [&] { return !queue.empty() || done.load(std::memory_order_acquire); });
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    ring();
+    compiler_thread.join();
+
+    if (status != Status::Ok) {
+        return status;
+    }
+    if (compiled != Status::Ok) {
+        error = std::move(failure);
+    }
+    return compiled;
+}
+
+// =====================================================
+// Cache
+// =====================================================
+
+ScriptCache& ScriptCache::instance() {
+    static ScriptCache cache;
+    return cache;
+}
+
+bool ScriptCache::find(std::string_view text, ProgramPtr& out) {
+    uint64_t hash = script_hash(text);
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = index_.find(hash);
+    if (it != index_.end() && (*it->second)->source_ == text) {
+        order_.splice(order_.begin(), order_, it->second);
+        ++hits_;
+        out = *it->second;
+        return true;
+    }
+    ++misses_;
+    return false;
+}
+
+void ScriptCache::insert(ProgramPtr program) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = index_.find(program->hash());
+    if (it != index_.end()) {
+        order_.erase(it->second);
+        index_.erase(it);
+    }
+    order_.push_front(program);
+    index_[program->hash()] = order_.begin();
+
+    if (order_.size() > kCapacity) {
+        index_.erase(order_.back()->hash());
+        order_.pop_back();
+    }
+}
+
+Status ScriptCache::compile(std::string_view text, ProgramPtr& out, ScriptError& error) {
+    if (find(text, out)) {
+        return Status::Ok;
+    }
+
+    // Compile outside the lock; a racing duplicate just replaces the entry.
+    ProgramPtr program;
+    Status status = compile_script(text, program, error);
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    insert(program);
+    out = std::move(program);
+    return Status::Ok;
+}
+
+void ScriptCache::stats(uint64_t& hits, uint64_t& misses, uint32_t& entries) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    hits    = hits_;
+    misses  = misses_;
+    entries = static_cast<uint32_t>(order_.size());
+}
+
+void ScriptCache::clear() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    order_.clear();
+    index_.clear();
+}
+
+} // namespace neuro
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "status.hpp"
+
+namespace neuro {
+
+// ABI-identical views of the bytecode (see neuro_native.h).
+using Op         = nn_op;
+using Point      = nn_point;
+using ScriptHost = nn_script_host;
+
+struct ScriptError {
+    uint32_t    line = 0;
+    std::string message;
+};
+
+// -------------------------------------------------
+// Compiled action script
+//
+// Flat op array plus two pools: NUL-terminated strings (text, keys) and
+// points (LINE / PATH, expanded at compile time). Immutable once built,
+// so the cache hands the same program to any number of runs.
+// -------------------------------------------------
+
+class Program {
+public:
+    uint64_t hash() const { return hash_; }
+    const std::vector<Op>& ops() const { return ops_; }
+
+    const char*  string(uint32_t index, uint32_t* len) const;
+    const Point* points(uint32_t index) const;
+
+    size_t string_count() const { return string_offsets_.size(); }
+    size_t point_count() const { return points_.size(); }
+
+private:
+    friend class ScriptCompiler;
+    friend class ScriptCache;
+    friend Status compile_script(std::string_view, std::shared_ptr<const Program>&, ScriptError&);
+    friend Status stream_script(std::string_view, const ScriptHost&, const std::function<Status()>&,
+                                ScriptError&);
+
+    // Merges a separately compiled run of ops onto the end.
+    void append(const Program& chunk);
+
+    uint64_t              hash_ = 0;
+    std::string           source_;
+    std::vector<Op>       ops_;
+    std::vector<char>     pool_;
+    std::vector<uint32_t> string_offsets_;
+    std::vector<uint32_t> string_lengths_;
+    std::vector<Point>    points_;
+};
+
+using ProgramPtr = std::shared_ptr<const Program>;
+
+uint64_t script_hash(std::string_view text);
+
+// Uncached compile. Status::Syntax fills `error`.
+Status compile_script(std::string_view text, ProgramPtr& out, ScriptError& error);
+
+// Interprets `program` against `host`, stopping at the first failure.
+Status run_script(const Program& program, const ScriptHost& host);
+
+// Compile and run pipelined (C ABI nn_script_stream). A compiler thread
+// feeds each line's ops through a lock-free queue while this thread
+// runs them, so the first input goes out before the rest is parsed;
+// `idle` (optional) is called whenever the executor has caught up.
+// Ops before a syntax error have already run when Status::Syntax comes
+// back. A cached script just runs; a new one is cached once it
+// has compiled completely.
+Status stream_script(std::string_view text, const ScriptHost& host, const std::function<Status()>& idle,
+                     ScriptError& error);
+
+// -------------------------------------------------
+// Process-wide LRU of compiled scripts, keyed by source hash
+// -------------------------------------------------
+
+class ScriptCache {
+public:
+    static constexpr size_t kCapacity = 64;
+
+    static ScriptCache& instance();
+
+    Status compile(std::string_view text, ProgramPtr& out, ScriptError& error);
+
+    // Lookup (counted as a hit or miss) / store without compiling.
+    bool find(std::string_view text, ProgramPtr& out);
+    void insert(ProgramPtr program);
+
+    void stats(uint64_t& hits, uint64_t& misses, uint32_t& entries) const;
+    void clear();
+
+private:
+    using Order = std::list<ProgramPtr>;
+
+    mutable std::mutex                      mutex_;
+    Order                                   order_; // most recent first
+    std::unordered_map<uint64_t, Order::iterator> index_;
+    uint64_t                                hits_   = 0;
+    uint64_t                                misses_ = 0;
+};
+
+} // namespace neuro
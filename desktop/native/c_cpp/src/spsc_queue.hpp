@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace neuro {
+
+// -------------------------------------------------
+// Bounded lock-free single-producer / single-consumer queue
+//
+// One thread push()es, one thread pop()s; neither ever blocks; a full
+// or empty queue just returns false. Each index is written by one side
+// only and published with release/acquire, so a popped value is fully
+// visible to the consumer.
+// -------------------------------------------------
+
+template <typename T>
+class SpscQueue {
+public:
+    // Capacity is rounded up to a power of two.
+    explicit SpscQueue(size_t capacity) {
+        size_t n = 1;
+        while (n < capacity) n <<= 1;
+        mask_  = n - 1;
+        slots_ = std::make_unique<T[]>(n);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer. `value` is only moved from when this returns true.
+    bool push(T&& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) > mask_) {
+            return false;
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer.
+    bool pop(T& out) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    bool full() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire) > mask_;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    size_t               mask_;
+    std::unique_ptr<T[]> slots_;
+
+    alignas(64) std::atomic<size_t> head_{0}; // next slot to pop
+    alignas(64) std::atomic<size_t> tail_{0}; // next slot to push
+};
+
+} // namespace neuro
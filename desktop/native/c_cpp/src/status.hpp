@@ -0,0 +1,23 @@
+#pragma once
+
+#include "neuro_native.h"
+
+namespace neuro {
+
+// Mirrors the NN_* codes so internal code and the C ABI never disagree.
+enum class Status : nn_status {
+    Ok              = NN_OK,
+    Unavailable     = NN_ERR_UNAVAILABLE,
+    InvalidArgument = NN_ERR_INVALID_ARGUMENT,
+    Busy            = NN_ERR_BUSY,
+    Timeout         = NN_ERR_TIMEOUT,
+    Failed          = NN_ERR_FAILED,
+    Syntax          = NN_ERR_SYNTAX,
+    Cancelled       = NN_ERR_CANCELLED,
+};
+
+inline nn_status to_c(Status status) {
+    return static_cast<nn_status>(status);
+}
+
+} // namespace neuro
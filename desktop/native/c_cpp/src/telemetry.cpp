@@ -0,0 +1,102 @@
+#include "telemetry.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include "clock.hpp"
+#include "history.hpp"
+
+namespace neuro {
+
+// Slot versions: 0 = never written, odd = being written, even = holds the
+// record whose sequence is version / 2.
+
+static size_t round_up_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+TelemetryRing::TelemetryRing(size_t capacity, int journal)
+    : mask_(round_up_pow2(std::max<size_t>(capacity, 2)) - 1),
+      journal_(journal),
+      records_(new Record[mask_ + 1]()),
+      versions_(new std::atomic<uint64_t>[mask_ + 1]) {
+    for (size_t i = 0; i <= mask_; ++i) {
+        versions_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t TelemetryRing::push(const Record& record) {
+    uint64_t sequence = head_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    size_t   index    = static_cast<size_t>(sequence - 1) & mask_;
+
+    std::atomic<uint64_t>& version = versions_[index];
+    uint64_t writing = sequence * 2 - 1;
+
+    // Claim the slot. Only a producer that lapped the whole ring can be
+    // here at the same time; if a newer one already holds it, drop ours.
+    uint64_t current = version.load(std::memory_order_acquire);
+    for (;;) {
+        if (current & 1) {
+            std::this_thread::yield();
+            current = version.load(std::memory_order_acquire);
+            continue;
+        }
+        if (current > writing) {
+            return sequence;
+        }
+        if (version.compare_exchange_weak(current, writing, std::memory_order_acq_rel)) {
+            break;
+        }
+    }
+
+    Record entry = record;
+    entry.sequence = sequence;
+    if (entry.timestamp_ns == 0) {
+        entry.timestamp_ns = monotonic_ns();
+    }
+    std::memcpy(&records_[index], &entry, sizeof(Record));
+
+    version.store(sequence * 2, std::memory_order_release);
+
+    if (journal_ >= 0 && History::enabled()) {
+        History::append(static_cast<uint32_t>(journal_), entry);
+    }
+    return sequence;
+}
+
+size_t TelemetryRing::snapshot(uint64_t since, Record* out, size_t max) const {
+    uint64_t head  = head_.load(std::memory_order_acquire);
+    uint64_t floor = std::max(since, floor_.load(std::memory_order_acquire));
+    if (floor >= head) {
+        return 0;
+    }
+
+    uint64_t first = head > capacity() ? head - capacity() : 0;
+    first = std::max(first, floor);
+    if (head - first > max) {
+        first = head - max;
+    }
+
+    size_t copied = 0;
+    for (uint64_t position = first; position < head; ++position) {
+        size_t   index    = static_cast<size_t>(position) & mask_;
+        uint64_t expected = (position + 1) * 2;
+
+        if (versions_[index].load(std::memory_order_acquire) != expected) {
+            continue; // still being written, or already overwritten
+        }
+
+        std::memcpy(&out[copied], &records_[index], sizeof(Record));
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (versions_[index].load(std::memory_order_relaxed) == expected) {
+            ++copied;
+        }
+    }
+    return copied;
+}
+
+} // namespace neuro
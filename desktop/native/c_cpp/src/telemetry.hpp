@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "neuro_native.h"
+
+namespace neuro {
+
+// Fixed 64-byte record, identical to nn_record on the ABI.
+using Record = nn_record;
+
+static_assert(sizeof(Record) == 64, "telemetry records are one cache line");
+
+// -------------------------------------------------
+// Lock-free multi-producer telemetry ring
+//
+// Producers claim a position with one fetch_add and publish the slot
+// through a per-slot version (seqlock), overwriting the oldest record
+// once full. Readers never block producers: snapshot() copies whatever
+// is stable and skips slots that are mid-write.
+//
+// A ring with a journal channel (the shared NN_CHANNEL_* rings) also
+// appends every record to the history log while one is started.
+// -------------------------------------------------
+
+class TelemetryRing {
+public:
+    // Capacity is rounded up to a power of two.
+    explicit TelemetryRing(size_t capacity, int journal = -1);
+
+    TelemetryRing(const TelemetryRing&) = delete;
+    TelemetryRing& operator=(const TelemetryRing&) = delete;
+
+    // Copies `record` in, assigning its sequence (and timestamp when 0).
+    // Returns the sequence number, 1-based.
+    uint64_t push(const Record& record);
+
+    // Copies up to `max` of the newest records with sequence > since, in
+    // order, into `out`. Returns the number copied.
+    size_t snapshot(uint64_t since, Record* out, size_t max) const;
+
+    // Records pushed so far (== sequence of the newest record).
+    uint64_t head() const { return head_.load(std::memory_order_acquire); }
+
+    // Hides everything pushed so far from later snapshots.
+    void clear() { floor_.store(head(), std::memory_order_release); }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    size_t                                 mask_;
+    int                                    journal_;
+    std::unique_ptr<Record[]>              records_;
+    std::unique_ptr<std::atomic<uint64_t>[]> versions_;
+
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> floor_{0};
+};
+
+} // namespace neuro
@@ -0,0 +1,214 @@
+#include "timeline.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+#include "scheduler.hpp"
+
+namespace neuro {
+
+template <typename Fn>
+Status Timeline::append(uint32_t lane, Fn&& fn) {
+    if (lane >= kLanes) {
+        return Status::InvalidArgument;
+    }
+
+    InputInjector& injector = InputInjector::instance();
+    std::lock_guard<std::mutex> guard(injector.mutex_);
+    Status status = injector.open_locked();
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    staged_.clear();
+    status = fn(injector, cursor_[lane]);
+    staged_.clear();
+    return status;
+}
+
+void Timeline::emit(uint64_t due_ns) {
+    for (const InputEvent& event : staged_) {
+        entries_.push_back({due_ns, event});
+    }
+    staged_.clear();
+}
+
+// -------------------------------------------------
+// Keyboard
+// -------------------------------------------------
+
+Status Timeline::key(uint32_t lane, std::string_view name, uint32_t action) {
+    return append(lane, [&](InputInjector& injector, uint64_t& cursor) {
+        injector.append_key(staged_, name, action);
+        emit(cursor);
+        return Status::Ok;
+    });
+}
+
+Status Timeline::hotkey(uint32_t lane, const char* const* keys, uint32_t count) {
+    return append(lane, [&](InputInjector& injector, uint64_t& cursor) {
+        injector.append_hotkey(staged_, keys, count);
+        emit(cursor);
+        return Status::Ok;
+    });
+}
+
+Status Timeline::type(uint32_t lane, std::string_view utf8, double interval_seconds) {
+    return append(lane, [&](InputInjector& injector, uint64_t& cursor) {
+        uint64_t interval = wait_ns(interval_seconds);
+        if (!interval) {
+            injector.append_text(staged_, clips_, utf8);
+            emit(cursor); // unpaced text: one entry group
+            return Status::Ok;
+        }
+        for (size_t i = 0; i < utf8.size();) {
+            injector.append_char(staged_, next_codepoint(utf8, i));
+            if (!staged_.empty()) {
+                emit(cursor);
+                cursor += interval;
+            }
+        }
+        return Status::Ok;
+    });
+}
+
+// -------------------------------------------------
+// Mouse
+// -------------------------------------------------
+
+Status Timeline::move(uint32_t lane, int32_t x, int32_t y, double seconds) {
+    seconds = wait_seconds(seconds);
+    return append(lane, [&](InputInjector& injector, uint64_t& cursor) {
+        injector.clamp(x, y);
+
+        int32_t from_x = pointer_x_, from_y = pointer_y_;
+        bool tween = seconds > kMinTweenSeconds &&
+                     (have_pointer_ || injector.platform_.cursor(from_x, from_y) == Status::Ok);
+
+        if (!tween) {
+            injector.append_move(staged_, x, y);
+            emit(cursor);
+        } else {
+            // Same linear tween as InputInjector::move, one entry per step.
+            int steps = std::max(1, static_cast<int>(seconds / kTweenStepSeconds));
+            uint64_t step_ns = wait_ns(seconds / steps);
+            for (int i = 1; i <= steps; ++i) {
+                double t = static_cast<double>(i) / steps;
+                injector.append_move(staged_, static_cast<int32_t>(from_x + (x - from_x) * t),
+                                     static_cast<int32_t>(from_y + (y - from_y) * t));
+                emit(cursor);
+                cursor += step_ns;
+            }
+        }
+
+        have_pointer_ = true;
+        pointer_x_ = x;
+        pointer_y_ = y;
+        return Status::Ok;
+    });
+}
+
+Status Timeline::click(uint32_t lane, int32_t x, int32_t y, uint32_t button) {
+    return append(lane, [&](InputInjector& injector, uint64_t& cursor) {
+        Status status = injector.append_click(staged_, x, y, button);
+        if (status != Status::Ok) {
+            return status;
+        }
+        emit(cursor);
+
+        injector.clamp(x, y);
+        have_pointer_ = true;
+        pointer_x_ = x;
+        pointer_y_ = y;
+        return Status::Ok;
+    });
+}
+
+Status Timeline::path(uint32_t lane, const nn_point* points, uint32_t count, double step_seconds) {
+    return append(lane, [&](InputInjector& injector, uint64_t& cursor) {
+        uint64_t step = wait_ns(step_seconds);
+        for (uint32_t i = 0; i < count; ++i) {
+            injector.append_move(staged_, points[i].x, points[i].y);
+            emit(cursor);
+            cursor += step;
+        }
+
+        if (count) {
+            int32_t x = points[count - 1].x, y = points[count - 1].y;
+            injector.clamp(x, y);
+            have_pointer_ = true;
+            pointer_x_ = x;
+            pointer_y_ = y;
+        }
+        return Status::Ok;
+    });
+}
+
+// -------------------------------------------------
+// Timing
+// -------------------------------------------------
+
+Status Timeline::wait(uint32_t lane, double seconds) {
+    if (lane >= kLanes) {
+        return Status::InvalidArgument;
+    }
+    cursor_[lane] += wait_ns(seconds);
+    return Status::Ok;
+}
+
+void Timeline::sync(double seconds) {
+    uint64_t meet = duration_ns() + wait_ns(seconds);
+    std::fill(std::begin(cursor_), std::end(cursor_), meet);
+}
+
+uint64_t Timeline::duration_ns() const {
+    return *std::max_element(std::begin(cursor_), std::end(cursor_));
+}
+
+void Timeline::clear() {
+    entries_.clear();
+    clips_.clear();
+    std::fill(std::begin(cursor_), std::end(cursor_), 0);
+    have_pointer_ = false;
+}
+
+Status Timeline::run() {
+    std::stable_sort(entries_.begin(), entries_.end(),
+                     [](const Entry& a, const Entry& b) { return a.due_ns < b.due_ns; });
+
+    Scheduler& scheduler = Scheduler::instance();
+    InputInjector& injector = InputInjector::instance();
+    uint64_t base = scheduler.anchor();
+
+    Status status = Status::Ok;
+    std::vector<InputEvent> group;
+    for (size_t i = 0; i < entries_.size() && status == Status::Ok;) {
+        uint64_t due = entries_[i].due_ns;
+        group.clear();
+        for (; i < entries_.size() && entries_[i].due_ns == due; ++i) {
+            group.push_back(entries_[i].event);
+        }
+
+        if (due) {
+            scheduler.wait_until(base + due);
+        }
+        std::lock_guard<std::mutex> guard(injector.mutex_);
+        status = injector.open_locked();
+        if (status == Status::Ok) {
+            status = injector.send_locked(group.data(), group.size(), clips_);
+        }
+    }
+
+    // Trailing waits still count, and the next run continues from here.
+    uint64_t duration = duration_ns();
+    uint64_t last_due = entries_.empty() ? 0 : entries_.back().due_ns;
+    if (status == Status::Ok && duration > last_due) {
+        scheduler.wait_until(base + duration);
+    }
+    scheduler.advance_to(base + duration);
+
+    clear();
+    return status;
+}
+
+} // namespace neuro
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "input.hpp"
+#include "status.hpp"
+
+namespace neuro {
+
+// -------------------------------------------------
+// Merged input timeline (C ABI nn_timeline_*)
+//
+// Keyboard and mouse instructions on one time axis. Each lane (device
+// stream) has its own cursor: an instruction is stamped at its lane's
+// cursor and advances only that lane, so independent streams overlap
+// in time. sync() is the cross-lane barrier: every lane catches up to
+// the furthest one, then waits once. Paced instructions (tweens, paced
+// paths, typing intervals) expand into one entry per step.
+//
+// run() executes the whole thing on the calling thread in deadline
+// order (ties in insertion order) against its scheduler timeline, and
+// events due at the same instant go out as one send. Events are
+// resolved when added, like InputBatch. Not thread-safe.
+// -------------------------------------------------
+
+class Timeline {
+public:
+    static constexpr uint32_t kLanes = NN_LANE_COUNT;
+
+    Status key(uint32_t lane, std::string_view name, uint32_t action);
+    Status hotkey(uint32_t lane, const char* const* keys, uint32_t count);
+    Status type(uint32_t lane, std::string_view utf8, double interval_seconds);
+
+    Status move(uint32_t lane, int32_t x, int32_t y, double seconds);
+    Status click(uint32_t lane, int32_t x, int32_t y, uint32_t button);
+    Status path(uint32_t lane, const nn_point* points, uint32_t count, double step_seconds);
+
+    // Advances one lane only.
+    Status wait(uint32_t lane, double seconds);
+
+    // Barrier: all lanes meet at the latest cursor, then wait `seconds`.
+    void sync(double seconds);
+
+    // Offset of the furthest lane cursor from the start of the run.
+    uint64_t duration_ns() const;
+    size_t   size() const { return entries_.size(); }
+
+    // Executes and clears (also on failure).
+    Status run();
+    void   clear();
+
+private:
+    struct Entry {
+        uint64_t   due_ns; // offset from the start of the run
+        InputEvent event;
+    };
+
+    template <typename Fn>
+    Status append(uint32_t lane, Fn&& fn);
+
+    // Stamps the staged events at `due_ns` and clears the staging area.
+    void emit(uint64_t due_ns);
+
+    std::vector<Entry>      entries_;
+    std::vector<InputEvent> staged_;
+    std::string             clips_; // Paste texts
+    uint64_t                cursor_[kLanes] = {};
+
+    // Where the pointer will be once everything so far has run, so a
+    // tween starts from the previous move instead of the live cursor.
+    bool    have_pointer_ = false;
+    int32_t pointer_x_    = 0;
+    int32_t pointer_y_    = 0;
+};
+
+} // namespace neuro
@@ -0,0 +1,387 @@
+#include "ui_tree.hpp"
+
+#include <algorithm>
+
+namespace neuro {
+
+namespace {
+
+const char* const kRoleNames[NN_UI_ROLE_COUNT] = {
+    "unknown", "window", "dialog", "pane", "group", "button", "checkbox", "radio",
+    "combobox", "edit", "text", "link", "image", "list", "listitem", "menu",
+    "menubar", "menuitem", "tab", "tabitem", "tree", "treeitem", "table", "row",
+    "cell", "header", "toolbar", "statusbar", "scrollbar", "slider", "spinner", "progress",
+    "document", "heading", "separator", "tooltip", "titlebar",
+};
+
+const struct {
+    uint32_t    bit;
+    const char* name;
+} kStateNames[] = {
+    {NN_UI_STATE_FOCUSED, "focused"},     {NN_UI_STATE_DISABLED, "disabled"},
+    {NN_UI_STATE_SELECTED, "selected"},   {NN_UI_STATE_CHECKED, "checked"},
+    {NN_UI_STATE_EXPANDED, "expanded"},   {NN_UI_STATE_COLLAPSED, "collapsed"},
+    {NN_UI_STATE_PROTECTED, "protected"},
+};
+
+constexpr size_t kLineName    = 80; // bytes of a name kept on its line
+constexpr size_t kLineValue   = 40;
+constexpr size_t kMoreReserve = 24; // "... 4294967295 more\n"
+
+// Longest prefix of at most `max` bytes that ends on a UTF-8 boundary.
+size_t utf8_prefix(const std::string& text, size_t max) {
+    if (text.size() <= max) {
+        return text.size();
+    }
+    size_t n = max;
+    while (n > 0 && (static_cast<unsigned char>(text[n]) & 0xC0) == 0x80) {
+        --n;
+    }
+    return n;
+}
+
+void append_quoted(std::string& line, const std::string& text, size_t max) {
+    size_t n = utf8_prefix(text, max);
+    line += '"';
+    for (size_t i = 0; i < n; ++i) {
+        char c = text[i];
+        if (c == '"' || c == '\\') {
+            line += '\\';
+            line += c;
+        } else if (c == '\n' || c == '\r' || c == '\t') {
+            line += ' '; // one element, one line
+        } else {
+            line += c;
+        }
+    }
+    if (n < text.size()) {
+        line += "...";
+    }
+    line += '"';
+}
+
+// Unnamed containers carry no information of their own.
+bool structural(const UiNode& node) {
+    return (node.role == NN_UI_ROLE_PANE || node.role == NN_UI_ROLE_GROUP || node.role == NN_UI_ROLE_UNKNOWN)
+           && node.name.empty() && node.value.empty() && !(node.states & NN_UI_STATE_FOCUSED);
+}
+
+bool same(const UiNode& a, const UiNode& b) {
+    return a.role == b.role && a.states == b.states && a.bounds.x == b.bounds.x && a.bounds.y == b.bounds.y
+           && a.bounds.width == b.bounds.width && a.bounds.height == b.bounds.height && a.name == b.name
+           && a.value == b.value;
+}
+
+} // namespace
+
+const char* ui_role_name(uint32_t role) {
+    return kRoleNames[role < NN_UI_ROLE_COUNT ? role : static_cast<uint32_t>(NN_UI_ROLE_UNKNOWN)];
+}
+
+void ui_text(const UiSnapshot& snapshot, size_t capacity, std::string& out) {
+    out.clear();
+
+    // Open ancestors of the current element: their depth, the indent
+    // their children get (a folded container passes its own on), and
+    // whether they are offscreen.
+    struct Open {
+        uint32_t depth;
+        uint32_t child_indent;
+        bool     hidden;
+    };
+    std::vector<Open> open;
+    std::string       line;
+    size_t            skipped = 0;
+
+    for (const UiElement& element : snapshot.elements) {
+        const UiNode& node = element.node;
+        while (!open.empty() && open.back().depth >= element.depth) {
+            open.pop_back();
+        }
+        uint32_t indent = open.empty() ? 0 : open.back().child_indent;
+        bool     hidden = (node.states & NN_UI_STATE_OFFSCREEN) || (!open.empty() && open.back().hidden);
+        bool     fold   = !open.empty() && structural(node); // the window line always stays
+        open.push_back({element.depth, fold ? indent : indent + 1, hidden});
+        if (hidden || fold) {
+            continue;
+        }
+        if (skipped) {
+            ++skipped;
+            continue;
+        }
+
+        line.assign(static_cast<size_t>(indent) * 2, ' ');
+        line += ui_role_name(node.role);
+        if (!node.name.empty()) {
+            line += ' ';
+            append_quoted(line, node.name, kLineName);
+        }
+        if (!node.value.empty()) {
+            line += " = ";
+            append_quoted(line, node.value, kLineValue);
+        }
+        const char* separator = " (";
+        for (const auto& state : kStateNames) {
+            if (node.states & state.bit) {
+                line += separator;
+                line += state.name;
+                separator = ", ";
+            }
+        }
+        if (*separator == ',') {
+            line += ')';
+        }
+        line += '\n';
+
+        if (out.size() + line.size() + kMoreReserve > capacity) {
+            skipped = 1;
+            continue;
+        }
+        out += line;
+    }
+
+    if (skipped) {
+        std::string more = "... " + std::to_string(skipped) + " more\n";
+        if (out.size() + more.size() <= capacity) {
+            out += more;
+        }
+    }
+}
+
+// =====================================================
+// UiTree
+// =====================================================
+
+UiTree& UiTree::instance() {
+    static UiTree tree;
+    return tree;
+}
+
+Status UiTree::start() {
+    std::lock_guard<std::mutex> guard(control_);
+    if (running()) {
+        return Status::Busy;
+    }
+
+    clear();
+    dirty_ = true; // the first commit always publishes
+
+    Status status = platform_.start(*this);
+    running_.store(status == Status::Ok, std::memory_order_release);
+    return status;
+}
+
+void UiTree::stop() {
+    std::lock_guard<std::mutex> guard(control_);
+    if (!running()) {
+        return;
+    }
+
+    platform_.stop();
+    running_.store(false, std::memory_order_release);
+
+    // The version keeps counting, so a restarted tree never repeats one.
+    std::lock_guard<std::mutex> snapshot_guard(snapshot_mutex_);
+    snapshot_.reset();
+}
+
+UiSnapshotPtr UiTree::snapshot() const {
+    std::lock_guard<std::mutex> guard(snapshot_mutex_);
+    return snapshot_;
+}
+
+void UiTree::clip(UiNode& node) {
+    node.name.resize(utf8_prefix(node.name, kMaxText));
+    node.value.resize(utf8_prefix(node.value, kMaxText));
+    if (node.states & NN_UI_STATE_PROTECTED) {
+        node.value.clear();
+    }
+}
+
+void UiTree::clear() {
+    nodes_.clear();
+    root_      = 0;
+    window_    = 0;
+    focus_     = 0;
+    truncated_ = false;
+}
+
+void UiTree::erase_subtree(uint64_t id) {
+    std::vector<uint64_t> pending = {id};
+    while (!pending.empty()) {
+        auto it = nodes_.find(pending.back());
+        pending.pop_back();
+        if (it == nodes_.end()) {
+            continue;
+        }
+        pending.insert(pending.end(), it->second.children.begin(), it->second.children.end());
+        nodes_.erase(it);
+    }
+}
+
+void UiTree::insert(std::vector<UiNode>& nodes, size_t first) {
+    for (size_t i = first; i < nodes.size(); ++i) {
+        UiNode& node = nodes[i];
+        if (node.id == 0 || node.id == root_ || !contains(node.parent)) {
+            continue;
+        }
+        if (contains(node.id)) {
+            // Moved here (or listed twice): the old place goes, which may
+            // take the new parent with it.
+            remove(node.id);
+            if (!contains(node.parent)) {
+                continue;
+            }
+        }
+        if (nodes_.size() >= kMaxNodes) {
+            truncated_ = true;
+            break;
+        }
+
+        uint64_t id = node.id;
+        clip(node);
+        nodes_[node.parent].children.push_back(id);
+        nodes_.emplace(id, Entry{std::move(node), {}});
+    }
+}
+
+void UiTree::reset(uint64_t window, std::vector<UiNode> nodes) {
+    clear();
+    window_ = window;
+    dirty_  = true;
+    if (nodes.empty() || nodes[0].id == 0) {
+        return;
+    }
+
+    UiNode& root = nodes[0];
+    root.parent = 0;
+    root_       = root.id;
+    clip(root);
+    nodes_.emplace(root_, Entry{std::move(root), {}});
+    insert(nodes, 1);
+}
+
+bool UiTree::replace(std::vector<UiNode> nodes) {
+    if (nodes.empty()) {
+        return true;
+    }
+    auto it = nodes_.find(nodes[0].id);
+    if (it == nodes_.end()) {
+        return false;
+    }
+
+    Entry& entry = it->second;
+    for (uint64_t child : entry.children) {
+        erase_subtree(child);
+    }
+    entry.children.clear();
+
+    UiNode& root = nodes[0];
+    root.parent = entry.node.parent; // it keeps its place
+    clip(root);
+    entry.node = std::move(root);
+    if (entry.node.id == root_) {
+        truncated_ = false; // the whole window was walked again
+    }
+    insert(nodes, 1);
+    dirty_ = true;
+    return true;
+}
+
+void UiTree::update(const UiNode& node) {
+    auto it = nodes_.find(node.id);
+    if (it == nodes_.end()) {
+        return;
+    }
+
+    UiNode next = node;
+    next.parent = it->second.node.parent;
+    clip(next);
+    if (!same(it->second.node, next)) {
+        it->second.node = std::move(next);
+        dirty_          = true;
+    }
+}
+
+void UiTree::remove(uint64_t id) {
+    auto it = nodes_.find(id);
+    if (it == nodes_.end()) {
+        return;
+    }
+    if (id == root_) {
+        uint64_t window = window_;
+        clear();
+        window_ = window;
+        dirty_  = true;
+        return;
+    }
+
+    auto parent = nodes_.find(it->second.node.parent);
+    if (parent != nodes_.end()) {
+        auto& siblings = parent->second.children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), id), siblings.end());
+    }
+    erase_subtree(id);
+    dirty_ = true;
+}
+
+void UiTree::set_focus(uint64_t id) {
+    if (focus_ != id) {
+        focus_ = id;
+        dirty_ = true;
+    }
+}
+
+void UiTree::commit() {
+    if (!dirty_) {
+        return;
+    }
+    dirty_ = false;
+
+    auto next = std::make_shared<UiSnapshot>();
+    next->version   = version_.load(std::memory_order_relaxed) + 1;
+    next->window    = window_;
+    next->truncated = truncated_;
+    next->elements.reserve(nodes_.size());
+
+    // Pre-order, children in the order the backend reported them. The
+    // focus bit follows set_focus(): backends report focus as an event,
+    // not as a property change of the two elements involved.
+    std::vector<std::pair<uint64_t, uint32_t>> pending;
+    if (root_) {
+        pending.emplace_back(root_, 0);
+    }
+    while (!pending.empty()) {
+        auto [id, depth] = pending.back();
+        pending.pop_back();
+        auto it = nodes_.find(id);
+        if (it == nodes_.end()) {
+            continue;
+        }
+
+        UiElement element = {it->second.node, depth};
+        element.node.states &= ~static_cast<uint32_t>(NN_UI_STATE_FOCUSED);
+        if (id == focus_) {
+            element.node.states |= NN_UI_STATE_FOCUSED;
+            next->focus = static_cast<int64_t>(next->elements.size());
+        }
+        next->elements.push_back(std::move(element));
+
+        const auto& children = it->second.children;
+        if (depth >= kMaxDepth) {
+            next->truncated = next->truncated || !children.empty();
+            continue;
+        }
+        for (auto child = children.rbegin(); child != children.rend(); ++child) {
+            pending.emplace_back(*child, depth + 1);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(snapshot_mutex_);
+        snapshot_ = std::move(next);
+    }
+    version_.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace neuro
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "capture.hpp"
+#include "neuro_native.h"
+#include "status.hpp"
+
+namespace neuro {
+
+class UiTree;
+
+// One accessible element as the backend reports it.
+struct UiNode {
+    uint64_t    id     = 0; // backend key (UIA runtime id / AT-SPI bus name + path, hashed)
+    uint64_t    parent = 0; // 0 for the window itself
+    uint32_t    role   = NN_UI_ROLE_UNKNOWN;
+    uint32_t    states = 0; // NN_UI_STATE_* bits
+    Rect        bounds;     // desktop pixels
+    std::string name;       // UTF-8, at most UiTree::kMaxText bytes
+    std::string value;      // empty for protected (password) fields
+};
+
+struct UiElement {
+    UiNode   node;
+    uint32_t depth = 0; // 0 = the window
+};
+
+// Immutable view handed to readers; replaced wholesale on every change.
+struct UiSnapshot {
+    uint64_t               version   = 0;
+    uint64_t               window    = 0;  // HWND on Windows (as in WindowInfo), 0 = unknown
+    int64_t                focus     = -1; // index into elements, -1 = not in the tree
+    bool                   truncated = false; // the tree hit kMaxNodes / kMaxDepth
+    std::vector<UiElement> elements;       // pre-order, elements[0] = the window
+};
+
+using UiSnapshotPtr = std::shared_ptr<const UiSnapshot>;
+
+// Short role name ("button", "edit", ...); "unknown" for anything else.
+const char* ui_role_name(uint32_t role);
+
+// Compact text form of `snapshot`, at most `capacity` bytes: one line
+// per element, indented by depth, as
+//     role "name" = value (states)
+// with unnamed structural containers (panes, groups) folded into their
+// parent and offscreen elements left out. When the budget runs out the
+// walk stops at a line boundary and a "... N more" line is added, so
+// the same tree always gives the same lines and two texts can be diffed
+// line by line.
+void ui_text(const UiSnapshot& snapshot, size_t capacity, std::string& out);
+
+// -------------------------------------------------
+// Platform half of the tree (src/platform/<os>/ui_tree_*.cpp)
+//
+// Runs its own thread: follows the foreground window, walks it once
+// when it comes to the front (reset) and afterwards re-walks only what
+// the OS says moved, from structure-changed events (replace / remove)
+// and property or focus events (update / set_focus), calling
+// sink.commit() after each batch.
+// -------------------------------------------------
+
+class PlatformUiWatch {
+public:
+    PlatformUiWatch();
+    ~PlatformUiWatch();
+
+    Status start(UiTree& sink);
+    void   stop();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// -------------------------------------------------
+// Accessibility tree of the foreground window (C ABI nn_ui_*)
+//
+// Same contract as WindowCache: reads never walk anything, version()
+// is one atomic load and snapshot() hands out the current immutable
+// tree. The tree is bounded (kMaxNodes elements, kMaxDepth levels,
+// kMaxText bytes per string) whatever the application exposes.
+// -------------------------------------------------
+
+class UiTree {
+public:
+    static constexpr size_t   kMaxNodes = 4096;
+    static constexpr uint32_t kMaxDepth = 48;
+    static constexpr size_t   kMaxText  = 256;
+
+    static UiTree& instance();
+
+    // Busy when already running.
+    Status start();
+    void   stop();
+    bool   running() const { return running_.load(std::memory_order_acquire); }
+
+    // Bumped once per committed change; 0 until the first snapshot.
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    // Null until the tree has started.
+    UiSnapshotPtr snapshot() const;
+
+    // -------- Called from the watch thread only --------
+    // Elements arrive in pre-order, each after its parent; the first is
+    // the root of what was walked. Anything whose parent is unknown is
+    // dropped, and so is whatever would go past kMaxNodes.
+
+    // A new foreground window (nodes[0], parent 0), or none when empty.
+    void reset(uint64_t window, std::vector<UiNode> nodes);
+    // Re-walked subtree of an element already in the tree. False when
+    // nodes[0] is not in the tree (the backend should re-walk more).
+    bool replace(std::vector<UiNode> nodes);
+    // New properties of a known element; its children are kept.
+    void update(const UiNode& node);
+    void remove(uint64_t id);
+    void set_focus(uint64_t id);
+    bool contains(uint64_t id) const { return nodes_.count(id) != 0; }
+    uint64_t window() const { return window_; }
+    // Room left under kMaxNodes, for backends bounding a walk.
+    size_t budget() const { return kMaxNodes - std::min(kMaxNodes, nodes_.size()); }
+
+    // Publishes a new snapshot if anything changed since the last one.
+    void commit();
+
+private:
+    struct Entry {
+        UiNode                node;
+        std::vector<uint64_t> children;
+    };
+
+    UiTree() = default;
+
+    void   clear();
+    void   erase_subtree(uint64_t id);
+    // Links nodes[first..] under what is already in the tree.
+    void   insert(std::vector<UiNode>& nodes, size_t first);
+    static void clip(UiNode& node);
+
+    std::mutex      control_;
+    PlatformUiWatch platform_;
+    std::atomic<bool> running_{false};
+
+    // Watch-thread state
+    std::unordered_map<uint64_t, Entry> nodes_;
+    uint64_t                            root_      = 0;
+    uint64_t                            window_    = 0;
+    uint64_t                            focus_     = 0;
+    bool                                truncated_ = false;
+    bool                                dirty_     = false;
+
+    mutable std::mutex    snapshot_mutex_;
+    UiSnapshotPtr         snapshot_;
+    std::atomic<uint64_t> version_{0};
+};
+
+} // namespace neuro
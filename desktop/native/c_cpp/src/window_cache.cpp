@@ -0,0 +1,115 @@
+#include "window_cache.hpp"
+
+namespace neuro {
+
+WindowCache& WindowCache::instance() {
+    static WindowCache cache;
+    return cache;
+}
+
+Status WindowCache::start() {
+    std::lock_guard<std::mutex> guard(control_);
+    if (running()) {
+        return Status::Busy;
+    }
+
+    windows_.clear();
+    index_.clear();
+    active_id_ = 0;
+    dirty_     = true; // the first commit always publishes
+
+    Status status = platform_.start(*this);
+    running_.store(status == Status::Ok, std::memory_order_release);
+    return status;
+}
+
+void WindowCache::stop() {
+    std::lock_guard<std::mutex> guard(control_);
+    if (!running()) {
+        return;
+    }
+
+    platform_.stop();
+    running_.store(false, std::memory_order_release);
+
+    // The version keeps counting, so a restarted cache never repeats one.
+    std::lock_guard<std::mutex> snapshot_guard(snapshot_mutex_);
+    snapshot_.reset();
+}
+
+WindowSnapshotPtr WindowCache::snapshot() const {
+    std::lock_guard<std::mutex> guard(snapshot_mutex_);
+    return snapshot_;
+}
+
+void WindowCache::reset(std::vector<WindowInfo> windows, uint64_t active_id) {
+    windows_ = std::move(windows);
+    index_.clear();
+    for (size_t i = 0; i < windows_.size(); ++i) {
+        index_[windows_[i].id] = i;
+    }
+    active_id_ = active_id;
+    dirty_     = true;
+}
+
+void WindowCache::upsert(uint64_t id, uint32_t pid, std::string title) {
+    auto it = index_.find(id);
+    if (it == index_.end()) {
+        index_[id] = windows_.size();
+        windows_.push_back(WindowInfo{id, pid, std::move(title)});
+        dirty_ = true;
+        return;
+    }
+
+    WindowInfo& info = windows_[it->second];
+    if (info.pid != pid || info.title != title) {
+        info.pid   = pid;
+        info.title = std::move(title);
+        dirty_     = true;
+    }
+}
+
+void WindowCache::remove(uint64_t id) {
+    auto it = index_.find(id);
+    if (it == index_.end()) {
+        return;
+    }
+
+    // Keep OS order: shift the tail down and fix its indices.
+    size_t at = it->second;
+    index_.erase(it);
+    windows_.erase(windows_.begin() + static_cast<ptrdiff_t>(at));
+    for (size_t i = at; i < windows_.size(); ++i) {
+        index_[windows_[i].id] = i;
+    }
+    dirty_ = true;
+}
+
+void WindowCache::set_active(uint64_t id) {
+    if (active_id_ != id) {
+        active_id_ = id;
+        dirty_     = true;
+    }
+}
+
+void WindowCache::commit() {
+    if (!dirty_) {
+        return;
+    }
+    dirty_ = false;
+
+    auto next = std::make_shared<WindowSnapshot>();
+    next->version   = version_.load(std::memory_order_relaxed) + 1;
+    next->active_id = active_id_;
+    auto active = index_.find(active_id_);
+    next->active = active != index_.end() ? static_cast<int64_t>(active->second) : -1;
+    next->windows   = windows_;
+
+    {
+        std::lock_guard<std::mutex> guard(snapshot_mutex_);
+        snapshot_ = std::move(next);
+    }
+    version_.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace neuro
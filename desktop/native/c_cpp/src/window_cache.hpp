@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "status.hpp"
+
+namespace neuro {
+
+class WindowCache;
+
+struct WindowInfo {
+    uint64_t    id  = 0; // HWND / X11 Window
+    uint32_t    pid = 0; // 0 when the window doesn't say
+    std::string title;   // UTF-8
+};
+
+// Immutable view handed to readers; replaced wholesale on every change.
+struct WindowSnapshot {
+    uint64_t                version   = 0;
+    uint64_t                active_id = 0;  // 0 = none / unknown
+    int64_t                 active    = -1; // index into windows, -1 = not listed
+    std::vector<WindowInfo> windows;        // top-level windows, OS order
+};
+
+using WindowSnapshotPtr = std::shared_ptr<const WindowSnapshot>;
+
+// -------------------------------------------------
+// Platform half of the cache (src/platform/<os>/window_cache_*.cpp)
+//
+// Runs its own thread: seeds the sink with a full enumeration, then
+// reports changes as the OS announces them (window created, destroyed,
+// shown, hidden, renamed; foreground changes) and calls sink.commit()
+// after each batch of events.
+// -------------------------------------------------
+
+class PlatformWindowWatch {
+public:
+    PlatformWindowWatch();
+    ~PlatformWindowWatch();
+
+    Status start(WindowCache& sink);
+    void   stop();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// -------------------------------------------------
+// Process-wide window state, kept current by OS events
+//
+// Readers never enumerate anything: version() is one atomic load and
+// snapshot() hands out the current immutable snapshot, so polling an
+// unchanged desktop costs nothing.
+// -------------------------------------------------
+
+class WindowCache {
+public:
+    static WindowCache& instance();
+
+    // Busy when already running.
+    Status start();
+    void   stop();
+    bool   running() const { return running_.load(std::memory_order_acquire); }
+
+    // Bumped once per committed change; 0 until the first snapshot.
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    // Null until the cache has started.
+    WindowSnapshotPtr snapshot() const;
+
+    // -------- Called from the watch thread only --------
+    void reset(std::vector<WindowInfo> windows, uint64_t active_id);
+    void upsert(uint64_t id, uint32_t pid, std::string title);
+    void remove(uint64_t id);
+    void set_active(uint64_t id);
+    bool contains(uint64_t id) const { return index_.count(id) != 0; }
+
+    // Publishes a new snapshot if anything changed since the last one.
+    void commit();
+
+private:
+    WindowCache() = default;
+
+    std::mutex          control_;
+    PlatformWindowWatch platform_;
+    std::atomic<bool>   running_{false};
+
+    // Watch-thread state
+    std::vector<WindowInfo>              windows_;
+    std::unordered_map<uint64_t, size_t> index_; // id -> position in windows_
+    uint64_t                             active_id_ = 0;
+    bool                                 dirty_     = false;
+
+    mutable std::mutex    snapshot_mutex_;
+    WindowSnapshotPtr     snapshot_;
+    std::atomic<uint64_t> version_{0};
+};
+
+} // namespace neuro
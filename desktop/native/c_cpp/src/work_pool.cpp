@@ -0,0 +1,165 @@
+#include "work_pool.hpp"
+
+#include <algorithm>
+
+namespace neuro {
+
+namespace {
+
+constexpr unsigned kMaxWorkers = 15;
+
+uint64_t pack(uint32_t begin, uint32_t end) {
+    return static_cast<uint64_t>(begin) << 32 | end;
+}
+
+uint32_t range_begin(uint64_t range) { return static_cast<uint32_t>(range >> 32); }
+uint32_t range_end(uint64_t range) { return static_cast<uint32_t>(range); }
+
+uint32_t range_size(uint64_t range) {
+    uint32_t begin = range_begin(range), end = range_end(range);
+    return end > begin ? end - begin : 0;
+}
+
+} // namespace
+
+WorkPool& WorkPool::shared() {
+    static WorkPool* pool = [] {
+        unsigned threads = std::thread::hardware_concurrency();
+        return new WorkPool(std::min(threads > 1 ? threads - 1 : 0u, kMaxWorkers));
+    }();
+    return *pool;
+}
+
+WorkPool::WorkPool(unsigned workers) : lane_count_(workers + 1), lanes_(new Lane[workers + 1]) {
+    workers_.reserve(workers);
+    for (unsigned lane = 1; lane <= workers; ++lane) {
+        workers_.emplace_back([this, lane] { work(lane); });
+    }
+}
+
+WorkPool::~WorkPool() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        closed_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void WorkPool::parallel_for(uint32_t count, const std::function<void(uint32_t)>& fn) {
+    if (lane_count_ == 1 || count <= 1) {
+        for (uint32_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> call(call_);
+    {
+        // No worker is inside drain() between loops (see the wait
+        // below), so the lanes can be refilled with plain stores.
+        std::lock_guard<std::mutex> guard(mutex_);
+        uint32_t share = count / lane_count_;
+        uint32_t extra = count % lane_count_;
+        uint32_t begin = 0;
+        for (unsigned lane = 0; lane < lane_count_; ++lane) {
+            uint32_t end = begin + share + (lane < extra ? 1 : 0);
+            lanes_[lane].range.store(pack(begin, end), std::memory_order_release);
+            begin = end;
+        }
+        remaining_.store(count, std::memory_order_relaxed);
+        fn_ = &fn;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    drain(0, fn);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&] { return remaining_.load(std::memory_order_acquire) == 0 && active_ == 0; });
+    fn_ = nullptr;
+}
+
+bool WorkPool::take(Lane& lane, uint32_t& index) {
+    uint64_t range = lane.range.load(std::memory_order_acquire);
+    while (range_size(range) != 0) {
+        uint32_t begin = range_begin(range);
+        if (lane.range.compare_exchange_weak(range, pack(begin + 1, range_end(range)),
+                                             std::memory_order_acq_rel, std::memory_order_acquire)) {
+            index = begin;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkPool::steal(unsigned self, uint32_t& index) {
+    for (;;) {
+        unsigned victim = self;
+        uint64_t seen   = 0;
+        for (unsigned lane = 0; lane < lane_count_; ++lane) {
+            uint64_t range = lanes_[lane].range.load(std::memory_order_acquire);
+            if (lane != self && range_size(range) > range_size(seen)) {
+                victim = lane;
+                seen   = range;
+            }
+        }
+        if (victim == self) {
+            return false;
+        }
+
+        uint32_t begin = range_begin(seen), end = range_end(seen);
+        uint32_t mid   = begin + (end - begin) / 2;
+        if (!lanes_[victim].range.compare_exchange_strong(seen, pack(begin, mid), std::memory_order_acq_rel,
+                                                          std::memory_order_acquire)) {
+            continue; // the owner or another thief got there first
+        }
+
+        // [mid, end) is ours now: run mid, and expose the rest in our own
+        // lane (empty, so nobody else writes it) for others to steal back.
+        index = mid;
+        lanes_[self].range.store(pack(mid + 1, end), std::memory_order_release);
+        return true;
+    }
+}
+
+void WorkPool::drain(unsigned self, const std::function<void(uint32_t)>& fn) {
+    uint32_t index = 0;
+    while (take(lanes_[self], index) || steal(self, index)) {
+        fn(index);
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> guard(mutex_);
+            done_.notify_all();
+        }
+    }
+}
+
+void WorkPool::work(unsigned self) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [&] { return closed_ || generation_ != seen; });
+        if (closed_) {
+            return;
+        }
+        seen = generation_;
+
+        // Woken too late: that loop has already finished without us.
+        const std::function<void(uint32_t)>* fn = fn_;
+        if (!fn) {
+            continue;
+        }
+
+        ++active_;
+        lock.unlock();
+        drain(self, *fn);
+        lock.lock();
+        if (--active_ == 0) {
+            done_.notify_all();
+        }
+    }
+}
+
+} // namespace neuro
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace neuro {
+
+// -------------------------------------------------
+// Work-stealing pool for data-parallel loops
+//
+// parallel_for() splits [0, count) into one contiguous range per thread
+// (the workers plus the caller, which works too). Each thread takes
+// indices from the front of its own range; one that runs dry steals the
+// back half of the fullest other range, so uneven items (a band of
+// busy screen against a band of flat background) still finish together.
+// A range is one packed 64-bit word, so taking and stealing are a CAS
+// each, with no lock on the item path.
+//
+// One loop runs at a time; `fn` must not call parallel_for itself.
+// -------------------------------------------------
+
+class WorkPool {
+public:
+    // Process-wide pool sized to the machine (hardware threads - 1
+    // workers). Leaked, like the other process-wide singletons.
+    static WorkPool& shared();
+
+    explicit WorkPool(unsigned workers);
+    ~WorkPool(); // joins the workers
+
+    WorkPool(const WorkPool&) = delete;
+    WorkPool& operator=(const WorkPool&) = delete;
+
+    // Threads a loop runs on, the caller included.
+    unsigned concurrency() const { return lane_count_; }
+
+    // Calls fn(i) once for every i in [0, count) and returns when all
+    // calls have returned.
+    void parallel_for(uint32_t count, const std::function<void(uint32_t)>& fn);
+
+private:
+    struct alignas(64) Lane {
+        std::atomic<uint64_t> range{0}; // begin << 32 | end
+    };
+
+    bool take(Lane& lane, uint32_t& index);
+    bool steal(unsigned self, uint32_t& index);
+    // Runs items (own lane first, then stolen) until every lane is dry.
+    void drain(unsigned self, const std::function<void(uint32_t)>& fn);
+    void work(unsigned self);
+
+    std::mutex call_; // one parallel_for at a time
+
+    std::mutex              mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    uint64_t                generation_ = 0;
+    unsigned                active_     = 0; // workers inside drain()
+    bool                    closed_     = false;
+
+    const std::function<void(uint32_t)>* fn_ = nullptr;
+    std::atomic<uint32_t>                remaining_{0};
+
+    const unsigned           lane_count_;
+    std::unique_ptr<Lane[]>  lanes_;   // [0] = caller, [1..] = workers
+    std::vector<std::thread> workers_; // last: started once the rest exists
+};
+
+} // namespace neuro
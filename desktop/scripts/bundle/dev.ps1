@@ -11,6 +11,12 @@ Pop-Location
 
 Copy-Item frontend/dist -Recurse $DIST/frontend
 
+# ---------- Native engine (optional, loaded by Rust + Python) ----------
+$NATIVE_DLL = "native/c_cpp/build/Release/neuro_native_shared.dll"
+if (Test-Path $NATIVE_DLL) {
+    Copy-Item $NATIVE_DLL $DIST
+}
+
 $PY_DIST = "$DIST/python"
 Write-Host "Bundling Python files and libraries..."
 
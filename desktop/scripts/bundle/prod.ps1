@@ -19,6 +19,12 @@ Copy-Item `
   apps/neuro-desktop/target/release/neuro-desktop.exe `
   $DIST
 
+# ---------- Native engine (optional, loaded by Rust + Python) ----------
+$NATIVE_DLL = "native/c_cpp/build/Release/neuro_native_shared.dll"
+if (Test-Path $NATIVE_DLL) {
+    Copy-Item $NATIVE_DLL $DIST
+}
+
 # ---------- Build frontend ----------
 Write-Host "Building frontend..."
 Push-Location frontend